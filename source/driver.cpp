@@ -10,6 +10,8 @@
 #include "module_io/print_info.h"
 #include "module_io/winput.h"
 
+#include <base/core/bfc_allocator.h>
+
 Driver::Driver()
 {
 }
@@ -92,6 +94,14 @@ void Driver::atomic_world(void)
     this->driver_run();
 
     ModuleBase::timer::finish(GlobalV::ofs_running);
+
+    // the pool of CPU tensors does not know about ModuleBase::Memory, record it here
+    const auto pool_stats = container::base::BFCAllocator::GetCPUAllocator()->GetStats();
+    ModuleBase::Memory::record_pool("TensorPool",
+                                    pool_stats.bytes_reserved,
+                                    pool_stats.peak_bytes_in_use,
+                                    pool_stats.num_allocs,
+                                    pool_stats.fragmentation);
     ModuleBase::Memory::print_all(GlobalV::ofs_running);
 
     return;
@@ -1,6 +1,7 @@
 #include "driver.h"
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
 #include "module_io/input.h"
+#include "module_io/output_queue.h"
 #include "module_io/winput.h"
 #include "module_cell/module_neighbor/sltk_atom_arrange.h"
 #include "module_io/print_info.h"
@@ -69,6 +70,9 @@ void Driver::driver_run()
     p_esolver->postprocess();
     ModuleESolver::clean_esolver(p_esolver);
 
+    // 7. wait for the files written in the background
+    ModuleIO::output_queue().flush();
+
     ModuleBase::timer::tick("Driver", "driver_line");
     return;
 }
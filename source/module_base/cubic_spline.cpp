@@ -5,6 +5,7 @@
 #include <cmath>
 #include <cstring>
 #include <functional>
+#include <vector>
 
 namespace ModuleBase
 {
@@ -22,6 +23,12 @@ CubicSpline::CubicSpline(CubicSpline const& other)
     std::memcpy(x_, other.x_, n_ * sizeof(double));
     std::memcpy(y_, other.y_, n_ * sizeof(double));
     std::memcpy(s_, other.s_, n_ * sizeof(double));
+
+    if (other.coef_)
+    {
+        coef_ = new double[4 * (n_ - 1)];
+        std::memcpy(coef_, other.coef_, 4 * (n_ - 1) * sizeof(double));
+    }
 }
 
 CubicSpline& CubicSpline::operator=(CubicSpline const& other)
@@ -40,6 +47,12 @@ CubicSpline& CubicSpline::operator=(CubicSpline const& other)
         std::memcpy(x_, other.x_, n_ * sizeof(double));
         std::memcpy(y_, other.y_, n_ * sizeof(double));
         std::memcpy(s_, other.s_, n_ * sizeof(double));
+
+        if (other.coef_)
+        {
+            coef_ = new double[4 * (n_ - 1)];
+            std::memcpy(coef_, other.coef_, 4 * (n_ - 1) * sizeof(double));
+        }
     }
 
     return *this;
@@ -50,10 +63,12 @@ void CubicSpline::cleanup()
     delete[] x_;
     delete[] y_;
     delete[] s_;
+    delete[] coef_;
 
     x_ = nullptr;
     y_ = nullptr;
     s_ = nullptr;
+    coef_ = nullptr;
 }
 
 void CubicSpline::check_build(const int n,
@@ -86,11 +101,12 @@ void CubicSpline::check_interp(const int n,
                                const int n_interp,
                                const double* const x_interp,
                                double* const y_interp,
-                               double* const dy_interp)
+                               double* const dy_interp,
+                               double* const d2y_interp)
 {
-    assert(n > 1 && x && y && s);     // make sure the interpolant exists
-    assert(n_interp > 0 && x_interp); // make sure the interpolation points exist
-    assert(y_interp || dy_interp);    // make sure at least one of y or dy is not null
+    assert(n > 1 && x && y && s);                // make sure the interpolant exists
+    assert(n_interp > 0 && x_interp);            // make sure the interpolation points exist
+    assert(y_interp || dy_interp || d2y_interp); // make sure at least one of the outputs is not null
 
     // check that x_interp is in the range of the interpolant
     assert(std::all_of(x_interp, x_interp + n_interp,
@@ -232,9 +248,31 @@ void CubicSpline::build(const int n,
     std::memcpy(y_, y, sizeof(double) * n);
     build(n_, x_, y_, s_, bc_start, bc_end, deriv_start, deriv_end);
 
-    double dx_avg = (x[n - 1] - x[0]) / (n - 1);
-    is_uniform_ = std::all_of(x, x + n,
-            [dx_avg, &x](const double& xi) -> bool { return std::abs(xi - (&xi - x) * dx_avg) < 1e-15; });
+    is_uniform_ = _is_uniform(n, x, uniform_thr_);
+
+    std::vector<int> p(n - 1);
+    std::vector<double> h(n - 1);
+    for (int i = 0; i != n - 1; ++i)
+    {
+        p[i] = i;
+        h[i] = x[i + 1] - x[i];
+    }
+    coef_ = new double[4 * (n - 1)];
+    _build_coef(n - 1, p.data(), h.data(), y_, s_, coef_);
+}
+
+bool CubicSpline::_is_uniform(const int n, const double* const x, const double thr)
+{
+    const double dx = (x[n - 1] - x[0]) / (n - 1);
+    const double tol = thr * (x[n - 1] - x[0]);
+    for (int i = 1; i != n - 1; ++i)
+    {
+        if (std::abs(x[i] - x[0] - i * dx) >= tol)
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
 void CubicSpline::eval(const int n,
@@ -244,38 +282,196 @@ void CubicSpline::eval(const int n,
                        const int n_interp,
                        const double* const x_interp,
                        double* const y_interp,
-                       double* const dy_interp)
+                       double* const dy_interp,
+                       double* const d2y_interp)
 {
-    check_interp(n, x, y, s, n_interp, x_interp, y_interp, dy_interp);
-    _eval(x, y, s, n_interp, x_interp, y_interp, dy_interp, _gen_search(n, x));
+    check_interp(n, x, y, s, n_interp, x_interp, y_interp, dy_interp, d2y_interp);
+    _eval(x, y, s, n_interp, x_interp, y_interp, dy_interp, d2y_interp, _gen_search(n, x));
 }
 
 void CubicSpline::eval(const int n_interp,
                        const double* const x_interp,
                        double* const y_interp,
-                       double* const dy_interp)
+                       double* const dy_interp,
+                       double* const d2y_interp)
 {
-    check_interp(n_, x_, y_, s_, n_interp, x_interp, y_interp, dy_interp);
-    _eval(x_, y_, s_, n_interp, x_interp, y_interp, dy_interp, _gen_search(n_, x_, is_uniform_));
+    check_interp(n_, x_, y_, s_, n_interp, x_interp, y_interp, dy_interp, d2y_interp);
+
+    // the coefficients are precomputed, so only the piece index and the
+    // local coordinate are needed for each point
+    int p[blksize_];
+    double w[blksize_];
+
+    const double x0 = x_[0];
+    const double inv_dx = (n_ - 1) / (x_[n_ - 1] - x_[0]);
+
+    for (int ib = 0; ib < n_interp; ib += blksize_)
+    {
+        const int nb = std::min(blksize_, n_interp - ib);
+        const double* xi = x_interp + ib;
+
+        if (is_uniform_)
+        {
+            for (int k = 0; k < nb; ++k)
+            {
+                p[k] = std::min(static_cast<int>((xi[k] - x0) * inv_dx), n_ - 2);
+            }
+        }
+        else
+        {
+            for (int k = 0; k < nb; ++k)
+            {
+                p[k] = std::min(static_cast<int>(std::upper_bound(x_, x_ + n_, xi[k]) - x_) - 1, n_ - 2);
+            }
+        }
+
+        for (int k = 0; k < nb; ++k)
+        {
+            w[k] = xi[k] - x_[p[k]];
+        }
+
+        _poly_eval(nb,
+                   p,
+                   w,
+                   coef_,
+                   y_interp ? y_interp + ib : nullptr,
+                   dy_interp ? dy_interp + ib : nullptr,
+                   d2y_interp ? d2y_interp + ib : nullptr);
+    }
+}
+
+void CubicSpline::eval_uniform(const int n,
+                               const double x0,
+                               const double dx,
+                               const double* const y,
+                               const double* const s,
+                               const int n_interp,
+                               const double* const x_interp,
+                               double* const y_interp,
+                               double* const dy_interp,
+                               double* const d2y_interp)
+{
+    assert(n > 1 && dx > 0 && y && s);
+    assert(n_interp > 0 && x_interp);
+    assert(y_interp || dy_interp || d2y_interp);
+    assert(std::all_of(x_interp, x_interp + n_interp,
+                [n, x0, dx](const double xi) { return xi >= x0 && xi <= x0 + (n - 1) * dx * (1.0 + 1e-14); }));
+
+    int p[blksize_];
+    int q[blksize_];
+    double h[blksize_];
+    double w[blksize_];
+    double coef[4 * blksize_];
+
+    const double inv_dx = 1.0 / dx;
+    std::fill(h, h + blksize_, dx);
+    for (int k = 0; k < blksize_; ++k)
+    {
+        q[k] = k;
+    }
+
+    for (int ib = 0; ib < n_interp; ib += blksize_)
+    {
+        const int nb = std::min(blksize_, n_interp - ib);
+        const double* xi = x_interp + ib;
+
+        for (int k = 0; k < nb; ++k)
+        {
+            p[k] = std::min(static_cast<int>((xi[k] - x0) * inv_dx), n - 2);
+            w[k] = xi[k] - x0 - p[k] * dx;
+        }
+
+        _build_coef(nb, p, h, y, s, coef);
+        _poly_eval(nb,
+                   q,
+                   w,
+                   coef,
+                   y_interp ? y_interp + ib : nullptr,
+                   dy_interp ? dy_interp + ib : nullptr,
+                   d2y_interp ? d2y_interp + ib : nullptr);
+    }
 }
 
 std::function<int(double)> CubicSpline::_gen_search(const int n, const double* const x, int is_uniform)
 {
     if (is_uniform != 0 && is_uniform != 1)
     {
-        double dx_avg = (x[n - 1] - x[0]) / (n - 1);
-        is_uniform = std::all_of(x, x + n,
-                [dx_avg, &x] (const double& xi) { return std::abs(xi - (&xi - x) * dx_avg) < 1e-15; });
+        is_uniform = _is_uniform(n, x, 1e-14);
     }
 
     if (is_uniform)
     {
-        double dx = x[1] - x[0];
-        return [dx, n, x](double xi) -> int { return xi == x[n - 1] ? n - 2 : xi / dx; };
+        double inv_dx = (n - 1) / (x[n - 1] - x[0]);
+        return [inv_dx, n, x](double xi) -> int { return std::min(static_cast<int>((xi - x[0]) * inv_dx), n - 2); };
     }
     else
     {
-        return [n, x](double xi) -> int { return (std::upper_bound(x, x + n, xi) - x) - 1; };
+        return [n, x](double xi) -> int { return std::min(static_cast<int>(std::upper_bound(x, x + n, xi) - x) - 1, n - 2); };
+    }
+}
+
+void CubicSpline::_build_coef(const int n_piece,
+                              const int* const p,
+                              const double* const h,
+                              const double* const y,
+                              const double* const s,
+                              double* const coef)
+{
+    for (int k = 0; k < n_piece; ++k)
+    {
+        const int i = p[k];
+        const double dd = (y[i + 1] - y[i]) / h[k];
+        const double c3 = (s[i] + s[i + 1] - 2.0 * dd) / (h[k] * h[k]);
+
+        coef[4 * k] = y[i];
+        coef[4 * k + 1] = s[i];
+        coef[4 * k + 2] = (dd - s[i]) / h[k] - c3 * h[k];
+        coef[4 * k + 3] = c3;
+    }
+}
+
+void CubicSpline::_poly_eval(const int n,
+                             const int* const p,
+                             const double* const w,
+                             const double* const coef,
+                             double* const y,
+                             double* const dy,
+                             double* const d2y)
+{
+    if (y)
+    {
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+        for (int k = 0; k < n; ++k)
+        {
+            const double* c = coef + 4 * p[k];
+            y[k] = ((c[3] * w[k] + c[2]) * w[k] + c[1]) * w[k] + c[0];
+        }
+    }
+
+    if (dy)
+    {
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+        for (int k = 0; k < n; ++k)
+        {
+            const double* c = coef + 4 * p[k];
+            dy[k] = (3.0 * c[3] * w[k] + 2.0 * c[2]) * w[k] + c[1];
+        }
+    }
+
+    if (d2y)
+    {
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+        for (int k = 0; k < n; ++k)
+        {
+            const double* c = coef + 4 * p[k];
+            d2y[k] = 6.0 * c[3] * w[k] + 2.0 * c[2];
+        }
     }
 }
 
@@ -286,25 +482,40 @@ void CubicSpline::_eval(const double* const x,
                         const double* const x_interp,
                         double* const y_interp,
                         double* const dy_interp,
+                        double* const d2y_interp,
                         std::function<int(double)> search)
 {
-    void (*poly_eval)(double, double, double, double, double, double*, double*) =
-        y_interp ? (dy_interp ? _poly_eval<true, true>: _poly_eval<true, false>) : _poly_eval<false, true>;
+    int p[blksize_];
+    int q[blksize_];
+    double h[blksize_];
+    double w[blksize_];
+    double coef[4 * blksize_];
 
-    for (int i = 0; i != n_interp; ++i)
+    for (int k = 0; k < blksize_; ++k)
     {
-        int p = search(x_interp[i]);
-        double w = x_interp[i] - x[p];
+        q[k] = k;
+    }
 
-        double dx = x[p + 1] - x[p];
-        double dd = (y[p + 1] - y[p]) / dx;
+    for (int ib = 0; ib < n_interp; ib += blksize_)
+    {
+        const int nb = std::min(blksize_, n_interp - ib);
+        const double* xi = x_interp + ib;
 
-        double c0 = y[p];
-        double c1 = s[p];
-        double c3 = (s[p] + s[p + 1] - 2.0 * dd) / (dx * dx);
-        double c2 = (dd - s[p]) / dx - c3 * dx;
+        for (int k = 0; k < nb; ++k)
+        {
+            p[k] = search(xi[k]);
+            w[k] = xi[k] - x[p[k]];
+            h[k] = x[p[k] + 1] - x[p[k]];
+        }
 
-        poly_eval(w, c0, c1, c2, c3, y_interp + i, dy_interp + i);
+        _build_coef(nb, p, h, y, s, coef);
+        _poly_eval(nb,
+                   q,
+                   w,
+                   coef,
+                   y_interp ? y_interp + ib : nullptr,
+                   dy_interp ? dy_interp + ib : nullptr,
+                   d2y_interp ? d2y_interp + ib : nullptr);
     }
 }
 
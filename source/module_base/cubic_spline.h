@@ -3,6 +3,8 @@
 
 #include "lapack_connector.h"
 
+#include <functional>
+
 namespace ModuleBase
 {
 
@@ -45,6 +47,9 @@ namespace ModuleBase
  *      // calculate the values & derivatives of interpolant at x_interp[i]
  *      cubspl.eval(n_interp, x_interp, y_interp, dy_interp);
  *
+ *      // calculate the values, first & second derivatives of interpolant at x_interp[i]
+ *      cubspl.eval(n_interp, x_interp, y_interp, dy_interp, d2y_interp);
+ *
  * Usage-2: static member functions
  *
  *      // gets the first-derivatives (s) at knots
@@ -54,6 +59,10 @@ namespace ModuleBase
  *      // evaluates the interpolant with knots, values & derivatives
  *      CubicSpline::eval(n, x, y, s, n_interp, x_interp, y_interp, dy_interp);
  *
+ *      // same as above for evenly spaced knots x[i] = x0 + i*dx, which
+ *      // locates the polynomial piece in O(1) instead of a binary search
+ *      CubicSpline::eval_uniform(n, x0, dx, y, s, n_interp, x_interp, y_interp, dy_interp);
+ *
  *                                                                                 */
 class CubicSpline
 {
@@ -106,19 +115,23 @@ class CubicSpline
      * @brief Evaluates the interpolant.
      *
      * This function evaluates the interpolant at x_interp[i].
-     * On finish, interpolated values are placed in y_interp,
-     * and the derivatives at x_interp[i] are placed in dy_interp.
+     * On finish, interpolated values are placed in y_interp, and the first and
+     * second derivatives at x_interp[i] are placed in dy_interp and d2y_interp.
      *
-     * If y_interp or dy_interp is nullptr, the corresponding values are
-     * not calculated. They must not be nullptr at the same time.
+     * If y_interp, dy_interp or d2y_interp is nullptr, the corresponding values
+     * are not calculated. They must not be nullptr at the same time.
+     *
+     * If the knots are evenly spaced, the polynomial piece of each point is
+     * located in O(1) time; otherwise a binary search is performed.
      *
      * @note the interpolant must be built before calling this function.
      *                                                                              */
-    void eval(const int n,                      //!< [in]  number of points to evaluate the interpolant
-              const double* const x_interp,     //!< [in]  places where the interpolant is evaluated;
-                                                //!<       must be within [x_[0], x_[n-1]]
-              double* const y_interp,           //!< [out] interpolated values
-              double* const dy_interp = nullptr //!< [out] derivatives at x_interp
+    void eval(const int n,                        //!< [in]  number of points to evaluate the interpolant
+              const double* const x_interp,       //!< [in]  places where the interpolant is evaluated;
+                                                  //!<       must be within [x_[0], x_[n-1]]
+              double* const y_interp,             //!< [out] interpolated values
+              double* const dy_interp = nullptr,  //!< [out] first-order derivatives at x_interp
+              double* const d2y_interp = nullptr  //!< [out] second-order derivatives at x_interp
     );
 
     /// knots of the interpolant
@@ -142,15 +155,36 @@ class CubicSpline
                                                       //!<      used if bc_end is first_deriv or second_deriv
     );
 
-    static void eval(const int n,                      //!< [in]  number of knots
-                     const double* const x,            //!< [in]  knots of the interpolant
-                     const double* const y,            //!< [in]  values at knots
-                     const double* const s,            //!< [in]  first-order derivatives at knots
-                     const int n_interp,               //!< [in]  number of points to evaluate the interpolant
-                     const double* const x_interp,     //!< [in]  places where the interpolant is evaluated;
-                                                       //!<       must be within [x_[0], x_[n-1]]
-                     double* const y_interp,           //!< [out] interpolated values
-                     double* const dy_interp = nullptr //!< [out] derivatives at x_interp
+    static void eval(const int n,                       //!< [in]  number of knots
+                     const double* const x,             //!< [in]  knots of the interpolant
+                     const double* const y,             //!< [in]  values at knots
+                     const double* const s,             //!< [in]  first-order derivatives at knots
+                     const int n_interp,                //!< [in]  number of points to evaluate the interpolant
+                     const double* const x_interp,      //!< [in]  places where the interpolant is evaluated;
+                                                        //!<       must be within [x_[0], x_[n-1]]
+                     double* const y_interp,            //!< [out] interpolated values
+                     double* const dy_interp = nullptr, //!< [out] first-order derivatives at x_interp
+                     double* const d2y_interp = nullptr //!< [out] second-order derivatives at x_interp
+    );
+
+    /*!
+     * @brief Evaluates a cubic spline whose knots are evenly spaced.
+     *
+     * The knots are x0 + i*dx (i=0,...,n-1) and are not accessed explicitly,
+     * so neither a knot array nor a uniformity check is needed. This is the
+     * preferred entry for radial tables on uniform grids.
+     *                                                                              */
+    static void eval_uniform(const int n,                       //!< [in]  number of knots
+                             const double x0,                   //!< [in]  first knot
+                             const double dx,                   //!< [in]  spacing between knots
+                             const double* const y,             //!< [in]  values at knots
+                             const double* const s,             //!< [in]  first-order derivatives at knots
+                             const int n_interp,                //!< [in]  number of points to evaluate
+                             const double* const x_interp,      //!< [in]  places where the interpolant is evaluated;
+                                                                //!<       must be within [x0, x0+(n-1)*dx]
+                             double* const y_interp,            //!< [out] interpolated values
+                             double* const dy_interp = nullptr, //!< [out] first-order derivatives at x_interp
+                             double* const d2y_interp = nullptr //!< [out] second-order derivatives at x_interp
     );
 
   private:
@@ -166,16 +200,27 @@ class CubicSpline
     //! first-order derivatives at knots
     double* s_ = nullptr;
 
+    //! polynomial coefficients of each piece, interleaved as (c0,c1,c2,c3) per interval
+    /*!
+     *  On [x_[i], x_[i+1]] the interpolant reads c0 + c1*w + c2*w^2 + c3*w^3 with
+     *  w = x - x_[i]. The four coefficients of a piece are contiguous so that an
+     *  evaluation touches a single cache line instead of four separate arrays.
+     *                                                                              */
+    double* coef_ = nullptr;
+
     //! A flag that tells whether the knots are evenly spaced.
     bool is_uniform_ = false;
 
     //! Numerical threshold for determining whether the knots are evenly spaced.
     /*!
-     *  The knots are considered uniform (evenly spaced) if for every i from 0 to n-2
+     *  The knots are considered uniform (evenly spaced) if for every i from 0 to n-1
      *
-     *          abs( (x[i+1]-x[i]) - (x[n-1]-x[0])/(n-1) ) < uniform_thr_
+     *          abs( x[i] - x[0] - i*(x[n-1]-x[0])/(n-1) ) < uniform_thr_ * (x[n-1]-x[0])
      *                                                                              */
-    double uniform_thr_ = 1e-15;
+    double uniform_thr_ = 1e-14;
+
+    /// Checks whether the knots are evenly spaced within a relative threshold.
+    static bool _is_uniform(const int n, const double* const x, const double thr);
 
     /// Checks whether the input arguments are valid for building a cubic spline.
     static void check_build(const int n,
@@ -192,7 +237,8 @@ class CubicSpline
                              const int n_interp,
                              const double* const x_interp,
                              double* const y_interp,
-                             double* const dy_interp);
+                             double* const dy_interp,
+                             double* const d2y_interp);
 
     //! Solves a cyclic tridiagonal linear system.
     /*!
@@ -224,20 +270,35 @@ class CubicSpline
     //! Wipes off the interpolant (if any) and deallocates memories.
     void cleanup();
 
-    /// Evaluates a cubic polynomial and its derivative.
-    template <bool EvalY, bool EvalDy>
-    static void _poly_eval(double w, double c0, double c1, double c2, double c3, double* y, double* dy)
-    {
-        if (EvalY)
-        {
-            *y = ((c3 * w + c2) * w + c1) * w + c0;
-        }
+    /*!
+     * @brief Computes the interleaved polynomial coefficients of pieces [p[k], p[k]+1].
+     *
+     * On finish, coef[4*k+j] (j=0,1,2,3) holds the coefficients c_j of the piece
+     * that starts at the p[k]-th knot and has a width of h[k].
+     *                                                                              */
+    static void _build_coef(const int n_piece,     //!< [in]  number of pieces
+                            const int* const p,    //!< [in]  left knot indices of the pieces
+                            const double* const h, //!< [in]  widths of the pieces
+                            const double* const y, //!< [in]  values at knots
+                            const double* const s, //!< [in]  first-order derivatives at knots
+                            double* const coef     //!< [out] interleaved coefficients
+    );
 
-        if (EvalDy)
-        {
-            *dy = (3.0 * c3 * w + 2.0 * c2) * w + c1;
-        }
-    }
+    /*!
+     * @brief Evaluates cubic polynomials with interleaved coefficients.
+     *
+     * The k-th point uses the coefficients at coef + 4*p[k] and the local
+     * coordinate w[k]. Each output is computed in its own loop without
+     * branches so that the compiler may vectorize it.
+     *                                                                              */
+    static void _poly_eval(const int n,               //!< [in]  number of points
+                           const int* const p,        //!< [in]  piece indices
+                           const double* const w,     //!< [in]  local coordinates
+                           const double* const coef,  //!< [in]  interleaved coefficients
+                           double* const y,           //!< [out] values (skipped if nullptr)
+                           double* const dy,          //!< [out] first-order derivatives (skipped if nullptr)
+                           double* const d2y          //!< [out] second-order derivatives (skipped if nullptr)
+    );
 
     /*!
      * @brief Generates a function that returns the index of the left knot of the
@@ -261,10 +322,14 @@ class CubicSpline
                       const double* const x_interp,     //!< [in]  places where the interpolant is evaluated;
                                                         //!<       must be within [x_[0], x_[n-1]]
                       double* const y_interp,           //!< [out] interpolated values
-                      double* const dy_interp,          //!< [out] derivatives at x_interp
+                      double* const dy_interp,          //!< [out] first-order derivatives at x_interp
+                      double* const d2y_interp,         //!< [out] second-order derivatives at x_interp
                       std::function<int(double)> search //!< [in]  a function that returns the index of the left
                                                         //         knot of the spline polynomial to be evaluated
     );
+
+    /// number of points processed at a time by the batched evaluation kernels
+    static constexpr int blksize_ = 64;
 };
 
 }; // namespace ModuleBase
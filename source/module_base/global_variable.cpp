@@ -25,8 +25,12 @@ int NLOCAL = 0; // total number of local basis.
 double  KSPACING[3] = {0.0,0.0,0.0};
 double MIN_DIST_COEF = 0.2;
 
+bool EWALD_SPME = false;
+double EWALD_SPME_TOL = 1e-8;
+
 double PSEUDORCUT;
 bool PSEUDO_MESH;
+bool PSEUDO_SBT_FFT = false;
 
 std::string CALCULATION = "scf";
 std::string ESOLVER_TYPE = "ksdft";
@@ -137,6 +141,7 @@ std::string global_wannier_card;
 
 std::string global_pseudo_dir = "";
 std::string global_orbital_dir = ""; // liuyu add 2021-08-14
+std::string global_cache_dir = "";
 
 // std::string global_pseudo_type = "auto";
 std::string global_epm_pseudo_card;
@@ -259,6 +264,7 @@ std::string init_wfc = "atomic";
 bool psi_initializer = false;
 
 int out_chg = 0;
+std::string out_chg_format = "cube";
 double nelec = 0;
 bool out_bandgap = false; // QO added for bandgap printing
 int out_interval = 1;    // convert from out_hsR_interval liuyu 2023-04-18
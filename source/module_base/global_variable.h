@@ -25,8 +25,12 @@ extern int NLOCAL; // 1.1 // mohan add 2009-05-29
 extern double KSPACING[3];
 extern double MIN_DIST_COEF;
 
+extern bool EWALD_SPME; // use the smooth particle-mesh Ewald method
+extern double EWALD_SPME_TOL;
+
 extern double PSEUDORCUT;
 extern bool PSEUDO_MESH;
+extern bool PSEUDO_SBT_FFT; // radial Fourier transforms of pseudopotentials by FFT
 
 extern std::string CALCULATION; // 2 "scf";"nscf" ;"symmetry"
 extern std::string ESOLVER_TYPE;
@@ -165,6 +169,7 @@ extern std::string global_pseudo_dir;
 // extern std::string global_pseudo_type; // mohan add 2013-05-20 (xiaohui add 2013-06-23)
 extern std::string global_out_dir;
 extern std::string global_orbital_dir; // liuyu add 2021-08-14
+extern std::string global_cache_dir; // cache of parsed pseudopotential and orbital files, empty for none
 extern std::string global_readin_dir; // zhengdy modified
 extern std::string global_stru_dir;   // liuyu add 2022-05-24 for MD STRU
 extern std::string global_matrix_dir; // liuyu add 2022-09-19 for HS matrix outpu, jiyy modified 2023-01-23 for R matrix output
@@ -253,7 +258,7 @@ extern std::vector<std::string> rpa_orbitals;
 
 // ofdft sunliang add on 2022-05-11
 extern std::string of_kinetic; // Kinetic energy functional, such as TF, VW, WT
-extern std::string of_method;  // optimization method, include cg1, cg2, tn (default), bfgs
+extern std::string of_method;  // optimization method, include cg1, cg2, tn (default), lbfgs, bfgs
 extern std::string of_conv;    // select the convergence criterion, potential, energy (default), or both
 extern double of_tole;    // tolerance of the energy change (in Ry) for determining the convergence, default=2e-6 Ry
 extern double of_tolp;    // tolerance of potential for determining the convergence, default=1e-5 in a.u.
@@ -289,6 +294,7 @@ extern std::string init_wfc;
 /// @author ykhuang, 20230920
 extern bool psi_initializer;
 extern int out_chg;
+extern std::string out_chg_format; // cube, binary or binary_zlib
 
 extern double nelec;
 extern bool out_bandgap;
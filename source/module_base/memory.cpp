@@ -24,6 +24,8 @@ int Memory::n_memory = 1000;
 int Memory::n_now = 0;
 bool Memory::init_flag =  false;
 
+std::vector<Memory::Pool> Memory::pools;
+
 std::string *Memory::name;
 std::string *Memory::class_name;
 double *Memory::consume;
@@ -207,6 +209,33 @@ void Memory::record
 	return;
 }
 
+void Memory::record_pool(const std::string &name_in,
+                         const size_t &reserved_bytes,
+                         const size_t &peak_bytes,
+                         const long &num_allocs,
+                         const double &fragmentation)
+{
+	record(name_in, reserved_bytes);
+
+	int find = 0;
+	for(find = 0; find < pools.size(); find++)
+	{
+		if(pools[find].name == name_in)
+		{
+			break;
+		}
+	}
+	if(find == pools.size())
+	{
+		pools.push_back(Pool());
+		pools[find].name = name_in;
+	}
+	pools[find].peak = peak_bytes / 1024.0 / 1024.0;
+	pools[find].num_allocs = num_allocs;
+	pools[find].fragmentation = fragmentation;
+	return;
+}
+
 void Memory::print(const int find)
 {
 	GlobalV::ofs_running <<"\n Warning_Memory_Consuming allocated: "
@@ -225,6 +254,7 @@ void Memory::finish(std::ofstream &ofs)
 		delete[] consume;
 		init_flag = false;
 	}
+	pools.clear();
 	return;
 }
 
@@ -282,6 +312,14 @@ void Memory::print_all(std::ofstream &ofs)
 //    std::cout<<"\n ----------------------------------------------------------"<<std::endl;
 	ofs<<" -------------   < 1.0 MB has been ignored ----------------"<<std::endl;
     ofs<<" ----------------------------------------------------------"<<std::endl;
+
+	// statistics of memory pools, not summed over processes
+	for(const Pool& pool : pools)
+	{
+		ofs << std::setw(20) << pool.name
+			<< " peak in use " << pool.peak << " MB, "
+			<< pool.num_allocs << " allocations, fragmentation " << pool.fragmentation << std::endl;
+	}
 	delete[] print_flag; //mohan fix by valgrind at 2012-04-02
 	return;
 }
@@ -5,6 +5,7 @@
 #include <iomanip>
 #include <iostream>
 #include <string>
+#include <vector>
 namespace ModuleBase
 {
 
@@ -50,6 +51,21 @@ class Memory
       const bool accumulate = false
     );
 
+    /**
+     * @brief Record the statistics of a memory pool, printed by print_all
+     *
+     * @param name The name of the pool
+     * @param reserved_bytes Memory held by the pool, recorded as the consumption of name
+     * @param peak_bytes Peak of the memory in use
+     * @param num_allocs Number of allocations served by the pool
+     * @param fragmentation 1 - largest free block / free memory of the pool
+     */
+    static void record_pool(const std::string &name,
+                            const size_t &reserved_bytes,
+                            const size_t &peak_bytes,
+                            const long &num_allocs,
+                            const double &fragmentation);
+
     static double &get_total(void)
     {
         return total;
@@ -85,6 +101,15 @@ class Memory
     static int n_now;
     static bool init_flag;
 
+    struct Pool
+    {
+        std::string name;
+        double peak = 0.0; // MB
+        long num_allocs = 0;
+        double fragmentation = 0.0;
+    };
+    static std::vector<Pool> pools;
+
     static int complex_matrix_memory; //(16 Byte)
     static int double_memory; //(8 Byte)
     static int int_memory; //(4 Byte)
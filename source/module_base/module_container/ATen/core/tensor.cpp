@@ -1,6 +1,6 @@
 #include <ATen/core/tensor.h>
 #include <ATen/core/tensor_utils.h>
-#include <base/core/cpu_allocator.h>
+#include <base/core/bfc_allocator.h>
 #if defined(__CUDA) || defined(__ROCM)
 #include <base/core/gpu_allocator.h>
 #endif // __CUDA || __ROCM
@@ -77,7 +77,8 @@ const TensorBuffer& Tensor::buffer() const { return *buffer_; }
 base::Allocator* Tensor::GetAllocator(DeviceType device) {
     base::Allocator * allocator;
     if (device == DeviceType::CpuDevice) {
-        allocator = new base::CPUAllocator();
+        // CPU tensors share one BFC pool, so that temporaries do not go through malloc/free.
+        allocator = new base::BFCAllocatorRef(base::BFCAllocator::GetCPUAllocator());
     }
 #if defined(__CUDA) || defined(__ROCM)
     else if (device == DeviceType::GpuDevice) {
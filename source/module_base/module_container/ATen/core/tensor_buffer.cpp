@@ -1,4 +1,4 @@
-#include <base/core/cpu_allocator.h>
+#include <base/core/bfc_allocator.h>
 #include <ATen/core/tensor_buffer.h>
 
 #if defined(__CUDA) || defined(__ROCM)
@@ -99,7 +99,7 @@ TensorBuffer& TensorBuffer::operator=(const TensorBuffer& other) {
 
     delete this->alloc_;
     if (other.GetDeviceType() == DeviceType::CpuDevice) {
-        this->alloc_ = new base::CPUAllocator();
+        this->alloc_ = new base::BFCAllocatorRef(base::BFCAllocator::GetCPUAllocator());
     }
     #if defined(__CUDA) || defined(__ROCM)
     else if (other.GetDeviceType() == DeviceType::GpuDevice) {
@@ -0,0 +1,305 @@
+#include <base/core/bfc_allocator.h>
+#include <base/core/cpu_allocator.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <new>
+
+namespace container {
+namespace base {
+
+constexpr BFCAllocator::chunk_handle_t BFCAllocator::kInvalidChunkHandle;
+constexpr int BFCAllocator::kInvalidBinNum;
+constexpr int BFCAllocator::kNumBins;
+constexpr size_t BFCAllocator::kMinAllocationSize;
+constexpr size_t BFCAllocator::kMinRegionSize;
+constexpr size_t BFCAllocator::kMaxRegionSize;
+
+BFCAllocator::BFCAllocator(std::unique_ptr<Allocator> sub_alloc, const size_t& total_memory, const Options& options)
+    : sub_alloc_(std::move(sub_alloc)), memory_limit_(total_memory), options_(options)
+{
+    bins_.reserve(kNumBins);
+    for (int b = 0; b < kNumBins; ++b) {
+        bins_.emplace_back(this, kMinAllocationSize << b);
+    }
+    // Reserve the whole pool at once if it is not allowed to grow.
+    if (!options_.allow_growth && memory_limit_ > 0) {
+        curr_region_allocation_bytes_ = round_bytes(memory_limit_);
+        memory_limit_ = curr_region_allocation_bytes_;
+        this->extend(curr_region_allocation_bytes_);
+    }
+}
+
+BFCAllocator::BFCAllocator(std::unique_ptr<Allocator> sub_alloc, const size_t& total_memory)
+    : BFCAllocator(std::move(sub_alloc), total_memory, Options())
+{}
+
+BFCAllocator::~BFCAllocator() {
+    for (auto& r : regions_) {
+        sub_alloc_->free(r.raw_ptr);
+    }
+}
+
+// Get the process-wide pool of CPU memory.
+BFCAllocator* BFCAllocator::GetCPUAllocator() {
+    static BFCAllocator* pool = new BFCAllocator(std::unique_ptr<Allocator>(new CPUAllocator()), 0);
+    return pool;
+}
+
+size_t BFCAllocator::round_bytes(const size_t& bytes) {
+    const size_t rounded = (bytes + kMinAllocationSize - 1) / kMinAllocationSize * kMinAllocationSize;
+    return std::max(rounded, kMinAllocationSize);
+}
+
+BFCAllocator::bin_index_t BFCAllocator::bin_num_for_size(const size_t& bytes) {
+    size_t v = std::max(bytes, kMinAllocationSize) / kMinAllocationSize;
+    int b = 0;
+    while (v > 1) {
+        v >>= 1;
+        ++b;
+    }
+    return std::min(b, kNumBins - 1);
+}
+
+BFCAllocator::chunk_handle_t BFCAllocator::allocate_chunk() {
+    if (!free_chunk_handles_.empty()) {
+        const chunk_handle_t h = free_chunk_handles_.back();
+        free_chunk_handles_.pop_back();
+        return h;
+    }
+    chunks_.emplace_back();
+    return chunks_.size() - 1;
+}
+
+void BFCAllocator::deallocate_chunk(const chunk_handle_t& h) {
+    chunks_[h] = chunk();
+    free_chunk_handles_.push_back(h);
+}
+
+bool BFCAllocator::extend(const size_t& rounded_bytes) {
+    size_t available = SIZE_MAX;
+    if (memory_limit_ > 0) {
+        available = memory_limit_ - stats_.bytes_reserved;
+    }
+    if (rounded_bytes > available || (!options_.allow_growth && !regions_.empty())) {
+        return false;
+    }
+
+    // Regions grow geometrically, so that the number of regions stays small.
+    size_t bytes = std::min(std::max(curr_region_allocation_bytes_, rounded_bytes), available);
+    void* raw_ptr = nullptr;
+    try {
+        raw_ptr = sub_alloc_->allocate(bytes + kMinAllocationSize);
+    }
+    catch (const std::bad_alloc&) {
+        raw_ptr = nullptr;
+    }
+    if (raw_ptr == nullptr && bytes > rounded_bytes) {
+        bytes = rounded_bytes;
+        try {
+            raw_ptr = sub_alloc_->allocate(bytes + kMinAllocationSize);
+        }
+        catch (const std::bad_alloc&) {
+            raw_ptr = nullptr;
+        }
+    }
+    if (raw_ptr == nullptr) {
+        return false;
+    }
+    if (bytes >= curr_region_allocation_bytes_) {
+        curr_region_allocation_bytes_ = std::min(curr_region_allocation_bytes_ * 2, kMaxRegionSize);
+    }
+
+    region r;
+    r.raw_ptr = raw_ptr;
+    r.size = bytes;
+    regions_.push_back(r);
+    stats_.bytes_reserved += bytes;
+
+    // The whole region becomes one free chunk, aligned to kMinAllocationSize.
+    const uintptr_t base = (reinterpret_cast<uintptr_t>(raw_ptr) + kMinAllocationSize - 1)
+                           / kMinAllocationSize * kMinAllocationSize;
+    const chunk_handle_t h = this->allocate_chunk();
+    chunk* c = this->chunk_from_handle(h);
+    c->ptr = reinterpret_cast<void*>(base);
+    c->size = bytes;
+    this->insert_free_chunk_into_bin(h);
+    return true;
+}
+
+void BFCAllocator::insert_free_chunk_into_bin(const chunk_handle_t& h) {
+    chunk* c = this->chunk_from_handle(h);
+    c->bin_index = bin_num_for_size(c->size);
+    bins_[c->bin_index].free_chunks.insert(h);
+}
+
+void BFCAllocator::remove_free_chunk_from_bin(const chunk_handle_t& h) {
+    chunk* c = this->chunk_from_handle(h);
+    bins_[c->bin_index].free_chunks.erase(h);
+    c->bin_index = kInvalidBinNum;
+}
+
+void BFCAllocator::split_chunk(const chunk_handle_t& h, const size_t& num_bytes) {
+    // allocate_chunk may reallocate chunks_, so get the pointers afterwards.
+    const chunk_handle_t h_new = this->allocate_chunk();
+    chunk* c = this->chunk_from_handle(h);
+    chunk* c_new = this->chunk_from_handle(h_new);
+
+    c_new->ptr = static_cast<char*>(c->ptr) + num_bytes;
+    c_new->size = c->size - num_bytes;
+    c->size = num_bytes;
+
+    c_new->prev_chunk_handle = h;
+    c_new->next_chunk_handle = c->next_chunk_handle;
+    c->next_chunk_handle = h_new;
+    if (c_new->next_chunk_handle != kInvalidChunkHandle) {
+        this->chunk_from_handle(c_new->next_chunk_handle)->prev_chunk_handle = h_new;
+    }
+    this->insert_free_chunk_into_bin(h_new);
+}
+
+void BFCAllocator::merge(const chunk_handle_t& h1, const chunk_handle_t& h2) {
+    chunk* c1 = this->chunk_from_handle(h1);
+    chunk* c2 = this->chunk_from_handle(h2);
+    c1->size += c2->size;
+    c1->next_chunk_handle = c2->next_chunk_handle;
+    if (c1->next_chunk_handle != kInvalidChunkHandle) {
+        this->chunk_from_handle(c1->next_chunk_handle)->prev_chunk_handle = h1;
+    }
+    this->deallocate_chunk(h2);
+}
+
+void BFCAllocator::free_and_coalesce(chunk_handle_t h) {
+    chunk* c = this->chunk_from_handle(h);
+    c->allocation_id = -1;
+    c->requested_size = 0;
+
+    const chunk_handle_t h_next = c->next_chunk_handle;
+    if (h_next != kInvalidChunkHandle && !this->chunk_from_handle(h_next)->allocated()) {
+        this->remove_free_chunk_from_bin(h_next);
+        this->merge(h, h_next);
+    }
+    const chunk_handle_t h_prev = this->chunk_from_handle(h)->prev_chunk_handle;
+    if (h_prev != kInvalidChunkHandle && !this->chunk_from_handle(h_prev)->allocated()) {
+        this->remove_free_chunk_from_bin(h_prev);
+        this->merge(h_prev, h);
+        h = h_prev;
+    }
+    this->insert_free_chunk_into_bin(h);
+}
+
+BFCAllocator::chunk_handle_t BFCAllocator::find_chunk(const size_t& rounded_bytes, const size_t& num_bytes) {
+    for (int b = bin_num_for_size(rounded_bytes); b < kNumBins; ++b) {
+        free_chunk_set_t& free_chunks = bins_[b].free_chunks;
+        // The chunks are sorted by size, the first one that fits is the best fit.
+        for (auto it = free_chunks.begin(); it != free_chunks.end(); ++it) {
+            const chunk_handle_t h = *it;
+            chunk* c = this->chunk_from_handle(h);
+            if (c->size < rounded_bytes) {
+                continue;
+            }
+            free_chunks.erase(it);
+            c->bin_index = kInvalidBinNum;
+
+            const size_t rest = c->size - rounded_bytes;
+            if (rest >= kMinAllocationSize && rest >= options_.fragment_fraction * c->size) {
+                this->split_chunk(h, rounded_bytes);
+                c = this->chunk_from_handle(h);
+            }
+            c->requested_size = num_bytes;
+            c->allocation_id = next_allocation_id_++;
+
+            stats_.num_allocs++;
+            stats_.bytes_in_use += c->size;
+            stats_.peak_bytes_in_use = std::max(stats_.peak_bytes_in_use, stats_.bytes_in_use);
+            stats_.largest_alloc_size = std::max(stats_.largest_alloc_size, num_bytes);
+            return h;
+        }
+    }
+    return kInvalidChunkHandle;
+}
+
+void* BFCAllocator::allocate_raw(const size_t& num_bytes, const size_t& alignment) {
+    if (num_bytes == 0) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    // Chunks are aligned to kMinAllocationSize, larger alignments are served from a larger chunk.
+    const size_t extra = (alignment > kMinAllocationSize) ? alignment : 0;
+    const size_t rounded_bytes = round_bytes(num_bytes + extra);
+    chunk_handle_t h = this->find_chunk(rounded_bytes, num_bytes);
+    if (h == kInvalidChunkHandle) {
+        if (!this->extend(rounded_bytes)) {
+            return nullptr;
+        }
+        h = this->find_chunk(rounded_bytes, num_bytes);
+        if (h == kInvalidChunkHandle) {
+            return nullptr;
+        }
+    }
+
+    void* ptr = this->chunk_from_handle(h)->ptr;
+    if (extra > 0) {
+        const uintptr_t p = reinterpret_cast<uintptr_t>(ptr);
+        ptr = reinterpret_cast<void*>((p + alignment - 1) / alignment * alignment);
+    }
+    ptr_to_chunk_[ptr] = h;
+    return ptr;
+}
+
+void* BFCAllocator::allocate(size_t size) {
+    return this->allocate_raw(size, kMinAllocationSize);
+}
+
+void* BFCAllocator::allocate(size_t size, size_t alignment) {
+    return this->allocate_raw(size, alignment);
+}
+
+void BFCAllocator::free(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = ptr_to_chunk_.find(ptr);
+    if (it == ptr_to_chunk_.end()) {
+        std::cerr << "BFCAllocator: the freed pointer was not allocated by this allocator." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    const chunk_handle_t h = it->second;
+    ptr_to_chunk_.erase(it);
+    stats_.bytes_in_use -= this->chunk_from_handle(h)->size;
+    this->free_and_coalesce(h);
+}
+
+size_t BFCAllocator::AllocatedSize(void* ptr) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = ptr_to_chunk_.find(ptr);
+    if (it == ptr_to_chunk_.end()) {
+        return 0;
+    }
+    return this->chunk_from_handle(it->second)->requested_size;
+}
+
+DeviceType BFCAllocator::GetDeviceType() {
+    return sub_alloc_->GetDeviceType();
+}
+
+BFCAllocator::Stats BFCAllocator::GetStats() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    Stats stats = stats_;
+    size_t largest_free = 0;
+    for (int b = kNumBins - 1; b >= 0; --b) {
+        if (!bins_[b].free_chunks.empty()) {
+            largest_free = this->chunk_from_handle(*bins_[b].free_chunks.rbegin())->size;
+            break;
+        }
+    }
+    const size_t free_bytes = stats.bytes_reserved - stats.bytes_in_use;
+    stats.fragmentation = (free_bytes > 0) ? 1.0 - static_cast<double>(largest_free) / free_bytes : 0.0;
+    return stats;
+}
+
+} // namespace base
+} // namespace container
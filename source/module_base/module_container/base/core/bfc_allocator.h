@@ -3,27 +3,70 @@
 
 #include <base/core/allocator.h>
 
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
 namespace container {
 namespace base {
 /**
- * @brief An allocator that allocates memory on a GPU device.
+ * @brief A best-fit with coalescing (BFC) allocator.
+ *
+ * This class keeps the memory taken from a sub allocator in a pool and reuses it for later
+ * allocations. Free chunks are kept in bins of power-of-two size classes, an allocation takes the
+ * smallest free chunk that fits and splits off the rest, and a freed chunk is merged with its free
+ * neighbours. Memory is only returned to the sub allocator when the BFCAllocator is destroyed.
  *
- * This class provides an implementation of the Allocator interface that allocates memory
- * on a GPU device using CUDA APIs.
+ * The allocator is thread safe.
  */
 class BFCAllocator : public Allocator {
 public:
 
     struct Options {
+        // Extend the pool on demand. If false, total_memory is reserved at construction.
         bool allow_growth = true;
+        // A chunk is not split if the rest is smaller than this fraction of the chunk.
         double fragment_fraction = 0.0;
     };
 
-    BFCAllocator(std::unique_ptr<Allocator> sub_alloc, const size_t& total_memory, const Options& options = Options());
+    /**
+     * @brief Statistics of the pool.
+     */
+    struct Stats {
+        // Number of allocations served.
+        int64_t num_allocs = 0;
+        // Bytes of the chunks in use, including the rounding.
+        size_t bytes_in_use = 0;
+        // Peak of bytes_in_use.
+        size_t peak_bytes_in_use = 0;
+        // Bytes taken from the sub allocator.
+        size_t bytes_reserved = 0;
+        // Largest single allocation.
+        size_t largest_alloc_size = 0;
+        // 1 - (largest free chunk) / (free bytes), 0 for an unfragmented pool.
+        double fragmentation = 0.0;
+    };
+
+    /**
+     * @brief Construct a new BFCAllocator object.
+     *
+     * @param sub_alloc The allocator providing the memory regions of the pool.
+     * @param total_memory The maximal size of the pool in bytes, 0 for no limit.
+     * @param options Options of the pool.
+     */
+    BFCAllocator(std::unique_ptr<Allocator> sub_alloc, const size_t& total_memory, const Options& options);
+
+    /**
+     * @brief Construct a new BFCAllocator object with the default options.
+     */
+    BFCAllocator(std::unique_ptr<Allocator> sub_alloc, const size_t& total_memory);
 
     ~BFCAllocator();
+
     /**
-     * @brief Allocate a block of memory with the given size and default alignment on GPU.
+     * @brief Allocate a block of memory with the given size and default alignment from the pool.
      *
      * @param size The size of the memory block to allocate.
      *
@@ -32,7 +75,7 @@ public:
     void* allocate(size_t size) override;
 
     /**
-     * @brief Allocate a block of memory with the given size and alignment on GPU.
+     * @brief Allocate a block of memory with the given size and alignment from the pool.
      *
      * @param size The size of the memory block to allocate.
      * @param alignment The alignment of the memory block to allocate.
@@ -42,41 +85,60 @@ public:
     void* allocate(size_t size, size_t alignment) override;
 
     /**
-     * @brief Free a block of GPU memory that was previously allocated by this allocator.
+     * @brief Return a block of memory that was previously allocated by this allocator to the pool.
      *
      * @param ptr A pointer to the memory block to free.
      */
     void free(void* ptr) override;
 
+    /**
+     * @brief Get the requested size of a block allocated by this allocator.
+     *
+     * @param ptr The pointer to get the allocated size of.
+     * @return size_t The requested size in bytes, 0 if ptr was not allocated by this allocator.
+     */
+    size_t AllocatedSize(void* ptr) override;
+
     /**
      * @brief Get the type of memory used by the TensorBuffer.
      *
-     * @return MemoryType The type of memory used by the TensorBuffer.
+     * @return MemoryType The type of memory of the sub allocator.
      */
     DeviceType GetDeviceType() override;
 
-    private:
+    /**
+     * @brief Get the statistics of the pool.
+     */
+    Stats GetStats() const;
 
-    // The sub allocator to use for extending the BFC's memory pool.
-    std::unique_ptr<Allocator> sub_alloc_;
+    /**
+     * @brief Get the process-wide pool of CPU memory used by the CPU tensors.
+     *
+     * The pool is never destroyed, so that tensors with static storage can be freed at exit.
+     */
+    static BFCAllocator* GetCPUAllocator();
 
-    struct bin;
-    mutable std::mutex mtx_;
+  private:
 
     // A chunk_handle is an index into the chunks_ vector in BFCAllocator
     // kInvalidChunkHandle means an invalid chunk index.
     typedef size_t chunk_handle_t;
-    static constexpr chunk_handle_t kInvalidChunkHandle = UINT64_MAX;
+    static constexpr chunk_handle_t kInvalidChunkHandle = SIZE_MAX;
 
     typedef int bin_index_t;
     static constexpr int kInvalidBinNum = -1;
     // The following means that the largest bin'd chunk size is 256 << 21 = 512MB.
     static constexpr int kNumBins = 21;
+    // All sizes are rounded up to multiples of kMinAllocationSize, which is also the alignment of the chunks.
+    static constexpr size_t kMinAllocationSize = 256;
+    // Size of the first region taken from the sub allocator, later regions double up to kMaxRegionSize.
+    static constexpr size_t kMinRegionSize = size_t(2) << 20;
+    static constexpr size_t kMaxRegionSize = size_t(1) << 30;
 
     struct chunk {
         // The size of the chunk in bytes.
         size_t size = 0;
-        // The bin index of the chunk.
+        // The bin index of the chunk, kInvalidBinNum if the chunk is in use.
         bin_index_t bin_index = kInvalidBinNum;
         // We sometimes give chunks that are larger than needed to reduce
         // fragmentation.  requested_size keeps track of what the client
@@ -84,51 +146,114 @@ public:
         // strategy is efficient.
         size_t requested_size = 0;
         // allocation_id is set to -1 when the chunk is not in use. It is assigned a
-        // value greater than zero before the chunk is returned from
-        // AllocateRaw, and this value is unique among values assigned by
-        // the parent allocator.
+        // value greater than zero before the chunk is returned from allocate.
         int64_t allocation_id = -1;
         // pointer to granted subbuffer.
-        void* ptr = nullptr;  
+        void* ptr = nullptr;
+        // The neighbours of the chunk in the same region, sorted by address.
         chunk_handle_t next_chunk_handle = kInvalidChunkHandle;
-        // The handle of the previous chunk in the bin.
         chunk_handle_t prev_chunk_handle = kInvalidChunkHandle;
         // Whether the chunk is allocated.
         bool allocated() const { return allocation_id > 0; }
     };
 
-    struct bin {
-        // The size of the chunks in this bin.
-        size_t bin_size = 0;
-        // The number of chunks in this bin.
-        size_t num_chunks = 0;
-        // The handle of the first chunk in the bin.
-        chunk_handle_t first_chunk_handle = kInvalidChunkHandle;
-        // The handle of the last chunk in the bin.
-        chunk_handle_t last_chunk_handle = kInvalidChunkHandle;
-
-        class chunk_comparator {
-          public:
-            explicit chunk_comparator(BFCAllocator* allocator) : allocator_(allocator) {}
-            // Sort first by size and then use pointer address as a tie breaker.
-            bool operator()(const chunk_handle_t ha,
-                            const chunk_handle_t hb) const {
-                const chunk* a = allocator_->chunk_from_handle(ha);
-                const chunk* b = allocator_->chunk_from_handle(hb);
-                if (a->size != b->size) {
-                    return a->size < b->size;
-                }
-                return a->ptr < b->ptr;
+    class chunk_comparator {
+      public:
+        explicit chunk_comparator(BFCAllocator* allocator) : allocator_(allocator) {}
+        // Sort first by size and then use pointer address as a tie breaker.
+        bool operator()(const chunk_handle_t ha, const chunk_handle_t hb) const {
+            const chunk* a = allocator_->chunk_from_handle(ha);
+            const chunk* b = allocator_->chunk_from_handle(hb);
+            if (a->size != b->size) {
+                return a->size < b->size;
             }
+            return a->ptr < b->ptr;
+        }
 
-          private:
-            BFCAllocator* allocator_;  // The parent allocator
-        };
+      private:
+        BFCAllocator* allocator_;  // The parent allocator
+    };
+
+    using free_chunk_set_t = std::set<chunk_handle_t, chunk_comparator>;
 
-        using free_chunk_set_t = std::set<ChunkHandle, ChunkComparator>;
+    struct bin {
+        // The smallest size of the chunks in this bin.
+        size_t bin_size = 0;
+        // The free chunks in this bin.
+        free_chunk_set_t free_chunks;
+        bin(BFCAllocator* allocator, const size_t& size) : bin_size(size), free_chunks(chunk_comparator(allocator)) {}
+    };
+
+    // A memory region taken from the sub allocator.
+    struct region {
+        void* raw_ptr = nullptr;
+        size_t size = 0;
     };
 
-    
+    chunk* chunk_from_handle(const chunk_handle_t& h) { return &chunks_[h]; }
+    const chunk* chunk_from_handle(const chunk_handle_t& h) const { return &chunks_[h]; }
+    chunk_handle_t allocate_chunk();
+    void deallocate_chunk(const chunk_handle_t& h);
+
+    static size_t round_bytes(const size_t& bytes);
+    static bin_index_t bin_num_for_size(const size_t& bytes);
+
+    // Take a new region of at least rounded_bytes from the sub allocator.
+    bool extend(const size_t& rounded_bytes);
+    // Take the smallest free chunk of at least rounded_bytes out of the bins, kInvalidChunkHandle if there is none.
+    chunk_handle_t find_chunk(const size_t& rounded_bytes, const size_t& num_bytes);
+    void insert_free_chunk_into_bin(const chunk_handle_t& h);
+    void remove_free_chunk_from_bin(const chunk_handle_t& h);
+    // Split chunk h so that it has num_bytes, the rest becomes a new free chunk.
+    void split_chunk(const chunk_handle_t& h, const size_t& num_bytes);
+    // Merge chunk h2 into its previous neighbour h1, h2 is deallocated.
+    void merge(const chunk_handle_t& h1, const chunk_handle_t& h2);
+    // Merge the free chunk h with its free neighbours and put it into its bin.
+    void free_and_coalesce(chunk_handle_t h);
+    void* allocate_raw(const size_t& num_bytes, const size_t& alignment);
+
+    // The sub allocator to use for extending the BFC's memory pool.
+    std::unique_ptr<Allocator> sub_alloc_;
+    size_t memory_limit_ = 0;
+    Options options_;
+    size_t curr_region_allocation_bytes_ = kMinRegionSize;
+
+    mutable std::mutex mtx_;
+
+    std::vector<chunk> chunks_;
+    // Handles of the unused entries of chunks_.
+    std::vector<chunk_handle_t> free_chunk_handles_;
+    std::vector<bin> bins_;
+    std::vector<region> regions_;
+    // The chunk of each pointer returned by allocate.
+    std::unordered_map<void*, chunk_handle_t> ptr_to_chunk_;
+
+    int64_t next_allocation_id_ = 1;
+    Stats stats_;
+};
+
+/**
+ * @brief A handle of a shared BFCAllocator.
+ *
+ * TensorBuffer owns and deletes its allocator, so each buffer gets its own handle
+ * while the memory comes from and goes back to the shared pool.
+ */
+class BFCAllocatorRef : public Allocator {
+  public:
+    explicit BFCAllocatorRef(BFCAllocator* pool) : pool_(pool) {}
+
+    void* allocate(size_t size) override { return pool_->allocate(size); }
+
+    void* allocate(size_t size, size_t alignment) override { return pool_->allocate(size, alignment); }
+
+    void free(void* ptr) override { pool_->free(ptr); }
+
+    size_t AllocatedSize(void* ptr) override { return pool_->AllocatedSize(ptr); }
+
+    DeviceType GetDeviceType() override { return pool_->GetDeviceType(); }
+
+  private:
+    BFCAllocator* pool_ = nullptr;
 };
 
 } // namespace base
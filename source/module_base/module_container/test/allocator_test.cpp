@@ -4,6 +4,7 @@
 #include <ATen/core/tensor.h>
 #include <base/core/allocator.h>
 #include <base/core/cpu_allocator.h>
+#include <base/core/bfc_allocator.h>
 
 
 TEST(CPUAllocator, AllocateAndFree) {
@@ -35,4 +36,83 @@ TEST(CPUAllocator, GetDeviceType) {
   container::base::CPUAllocator alloc;
   EXPECT_EQ(container::DeviceType::CpuDevice,
             alloc.GetDeviceType());
-}
\ No newline at end of file
+}
+
+TEST(BFCAllocator, ReuseFreedChunk) {
+  container::base::BFCAllocator alloc(
+      std::unique_ptr<container::base::Allocator>(new container::base::CPUAllocator()), 0);
+  void* ptr = alloc.allocate(1000);
+  EXPECT_NE(nullptr, ptr);
+  EXPECT_EQ(1000, alloc.AllocatedSize(ptr));
+  alloc.free(ptr);
+  // The freed chunk is the best fit for the same size.
+  void* ptr2 = alloc.allocate(1000);
+  EXPECT_EQ(ptr, ptr2);
+  alloc.free(ptr2);
+
+  auto stats = alloc.GetStats();
+  EXPECT_EQ(2, stats.num_allocs);
+  EXPECT_EQ(0, stats.bytes_in_use);
+  EXPECT_EQ(1024, stats.peak_bytes_in_use);
+  EXPECT_EQ(1000, stats.largest_alloc_size);
+  EXPECT_DOUBLE_EQ(0.0, stats.fragmentation);
+
+  EXPECT_EQ(nullptr, alloc.allocate(0));
+}
+
+TEST(BFCAllocator, Coalesce) {
+  container::base::BFCAllocator alloc(
+      std::unique_ptr<container::base::Allocator>(new container::base::CPUAllocator()), 0);
+  void* a = alloc.allocate(1024);
+  void* b = alloc.allocate(1024);
+  void* c = alloc.allocate(1024);
+  EXPECT_EQ(static_cast<char*>(a) + 1024, b);
+  EXPECT_EQ(static_cast<char*>(b) + 1024, c);
+
+  // A hole in the middle of the pool fragments it.
+  alloc.free(b);
+  EXPECT_GT(alloc.GetStats().fragmentation, 0.0);
+
+  // The neighbours are merged back into one free chunk.
+  alloc.free(a);
+  alloc.free(c);
+  EXPECT_DOUBLE_EQ(0.0, alloc.GetStats().fragmentation);
+  void* d = alloc.allocate(3072);
+  EXPECT_EQ(a, d);
+  alloc.free(d);
+}
+
+TEST(BFCAllocator, Alignment) {
+  container::base::BFCAllocator alloc(
+      std::unique_ptr<container::base::Allocator>(new container::base::CPUAllocator()), 0);
+  void* ptr = alloc.allocate(100, 4096);
+  EXPECT_NE(nullptr, ptr);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(ptr) % 4096);
+  EXPECT_EQ(100, alloc.AllocatedSize(ptr));
+  alloc.free(ptr);
+}
+
+TEST(BFCAllocator, MemoryLimit) {
+  container::base::BFCAllocator::Options options;
+  options.allow_growth = false;
+  container::base::BFCAllocator alloc(
+      std::unique_ptr<container::base::Allocator>(new container::base::CPUAllocator()), 4096, options);
+  EXPECT_EQ(4096, alloc.GetStats().bytes_reserved);
+  void* ptr = alloc.allocate(4096);
+  EXPECT_NE(nullptr, ptr);
+  EXPECT_EQ(nullptr, alloc.allocate(1));
+  alloc.free(ptr);
+  EXPECT_EQ(4096, alloc.GetStats().bytes_reserved);
+}
+
+TEST(BFCAllocator, Tensor) {
+  auto pool = container::base::BFCAllocator::GetCPUAllocator();
+  const auto num_allocs = pool->GetStats().num_allocs;
+  {
+    container::Tensor t(container::DataType::DT_DOUBLE, container::TensorShape({16, 16}));
+    EXPECT_EQ(num_allocs + 1, pool->GetStats().num_allocs);
+    EXPECT_EQ(16 * 16 * sizeof(double), pool->AllocatedSize(t.data()));
+  }
+  EXPECT_EQ(0, pool->AllocatedSize(nullptr));
+  EXPECT_EQ(container::DeviceType::CpuDevice, container::base::BFCAllocatorRef(pool).GetDeviceType());
+}
@@ -3,6 +3,7 @@
 
 #include <ATen/core/tensor.h>
 #include <ATen/core/tensor_map.h>
+#include <base/core/bfc_allocator.h>
 
 
 TEST(Tensor, Constructor) {
@@ -300,7 +301,6 @@ TEST(Tensor, Buffer) {
 
 TEST(Tensor, Resize) {
     container::Tensor t1(container::DataType::DT_FLOAT, container::TensorShape({2, 2}));
-    const float* data_ptr1 = t1.data<float>();
 
     container::TensorShape new_shape({3, 3});
     t1.resize(new_shape);
@@ -311,8 +311,10 @@ TEST(Tensor, Resize) {
     // Check if the shape of the tensor object is updated
     EXPECT_EQ(t1.shape(), new_shape);
 
-    // Check if the data buffer of the tensor object is reallocated
-    EXPECT_NE(t1.data<float>(), data_ptr1);
+    // Check if the data buffer of the tensor object is reallocated,
+    // the CPU memory pool may hand out the freed block again
+    EXPECT_EQ(container::base::BFCAllocator::GetCPUAllocator()->AllocatedSize(t1.data()),
+              new_shape.NumElements() * sizeof(float));
 
     // Check if the data buffer is correctly zeroed
     const float* data_ptr2 = t1.data<float>();
@@ -0,0 +1,136 @@
+#include "./opt_LBFGS.h"
+
+#include "module_base/parallel_reduce.h"
+
+namespace ModuleBase
+{
+//
+// Allocate space for the history and the last x and gradient.
+//
+void Opt_LBFGS::allocate(
+    int nx, // length of the solution array x
+    int m // number of (s, y) pairs kept in history
+)
+{
+    this->nx = nx;
+    this->m = m;
+    this->s_hist.assign(static_cast<size_t>(this->m) * this->nx, 0.);
+    this->y_hist.assign(static_cast<size_t>(this->m) * this->nx, 0.);
+    this->rho_hist.assign(this->m, 0.);
+    this->alpha.assign(this->m, 0.);
+    this->x_old.assign(this->nx, 0.);
+    this->gradient_old.assign(this->nx, 0.);
+    this->refresh();
+}
+
+void Opt_LBFGS::setPara(
+    double dV
+)
+{
+    this->dV = dV;
+}
+
+//
+// Drop the history, so that the next direction is the steepest descent one.
+// If nx changes, reallocate space.
+//
+void Opt_LBFGS::refresh(
+    int nx_new // length of new x, default 0 means the length doesn't change
+)
+{
+    if (nx_new != 0 && nx_new != this->nx)
+    {
+        this->allocate(nx_new, this->m);
+        return;
+    }
+    this->iter = 0;
+    this->nhist = 0;
+    this->newest = -1;
+    this->gamma = 1.;
+}
+
+//
+// Get next optimization direction d = -H g with the two-loop recursion.
+// The first call (or the first call after refresh) gives d = -g.
+//
+void Opt_LBFGS::next_direct(
+    double *px, // current x
+    double *pgradient, // df(x)/dx
+    double *rdirect // next direct
+)
+{
+    if (this->iter > 0)
+    {
+        this->update_history(px, pgradient);
+    }
+    for (int i = 0; i < this->nx; ++i)
+    {
+        this->x_old[i] = px[i];
+        this->gradient_old[i] = pgradient[i];
+        rdirect[i] = pgradient[i];
+    }
+    this->iter++;
+
+    // q = g; from the newest pair to the oldest: alpha_i = rho_i <s_i, q>, q = q - alpha_i y_i
+    for (int k = 0; k < this->nhist; ++k)
+    {
+        const int ih = (this->newest - k + this->m) % this->m;
+        const double *s = this->s_hist.data() + static_cast<size_t>(ih) * this->nx;
+        const double *y = this->y_hist.data() + static_cast<size_t>(ih) * this->nx;
+        double sq = this->inner_product(s, rdirect, this->nx);
+        Parallel_Reduce::reduce_double_all(sq);
+        this->alpha[ih] = this->rho_hist[ih] * sq;
+        for (int i = 0; i < this->nx; ++i) rdirect[i] -= this->alpha[ih] * y[i];
+    }
+
+    // r = H0 q; from the oldest pair to the newest: beta = rho_i <y_i, r>, r = r + (alpha_i - beta) s_i
+    for (int i = 0; i < this->nx; ++i) rdirect[i] *= this->gamma;
+    for (int k = this->nhist - 1; k >= 0; --k)
+    {
+        const int ih = (this->newest - k + this->m) % this->m;
+        const double *s = this->s_hist.data() + static_cast<size_t>(ih) * this->nx;
+        const double *y = this->y_hist.data() + static_cast<size_t>(ih) * this->nx;
+        double yr = this->inner_product(y, rdirect, this->nx);
+        Parallel_Reduce::reduce_double_all(yr);
+        const double beta = this->rho_hist[ih] * yr;
+        for (int i = 0; i < this->nx; ++i) rdirect[i] += (this->alpha[ih] - beta) * s[i];
+    }
+
+    for (int i = 0; i < this->nx; ++i) rdirect[i] = -rdirect[i];
+}
+
+//
+// Push (s, y) of the last step into the ring buffer and update gamma.
+// The pair is skipped if the curvature condition <s,y> > 0 does not hold,
+// which keeps H positive definite.
+//
+void Opt_LBFGS::update_history(
+    double *px, // current x
+    double *pgradient // df(x)/dx
+)
+{
+    const int ih = (this->newest + 1) % this->m;
+    double *s = this->s_hist.data() + static_cast<size_t>(ih) * this->nx;
+    double *y = this->y_hist.data() + static_cast<size_t>(ih) * this->nx;
+    double sy_yy[2] = {0., 0.};
+    for (int i = 0; i < this->nx; ++i)
+    {
+        s[i] = px[i] - this->x_old[i];
+        y[i] = pgradient[i] - this->gradient_old[i];
+    }
+    sy_yy[0] = this->inner_product(s, y, this->nx);
+    sy_yy[1] = this->inner_product(y, y, this->nx);
+    Parallel_Reduce::reduce_double_all(sy_yy, 2);
+
+    if (sy_yy[0] <= 1e-12 * sy_yy[1] || sy_yy[1] == 0.)
+    {
+        // the slot of the oldest pair has been overwritten if the buffer is full
+        if (this->nhist == this->m) this->nhist--;
+        return;
+    }
+    this->newest = ih;
+    this->rho_hist[ih] = 1. / sy_yy[0];
+    this->gamma = sy_yy[0] / sy_yy[1];
+    if (this->nhist < this->m) this->nhist++;
+}
+}
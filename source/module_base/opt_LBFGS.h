@@ -0,0 +1,76 @@
+#ifndef OPT_LBFGS_H
+#define OPT_LBFGS_H
+
+#include <vector>
+
+namespace ModuleBase
+{
+//
+// A class designed to deal with optimization problems min{f(x)} with the
+// limited-memory BFGS method.
+// The m most recent pairs s_k = x_{k+1} - x_k and y_k = g_{k+1} - g_k are kept
+// in a ring buffer, and the direction d = -H g is built by the two-loop recursion
+// with the initial inverse Hessian H0 = gamma * I, gamma = <s,y>/<y,y>.
+// See Nocedal J, Wright S J. Numerical Optimization, 2006, Algorithm 7.4.
+// We adopt following abbreviation
+// x -> solution
+// d -> direction
+// g -> gradient
+//
+class Opt_LBFGS
+{
+public:
+    Opt_LBFGS(){};
+    ~Opt_LBFGS(){};
+
+    void allocate(
+        int nx, // length of the solution array x
+        int m = 7 // number of (s, y) pairs kept in history
+    );
+    void setPara(
+        double dV
+    );
+    void refresh(
+        int nx_new=0 // length of new x, default 0 means the length doesn't change
+    );
+
+    void next_direct(
+        double *px, // current x
+        double *pgradient, // df(x)/dx
+        double *rdirect // next direct
+    );
+
+    int get_iter() {return this->iter;}
+    int get_nhistory() {return this->nhist;}
+    double get_gamma() {return this->gamma;}
+
+private:
+    double dV = 1.;
+    int nx = 0; // length of the solution array x
+    int m = 7; // max number of (s, y) pairs
+    int iter = 0; // number of iteration
+    int nhist = 0; // number of (s, y) pairs stored now
+    int newest = -1; // position of the newest pair in the ring buffer
+    double gamma = 1.; // H0 = gamma * I
+
+    std::vector<double> s_hist; // m * nx, x_{k+1} - x_k
+    std::vector<double> y_hist; // m * nx, g_{k+1} - g_k
+    std::vector<double> rho_hist; // m, 1/<y,s>
+    std::vector<double> alpha; // m, work space of the two-loop recursion
+    std::vector<double> x_old; // x of last step
+    std::vector<double> gradient_old; // gradient of last step
+
+    void update_history(
+        double *px, // current x
+        double *pgradient // df(x)/dx
+    );
+    double inner_product(const double *pa, const double *pb, int length)
+    {
+        double innerproduct = 0.;
+        for (int i = 0; i < length; ++i) innerproduct += pa[i] * pb[i];
+        innerproduct *= this->dV;
+        return innerproduct;
+    }
+};
+}
+#endif
@@ -0,0 +1,191 @@
+#include "packed_buffer.h"
+
+#include "parallel_common.h"
+#include "tool_quit.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ModuleBase
+{
+
+namespace
+{
+// identifies the cache files and their layout, to be changed when the layout changes
+const char cache_magic[8] = {'A', 'B', 'A', 'C', 'U', 'S', 'P', '1'};
+
+uint64_t fnv1a(const char* p, const size_t& n, uint64_t h = 14695981039346656037ULL)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        h ^= static_cast<unsigned char>(p[i]);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+std::string to_hex(const uint64_t& h)
+{
+    std::stringstream ss;
+    ss << std::hex;
+    ss.width(16);
+    ss.fill('0');
+    ss << h;
+    return ss.str();
+}
+} // namespace
+
+void PackedBuffer::pack(const std::string& s)
+{
+    const int n = s.size();
+    this->pack(n);
+    this->data.insert(this->data.end(), s.begin(), s.end());
+}
+
+void PackedBuffer::pack(const std::string* s, const int& n)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        this->pack(s[i]);
+    }
+}
+
+void PackedBuffer::unpack(std::string& s)
+{
+    int n = 0;
+    this->unpack(n);
+    this->check_size(n);
+    s.assign(this->data.data() + this->pos, n);
+    this->pos += n;
+}
+
+void PackedBuffer::unpack(std::string* s, const int& n)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        this->unpack(s[i]);
+    }
+}
+
+void PackedBuffer::clear()
+{
+    this->data.clear();
+    this->pos = 0;
+}
+
+void PackedBuffer::check_size(const size_t& bytes) const
+{
+    if (this->pos + bytes > this->data.size())
+    {
+        ModuleBase::WARNING_QUIT("PackedBuffer::unpack", "unpacking beyond the end of the buffer");
+    }
+}
+
+void PackedBuffer::bcast()
+{
+#ifdef __MPI
+    int n = this->data.size();
+    Parallel_Common::bcast_int(n);
+    this->data.resize(n);
+    Parallel_Common::bcast_char(this->data.data(), n);
+#endif
+    this->pos = 0;
+}
+
+std::string PackedBuffer::cache_file(const std::string& dir, const std::string& key)
+{
+    return dir + "/" + to_hex(fnv1a(key.data(), key.size())) + ".bin";
+}
+
+bool PackedBuffer::save(const std::string& dir, const std::string& key) const
+{
+    mkdir(dir.c_str(), 0755);
+    const std::string file = cache_file(dir, key);
+    const std::string tmp = file + ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream ofs(tmp.c_str(), std::ios::binary);
+        if (!ofs)
+        {
+            return false;
+        }
+        const int nkey = key.size();
+        const uint64_t ndata = this->data.size();
+        ofs.write(cache_magic, sizeof(cache_magic));
+        ofs.write(reinterpret_cast<const char*>(&nkey), sizeof(nkey));
+        ofs.write(key.data(), nkey);
+        ofs.write(reinterpret_cast<const char*>(&ndata), sizeof(ndata));
+        ofs.write(this->data.data(), ndata);
+        if (!ofs)
+        {
+            ofs.close();
+            std::remove(tmp.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tmp.c_str(), file.c_str()) != 0)
+    {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool PackedBuffer::load(const std::string& dir, const std::string& key)
+{
+    this->clear();
+    std::ifstream ifs(cache_file(dir, key).c_str(), std::ios::binary);
+    if (!ifs)
+    {
+        return false;
+    }
+    char magic[sizeof(cache_magic)];
+    int nkey = 0;
+    uint64_t ndata = 0;
+    ifs.read(magic, sizeof(magic));
+    ifs.read(reinterpret_cast<char*>(&nkey), sizeof(nkey));
+    if (!ifs || std::memcmp(magic, cache_magic, sizeof(magic)) != 0 || nkey != static_cast<int>(key.size()))
+    {
+        return false;
+    }
+    std::string key_file(nkey, ' ');
+    ifs.read(&key_file[0], nkey);
+    ifs.read(reinterpret_cast<char*>(&ndata), sizeof(ndata));
+    if (!ifs || key_file != key)
+    {
+        return false;
+    }
+    this->data.resize(ndata);
+    ifs.read(this->data.data(), ndata);
+    if (!ifs)
+    {
+        this->clear();
+        return false;
+    }
+    return true;
+}
+
+std::string PackedBuffer::file_key(const std::string& file)
+{
+    std::ifstream ifs(file.c_str(), std::ios::binary);
+    if (!ifs)
+    {
+        return "";
+    }
+    uint64_t h = 14695981039346656037ULL;
+    uint64_t n = 0;
+    std::vector<char> chunk(1 << 16);
+    while (ifs)
+    {
+        ifs.read(chunk.data(), chunk.size());
+        const size_t nread = ifs.gcount();
+        h = fnv1a(chunk.data(), nread, h);
+        n += nread;
+    }
+    return std::to_string(n) + "-" + to_hex(h);
+}
+
+} // namespace ModuleBase
@@ -0,0 +1,106 @@
+#ifndef PACKED_BUFFER_H
+#define PACKED_BUFFER_H
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ModuleBase
+{
+
+/**
+ * @brief A byte buffer into which values, arrays and strings are packed one after another.
+ *
+ * Data parsed on rank 0 is packed once and sent to all ranks with a single broadcast, instead of
+ * one broadcast per field. The same buffer can be kept in a binary cache file, so that a file
+ * with the same content does not have to be parsed again by a later run.
+ *
+ * The values are unpacked in the order in which they were packed.
+ */
+class PackedBuffer
+{
+  public:
+    PackedBuffer(){};
+    ~PackedBuffer(){};
+
+    template <typename T>
+    void pack(const T& value)
+    {
+        static_assert(std::is_arithmetic<T>::value, "only arithmetic types can be packed");
+        this->pack(&value, 1);
+    }
+
+    template <typename T>
+    void pack(const T* values, const int& n)
+    {
+        static_assert(std::is_arithmetic<T>::value, "only arithmetic types can be packed");
+        const char* p = reinterpret_cast<const char*>(values);
+        this->data.insert(this->data.end(), p, p + n * sizeof(T));
+    }
+
+    void pack(const std::string& s);
+    void pack(const std::string* s, const int& n);
+
+    template <typename T>
+    void unpack(T& value)
+    {
+        this->unpack(&value, 1);
+    }
+
+    template <typename T>
+    void unpack(T* values, const int& n)
+    {
+        static_assert(std::is_arithmetic<T>::value, "only arithmetic types can be unpacked");
+        const size_t bytes = n * sizeof(T);
+        this->check_size(bytes);
+        std::memcpy(values, this->data.data() + this->pos, bytes);
+        this->pos += bytes;
+    }
+
+    void unpack(std::string& s);
+    void unpack(std::string* s, const int& n);
+
+    /// clear the buffer and the read position
+    void clear();
+
+    /// size of the buffer in bytes
+    size_t size() const { return this->data.size(); }
+
+    /// broadcast the buffer of rank 0 to all ranks of MPI_COMM_WORLD, the read position is reset
+    void bcast();
+
+    /**
+     * @brief write the buffer to the cache file of key in dir
+     *
+     * The file is written to a temporary name first and then renamed, so that runs sharing the
+     * directory never see a partially written file.
+     *
+     * @return false if the file cannot be written
+     */
+    bool save(const std::string& dir, const std::string& key) const;
+
+    /**
+     * @brief read the buffer from the cache file of key in dir
+     *
+     * @return false if there is no cache file for key or it is damaged, the buffer is then empty
+     */
+    bool load(const std::string& dir, const std::string& key);
+
+    /// a key of the content of file: its size and 64-bit FNV-1a hash, empty if the file cannot be read
+    static std::string file_key(const std::string& file);
+
+  private:
+    /// quit if fewer than bytes are left to unpack
+    void check_size(const size_t& bytes) const;
+
+    /// name of the cache file of key in dir
+    static std::string cache_file(const std::string& dir, const std::string& key);
+
+    std::vector<char> data;
+    size_t pos = 0;
+};
+
+} // namespace ModuleBase
+
+#endif
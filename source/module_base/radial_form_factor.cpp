@@ -0,0 +1,104 @@
+#include "radial_form_factor.h"
+
+#include "constants.h"
+#include "cubic_spline.h"
+#include "spherical_bessel_transformer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace ModuleBase
+{
+
+void RadialFormFactor::build(const int l,
+                             const int mesh,
+                             const double* r,
+                             const double* in,
+                             const int p,
+                             const double qmax)
+{
+    assert(l >= 0 && mesh > 1 && p <= 2 && qmax >= 0.0);
+
+    // the uniform grid x[i] = i*dr spans [0, n*dr] and the transform is obtained at y[j] = j*dq
+    // with dq = pi/(n*dr), so dr limits the largest q and n*dr the q spacing.
+    // rcut is put on the grid and n is a power of two, for which the FFTs are the fastest.
+    const double rcut = r[mesh - 1];
+    const double dr_target = (qmax > 0.0) ? std::min(dr_max_, PI / qmax) : dr_max_;
+    const int nr = static_cast<int>(std::ceil(rcut / dr_target));
+    const double dr = rcut / nr;
+    int n = 1;
+    while (n < nr || n * dr < PI / dq_max_)
+    {
+        n *= 2;
+    }
+    const int ngrid = n + 1;
+    this->dq_ = PI / (n * dr);
+
+    // interpolate F onto the uniform grid, F is zero beyond rcut
+    std::vector<double> f(ngrid, 0.0);
+    std::vector<double> s(mesh);
+    CubicSpline::build(mesh, r, in, s.data());
+
+    int nbelow = 0;
+    for (; nbelow <= nr && nbelow * dr < r[0]; ++nbelow)
+    {
+        // below the first mesh point F(x) is taken as F(r[0])
+        f[nbelow] = (nbelow == 0) ? (p == 0 ? in[0] : 0.0) : in[0] * std::pow(nbelow * dr / r[0], p);
+    }
+    if (nr + 1 > nbelow)
+    {
+        std::vector<double> x(nr + 1 - nbelow);
+        for (size_t i = 0; i < x.size(); ++i)
+        {
+            x[i] = std::min((i + nbelow) * dr, rcut);
+        }
+        CubicSpline::eval(mesh, r, in, s.data(), x.size(), x.data(), &f[nbelow]);
+    }
+
+    // the FFT sums over the grid points, which is the trapezoidal rule for a function that vanishes
+    // at both ends; halving the value at rcut keeps it so for a function truncated at rcut
+    f[nr] *= 0.5;
+
+    std::vector<double> g(ngrid);
+    SphericalBesselTransformer sbt;
+    sbt.radrfft(l, ngrid, n * dr, f.data(), g.data(), p);
+
+    // radrfft carries a prefactor of sqrt(2/pi)
+    const int nq = std::min(static_cast<int>(qmax / this->dq_) + 3, ngrid);
+    const double pref = std::sqrt(PI / 2.0);
+    this->value_.resize(nq);
+    std::transform(g.begin(), g.begin() + nq, this->value_.begin(), [pref](const double& v) { return v * pref; });
+
+    std::vector<double> q(nq);
+    for (int j = 0; j < nq; ++j)
+    {
+        q[j] = j * this->dq_;
+    }
+    this->deriv_.resize(nq);
+    CubicSpline::build(nq, q.data(), this->value_.data(), this->deriv_.data());
+}
+
+void RadialFormFactor::eval(const int n, const double* q, double* out) const
+{
+    if (n > 0)
+    {
+        CubicSpline::eval_uniform(this->value_.size(),
+                                  0.0,
+                                  this->dq_,
+                                  this->value_.data(),
+                                  this->deriv_.data(),
+                                  n,
+                                  q,
+                                  out);
+    }
+}
+
+double RadialFormFactor::eval(const double q) const
+{
+    double out = 0.0;
+    this->eval(1, &q, &out);
+    return out;
+}
+
+} // namespace ModuleBase
@@ -0,0 +1,80 @@
+#ifndef RADIAL_FORM_FACTOR_H_
+#define RADIAL_FORM_FACTOR_H_
+
+#include <vector>
+
+namespace ModuleBase
+{
+
+/**
+ * @brief Tabulated spherical Bessel transform of a radial function given on an arbitrary mesh.
+ *
+ * Form factors of pseudopotentials and atomic densities read
+ *
+ *                   / rcut     2
+ *          G(q) =   |      dr r  F(r) j (q*r)
+ *                   /  0               l
+ *
+ * where F(r) is given on the (usually logarithmic) radial mesh of the pseudopotential file.
+ * Instead of integrating once for every |G| shell, this class interpolates F(r) onto a uniform
+ * grid, transforms it with SphericalBesselTransformer::radrfft and keeps G(q) on a uniform q grid,
+ * from which the values on the G shells are obtained by cubic spline interpolation.
+ *
+ * Usage:
+ *
+ *      RadialFormFactor ff;
+ *
+ *      // in[ir] = pow(r[ir], p) * F(r[ir]), tabulated for 0 <= q <= qmax
+ *      ff.build(l, mesh, r, in, p, qmax);
+ *
+ *      // G(q[i]), each q[i] within [0, qmax]
+ *      ff.eval(n, q, out);
+ *
+ */
+class RadialFormFactor
+{
+  public:
+    RadialFormFactor(){};
+    ~RadialFormFactor(){};
+
+    /**
+     * @brief Tabulates the l-th order transform of F(r) for 0 <= q <= qmax.
+     *
+     * @param[in]   l       order of the transform
+     * @param[in]   mesh    number of mesh points, F(r) is taken as zero beyond r[mesh-1]
+     * @param[in]   r       strictly increasing radial mesh
+     * @param[in]   in      input values, in[ir] = pow(r[ir], p) * F(r[ir])
+     * @param[in]   p       exponent of the extra power term in input values, must not exceed 2
+     * @param[in]   qmax    largest q at which the transform will be evaluated
+     */
+    void build(const int l, const int mesh, const double* r, const double* in, const int p, const double qmax);
+
+    /// out[i] = G(q[i]), every q[i] must be within [0, qmax]
+    void eval(const int n, const double* q, double* out) const;
+
+    /// G(q) at a single q within [0, qmax]
+    double eval(const double q) const;
+
+    /// the largest q of the table
+    double qmax() const { return (this->value_.size() - 1) * this->dq_; }
+
+  private:
+    /// largest spacing of the uniform radial grid, in Bohr
+    static constexpr double dr_max_ = 0.005;
+
+    /// largest spacing of the q grid, in 1/Bohr
+    static constexpr double dq_max_ = 0.005;
+
+    /// spacing of the q grid
+    double dq_ = 0.0;
+
+    /// G(i*dq_)
+    std::vector<double> value_;
+
+    /// dG/dq at i*dq_, defining the cubic spline
+    std::vector<double> deriv_;
+};
+
+} // namespace ModuleBase
+
+#endif
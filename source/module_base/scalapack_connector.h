@@ -86,6 +86,38 @@ extern "C"
 		const double* abstol, int* m, int* nz, double* w, const double*orfac, std::complex<double>* Z, const int* iz, const int* jz, const int*descz,
 		std::complex<double>* work, int* lwork, double* rwork, int* lrwork, int*iwork, int*liwork, int* ifail, int*iclustr, double*gap, int* info);
 
+	void pdsygst_(const int* ibtype, const char* uplo, const int* n,
+		double* A, const int* ia, const int* ja, const int* desca,
+		const double* B, const int* ib, const int* jb, const int* descb,
+		double* scale, int* info);
+	void pzhegst_(const int* ibtype, const char* uplo, const int* n,
+		std::complex<double>* A, const int* ia, const int* ja, const int* desca,
+		const std::complex<double>* B, const int* ib, const int* jb, const int* descb,
+		double* scale, int* info);
+
+	void pdsyevx_(const char* jobz, const char* range, const char* uplo,
+		const int* n, double* A, const int* ia, const int* ja, const int*desca,
+		const double* vl, const double* vu, const int* il, const int* iu,
+		const double* abstol, int* m, int* nz, double* w, const double*orfac, double* Z, const int* iz, const int* jz, const int*descz,
+		double* work, int* lwork, int*iwork, int*liwork, int* ifail, int*iclustr, double*gap, int* info);
+	void pzheevx_(const char* jobz, const char* range, const char* uplo,
+		const int* n, std::complex<double>* A, const int* ia, const int* ja, const int*desca,
+		const double* vl, const double* vu, const int* il, const int* iu,
+		const double* abstol, int* m, int* nz, double* w, const double*orfac, std::complex<double>* Z, const int* iz, const int* jz, const int*descz,
+		std::complex<double>* work, int* lwork, double* rwork, int* lrwork, int*iwork, int*liwork, int* ifail, int*iclustr, double*gap, int* info);
+
+	void pdtrsm_(const char* side, const char* uplo, const char* transa, const char* diag, const int* m, const int* n,
+		const double* alpha, const double* a, const int* ia, const int* ja, const int* desca,
+		double* b, const int* ib, const int* jb, const int* descb);
+	void pztrsm_(const char* side, const char* uplo, const char* transa, const char* diag, const int* m, const int* n,
+		const std::complex<double>* alpha, const std::complex<double>* a, const int* ia, const int* ja, const int* desca,
+		std::complex<double>* b, const int* ib, const int* jb, const int* descb);
+
+	void pzgetrs_(
+		const char *trans, const int *n, const int *nrhs,
+		const std::complex<double> *A, const int *ia, const int *ja, const int *desca, const int *ipiv,
+		std::complex<double> *B, const int *ib, const int *jb, const int *descb, int *info);
+
 	void pzgetri_(
 		const int *n, 
 		const std::complex<double> *A, const int *ia, const int *ja, const int *desca,
@@ -154,6 +186,15 @@ public:
 		pzgetri_(&n, A, &ia, &ja, desca, ipiv, work, lwork, iwork, liwork, info);
 	}
 
+	static inline
+	void getrs(
+		const char trans, const int n, const int nrhs,
+		const std::complex<double> *A, const int ia, const int ja, const int *desca, const int *ipiv,
+		std::complex<double> *B, const int ib, const int jb, const int *descb, int *info)
+	{
+		pzgetrs_(&trans, &n, &nrhs, A, &ia, &ja, desca, ipiv, B, &ib, &jb, descb, info);
+	}
+
 	static inline
 	void tranu(
 		const int m, const int n,
@@ -1,6 +1,7 @@
 #include "module_base/cubic_spline.h"
 
 #include <cmath>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "module_base/constants.h"
@@ -25,6 +26,9 @@ using ModuleBase::PI;
  *
  *  - eval
  *      Evaluates the interpolant at certain points.
+ *
+ *  - eval_uniform
+ *      Evaluates the interpolant with evenly spaced knots.
  *                                                          */
 class CubicSplineTest : public ::testing::Test
 {
@@ -1448,6 +1452,68 @@ TEST_F(CubicSplineTest, SecondDeriv)
     }
 }
 
+TEST_F(CubicSplineTest, UniformFastPath)
+{
+    // knots do not start from zero to make sure the offset is handled
+    int n = 2001;
+    double x0 = 0.5;
+    double dx = 0.01;
+    std::vector<double> x(n), y(n), s(n);
+    for (int i = 0; i != n; ++i)
+    {
+        x[i] = x0 + i * dx;
+        y[i] = std::sin(x[i]) * std::exp(-0.1 * x[i]);
+    }
+
+    CubicSpline::build(n, x.data(), y.data(), s.data());
+
+    CubicSpline cubspl;
+    cubspl.build(n, x.data(), y.data());
+
+    int ni = 100000;
+    std::vector<double> xi(ni);
+    for (int i = 0; i != ni; ++i)
+    {
+        xi[i] = x0 + (x[n - 1] - x0) * std::pow(std::sin(0.37 * i), 2);
+    }
+    xi[0] = x[0];
+    xi[ni - 1] = x[n - 1];
+
+    std::vector<double> y_ref(ni), dy_ref(ni), y1(ni), dy1(ni), d2y1(ni), y2(ni), dy2(ni), d2y2(ni);
+
+    // reference: binary search + scalar evaluation of each piece
+    for (int i = 0; i != ni; ++i)
+    {
+        int p = std::min(static_cast<int>(std::upper_bound(x.begin(), x.end(), xi[i]) - x.begin()) - 1, n - 2);
+        double h = x[p + 1] - x[p];
+        double dd = (y[p + 1] - y[p]) / h;
+        double c3 = (s[p] + s[p + 1] - 2.0 * dd) / (h * h);
+        double c2 = (dd - s[p]) / h - c3 * h;
+        double w = xi[i] - x[p];
+        y_ref[i] = ((c3 * w + c2) * w + s[p]) * w + y[p];
+        dy_ref[i] = (3.0 * c3 * w + 2.0 * c2) * w + s[p];
+    }
+
+    CubicSpline::eval_uniform(n, x0, dx, y.data(), s.data(), ni, xi.data(), y1.data(), dy1.data(), d2y1.data());
+    cubspl.eval(ni, xi.data(), y2.data(), dy2.data(), d2y2.data());
+
+    for (int i = 0; i != ni; ++i)
+    {
+        EXPECT_NEAR(y1[i], y_ref[i], 1e-12);
+        EXPECT_NEAR(dy1[i], dy_ref[i], 1e-10);
+        EXPECT_NEAR(y2[i], y_ref[i], 1e-12);
+        EXPECT_NEAR(dy2[i], dy_ref[i], 1e-10);
+        EXPECT_NEAR(d2y2[i], d2y1[i], 1e-8);
+    }
+
+    // second derivatives should be close to the analytical ones
+    for (int i = 0; i != ni; ++i)
+    {
+        double d2y_exact = -std::exp(-0.1 * xi[i]) * (0.99 * std::sin(xi[i]) + 0.2 * std::cos(xi[i]));
+        EXPECT_NEAR(d2y1[i], d2y_exact, 1e-3);
+    }
+}
+
 int main(int argc, char** argv)
 {
 
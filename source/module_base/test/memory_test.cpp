@@ -22,6 +22,8 @@ namespace GlobalV
  *   - print_all
  *     - print memory consumed (> MB) in a
  *     - std::ofstream file
+ *   - record_pool
+ *     - statistics of a memory pool are printed by print_all
  */
 
 #define private public
@@ -137,6 +139,24 @@ TEST_F(MemoryTest, printall)
 	ifs.close();
 }
 
+TEST_F(MemoryTest, RecordPool)
+{
+	ModuleBase::Memory::record_pool("Tensor_Pool", 8*1024*1024, 6*1024*1024, 42, 0.25);
+	// the same pool is updated
+	ModuleBase::Memory::record_pool("Tensor_Pool", 16*1024*1024, 12*1024*1024, 84, 0.5);
+	EXPECT_EQ(ModuleBase::Memory::pools.size(), 1);
+	EXPECT_DOUBLE_EQ(ModuleBase::Memory::pools[0].peak, 12.0);
+	EXPECT_EQ(ModuleBase::Memory::pools[0].num_allocs, 84);
+	ofs.open("tmp");
+	ModuleBase::Memory::print_all(ofs);
+	ofs.close();
+	ifs.open("tmp");
+	std::string str((std::istreambuf_iterator<char>(ifs)),std::istreambuf_iterator<char>());
+	ifs.close();
+	EXPECT_THAT(str,testing::HasSubstr("Tensor_Pool"));
+	EXPECT_THAT(str,testing::HasSubstr("84 allocations, fragmentation 0.5"));
+}
+
 TEST_F(MemoryTest, finish)
 {
 	*ModuleBase::Memory::name = "tmp_name";
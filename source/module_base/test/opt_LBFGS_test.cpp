@@ -0,0 +1,159 @@
+#include "gtest/gtest.h"
+#include "../opt_LBFGS.h"
+#include "../opt_DCsrch.h"
+#include "../global_function.h"
+#include "./opt_test_tools.h"
+
+#define DOUBLETHRESHOLD 1e-5
+
+class LBFGS_test : public testing::Test
+{
+protected:
+    ModuleBase::Opt_LBFGS lbfgs;
+    ModuleBase::Opt_DCsrch ds;
+    TestTools tools;
+    int maxiter = 500;
+    double step = 1.;
+    double residual = 10.;
+    double tol = 1e-5;
+    int final_iter = 0;
+    int nfunc = 0; // number of function evaluations
+    char *task = NULL;
+    double *p = NULL;
+    double *x = NULL;
+
+    void SetUp()
+    {
+        lbfgs.setPara(1.);
+        lbfgs.allocate(tools.nx, 5);
+        task = new char[60];
+        p = new double[tools.nx];
+        x = new double[tools.nx];
+    }
+
+    void TearDown()
+    {
+        delete[] task;
+        delete[] p;
+        delete[] x;
+    }
+
+    void Solve(int func_label)
+    {
+        lbfgs.refresh();
+        ds.set_paras(1e-4, 9e-1, 1e-12, 0., 12.);
+        residual = 10.;
+        final_iter = 0;
+        nfunc = 0;
+        for (int i = 0; i < tools.nx; ++i)
+        {
+            x[i] = 0;
+            p[i] = 0;
+        }
+
+        double f = 0;
+        double g = 0;
+        double *gradient = new double[3];
+        double *temp_x = new double[3];
+        ModuleBase::GlobalFunc::ZEROS(gradient, 3);
+        ModuleBase::GlobalFunc::ZEROS(temp_x, 3);
+
+        for (int iter = 0; iter < maxiter; ++iter)
+        {
+            tools.dfuncdx(x, gradient, func_label);
+            residual = 0;
+            for (int i = 0; i<3 ;++i) residual += gradient[i] * gradient[i];
+            if (residual < tol)
+            {
+                final_iter = iter;
+                break;
+            }
+            lbfgs.next_direct(x, gradient, p);
+            // the quasi-Newton step is tried first
+            step = 1.;
+            for (int i = 0; i < 3; ++i) temp_x[i] = x[i];
+            task[0] = 'S'; task[1] = 'T'; task[2] = 'A'; task[3] = 'R'; task[4] = 'T';
+            while (true)
+            {
+                f = tools.func(temp_x, func_label);
+                g = tools.dfuncdstp(temp_x, p, func_label);
+                nfunc++;
+                ds.dcSrch(f, g, step, task);
+                if (task[0] == 'F' && task[1] == 'G')
+                {
+                    for (int j = 0; j < 3; ++j) temp_x[j] = x[j] + step * p[j];
+                    continue;
+                }
+                else
+                {
+                    break;
+                }
+            }
+            for (int i = 0; i < 3; ++i) x[i] += step * p[i];
+        }
+        delete[] temp_x;
+        delete[] gradient;
+    }
+};
+
+TEST_F(LBFGS_test, First_Direct_Is_Steepest_Descent)
+{
+    double gradient[3] = {1., -2., 3.};
+    lbfgs.next_direct(x, gradient, p);
+    EXPECT_DOUBLE_EQ(p[0], -1.);
+    EXPECT_DOUBLE_EQ(p[1], 2.);
+    EXPECT_DOUBLE_EQ(p[2], -3.);
+    EXPECT_EQ(lbfgs.get_nhistory(), 0);
+    EXPECT_EQ(lbfgs.get_iter(), 1);
+}
+
+TEST_F(LBFGS_test, Secant_Equation)
+{
+    // with a single pair, H y = s must hold
+    double x0[3] = {0., 0., 0.};
+    double x1[3] = {0.3, -0.2, 0.5};
+    double g0[3] = {0., 0., 0.};
+    double g1[3] = {0., 0., 0.};
+    tools.dfuncdx(x0, g0, 0);
+    tools.dfuncdx(x1, g1, 0);
+    lbfgs.next_direct(x0, g0, p);
+    lbfgs.next_direct(x1, g1, p);
+    ASSERT_EQ(lbfgs.get_nhistory(), 1);
+
+    // feed y = g1 - g0 at the same x, the new pair (s = 0) is rejected and d = -H y = -s
+    double y[3] = {g1[0] - g0[0], g1[1] - g0[1], g1[2] - g0[2]};
+    lbfgs.next_direct(x1, y, p);
+    EXPECT_EQ(lbfgs.get_nhistory(), 1);
+    for (int i = 0; i < 3; ++i) EXPECT_NEAR(p[i], -(x1[i] - x0[i]), 1e-12);
+}
+
+TEST_F(LBFGS_test, LBFGS_Solve_LinearEq)
+{
+    tol = 1e-14;
+    Solve(0);
+    EXPECT_NEAR(x[0], 0.5, DOUBLETHRESHOLD);
+    EXPECT_NEAR(x[1], 0., DOUBLETHRESHOLD);
+    EXPECT_NEAR(x[2], 1.5, DOUBLETHRESHOLD);
+    EXPECT_LE(final_iter, 10);
+    EXPECT_EQ(lbfgs.get_iter(), final_iter);
+}
+
+TEST_F(LBFGS_test, LBFGS_Min_Func)
+{
+    Solve(1);
+    EXPECT_LT(residual, tol);
+    EXPECT_GT(final_iter, 0);
+    EXPECT_EQ(lbfgs.get_iter(), final_iter);
+    EXPECT_GT(lbfgs.get_gamma(), 0.);
+    EXPECT_LE(lbfgs.get_nhistory(), 5);
+}
+
+TEST_F(LBFGS_test, Refresh)
+{
+    Solve(0);
+    EXPECT_GT(lbfgs.get_nhistory(), 0);
+    lbfgs.refresh();
+    EXPECT_EQ(lbfgs.get_nhistory(), 0);
+    EXPECT_EQ(lbfgs.get_iter(), 0);
+    EXPECT_DOUBLE_EQ(lbfgs.get_gamma(), 1.);
+}
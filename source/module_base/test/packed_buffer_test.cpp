@@ -0,0 +1,112 @@
+#include "../packed_buffer.h"
+#include "../global_variable.h"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+/************************************************
+ *  unit test of class PackedBuffer
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - PackedBuffer::pack, PackedBuffer::unpack
+ *     - values, arrays and strings come back in the order they were packed
+ *   - PackedBuffer::save, PackedBuffer::load
+ *     - a saved buffer is loaded back with the same key
+ *     - a different key, or a missing directory, gives no buffer
+ *   - PackedBuffer::file_key
+ *     - the key changes with the content of the file, and is empty for a missing file
+ */
+
+class PackedBufferTest : public testing::Test
+{
+  protected:
+    std::string dir = "packed_buffer_cache";
+
+    void TearDown() override
+    {
+        std::system(("rm -rf " + dir).c_str());
+        std::remove("packed_buffer_test.txt");
+    }
+
+    void fill(ModuleBase::PackedBuffer& buf)
+    {
+        const double x[3] = {1.5, -2.25, 1e-300};
+        const std::string s[2] = {"", "Si.upf"};
+        buf.pack(7);
+        buf.pack(true);
+        buf.pack(x, 3);
+        buf.pack(std::string("PBE"));
+        buf.pack(s, 2);
+    }
+
+    void check(ModuleBase::PackedBuffer& buf)
+    {
+        int n = 0;
+        bool b = false;
+        double x[3];
+        std::string f;
+        std::string s[2];
+        buf.unpack(n);
+        buf.unpack(b);
+        buf.unpack(x, 3);
+        buf.unpack(f);
+        buf.unpack(s, 2);
+        EXPECT_EQ(n, 7);
+        EXPECT_TRUE(b);
+        EXPECT_EQ(x[0], 1.5);
+        EXPECT_EQ(x[1], -2.25);
+        EXPECT_EQ(x[2], 1e-300);
+        EXPECT_EQ(f, "PBE");
+        EXPECT_EQ(s[0], "");
+        EXPECT_EQ(s[1], "Si.upf");
+    }
+};
+
+TEST_F(PackedBufferTest, PackUnpack)
+{
+    ModuleBase::PackedBuffer buf;
+    fill(buf);
+    EXPECT_EQ(buf.size(), 4 * sizeof(int) + sizeof(bool) + 3 * sizeof(double) + 3 + 6);
+    check(buf);
+    buf.clear();
+    EXPECT_EQ(buf.size(), 0);
+}
+
+TEST_F(PackedBufferTest, SaveLoad)
+{
+    ModuleBase::PackedBuffer buf;
+    fill(buf);
+    EXPECT_TRUE(buf.save(dir, "pp 123-abc"));
+
+    ModuleBase::PackedBuffer cached;
+    EXPECT_TRUE(cached.load(dir, "pp 123-abc"));
+    EXPECT_EQ(cached.size(), buf.size());
+    check(cached);
+
+    EXPECT_FALSE(cached.load(dir, "pp 123-abd"));
+    EXPECT_EQ(cached.size(), 0);
+    EXPECT_FALSE(cached.load("no_such_dir", "pp 123-abc"));
+}
+
+TEST_F(PackedBufferTest, FileKey)
+{
+    EXPECT_EQ(ModuleBase::PackedBuffer::file_key("no_such_file"), "");
+
+    std::ofstream ofs("packed_buffer_test.txt");
+    ofs << "PP_HEADER 1";
+    ofs.close();
+    const std::string key1 = ModuleBase::PackedBuffer::file_key("packed_buffer_test.txt");
+    EXPECT_EQ(key1.substr(0, 3), "11-");
+    EXPECT_EQ(ModuleBase::PackedBuffer::file_key("packed_buffer_test.txt"), key1);
+
+    ofs.open("packed_buffer_test.txt");
+    ofs << "PP_HEADER 2";
+    ofs.close();
+    const std::string key2 = ModuleBase::PackedBuffer::file_key("packed_buffer_test.txt");
+    EXPECT_NE(key2, key1);
+    EXPECT_EQ(key2.size(), key1.size());
+}
@@ -0,0 +1,132 @@
+#include "module_base/radial_form_factor.h"
+
+#include "gtest/gtest.h"
+#include "module_base/constants.h"
+
+#include <cmath>
+#include <vector>
+
+#ifdef __MPI
+#include <mpi.h>
+#endif
+
+using ModuleBase::PI;
+using ModuleBase::RadialFormFactor;
+
+/***********************************************************
+ *      Unit test of class RadialFormFactor
+ ***********************************************************/
+
+/*! Tested functions:
+ *
+ *  - build & eval
+ *      - Tabulates the spherical Bessel transform of a radial
+ *        function given on a logarithmic mesh and evaluates
+ *        it at arbitrary q.
+ *
+ *                                                          */
+
+class RadialFormFactorTest : public ::testing::Test
+{
+  protected:
+    void SetUp()
+    {
+        // logarithmic mesh of the kind used in pseudopotential files
+        const double xmin = -7.0;
+        const double dx = 0.0125;
+        for (double x = xmin; std::exp(x) < rcut; x += dx)
+        {
+            r.push_back(std::exp(x));
+        }
+    }
+
+    /**
+     * The l-th order transform of F(r) = r^l exp(-a*r^2) is
+     *
+     *      sqrt(pi) * q^l / (2^(l+2) * a^(l+3/2)) * exp(-q^2/(4a))
+     *                                                              */
+    double ref(const int l, const double q) const
+    {
+        return std::sqrt(PI) * std::pow(q, l) / std::pow(2.0, l + 2) / std::pow(a, l + 1.5)
+               * std::exp(-q * q / 4.0 / a);
+    }
+
+    const double a = 1.5;
+    const double rcut = 10.0;
+    const double qmax = 20.0;
+    std::vector<double> r;
+};
+
+TEST_F(RadialFormFactorTest, Gaussian)
+{
+    std::vector<double> q;
+    for (double qi = 0.0; qi <= qmax; qi += 0.0731)
+    {
+        q.push_back(qi);
+    }
+    q.push_back(qmax);
+    std::vector<double> out(q.size());
+
+    RadialFormFactor ff;
+    for (int l = 0; l <= 3; ++l)
+    {
+        for (int p = 0; p <= 2; ++p)
+        {
+            std::vector<double> in(r.size());
+            for (int ir = 0; ir < r.size(); ++ir)
+            {
+                in[ir] = std::pow(r[ir], l + p) * std::exp(-a * r[ir] * r[ir]);
+            }
+            ff.build(l, r.size(), r.data(), in.data(), p, qmax);
+            EXPECT_GE(ff.qmax(), qmax);
+
+            ff.eval(q.size(), q.data(), out.data());
+            for (int iq = 0; iq < q.size(); ++iq)
+            {
+                EXPECT_NEAR(out[iq], ref(l, q[iq]), 1e-8) << "l=" << l << " p=" << p << " q=" << q[iq];
+            }
+            EXPECT_NEAR(ff.eval(1.0), ref(l, 1.0), 1e-8);
+        }
+    }
+}
+
+TEST_F(RadialFormFactorTest, Truncated)
+{
+    // a function that is cut at rcut gives the transform of the truncated function
+    std::vector<double> in(r.size());
+    for (int ir = 0; ir < r.size(); ++ir)
+    {
+        in[ir] = std::exp(-0.05 * r[ir] * r[ir]);
+    }
+    RadialFormFactor ff;
+    ff.build(0, r.size(), r.data(), in.data(), 0, 5.0);
+
+    // q = 0: integral of r^2 F(r) by Simpson's rule on a fine uniform grid
+    const int n = 20000;
+    const double h = r.back() / n;
+    double sum = 0.0;
+    for (int i = 0; i <= n; ++i)
+    {
+        const double x = i * h;
+        const double w = (i == 0 || i == n) ? 1.0 : (i % 2 == 1 ? 4.0 : 2.0);
+        sum += w * x * x * std::exp(-0.05 * x * x);
+    }
+    sum *= h / 3.0;
+    EXPECT_NEAR(ff.eval(0.0), sum, 1e-6 * sum);
+}
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+#endif
+
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+
+    return result;
+}
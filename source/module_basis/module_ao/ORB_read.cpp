@@ -6,6 +6,7 @@
 #include "module_base/parallel_common.h"
 #include <algorithm>
 #include "module_base/timer.h"
+#include "module_base/global_variable.h"
 
 //==============================
 // Define an object here! 
@@ -278,7 +279,7 @@ void LCAO_Orbitals::Read_PAO(
 	int lmaxt=0;
 	int nchimaxt=0;
 
-	this->read_orb_file(ofs_in, in_ao, it, lmaxt, nchimaxt, this->Phi, force_flag, my_rank);
+	this->read_orb_file(ofs_in, in_ao, this->orbital_file[it], it, lmaxt, nchimaxt, this->Phi, force_flag, my_rank);
 
 	//lmax and nchimax for all types
 	this->lmax = std::max(this->lmax, lmaxt);
@@ -325,7 +326,7 @@ void LCAO_Orbitals::Read_Descriptor(
 	this->lmax_d = 0;
 	this->nchimax_d = 0;
 
-	this->read_orb_file(ofs_in, in_de, 0, this->lmax_d, this->nchimax_d, this->Alpha, force_flag, my_rank);
+	this->read_orb_file(ofs_in, in_de, this->descriptor_file, 0, this->lmax_d, this->nchimax_d, this->Alpha, force_flag, my_rank);
 
 	in_de.close();
 
@@ -336,6 +337,7 @@ void LCAO_Orbitals::Read_Descriptor(
 void LCAO_Orbitals::read_orb_file(
 	std::ofstream &ofs_in, // GlobalV::ofs_running
 	std::ifstream &ifs,
+	const std::string &orb_file,
 	const int &it, 
 	int &lmax, 
 	int &nchimax, 
@@ -344,44 +346,40 @@ void LCAO_Orbitals::read_orb_file(
 	const int &my_rank)
 {
 	ModuleBase::TITLE("LCAO_Orbitals","read_orb_file");
-	char word[80];
-	std::string orb_label;
+
+	// the file is parsed on rank 0, or taken from the cache of an earlier run,
+	// and sent to all ranks with one broadcast
+	ModuleBase::PackedBuffer buf;
 	if (my_rank == 0)
 	{
-		while (ifs.good())
+		std::string cache_key;
+		bool from_cache = false;
+		if (GlobalV::global_cache_dir != "")
 		{
-			ifs >> word;
-			if (std::strcmp(word, "Element") == 0)
+			const std::string file_key = ModuleBase::PackedBuffer::file_key(orb_file);
+			if (file_key != "")
 			{
-				ifs >> orb_label;
-				continue;
-			}
-			if (std::strcmp(word, "Lmax") == 0)
-			{
-				ifs >> lmax;
-				break;
+				cache_key = "orb " + file_key;
+				from_cache = buf.load(GlobalV::global_cache_dir, cache_key);
 			}
 		}
-	}
-#ifdef __MPI
-	Parallel_Common::bcast_int(lmax);
-#endif	
-	
-	int* nchi = new int[lmax+1];		// allocate space: number of chi for each L.
-	
-	if (my_rank == 0)
-	{	
-		for (int l = 0; l <= lmax; l++)
+		if (!from_cache && this->parse_orb_file(ifs, buf) && cache_key != "")
 		{
-			ifs >> word >> word >> word >> nchi[l];
-			nchimax = std::max(nchimax, nchi[l]);
+			buf.save(GlobalV::global_cache_dir, cache_key);
 		}
 	}
+	buf.bcast();
 
-#ifdef __MPI
-	Parallel_Common::bcast_int(nchimax);
-	Parallel_Common::bcast_int(nchi, lmax + 1);
-#endif		
+	std::string orb_label;
+	buf.unpack(orb_label);
+	buf.unpack(lmax);
+
+	int* nchi = new int[lmax+1];		// allocate space: number of chi for each L.
+	buf.unpack(nchi, lmax + 1);
+	for (int l = 0; l <= lmax; l++)
+	{
+		nchimax = std::max(nchimax, nchi[l]);
+	}
 
 	// calculate total number of chi
 	int total_nchi = 0;
@@ -394,44 +392,18 @@ void LCAO_Orbitals::read_orb_file(
 	delete[] ao[it].phiLN;
 	ao[it].phiLN = new Numerical_Orbital_Lm[total_nchi];
 
-	int meshr=0; // number of mesh points
 	int meshr_read=0;
 	double dr=0.0; 
-
-	if (my_rank == 0)
+	buf.unpack(meshr_read);
+	buf.unpack(dr);
+	// number of mesh points
+	int meshr = meshr_read;
+	if (meshr % 2 == 0)
 	{
-		while (ifs.good())
-		{
-			ifs >> word;
-			if (std::strcmp(word, "END") == 0)		// Peize Lin fix bug about strcmp 2016-08-02
-			{
-				break;
-			}
-		}
-		ModuleBase::CHECK_NAME(ifs, "Mesh");
-		ifs >> meshr;
-		meshr_read = meshr;
-		if (meshr % 2 == 0)
-		{
-			++meshr;
-		}
-		ModuleBase::CHECK_NAME(ifs, "dr");
-		ifs >> dr;
+		++meshr;
 	}
 
-#ifdef __MPI
-	Parallel_Common::bcast_int(meshr);
-	Parallel_Common::bcast_int(meshr_read);
-	Parallel_Common::bcast_double(dr);
-#endif		
-
 	int count = 0;
-	std::string name1;
-	std::string name2;
-	std::string name3;
-	int tmp_it=0;
-	int tmp_l=0;
-	int tmp_n=0;
 
 	for (int L = 0; L <= lmax; L++)
 	{
@@ -471,55 +443,19 @@ void LCAO_Orbitals::read_orb_file(
 			// set the length of orbital
 			ofs_in << std::setw(8) << radial[meshr - 1];
 
-			// mohan update 2010-09-07
 			bool find = false;
-			if (my_rank == 0)
-			{
-				while (!find)
-				{
-					if (ifs.eof())
-					{
-						std::cout << " Can't find l="
-							<< L << " n=" << N << " orbital." << std::endl;
-						break;
-					}
-
-					ifs >> name1 >> name2>> name3;
-					ifs >> tmp_it >> tmp_l >> tmp_n;
-					assert( name1 == "Type" );
-					if (L == tmp_l && N == tmp_n)
-					{
-						// meshr_read is different from meshr if meshr is even number.
-						for (int ir = 0; ir < meshr_read; ir++)
-						{
-							ifs >> psi[ir];
-							psir[ir] = psi[ir] * radial[ir];
-						}
-						find = true;
-					}
-					else
-					{
-						double no_use;
-						for (int ir = 0; ir < meshr_read; ir++)
-						{
-							ifs >> no_use;
-						}
-					}
-				}//end find
-			}
-
-#ifdef __MPI
-			Parallel_Common::bcast_bool(find);
-#endif
+			buf.unpack(find);
 			if (!find)
 			{
 				ModuleBase::WARNING_QUIT("LCAO_Orbitals::read_orb_file", "Can't find orbitals.");
 			}
 
-#ifdef __MPI
-			Parallel_Common::bcast_double(psi, meshr_read);
-			Parallel_Common::bcast_double(psir, meshr_read);
-#endif
+			// meshr_read is different from meshr if meshr is even number.
+			buf.unpack(psi, meshr_read);
+			for (int ir = 0; ir < meshr_read; ir++)
+			{
+				psir[ir] = psi[ir] * radial[ir];
+			}
 
 			// renormalize radial wave functions
 			double* inner = new double[meshr]();
@@ -585,3 +521,106 @@ void LCAO_Orbitals::read_orb_file(
 	delete[] nchi;
 	return;
 }
+
+
+bool LCAO_Orbitals::parse_orb_file(std::ifstream &ifs, ModuleBase::PackedBuffer &buf)
+{
+	ModuleBase::TITLE("LCAO_Orbitals","parse_orb_file");
+	char word[80];
+	std::string orb_label;
+	int lmax = 0;
+	while (ifs.good())
+	{
+		ifs >> word;
+		if (std::strcmp(word, "Element") == 0)
+		{
+			ifs >> orb_label;
+			continue;
+		}
+		if (std::strcmp(word, "Lmax") == 0)
+		{
+			ifs >> lmax;
+			break;
+		}
+	}
+
+	std::vector<int> nchi(lmax + 1, 0);
+	for (int l = 0; l <= lmax; l++)
+	{
+		ifs >> word >> word >> word >> nchi[l];
+	}
+
+	while (ifs.good())
+	{
+		ifs >> word;
+		if (std::strcmp(word, "END") == 0)		// Peize Lin fix bug about strcmp 2016-08-02
+		{
+			break;
+		}
+	}
+	int meshr_read = 0;
+	double dr = 0.0;
+	ModuleBase::CHECK_NAME(ifs, "Mesh");
+	ifs >> meshr_read;
+	ModuleBase::CHECK_NAME(ifs, "dr");
+	ifs >> dr;
+
+	buf.pack(orb_label);
+	buf.pack(lmax);
+	buf.pack(nchi.data(), lmax + 1);
+	buf.pack(meshr_read);
+	buf.pack(dr);
+
+	std::string name1;
+	std::string name2;
+	std::string name3;
+	int tmp_it=0;
+	int tmp_l=0;
+	int tmp_n=0;
+	std::vector<double> psi(meshr_read);
+	for (int L = 0; L <= lmax; L++)
+	{
+		for (int N = 0; N < nchi[L]; N++)
+		{
+			// mohan update 2010-09-07
+			bool find = false;
+			while (!find)
+			{
+				if (ifs.eof())
+				{
+					std::cout << " Can't find l="
+						<< L << " n=" << N << " orbital." << std::endl;
+					break;
+				}
+
+				ifs >> name1 >> name2>> name3;
+				ifs >> tmp_it >> tmp_l >> tmp_n;
+				assert( name1 == "Type" );
+				if (L == tmp_l && N == tmp_n)
+				{
+					for (int ir = 0; ir < meshr_read; ir++)
+					{
+						ifs >> psi[ir];
+					}
+					find = true;
+				}
+				else
+				{
+					double no_use;
+					for (int ir = 0; ir < meshr_read; ir++)
+					{
+						ifs >> no_use;
+					}
+				}
+			}//end find
+
+			buf.pack(find);
+			if (!find)
+			{
+				return false;
+			}
+			buf.pack(psi.data(), meshr_read);
+		}
+	}
+	return true;
+}
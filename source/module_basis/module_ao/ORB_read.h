@@ -4,6 +4,7 @@
 #include "ORB_atomic.h"
 #include "ORB_atomic_lm.h"
 #include "ORB_nonlocal.h"
+#include "module_base/packed_buffer.h"
 
 ////////////////////////////////////////////////////////////
 /// advices for reconstructions:
@@ -105,6 +106,7 @@ private:
 	void read_orb_file(
 		std::ofstream &ofs_in,
 		std::ifstream &ifs, 
+		const std::string &orb_file, // the name of ifs, for the cache
 		const int &it, 
 		int &lmax, 
 		int &nchimax, 
@@ -112,6 +114,9 @@ private:
 		const bool &force_flag, // mohan add 2021-05-07
 		const int &my_rank);	//caoyu add 2021-04-26
 
+	/// parse the orbital file on rank 0 into buf, false if an orbital is missing
+	static bool parse_orb_file(std::ifstream &ifs, ModuleBase::PackedBuffer &buf);
+
 };
 
 /// PLEASE avoid using 'ORB' as global variable 
@@ -27,6 +27,12 @@ using iclock = std::chrono::high_resolution_clock;
  *
  *  - build
  *      - builds an object for doing a specific two-center integral
+ *
+ *  - calculate (batch)
+ *      - agrees with the single-pair calculate for every entry
+ *
+ *  - snap
+ *      - agrees with the single-pair calculate for all ket functions
  *                                                                      */
 class TwoCenterIntegratorTest : public ::testing::Test
 {
@@ -162,6 +168,105 @@ TEST_F(TwoCenterIntegratorTest, FiniteDifference)
     }
 }
 
+TEST_F(TwoCenterIntegratorTest, BatchConsistency)
+{
+    nfile = 3;
+    orb.build(nfile, file, 'o');
+
+    ModuleBase::SphericalBesselTransformer sbt;
+    orb.set_transformer(sbt);
+
+    double rmax = orb.rcut_max() * 2.0;
+    double dr = 0.01;
+    int nr = static_cast<int>(rmax / dr) + 1;
+    orb.set_uniform_grid(true, nr, rmax, 'i', true);
+
+    S_intor.tabulate(orb, orb, 'S', nr, rmax);
+
+    // all orbital pairs at a few displacements, including R = 0 and R beyond the cutoff
+    std::vector<ModuleBase::Vector3<double>> vR0 = {{1.0, 2.0, 3.0}, {0.0, 0.0, 0.0}, {-2.5, 0.3, 1.1}, {30.0, 0.0, 0.0}};
+
+    std::vector<int> itype1, l1, izeta1, m1, itype2, l2, izeta2, m2;
+    std::vector<ModuleBase::Vector3<double>> vR;
+    for (auto& v : vR0)
+    {
+        for (int t1 = 0; t1 < nfile; t1++)
+        {
+            for (int t2 = 0; t2 < nfile; t2++)
+            {
+                for (int L1 = 0; L1 <= orb(t1).lmax(); L1++)
+                {
+                    for (int N1 = 0; N1 < orb(t1).nzeta(L1); N1++)
+                    {
+                        for (int L2 = 0; L2 <= orb(t2).lmax(); L2++)
+                        {
+                            for (int N2 = 0; N2 < orb(t2).nzeta(L2); N2++)
+                            {
+                                for (int M1 = -L1; M1 <= L1; ++M1)
+                                {
+                                    for (int M2 = -L2; M2 <= L2; ++M2)
+                                    {
+                                        itype1.push_back(t1);
+                                        l1.push_back(L1);
+                                        izeta1.push_back(N1);
+                                        m1.push_back(M1);
+                                        itype2.push_back(t2);
+                                        l2.push_back(L2);
+                                        izeta2.push_back(N2);
+                                        m2.push_back(M2);
+                                        vR.push_back(v);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    const int n = vR.size();
+    std::vector<double> out(n), grad_out(3 * n);
+    S_intor.calculate(n, itype1.data(), l1.data(), izeta1.data(), m1.data(),
+                      itype2.data(), l2.data(), izeta2.data(), m2.data(), vR.data(),
+                      out.data(), grad_out.data());
+
+    for (int i = 0; i < n; ++i)
+    {
+        double elem = 0.0;
+        double grad_elem[3] = {0.0, 0.0, 0.0};
+        S_intor.calculate(itype1[i], l1[i], izeta1[i], m1[i], itype2[i], l2[i], izeta2[i], m2[i], vR[i], &elem, grad_elem);
+        EXPECT_NEAR(out[i], elem, 1e-14);
+        EXPECT_NEAR(grad_out[3 * i], grad_elem[0], 1e-14);
+        EXPECT_NEAR(grad_out[3 * i + 1], grad_elem[1], 1e-14);
+        EXPECT_NEAR(grad_out[3 * i + 2], grad_elem[2], 1e-14);
+    }
+
+    // snap computes all ket functions of a type in one batch (m in the order of 0, 1, -1, 2, -2, ...)
+    std::vector<std::vector<double>> snap_out;
+    S_intor.snap(1, 2, 0, -1, 2, vR0[2], true, snap_out);
+    int index = 0;
+    for (int L2 = 0; L2 <= orb(2).lmax(); L2++)
+    {
+        for (int N2 = 0; N2 < orb(2).nzeta(L2); N2++)
+        {
+            for (int mm2 = 0; mm2 <= 2 * L2; ++mm2)
+            {
+                int M2 = (mm2 % 2 == 0) ? -mm2 / 2 : (mm2 + 1) / 2;
+                double elem = 0.0;
+                double grad_elem[3] = {0.0, 0.0, 0.0};
+                S_intor.calculate(1, 2, 0, -1, 2, L2, N2, M2, vR0[2], &elem, grad_elem);
+                EXPECT_NEAR(snap_out[0][index], elem, 1e-14);
+                EXPECT_NEAR(snap_out[1][index], grad_elem[0], 1e-14);
+                EXPECT_NEAR(snap_out[2][index], grad_elem[1], 1e-14);
+                EXPECT_NEAR(snap_out[3][index], grad_elem[2], 1e-14);
+                ++index;
+            }
+        }
+    }
+    EXPECT_EQ(index, snap_out[0].size());
+}
+
 //TEST_F(TwoCenterIntegratorTest, LegacyConsistency)
 //{
 //    // use less files so that the test wouldn't take too long
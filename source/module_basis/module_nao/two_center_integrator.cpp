@@ -3,9 +3,12 @@
 #include "module_base/vector3.h"
 #include "module_base/ylm.h"
 
+#include <algorithm>
+
 TwoCenterIntegrator::TwoCenterIntegrator():
     is_tabulated_(false),
-    op_('\0')
+    op_('\0'),
+    lmax_ylm_(0)
 {
 }
 
@@ -18,6 +21,7 @@ void TwoCenterIntegrator::tabulate(const RadialCollection& bra,
     op_ = op;
     table_.build(bra, ket, op, nr, cutoff);
     RealGauntTable::instance().build(std::max(bra.lmax(), ket.lmax()));
+    lmax_ylm_ = bra.lmax() + ket.lmax();
     is_tabulated_ = true;
 }
 
@@ -32,62 +36,104 @@ void TwoCenterIntegrator::calculate(const int itype1,
 	                                const ModuleBase::Vector3<double>& vR, // R = R2 - R1
                                     double* out,
                                     double* grad_out) const
+{
+    calculate(1, &itype1, &l1, &izeta1, &m1, &itype2, &l2, &izeta2, &m2, &vR, out, grad_out);
+}
+
+void TwoCenterIntegrator::calculate(const int n,
+                                    const int* itype1,
+                                    const int* l1,
+                                    const int* izeta1,
+                                    const int* m1,
+                                    const int* itype2,
+                                    const int* l2,
+                                    const int* izeta2,
+                                    const int* m2,
+                                    const ModuleBase::Vector3<double>* vR, // vR = R2 - R1
+                                    double* out,
+                                    double* grad_out) const
 {
 #ifdef __DEBUG
     assert( is_tabulated_ );
     assert( out || grad_out );
 #endif
 
-    if (out) *out = 0.0;
-    if (grad_out) std::fill(grad_out, grad_out + 3, 0.0);
+    if (out) std::fill(out, out + n, 0.0);
+    if (grad_out) std::fill(grad_out, grad_out + 3 * n, 0.0);
 
-    double R = vR.norm();
-    if (R > table_.rmax())
-    {
-        return;
-    }
+    // a single pair only needs the spherical harmonics up to l1 + l2, while in a
+    // batch they are generated once per vR for all l1 & l2 of the table
+    const int lmax_ylm = (n == 1) ? l1[0] + l2[0] : lmax_ylm_;
 
-    // unit vector along R
-    ModuleBase::Vector3<double> uR = (R == 0.0 ? ModuleBase::Vector3<double>(0., 0., 1.) : vR / R);
-
-    // generate all necessary real (solid) spherical harmonics
+    // real (solid) spherical harmonics of the most recent vR
 	std::vector<double> Rl_Y;
 	std::vector<std::vector<double>> grad_Rl_Y;
+    const ModuleBase::Vector3<double>* vR_cached = nullptr;
 
-    // R^l * Y is necessary anyway
-    ModuleBase::Ylm::rl_sph_harm(l1 + l2, vR[0], vR[1], vR[2], Rl_Y);
-    if (grad_out) ModuleBase::Ylm::grad_rl_sph_harm(l1 + l2, vR[0], vR[1], vR[2], Rl_Y, grad_Rl_Y);
-
-    double tmp[2] = {0.0, 0.0};
-    double* S_by_Rl = tmp;
-    double* d_S_by_Rl = grad_out ? tmp + 1 : nullptr;
+    // radial parts S/R^l and (d/dR)(S/R^l) of the most recent pair of radial functions,
+    // indexed by l (only l = |l1-l2|, |l1-l2|+2, ..., l1+l2 are meaningful)
+    std::vector<double> S_by_Rl(lmax_ylm + 1, 0.0);
+    std::vector<double> d_S_by_Rl(lmax_ylm + 1, 0.0);
+    int radial_cached[6] = {-1, -1, -1, -1, -1, -1};
+    bool radial_valid = false;
 
-    // the sign is given by i^(l1-l2-l) = (-1)^((l1-l2-l)/2)
-    int sign = (l1 - l2 - std::abs(l1 - l2)) % 4 == 0 ? 1 : -1;
-    for (int l = std::abs(l1 - l2); l <= l1 + l2; l += 2)
+    for (int i = 0; i < n; ++i)
     {
-        // look up S/R^l and (d/dR)(S/R^l) (if necessary) from the radial table
-        table_.lookup(itype1, l1, izeta1, itype2, l2, izeta2, l, R, S_by_Rl, d_S_by_Rl);
+        const double R = vR[i].norm();
+        if (R > table_.rmax())
+        {
+            continue;
+        }
 
-		for (int m = -l; m <= l; ++m)
+        // unit vector along R
+        ModuleBase::Vector3<double> uR = (R == 0.0 ? ModuleBase::Vector3<double>(0., 0., 1.) : vR[i] / R);
+
+        if (vR_cached == nullptr || vR[i] != *vR_cached)
         {
-            double G = RealGauntTable::instance()(l1, l2, l, m1, m2, m);
+            // R^l * Y is necessary anyway
+            ModuleBase::Ylm::rl_sph_harm(lmax_ylm, vR[i][0], vR[i][1], vR[i][2], Rl_Y);
+            if (grad_out) ModuleBase::Ylm::grad_rl_sph_harm(lmax_ylm, vR[i][0], vR[i][1], vR[i][2], Rl_Y, grad_Rl_Y);
+            vR_cached = &vR[i];
+            radial_valid = false;
+        }
 
-            if (out)
+        const int key[6] = {itype1[i], l1[i], izeta1[i], itype2[i], l2[i], izeta2[i]};
+        if (!radial_valid || !std::equal(key, key + 6, radial_cached))
+        {
+            for (int l = std::abs(l1[i] - l2[i]); l <= l1[i] + l2[i]; l += 2)
             {
-                *out += sign * G * (*S_by_Rl) * Rl_Y[ylm_index(l, m)];
+                // look up S/R^l and (d/dR)(S/R^l) (if necessary) from the radial table
+                table_.lookup(itype1[i], l1[i], izeta1[i], itype2[i], l2[i], izeta2[i], l, R,
+                              &S_by_Rl[l], grad_out ? &d_S_by_Rl[l] : nullptr);
             }
+            std::copy(key, key + 6, radial_cached);
+            radial_valid = true;
+        }
 
-            if (grad_out)
+        // the sign is given by i^(l1-l2-l) = (-1)^((l1-l2-l)/2)
+        int sign = (l1[i] - l2[i] - std::abs(l1[i] - l2[i])) % 4 == 0 ? 1 : -1;
+        for (int l = std::abs(l1[i] - l2[i]); l <= l1[i] + l2[i]; l += 2)
+        {
+            for (int m = -l; m <= l; ++m)
             {
-                for (int i = 0; i < 3; ++i)
+                double G = RealGauntTable::instance()(l1[i], l2[i], l, m1[i], m2[i], m);
+
+                if (out)
+                {
+                    out[i] += sign * G * S_by_Rl[l] * Rl_Y[ylm_index(l, m)];
+                }
+
+                if (grad_out)
                 {
-                    grad_out[i] += sign * G * ( (*d_S_by_Rl) * uR[i] * Rl_Y[ylm_index(l, m)]
-                                                + (*S_by_Rl) * grad_Rl_Y[ylm_index(l, m)][i] );
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        grad_out[3 * i + k] += sign * G * ( d_S_by_Rl[l] * uR[k] * Rl_Y[ylm_index(l, m)]
+                                                            + S_by_Rl[l] * grad_Rl_Y[ylm_index(l, m)][k] );
+                    }
                 }
             }
+            sign = -sign;
         }
-        sign = -sign;
     }
 }
 
@@ -124,8 +170,12 @@ void TwoCenterIntegrator::snap(const int itype1,
         std::fill(out[i].begin(), out[i].end(), 0.0);
 	}
 
+    // all ket functions share vR, so they are evaluated in one batch
+    std::vector<int> itype1_v(num_ket, itype1), l1_v(num_ket, l1), izeta1_v(num_ket, izeta1), m1_v(num_ket, m1);
+    std::vector<int> itype2_v(num_ket, itype2), l2_v(num_ket), izeta2_v(num_ket), m2_v(num_ket);
+    std::vector<ModuleBase::Vector3<double>> vR_v(num_ket, vR);
+
     int index = 0;
-    double tmp[3] = {0.0, 0.0, 0.0};
     for (int l2 = 0; l2 <= table_.lmax_ket(); ++l2)
     {
         for (int izeta2 = 0; izeta2 < table_.nchi_ket(itype2, l2); ++izeta2)
@@ -135,20 +185,28 @@ void TwoCenterIntegrator::snap(const int itype1,
             // whether it should be rearranged to -l, -l+1, ..., l will be studied later
             for (int mm2 = 0; mm2 <= 2*l2; ++mm2)
             {
-                int m2 = (mm2 % 2 == 0) ? -mm2 / 2 : (mm2 + 1) / 2;
-                calculate(itype1, l1, izeta1, m1, itype2, l2, izeta2, m2, vR, &out[0][index], deriv ? tmp : nullptr);
-
-                if (deriv)
-                {
-                    out[1][index] = tmp[0];
-                    out[2][index] = tmp[1];
-                    out[3][index] = tmp[2];
-                }
-
+                l2_v[index] = l2;
+                izeta2_v[index] = izeta2;
+                m2_v[index] = (mm2 % 2 == 0) ? -mm2 / 2 : (mm2 + 1) / 2;
                 ++index;
             }
         }
     }
+
+    std::vector<double> grad(deriv ? 3 * num_ket : 0);
+    calculate(num_ket, itype1_v.data(), l1_v.data(), izeta1_v.data(), m1_v.data(),
+              itype2_v.data(), l2_v.data(), izeta2_v.data(), m2_v.data(), vR_v.data(),
+              out[0].data(), deriv ? grad.data() : nullptr);
+
+    if (deriv)
+    {
+        for (int i = 0; i < num_ket; ++i)
+        {
+            out[1][i] = grad[3 * i];
+            out[2][i] = grad[3 * i + 1];
+            out[3][i] = grad[3 * i + 2];
+        }
+    }
 }
 
 int TwoCenterIntegrator::ylm_index(const int l, const int m) const
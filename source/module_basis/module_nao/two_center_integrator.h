@@ -99,6 +99,53 @@ class TwoCenterIntegrator
                    double* grad_out = nullptr
     ) const;
 
+    /*!
+     * @brief Compute two-center integrals for a batch of orbital pairs and displacements.
+     *
+     * The i-th entry of the batch is the integral between orbital
+     * (itype1[i], l1[i], izeta1[i], m1[i]) and orbital (itype2[i], l2[i], izeta2[i], m2[i])
+     * with vR[i] = R2 - R1. Results are identical to calling the single-pair version
+     * for each entry, but
+     *
+     *  - consecutive entries with the same vR share one evaluation of the real solid
+     *    spherical harmonics (up to the maximum l of the table);
+     *  - consecutive entries that further share the same pair of radial functions
+     *    share the radial table lookups (i.e., all m1 & m2 of a given l1 & l2).
+     *
+     * Callers should therefore order the batch with vR outermost and m innermost,
+     * e.g., all orbital pairs of one atom pair in a row. The function is thread-safe
+     * and can be called from within OpenMP parallel regions over atom pairs.
+     *
+     * @param[in]  n           Number of entries in the batch.
+     * @param[in]  itype1      Element indices of orbital 1, size n.
+     * @param[in]  l1          Angular momenta of orbital 1, size n.
+     * @param[in]  izeta1      Zeta numbers of orbital 1, size n.
+     * @param[in]  m1          Magnetic quantum numbers of orbital 1, size n.
+     * @param[in]  itype2      Element indices of orbital 2, size n.
+     * @param[in]  l2          Angular momenta of orbital 2, size n.
+     * @param[in]  izeta2      Zeta numbers of orbital 2, size n.
+     * @param[in]  m2          Magnetic quantum numbers of orbital 2, size n.
+     * @param[in]  vR          R2 - R1 of each entry, size n.
+     * @param[out] out         Two-center integrals, size n. Not computed if nullptr.
+     * @param[out] grad_out    Gradients, size 3*n, with grad_out[3*i+k] being the k-th
+     *                         Cartesian component of the i-th entry. Not computed if nullptr.
+     *
+     * @note out and grad_out cannot be both nullptr.
+     *                                                                                  */
+    void calculate(const int n,
+                   const int* itype1,
+                   const int* l1,
+                   const int* izeta1,
+                   const int* m1,
+                   const int* itype2,
+                   const int* l2,
+                   const int* izeta2,
+                   const int* m2,
+                   const ModuleBase::Vector3<double>* vR,
+                   double* out = nullptr,
+                   double* grad_out = nullptr
+    ) const;
+
     /*!
      * @brief Compute a batch of two-center integrals.
      *
@@ -123,6 +170,9 @@ class TwoCenterIntegrator
     char op_;
     TwoCenterTable table_;
 
+    /// maximum l of the real solid spherical harmonics involved, i.e., lmax(bra) + lmax(ket)
+    int lmax_ylm_;
+
     /*!
      * @brief Returns the index of (l,m) in the array of spherical harmonics.
      *
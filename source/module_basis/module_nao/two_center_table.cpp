@@ -89,7 +89,7 @@ void TwoCenterTable::lookup(const int itype1,
 
     const double*  tab = table(itype1, l1, izeta1, itype2, l2, izeta2, l, false);
     const double* dtab = table(itype1, l1, izeta1, itype2, l2, izeta2, l, true);
-    ModuleBase::CubicSpline::eval(nr_, rgrid_, tab, dtab, 1, &R, val, dval);
+    ModuleBase::CubicSpline::eval_uniform(nr_, 0.0, rmax_ / (nr_ - 1), tab, dtab, 1, &R, val, dval);
 }
 
 int& TwoCenterTable::table_index(const NumericalRadial* it1, const NumericalRadial* it2, const int l)
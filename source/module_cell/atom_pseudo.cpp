@@ -152,125 +152,146 @@ void Atom_pseudo::set_d_so(
 	return;
 }
 
-#include "module_base/parallel_common.h"
-#ifdef __MPI
-
-void Atom_pseudo::bcast_atom_pseudo(void)
+void Atom_pseudo::pack_atom_pseudo(ModuleBase::PackedBuffer& buf) const
 {
-	ModuleBase::TITLE("Atom_pseudo","bcast_atom_pseudo");
 // == pseudo_h ==
-//int
-	Parallel_Common::bcast_int( lmax );
-	Parallel_Common::bcast_int( mesh );
-	Parallel_Common::bcast_int( nchi );
-	Parallel_Common::bcast_int( nbeta );
-	Parallel_Common::bcast_int( nv );
-	Parallel_Common::bcast_int( zv );
-
-//double
-	Parallel_Common::bcast_double( etotps );
-	Parallel_Common::bcast_double( ecutwfc );
-	Parallel_Common::bcast_double( ecutrho );
-
-// bool
-	Parallel_Common::bcast_bool( tvanp );
-	Parallel_Common::bcast_bool( nlcc );
-	Parallel_Common::bcast_bool( has_so );
+	buf.pack( lmax );
+	buf.pack( mesh );
+	buf.pack( nchi );
+	buf.pack( nbeta );
+	buf.pack( nv );
+	buf.pack( zv );
+	buf.pack( etotps );
+	buf.pack( ecutwfc );
+	buf.pack( ecutrho );
+	buf.pack( tvanp );
+	buf.pack( nlcc );
+	buf.pack( has_so );
+	buf.pack( psd );
+	buf.pack( pp_type );
+	buf.pack( xc_func );
+	buf.pack( jjj, nbeta );
+	buf.pack( els, nchi );
+	buf.pack( lchi, nchi );
+	buf.pack( oc, nchi );
+	buf.pack( jchi, nchi );
+	buf.pack( nn, nchi );
+// == pseudo_atom ==
+	buf.pack( msh );
+	buf.pack( rcut );
+	buf.pack( r, mesh );
+	buf.pack( rab, mesh );
+	buf.pack( rho_atc, mesh );
+	buf.pack( rho_at, mesh );
+	buf.pack( chi.c, nchi * mesh );
+// == pseudo_vl ==
+	buf.pack( vloc_at, mesh );
+// == pseudo_nc ==
+	buf.pack( lll, nbeta );
+	buf.pack( kkbeta );
+	buf.pack( nh );
+	buf.pack( betar.nr );
+	buf.pack( betar.nc );
+	buf.pack( dion.c, nbeta * nbeta );
+	buf.pack( betar.c, betar.nr * betar.nc );
+	return;
+}
 
-//std::string
-	Parallel_Common::bcast_string( psd );
-	Parallel_Common::bcast_string( pp_type );
-	Parallel_Common::bcast_string( xc_func );
+void Atom_pseudo::unpack_atom_pseudo(ModuleBase::PackedBuffer& buf)
+{
+// == pseudo_h ==
+	buf.unpack( lmax );
+	buf.unpack( mesh );
+	buf.unpack( nchi );
+	buf.unpack( nbeta );
+	buf.unpack( nv );
+	buf.unpack( zv );
+	buf.unpack( etotps );
+	buf.unpack( ecutwfc );
+	buf.unpack( ecutrho );
+	buf.unpack( tvanp );
+	buf.unpack( nlcc );
+	buf.unpack( has_so );
+	buf.unpack( psd );
+	buf.unpack( pp_type );
+	buf.unpack( xc_func );
 
-	if(GlobalV::MY_RANK!=0)
-	{
-		delete[] jjj;
-		delete[] els;
-		delete[] lchi;
-		delete[] oc;
-		delete[] jchi;
-		delete[] nn;
-		jjj = new double [nbeta];
-		els = new std::string[nchi];
-		lchi = new int [nchi];
-		oc = new double[nchi];
-		jchi = new double[nchi];
-		nn = new int[nchi];
-	}
-	
-	Parallel_Common::bcast_double( jjj, nbeta );
-	Parallel_Common::bcast_string( els, nchi);
-	Parallel_Common::bcast_int( lchi, nchi);
-	Parallel_Common::bcast_double( oc, nchi);
-	Parallel_Common::bcast_double( jchi, nchi);
-	Parallel_Common::bcast_int( nn, nchi);
-// == end of pseudo_h
+	delete[] jjj;
+	delete[] els;
+	delete[] lchi;
+	delete[] oc;
+	delete[] jchi;
+	delete[] nn;
+	jjj = new double [nbeta];
+	els = new std::string[nchi];
+	lchi = new int [nchi];
+	oc = new double[nchi];
+	jchi = new double[nchi];
+	nn = new int[nchi];
+	buf.unpack( jjj, nbeta );
+	buf.unpack( els, nchi );
+	buf.unpack( lchi, nchi );
+	buf.unpack( oc, nchi );
+	buf.unpack( jchi, nchi );
+	buf.unpack( nn, nchi );
 
 // == pseudo_atom ==
-	Parallel_Common::bcast_int( msh );
-	Parallel_Common::bcast_double( rcut );
-	if(GlobalV::MY_RANK != 0)
-	{
-		assert(mesh!=0);
-		delete[] r;
-		delete[] rab;
-		delete[] rho_atc;
-		delete[] rho_at;
-		r = new double[mesh];
-		rab = new double[mesh];
-		rho_atc = new double[mesh];
-		rho_at = new double[mesh];
-		chi.create( nchi,mesh );
-	}
-	
-	Parallel_Common::bcast_double( r, mesh );
-	Parallel_Common::bcast_double( rab, mesh );
-	Parallel_Common::bcast_double( rho_atc, mesh );
-	Parallel_Common::bcast_double( rho_at, mesh );
-	Parallel_Common::bcast_double( chi.c, nchi * mesh );
-// == end of pseudo_atom ==
-	
+	buf.unpack( msh );
+	buf.unpack( rcut );
+	assert(mesh!=0);
+	delete[] r;
+	delete[] rab;
+	delete[] rho_atc;
+	delete[] rho_at;
+	r = new double[mesh];
+	rab = new double[mesh];
+	rho_atc = new double[mesh];
+	rho_at = new double[mesh];
+	chi.create( nchi,mesh );
+	buf.unpack( r, mesh );
+	buf.unpack( rab, mesh );
+	buf.unpack( rho_atc, mesh );
+	buf.unpack( rho_at, mesh );
+	buf.unpack( chi.c, nchi * mesh );
+
 // == pseudo_vl ==
-	if(GlobalV::MY_RANK != 0)
-	{
-		delete[] vloc_at;
-		vloc_at = new double[mesh];
-	}
-	Parallel_Common::bcast_double( vloc_at, mesh);
-// == end of pseudo_vl ==
+	delete[] vloc_at;
+	vloc_at = new double[mesh];
+	buf.unpack( vloc_at, mesh );
 
 // == pseudo_nc ==
-	if(GlobalV::MY_RANK != 0)
-	{
-		delete[] lll;
-		lll = new int[nbeta];
-	}
-	Parallel_Common::bcast_int( lll, nbeta );
-	Parallel_Common::bcast_int( kkbeta );
-	Parallel_Common::bcast_int( nh );
+	delete[] lll;
+	lll = new int[nbeta];
+	buf.unpack( lll, nbeta );
+	buf.unpack( kkbeta );
+	buf.unpack( nh );
+	int nr = 0;
+	int nc = 0;
+	buf.unpack( nr );
+	buf.unpack( nc );
+	betar.create(nr,nc);
+	dion.create(nbeta, nbeta);
+	buf.unpack( dion.c, nbeta * nbeta );
+	buf.unpack( betar.c, nr * nc );
+	return;
+}
 
-	int nr,nc;
-	if(GlobalV::MY_RANK == 0)
+#ifdef __MPI
+
+// all fields are packed into one buffer on rank 0, which is sent with a single broadcast
+void Atom_pseudo::bcast_atom_pseudo(void)
+{
+	ModuleBase::TITLE("Atom_pseudo","bcast_atom_pseudo");
+	ModuleBase::PackedBuffer buf;
+	if(GlobalV::MY_RANK==0)
 	{
-		nr = betar.nr;
-		nc = betar.nc;
+		this->pack_atom_pseudo(buf);
 	}
-	Parallel_Common::bcast_int( nr );
-	Parallel_Common::bcast_int( nc );
-
-	if(GlobalV::MY_RANK != 0)
+	buf.bcast();
+	if(GlobalV::MY_RANK!=0)
 	{
-		betar.create(nr,nc);
-		dion.create(nbeta, nbeta);
+		this->unpack_atom_pseudo(buf);
 	}
-
-	// below two 'bcast_double' lines of codes seem to have bugs,
-	// on some computers, the code will stuck here for ever.
-	// mohan note 2021-04-28
-	Parallel_Common::bcast_double( dion.c , nbeta * nbeta);
-	Parallel_Common::bcast_double( betar.c, nr * nc );
-// == end of psesudo_nc ==
-
 	return;
 }
 
@@ -8,6 +8,7 @@
 #include "../module_base/complexarray.h"
 #include "../module_base/complexmatrix.h"
 #include "pseudo_nc.h"
+#include "../module_base/packed_buffer.h"
 
 
 class Atom_pseudo : public pseudo_nc
@@ -45,6 +46,11 @@ public:
 	}
 	
 
+	// pack the pseudopotential into buf, to be broadcast or cached
+	void pack_atom_pseudo(ModuleBase::PackedBuffer& buf) const;
+	// read the pseudopotential back from buf, in the order of pack_atom_pseudo
+	void unpack_atom_pseudo(ModuleBase::PackedBuffer& buf);
+
 #ifdef __MPI
 	void bcast_atom_pseudo(void); // for upf201
 #endif
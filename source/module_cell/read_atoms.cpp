@@ -894,7 +894,14 @@ void UnitCell::print_stru_file(const std::string &fn, const int &type, const int
 	if(GlobalV::MY_RANK!=0) return;
 
 	std::ofstream ofs(fn.c_str());
+	this->print_stru_ofs(ofs, type, level);
+	ofs.close();
+
+	return;
+}
 
+void UnitCell::print_stru_ofs(std::ostream &ofs, const int &type, const int &level)const
+{
 	ofs << "ATOMIC_SPECIES" << std::endl;
 	ofs << std::setprecision(12);
 
@@ -1025,8 +1032,6 @@ void UnitCell::print_stru_file(const std::string &fn, const int &type, const int
 		}
 	}
 
-	ofs.close();
-
 	return;
 }
 
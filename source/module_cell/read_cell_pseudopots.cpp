@@ -1,6 +1,7 @@
 #include "unitcell.h"
 #include "module_base/parallel_common.h"
 #include "module_io/input.h"
+#include "module_base/packed_buffer.h"
 #ifdef __LCAO
 //#include "../module_basis/module_ao/ORB_read.h" // to use 'ORB' -- mohan 2021-01-30
 #endif
@@ -27,10 +28,38 @@ void UnitCell::read_cell_pseudopots(const std::string &pp_dir, std::ofstream &lo
 		// mohan update 2010-09-12	
 		int error = 0;
 		int error_ap = 0;
+
+		// the parsed pseudopotential is cached by the content of the file and
+		// the input parameters that change it
+		ModuleBase::PackedBuffer cache;
+		std::string cache_key;
+		bool from_cache = false;
 		
 		if(GlobalV::MY_RANK==0)
 		{
 			pp_address = pp_dir + this->pseudo_fn[i];
+			if(GlobalV::global_cache_dir != "")
+			{
+				const std::string file_key = ModuleBase::PackedBuffer::file_key(pp_address);
+				if(file_key != "")
+				{
+					std::stringstream key;
+					key << std::setprecision(17) << "pp " << file_key << " " << this->pseudo_type[i]
+						<< " " << this->atoms[i].flag_empty_element << " " << GlobalV::LSPINORB
+						<< " " << GlobalV::soc_lambda << " " << GlobalV::PSEUDORCUT << " " << GlobalV::DFT_FUNCTIONAL;
+					cache_key = key.str();
+					from_cache = cache.load(GlobalV::global_cache_dir, cache_key);
+				}
+			}
+		}
+
+		if(from_cache)
+		{
+			atoms[i].ncpp.unpack_atom_pseudo(cache);
+			cache.unpack(upf.functional_error);
+		}
+		else if(GlobalV::MY_RANK==0)
+		{
 			error = upf.init_pseudo_reader( pp_address, this->pseudo_type[i] ); //xiaohui add 2013-06-23
 
 			if(error==0) // mohan add 2021-04-16
@@ -78,7 +107,16 @@ void UnitCell::read_cell_pseudopots(const std::string &pp_dir, std::ofstream &lo
 		if(GlobalV::MY_RANK==0)
 		{
 //			upf.print_pseudo_upf( ofs );
-			atoms[i].ncpp.set_pseudo_nc( upf );
+			if(!from_cache)
+			{
+				atoms[i].ncpp.set_pseudo_nc( upf );
+				if(cache_key != "")
+				{
+					atoms[i].ncpp.pack_atom_pseudo(cache);
+					cache.pack(upf.functional_error);
+					cache.save(GlobalV::global_cache_dir, cache_key);
+				}
+			}
 
 			log << "\n Read in pseudopotential file is " << pseudo_fn[i] << std::endl;
 			ModuleBase::GlobalFunc::OUT(log,"pseudopotential type",atoms[i].ncpp.pp_type);
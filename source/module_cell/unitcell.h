@@ -260,6 +260,7 @@ public:
 	int find_type(const std::string &label);
 	void print_tau(void)const;
 	void print_stru_file(const std::string &fn, const int &type=1, const int &level=0)const; // mohan add 2011-03-22
+	void print_stru_ofs(std::ostream &ofs, const int &type=1, const int &level=0)const; // the content of print_stru_file
 	void check_dtau(void);
     void setup_cell_after_vc(std::ofstream &log); //LiuXh add 20180515
 	
@@ -9,6 +9,11 @@
 
 namespace elecstate
 {
+template <>
+void ElecStateLCAO<double>::dmToRho();
+template <>
+void ElecStateLCAO<std::complex<double>>::dmToRho();
+
 template <typename TK>
 int ElecStateLCAO<TK>::out_wfc_lcao = 0;
 
@@ -132,6 +137,17 @@ void ElecStateLCAO<std::complex<double>>::psiToRho(const psi::Psi<std::complex<d
     }
     // old 2D-to-Grid conversion has been replaced by new Gint Refactor 2023/09/25
     //this->loc->cal_dk_k(*this->lowf->gridt, this->wg, (*this->klist));
+    this->dmToRho();
+
+    ModuleBase::timer::tick("ElecStateLCAO", "psiToRho");
+    return;
+}
+
+template <>
+void ElecStateLCAO<std::complex<double>>::dmToRho()
+{
+    ModuleBase::TITLE("ElecStateLCAO", "dmToRho");
+    ModuleBase::timer::tick("ElecStateLCAO", "dmToRho");
     for (int is = 0; is < GlobalV::NSPIN; is++)
     {
         ModuleBase::GlobalFunc::ZEROS(this->charge->rho[is], this->charge->nrxx); // mohan 2009-11-10
@@ -154,9 +170,7 @@ void ElecStateLCAO<std::complex<double>>::psiToRho(const psi::Psi<std::complex<d
     }
 
     this->charge->renormalize_rho();
-
-    ModuleBase::timer::tick("ElecStateLCAO", "psiToRho");
-    return;
+    ModuleBase::timer::tick("ElecStateLCAO", "dmToRho");
 }
 
 // Gamma_only case
@@ -204,6 +218,17 @@ void ElecStateLCAO<double>::psiToRho(const psi::Psi<double>& psi)
         }
     }
 
+    this->dmToRho();
+
+    ModuleBase::timer::tick("ElecStateLCAO", "psiToRho");
+    return;
+}
+
+template <>
+void ElecStateLCAO<double>::dmToRho()
+{
+    ModuleBase::TITLE("ElecStateLCAO", "dmToRho");
+    ModuleBase::timer::tick("ElecStateLCAO", "dmToRho");
     for (int is = 0; is < GlobalV::NSPIN; is++)
     {
         ModuleBase::GlobalFunc::ZEROS(this->charge->rho[is], this->charge->nrxx); // mohan 2009-11-10
@@ -227,9 +252,7 @@ void ElecStateLCAO<double>::psiToRho(const psi::Psi<double>& psi)
     }
 
     this->charge->renormalize_rho();
-
-    ModuleBase::timer::tick("ElecStateLCAO", "psiToRho");
-    return;
+    ModuleBase::timer::tick("ElecStateLCAO", "dmToRho");
 }
 
 template <typename TK>
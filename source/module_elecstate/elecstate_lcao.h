@@ -40,6 +40,8 @@ class ElecStateLCAO : public ElecState
 
     // interface for HSolver to calculate rho from Psi
     virtual void psiToRho(const psi::Psi<TK>& psi) override;
+    // calculate rho on the real space grid from the density matrix DM(R) stored in this->DM
+    void dmToRho();
     //virtual void psiToRho(const psi::Psi<double>& psi) override;
     // return current electronic density rho, as a input for constructing Hamiltonian
     // const double* getRho(int spin) const override;
@@ -26,6 +26,7 @@
 #include "module_base/math_integral.h"
 #include "module_base/memory.h"
 #include "module_base/parallel_reduce.h"
+#include "module_base/radial_form_factor.h"
 #include "module_base/timer.h"
 #include "module_base/tool_threading.h"
 #include "module_cell/unitcell.h"
@@ -387,16 +388,31 @@ void Charge::atomic_rho(const int spin_number_need,
                             // G=0 term only belong to 1 cpu.
                             // Other processors start from '0'
                             //----------------------------------------------------------
+                            // with pseudo_sbt_fft the transform is tabulated once on a uniform q grid
+                            // by FFT and interpolated onto the |G| shells
+                            if (GlobalV::PSEUDO_SBT_FFT && this->rhopw->ngg > gstart)
+                            {
+                                std::vector<double> gx(this->rhopw->ngg - gstart);
+                                for (int igg = gstart; igg < this->rhopw->ngg; ++igg)
+                                {
+                                    gx[igg - gstart] = sqrt(this->rhopw->gg_uniq[igg]) * ucell.tpiba;
+                                }
+                                ModuleBase::RadialFormFactor rho_ff;
+                                rho_ff.build(0, mesh, atom->ncpp.r, rhoatm.data(), 2, gx.back());
+                                rho_ff.eval(gx.size(), gx.data(), &rho_lgl[gstart]);
+                            }
     #ifdef _OPENMP
     #pragma omp parallel
                         {
     #endif
                             std::vector<double> rho1d(ucell.meshx);
 
+                            // otherwise the radial integration is done for each shell
+                            const int igg_start = GlobalV::PSEUDO_SBT_FFT ? this->rhopw->ngg : gstart;
     #ifdef _OPENMP
     #pragma omp for
     #endif
-                            for (int igg = gstart; igg < this->rhopw->ngg; ++igg)
+                            for (int igg = igg_start; igg < this->rhopw->ngg; ++igg)
                             {
                                 const double gx = sqrt(this->rhopw->gg_uniq[igg]) * ucell.tpiba;
                                 for (int ir = 0; ir < mesh; ir++)
@@ -130,6 +130,7 @@ void Charge_Mixing::Simplified_Broyden_mixing(const int &iter,
 		}
 		this->rhopw->recip2real( chr->rhog_save[is], chr->rho[is]);
 	}
+	this->iter_broyden = iter;
 	ModuleBase::timer::tick("Charge", "Broyden_mixing");
 	return;
 }
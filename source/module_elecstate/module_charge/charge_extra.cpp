@@ -4,6 +4,17 @@
 #include "module_base/global_variable.h"
 #include "module_base/tool_threading.h"
 #include "module_io/cube_io.h"
+#include "module_io/rho_io.h"
+
+namespace
+{
+// the files of the extrapolation are written in the format of out_chg_format
+std::string extra_file_name(const std::string& tag, const int is)
+{
+    const std::string fn = GlobalV::global_out_dir + tag + "_SPIN" + std::to_string(is + 1) + "_CHG.cube";
+    return GlobalV::out_chg_format == "cube" ? fn : ModuleIO::rho_binary_name(fn);
+}
+} // namespace
 
 Charge_Extra::Charge_Extra()
 {
@@ -323,13 +334,13 @@ void Charge_Extra::save_files(const int& istep,
                               const Charge* chr,
                               const Structure_Factor* sf) const
 {
-    // rename OLD1_SPIN*_CHG.cube to OLD2_SPIN*_CHG.cube
+    // rename OLD1_SPIN*_CHG.cube to OLD2_SPIN*_CHG.cube (.bin for the binary formats)
     if (istep > 1 && pot_order == 3 && GlobalV::MY_RANK == 0)
     {
         for (int is = 0; is < GlobalV::NSPIN; ++is)
         {
-            std::string old_name = GlobalV::global_out_dir + "OLD1_SPIN" + std::to_string(is + 1) + "_CHG.cube";
-            std::string new_name = GlobalV::global_out_dir + "OLD2_SPIN" + std::to_string(is + 1) + "_CHG.cube";
+            std::string old_name = extra_file_name("OLD1", is);
+            std::string new_name = extra_file_name("OLD2", is);
             if (std::rename(old_name.c_str(), new_name.c_str()) == -1)
             {
                 std::cout << "old file: " << old_name << std::endl;
@@ -344,8 +355,8 @@ void Charge_Extra::save_files(const int& istep,
     {
         for (int is = 0; is < GlobalV::NSPIN; ++is)
         {
-            std::string old_name = GlobalV::global_out_dir + "NOW_SPIN" + std::to_string(is + 1) + "_CHG.cube";
-            std::string new_name = GlobalV::global_out_dir + "OLD1_SPIN" + std::to_string(is + 1) + "_CHG.cube";
+            std::string old_name = extra_file_name("NOW", is);
+            std::string new_name = extra_file_name("OLD1", is);
             if (std::rename(old_name.c_str(), new_name.c_str()) == -1)
             {
                 std::cout << "old file: " << old_name << std::endl;
@@ -380,7 +391,26 @@ void Charge_Extra::save_files(const int& istep,
     // save NOW_SPIN*_CHG.cube
     for (int is = 0; is < GlobalV::NSPIN; ++is)
     {
-        std::string filename = GlobalV::global_out_dir + "NOW_SPIN" + std::to_string(is + 1) + "_CHG.cube";
+        std::string filename = extra_file_name("NOW", is);
+        if (GlobalV::out_chg_format != "cube")
+        {
+            ModuleIO::write_rho_binary(
+#ifdef __MPI
+                chr->rhopw->nplane,
+                chr->rhopw->startz_current,
+#endif
+                rho_atom[is],
+                is,
+                GlobalV::NSPIN,
+                filename,
+                chr->rhopw->nx,
+                chr->rhopw->ny,
+                chr->rhopw->nz,
+                0.0,
+                &ucell,
+                GlobalV::out_chg_format == "binary_zlib");
+            continue;
+        }
         ModuleIO::write_cube(
 #ifdef __MPI
             pw_big->bz,
@@ -424,7 +454,26 @@ void Charge_Extra::read_files(
 
     for (int is = 0; is < GlobalV::NSPIN; ++is)
     {
-        std::string filename = GlobalV::global_out_dir + tag + "_SPIN" + std::to_string(is + 1) + "_CHG.cube";
+        std::string filename = extra_file_name(tag, is);
+        if (GlobalV::out_chg_format != "cube")
+        {
+            ModuleIO::read_rho_binary(
+#ifdef __MPI
+                Pgrid,
+#endif
+                is,
+                GlobalV::NSPIN,
+                filename,
+                data[is],
+                nx,
+                ny,
+                nz,
+                ef,
+                ucell,
+                prenspin,
+                false);
+            continue;
+        }
         ModuleIO::read_cube(
 #ifdef __MPI
             Pgrid,
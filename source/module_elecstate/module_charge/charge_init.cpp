@@ -8,6 +8,7 @@
 #include "module_base/math_sphbes.h"
 #include "module_base/memory.h"
 #include "module_base/parallel_reduce.h"
+#include "module_base/radial_form_factor.h"
 #include "module_base/timer.h"
 #include "module_base/tool_threading.h"
 #include "module_elecstate/magnetism.h"
@@ -149,9 +150,27 @@ void Charge::init_rho(elecstate::efermi& eferm_iout, const ModuleBase::ComplexMa
     // Peize Lin add 2020.04.04
     if (GlobalC::restart.info_load.load_charge && !GlobalC::restart.info_load.load_charge_finish)
     {
-        for (int is = 0; is < GlobalV::NSPIN; ++is)
+        // the binary checkpoint may come from another parallel layout
+        Restart::Info_Checkpoint info;
+        if (GlobalC::restart.info_load.load_checkpoint && GlobalC::restart.load_checkpoint_info(info)
+            && GlobalC::restart.load_grids(info,
+                                           "charge",
+                                           this->rhopw->nx,
+                                           this->rhopw->ny,
+                                           this->rhopw->nz,
+                                           this->rhopw->startz_current,
+                                           this->rhopw->nplane,
+                                           std::vector<double*>(rho, rho + GlobalV::NSPIN)))
+        {
+            GlobalV::ofs_running << " Read in the charge density of iteration " << info.iter
+                                 << " from the restart checkpoint" << std::endl;
+        }
+        else
         {
-            GlobalC::restart.load_disk("charge", is, this->nrxx, rho);
+            for (int is = 0; is < GlobalV::NSPIN; ++is)
+            {
+                GlobalC::restart.load_disk("charge", is, this->nrxx, rho);
+            }
         }
         GlobalC::restart.info_load.load_charge_finish = true;
     }
@@ -296,6 +315,39 @@ void Charge::non_linear_core_correction
 {
     ModuleBase::TITLE("charge","drhoc");
 
+    // with pseudo_sbt_fft the transform is tabulated once on a uniform q grid
+    // by FFT and interpolated onto the |G| shells
+    if (numeric && GlobalV::PSEUDO_SBT_FFT)
+    {
+        int igl0 = 0;
+        if (this->rhopw->gg_uniq[0] < 1.0e-8)
+        {
+            std::vector<double> aux(mesh);
+            for (int ir = 0; ir < mesh; ir++)
+            {
+                aux[ir] = r[ir] * r[ir] * rhoc[ir];
+            }
+            ModuleBase::Integral::Simpson_Integral(mesh, aux.data(), rab, rhocg[0]);
+            igl0 = 1;
+        }
+        if (this->rhopw->ngg > igl0)
+        {
+            std::vector<double> gx(this->rhopw->ngg - igl0);
+            for (int igl = igl0; igl < this->rhopw->ngg; igl++)
+            {
+                gx[igl - igl0] = sqrt(this->rhopw->gg_uniq[igl] * GlobalC::ucell.tpiba2);
+            }
+            ModuleBase::RadialFormFactor rhoc_ff;
+            rhoc_ff.build(0, mesh, r, rhoc, 0, gx.back());
+            rhoc_ff.eval(gx.size(), gx.data(), &rhocg[igl0]);
+        }
+        for (int igl = 0; igl < this->rhopw->ngg; igl++)
+        {
+            rhocg[igl] *= ModuleBase::FOUR_PI / GlobalC::ucell.omega;
+        }
+        return;
+    }
+
 	// use labmda instead of repeating codes
 	const auto kernel = [&](int num_threads, int thread_id)
 	{
@@ -220,7 +220,7 @@ void Charge_Mixing::mix_rho(const int &iter, Charge* chr)
     }
     else if ( this->mixing_mode == "broyden")
     {
-		this->Simplified_Broyden_mixing(iter, chr);
+		this->Simplified_Broyden_mixing(iter + this->iter_rst, chr);
     }
     else
     {
@@ -487,3 +487,83 @@ double Charge_Mixing::rhog_dot_product(
     return sum;
 }
 
+std::vector<int> Charge_Mixing::get_history_steps() const
+{
+	if(this->mixing_mode == "pulay")
+	{
+		return {irstep, idstep, totstep};
+	}
+	else if(this->mixing_mode == "broyden")
+	{
+		return {iter_broyden};
+	}
+	return {};
+}
+
+std::vector<double*> Charge_Mixing::get_history_grids()
+{
+	std::vector<double*> grids;
+	if(this->mixing_mode != "pulay")
+	{
+		return grids;
+	}
+
+	rstep = this->mixing_ndim;
+	dstep = this->mixing_ndim - 1;
+	this->allocate_Pulay();
+
+	const bool with_tau = (XC_Functional::get_func_type() == 3 || XC_Functional::get_func_type() == 5) && mixing_tau;
+	for(int is=0; is<GlobalV::NSPIN; is++)
+	{
+		for(int i=0; i<rstep; i++) grids.push_back(Rrho[is][i]);
+		for(int i=0; i<dstep; i++) grids.push_back(dRrho[is][i]);
+		for(int i=0; i<dstep; i++) grids.push_back(drho[is][i]);
+		grids.push_back(rho_save2[is]);
+		if(with_tau)
+		{
+			for(int i=0; i<rstep; i++) grids.push_back(Rtau[is][i]);
+			for(int i=0; i<dstep; i++) grids.push_back(dRtau[is][i]);
+			for(int i=0; i<dstep; i++) grids.push_back(dtau[is][i]);
+			grids.push_back(tau_save2[is]);
+		}
+	}
+	return grids;
+}
+
+std::vector<std::complex<double>*> Charge_Mixing::get_history_coefs()
+{
+	std::vector<std::complex<double>*> coefs;
+	if(this->mixing_mode != "broyden")
+	{
+		return coefs;
+	}
+
+	this->allocate_Broyden();
+	for(int i=0; i<mixing_ndim+1; i++)
+	{
+		for(int is=0; is<GlobalV::NSPIN; is++)
+		{
+			coefs.push_back(dF[i][is]);
+			coefs.push_back(dn[i][is]);
+		}
+	}
+	return coefs;
+}
+
+void Charge_Mixing::set_history_steps(const std::vector<int>& steps)
+{
+	if(this->mixing_mode == "pulay")
+	{
+		assert(steps.size() == 3);
+		irstep = steps[0];
+		idstep = steps[1];
+		totstep = steps[2];
+		// keep the loaded history in allocate_Pulay
+		this->new_e_iteration = false;
+	}
+	else if(this->mixing_mode == "broyden")
+	{
+		assert(steps.size() == 1);
+		this->iter_rst = steps[0];
+	}
+}
@@ -62,6 +62,18 @@ class Charge_Mixing
 	int get_idstep() const {return idstep;}
 	double* get_alpha() const {return alpha;}
 
+//======================================
+// mixing history kept in restart checkpoints, in charge_mixing.cpp
+//======================================
+	// step counters of the history
+	std::vector<int> get_history_steps() const;
+	// Pulay: real-space grids of the history, distributed like rho; allocated if needed
+	std::vector<double*> get_history_grids();
+	// Broyden: G-space coefficients of the history on this rank; allocated if needed
+	std::vector<std::complex<double>*> get_history_coefs();
+	// continue from a history loaded into the arrays above, must be called after reset()
+	void set_history_steps(const std::vector<int>& steps);
+
 	private:
 
 //======================================
@@ -133,6 +145,8 @@ class Charge_Mixing
 		Charge* chr); //qianrui created 2021-5-15
 
 	bool initb; // b stands for Broyden algorithms.
+	int iter_rst = 0; // iterations of the Broyden history loaded from a restart checkpoint
+	int iter_broyden = 0; // the last iteration of Simplified_Broyden_mixing, counting iter_rst
 	void allocate_Broyden();
 	void deallocate_Broyden();
 
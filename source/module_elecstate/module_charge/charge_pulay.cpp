@@ -140,6 +140,7 @@ void Charge_Mixing::reset()		// Peize Lin add 2018-11-01
 	irstep = 0;
 	idstep = 0;
 	totstep = 0;
+	iter_rst = 0;
 
     // liuyu add 2023-03-29
     // if md_prec_level == 2, charge mixing should re-allocate 
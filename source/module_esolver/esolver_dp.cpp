@@ -21,6 +21,8 @@
 #include "module_base/parallel_common.h"
 #include "module_base/timer.h"
 
+#include <cmath>
+
 namespace ModuleESolver
 {
 
@@ -120,6 +122,100 @@ namespace ModuleESolver
         ModuleBase::timer::tick("ESolver_DP", "Run");
     }
 
+    void ESolver_DP::Run_frames(const int nframes_in,
+                                const ModuleBase::Vector3<double>* tau,
+                                const ModuleBase::Matrix3* latvec,
+                                const UnitCell& ucell)
+    {
+        ModuleBase::TITLE("ESolver_DP", "Run_frames");
+        ModuleBase::timer::tick("ESolver_DP", "Run_frames");
+
+        const int nat = ucell.nat;
+        nframes = nframes_in;
+
+        /// the buffers only grow, so repeated calls with the same batch size do not reallocate
+        frames_cell.resize(9 * nframes);
+        frames_coord.resize(3 * nat * nframes);
+
+        for (int iframe = 0; iframe < nframes; ++iframe)
+        {
+            const ModuleBase::Matrix3& lat = latvec[iframe];
+            double* box = frames_cell.data() + 9 * iframe;
+            box[0] = lat.e11 * ucell.lat0_angstrom;
+            box[1] = lat.e12 * ucell.lat0_angstrom;
+            box[2] = lat.e13 * ucell.lat0_angstrom;
+            box[3] = lat.e21 * ucell.lat0_angstrom;
+            box[4] = lat.e22 * ucell.lat0_angstrom;
+            box[5] = lat.e23 * ucell.lat0_angstrom;
+            box[6] = lat.e31 * ucell.lat0_angstrom;
+            box[7] = lat.e32 * ucell.lat0_angstrom;
+            box[8] = lat.e33 * ucell.lat0_angstrom;
+
+            const ModuleBase::Vector3<double>* pos = tau + nat * iframe;
+            double* xyz = frames_coord.data() + 3 * nat * iframe;
+            for (int i = 0; i < nat; ++i)
+            {
+                xyz[3 * i] = pos[i].x * ucell.lat0_angstrom;
+                xyz[3 * i + 1] = pos[i].y * ucell.lat0_angstrom;
+                xyz[3 * i + 2] = pos[i].z * ucell.lat0_angstrom;
+            }
+        }
+
+#ifdef __DPMD
+        std::vector<double> e, f, v;
+        dp.compute(e, f, v, frames_coord, atype, frames_cell);
+
+        const double fact_f = ModuleBase::Ry_to_eV * ModuleBase::ANGSTROM_AU;
+        const double lat0_3 = ucell.lat0 * ucell.lat0 * ucell.lat0;
+
+        frames_potential.resize(nframes);
+        frames_force.resize(3 * nat * nframes);
+        frames_virial.resize(9 * nframes);
+        for (int iframe = 0; iframe < nframes; ++iframe)
+        {
+            frames_potential[iframe] = e[iframe] / ModuleBase::Ry_to_eV;
+
+            const double omega = std::abs(latvec[iframe].Det()) * lat0_3;
+            const double fact_v = omega * ModuleBase::Ry_to_eV;
+            for (int i = 0; i < 9; ++i)
+            {
+                frames_virial[9 * iframe + i] = v[9 * iframe + i] / fact_v;
+            }
+        }
+        for (int i = 0; i < 3 * nat * nframes; ++i)
+        {
+            frames_force[i] = f[i] / fact_f;
+        }
+#else
+        ModuleBase::WARNING_QUIT("ESolver_DP", "Please recompile with -D__DPMD");
+#endif
+        ModuleBase::timer::tick("ESolver_DP", "Run_frames");
+    }
+
+    void ESolver_DP::cal_Frame(const int iframe,
+                               double& etot,
+                               ModuleBase::matrix& force,
+                               ModuleBase::matrix& stress) const
+    {
+        assert(iframe >= 0 && iframe < nframes);
+        const int nat = force.nr;
+        etot = frames_potential[iframe];
+        for (int i = 0; i < nat; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                force(i, j) = frames_force[3 * nat * iframe + 3 * i + j];
+            }
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                stress(i, j) = frames_virial[9 * iframe + 3 * i + j];
+            }
+        }
+    }
+
     double ESolver_DP::cal_Energy()
     {
         return dp_potential;
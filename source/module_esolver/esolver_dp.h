@@ -46,6 +46,39 @@ class ESolver_DP : public ESolver
      */
     void Run(const int istep, UnitCell& cell) override;
 
+    /**
+     * @brief Run the DP solver for several frames of the same atoms in one DeePMD call
+     *
+     * The frames share the atom types of the unit cell, so the type array built in Init is reused.
+     *
+     * @param nframes the number of frames
+     * @param tau atomic positions of all frames in lat0, nframes * nat in the atom order of cell
+     * @param latvec lattice vectors of all frames in lat0
+     * @param cell unitcell information
+     */
+    void Run_frames(const int nframes,
+                    const ModuleBase::Vector3<double>* tau,
+                    const ModuleBase::Matrix3* latvec,
+                    const UnitCell& cell);
+
+    /**
+     * @brief get the energy, forces and virials of one frame computed by Run_frames
+     *
+     * @param iframe the index of the frame
+     * @param etot the computed energy
+     * @param force the computed atomic forces
+     * @param stress the computed lattice virials
+     */
+    void cal_Frame(const int iframe, double& etot, ModuleBase::matrix& force, ModuleBase::matrix& stress) const;
+
+    /**
+     * @brief get the number of frames computed by the last Run_frames
+     */
+    int get_nframes() const
+    {
+        return nframes;
+    }
+
     /**
      * @brief get the total energy without ion kinetic energy
      *
@@ -115,6 +148,13 @@ class ESolver_DP : public ESolver
     double dp_potential;          ///< the computed potential energy
     ModuleBase::matrix dp_force;  ///< the computed atomic forces
     ModuleBase::matrix dp_virial; ///< the computed lattice virials
+
+    int nframes = 0;                       ///< the number of frames computed by Run_frames
+    std::vector<double> frames_cell;       ///< the lattice vectors of all frames
+    std::vector<double> frames_coord;      ///< the atomic positions of all frames
+    std::vector<double> frames_potential;  ///< the computed potential energy of all frames
+    std::vector<double> frames_force;      ///< the computed atomic forces of all frames
+    std::vector<double> frames_virial;     ///< the computed lattice virials of all frames
 };
 
 } // namespace ModuleESolver
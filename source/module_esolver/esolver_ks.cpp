@@ -384,7 +384,12 @@ namespace ModuleESolver
                         if(iter == 1)
                         {
                             double bandgap_for_autoset = 0.0;
-                            if (!GlobalV::TWO_EFERMI)
+                            if (GlobalV::KS_SOLVER == "purification")
+                            {
+                                // no eigenvalues, the conservative mixing_beta of metals is taken
+                                bandgap_for_autoset = 0.0;
+                            }
+                            else if (!GlobalV::TWO_EFERMI)
                             {
                                 this->pelec->cal_bandgap();
                                 bandgap_for_autoset = this->pelec->bandgap;
@@ -486,7 +491,8 @@ namespace ModuleESolver
                                     GlobalV::global_out_dir,
                                     precision,
                                     tag,
-                                    prefix);
+                                    prefix,
+                                    GlobalV::out_chg_format);
     }
 
     template<typename T, typename Device>
@@ -505,7 +511,8 @@ namespace ModuleESolver
                                     GlobalV::global_out_dir,
                                     precision,
                                     tag,
-                                    prefix);
+                                    prefix,
+                                    GlobalV::out_chg_format);
     }
 
     template<typename T, typename Device>
@@ -348,7 +348,9 @@ void ESolver_KS_LCAO::postprocess()
         GlobalV::ofs_running << "\n\n\n\n";
     }
     // qianrui modify 2020-10-18
-    if (GlobalV::CALCULATION == "scf" || GlobalV::CALCULATION == "md" || GlobalV::CALCULATION == "relax")
+    // purification gives no eigenvalues
+    if ((GlobalV::CALCULATION == "scf" || GlobalV::CALCULATION == "md" || GlobalV::CALCULATION == "relax")
+        && GlobalV::KS_SOLVER != "purification")
     {
         ModuleIO::write_istate_info(this->pelec->ekb, this->pelec->wg, kv, &(GlobalC::Pkpoints));
     }
@@ -507,6 +509,13 @@ void ESolver_KS_LCAO::eachiterinit(const int istep, const int iter)
     if (iter == 1)
         this->p_chgmix->reset();
 
+    // the mixing history is loaded after reset
+    if (iter == 1 && GlobalC::restart.info_load.load_checkpoint && !GlobalC::restart.info_load.load_checkpoint_finish)
+    {
+        this->load_checkpoint();
+        GlobalC::restart.info_load.load_checkpoint_finish = true;
+    }
+
     // mohan update 2012-06-05
     this->pelec->f_en.deband_harris = this->pelec->cal_delta_eband();
 
@@ -632,8 +641,8 @@ void ESolver_KS_LCAO::hamilt2density(int istep, int iter, double ethr)
         ModuleBase::WARNING_QUIT("ESolver_KS_PW", "HSolver has not been initialed!");
     }
 
-    // print ekb for each k point and each band
-    for (int ik = 0; ik < kv.nks; ++ik)
+    // print ekb for each k point and each band, purification gives no eigenvalues
+    for (int ik = 0; ik < kv.nks && GlobalV::KS_SOLVER != "purification"; ++ik)
     {
         this->pelec->print_band(ik, INPUT.printe, iter);
     }
@@ -819,6 +828,10 @@ void ESolver_KS_LCAO::eachiterfinish(int iter)
             GlobalC::restart.save_disk(*this->UHM.LM, "charge", is, pelec->charge->nrxx, pelec->charge->rho);
         }
     }
+    if (GlobalC::restart.info_save.checkpoint_freq > 0 && iter % GlobalC::restart.info_save.checkpoint_freq == 0)
+    {
+        this->save_checkpoint(iter);
+    }
 
     //-----------------------------------
     // output charge density for tmp
@@ -848,6 +861,12 @@ void ESolver_KS_LCAO::eachiterfinish(int iter)
 
 void ESolver_KS_LCAO::afterscf(const int istep)
 {
+    // the last checkpoint is only complete when all ranks have written it
+    if (GlobalC::restart.info_save.checkpoint_freq > 0)
+    {
+        GlobalC::restart.wait_checkpoint();
+    }
+
     // save charge difference into files for charge extrapolation
     if (GlobalV::CALCULATION != "scf")
     {
@@ -901,7 +920,7 @@ void ESolver_KS_LCAO::afterscf(const int istep)
     ModuleIO::output_convergence_after_scf(this->conv_elec, this->pelec->f_en.etot);
     ModuleIO::output_efermi(this->conv_elec, this->pelec->eferm.ef);
 
-    if (GlobalV::OUT_LEVEL != "m")
+    if (GlobalV::OUT_LEVEL != "m" && GlobalV::KS_SOLVER != "purification")
     {
         this->pelec->print_eigenvalue(GlobalV::ofs_running);
     }
@@ -1031,6 +1050,105 @@ ModuleIO::Output_Mat_Sparse ESolver_KS_LCAO::create_Output_Mat_Sparse(int istep)
                                        this->p_hamilt);
 }
 
+std::vector<hamilt::HContainer<double>*> ESolver_KS_LCAO::get_DMR_vector() const
+{
+    if (GlobalV::GAMMA_ONLY_LOCAL)
+    {
+        return dynamic_cast<const elecstate::ElecStateLCAO<double>*>(this->pelec)->get_DM()->get_DMR_vector();
+    }
+    else
+    {
+        return dynamic_cast<const elecstate::ElecStateLCAO<std::complex<double>>*>(this->pelec)
+            ->get_DM()
+            ->get_DMR_vector();
+    }
+}
+
+void ESolver_KS_LCAO::save_checkpoint(const int iter)
+{
+    ModuleBase::TITLE("ESolver_KS_LCAO", "save_checkpoint");
+    ModuleBase::timer::tick("ESolver_KS_LCAO", "save_checkpoint");
+
+    const ModulePW::PW_Basis* rhopw = this->pw_rho;
+    GlobalC::restart.begin_checkpoint();
+
+    const std::vector<const double*> rho(this->pelec->charge->rho, this->pelec->charge->rho + GlobalV::NSPIN);
+    GlobalC::restart.save_grids("charge", rhopw->nx, rhopw->ny, rhopw->nz, rhopw->startz_current, rhopw->nplane, rho);
+
+    const std::vector<double*> mix_grids = this->p_chgmix->get_history_grids();
+    if (!mix_grids.empty())
+    {
+        const std::vector<const double*> grids(mix_grids.begin(), mix_grids.end());
+        GlobalC::restart.save_grids("mixing", rhopw->nx, rhopw->ny, rhopw->nz, rhopw->startz_current, rhopw->nplane, grids);
+    }
+    const std::vector<std::complex<double>*> mix_coefs = this->p_chgmix->get_history_coefs();
+    if (!mix_coefs.empty())
+    {
+        const std::vector<const std::complex<double>*> coefs(mix_coefs.begin(), mix_coefs.end());
+        GlobalC::restart.save_coefs("mixing", rhopw->npw, coefs);
+    }
+
+    // the SCF rebuilds DMR from the wave functions in the first iteration, so it is written for
+    // post-processing with Restart::load_hcontainer but not read back by load_checkpoint
+    GlobalC::restart.save_hcontainer("DMR", this->get_DMR_vector());
+
+    Restart::Info_Checkpoint info;
+    info.nproc = GlobalV::NPROC;
+    info.iter = iter;
+    info.mixing_steps = this->p_chgmix->get_history_steps();
+    GlobalC::restart.commit_checkpoint(info);
+
+    ModuleBase::timer::tick("ESolver_KS_LCAO", "save_checkpoint");
+}
+
+void ESolver_KS_LCAO::load_checkpoint()
+{
+    ModuleBase::TITLE("ESolver_KS_LCAO", "load_checkpoint");
+    ModuleBase::timer::tick("ESolver_KS_LCAO", "load_checkpoint");
+
+    Restart::Info_Checkpoint info;
+    if (!GlobalC::restart.load_checkpoint_info(info))
+    {
+        ModuleBase::WARNING("ESolver_KS_LCAO", "no restart checkpoint found, start SCF from scratch");
+        ModuleBase::timer::tick("ESolver_KS_LCAO", "load_checkpoint");
+        return;
+    }
+
+    // the history is only taken if it is complete, otherwise the mixing starts afresh
+    const ModulePW::PW_Basis* rhopw = this->pw_rho;
+    bool mix_ok = true;
+    const std::vector<double*> mix_grids = this->p_chgmix->get_history_grids();
+    if (!mix_grids.empty())
+    {
+        mix_ok = GlobalC::restart.load_grids(info,
+                                             "mixing",
+                                             rhopw->nx,
+                                             rhopw->ny,
+                                             rhopw->nz,
+                                             rhopw->startz_current,
+                                             rhopw->nplane,
+                                             mix_grids);
+    }
+    const std::vector<std::complex<double>*> mix_coefs = this->p_chgmix->get_history_coefs();
+    if (!mix_coefs.empty())
+    {
+        mix_ok = GlobalC::restart.load_coefs(info, "mixing", rhopw->npw, mix_coefs);
+    }
+    if (mix_ok && !info.mixing_steps.empty())
+    {
+        this->p_chgmix->set_history_steps(info.mixing_steps);
+        GlobalV::ofs_running << " Continue charge mixing from iteration " << info.iter
+                             << " of the restart checkpoint" << std::endl;
+    }
+    else
+    {
+        this->p_chgmix->reset();
+        ModuleBase::WARNING("ESolver_KS_LCAO", "charge mixing history of the restart checkpoint is not used");
+    }
+
+    ModuleBase::timer::tick("ESolver_KS_LCAO", "load_checkpoint");
+}
+
 bool ESolver_KS_LCAO::md_skip_out(std::string calculation, int istep, int interval)
 {
     if (calculation == "md")
@@ -82,6 +82,15 @@ namespace ModuleESolver
         /// @brief check if skip the corresponding output in md calculation
         bool md_skip_out(std::string calculation, int istep, int interval);
 
+        /// @brief write charge density, mixing history and DMR into the binary restart checkpoint
+        void save_checkpoint(const int iter);
+
+        /// @brief load mixing history from the binary restart checkpoint, the charge density is loaded in init_rho
+        void load_checkpoint();
+
+        /// @brief the real-space density matrices of each spin
+        std::vector<hamilt::HContainer<double>*> get_DMR_vector() const;
+
 #ifdef __EXX
         std::shared_ptr<Exx_LRI_Interface<double>> exd = nullptr;
         std::shared_ptr<Exx_LRI_Interface<std::complex<double>>> exc = nullptr;
@@ -7,6 +7,7 @@
 #include "module_base/timer.h"
 #include "module_cell/module_neighbor/sltk_atom_arrange.h"
 #include "module_cell/module_neighbor/sltk_grid_driver.h"
+#include "module_hsolver/hsolver_lcao.h"
 #include "module_io/berryphase.h"
 #include "module_io/istate_charge.h"
 #include "module_io/istate_envelope.h"
@@ -335,6 +336,11 @@ namespace ModuleESolver
             dynamic_cast<elecstate::ElecStateLCAO<std::complex<double>>*>(this->pelec)->get_DM()->init_DMR(
                 *(dynamic_cast<hamilt::HamiltLCAO<std::complex<double>, std::complex<double>>*>(this->p_hamilt)->getHR()));
         }
+        // the sparsity pattern of purification follows the atoms
+        if (GlobalV::KS_SOLVER == "purification")
+        {
+            dynamic_cast<hsolver::HSolverLCAO*>(this->phsol)->reset_purification();
+        }
         
         // the electron charge density should be symmetrized,
         // here is the initialization
@@ -143,6 +143,7 @@ void ESolver_KS_LCAO_TDDFT::hamilt2density(int istep, int iter, double ethr)
                                                  this->psi_laststep,
                                                  this->Hk_laststep,
                                                  this->Sk_laststep,
+                                                 this->Sk_lu,
                                                  this->pelec_td->ekb,
                                                  td_htype,
                                                  INPUT.propagator,
@@ -162,6 +163,7 @@ void ESolver_KS_LCAO_TDDFT::hamilt2density(int istep, int iter, double ethr)
                                              this->psi_laststep,
                                              this->Hk_laststep,
                                              this->Sk_laststep,
+                                             this->Sk_lu,
                                              this->pelec_td->ekb,
                                              td_htype,
                                              INPUT.propagator,
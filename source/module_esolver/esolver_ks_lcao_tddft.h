@@ -9,6 +9,7 @@
 #include "module_hamilt_lcao/hamilt_lcaodft/local_orbital_wfc.h"
 #include "module_hamilt_lcao/hamilt_lcaodft/record_adj.h"
 #include "module_elecstate/elecstate_lcao_tddft.h"
+#include "module_hamilt_lcao/module_tddft/propagator.h"
 
 
 namespace ModuleESolver
@@ -24,6 +25,8 @@ class ESolver_KS_LCAO_TDDFT : public ESolver_KS_LCAO
     psi::Psi<std::complex<double>>* psi_laststep = nullptr;
     std::complex<double>** Hk_laststep = nullptr;
     std::complex<double>** Sk_laststep = nullptr;
+    /// LU factors of S(k) used by the propagators, reused while S does not change
+    std::vector<module_tddft::OverlapLU> Sk_lu;
     //same as pelec
     elecstate::ElecStateLCAO_TDDFT* pelec_td = nullptr;
     int td_htype = 1;
@@ -12,6 +12,7 @@
 #include "module_elecstate/module_charge/symmetry_rho.h"
 #include "module_elecstate/occupy.h"
 #include "module_hamilt_general/module_ewald/H_Ewald_pw.h"
+#include "module_hamilt_general/module_xc/xc_functional.h"
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
 #include "module_io/print_info.h"
 //-----force-------------------
@@ -199,6 +200,26 @@ void ESolver_KS_PW<T, Device>::Init(Input& inp, UnitCell& ucell)
     this->pelec->charge->allocate(GlobalV::NSPIN);
     this->pelec->omega = GlobalC::ucell.omega;
 
+#ifdef __EXX
+    if (GlobalC::exx_info.info_global.cal_exx)
+    {
+        if (GlobalV::CALCULATION == "nscf")
+        {
+            ModuleBase::WARNING_QUIT("ESolver_KS_PW", "nscf calculation with hybrid functionals is not supported in planewave");
+        }
+        // two-level calculation as in LCAO: the first scf loop is done without exact exchange,
+        // the ACE operator is added after it converges
+        if (ucell.atoms[0].ncpp.xc_func == "HF" || ucell.atoms[0].ncpp.xc_func == "PBE0" || ucell.atoms[0].ncpp.xc_func == "HSE")
+        {
+            XC_Functional::set_xc_type("pbe");
+        }
+        else if (ucell.atoms[0].ncpp.xc_func == "SCAN0")
+        {
+            XC_Functional::set_xc_type("scan");
+        }
+    }
+#endif
+
     // Initialize the potential.
     if (this->pelec->pot == nullptr)
     {
@@ -339,6 +360,7 @@ template <typename T, typename Device>
 void ESolver_KS_PW<T, Device>::beforescf(int istep)
 {
     ModuleBase::TITLE("ESolver_KS_PW", "beforescf");
+    this->sigmanl_ready = false;
 
     if (GlobalC::ucell.cell_parameter_updated)
     {
@@ -369,6 +391,16 @@ void ESolver_KS_PW<T, Device>::beforescf(int istep)
     {
         this->p_hamilt = new hamilt::HamiltPW<T, Device>(this->pelec->pot, this->pw_wfc, &this->kv);
     }
+#ifdef __EXX
+    // once switched on, exact exchange is kept for the following ionic steps,
+    // the old operator has been deleted together with the old Hamiltonian
+    if (this->exx_op != nullptr)
+    {
+        this->exx_op = nullptr;
+        this->add_exx_operator();
+        this->exx_two_level_step = 1;
+    }
+#endif
 
     //----------------------------------------------------------
     // about vdw, jiyy add vdwd3 and linpz add vdwd2
@@ -446,6 +478,60 @@ void ESolver_KS_PW<T, Device>::othercalculation(const int istep)
     return;
 }
 
+template <typename T, typename Device>
+bool ESolver_KS_PW<T, Device>::do_after_converge(int& iter)
+{
+#ifdef __EXX
+    if (GlobalC::exx_info.info_global.cal_exx)
+    {
+        // the ACE operator is rebuilt from the converged orbitals until the scf loop
+        // converges in its first iteration or the maximal number of exx steps is reached
+        if (this->exx_two_level_step == GlobalC::exx_info.info_global.hybrid_step
+            || (iter == 1 && this->exx_two_level_step != 0))
+        {
+            return true;
+        }
+        if (this->exx_op == nullptr)
+        {
+            XC_Functional::set_xc_type(GlobalC::ucell.atoms[0].ncpp.xc_func);
+            this->add_exx_operator();
+        }
+        else
+        {
+            this->exx_op->update_ace(this->kspw_psi[0], this->pelec->wg);
+        }
+        iter = 0;
+        std::cout << " Updating EXX and rerun SCF" << std::endl;
+        this->exx_two_level_step++;
+        return false;
+    }
+#endif // __EXX
+    return true;
+}
+
+#ifdef __EXX
+template <typename T, typename Device>
+void ESolver_KS_PW<T, Device>::add_exx_operator()
+{
+    ModuleBase::TITLE("ESolver_KS_PW", "add_exx_operator");
+    if (GlobalV::KPAR > 1 || GlobalV::NSPIN == 4 || this->pw_rho->gamma_only)
+    {
+        ModuleBase::WARNING_QUIT("ESolver_KS_PW", "hybrid functionals in planewave need kpar = 1, nspin = 1 or 2 and no gamma_only");
+    }
+    const double hse_omega = (GlobalC::exx_info.info_global.ccp_type == Conv_Coulomb_Pot_K::Ccp_Type::Hse)
+                                 ? GlobalC::exx_info.info_global.hse_omega
+                                 : 0.0;
+    this->exx_op = new hamilt::OperatorEXX<hamilt::OperatorPW<T, Device>>(this->kv.isk.data(),
+                                                                          this->pw_wfc,
+                                                                          this->pw_rho,
+                                                                          this->kv.nkstot_full,
+                                                                          GlobalC::exx_info.info_global.hybrid_alpha,
+                                                                          hse_omega);
+    this->p_hamilt->ops->add(this->exx_op);
+    this->exx_op->update_ace(this->kspw_psi[0], this->pelec->wg);
+}
+#endif
+
 template <typename T, typename Device>
 void ESolver_KS_PW<T, Device>::eachiterinit(const int istep, const int iter)
 {
@@ -576,9 +662,17 @@ void ESolver_KS_PW<T, Device>::hamilt2density(const int istep, const int iter, c
         ModuleBase::WARNING_QUIT("ESolver_KS_PW", "HSolver has not been initialed!");
     }
     // add exx
-#ifdef __LCAO
 #ifdef __EXX
-    this->pelec->set_exx(GlobalC::exx_lip.get_exx_energy()); // Peize Lin add 2019-03-09
+    if (this->exx_op != nullptr)
+    {
+        // hybrid_alpha is already included in the ACE operator
+        this->pelec->f_en.exx = this->exx_op->cal_exx_energy(this->kspw_psi[0], this->pelec->wg);
+    }
+#ifdef __LCAO
+    else
+    {
+        this->pelec->set_exx(GlobalC::exx_lip.get_exx_energy()); // Peize Lin add 2019-03-09
+    }
 #endif
 #endif
     // calculate the delta_harris energy
@@ -730,7 +824,23 @@ void ESolver_KS_PW<T, Device>::cal_Force(ModuleBase::matrix& force)
                                ? new psi::Psi<std::complex<double>, Device>(this->kspw_psi[0])
                                : reinterpret_cast<psi::Psi<std::complex<double>, Device>*>(this->kspw_psi);
     }
-    ff.cal_force(force, *this->pelec, this->pw_rho, &this->symm, &this->sf, &this->kv, this->pw_wfc, this->__kspw_psi);
+    // when the stress follows, its nonlocal part shares vkb and becp with the nonlocal forces
+    ModuleBase::matrix* sigmanl_out = nullptr;
+    if (GlobalV::CAL_STRESS)
+    {
+        this->sigmanl.create(3, 3);
+        sigmanl_out = &this->sigmanl;
+    }
+    ff.cal_force(force,
+                 *this->pelec,
+                 this->pw_rho,
+                 &this->symm,
+                 &this->sf,
+                 &this->kv,
+                 this->pw_wfc,
+                 this->__kspw_psi,
+                 sigmanl_out);
+    this->sigmanl_ready = (sigmanl_out != nullptr);
 }
 
 template <typename T, typename Device>
@@ -753,7 +863,9 @@ void ESolver_KS_PW<T, Device>::cal_Stress(ModuleBase::matrix& stress)
                   &this->kv,
                   this->pw_wfc,
                   this->psi,
-                  this->__kspw_psi);
+                  this->__kspw_psi,
+                  this->sigmanl_ready ? &this->sigmanl : nullptr);
+    this->sigmanl_ready = false;
 
     // external stress
     double unit_transform = 0.0;
@@ -4,6 +4,9 @@
 #include "module_hamilt_pw/hamilt_pwdft/operator_pw/velocity_pw.h"
 #include "module_psi/psi_initializer.h"
 #include <module_base/macros.h>
+#ifdef __EXX
+#include "module_hamilt_pw/hamilt_pwdft/operator_pw/op_exx_pw.h"
+#endif
 
 // #include "Basis_PW.h"
 // #include "Estate_PW.h"
@@ -77,6 +80,7 @@ namespace ModuleESolver
         virtual void eachiterfinish(const int iter) override;
         virtual void afterscf(const int istep) override;
         virtual void othercalculation(const int istep)override;
+        virtual bool do_after_converge(int& iter) override;
 
         //temporary, this will be removed in the future;
         //Init Global class
@@ -91,7 +95,18 @@ namespace ModuleESolver
         psi::AbacusDevice_t device = {};
         psi::Psi<T, Device>* kspw_psi = nullptr;
         psi::Psi<std::complex<double>, Device>* __kspw_psi = nullptr;
+        /// nonlocal stress computed together with the nonlocal forces in cal_Force, used by the next cal_Stress
+        ModuleBase::matrix sigmanl;
+        bool sigmanl_ready = false;
         using castmem_2d_d2h_op = psi::memory::cast_memory_op<std::complex<double>, T, psi::DEVICE_CPU, Device>;
+#ifdef __EXX
+        /// add the exact exchange operator to p_hamilt and build its ACE projectors from the current psi
+        void add_exx_operator();
+        /// owned by p_hamilt once added
+        hamilt::OperatorEXX<hamilt::OperatorPW<T, Device>>* exx_op = nullptr;
+        /// number of ACE updates in the current ionic step, as two_level_step in Exx_LRI
+        int exx_two_level_step = 0;
+#endif
     };
 }  // namespace ModuleESolver
 #endif
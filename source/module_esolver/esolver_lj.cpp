@@ -1,5 +1,8 @@
 #include "esolver_lj.h"
 
+#include "module_base/parallel_reduce.h"
+#include "module_base/timer.h"
+#include "module_base/tool_threading.h"
 #include "module_cell/module_neighbor/sltk_atom_arrange.h"
 #include "module_cell/module_neighbor/sltk_grid_driver.h"
 
@@ -20,55 +23,43 @@ namespace ModuleESolver
         lj_rcut *= ModuleBase::ANGSTROM_AU;
         lj_epsilon /= ModuleBase::Ry_to_eV;
         lj_sigma *= ModuleBase::ANGSTROM_AU;
+
+        // the extra searching radius serves as the Verlet skin; it is kept here because
+        // GlobalV::SEARCH_RADIUS is restored for the DFT esolver in r-RESPA MD
+        lj_rlist = GlobalV::SEARCH_RADIUS;
+        lj_skin = lj_rlist - lj_rcut;
+
+        // atoms are distributed over all processors, each pair is owned by its first atom
+        int nat_local = 0;
+        ModuleBase::TASK_DIST_1D(GlobalV::NPROC, GlobalV::MY_RANK, ucell.nat, iat_begin, nat_local);
+        iat_end = iat_begin + nat_local;
+
+        nl_nbuild = 0;
+        nl_tau_ref.clear();
     }
 
     void ESolver_LJ::Run(const int istep, UnitCell& ucell)
     {
-        Grid_Driver grid_neigh(GlobalV::test_deconstructor, GlobalV::test_grid_driver, GlobalV::test_grid);
-        atom_arrange::search(
-            GlobalV::SEARCH_PBC,
-            GlobalV::ofs_running,
-            grid_neigh,
-            ucell,
-            GlobalV::SEARCH_RADIUS,
-            GlobalV::test_atom_input);
+        ModuleBase::timer::tick("ESolver_LJ", "Run");
 
-        double distance;
-        int index = 0;
+        if (neighbor_list_expired(ucell))
+        {
+            build_neighbor_list(ucell);
+        }
 
         // Important! potential, force, virial must be zero per step
         lj_potential = 0;
         lj_force.zero_out();
         lj_virial.zero_out();
 
-        ModuleBase::Vector3<double> tau1, tau2, dtau;
-        for (int it = 0; it < ucell.ntype; ++it)
-        {
-            Atom* atom1 = &ucell.atoms[it];
-            for (int ia = 0; ia < atom1->na; ++ia)
-            {
-                tau1 = atom1->tau[ia];
-                grid_neigh.Find_atom(ucell, tau1, it, ia);
-                for (int ad = 0; ad < grid_neigh.getAdjacentNum(); ++ad)
-                {
-                    tau2 = grid_neigh.getAdjacentTau(ad);
-                    dtau = (tau1 - tau2) * ucell.lat0;
-                    distance = dtau.norm();
-                    if (distance <= lj_rcut)
-                    {
-                        lj_potential += LJ_energy(distance); // - LJ_energy(lj_rcut);
-                        ModuleBase::Vector3<double> f_ij = LJ_force(distance, dtau);
-                        lj_force(index, 0) += f_ij.x;
-                        lj_force(index, 1) += f_ij.y;
-                        lj_force(index, 2) += f_ij.z;
-                        LJ_virial(f_ij, dtau);
-                    }
-                }
-                index++;
-            }
-        }
+        cal_pair_interaction(ucell);
+
+#ifdef __MPI
+        Parallel_Reduce::reduce_double_all(lj_potential);
+        Parallel_Reduce::reduce_double_all(lj_force.c, lj_force.nr * lj_force.nc);
+        Parallel_Reduce::reduce_double_all(lj_virial.c, lj_virial.nr * lj_virial.nc);
+#endif
 
-        lj_potential /= 2.0;
         GlobalV::ofs_running << " final etot is " << std::setprecision(11) << lj_potential * ModuleBase::Ry_to_eV
                              << " eV" << std::endl;
 
@@ -77,18 +68,11 @@ namespace ModuleESolver
         {
             for (int j = 0; j < 3; ++j)
             {
-                lj_virial(i, j) /= (2.0 * ucell.omega);
+                lj_virial(i, j) /= ucell.omega;
             }
         }
-#ifdef __MPI
-        atom_arrange::delete_vector(
-            GlobalV::ofs_running,
-            GlobalV::SEARCH_PBC,
-            grid_neigh,
-            ucell, 
-            GlobalV::SEARCH_RADIUS,
-            GlobalV::test_atom_input);
-#endif
+
+        ModuleBase::timer::tick("ESolver_LJ", "Run");
     }
 
     double ESolver_LJ::cal_Energy()
@@ -127,16 +111,214 @@ namespace ModuleESolver
         return dr * coff;
     }
 
-    void ESolver_LJ::LJ_virial(const ModuleBase::Vector3<double>& force,
-        const ModuleBase::Vector3<double>& dtau)
+    bool ESolver_LJ::neighbor_list_expired(const UnitCell& ucell) const
     {
-        for (int i = 0; i < 3; ++i)
+        if (nl_tau_ref.size() != static_cast<size_t>(ucell.nat))
         {
-            for (int j = 0; j < 3; ++j)
+            return true;
+        }
+
+        // images of the partners move with the lattice vectors
+        if (ucell.a1 * ucell.lat0 != nl_a1_ref || ucell.a2 * ucell.lat0 != nl_a2_ref
+            || ucell.a3 * ucell.lat0 != nl_a3_ref)
+        {
+            return true;
+        }
+
+        // no pair can cross lj_rcut unless some atom moved more than half of the skin
+        const double thr2 = 0.25 * lj_skin * lj_skin / (ucell.lat0 * ucell.lat0);
+        for (int iat = 0; iat < ucell.nat; ++iat)
+        {
+            if ((ucell.get_tau(iat) - nl_tau_ref[iat]).norm2() > thr2)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ESolver_LJ::build_neighbor_list(UnitCell& ucell)
+    {
+        ModuleBase::TITLE("ESolver_LJ", "build_neighbor_list");
+        ModuleBase::timer::tick("ESolver_LJ", "build_neighbor_list");
+
+        Grid_Driver grid_neigh(GlobalV::test_deconstructor, GlobalV::test_grid_driver, GlobalV::test_grid);
+        atom_arrange::search(
+            GlobalV::SEARCH_PBC,
+            GlobalV::ofs_running,
+            grid_neigh,
+            ucell,
+            lj_rlist,
+            GlobalV::test_atom_input);
+
+        const double rlist = lj_rlist / ucell.lat0;
+        const double rlist2 = rlist * rlist;
+
+        std::vector<int> type_start(ucell.ntype, 0);
+        for (int it = 1; it < ucell.ntype; ++it)
+        {
+            type_start[it] = type_start[it - 1] + ucell.atoms[it - 1].na;
+        }
+
+        nl_start.assign(ucell.nat + 1, 0);
+        nl_jat.clear();
+        nl_shift.clear();
+        for (int iat = iat_begin; iat < iat_end; ++iat)
+        {
+            nl_start[iat] = nl_jat.size();
+
+            const int it = ucell.iat2it[iat];
+            const int ia = ucell.iat2ia[iat];
+            const ModuleBase::Vector3<double>& tau1 = ucell.atoms[it].tau[ia];
+            grid_neigh.Find_atom(ucell, tau1, it, ia);
+            for (int ad = 0; ad < grid_neigh.getAdjacentNum(); ++ad)
+            {
+                const int jt = grid_neigh.getType(ad);
+                const int ja = grid_neigh.getNatom(ad);
+                const int jat = type_start[jt] + ja;
+                const ModuleBase::Vector3<int>& box = grid_neigh.getBox(ad);
+
+                // Newton's third law: keep (i, j, R) once, drop its mirror (j, i, -R)
+                bool keep = jat > iat;
+                if (jat == iat)
+                {
+                    keep = box.x > 0 || (box.x == 0 && (box.y > 0 || (box.y == 0 && box.z > 0)));
+                }
+                if (!keep)
+                {
+                    continue;
+                }
+
+                const ModuleBase::Vector3<double>& tau2 = grid_neigh.getAdjacentTau(ad);
+                if ((tau1 - tau2).norm2() > rlist2)
+                {
+                    continue;
+                }
+
+                nl_jat.push_back(jat);
+                nl_shift.push_back(tau2 - ucell.atoms[jt].tau[ja]);
+            }
+        }
+        for (int iat = iat_end; iat <= ucell.nat; ++iat)
+        {
+            nl_start[iat] = nl_jat.size();
+        }
+
+        nl_tau_ref.resize(ucell.nat);
+        for (int iat = 0; iat < ucell.nat; ++iat)
+        {
+            nl_tau_ref[iat] = ucell.get_tau(iat);
+        }
+        nl_a1_ref = ucell.a1 * ucell.lat0;
+        nl_a2_ref = ucell.a2 * ucell.lat0;
+        nl_a3_ref = ucell.a3 * ucell.lat0;
+        ++nl_nbuild;
+
+#ifdef __MPI
+        atom_arrange::delete_vector(
+            GlobalV::ofs_running,
+            GlobalV::SEARCH_PBC,
+            grid_neigh,
+            ucell,
+            lj_rlist,
+            GlobalV::test_atom_input);
+#endif
+
+        ModuleBase::timer::tick("ESolver_LJ", "build_neighbor_list");
+    }
+
+    void ESolver_LJ::cal_pair_interaction(const UnitCell& ucell)
+    {
+        const int nat = ucell.nat;
+        const double rcut2 = lj_rcut * lj_rcut;
+        const double sigma2 = lj_sigma * lj_sigma;
+
+        std::vector<ModuleBase::Vector3<double>> tau(nat);
+        for (int iat = 0; iat < nat; ++iat)
+        {
+            tau[iat] = ucell.get_tau(iat) * ucell.lat0;
+        }
+
+        // each thread accumulates forces into its own buffer to avoid write conflicts
+        int nthread = 1;
+#ifdef _OPENMP
+        nthread = omp_get_max_threads();
+#endif
+        std::vector<double> force_thread(static_cast<size_t>(nthread) * nat * 3, 0.0);
+
+        double potential = 0.0;
+        double v00 = 0.0, v01 = 0.0, v02 = 0.0, v11 = 0.0, v12 = 0.0, v22 = 0.0;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64) reduction(+ : potential, v00, v01, v02, v11, v12, v22)
+#endif
+        for (int iat = iat_begin; iat < iat_end; ++iat)
+        {
+            int thread_id = 0;
+#ifdef _OPENMP
+            thread_id = omp_get_thread_num();
+#endif
+            double* force = force_thread.data() + static_cast<size_t>(thread_id) * nat * 3;
+            double fx = 0.0, fy = 0.0, fz = 0.0;
+
+            for (int ip = nl_start[iat]; ip < nl_start[iat + 1]; ++ip)
+            {
+                const int jat = nl_jat[ip];
+                const ModuleBase::Vector3<double> dtau = tau[iat] - tau[jat] - nl_shift[ip] * ucell.lat0;
+                const double r2 = dtau.norm2();
+                if (r2 > rcut2)
+                {
+                    continue;
+                }
+
+                const double sr2 = sigma2 / r2;
+                const double sr6 = sr2 * sr2 * sr2;
+                potential += 4.0 * lj_epsilon * (sr6 - 1.0) * sr6;
+
+                const double coff = 24.0 * lj_epsilon * (2.0 * sr6 - 1.0) * sr6 / r2;
+                const double f_x = dtau.x * coff;
+                const double f_y = dtau.y * coff;
+                const double f_z = dtau.z * coff;
+                fx += f_x;
+                fy += f_y;
+                fz += f_z;
+                force[3 * jat] -= f_x;
+                force[3 * jat + 1] -= f_y;
+                force[3 * jat + 2] -= f_z;
+
+                v00 += dtau.x * f_x;
+                v01 += dtau.x * f_y;
+                v02 += dtau.x * f_z;
+                v11 += dtau.y * f_y;
+                v12 += dtau.y * f_z;
+                v22 += dtau.z * f_z;
+            }
+
+            force[3 * iat] += fx;
+            force[3 * iat + 1] += fy;
+            force[3 * iat + 2] += fz;
+        }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int i = 0; i < nat * 3; ++i)
+        {
+            double sum = 0.0;
+            for (int id = 0; id < nthread; ++id)
             {
-                lj_virial(i, j) += dtau[i] * force[j];
+                sum += force_thread[static_cast<size_t>(id) * nat * 3 + i];
             }
+            lj_force.c[i] = sum;
         }
+
+        lj_potential = potential;
+        lj_virial(0, 0) = v00;
+        lj_virial(0, 1) = lj_virial(1, 0) = v01;
+        lj_virial(0, 2) = lj_virial(2, 0) = v02;
+        lj_virial(1, 1) = v11;
+        lj_virial(1, 2) = lj_virial(2, 1) = v12;
+        lj_virial(2, 2) = v22;
     }
 
 }
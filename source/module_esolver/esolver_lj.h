@@ -3,6 +3,8 @@
 
 #include "./esolver.h"
 
+#include <vector>
+
 namespace ModuleESolver
 {
 
@@ -25,8 +27,6 @@ namespace ModuleESolver
         double LJ_energy(const double d);
         ModuleBase::Vector3<double> LJ_force(const double d,
             const ModuleBase::Vector3<double> dr);
-        void LJ_virial(const ModuleBase::Vector3<double>& force,
-            const ModuleBase::Vector3<double>& dtau);
 
         //--------------temporary----------------------------
         double lj_rcut;
@@ -36,6 +36,37 @@ namespace ModuleESolver
         ModuleBase::matrix lj_force;
         ModuleBase::matrix lj_virial;
         //---------------------------------------------------
+
+        /// number of neighbor list rebuilds since Init
+        int get_nbuild() const { return nl_nbuild; }
+
+    private:
+        /// search neighbors within lj_rcut + lj_skin and store each pair once
+        void build_neighbor_list(UnitCell& ucell);
+
+        /// true if any atom moved more than lj_skin/2 or the cell changed since the last build
+        bool neighbor_list_expired(const UnitCell& ucell) const;
+
+        /// accumulate energy, force and virial of the pairs owned by this rank
+        void cal_pair_interaction(const UnitCell& ucell);
+
+        double lj_rlist = 0.0; ///< searching radius of the neighbor list (Bohr)
+        double lj_skin = 0.0;  ///< Verlet skin of the neighbor list (Bohr)
+        int nl_nbuild = 0;
+
+        // Half neighbor list in CSR layout: the partners of atom iat are
+        // nl_jat[nl_start[iat] ... nl_start[iat+1]), each with the lattice
+        // translation nl_shift (lat0 unit) applied to the partner.
+        // Only atoms in [iat_begin, iat_end) are owned by this rank.
+        int iat_begin = 0;
+        int iat_end = 0;
+        std::vector<int> nl_start;
+        std::vector<int> nl_jat;
+        std::vector<ModuleBase::Vector3<double>> nl_shift;
+
+        // atomic positions and lattice at the last build
+        std::vector<ModuleBase::Vector3<double>> nl_tau_ref;
+        ModuleBase::Vector3<double> nl_a1_ref, nl_a2_ref, nl_a3_ref;
     };
 }
 #endif
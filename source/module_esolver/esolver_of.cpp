@@ -192,6 +192,18 @@ void ESolver_OF::Init(Input &inp, UnitCell &ucell)
         this->opt_cg.setPara(this->dV);
         this->opt_dcsrch.set_paras(1e-4,1e-2);
     }
+    else if (this->of_method == "lbfgs")
+    {
+        delete[] this->opt_lbfgs;
+        this->opt_lbfgs = new ModuleBase::Opt_LBFGS[GlobalV::NSPIN];
+        for (int is = 0; is < GlobalV::NSPIN; ++is)
+        {
+            this->opt_lbfgs[is].allocate(this->nrxx);
+            this->opt_lbfgs[is].setPara(this->dV);
+        }
+        // the quasi-Newton step is usually acceptable, so the Wolfe condition on dE/dtheta is loose
+        this->opt_dcsrch.set_paras(1e-4,9e-1);
+    }
     else if (this->of_method == "bfgs")
     {
         ModuleBase::WARNING_QUIT("esolver_of", "BFGS is not supported now.");
@@ -326,6 +338,18 @@ void ESolver_OF::init_after_vc(Input &inp, UnitCell &ucell)
         this->opt_cg.setPara(this->dV);
         this->opt_dcsrch.set_paras(1e-4,1e-2);
     }
+    else if (this->of_method == "lbfgs")
+    {
+        delete[] this->opt_lbfgs;
+        this->opt_lbfgs = new ModuleBase::Opt_LBFGS[GlobalV::NSPIN];
+        for (int is = 0; is < GlobalV::NSPIN; ++is)
+        {
+            this->opt_lbfgs[is].allocate(this->nrxx);
+            this->opt_lbfgs[is].setPara(this->dV);
+        }
+        // the quasi-Newton step is usually acceptable, so the Wolfe condition on dE/dtheta is loose
+        this->opt_dcsrch.set_paras(1e-4,9e-1);
+    }
     else if (this->of_method == "bfgs")
     {
         ModuleBase::WARNING_QUIT("esolver_of", "BFGS is not supported now.");
@@ -468,7 +492,11 @@ void ESolver_OF::beforeOpt(const int istep)
         ModuleBase::GlobalFunc::ZEROS(this->pdLdphi[is], this->nrxx);
         ModuleBase::GlobalFunc::ZEROS(this->pdEdphi[is], this->nrxx);
         ModuleBase::GlobalFunc::ZEROS(this->pdirect[is], this->nrxx);
+        // the history of last ionic step belongs to another potential
+        if (this->of_method == "lbfgs") this->opt_lbfgs[is].refresh();
     }
+    this->nPotEval = 0;
+    this->nPotEvalTot = 0;
     if (GlobalV::NSPIN == 1)
     {
         this->theta[0] = 0.2;
@@ -483,6 +511,7 @@ void ESolver_OF::updateV()
     // (1) get dL/dphi
     if(GlobalV::NSPIN==4) GlobalC::ucell.cal_ux();
     this->pelec->pot->update_from_charge(pelec->charge, &GlobalC::ucell); // Hartree + XC + external
+    this->nPotEval++;
     this->kineticPotential(pelec->charge->rho, this->pphi, this->pelec->pot->get_effective_v()); // (kinetic + Hartree + XC + external) * 2 * phi
     for (int is = 0; is < GlobalV::NSPIN; ++is)
     {
@@ -535,13 +564,17 @@ void ESolver_OF::solveV()
         {
             opt_cg.next_direct(this->pdLdphi[is], 2, this->pdirect[is]);
         }
+        else if (this->of_method == "lbfgs")
+        {
+            opt_lbfgs[is].next_direct(this->pphi[is], this->pdLdphi[is], this->pdirect[is]);
+        }
         else if (this->of_method == "bfgs")
         {
             return;
         }
         else
         {
-            ModuleBase::WARNING_QUIT("ESolver_OF", "of_method must be one of CG, TN, or BFGS.");
+            ModuleBase::WARNING_QUIT("ESolver_OF", "of_method must be one of CG, TN, LBFGS, or BFGS.");
         }
     }
     // initialize tempPhi and tempRho used in line search
@@ -580,6 +613,8 @@ void ESolver_OF::solveV()
         else if (dEdtheta[is] > 0)
         {
             GlobalV::ofs_warning << "ESolver_OF: WARNING " << "dEdphi > 0, replace direct with steepest descent method." << std::endl;
+            // the curvature information is not reliable any more, restart L-BFGS
+            if (this->of_method == "lbfgs") this->opt_lbfgs[is].refresh();
             for (int ir = 0; ir < this->nrxx; ++ir)
             {
                 this->pdirect[is][ir] = - this->pdLdphi[is][ir];
@@ -835,7 +870,16 @@ void ESolver_OF::getNextDirect()
         }
 
         tempTheta = normDir/tempTheta;
-        this->theta[0] = std::min(this->theta[0], tempTheta);
+        if (this->of_method == "lbfgs" && this->opt_lbfgs[0].get_nhistory() > 0)
+        {
+            // cheap initial step: map the full quasi-Newton step |phi> + |d'> onto the sphere <phi|phi> = nelec,
+            // so that the line search usually accepts the first trial theta
+            this->theta[0] = atan(normDir / sqrt(this->nelec[0]));
+        }
+        else
+        {
+            this->theta[0] = std::min(this->theta[0], tempTheta);
+        }
     }
     else if (GlobalV::NSPIN == 2) // theta = 0
     {
@@ -979,7 +1023,7 @@ void ESolver_OF::printInfo()
 {
     if (this->iter == 0){
         std::cout << "======================== Running OFDFT ========================" <<  std::endl;
-        std::cout << "Iter        Etot(Ha)          Theta      PotNorm     deltaE(Ha)" << std::endl;
+        std::cout << "Iter        Etot(Ha)          Theta      PotNorm     deltaE(Ha)  NPot" << std::endl;
         // cout << "======================================== Running OFDFT ========================================" <<  endl;
         // cout << "Iter        Etot(Ha)          Theta       PotNorm        min/max(den)          min/max(dE/dPhi)" << endl;
         // cout << "============================================ OFDFT ========================================" <<  endl;
@@ -1001,7 +1045,10 @@ void ESolver_OF::printInfo()
     << std::setw(22) << std::setiosflags(std::ios::scientific) << std::setprecision(12) << this->energy_current/2.
     << std::setw(12) << std::setprecision(3) << this->theta[0]
     << std::setw(12) << this->normdLdphi
-    << std::setw(12) << (this->energy_current - this->energy_last)/2. << std::endl;
+    << std::setw(12) << (this->energy_current - this->energy_last)/2.
+    << std::setw(6) << this->nPotEval << std::endl;
+    this->nPotEvalTot += this->nPotEval;
+    this->nPotEval = 0;
     // ============ test new convergence criterion =================
     // << setw(12) << this->deltaRhoG
     // << setw(12) << this->deltaRhoR
@@ -1014,6 +1061,8 @@ void ESolver_OF::printInfo()
 
 void ESolver_OF::afterOpt(const int istep)
 {
+    GlobalV::ofs_running << " OFDFT: " << this->nPotEvalTot << " potential evaluations in " << this->iter
+                         << " iterations (" << this->of_method << ")" << std::endl;
     ModuleIO::output_convergence_after_scf(this->conv, this->pelec->f_en.etot);
 
     // save charge difference into files for charge extrapolation
@@ -1151,6 +1200,7 @@ void ESolver_OF::calV(double *ptempPhi, double *rdLdphi)
 
     if(GlobalV::NSPIN==4) GlobalC::ucell.cal_ux();
     this->pelec->pot->update_from_charge(this->ptempRho, &GlobalC::ucell);
+    this->nPotEval++;
     ModuleBase::matrix& vr_eff = this->pelec->pot->get_effective_v();
 
     this->kineticPotential(this->ptempRho->rho, tempPhi, vr_eff);
@@ -1182,6 +1232,7 @@ void ESolver_OF::caldEdtheta(double **ptempPhi, Charge* tempRho, double *ptheta,
 
     if(GlobalV::NSPIN==4) GlobalC::ucell.cal_ux();
     this->pelec->pot->update_from_charge(tempRho, &GlobalC::ucell);
+    this->nPotEval++;
     ModuleBase::matrix& vr_eff = this->pelec->pot->get_effective_v();
 
     this->kineticPotential(tempRho->rho, ptempPhi, vr_eff);
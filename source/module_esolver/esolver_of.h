@@ -3,6 +3,7 @@
 
 #include "esolver_fp.h"
 #include "module_base/opt_TN.hpp"
+#include "module_base/opt_LBFGS.h"
 #include "module_base/opt_DCsrch.h"
 #include "module_psi/psi.h"
 #include "module_elecstate/module_charge/charge_extra.h"    // liuyu add 2022-11-07
@@ -74,6 +75,7 @@ public:
         if (this->mu != NULL) delete[] this->mu;
         if (this->task != NULL) delete[] this->task;
         if (this->opt_cg_mag != NULL) delete this->opt_cg_mag;
+        if (this->opt_lbfgs != NULL) delete[] this->opt_lbfgs;
         delete this->ptempRho;
     }
 
@@ -105,10 +107,11 @@ private:
     ModuleBase::Opt_TN opt_tn;
     ModuleBase::Opt_DCsrch opt_dcsrch;
     ModuleBase::Opt_CG *opt_cg_mag = NULL; // for spin2 case, under testing
+    ModuleBase::Opt_LBFGS *opt_lbfgs = NULL; // one per spin channel, each keeps its own history
 
     // from Input
     std::string of_kinetic = "wt";   // Kinetic energy functional, such as TF, VW, WT
-    std::string of_method = "tn";    // optimization method, include cg1, cg2, tn (default), bfgs
+    std::string of_method = "tn";    // optimization method, include cg1, cg2, tn (default), lbfgs, bfgs
     std::string of_conv = "energy";  // select the convergence criterion, potential, energy (default), or both
     double of_tole = 2e-6;      // tolerance of the energy change (in Ry) for determining the convergence, default=2e-6 Ry
     double of_tolp = 1e-5;      // tolerance of potential for determining the convergence, default=1e-5 in a.u.
@@ -132,6 +135,8 @@ private:
     int tnSpinFlag = -1;                        // spin flag used in calV, which will be called by opt_tn
     int maxDCsrch = 200;                        // max no. of line search
     int flag = -1;                              // flag of TN
+    int nPotEval = 0;                           // number of potential evaluations since last printInfo
+    int nPotEvalTot = 0;                        // number of potential evaluations in this ionic step
 
     Charge* ptempRho = nullptr;                 // used in line search
 
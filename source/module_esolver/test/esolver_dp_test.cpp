@@ -12,6 +12,8 @@
  * - Tested Functions:
  *   - ESolver_DP::Init()
  *   - ESolver_DP::Run()
+ *   - ESolver_DP::Run_frames()
+ *   - ESolver_DP::cal_Frame()
  *   - ESolver_DP::cal_Energy()
  *   - ESolver_DP::cal_Force()
  *   - ESolver_DP::cal_Stress()
@@ -92,6 +94,60 @@ TEST_F(ESolverDPTest, RunWarningQuit)
     EXPECT_THAT(output, testing::HasSubstr("Please recompile with -D__DPMD"));
 }
 
+// Test the Run_frames() funciton WARNING_QUIT
+TEST_F(ESolverDPTest, RunFramesWarningQuit)
+{
+    const int nframes = 2;
+    std::vector<ModuleBase::Vector3<double>> tau(nframes * ucell.nat);
+    std::vector<ModuleBase::Matrix3> latvec(nframes);
+
+    testing::internal::CaptureStdout();
+    EXPECT_EXIT(esolver->Run_frames(nframes, tau.data(), latvec.data(), ucell), ::testing::ExitedWithCode(0), "");
+    std::string output = testing::internal::GetCapturedStdout();
+    EXPECT_THAT(output, testing::HasSubstr("Please recompile with -D__DPMD"));
+}
+
+// Test the cal_Frame() funciton
+TEST_F(ESolverDPTest, CalFrame)
+{
+    const int nframes = 2;
+    esolver->nframes = nframes;
+    esolver->frames_potential = {9.8, 19.6};
+    esolver->frames_force.resize(3 * ucell.nat * nframes);
+    esolver->frames_virial.resize(9 * nframes);
+    for (int i = 0; i < 3 * ucell.nat * nframes; ++i)
+    {
+        esolver->frames_force[i] = i;
+    }
+    for (int i = 0; i < 9 * nframes; ++i)
+    {
+        esolver->frames_virial[i] = -i;
+    }
+
+    double etot = 0.0;
+    ModuleBase::matrix force(ucell.nat, 3);
+    ModuleBase::matrix stress(3, 3);
+    esolver->cal_Frame(1, etot, force, stress);
+
+    // Check the results
+    EXPECT_EQ(esolver->get_nframes(), nframes);
+    EXPECT_DOUBLE_EQ(etot, 19.6);
+    for (int i = 0; i < ucell.nat; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            EXPECT_DOUBLE_EQ(force(i, j), 3.0 * ucell.nat + 3.0 * i + j);
+        }
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            EXPECT_DOUBLE_EQ(stress(i, j), -9.0 - 3.0 * i - j);
+        }
+    }
+}
+
 // Test the cal_Energy() funciton
 TEST_F(ESolverDPTest, CalEnergy)
 {
@@ -8,6 +8,7 @@
 
 double H_Ewald_pw::alpha=0.0;
 int H_Ewald_pw::mxr = 200;
+Ewald_SPME H_Ewald_pw::spme;
 H_Ewald_pw::H_Ewald_pw(){};
 H_Ewald_pw::~H_Ewald_pw(){};
 
@@ -18,6 +19,14 @@ double H_Ewald_pw::compute_ewald(const UnitCell& cell,
     ModuleBase::TITLE("H_Ewald_pw","compute_ewald");
     ModuleBase::timer::tick("H_Ewald_pw","compute_ewald");
 
+    if (GlobalV::EWALD_SPME)
+    {
+        spme.set_parameters(GlobalV::EWALD_SPME_TOL);
+        const double ewalds = spme.compute(cell, nullptr, nullptr);
+        ModuleBase::timer::tick("H_Ewald_pw","compute_ewald");
+        return ewalds;
+    }
+
 //----------------------------------------------------------
 // Calculates Ewald energy with both G- and R-space terms.
 // Determines optimal alpha. Should hopefully work for any structure.
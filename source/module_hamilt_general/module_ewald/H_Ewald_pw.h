@@ -7,6 +7,7 @@
 #include "module_basis/module_pw/pw_basis.h"
 #include "module_hamilt_pw/hamilt_pwdft/forces.h"
 #include "module_hamilt_pw/hamilt_pwdft/stress_func.h"
+#include "ewald_spme.h"
 
 class H_Ewald_pw 
 {
@@ -35,6 +36,9 @@ class H_Ewald_pw
 	static double alpha;
     static int mxr;
 
+    // the smooth particle-mesh Ewald method, used instead of the sums above if GlobalV::EWALD_SPME
+    static Ewald_SPME spme;
+
 };
 
 #endif //ewald energy
@@ -0,0 +1,499 @@
+#include "ewald_spme.h"
+
+#include "module_base/constants.h"
+#include "module_base/global_function.h"
+#include "module_base/global_variable.h"
+#include "module_base/parallel_global.h"
+#include "module_base/parallel_reduce.h"
+#include "module_base/timer.h"
+
+#include <cmath>
+
+namespace
+{
+// number of atoms within rcut of an atom, on average
+const double neighbor_target = 100.0;
+// the mesh samples the plane waves up to oversampling * Gcut
+const double oversampling = 1.5;
+} // namespace
+
+void Ewald_SPME::set_parameters(const double& tol_in, const int& order_in)
+{
+    if (tol_in <= 0.0 || tol_in >= 1.0)
+    {
+        ModuleBase::WARNING_QUIT("Ewald_SPME", "tol should be in (0, 1)");
+    }
+    if (order_in < 4 || order_in % 2 != 0)
+    {
+        ModuleBase::WARNING_QUIT("Ewald_SPME", "the order of the B-splines should be even and at least 4");
+    }
+    if (tol_in != this->tol || order_in != this->order)
+    {
+        this->tol = tol_in;
+        this->order = order_in;
+        // set up again at the next call
+        this->nat = 0;
+    }
+}
+
+void Ewald_SPME::setup(const double& lat0_in, const ModuleBase::Matrix3& latvec_in, const int& nat_in)
+{
+    if (this->pw != nullptr && nat_in == this->nat && lat0_in == this->lat0 && latvec_in == this->latvec)
+    {
+        return;
+    }
+    ModuleBase::TITLE("Ewald_SPME", "setup");
+    this->nat = nat_in;
+    this->lat0 = lat0_in;
+    this->latvec = latvec_in;
+    const ModuleBase::Matrix3 g = latvec_in.Inverse().Transpose();
+    this->b[0] = ModuleBase::Vector3<double>(g.e11, g.e12, g.e13);
+    this->b[1] = ModuleBase::Vector3<double>(g.e21, g.e22, g.e23);
+    this->b[2] = ModuleBase::Vector3<double>(g.e31, g.e32, g.e33);
+    this->omega = std::abs(latvec_in.Det()) * std::pow(lat0_in, 3);
+
+    // erfc(sqrt(alpha) * rcut) = tol and exp(-Gcut^2 / 4 alpha) = tol
+    const double x = std::sqrt(-std::log(this->tol));
+    this->rcut = std::cbrt(3.0 * neighbor_target * this->omega / (ModuleBase::FOUR_PI * nat_in));
+    double sqa = x / this->rcut;
+    while (std::erfc(sqa * this->rcut) > this->tol)
+    {
+        sqa *= 1.01;
+    }
+    this->alpha = sqa * sqa;
+    const double gcut = 2.0 * sqa * x;
+
+    this->pw.reset(new ModulePW::PW_Basis());
+#ifdef __MPI
+    this->pw->initmpi(GlobalV::NPROC_IN_POOL, GlobalV::RANK_IN_POOL, POOL_WORLD);
+#endif
+    // ecut in Ry is G^2 in Bohr^-2, the lattice is passed as a temporary, the implicit copy of Matrix3 is deprecated
+    this->pw->initgrids(lat0_in,
+                        ModuleBase::Matrix3(latvec_in.e11, latvec_in.e12, latvec_in.e13,
+                                            latvec_in.e21, latvec_in.e22, latvec_in.e23,
+                                            latvec_in.e31, latvec_in.e32, latvec_in.e33),
+                        std::pow(oversampling * gcut, 2));
+    this->pw->initparameters(false, gcut * gcut);
+    this->pw->setuptransform();
+    this->pw->collect_local_pw();
+
+    // squared moduli of the Euler exponential splines, |b(m)|^2 = 1 / |sum_k M_n(k+1) exp(2 pi i m k / n)|^2
+    const int nmesh[3] = {this->pw->nx, this->pw->ny, this->pw->nz};
+    std::vector<double> theta(this->order), dtheta(this->order);
+    bspline(0.0, this->order, theta.data(), dtheta.data());
+    std::vector<double> bmod[3];
+    for (int d = 0; d < 3; ++d)
+    {
+        bmod[d].resize(nmesh[d]);
+        for (int m = 0; m < nmesh[d]; ++m)
+        {
+            std::complex<double> sum = 0.0;
+            for (int k = 0; k < this->order - 1; ++k)
+            {
+                sum += theta[k + 1] * std::exp(std::complex<double>(0.0, ModuleBase::TWO_PI * m * k / nmesh[d]));
+            }
+            bmod[d][m] = 1.0 / std::norm(sum);
+        }
+    }
+
+    const double nxyz = static_cast<double>(this->pw->nxyz);
+    const double fact = ModuleBase::e2 * ModuleBase::TWO_PI / this->omega * nxyz * nxyz;
+    this->kernel.assign(this->pw->npw, 0.0);
+    for (int ig = 0; ig < this->pw->npw; ++ig)
+    {
+        if (ig == this->pw->ig_gge0)
+        {
+            continue;
+        }
+        const double g2 = this->pw->gg[ig] * this->pw->tpiba2;
+        double b = 1.0;
+        for (int d = 0; d < 3; ++d)
+        {
+            const int m = static_cast<int>(std::round(this->pw->gdirect[ig][d]));
+            b *= bmod[d][(m + nmesh[d]) % nmesh[d]];
+        }
+        this->kernel[ig] = fact * std::exp(-g2 / 4.0 / this->alpha) / g2 * b;
+    }
+
+    if (GlobalV::test_energy)
+    {
+        ModuleBase::GlobalFunc::OUT(GlobalV::ofs_running, "SPME alpha", this->alpha);
+        ModuleBase::GlobalFunc::OUT(GlobalV::ofs_running, "SPME rcut (Bohr)", this->rcut);
+        ModuleBase::GlobalFunc::OUT(GlobalV::ofs_running, "SPME mesh", nmesh[0], nmesh[1], nmesh[2]);
+    }
+}
+
+double Ewald_SPME::compute(const UnitCell& cell, ModuleBase::matrix* force, ModuleBase::matrix* sigma)
+{
+    std::vector<ModuleBase::Vector3<double>> tau(cell.nat);
+    std::vector<double> zv(cell.nat);
+    int iat = 0;
+    for (int it = 0; it < cell.ntype; ++it)
+    {
+        for (int ia = 0; ia < cell.atoms[it].na; ++ia)
+        {
+            tau[iat] = cell.atoms[it].tau[ia];
+            zv[iat] = cell.atoms[it].ncpp.zv;
+            ++iat;
+        }
+    }
+    return this->compute(cell.lat0, cell.latvec, tau, zv, force, sigma);
+}
+
+double Ewald_SPME::compute(const double& lat0_in,
+                           const ModuleBase::Matrix3& latvec_in,
+                           const std::vector<ModuleBase::Vector3<double>>& tau,
+                           const std::vector<double>& zv,
+                           ModuleBase::matrix* force,
+                           ModuleBase::matrix* sigma)
+{
+    ModuleBase::TITLE("Ewald_SPME", "compute");
+    ModuleBase::timer::tick("Ewald_SPME", "compute");
+
+    const int nat_in = tau.size();
+    this->setup(lat0_in, latvec_in, nat_in);
+    if (force != nullptr)
+    {
+        force->create(nat_in, 3);
+    }
+    if (sigma != nullptr)
+    {
+        sigma->create(3, 3);
+    }
+
+    double energy = this->real_space(tau, zv, force, sigma) + this->recip_space(tau, zv, force, sigma);
+
+    // self energy and the neutralizing background, added once
+    double charge = 0.0;
+    double charge2 = 0.0;
+    for (int iat = 0; iat < nat_in; ++iat)
+    {
+        charge += zv[iat];
+        charge2 += zv[iat] * zv[iat];
+    }
+    const double ebg = -0.5 * ModuleBase::e2 * ModuleBase::PI * charge * charge / this->omega / this->alpha;
+    energy += -ModuleBase::e2 * std::sqrt(this->alpha / ModuleBase::PI) * charge2 + ebg;
+    if (sigma != nullptr)
+    {
+        for (int l = 0; l < 3; ++l)
+        {
+            (*sigma)(l, l) += ebg / this->omega;
+        }
+    }
+
+    ModuleBase::timer::tick("Ewald_SPME", "compute");
+    return energy;
+}
+
+double Ewald_SPME::real_space(const std::vector<ModuleBase::Vector3<double>>& tau,
+                              const std::vector<double>& zv,
+                              ModuleBase::matrix* force,
+                              ModuleBase::matrix* sigma) const
+{
+    ModuleBase::timer::tick("Ewald_SPME", "real_space");
+    const int nat_in = tau.size();
+
+    // cell list in fractional coordinates, the cells are at least rcut wide if the box allows
+    int ncell[3], nsearch[3];
+    for (int d = 0; d < 3; ++d)
+    {
+        const double width = this->lat0 / this->b[d].norm();
+        ncell[d] = std::max(1, static_cast<int>(width / this->rcut));
+        nsearch[d] = static_cast<int>(std::ceil(this->rcut * ncell[d] / width));
+    }
+    std::vector<ModuleBase::Vector3<double>> frac(nat_in);
+    std::vector<int> icell(nat_in);
+    std::vector<std::vector<int>> atoms_in_cell(ncell[0] * ncell[1] * ncell[2]);
+    for (int iat = 0; iat < nat_in; ++iat)
+    {
+        int c[3];
+        for (int d = 0; d < 3; ++d)
+        {
+            frac[iat][d] = tau[iat] * this->b[d];
+            frac[iat][d] -= std::floor(frac[iat][d]);
+            c[d] = std::min(static_cast<int>(frac[iat][d] * ncell[d]), ncell[d] - 1);
+        }
+        icell[iat] = (c[0] * ncell[1] + c[1]) * ncell[2] + c[2];
+        atoms_in_cell[icell[iat]].push_back(iat);
+    }
+
+    const double rcut2 = this->rcut * this->rcut;
+    const double sqa = std::sqrt(this->alpha);
+    const double sq4a_pi = 2.0 * std::sqrt(this->alpha / ModuleBase::PI);
+    double energy = 0.0;
+    std::vector<double> gs(3 * nat_in + 9, 0.0);
+
+#pragma omp parallel reduction(+ : energy)
+    {
+        std::vector<double> gs_thread(3 * nat_in + 9, 0.0);
+#pragma omp for schedule(dynamic)
+        for (int iat = GlobalV::RANK_IN_POOL; iat < nat_in; iat += GlobalV::NPROC_IN_POOL)
+        {
+            const int ic[3] = {icell[iat] / (ncell[1] * ncell[2]), icell[iat] / ncell[2] % ncell[1], icell[iat] % ncell[2]};
+            for (int ox = -nsearch[0]; ox <= nsearch[0]; ++ox)
+            {
+                for (int oy = -nsearch[1]; oy <= nsearch[1]; ++oy)
+                {
+                    for (int oz = -nsearch[2]; oz <= nsearch[2]; ++oz)
+                    {
+                        // the neighbouring cell and the lattice translation of its periodic image
+                        const int c[3] = {ic[0] + ox, ic[1] + oy, ic[2] + oz};
+                        int cw[3];
+                        ModuleBase::Vector3<double> shift;
+                        for (int d = 0; d < 3; ++d)
+                        {
+                            const int s = static_cast<int>(std::floor(static_cast<double>(c[d]) / ncell[d]));
+                            cw[d] = c[d] - s * ncell[d];
+                            shift[d] = s;
+                        }
+                        const bool home = (shift.norm2() == 0.0);
+                        for (const int jat: atoms_in_cell[(cw[0] * ncell[1] + cw[1]) * ncell[2] + cw[2]])
+                        {
+                            if (home && jat == iat)
+                            {
+                                continue;
+                            }
+                            const ModuleBase::Vector3<double> rij
+                                = (frac[jat] + shift - frac[iat]) * this->latvec * this->lat0;
+                            const double r2 = rij.norm2();
+                            if (r2 > rcut2)
+                            {
+                                continue;
+                            }
+                            const double r = std::sqrt(r2);
+                            const double zz = ModuleBase::e2 * zv[iat] * zv[jat];
+                            const double erfc_r = std::erfc(sqa * r) / r;
+                            energy += 0.5 * zz * erfc_r;
+                            // -dE/dr / r
+                            const double fr = zz * (erfc_r + sq4a_pi * std::exp(-this->alpha * r2)) / r2;
+                            for (int l = 0; l < 3; ++l)
+                            {
+                                gs_thread[3 * iat + l] -= fr * rij[l];
+                                for (int m = 0; m < 3; ++m)
+                                {
+                                    gs_thread[3 * nat_in + 3 * l + m] += 0.5 * fr * rij[l] * rij[m];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+#pragma omp critical(ewald_spme_real)
+        for (size_t i = 0; i < gs.size(); ++i)
+        {
+            gs[i] += gs_thread[i];
+        }
+    }
+
+    Parallel_Reduce::reduce_double_pool(energy);
+    if (force != nullptr || sigma != nullptr)
+    {
+        Parallel_Reduce::reduce_double_pool(gs.data(), gs.size());
+    }
+    if (force != nullptr)
+    {
+        for (int iat = 0; iat < nat_in; ++iat)
+        {
+            for (int l = 0; l < 3; ++l)
+            {
+                (*force)(iat, l) += gs[3 * iat + l];
+            }
+        }
+    }
+    if (sigma != nullptr)
+    {
+        for (int l = 0; l < 3; ++l)
+        {
+            for (int m = 0; m < 3; ++m)
+            {
+                (*sigma)(l, m) += gs[3 * nat_in + 3 * l + m] / this->omega;
+            }
+        }
+    }
+    ModuleBase::timer::tick("Ewald_SPME", "real_space");
+    return energy;
+}
+
+double Ewald_SPME::recip_space(const std::vector<ModuleBase::Vector3<double>>& tau,
+                               const std::vector<double>& zv,
+                               ModuleBase::matrix* force,
+                               ModuleBase::matrix* sigma) const
+{
+    ModuleBase::timer::tick("Ewald_SPME", "recip_space");
+    const int nat_in = tau.size();
+    const int p = this->order;
+    const int nmesh[3] = {this->pw->nx, this->pw->ny, this->pw->nz};
+    const int nplane = this->pw->nplane;
+    const int startz = this->pw->startz_current;
+
+    // B-spline weights of the atoms, the mesh point of theta[j] is k0 - j
+    std::vector<double> theta(3 * nat_in * p), dtheta(3 * nat_in * p);
+    std::vector<int> k0(3 * nat_in);
+    for (int iat = 0; iat < nat_in; ++iat)
+    {
+        for (int d = 0; d < 3; ++d)
+        {
+            const double frac = tau[iat] * this->b[d];
+            const double u = (frac - std::floor(frac)) * nmesh[d];
+            const int k = std::min(static_cast<int>(u), nmesh[d] - 1);
+            k0[3 * iat + d] = k;
+            bspline(u - k, p, &theta[(3 * iat + d) * p], &dtheta[(3 * iat + d) * p]);
+        }
+    }
+    auto local_z = [&](const int& iat, const int& j) {
+        const int iz = ((k0[3 * iat + 2] - j) % nmesh[2] + nmesh[2]) % nmesh[2];
+        return iz - startz;
+    };
+
+    // spread the charges onto the z planes of this process
+    std::vector<double> qmesh(this->pw->nrxx, 0.0);
+    for (int iat = 0; iat < nat_in; ++iat)
+    {
+        for (int jz = 0; jz < p; ++jz)
+        {
+            const int iz = local_z(iat, jz);
+            if (iz < 0 || iz >= nplane)
+            {
+                continue;
+            }
+            const double qz = zv[iat] * theta[(3 * iat + 2) * p + jz];
+            for (int jx = 0; jx < p; ++jx)
+            {
+                const int ix = ((k0[3 * iat] - jx) % nmesh[0] + nmesh[0]) % nmesh[0];
+                const double qxz = qz * theta[3 * iat * p + jx];
+                for (int jy = 0; jy < p; ++jy)
+                {
+                    const int iy = ((k0[3 * iat + 1] - jy) % nmesh[1] + nmesh[1]) % nmesh[1];
+                    qmesh[(ix * nmesh[1] + iy) * nplane + iz] += qxz * theta[(3 * iat + 1) * p + jy];
+                }
+            }
+        }
+    }
+
+    std::vector<std::complex<double>> qg(this->pw->npw);
+    this->pw->real2recip(qmesh.data(), qg.data());
+
+    double energy = 0.0;
+    ModuleBase::matrix sigma_g(3, 3);
+    for (int ig = 0; ig < this->pw->npw; ++ig)
+    {
+        const double e = this->kernel[ig] * std::norm(qg[ig]);
+        energy += e;
+        if (sigma != nullptr && ig != this->pw->ig_gge0)
+        {
+            const double g2 = this->pw->gg[ig] * this->pw->tpiba2;
+            const ModuleBase::Vector3<double> g = this->pw->gcar[ig] * this->pw->tpiba;
+            const double fact = 2.0 * (g2 / 4.0 / this->alpha + 1.0) / g2;
+            for (int l = 0; l < 3; ++l)
+            {
+                sigma_g(l, l) += e;
+                for (int m = 0; m < 3; ++m)
+                {
+                    sigma_g(l, m) -= e * fact * g[l] * g[m];
+                }
+            }
+        }
+        // dE/dQ(k) = 2 sum_G C(G) Q(G) exp(iGk), with Q(G) = nxyz qg(G)
+        qg[ig] *= 2.0 * this->kernel[ig] / static_cast<double>(this->pw->nxyz);
+    }
+    Parallel_Reduce::reduce_double_pool(energy);
+    if (sigma != nullptr)
+    {
+        Parallel_Reduce::reduce_double_pool(sigma_g.c, 9);
+        for (int l = 0; l < 3; ++l)
+        {
+            for (int m = 0; m < 3; ++m)
+            {
+                (*sigma)(l, m) += sigma_g(l, m) / this->omega;
+            }
+        }
+    }
+
+    if (force != nullptr)
+    {
+        // the potential on the mesh, qmesh is reused
+        this->pw->recip2real(qg.data(), qmesh.data());
+        // dE/dr = sum_d dE/du_d n_d b_d / lat0
+        ModuleBase::matrix dedu(nat_in, 3);
+#pragma omp parallel for schedule(static)
+        for (int iat = 0; iat < nat_in; ++iat)
+        {
+            const double* tx = &theta[3 * iat * p];
+            const double* ty = &theta[(3 * iat + 1) * p];
+            const double* tz = &theta[(3 * iat + 2) * p];
+            const double* dtx = &dtheta[3 * iat * p];
+            const double* dty = &dtheta[(3 * iat + 1) * p];
+            const double* dtz = &dtheta[(3 * iat + 2) * p];
+            double d[3] = {0.0, 0.0, 0.0};
+            for (int jz = 0; jz < p; ++jz)
+            {
+                const int iz = local_z(iat, jz);
+                if (iz < 0 || iz >= nplane)
+                {
+                    continue;
+                }
+                for (int jx = 0; jx < p; ++jx)
+                {
+                    const int ix = ((k0[3 * iat] - jx) % nmesh[0] + nmesh[0]) % nmesh[0];
+                    for (int jy = 0; jy < p; ++jy)
+                    {
+                        const int iy = ((k0[3 * iat + 1] - jy) % nmesh[1] + nmesh[1]) % nmesh[1];
+                        const double phi = qmesh[(ix * nmesh[1] + iy) * nplane + iz];
+                        d[0] += phi * dtx[jx] * ty[jy] * tz[jz];
+                        d[1] += phi * tx[jx] * dty[jy] * tz[jz];
+                        d[2] += phi * tx[jx] * ty[jy] * dtz[jz];
+                    }
+                }
+            }
+            for (int l = 0; l < 3; ++l)
+            {
+                dedu(iat, l) = zv[iat] * d[l] * nmesh[l];
+            }
+        }
+        Parallel_Reduce::reduce_double_pool(dedu.c, dedu.nr * dedu.nc);
+        for (int iat = 0; iat < nat_in; ++iat)
+        {
+            for (int l = 0; l < 3; ++l)
+            {
+                for (int a = 0; a < 3; ++a)
+                {
+                    (*force)(iat, a) -= dedu(iat, l) * this->b[l][a] / this->lat0;
+                }
+            }
+        }
+    }
+
+    ModuleBase::timer::tick("Ewald_SPME", "recip_space");
+    return energy;
+}
+
+void Ewald_SPME::bspline(const double& w, const int& n, double* theta, double* dtheta)
+{
+    // M_2(w) = w, M_2(w + 1) = 1 - w
+    for (int j = 0; j < n; ++j)
+    {
+        theta[j] = 0.0;
+    }
+    theta[0] = w;
+    theta[1] = 1.0 - w;
+    // M_k(x) = (x M_{k-1}(x) + (k - x) M_{k-1}(x - 1)) / (k - 1), going down in j to use theta[j-1] of order k-1
+    for (int k = 3; k <= n; ++k)
+    {
+        if (k == n)
+        {
+            // M_n'(x) = M_{n-1}(x) - M_{n-1}(x - 1)
+            dtheta[0] = theta[0];
+            for (int j = 1; j < n; ++j)
+            {
+                dtheta[j] = theta[j] - theta[j - 1];
+            }
+        }
+        for (int j = k - 1; j >= 0; --j)
+        {
+            const double x = w + j;
+            const double prev = (j > 0) ? theta[j - 1] : 0.0;
+            theta[j] = (x * theta[j] + (k - x) * prev) / (k - 1);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef EWALD_SPME_H
+#define EWALD_SPME_H
+
+#include "module_base/matrix.h"
+#include "module_base/matrix3.h"
+#include "module_base/vector3.h"
+#include "module_basis/module_pw/pw_basis.h"
+#include "module_cell/unitcell.h"
+
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Ewald energy, forces and stress of the ions with the smooth particle-mesh Ewald (SPME) method.
+ *
+ * The real space sum runs over a cell list of the atoms within rcut, the reciprocal space sum
+ * spreads the charges onto a coarse mesh with cardinal B-splines and uses the FFT of a PW_Basis,
+ * so that the cost grows as N log N instead of N^2 times the number of lattice images.
+ * See U. Essmann et al., J. Chem. Phys. 103, 8577 (1995).
+ *
+ * The Ewald parameter alpha, rcut and the mesh are chosen from tol: erfc(sqrt(alpha) * rcut) = tol,
+ * exp(-Gcut^2 / 4 alpha) = tol, and the mesh samples Gcut finely enough for the B-spline interpolation.
+ * Energies are in Ry, forces in Ry/Bohr and the stress in Ry/Bohr^3, with the same conventions as
+ * H_Ewald_pw::compute_ewald, Forces::cal_force_ew and Stress_Func::stress_ewa.
+ */
+class Ewald_SPME
+{
+  public:
+    Ewald_SPME(){};
+    ~Ewald_SPME(){};
+
+    /**
+     * @brief set the accuracy target and the order of the B-splines
+     *
+     * @param tol_in relative accuracy of the real and reciprocal space sums
+     * @param order_in order of the B-splines, must be even
+     */
+    void set_parameters(const double& tol_in, const int& order_in = 8);
+
+    /**
+     * @brief compute the Ewald energy, and the forces and the stress if the pointers are not null
+     *
+     * @param lat0 lattice constant in Bohr
+     * @param latvec lattice vectors in lat0
+     * @param tau Cartesian positions of the atoms in lat0
+     * @param zv ionic charges of the atoms
+     * @param force [out] nat x 3 forces, overwritten
+     * @param sigma [out] 3 x 3 stress, overwritten
+     * @return double the Ewald energy
+     */
+    double compute(const double& lat0,
+                   const ModuleBase::Matrix3& latvec,
+                   const std::vector<ModuleBase::Vector3<double>>& tau,
+                   const std::vector<double>& zv,
+                   ModuleBase::matrix* force,
+                   ModuleBase::matrix* sigma);
+
+    /// the same for the atoms of cell, the forces are ordered by iat
+    double compute(const UnitCell& cell, ModuleBase::matrix* force, ModuleBase::matrix* sigma);
+
+    double get_alpha() const { return this->alpha; }
+    double get_rcut() const { return this->rcut; }
+
+  private:
+    /// choose alpha, rcut and the mesh, and set up the FFT if the cell has changed
+    void setup(const double& lat0, const ModuleBase::Matrix3& latvec, const int& nat);
+
+    /// real space sum over the pairs within rcut
+    double real_space(const std::vector<ModuleBase::Vector3<double>>& tau,
+                      const std::vector<double>& zv,
+                      ModuleBase::matrix* force,
+                      ModuleBase::matrix* sigma) const;
+
+    /// reciprocal space sum with the charges spread onto the mesh
+    double recip_space(const std::vector<ModuleBase::Vector3<double>>& tau,
+                       const std::vector<double>& zv,
+                       ModuleBase::matrix* force,
+                       ModuleBase::matrix* sigma) const;
+
+    /// theta[j] = M_n(w + j) and dtheta[j] = M_n'(w + j), j = 0, ..., n-1, for w in [0, 1)
+    static void bspline(const double& w, const int& n, double* theta, double* dtheta);
+
+    double tol = 1.0e-8;
+    int order = 8;
+
+    double alpha = 0.0;
+    double rcut = 0.0;
+    double lat0 = 0.0;
+    double omega = 0.0;
+    ModuleBase::Matrix3 latvec;
+    /// reciprocal lattice vectors in 1/lat0, without 2pi
+    ModuleBase::Vector3<double> b[3];
+    int nat = 0;
+
+    std::unique_ptr<ModulePW::PW_Basis> pw;
+    /// C(G) = e2/2 4pi/omega exp(-G^2/4alpha)/G^2 |b(G)|^2 nxyz^2 on the plane waves of pw, 0 for G = 0
+    std::vector<double> kernel;
+};
+
+#endif
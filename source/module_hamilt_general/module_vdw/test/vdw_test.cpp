@@ -207,16 +207,21 @@ TEST_F(vdwd2Test, OneAtomWarning)
     stru_ structure1{std::vector<double>{0.5, 0.5, 0.0, 0.5, 0.0, 0.5, 0.0, 0.5, 0.5},
                      std::vector<atomtype_>{atomtype_{"Si", std::vector<std::vector<double>>{{0., 0., 0.}}}}};
     construct_ucell(structure1,ucell1);
-    GlobalV::ofs_warning.open("warning.log");
+    // one file for each process in the parallel test, only the first process writes the warning
+    const std::string warning_file = "warning" + std::to_string(GlobalV::MY_RANK) + ".log";
+    GlobalV::ofs_warning.open(warning_file);
     std::ifstream ifs;
     std::string output;
  
     std::unique_ptr<vdw::Vdw> vdw_test = vdw::make_vdw(ucell1, input);
 
     GlobalV::ofs_warning.close();
-	ifs.open("warning.log");
+	ifs.open(warning_file);
 	getline(ifs,output);
-	EXPECT_THAT(output,testing::HasSubstr("warning"));
+    if (GlobalV::MY_RANK == 0)
+    {
+        EXPECT_THAT(output,testing::HasSubstr("warning"));
+    }
     EXPECT_EQ(vdw_test,nullptr);
 
     ifs.close();
@@ -603,6 +608,8 @@ TEST_F(vdwd3abcTest, D3bjGetStress)
 int main(int argc, char **argv)
 {
     MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &GlobalV::NPROC);
+    MPI_Comm_rank(MPI_COMM_WORLD, &GlobalV::MY_RANK);
     testing::InitGoogleTest(&argc, argv);
     int result = RUN_ALL_TESTS();
     MPI_Finalize();
@@ -9,8 +9,12 @@
 #include "module_base/constants.h"
 #include "module_base/element_name.h"
 #include "module_base/global_function.h"
+#include "module_base/global_variable.h"
+#include "module_base/parallel_reduce.h"
 #include "module_base/timer.h"
 
+#include <algorithm>
+
 namespace vdw
 {
 
@@ -22,6 +26,8 @@ void Vdwd3::init()
     lat_[2] = ucell_.a3 * ucell_.lat0;
 
     std::vector<double> at_kind = atom_kind();
+    iz_.clear();
+    xyz_.clear();
     iz_.reserve(ucell_.nat);
     xyz_.reserve(ucell_.nat);
     for (size_t it = 0; it != ucell_.ntype; it++)
@@ -46,6 +52,129 @@ void Vdwd3::init()
     set_criteria(para_.cn_thr2(), lat_, tau_max);
     for (size_t i = 0; i < 3; i++)
         rep_cn_[i] = ceil(tau_max[i]);
+
+    set_neighbors();
+}
+
+void Vdwd3::set_neighbors()
+{
+    ModuleBase::timer::tick("Vdwd3", "set_neighbors");
+    const int nat = ucell_.nat;
+    const double rthr2 = std::max(para_.rthr2(), para_.cn_thr2());
+
+    // lattice translations, computed in the same way as in the loops over taux, tauy and tauz before
+    rep_tau_.resize(3);
+    for (int i = 0; i < 3; i++)
+        rep_tau_[i] = std::max(rep_vdw_[i], rep_cn_[i]);
+    tau_.clear();
+    tau_index_.clear();
+    for (int taux = -rep_tau_[0]; taux <= rep_tau_[0]; taux++)
+        for (int tauy = -rep_tau_[1]; tauy <= rep_tau_[1]; tauy++)
+            for (int tauz = -rep_tau_[2]; tauz <= rep_tau_[2]; tauz++)
+            {
+                tau_index_.emplace_back(taux, tauy, tauz);
+                tau_.emplace_back(static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
+                                  + static_cast<double>(tauz) * lat_[2]);
+            }
+    const int ntau = tau_.size();
+    const int tau0 = ntau / 2;
+
+    // cell list of all the images xyz_[jat] + tau_[itau], the cells are half of the cutoff wide,
+    // so the neighbors of an atom are in the 5x5x5 cells around it
+    const double edge = 0.5 * std::sqrt(rthr2) + 1e-6;
+    ModuleBase::Vector3<double> pmin = xyz_[0], pmax = xyz_[0];
+    for (int jat = 0; jat < nat; jat++)
+        for (int itau = 0; itau < ntau; itau++)
+        {
+            const ModuleBase::Vector3<double> p = xyz_[jat] + tau_[itau];
+            for (int i = 0; i < 3; i++)
+            {
+                pmin[i] = std::min(pmin[i], p[i]);
+                pmax[i] = std::max(pmax[i], p[i]);
+            }
+        }
+    int ncell[3];
+    for (int i = 0; i < 3; i++)
+        ncell[i] = static_cast<int>((pmax[i] - pmin[i]) / edge) + 1;
+    auto cell_of = [&](const ModuleBase::Vector3<double>& p, int* c) {
+        for (int i = 0; i < 3; i++)
+            c[i] = std::min(std::max(static_cast<int>((p[i] - pmin[i]) / edge), 0), ncell[i] - 1);
+    };
+    std::vector<int> head(ncell[0] * ncell[1] * ncell[2], -1), next(nat * ntau, -1);
+    for (int im = nat * ntau - 1; im >= 0; im--)
+    {
+        int c[3];
+        cell_of(xyz_[im / ntau] + tau_[im % ntau], c);
+        const int ic = (c[0] * ncell[1] + c[1]) * ncell[2] + c[2];
+        next[im] = head[ic];
+        head[ic] = im;
+    }
+
+    std::vector<std::vector<Neighbor>> neighbors(nat);
+#pragma omp parallel for schedule(dynamic)
+    for (int iat = 0; iat < nat; iat++)
+    {
+        int c[3];
+        cell_of(xyz_[iat], c);
+        for (int cx = std::max(c[0] - 2, 0); cx <= std::min(c[0] + 2, ncell[0] - 1); cx++)
+            for (int cy = std::max(c[1] - 2, 0); cy <= std::min(c[1] + 2, ncell[1] - 1); cy++)
+                for (int cz = std::max(c[2] - 2, 0); cz <= std::min(c[2] + 2, ncell[2] - 1); cz++)
+                    for (int im = head[(cx * ncell[1] + cy) * ncell[2] + cz]; im != -1; im = next[im])
+                    {
+                        const int jat = im / ntau;
+                        const int itau = im % ntau;
+                        if (jat > iat || (jat == iat && itau == tau0))
+                            continue;
+                        if ((xyz_[jat] - xyz_[iat] + tau_[itau]).norm2() <= rthr2)
+                            neighbors[iat].push_back({jat, itau});
+                    }
+        std::sort(neighbors[iat].begin(), neighbors[iat].end(), [](const Neighbor& a, const Neighbor& b) {
+            return a.atom < b.atom || (a.atom == b.atom && a.itau < b.itau);
+        });
+    }
+
+    neighbor_start_.assign(nat + 1, 0);
+    for (int iat = 0; iat < nat; iat++)
+        neighbor_start_[iat + 1] = neighbor_start_[iat] + neighbors[iat].size();
+    neighbor_.resize(neighbor_start_[nat]);
+    for (int iat = 0; iat < nat; iat++)
+        std::copy(neighbors[iat].begin(), neighbors[iat].end(), neighbor_.begin() + neighbor_start_[iat]);
+    ModuleBase::timer::tick("Vdwd3", "set_neighbors");
+}
+
+int Vdwd3::find_neighbor(int iat, int jat, int itau) const
+{
+    const Neighbor target = {jat, itau};
+    auto first = neighbor_.begin() + neighbor_start_[iat];
+    auto last = neighbor_.begin() + neighbor_start_[iat + 1];
+    auto it = std::lower_bound(first, last, target, [](const Neighbor& a, const Neighbor& b) {
+        return a.atom < b.atom || (a.atom == b.atom && a.itau < b.itau);
+    });
+    if (it == last || it->atom != jat || it->itau != itau)
+        return -1;
+    return it - neighbor_.begin();
+}
+
+int Vdwd3::tau_diff(int ktau, int jtau) const
+{
+    const ModuleBase::Vector3<int> t = tau_index_[ktau] - tau_index_[jtau];
+    if (std::abs(t.x) > rep_tau_[0] || std::abs(t.y) > rep_tau_[1] || std::abs(t.z) > rep_tau_[2])
+        return -1;
+    return ((t.x + rep_tau_[0]) * (2 * rep_tau_[1] + 1) + t.y + rep_tau_[1]) * (2 * rep_tau_[2] + 1) + t.z
+           + rep_tau_[2];
+}
+
+bool Vdwd3::in_box(const ModuleBase::Vector3<int> &t, const std::vector<int> &rep) const
+{
+    return std::abs(t.x) <= rep[0] && std::abs(t.y) <= rep[1] && std::abs(t.z) <= rep[2];
+}
+
+std::vector<int> Vdwd3::local_atoms() const
+{
+    std::vector<int> atoms;
+    for (int iat = GlobalV::MY_RANK; iat < ucell_.nat; iat += GlobalV::NPROC)
+        atoms.push_back(iat);
+    return atoms;
 }
 
 void Vdwd3::set_criteria(double rthr, const std::vector<ModuleBase::Vector3<double>> &lat, std::vector<double> &tau_max)
@@ -82,161 +211,93 @@ void Vdwd3::cal_energy()
     ModuleBase::timer::tick("Vdwd3", "cal_energy");
     init();
 
-    int ij;
-    double c6 = 0.0, c8 = 0.0, r2 = 0.0, r6 = 0.0, r8 = 0.0, rr = 0.0, damp6 = 0.0, damp8 = 0.0;
-    double e6 = 0.0, e8 = 0.0, eabc = 0.0;
-    std::vector<double> cc6ab(ucell_.nat * ucell_.nat), cn(ucell_.nat);
+    const int nat = ucell_.nat;
+    std::vector<double> cc6ab(nat * nat), cn(nat);
     pbc_ncoord(cn);
-    ModuleBase::Vector3<double> tau;
-    if (para_.version() == "d3_0") // DFT-D3(zero-damping)
+
+    // the three-body term needs the c6 of all pairs, not only of the pairs of this process
+    if (para_.abc())
     {
-        double tmp;
-        for (int iat = 0; iat != ucell_.nat - 1; iat++)
-            for (int jat = iat + 1; jat != ucell_.nat; jat++)
+#pragma omp parallel for schedule(dynamic)
+        for (int iat = 0; iat < nat; iat++)
+            for (int jat = iat; jat < nat; jat++)
             {
+                double c6 = 0.0;
                 get_c6(iz_[iat], iz_[jat], cn[iat], cn[jat], c6);
-                if (para_.abc())
-                {
-                    ij = lin(iat, jat);
-                    cc6ab[ij] = std::sqrt(c6);
-                }
-                for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++)
-                    for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++)
-                        for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
-                        {
-                            tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                                  + static_cast<double>(tauz) * lat_[2];
-                            r2 = (xyz_[iat] - xyz_[jat] + tau).norm2();
-                            if (r2 > para_.rthr2())
-                                continue;
-                            rr = para_.r0ab()[iz_[iat]][iz_[jat]] / std::sqrt(r2);
-                            // zero-damping function
-                            tmp = para_.rs6() * rr;
-                            damp6 = 1.0 / (1.0 + 6.0 * std::pow(tmp, para_.alp6()));
-                            tmp = para_.rs18() * rr;
-                            damp8 = 1.0 / (1.0 + 6.0 * std::pow(tmp, para_.alp8()));
-
-                            r6 = std::pow(r2, 3);
-                            e6 += damp6 / r6 * c6;
-
-                            c8 = 3.0 * para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[jat]] * c6;
-                            r8 = r6 * r2;
-                            e8 += c8 * damp8 / r8;
-                        } // end tau
-            } // end jat
-
-        for (int iat = 0; iat != ucell_.nat; iat++)
-        {
-            int jat = iat;
-            get_c6(iz_[iat], iz_[jat], cn[iat], cn[jat], c6);
-            if (para_.abc())
-            {
-                ij = lin(iat, jat);
-                cc6ab[ij] = std::sqrt(c6);
+                cc6ab[lin(iat, jat)] = std::sqrt(c6);
             }
-            for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++)
-                for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++)
-                    for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
-                    {
-                        if (taux == 0 && tauy == 0 && tauz == 0)
-                            continue;
-                        tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                              + static_cast<double>(tauz) * lat_[2];
-                        r2 = tau.norm2();
-                        if (r2 > para_.rthr2())
-                            continue;
-                        rr = para_.r0ab()[iz_[iat]][iz_[jat]] / std::sqrt(r2);
-
-                        // zero-damping function
-                        tmp = para_.rs6() * rr;
-                        damp6 = 1.0 / (1.0 + 6.0 * std::pow(tmp, para_.alp6()));
-                        tmp = para_.rs18() * rr;
-                        damp8 = 1.0 / (1.0 + 6.0 * std::pow(tmp, para_.alp8()));
-
-                        r6 = std::pow(r2, 3);
-                        e6 += damp6 / r6 * c6 * 0.5;
+    }
 
-                        c8 = 3.0 * para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[jat]] * c6;
-                        r8 = r6 * r2;
-                        e8 += c8 * damp8 / r8 * 0.5;
-                    } // end tau
-        } // end iat
-    } // end d3_0
-    else if (para_.version() == "d3_bj") // DFT-D3(BJ-damping)
+    // pairs of jat and its neighbors iat <= jat, the pairs iat == jat are counted twice
+    const std::vector<int> atoms = local_atoms();
+    const bool zero_damping = (para_.version() == "d3_0");
+    const bool bj_damping = (para_.version() == "d3_bj");
+    double e6 = 0.0, e8 = 0.0, eabc = 0.0;
+#pragma omp parallel for schedule(dynamic) reduction(+ : e6, e8)
+    for (int ia = 0; ia < atoms.size(); ia++)
     {
-        double r42;
-        for (int iat = 0; iat != ucell_.nat; iat++)
+        const int jat = atoms[ia];
+        int iat_c6 = -1;
+        double c6 = 0.0, c8 = 0.0, r2 = 0.0, r6 = 0.0, r8 = 0.0, rr = 0.0, damp6 = 0.0, damp8 = 0.0, r42 = 0.0;
+        for (int in = neighbor_start_[jat]; in < neighbor_start_[jat + 1]; in++)
         {
-            for (int jat = iat + 1; jat != ucell_.nat; jat++)
+            const int iat = neighbor_[in].atom;
+            const int itau = neighbor_[in].itau;
+            if (!in_box(tau_index_[itau], rep_vdw_))
+                continue;
+            const ModuleBase::Vector3<double> &tau = tau_[itau];
+            r2 = (xyz_[iat] - xyz_[jat] + tau).norm2();
+            if (r2 > para_.rthr2())
+                continue;
+            const double w = (iat == jat) ? 0.5 : 1.0;
+            if (iat != iat_c6)
             {
                 get_c6(iz_[iat], iz_[jat], cn[iat], cn[jat], c6);
-                if (para_.abc())
-                {
-                    ij = lin(iat, jat);
-                    cc6ab[ij] = std::sqrt(c6);
-                }
-                for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++)
-                    for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++)
-                        for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
-                        {
-                            tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                                  + static_cast<double>(tauz) * lat_[2];
-                            r2 = (xyz_[iat] - xyz_[jat] + tau).norm2();
-                            if (r2 > para_.rthr2())
-                                continue;
-                            rr = para_.r0ab()[iz_[iat]][iz_[jat]] / std::sqrt(r2);
-
-                            // BJ-damping function
-                            r42 = para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[jat]];
-                            damp6 = std::pow((para_.rs6() * std::sqrt(3.0 * r42) + para_.rs18()), 6);
-                            damp8 = std::pow((para_.rs6() * std::sqrt(3.0 * r42) + para_.rs18()), 8);
-
-                            r6 = std::pow(r2, 3);
-                            e6 += c6 / (r6 + damp6);
-
-                            c8 = 3.0 * c6 * r42;
-                            r8 = r6 * r2;
-                            e8 += c8 / (r8 + damp8);
-                        } // end tau
-            } // end jat
-            int jat = iat;
-            get_c6(iz_[iat], iz_[jat], cn[iat], cn[jat], c6);
-            r42 = para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[jat]];
-            damp6 = std::pow((para_.rs6() * std::sqrt(3.0 * r42) + para_.rs18()), 6);
-            damp8 = std::pow((para_.rs6() * std::sqrt(3.0 * r42) + para_.rs18()), 8);
-            if (para_.abc())
+                iat_c6 = iat;
+            }
+
+            if (zero_damping) // DFT-D3(zero-damping)
             {
-                ij = lin(iat, jat);
-                cc6ab[ij] = std::sqrt(c6);
+                rr = para_.r0ab()[iz_[iat]][iz_[jat]] / std::sqrt(r2);
+                // zero-damping function
+                double tmp = para_.rs6() * rr;
+                damp6 = 1.0 / (1.0 + 6.0 * std::pow(tmp, para_.alp6()));
+                tmp = para_.rs18() * rr;
+                damp8 = 1.0 / (1.0 + 6.0 * std::pow(tmp, para_.alp8()));
+
+                r6 = std::pow(r2, 3);
+                e6 += damp6 / r6 * c6 * w;
+
+                c8 = 3.0 * para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[jat]] * c6;
+                r8 = r6 * r2;
+                e8 += c8 * damp8 / r8 * w;
             }
-            for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++)
-                for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++)
-                    for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
-                    {
-                        if (taux == 0 && tauy == 0 && tauz == 0)
-                            continue;
-                        tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                              + static_cast<double>(tauz) * lat_[2];
-                        r2 = tau.norm2();
-                        if (r2 > para_.rthr2())
-                            continue;
-                        rr = para_.r0ab()[iz_[iat]][iz_[jat]] / std::sqrt(r2);
+            else if (bj_damping) // DFT-D3(BJ-damping)
+            {
+                // BJ-damping function
+                r42 = para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[jat]];
+                damp6 = std::pow((para_.rs6() * std::sqrt(3.0 * r42) + para_.rs18()), 6);
+                damp8 = std::pow((para_.rs6() * std::sqrt(3.0 * r42) + para_.rs18()), 8);
 
-                        r6 = std::pow(r2, 3);
-                        e6 += c6 / (r6 + damp6) * 0.5;
+                r6 = std::pow(r2, 3);
+                e6 += c6 / (r6 + damp6) * w;
 
-                        c8 = 3.0 * c6 * r42;
-                        r8 = r6 * r2;
-                        e8 += c8 / (r8 + damp8) * 0.5;
-                    } // end tau
-        } // end iat
-    } // end d3_bj
+                c8 = 3.0 * c6 * r42;
+                r8 = r6 * r2;
+                e8 += c8 / (r8 + damp8) * w;
+            }
+        } // end neighbors
+    } // end jat
 
     if (para_.abc())
     {
-        pbc_three_body(iz_, lat_, xyz_, rep_cn_, cc6ab, eabc);
+        pbc_three_body(cc6ab, eabc);
     }
-    energy_ = (-para_.s6() * e6 - para_.s18() * e8 - eabc) * 2;
+
+    // the energies are summed over the atoms of all processes at once
+    double e[3] = {e6, e8, eabc};
+    Parallel_Reduce::reduce_double_all(e, 3);
+    energy_ = (-para_.s6() * e[0] - para_.s18() * e[1] - e[2]) * 2;
     ModuleBase::timer::tick("Vdwd3", "cal_energy");
 }
 
@@ -308,327 +369,125 @@ void Vdwd3::get_c6(int iat, int jat, double nci, double ncj, double &c6)
     c6 = (rsum > 1e-99) ? csum / rsum : c6mem;
 }
 
+
 void Vdwd3::pbc_ncoord(std::vector<double> &cn)
 {
-    for (size_t i = 0; i != ucell_.nat; i++)
+    const int nat = ucell_.nat;
+    const std::vector<int> atoms = local_atoms();
+    cn.assign(nat, 0.0);
+#pragma omp parallel
     {
-        double xn = 0.0;
-        ModuleBase::Vector3<double> tau;
-        double r2, rr;
-        for (size_t iat = 0; iat != ucell_.nat; iat++)
-            for (int taux = -rep_cn_[0]; taux <= rep_cn_[0]; taux++)
-                for (int tauy = -rep_cn_[1]; tauy <= rep_cn_[1]; tauy++)
-                    for (int tauz = -rep_cn_[2]; tauz <= rep_cn_[2]; tauz++)
-                    {
-                        if (iat == i && taux == 0 && tauy == 0 && tauz == 0)
-                            continue;
-                        tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                              + static_cast<double>(tauz) * lat_[2];
-                        r2 = (xyz_[iat] - xyz_[i] + tau).norm2();
-                        if (r2 > para_.cn_thr2())
-                            continue;
-                        rr = (para_.rcov()[iz_[i]] + para_.rcov()[iz_[iat]]) / std::sqrt(r2);
-                        xn += 1.0 / (1.0 + exp(-para_.k1() * (rr - 1.0)));
-                    }
-        cn[i] = xn;
+        // each pair of neighbors contributes to the coordination numbers of both atoms
+        std::vector<double> cn_thread(nat, 0.0);
+#pragma omp for schedule(dynamic)
+        for (int ia = 0; ia < atoms.size(); ia++)
+        {
+            const int i = atoms[ia];
+            for (int in = neighbor_start_[i]; in < neighbor_start_[i + 1]; in++)
+            {
+                const int iat = neighbor_[in].atom;
+                const int itau = neighbor_[in].itau;
+                if (!in_box(tau_index_[itau], rep_cn_))
+                    continue;
+                const double r2 = (xyz_[iat] - xyz_[i] + tau_[itau]).norm2();
+                if (r2 > para_.cn_thr2())
+                    continue;
+                const double rr = (para_.rcov()[iz_[i]] + para_.rcov()[iz_[iat]]) / std::sqrt(r2);
+                const double xn = 1.0 / (1.0 + exp(-para_.k1() * (rr - 1.0)));
+                cn_thread[i] += xn;
+                if (iat != i)
+                    cn_thread[iat] += xn;
+            }
+        }
+#pragma omp critical(vdwd3_ncoord)
+        for (int i = 0; i < nat; i++)
+            cn[i] += cn_thread[i];
     }
+    Parallel_Reduce::reduce_double_all(cn.data(), nat);
 }
 
-void Vdwd3::pbc_three_body(const std::vector<int> &iz,
-                           const std::vector<ModuleBase::Vector3<double>> &lat,
-                           const std::vector<ModuleBase::Vector3<double>> &xyz,
-                           const std::vector<int> &rep_cn,
-                           const std::vector<double> &cc6ab,
-                           double &eabc)
+void Vdwd3::three_body_neighbors(int iat, std::vector<int> &neighbors) const
 {
-    double sr9 = 0.75, alp9 = -16.0;
-    int ij, ik, jk;
-    double r0ij, r0ik, r0jk, c9, rij2, rik2, rjk2, rr0ij, rr0ik, rr0jk, geomean, fdamp, tmp1, tmp2, tmp3, tmp4, ang;
-    ModuleBase::Vector3<double> ijvec, ikvec, jkvec, jtau, ktau;
-    std::vector<double> repmin(3), repmax(3);
-    for (int iat = 2; iat != ucell_.nat; iat++)
-        for (int jat = 1; jat != iat; jat++)
-        {
-            ijvec = xyz_[jat] - xyz_[iat];
-            ij = lin(iat, jat);
-            r0ij = para_.r0ab()[iz_[jat]][iz_[iat]];
-            for (int kat = 0; kat != jat; kat++)
-            {
-                ik = lin(iat, kat);
-                jk = lin(jat, kat);
-                ikvec = xyz_[kat] - xyz_[iat];
-                jkvec = xyz_[kat] - xyz_[jat];
-                c9 = -cc6ab[ij] * cc6ab[ik] * cc6ab[jk];
-
-                r0ik = para_.r0ab()[iz_[kat]][iz_[iat]];
-                r0jk = para_.r0ab()[iz_[kat]][iz_[jat]];
-
-                for (int jtaux = -rep_cn_[0]; jtaux <= rep_cn_[0]; jtaux++)
-                {
-                    repmin[0] = std::max(-rep_cn_[0], jtaux - rep_cn_[0]);
-                    repmax[0] = std::min(rep_cn_[0], jtaux + rep_cn_[0]);
-                    for (int jtauy = -rep_cn_[1]; jtauy <= rep_cn_[1]; jtauy++)
-                    {
-                        repmin[1] = std::max(-rep_cn_[1], jtauy - rep_cn_[1]);
-                        repmax[1] = std::min(rep_cn_[1], jtauy + rep_cn_[1]);
-                        for (int jtauz = -rep_cn_[2]; jtauz <= rep_cn_[2]; jtauz++)
-                        {
-                            repmin[2] = std::max(-rep_cn_[2], jtauz - rep_cn_[2]);
-                            repmax[2] = std::min(rep_cn_[2], jtauz + rep_cn_[2]);
-                            jtau = static_cast<double>(jtaux) * lat_[0] + static_cast<double>(jtauy) * lat_[1]
-                                   + static_cast<double>(jtauz) * lat_[2];
-                            rij2 = (ijvec + jtau).norm2();
-                            if (rij2 > para_.cn_thr2())
-                                continue;
-                            rr0ij = std::sqrt(rij2) / r0ij;
-
-                            for (int ktaux = repmin[0]; ktaux <= repmax[0]; ktaux++)
-                                for (int ktauy = repmin[1]; ktauy <= repmax[1]; ktauy++)
-                                    for (int ktauz = repmin[2]; ktauz <= repmax[2]; ktauz++)
-                                    {
-                                        ktau = static_cast<double>(ktaux) * lat_[0]
-                                               + static_cast<double>(ktauy) * lat_[1]
-                                               + static_cast<double>(ktauz) * lat_[2];
-                                        rik2 = (ikvec + ktau).norm2();
-                                        if (rik2 > para_.cn_thr2())
-                                            continue;
-                                        rr0ik = std::sqrt(rik2) / r0ik;
-
-                                        rjk2 = (jkvec + ktau - jtau).norm2();
-                                        if (rjk2 > para_.cn_thr2())
-                                            continue;
-                                        rr0jk = std::sqrt(rjk2) / r0jk;
-
-                                        geomean = std::pow(rr0ij * rr0ik * rr0jk, 1.0 / 3.0);
-                                        fdamp = 1.0 / (1.0 + 6.0 * std::pow(sr9 * geomean, alp9));
-                                        tmp1 = (rij2 + rjk2 - rik2);
-                                        tmp2 = (rij2 + rik2 - rjk2);
-                                        tmp3 = (rik2 + rjk2 - rij2);
-                                        tmp4 = rij2 * rjk2 * rik2;
-
-                                        ang = (0.375 * tmp1 * tmp2 * tmp3 / tmp4 + 1.0) / std::pow(tmp4, 1.5);
-
-                                        eabc += ang * c9 * fdamp;
-                                    } // end ktau
-                        } // end jtauz
-                    } // end jtauy
-                } // end jtaux
-            } // end kat
-        } // end jat
-    // end iat
-
-    for (int iat = 1; iat != ucell_.nat; iat++)
+    neighbors.clear();
+    for (int in = neighbor_start_[iat]; in < neighbor_start_[iat + 1]; in++)
     {
-        int jat = iat;
-        ij = lin(iat, jat);
-        ijvec.set(0, 0, 0);
-        r0ij = para_.r0ab()[iz_[jat]][iz_[iat]];
-        for (int kat = 0; kat != iat; kat++)
-        {
-            jk = lin(jat, kat);
-            ik = jk;
-            ikvec = xyz_[kat] - xyz_[iat];
-            jkvec = ikvec;
-            c9 = -cc6ab[ij] * cc6ab[ik] * cc6ab[jk];
-
-            r0ik = para_.r0ab()[iz_[kat]][iz_[iat]];
-            r0jk = para_.r0ab()[iz_[kat]][iz_[jat]];
-            for (int jtaux = -rep_cn_[0]; jtaux <= rep_cn_[0]; jtaux++)
-            {
-                repmin[0] = std::max(-rep_cn_[0], jtaux - rep_cn_[0]);
-                repmax[0] = std::min(rep_cn_[0], jtaux + rep_cn_[0]);
-                for (int jtauy = -rep_cn_[1]; jtauy <= rep_cn_[1]; jtauy++)
-                {
-                    repmin[1] = std::max(-rep_cn_[1], jtauy - rep_cn_[1]);
-                    repmax[1] = std::min(rep_cn_[1], jtauy + rep_cn_[1]);
-                    for (int jtauz = -rep_cn_[2]; jtauz <= rep_cn_[2]; jtauz++)
-                    {
-                        repmin[2] = std::max(-rep_cn_[2], jtauz - rep_cn_[2]);
-                        repmax[2] = std::min(rep_cn_[2], jtauz + rep_cn_[2]);
-                        if (jtaux == 0 && jtauy == 0 && jtauz == 0)
-                            continue;
-                        jtau = static_cast<double>(jtaux) * lat_[0] + static_cast<double>(jtauy) * lat_[1]
-                               + static_cast<double>(jtauz) * lat_[2];
-                        rij2 = (ijvec + jtau).norm2();
-                        if (rij2 > para_.cn_thr2())
-                            continue;
-                        rr0ij = std::sqrt(rij2) / r0ij;
-
-                        for (int ktaux = repmin[0]; ktaux <= repmax[0]; ktaux++)
-                            for (int ktauy = repmin[1]; ktauy <= repmax[1]; ktauy++)
-                                for (int ktauz = repmin[2]; ktauz <= repmax[2]; ktauz++)
-                                {
-                                    ktau = static_cast<double>(ktaux) * lat_[0] + static_cast<double>(ktauy) * lat_[1]
-                                           + static_cast<double>(ktauz) * lat_[2];
-                                    rik2 = (ikvec + ktau).norm2();
-                                    if (rik2 > para_.cn_thr2())
-                                        continue;
-                                    rr0ik = std::sqrt(rik2) / r0ik;
-
-                                    rjk2 = (jkvec + ktau - jtau).norm2();
-                                    if (rjk2 > para_.cn_thr2())
-                                        continue;
-                                    rr0jk = std::sqrt(rjk2) / r0jk;
-
-                                    geomean = std::pow(rr0ij * rr0ik * rr0jk, 1.0 / 3.0);
-                                    fdamp = 1.0 / (1.0 + 6.0 * std::pow(sr9 * geomean, alp9));
-                                    tmp1 = (rij2 + rjk2 - rik2);
-                                    tmp2 = (rij2 + rik2 - rjk2);
-                                    tmp3 = (rik2 + rjk2 - rij2);
-                                    tmp4 = rij2 * rjk2 * rik2;
-
-                                    ang = (0.375 * tmp1 * tmp2 * tmp3 / tmp4 + 1.0) / std::pow(tmp4, 1.5);
-
-                                    eabc += ang * c9 * fdamp / 2.0;
-                                } // end ktau
-                    } // end jtauz
-                } // end jtauy
-            } // end jtaux
-        } // end kat
-    } // end iat
-
-    for (int iat = 1; iat != ucell_.nat; iat++)
-        for (int jat = 0; jat != iat; jat++)
-        {
-            int kat = jat;
-            ij = lin(iat, jat);
-            jk = lin(jat, kat);
-            ik = ij;
-            ikvec = xyz_[kat] - xyz_[iat];
-            ijvec = ikvec;
-            jkvec.set(0, 0, 0);
-            c9 = -cc6ab[ij] * cc6ab[ik] * cc6ab[jk];
-
-            r0ij = para_.r0ab()[iz_[jat]][iz_[iat]];
-            r0ik = r0ij;
-            r0jk = para_.r0ab()[iz_[kat]][iz_[jat]];
-
-            for (int jtaux = -rep_cn_[0]; jtaux <= rep_cn_[0]; jtaux++)
-            {
-                repmin[0] = std::max(-rep_cn_[0], jtaux - rep_cn_[0]);
-                repmax[0] = std::min(rep_cn_[0], jtaux + rep_cn_[0]);
-                for (int jtauy = -rep_cn_[1]; jtauy <= rep_cn_[1]; jtauy++)
-                {
-                    repmin[1] = std::max(-rep_cn_[1], jtauy - rep_cn_[1]);
-                    repmax[1] = std::min(rep_cn_[1], jtauy + rep_cn_[1]);
-                    for (int jtauz = -rep_cn_[2]; jtauz <= rep_cn_[2]; jtauz++)
-                    {
-                        repmin[2] = std::max(-rep_cn_[2], jtauz - rep_cn_[2]);
-                        repmax[2] = std::min(rep_cn_[2], jtauz + rep_cn_[2]);
-                        jtau = static_cast<double>(jtaux) * lat_[0] + static_cast<double>(jtauy) * lat_[1]
-                               + static_cast<double>(jtauz) * lat_[2];
-                        rij2 = (ijvec + jtau).norm2();
-                        if (rij2 > para_.cn_thr2())
-                            continue;
-                        rr0ij = std::sqrt(rij2) / r0ij;
-
-                        for (int ktaux = repmin[0]; ktaux <= repmax[0]; ktaux++)
-                            for (int ktauy = repmin[1]; ktauy <= repmax[1]; ktauy++)
-                                for (int ktauz = repmin[2]; ktauz <= repmax[2]; ktauz++)
-                                {
-                                    if (jtaux == ktaux && jtauy == ktauy && jtauz == ktauz)
-                                        continue;
-                                    ktau = static_cast<double>(ktaux) * lat_[0] + static_cast<double>(ktauy) * lat_[1]
-                                           + static_cast<double>(ktauz) * lat_[2];
-                                    rik2 = (ikvec + ktau).norm2();
-                                    if (rik2 > para_.cn_thr2())
-                                        continue;
-                                    rr0ik = std::sqrt(rik2) / r0ik;
-
-                                    rjk2 = (jkvec + ktau - jtau).norm2();
-                                    if (rjk2 > para_.cn_thr2())
-                                        continue;
-                                    rr0jk = std::sqrt(rjk2) / r0jk;
-
-                                    geomean = std::pow(rr0ij * rr0ik * rr0jk, 1.0 / 3.0);
-                                    fdamp = 1.0 / (1.0 + 6.0 * std::pow(sr9 * geomean, alp9));
-                                    tmp1 = (rij2 + rjk2 - rik2);
-                                    tmp2 = (rij2 + rik2 - rjk2);
-                                    tmp3 = (rik2 + rjk2 - rij2);
-                                    tmp4 = rij2 * rjk2 * rik2;
-
-                                    ang = (0.375 * tmp1 * tmp2 * tmp3 / tmp4 + 1.0) / std::pow(tmp4, 1.5);
-
-                                    eabc += ang * c9 * fdamp / 2.0;
-                                } // end ktau
-                    } // end jtauz
-                } // end jtauy
-            } // end jtaux
-        } // end jat
-    // end iat
-
-    for (int iat = 0; iat != ucell_.nat; iat++)
+        const int jat = neighbor_[in].atom;
+        const int jtau = neighbor_[in].itau;
+        if (in_box(tau_index_[jtau], rep_cn_) && (xyz_[jat] - xyz_[iat] + tau_[jtau]).norm2() <= para_.cn_thr2())
+            neighbors.push_back(in);
+    }
+}
+
+void Vdwd3::pbc_three_body(const std::vector<double> &cc6ab, double &eabc)
+{
+    const double sr9 = 0.75, alp9 = -16.0;
+    const std::vector<int> atoms = local_atoms();
+    double e = 0.0;
+#pragma omp parallel reduction(+ : e)
     {
-        int jat = iat;
-        int kat = iat;
-        ijvec.set(0, 0, 0);
-        ij = lin(iat, iat);
-        ik = ij;
-        jk = ij;
-        ikvec = ijvec;
-        jkvec = ikvec;
-        c9 = -cc6ab[ij] * cc6ab[ik] * cc6ab[jk];
-
-        r0ij = para_.r0ab()[iz_[iat]][iz_[iat]];
-        r0ik = r0ij;
-        r0jk = r0ij;
-
-        for (int jtaux = -rep_cn_[0]; jtaux <= rep_cn_[0]; jtaux++)
+        std::vector<int> neighbors;
+        int ij, ik, jk;
+        double r0ij, r0ik, r0jk, c9, rij2, rik2, rjk2, rr0ij, rr0ik, rr0jk, geomean, fdamp, tmp1, tmp2, tmp3, tmp4, ang;
+        ModuleBase::Vector3<double> ijvec, ikvec, jkvec;
+#pragma omp for schedule(dynamic)
+        for (int ia = 0; ia < atoms.size(); ia++)
         {
-            repmin[0] = std::max(-rep_cn_[0], jtaux - rep_cn_[0]);
-            repmax[0] = std::min(rep_cn_[0], jtaux + rep_cn_[0]);
-            for (int jtauy = -rep_cn_[1]; jtauy <= rep_cn_[1]; jtauy++)
+            const int iat = atoms[ia];
+            // triples iat >= jat >= kat of the images within cn_thr of each other
+            three_body_neighbors(iat, neighbors);
+            for (int nj = 0; nj < neighbors.size(); nj++)
             {
-                repmin[1] = std::max(-rep_cn_[1], jtauy - rep_cn_[1]);
-                repmax[1] = std::min(rep_cn_[1], jtauy + rep_cn_[1]);
-                for (int jtauz = -rep_cn_[2]; jtauz <= rep_cn_[2]; jtauz++)
+                const int jat = neighbor_[neighbors[nj]].atom;
+                const int jtau = neighbor_[neighbors[nj]].itau;
+                const ModuleBase::Vector3<double> &jtau_vec = tau_[jtau];
+                ijvec = xyz_[jat] - xyz_[iat];
+                ij = lin(iat, jat);
+                r0ij = para_.r0ab()[iz_[jat]][iz_[iat]];
+                rij2 = (ijvec + jtau_vec).norm2();
+                rr0ij = std::sqrt(rij2) / r0ij;
+
+                // the neighbors are sorted by the atoms, kat <= jat come first
+                for (int nk = 0; nk < neighbors.size() && neighbor_[neighbors[nk]].atom <= jat; nk++)
                 {
-                    repmin[2] = std::max(-rep_cn_[2], jtauz - rep_cn_[2]);
-                    repmax[2] = std::min(rep_cn_[2], jtauz + rep_cn_[2]);
-                    jtau = static_cast<double>(jtaux) * lat_[0] + static_cast<double>(jtauy) * lat_[1]
-                           + static_cast<double>(jtauz) * lat_[2];
-                    if (jtaux == 0 && jtauy == 0 && jtauz == 0)
+                    if (nk == nj)
+                        continue;
+                    const int kat = neighbor_[neighbors[nk]].atom;
+                    const int ktau = neighbor_[neighbors[nk]].itau;
+                    if (!in_box(tau_index_[ktau] - tau_index_[jtau], rep_cn_))
                         continue;
-                    rij2 = jtau.norm2();
-                    if (rij2 > para_.cn_thr2())
+                    const ModuleBase::Vector3<double> &ktau_vec = tau_[ktau];
+                    ik = lin(iat, kat);
+                    jk = lin(jat, kat);
+                    ikvec = xyz_[kat] - xyz_[iat];
+                    jkvec = xyz_[kat] - xyz_[jat];
+                    c9 = -cc6ab[ij] * cc6ab[ik] * cc6ab[jk];
+
+                    r0ik = para_.r0ab()[iz_[kat]][iz_[iat]];
+                    r0jk = para_.r0ab()[iz_[kat]][iz_[jat]];
+
+                    rik2 = (ikvec + ktau_vec).norm2();
+                    rr0ik = std::sqrt(rik2) / r0ik;
+
+                    rjk2 = (jkvec + ktau_vec - jtau_vec).norm2();
+                    if (rjk2 > para_.cn_thr2())
                         continue;
-                    rr0ij = std::sqrt(rij2) / r0ij;
-
-                    for (int ktaux = repmin[0]; ktaux <= repmax[0]; ktaux++)
-                        for (int ktauy = repmin[1]; ktauy <= repmax[1]; ktauy++)
-                            for (int ktauz = repmin[2]; ktauz <= repmax[2]; ktauz++)
-                            {
-                                if (ktaux == 0 && ktauy == 0 && ktauz == 0)
-                                    continue;
-                                if (jtaux == ktaux && jtauy == ktauy && jtauz == ktauz)
-                                    continue;
-                                ktau = static_cast<double>(ktaux) * lat_[0] + static_cast<double>(ktauy) * lat_[1]
-                                       + static_cast<double>(ktauz) * lat_[2];
-                                rik2 = ktau.norm2();
-                                if (rik2 > para_.cn_thr2())
-                                    continue;
-                                rr0ik = std::sqrt(rik2) / r0ik;
-
-                                rjk2 = (jkvec + ktau - jtau).norm2();
-                                if (rjk2 > para_.cn_thr2())
-                                    continue;
-                                rr0jk = std::sqrt(rjk2) / r0jk;
-
-                                geomean = std::pow(rr0ij * rr0ik * rr0jk, 1.0 / 3.0);
-                                fdamp = 1.0 / (1.0 + 6.0 * std::pow(sr9 * geomean, alp9));
-                                tmp1 = (rij2 + rjk2 - rik2);
-                                tmp2 = (rij2 + rik2 - rjk2);
-                                tmp3 = (rik2 + rjk2 - rij2);
-                                tmp4 = rij2 * rjk2 * rik2;
-
-                                ang = (0.375 * tmp1 * tmp2 * tmp3 / tmp4 + 1.0) / std::pow(tmp4, 1.5);
-
-                                eabc += ang * c9 * fdamp / 6.0;
-                            } // end ktau
-                } // end jtauz
-            } // end jtauy
-        } // end jtaux
-    } // end iat
+                    rr0jk = std::sqrt(rjk2) / r0jk;
+
+                    geomean = std::pow(rr0ij * rr0ik * rr0jk, 1.0 / 3.0);
+                    fdamp = 1.0 / (1.0 + 6.0 * std::pow(sr9 * geomean, alp9));
+                    tmp1 = (rij2 + rjk2 - rik2);
+                    tmp2 = (rij2 + rik2 - rjk2);
+                    tmp3 = (rik2 + rjk2 - rij2);
+                    tmp4 = rij2 * rjk2 * rik2;
+
+                    ang = (0.375 * tmp1 * tmp2 * tmp3 / tmp4 + 1.0) / std::pow(tmp4, 1.5);
+
+                    e += ang * c9 * fdamp / three_body_multiplicity(iat, jat, kat);
+                } // end kat
+            } // end jat
+        } // end iat
+    }
+    eabc = e;
 }
 
 void Vdwd3::get_dc6_dcnij(int mxci, int mxcj, double cni, double cnj, int izi, int izj,
@@ -681,755 +540,311 @@ void Vdwd3::get_dc6_dcnij(int mxci, int mxcj, double cni, double cnj, int izi, i
 
 void Vdwd3::pbc_gdisp(std::vector<ModuleBase::Vector3<double>> &g, ModuleBase::matrix &smearing_sigma)
 {
-    std::vector<double> c6save(ucell_.nat * (ucell_.nat + 1)), dc6_rest_sum(ucell_.nat * (ucell_.nat + 1) / 2),
-        dc6i(ucell_.nat), cn(ucell_.nat);
+    const int nat = ucell_.nat;
+    std::vector<double> c6save(nat * (nat + 1)), dc6ii(nat), dc6i(nat), cn(nat);
     pbc_ncoord(cn);
-    std::vector<std::vector<double>> dc6ij(ucell_.nat, std::vector<double>(ucell_.nat));
-    double c6 = 0.0, dc6iji = 0.0, dc6ijj = 0.0;
-    double r = 0.0, r0 = 0.0, r2 = 0.0, r6 = 0.0, r7 = 0.0, r8 = 0.0, r9 = 0.0;
-    double r42 = 0.0, rcovij = 0.0, t6 = 0.0, t8 = 0.0, dc6_rest = 0.0;
-    int linii = 0, linij = 0;
-    ModuleBase::Vector3<double> tau;
-    std::vector<std::vector<std::vector<std::vector<double>>>> drij(
-        ucell_.nat * (ucell_.nat + 1) / 2,
-        std::vector<std::vector<std::vector<double>>>(
-            2 * rep_vdw_[0] + 1,
-            std::vector<std::vector<double>>(2 * rep_vdw_[1] + 1, std::vector<double>(2 * rep_vdw_[2] + 1))));
-    if (para_.version() == "d3_0")
-    {
-        double damp6 = 0.0, damp8 = 0.0;
-        for (int iat = 0; iat != ucell_.nat; iat++)
-        {
-            get_dc6_dcnij(para_.mxc()[iz_[iat]], para_.mxc()[iz_[iat]], cn[iat], cn[iat],
-                          iz_[iat], iz_[iat], iat, iat, c6, dc6iji, dc6ijj);
-
-            linii = lin(iat, iat);
-            c6save[linii] = c6;
-            dc6ij[iat][iat] = dc6iji;
-            r0 = para_.r0ab()[iz_[iat]][iz_[iat]];
-            r42 = para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[iat]];
-            rcovij = para_.rcov()[iz_[iat]] + para_.rcov()[iz_[iat]];
-
-            for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++)
-                for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++)
-                    for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
-                    {
-                        tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                              + static_cast<double>(tauz) * lat_[2];
-
-                        // first dE/d(tau)
-                        r2 = tau.norm2();
-                        if (r2 > 0.1 && r2 < para_.rthr2())
-                        {
-                            r = std::sqrt(r2);
-                            r6 = std::pow(r2, 3);
-                            r7 = r6 * r;
-                            r8 = r6 * r2;
-                            r9 = r8 * r;
-
-                            t6 = std::pow(r / (para_.rs6() * r0), -para_.alp6());
-                            damp6 = 1.0 / (1.0 + 6.0 * t6);
-                            t8 = std::pow(r / (para_.rs18() * r0), -para_.alp8());
-                            damp8 = 1.0 / (1.0 + 6.0 * t8);
-
-                            // d(r^(-6))/d(tau)
-                            drij[linii][taux + rep_vdw_[0]][tauy + rep_vdw_[1]][tauz + rep_vdw_[2]]
-                                += (-para_.s6() * (6.0 / (r7)*c6 * damp6)
-                                    - para_.s18() * (24.0 / (r9)*c6 * r42 * damp8))
-                                   * 0.5;
-                            // d(f_dmp)/d(tau)
-                            drij[linii][taux + rep_vdw_[0]][tauy + rep_vdw_[1]][tauz + rep_vdw_[2]]
-                                += (para_.s6() * c6 / r7 * 6.0 * para_.alp6() * t6 * damp6 * damp6
-                                    + para_.s18() * c6 * r42 / r9 * 18.0 * para_.alp8() * t8 * damp8 * damp8)
-                                   * 0.5;
-
-                            dc6_rest = (para_.s6() / r6 * damp6 + 3.0 * para_.s18() * r42 / r8 * damp8) * 0.5;
-                            dc6i[iat] += dc6_rest * (dc6iji + dc6ijj);
-                            dc6_rest_sum[linii] += dc6_rest;
-                        }
-                    } // end tau
-            for (int jat = 0; jat != iat; jat++)
-            {
-                get_dc6_dcnij(para_.mxc()[iz_[iat]], para_.mxc()[iz_[jat]], cn[iat], cn[jat],
-                              iz_[iat], iz_[jat], iat, jat, c6, dc6iji, dc6ijj);
+    std::vector<std::vector<double>> dc6ij(nat, std::vector<double>(nat));
 
-                linij = lin(iat, jat);
-                c6save[linij] = c6;
-                r0 = para_.r0ab()[iz_[iat]][iz_[jat]];
-                r42 = para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[jat]];
-                rcovij = para_.rcov()[iz_[iat]] + para_.rcov()[iz_[jat]];
-                dc6ij[jat][iat] = dc6iji;
-                dc6ij[iat][jat] = dc6ijj;
-                for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++)
-                    for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++)
-                        for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
-                        {
-                            tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                                  + static_cast<double>(tauz) * lat_[2];
-                            r2 = (xyz_[jat] - xyz_[iat] + tau).norm2();
-                            if (r2 > para_.rthr2())
-                                continue;
-
-                            r = std::sqrt(r2);
-                            r6 = std::pow(r2, 3);
-                            r7 = r6 * r;
-                            r8 = r6 * r2;
-                            r9 = r8 * r;
-
-                            t6 = std::pow(r / (para_.rs6() * r0), -para_.alp6());
-                            damp6 = 1.0 / (1.0 + 6.0 * t6);
-                            t8 = std::pow(r / (para_.rs18() * r0), -para_.alp8());
-                            damp8 = 1.0 / (1.0 + 6.0 * t8);
-
-                            // d(r^(-6))/d(r_ij)
-                            drij[linij][taux + rep_vdw_[0]][tauy + rep_vdw_[1]][tauz + rep_vdw_[2]]
-                                += -para_.s6() * (6.0 / (r7)*c6 * damp6) - para_.s18() * (24.0 / (r9)*c6 * r42 * damp8);
-                            // d(f_dmp)/d(r_ij)
-                            drij[linij][taux + rep_vdw_[0]][tauy + rep_vdw_[1]][tauz + rep_vdw_[2]]
-                                += para_.s6() * c6 / r7 * 6.0 * para_.alp6() * t6 * damp6 * damp6
-                                   + para_.s18() * c6 * r42 / r9 * 18.0 * para_.alp8() * t8 * damp8 * damp8;
-
-                            dc6_rest = para_.s6() / r6 * damp6 + 3.0 * para_.s18() * r42 / r8 * damp8;
-                            dc6i[iat] += dc6_rest * dc6iji;
-                            dc6i[jat] += dc6_rest * dc6ijj;
-                            dc6_rest_sum[linij] += dc6_rest;
-                        } // end tau
-            } // end jat
-        } // end iat
-    } // end d3_0
-    else if (para_.version() == "d3_bj")
-    {
-        double r4;
-        for (int iat = 0; iat != ucell_.nat; iat++)
+    // c6 and its derivatives with respect to the coordination numbers, needed for all pairs by the three-body term
+#pragma omp parallel for schedule(dynamic)
+    for (int iat = 0; iat < nat; iat++)
+        for (int jat = 0; jat <= iat; jat++)
         {
-            get_dc6_dcnij(para_.mxc()[iz_[iat]], para_.mxc()[iz_[iat]], cn[iat], cn[iat],
-                          iz_[iat], iz_[iat], iat, iat, c6, dc6iji, dc6ijj);
-
-            linii = lin(iat, iat);
-            c6save[linii] = c6;
-            dc6ij[iat][iat] = dc6iji;
-            r42 = para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[iat]];
-            r0 = para_.rs6() * std::sqrt(3.0 * r42) + para_.rs18();
-            rcovij = para_.rcov()[iz_[iat]] + para_.rcov()[iz_[iat]];
-
-            for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++)
-                for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++)
-                    for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
-                    {
-                        tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                              + static_cast<double>(tauz) * lat_[2];
-
-                        // first dE/d(tau)
-                        r2 = tau.norm2();
-                        if (r2 > 0.1 && r2 < para_.rthr2())
-                        {
-                            r = std::sqrt(r2);
-                            r4 = r2 * r2;
-                            r6 = std::pow(r2, 3);
-                            r7 = r6 * r;
-                            r8 = r6 * r2;
-                            r9 = r8 * r;
-
-                            t6 = r6 + std::pow(r0, 6);
-                            t8 = r8 + std::pow(r0, 8);
-
-                            // d(1/r^(-6)+r0^6)/d(r)
-                            drij[linii][taux + rep_vdw_[0]][tauy + rep_vdw_[1]][tauz + rep_vdw_[2]]
-                                += -para_.s6() * c6 * 6.0 * r4 * r / (t6 * t6) * 0.5
-                                   - para_.s18() * c6 * 24.0 * r42 * r7 / (t8 * t8) * 0.5;
-
-                            dc6_rest = (para_.s6() / t6 + 3.0 * para_.s18() * r42 / t8) * 0.5;
-                            dc6i[iat] += dc6_rest * (dc6iji + dc6ijj);
-                            dc6_rest_sum[linii] += dc6_rest;
-                        }
-                    } // end tau
-            for (int jat = 0; jat != iat; jat++)
-            {
-                get_dc6_dcnij(para_.mxc()[iz_[iat]], para_.mxc()[iz_[jat]], cn[iat], cn[jat],
-                              iz_[iat], iz_[jat], iat, jat, c6, dc6iji, dc6ijj);
-
-                linij = lin(iat, jat);
-                c6save[linij] = c6;
-                r42 = para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[jat]];
-                r0 = para_.rs6() * std::sqrt(3.0 * r42) + para_.rs18();
-                rcovij = para_.rcov()[iz_[iat]] + para_.rcov()[iz_[jat]];
-                dc6ij[jat][iat] = dc6iji;
-                dc6ij[iat][jat] = dc6ijj;
-                for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++)
-                    for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++)
-                        for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
-                        {
-                            tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                                  + static_cast<double>(tauz) * lat_[2];
-                            r2 = (xyz_[jat] - xyz_[iat] + tau).norm2();
-                            if (r2 > para_.rthr2())
-                                continue;
-
-                            r = std::sqrt(r2);
-                            r4 = r2 * r2;
-                            r6 = std::pow(r2, 3);
-                            r7 = r6 * r;
-                            r8 = r6 * r2;
-                            r9 = r8 * r;
-
-                            t6 = r6 + std::pow(r0, 6);
-                            t8 = r8 + std::pow(r0, 8);
-
-                            drij[linij][taux + rep_vdw_[0]][tauy + rep_vdw_[1]][tauz + rep_vdw_[2]]
-                                += -para_.s6() * c6 * 6.0 * r4 * r / (t6 * t6)
-                                   - para_.s18() * c6 * 24.0 * r42 * r7 / (t8 * t8);
-
-                            dc6_rest = para_.s6() / t6 + 3.0 * para_.s18() * r42 / t8;
-                            dc6i[iat] += dc6_rest * dc6iji;
-                            dc6i[jat] += dc6_rest * dc6ijj;
-                            dc6_rest_sum[linij] += dc6_rest;
-                        } // end tau
-            } // end jat
-        } // end iat
-    } // end d3_bj
+            double c6 = 0.0, dc6iji = 0.0, dc6ijj = 0.0;
+            get_dc6_dcnij(para_.mxc()[iz_[iat]], para_.mxc()[iz_[jat]], cn[iat], cn[jat],
+                          iz_[iat], iz_[jat], iat, jat, c6, dc6iji, dc6ijj);
+            c6save[lin(iat, jat)] = c6;
+            dc6ij[iat][jat] = dc6ijj;
+            dc6ij[jat][iat] = dc6iji;
+            if (iat == jat)
+                dc6ii[iat] = dc6iji + dc6ijj;
+        }
 
-    if (para_.abc())
+    // the vector r_ij of the pair of iat and neighbor_[in], false if the pair is out of range
+    auto pair_vector = [this](const int iat, const int in, ModuleBase::Vector3<double> &rij) -> bool {
+        const int jat = neighbor_[in].atom;
+        const int itau = neighbor_[in].itau;
+        if (!in_box(tau_index_[itau], rep_vdw_))
+            return false;
+        rij = xyz_[jat] - xyz_[iat] + tau_[itau];
+        const double r2 = rij.norm2();
+        // all the images of iat itself contribute to the stress
+        return jat == iat || (r2 <= para_.rthr2() && r2 >= 0.5);
+    };
+    // dE/dr_ij * dr_ij/dxyz_i of the pair, and its stress
+    auto add_gdisp = [nat](const int iat, const int jat, const double x1, const ModuleBase::Vector3<double> &rij,
+                           std::vector<double> &gs) {
+        const ModuleBase::Vector3<double> vec3 = x1 * rij / rij.norm();
+        if (jat != iat)
+            for (int i = 0; i < 3; i++)
+            {
+                gs[3 * iat + i] += vec3[i];
+                gs[3 * jat + i] -= vec3[i];
+            }
+        for (size_t i = 0; i != 3; i++)
+            for (size_t j = 0; j != 3; j++)
+            {
+                gs[3 * nat + 3 * i + j] += vec3[j] * rij[i];
+            }
+    };
+
+    // drij[in]: dE/dr of the pair of iat and its neighbor neighbor_[in], for the atoms iat of this process
+    std::vector<double> drij(neighbor_.size());
+    std::vector<double> gs(3 * nat + 9, 0.0);
+    const std::vector<int> atoms = local_atoms();
+    const bool zero_damping = (para_.version() == "d3_0");
+    const bool bj_damping = (para_.version() == "d3_bj");
+#pragma omp parallel
     {
-        ModuleBase::Vector3<double> ijvec, ikvec, jkvec, jtau, ktau;
-        std::vector<int> repmin(3), repmax(3);
-        double sr9 = 0.75, alp9 = -16.0;
-        double linik, linjk, rij2, rik2, rjk2, rr0ij, rr0ik, rr0jk, geomean2, geomean, geomean3, r0av, r;
-        double c6ij, c6ik, c6jk, c9, damp9, ang, dfdmp, dang, tmp1, dc9;
-        for (int iat = 2; iat < ucell_.nat; iat++)
+        std::vector<double> dc6i_thread(nat, 0.0);
+        std::vector<double> gs_thread(3 * nat + 9, 0.0);
+        double c6 = 0.0, dc6iji = 0.0, dc6ijj = 0.0;
+        double r = 0.0, r0 = 0.0, r2 = 0.0, r4 = 0.0, r6 = 0.0, r7 = 0.0, r8 = 0.0, r9 = 0.0;
+        double r42 = 0.0, t6 = 0.0, t8 = 0.0, damp6 = 0.0, damp8 = 0.0, dc6_rest = 0.0;
+
+#pragma omp for schedule(dynamic)
+        for (int ia = 0; ia < atoms.size(); ia++)
         {
-            for (int jat = 1; jat != iat; jat++)
+            const int iat = atoms[ia];
+            for (int in = neighbor_start_[iat]; in < neighbor_start_[iat + 1]; in++)
             {
-                linij = lin(iat, jat);
-                ijvec = xyz_[jat] - xyz_[iat];
+                const int jat = neighbor_[in].atom;
+                const int itau = neighbor_[in].itau;
+                if (!in_box(tau_index_[itau], rep_vdw_))
+                    continue;
+                r2 = (xyz_[jat] - xyz_[iat] + tau_[itau]).norm2();
+                // the images of iat itself are counted twice
+                const bool self = (iat == jat);
+                const double w = self ? 0.5 : 1.0;
+                if (self ? !(r2 > 0.1 && r2 < para_.rthr2()) : (r2 > para_.rthr2()))
+                    continue;
+
+                c6 = c6save[lin(iat, jat)];
+                dc6iji = dc6ij[jat][iat];
+                dc6ijj = dc6ij[iat][jat];
+                r42 = para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[jat]];
 
-                c6ij = c6save[linij];
-                for (int kat = 0; kat != jat; kat++)
+                if (zero_damping)
                 {
-                    linik = lin(iat, kat);
-                    linjk = lin(jat, kat);
-                    ikvec = xyz_[kat] - xyz_[iat];
-                    jkvec = xyz_[kat] - xyz_[jat];
-
-                    c6ik = c6save[linik];
-                    c6jk = c6save[linjk];
-                    c9 = -1.0 * std::sqrt(c6ij * c6ik * c6jk);
+                    r0 = para_.r0ab()[iz_[iat]][iz_[jat]];
+                    r = std::sqrt(r2);
+                    r6 = std::pow(r2, 3);
+                    r7 = r6 * r;
+                    r8 = r6 * r2;
+                    r9 = r8 * r;
+
+                    t6 = std::pow(r / (para_.rs6() * r0), -para_.alp6());
+                    damp6 = 1.0 / (1.0 + 6.0 * t6);
+                    t8 = std::pow(r / (para_.rs18() * r0), -para_.alp8());
+                    damp8 = 1.0 / (1.0 + 6.0 * t8);
+
+                    // d(r^(-6))/d(r_ij)
+                    drij[in] += (-para_.s6() * (6.0 / (r7)*c6 * damp6) - para_.s18() * (24.0 / (r9)*c6 * r42 * damp8))
+                                * w;
+                    // d(f_dmp)/d(r_ij)
+                    drij[in] += (para_.s6() * c6 / r7 * 6.0 * para_.alp6() * t6 * damp6 * damp6
+                                 + para_.s18() * c6 * r42 / r9 * 18.0 * para_.alp8() * t8 * damp8 * damp8)
+                                * w;
+
+                    dc6_rest = (para_.s6() / r6 * damp6 + 3.0 * para_.s18() * r42 / r8 * damp8) * w;
+                }
+                else if (bj_damping)
+                {
+                    r0 = para_.rs6() * std::sqrt(3.0 * r42) + para_.rs18();
+                    r = std::sqrt(r2);
+                    r4 = r2 * r2;
+                    r6 = std::pow(r2, 3);
+                    r7 = r6 * r;
+                    r8 = r6 * r2;
+                    r9 = r8 * r;
 
-                    for (int jtaux = -rep_cn_[0]; jtaux <= rep_cn_[0]; jtaux++)
-                    {
-                        repmin[0] = std::max(-rep_cn_[0], jtaux - rep_cn_[0]);
-                        repmax[0] = std::min(rep_cn_[0], jtaux + rep_cn_[0]);
-                        for (int jtauy = -rep_cn_[1]; jtauy <= rep_cn_[1]; jtauy++)
-                        {
-                            repmin[1] = std::max(-rep_cn_[1], jtauy - rep_cn_[1]);
-                            repmax[1] = std::min(rep_cn_[1], jtauy + rep_cn_[1]);
-                            for (int jtauz = -rep_cn_[2]; jtauz <= rep_cn_[2]; jtauz++)
-                            {
-                                repmin[2] = std::max(-rep_cn_[2], jtauz - rep_cn_[2]);
-                                repmax[2] = std::min(rep_cn_[2], jtauz + rep_cn_[2]);
-                                jtau = static_cast<double>(jtaux) * lat_[0] + static_cast<double>(jtauy) * lat_[1]
-                                       + static_cast<double>(jtauz) * lat_[2];
-                                rij2 = (ijvec + jtau).norm2();
-                                if (rij2 > para_.cn_thr2())
-                                    continue;
-                                rr0ij = std::sqrt(rij2) / para_.r0ab()[iz_[jat]][iz_[iat]];
-
-                                for (int ktaux = repmin[0]; ktaux <= repmax[0]; ktaux++)
-                                    for (int ktauy = repmin[1]; ktauy <= repmax[1]; ktauy++)
-                                        for (int ktauz = repmin[2]; ktauz <= repmax[2]; ktauz++)
-                                        {
-                                            ktau = static_cast<double>(ktaux) * lat_[0]
-                                                   + static_cast<double>(ktauy) * lat_[1]
-                                                   + static_cast<double>(ktauz) * lat_[2];
-                                            rik2 = (ikvec + ktau).norm2();
-                                            if (rik2 > para_.cn_thr2())
-                                                continue;
-
-                                            rjk2 = (jkvec + ktau - jtau).norm2();
-                                            if (rjk2 > para_.cn_thr2())
-                                                continue;
-                                            rr0ik = std::sqrt(rik2) / para_.r0ab()[iz_[kat]][iz_[iat]];
-                                            rr0jk = std::sqrt(rjk2) / para_.r0ab()[iz_[kat]][iz_[jat]];
-
-                                            geomean2 = rij2 * rjk2 * rik2;
-                                            r0av = std::pow(rr0ij * rr0ik * rr0jk, 1.0 / 3.0);
-                                            damp9 = 1.0 / (1.0 + 6.0 * std::pow(sr9 * r0av, alp9));
-                                            geomean = std::sqrt(geomean2);
-                                            geomean3 = geomean * geomean2;
-                                            ang = 0.375 * (rij2 + rjk2 - rik2) * (rij2 - rjk2 + rik2)
-                                                      * (-rij2 + rjk2 + rik2) / (geomean3 * geomean2)
-                                                  + 1.0 / geomean3;
-                                            dc6_rest = ang * damp9;
-                                            dfdmp = 2.0 * alp9 * std::pow(0.75 * r0av, alp9) * damp9 * damp9;
-
-                                            r = std::sqrt(rij2);
-                                            dang = -0.375
-                                                   * (std::pow(rij2, 3) + std::pow(rij2, 2) * (rjk2 + rik2)
-                                                      + rij2 * (3.0 * std::pow(rjk2, 2) + 2.0 * rjk2 * rik2
-                                                                + 3.0 * std::pow(rik2, 2))
-                                                      - 5.0 * std::pow(rjk2 - rik2, 2) * (rjk2 + rik2))
-                                                   / (r * geomean3 * geomean2);
-                                            tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                            drij[linij][jtaux + rep_vdw_[0]][jtauy + rep_vdw_[1]][jtauz + rep_vdw_[2]]
-                                                -= tmp1;
-
-                                            r = std::sqrt(rik2);
-                                            dang = -0.375
-                                                   * (std::pow(rik2, 3) + std::pow(rik2, 2) * (rjk2 + rij2)
-                                                      + rik2 * (3.0 * std::pow(rjk2, 2) + 2.0 * rjk2 * rij2
-                                                                + 3.0 * std::pow(rij2, 2))
-                                                      - 5.0 * std::pow(rjk2 - rij2, 2) * (rjk2 + rij2))
-                                                   / (r * geomean3 * geomean2);
-                                            tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                            drij[linik][ktaux + rep_vdw_[0]][ktauy + rep_vdw_[1]][ktauz + rep_vdw_[2]]
-                                                -= tmp1;
-
-                                            r = std::sqrt(rjk2);
-                                            dang = -0.375
-                                                   * (std::pow(rjk2, 3) + std::pow(rjk2, 2) * (rik2 + rij2)
-                                                      + rjk2 * (3.0 * std::pow(rik2, 2) + 2.0 * rik2 * rij2
-                                                                + 3.0 * std::pow(rij2, 2))
-                                                      - 5.0 * std::pow(rik2 - rij2, 2) * (rik2 + rij2))
-                                                   / (r * geomean3 * geomean2);
-                                            tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                            drij[linjk][ktaux - jtaux + rep_vdw_[0]][ktauy - jtauy + rep_vdw_[1]]
-                                                [ktauz - jtauz + rep_vdw_[2]]
-                                                -= tmp1;
-
-                                            dc9 = (dc6ij[jat][iat] / c6ij + dc6ij[kat][iat] / c6ik) * c9 * 0.5;
-                                            dc6i[iat] += dc6_rest * dc9;
-
-                                            dc9 = (dc6ij[iat][jat] / c6ij + dc6ij[kat][jat] / c6jk) * c9 * 0.5;
-                                            dc6i[jat] += dc6_rest * dc9;
-
-                                            dc9 = (dc6ij[iat][kat] / c6ik + dc6ij[jat][kat] / c6jk) * c9 * 0.5;
-                                            dc6i[kat] += dc6_rest * dc9;
-                                        } // end ktau
-                            } // end jtauz
-                        } // end jtauy
-                    } // end jtaux
-                } // end kat
-            } // end jat
-        }
-        for (int iat = 1; iat != ucell_.nat; iat++)
-        {
-            int jat = iat;
-            linij = lin(iat, jat);
-            ijvec.set(0, 0, 0);
+                    t6 = r6 + std::pow(r0, 6);
+                    t8 = r8 + std::pow(r0, 8);
 
-            c6ij = c6save[linij];
-            for (int kat = 0; kat != iat; kat++)
-            {
-                linjk = lin(jat, kat);
-                linik = linjk;
-                ikvec = xyz_[kat] - xyz_[iat];
-                jkvec = ikvec;
+                    // d(1/r^(-6)+r0^6)/d(r)
+                    drij[in] += -para_.s6() * c6 * 6.0 * r4 * r / (t6 * t6) * w
+                                - para_.s18() * c6 * 24.0 * r42 * r7 / (t8 * t8) * w;
 
-                c6ik = c6save[linik];
-                c6jk = c6ik;
-                c9 = -1.0 * std::sqrt(c6ij * c6ik * c6jk);
+                    dc6_rest = (para_.s6() / t6 + 3.0 * para_.s18() * r42 / t8) * w;
+                }
+                else
+                    continue;
 
-                for (int jtaux = -rep_cn_[0]; jtaux <= rep_cn_[0]; jtaux++)
+                if (self)
+                    dc6i_thread[iat] += dc6_rest * dc6ii[iat];
+                else
                 {
-                    repmin[0] = std::max(-rep_cn_[0], jtaux - rep_cn_[0]);
-                    repmax[0] = std::min(rep_cn_[0], jtaux + rep_cn_[0]);
-                    for (int jtauy = -rep_cn_[1]; jtauy <= rep_cn_[1]; jtauy++)
-                    {
-                        repmin[1] = std::max(-rep_cn_[1], jtauy - rep_cn_[1]);
-                        repmax[1] = std::min(rep_cn_[1], jtauy + rep_cn_[1]);
-                        for (int jtauz = -rep_cn_[2]; jtauz <= rep_cn_[2]; jtauz++)
-                        {
-                            repmin[2] = std::max(-rep_cn_[2], jtauz - rep_cn_[2]);
-                            repmax[2] = std::min(rep_cn_[2], jtauz + rep_cn_[2]);
-                            if (jtaux == 0 && jtauy == 0 && jtauz == 0)
-                                continue;
-                            jtau = static_cast<double>(jtaux) * lat_[0] + static_cast<double>(jtauy) * lat_[1]
-                                   + static_cast<double>(jtauz) * lat_[2];
-                            rij2 = jtau.norm2();
-                            if (rij2 > para_.cn_thr2())
-                                continue;
-                            rr0ij = std::sqrt(rij2) / para_.r0ab()[iz_[jat]][iz_[iat]];
-
-                            for (int ktaux = repmin[0]; ktaux <= repmax[0]; ktaux++)
-                                for (int ktauy = repmin[1]; ktauy <= repmax[1]; ktauy++)
-                                    for (int ktauz = repmin[2]; ktauz <= repmax[2]; ktauz++)
-                                    {
-                                        ktau = static_cast<double>(ktaux) * lat_[0]
-                                               + static_cast<double>(ktauy) * lat_[1]
-                                               + static_cast<double>(ktauz) * lat_[2];
-                                        rik2 = (ikvec + ktau).norm2();
-                                        if (rik2 > para_.cn_thr2())
-                                            continue;
-
-                                        rjk2 = (jkvec + ktau - jtau).norm2();
-                                        if (rjk2 > para_.cn_thr2())
-                                            continue;
-                                        rr0ik = std::sqrt(rik2) / para_.r0ab()[iz_[kat]][iz_[iat]];
-                                        rr0jk = std::sqrt(rjk2) / para_.r0ab()[iz_[kat]][iz_[jat]];
-
-                                        geomean2 = rij2 * rjk2 * rik2;
-                                        r0av = std::pow(rr0ij * rr0ik * rr0jk, 1.0 / 3.0);
-                                        damp9 = 1.0 / (1.0 + 6.0 * std::pow(sr9 * r0av, alp9));
-                                        geomean = std::sqrt(geomean2);
-                                        geomean3 = geomean * geomean2;
-                                        ang = 0.375 * (rij2 + rjk2 - rik2) * (rij2 - rjk2 + rik2)
-                                                  * (-rij2 + rjk2 + rik2) / (geomean3 * geomean2)
-                                              + 1.0 / geomean3;
-                                        dc6_rest = ang * damp9 / 2.0;
-                                        dfdmp = 2.0 * alp9 * std::pow(0.75 * r0av, alp9) * damp9 * damp9;
-
-                                        r = std::sqrt(rij2);
-                                        dang = -0.375
-                                               * (std::pow(rij2, 3) + std::pow(rij2, 2) * (rjk2 + rik2)
-                                                  + rij2 * (3.0 * std::pow(rjk2, 2) + 2.0 * rjk2 * rik2
-                                                            + 3.0 * std::pow(rik2, 2))
-                                                  - 5.0 * std::pow(rjk2 - rik2, 2) * (rjk2 + rik2))
-                                               / (r * geomean3 * geomean2);
-                                        tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                        drij[linij][jtaux + rep_vdw_[0]][jtauy + rep_vdw_[1]][jtauz + rep_vdw_[2]]
-                                            -= tmp1 / 2.0;
-
-                                        r = std::sqrt(rik2);
-                                        dang = -0.375
-                                               * (std::pow(rik2, 3) + std::pow(rik2, 2) * (rjk2 + rij2)
-                                                  + rik2 * (3.0 * std::pow(rjk2, 2) + 2.0 * rjk2 * rij2
-                                                            + 3.0 * std::pow(rij2, 2))
-                                                  - 5.0 * std::pow(rjk2 - rij2, 2) * (rjk2 + rij2))
-                                               / (r * geomean3 * geomean2);
-                                        tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                        drij[linik][ktaux + rep_vdw_[0]][ktauy + rep_vdw_[1]][ktauz + rep_vdw_[2]]
-                                            -= tmp1 / 2.0;
-
-                                        r = std::sqrt(rjk2);
-                                        dang = -0.375
-                                               * (std::pow(rjk2, 3) + std::pow(rjk2, 2) * (rik2 + rij2)
-                                                  + rjk2 * (3.0 * std::pow(rik2, 2) + 2.0 * rik2 * rij2
-                                                            + 3.0 * std::pow(rij2, 2))
-                                                  - 5.0 * std::pow(rik2 - rij2, 2) * (rik2 + rij2))
-                                               / (r * geomean3 * geomean2);
-                                        tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                        drij[linjk][ktaux - jtaux + rep_vdw_[0]][ktauy - jtauy + rep_vdw_[1]]
-                                            [ktauz - jtauz + rep_vdw_[2]]
-                                            -= tmp1 / 2.0;
-
-                                        dc9 = (dc6ij[jat][iat] / c6ij + dc6ij[kat][iat] / c6ik) * c9 * 0.5;
-                                        dc6i[iat] += dc6_rest * dc9;
-
-                                        dc9 = (dc6ij[iat][jat] / c6ij + dc6ij[kat][jat] / c6jk) * c9 * 0.5;
-                                        dc6i[jat] += dc6_rest * dc9;
-
-                                        dc9 = (dc6ij[iat][kat] / c6ik + dc6ij[jat][kat] / c6jk) * c9 * 0.5;
-                                        dc6i[kat] += dc6_rest * dc9;
-                                    } // end ktau
-                        } // end jtauz
-                    } // end jtauy
-                } // end jtaux
-            } // end kat
+                    dc6i_thread[iat] += dc6_rest * dc6iji;
+                    dc6i_thread[jat] += dc6_rest * dc6ijj;
+                }
+            } // end neighbors
         } // end iat
 
-        for (int iat = 1; iat != ucell_.nat; iat++)
-            for (int jat = 0; jat != iat; jat++)
-            {
-                int kat = jat;
-                linij = lin(iat, jat);
-                linjk = lin(jat, kat);
-                linik = linij;
-                ikvec = xyz_[kat] - xyz_[iat];
-                ijvec = ikvec;
-                jkvec.set(0, 0, 0);
-
-                c6ij = c6save[linij];
-                c6ik = c6ij;
-                c6jk = c6save[linjk];
-                c9 = -1.0 * std::sqrt(c6ij * c6ik * c6jk);
-
-                for (int jtaux = -rep_cn_[0]; jtaux <= rep_cn_[0]; jtaux++)
-                {
-                    repmin[0] = std::max(-rep_cn_[0], jtaux - rep_cn_[0]);
-                    repmax[0] = std::min(rep_cn_[0], jtaux + rep_cn_[0]);
-                    for (int jtauy = -rep_cn_[1]; jtauy <= rep_cn_[1]; jtauy++)
-                    {
-                        repmin[1] = std::max(-rep_cn_[1], jtauy - rep_cn_[1]);
-                        repmax[1] = std::min(rep_cn_[1], jtauy + rep_cn_[1]);
-                        for (int jtauz = -rep_cn_[2]; jtauz <= rep_cn_[2]; jtauz++)
-                        {
-                            repmin[2] = std::max(-rep_cn_[2], jtauz - rep_cn_[2]);
-                            repmax[2] = std::min(rep_cn_[2], jtauz + rep_cn_[2]);
-                            jtau = static_cast<double>(jtaux) * lat_[0] + static_cast<double>(jtauy) * lat_[1]
-                                   + static_cast<double>(jtauz) * lat_[2];
-                            rij2 = (ijvec + jtau).norm2();
-                            if (rij2 > para_.cn_thr2())
-                                continue;
-                            rr0ij = std::sqrt(rij2) / para_.r0ab()[iz_[jat]][iz_[iat]];
-
-                            for (int ktaux = repmin[0]; ktaux <= repmax[0]; ktaux++)
-                                for (int ktauy = repmin[1]; ktauy <= repmax[1]; ktauy++)
-                                    for (int ktauz = repmin[2]; ktauz <= repmax[2]; ktauz++)
-                                    {
-                                        if (jtaux == ktaux && jtauy == ktauy && jtauz == ktauz)
-                                            continue;
-                                        ktau = static_cast<double>(ktaux) * lat_[0]
-                                               + static_cast<double>(ktauy) * lat_[1]
-                                               + static_cast<double>(ktauz) * lat_[2];
-                                        rik2 = (ikvec + ktau).norm2();
-                                        if (rik2 > para_.cn_thr2())
-                                            continue;
-                                        rr0ik = std::sqrt(rik2) / para_.r0ab()[iz_[kat]][iz_[iat]];
-
-                                        rjk2 = (jkvec + ktau - jtau).norm2();
-                                        if (rjk2 > para_.cn_thr2())
-                                            continue;
-                                        rr0jk = std::sqrt(rjk2) / para_.r0ab()[iz_[kat]][iz_[jat]];
-
-                                        geomean2 = rij2 * rjk2 * rik2;
-                                        r0av = std::pow(rr0ij * rr0ik * rr0jk, 1.0 / 3.0);
-                                        damp9 = 1.0 / (1.0 + 6.0 * std::pow(sr9 * r0av, alp9));
-                                        geomean = std::sqrt(geomean2);
-                                        geomean3 = geomean * geomean2;
-                                        ang = 0.375 * (rij2 + rjk2 - rik2) * (rij2 - rjk2 + rik2)
-                                                  * (-rij2 + rjk2 + rik2) / (geomean3 * geomean2)
-                                              + 1.0 / geomean3;
-                                        dc6_rest = ang * damp9 / 2.0;
-                                        dfdmp = 2.0 * alp9 * std::pow(0.75 * r0av, alp9) * damp9 * damp9;
-
-                                        r = std::sqrt(rij2);
-                                        dang = -0.375
-                                               * (std::pow(rij2, 3) + std::pow(rij2, 2) * (rjk2 + rik2)
-                                                  + rij2 * (3.0 * std::pow(rjk2, 2) + 2.0 * rjk2 * rik2
-                                                            + 3.0 * std::pow(rik2, 2))
-                                                  - 5.0 * std::pow(rjk2 - rik2, 2) * (rjk2 + rik2))
-                                               / (r * geomean3 * geomean2);
-                                        tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                        drij[linij][jtaux + rep_vdw_[0]][jtauy + rep_vdw_[1]][jtauz + rep_vdw_[2]]
-                                            -= tmp1 / 2.0;
-
-                                        r = std::sqrt(rik2);
-                                        dang = -0.375
-                                               * (std::pow(rik2, 3) + std::pow(rik2, 2) * (rjk2 + rij2)
-                                                  + rik2 * (3.0 * std::pow(rjk2, 2) + 2.0 * rjk2 * rij2
-                                                            + 3.0 * std::pow(rij2, 2))
-                                                  - 5.0 * std::pow(rjk2 - rij2, 2) * (rjk2 + rij2))
-                                               / (r * geomean3 * geomean2);
-                                        tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                        drij[linik][ktaux + rep_vdw_[0]][ktauy + rep_vdw_[1]][ktauz + rep_vdw_[2]]
-                                            -= tmp1 / 2.0;
-
-                                        r = std::sqrt(rjk2);
-                                        dang = -0.375
-                                               * (std::pow(rjk2, 3) + std::pow(rjk2, 2) * (rik2 + rij2)
-                                                  + rjk2 * (3.0 * std::pow(rik2, 2) + 2.0 * rik2 * rij2
-                                                            + 3.0 * std::pow(rij2, 2))
-                                                  - 5.0 * std::pow(rik2 - rij2, 2) * (rik2 + rij2))
-                                               / (r * geomean3 * geomean2);
-                                        tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                        drij[linjk][ktaux - jtaux + rep_vdw_[0]][ktauy - jtauy + rep_vdw_[1]]
-                                            [ktauz - jtauz + rep_vdw_[2]]
-                                            -= tmp1 / 2.0;
-
-                                        dc9 = (dc6ij[jat][iat] / c6ij + dc6ij[kat][iat] / c6ik) * c9 * 0.5;
-                                        dc6i[iat] += dc6_rest * dc9;
-
-                                        dc9 = (dc6ij[iat][jat] / c6ij + dc6ij[kat][jat] / c6jk) * c9 * 0.5;
-                                        dc6i[jat] += dc6_rest * dc9;
-
-                                        dc9 = (dc6ij[iat][kat] / c6ik + dc6ij[jat][kat] / c6jk) * c9 * 0.5;
-                                        dc6i[kat] += dc6_rest * dc9;
-                                    } // end ktau
-                        } // end jtauz
-                    } // end jtauy
-                } // end jtaux
-            } // end jat
-        // end iat
-
-        for (int iat = 0; iat != ucell_.nat; iat++)
+        if (para_.abc())
         {
-            int jat = iat;
-            int kat = iat;
-            ijvec.set(0, 0, 0);
-            linij = lin(iat, jat);
-            linik = lin(iat, kat);
-            linjk = lin(jat, kat);
-            ikvec = ijvec;
-            jkvec = ikvec;
-            c6ij = c6save[linij];
-            c6ik = c6ij;
-            c6jk = c6ij;
-            c9 = -1.0 * std::sqrt(c6ij * c6ik * c6jk);
-
-            for (int jtaux = -rep_cn_[0]; jtaux <= rep_cn_[0]; jtaux++)
+            std::vector<int> neighbors;
+            const double sr9 = 0.75, alp9 = -16.0;
+            ModuleBase::Vector3<double> ijvec, ikvec, jkvec, rjk;
+            double rij2, rik2, rjk2, rr0ij, rr0ik, rr0jk, geomean2, geomean, geomean3, r0av;
+            double c6ij, c6ik, c6jk, c9, damp9, ang, dfdmp, dang, tmp1, dc9, m;
+#pragma omp for schedule(dynamic)
+            for (int ia = 0; ia < atoms.size(); ia++)
             {
-                repmin[0] = std::max(-rep_cn_[0], jtaux - rep_cn_[0]);
-                repmax[0] = std::min(rep_cn_[0], jtaux + rep_cn_[0]);
-                for (int jtauy = -rep_cn_[1]; jtauy <= rep_cn_[1]; jtauy++)
+                const int iat = atoms[ia];
+                // triples iat >= jat >= kat of the images within cn_thr of each other
+                three_body_neighbors(iat, neighbors);
+                for (int nj = 0; nj < neighbors.size(); nj++)
                 {
-                    repmin[1] = std::max(-rep_cn_[1], jtauy - rep_cn_[1]);
-                    repmax[1] = std::min(rep_cn_[1], jtauy + rep_cn_[1]);
-                    for (int jtauz = -rep_cn_[2]; jtauz <= rep_cn_[2]; jtauz++)
+                    const int ij = neighbors[nj];
+                    const int jat = neighbor_[ij].atom;
+                    const int jtau = neighbor_[ij].itau;
+                    const ModuleBase::Vector3<double> &jtau_vec = tau_[jtau];
+                    ijvec = xyz_[jat] - xyz_[iat];
+                    c6ij = c6save[lin(iat, jat)];
+                    rij2 = (ijvec + jtau_vec).norm2();
+                    rr0ij = std::sqrt(rij2) / para_.r0ab()[iz_[jat]][iz_[iat]];
+                    double drij_ij = 0.0;
+
+                    // the neighbors are sorted by the atoms, kat <= jat come first
+                    for (int nk = 0; nk < neighbors.size() && neighbor_[neighbors[nk]].atom <= jat; nk++)
                     {
-                        repmin[2] = std::max(-rep_cn_[2], jtauz - rep_cn_[2]);
-                        repmax[2] = std::min(rep_cn_[2], jtauz + rep_cn_[2]);
-                        if (jtaux == 0 && jtauy == 0 && jtauz == 0)
+                        if (nk == nj)
                             continue;
-                        jtau = static_cast<double>(jtaux) * lat_[0] + static_cast<double>(jtauy) * lat_[1]
-                               + static_cast<double>(jtauz) * lat_[2];
-                        rij2 = jtau.norm2();
-                        if (rij2 > para_.cn_thr2())
+                        const int ik = neighbors[nk];
+                        const int kat = neighbor_[ik].atom;
+                        const int ktau = neighbor_[ik].itau;
+                        if (!in_box(tau_index_[ktau] - tau_index_[jtau], rep_cn_))
                             continue;
-                        rr0ij = std::sqrt(rij2) / para_.r0ab()[iz_[jat]][iz_[iat]];
-
-                        for (int ktaux = repmin[0]; ktaux <= repmax[0]; ktaux++)
-                            for (int ktauy = repmin[1]; ktauy <= repmax[1]; ktauy++)
-                                for (int ktauz = repmin[2]; ktauz <= repmax[2]; ktauz++)
-                                {
-                                    if (ktaux == 0 && ktauy == 0 && ktauz == 0)
-                                        continue;
-                                    if (jtaux == ktaux && jtauy == ktauy && jtauz == ktauz)
-                                        continue;
-                                    ktau = static_cast<double>(ktaux) * lat_[0] + static_cast<double>(ktauy) * lat_[1]
-                                           + static_cast<double>(ktauz) * lat_[2];
-                                    rik2 = ktau.norm2();
-                                    if (rik2 > para_.cn_thr2())
-                                        continue;
-                                    rr0ik = std::sqrt(rik2) / para_.r0ab()[iz_[kat]][iz_[iat]];
-
-                                    rjk2 = (jkvec + ktau - jtau).norm2();
-                                    if (rjk2 > para_.cn_thr2())
-                                        continue;
-                                    rr0jk = std::sqrt(rjk2) / para_.r0ab()[iz_[kat]][iz_[jat]];
-
-                                    geomean2 = rij2 * rjk2 * rik2;
-                                    r0av = std::pow(rr0ij * rr0ik * rr0jk, 1.0 / 3.0);
-                                    damp9 = 1.0 / (1.0 + 6.0 * std::pow(sr9 * r0av, alp9));
-                                    geomean = std::sqrt(geomean2);
-                                    geomean3 = geomean * geomean2;
-                                    ang = 0.375 * (rij2 + rjk2 - rik2) * (rij2 - rjk2 + rik2) * (-rij2 + rjk2 + rik2)
-                                              / (geomean3 * geomean2)
-                                          + 1.0 / geomean3;
-                                    dc6_rest = ang * damp9 / 6.0;
-                                    dfdmp = 2.0 * alp9 * std::pow(0.75 * r0av, alp9) * damp9 * damp9;
-
-                                    r = std::sqrt(rij2);
-                                    dang = -0.375
-                                           * (std::pow(rij2, 3) + std::pow(rij2, 2) * (rjk2 + rik2)
-                                              + rij2 * (3.0 * std::pow(rjk2, 2) + 2.0 * rjk2 * rik2
-                                                        + 3.0 * std::pow(rik2, 2))
-                                              - 5.0 * std::pow(rjk2 - rik2, 2) * (rjk2 + rik2))
-                                           / (r * geomean3 * geomean2);
-                                    tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                    drij[linij][jtaux + rep_vdw_[0]][jtauy + rep_vdw_[1]][jtauz + rep_vdw_[2]]
-                                        -= tmp1 / 6.0;
-
-                                    r = std::sqrt(rik2);
-                                    dang = -0.375
-                                           * (std::pow(rik2, 3) + std::pow(rik2, 2) * (rjk2 + rij2)
-                                              + rik2 * (3.0 * std::pow(rjk2, 2) + 2.0 * rjk2 * rij2
-                                                        + 3.0 * std::pow(rij2, 2))
-                                              - 5.0 * std::pow(rjk2 - rij2, 2) * (rjk2 + rij2))
-                                           / (r * geomean3 * geomean2);
-                                    tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                    drij[linik][ktaux + rep_vdw_[0]][ktauy + rep_vdw_[1]][ktauz + rep_vdw_[2]]
-                                        -= tmp1 / 6.0;
-
-                                    r = std::sqrt(rjk2);
-                                    dang = -0.375
-                                           * (std::pow(rjk2, 3) + std::pow(rjk2, 2) * (rik2 + rij2)
-                                              + rjk2 * (3.0 * std::pow(rik2, 2) + 2.0 * rik2 * rij2
-                                                        + 3.0 * std::pow(rij2, 2))
-                                              - 5.0 * std::pow(rik2 - rij2, 2) * (rik2 + rij2))
-                                           / (r * geomean3 * geomean2);
-                                    tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                    drij[linjk][ktaux - jtaux + rep_vdw_[0]][ktauy - jtauy + rep_vdw_[1]]
-                                        [ktauz - jtauz + rep_vdw_[2]]
-                                        -= tmp1 / 6.0;
-
-                                    dc9 = (dc6ij[jat][iat] / c6ij + dc6ij[kat][iat] / c6ik) * c9 * 0.5;
-                                    dc6i[iat] += dc6_rest * dc9;
-
-                                    dc9 = (dc6ij[iat][jat] / c6ij + dc6ij[kat][jat] / c6jk) * c9 * 0.5;
-                                    dc6i[jat] += dc6_rest * dc9;
-
-                                    dc9 = (dc6ij[iat][kat] / c6ik + dc6ij[jat][kat] / c6jk) * c9 * 0.5;
-                                    dc6i[kat] += dc6_rest * dc9;
-                                } // end ktau
-                    } // end jtauz
-                } // end jtauy
-            } // jtaux
-        } // end iat
-    }
+                        const ModuleBase::Vector3<double> &ktau_vec = tau_[ktau];
+                        ikvec = xyz_[kat] - xyz_[iat];
+                        jkvec = xyz_[kat] - xyz_[jat];
 
-    // dE/dr_ij * dr_ij/dxyz_i
-    double expterm, dcnn, x1;
-    ModuleBase::Vector3<double> rij, vec3;
-    for (int iat = 1; iat != ucell_.nat; iat++)
-        for (int jat = 0; jat != iat; jat++)
-        {
-            linij = lin(iat, jat);
-            rcovij = para_.rcov()[iz_[iat]] + para_.rcov()[iz_[jat]];
-            for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++)
-                for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++)
-                    for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
-                    {
-                        tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                              + static_cast<double>(tauz) * lat_[2];
-                        rij = xyz_[jat] - xyz_[iat] + tau;
-                        r2 = rij.norm2();
-                        if (r2 > para_.rthr2() || r2 < 0.5)
+                        c6ik = c6save[lin(iat, kat)];
+                        c6jk = c6save[lin(jat, kat)];
+                        c9 = -1.0 * std::sqrt(c6ij * c6ik * c6jk);
+
+                        rik2 = (ikvec + ktau_vec).norm2();
+                        rjk2 = (jkvec + ktau_vec - jtau_vec).norm2();
+                        if (rjk2 > para_.cn_thr2())
                             continue;
-                        r = std::sqrt(r2);
-                        if (r2 < para_.cn_thr2())
-                        {
-                            expterm = exp(-para_.k1() * (rcovij / r - 1.0));
-                            dcnn = -para_.k1() * rcovij * expterm / (r2 * (expterm + 1.0) * (expterm + 1.0));
-                        }
-                        else
-                            dcnn = 0.0;
-                        x1 = drij[linij][taux + rep_vdw_[0]][tauy + rep_vdw_[1]][tauz + rep_vdw_[2]]
-                             + dcnn * (dc6i[iat] + dc6i[jat]);
-                        vec3 = x1 * rij / r;
-                        g[iat] += vec3;
-                        g[jat] -= vec3;
-
-                        std::vector<double> vec = {vec3.x, vec3.y, vec3.z};
-                        std::vector<double> rij_vec = {rij.x, rij.y, rij.z};
-                        for (size_t i = 0; i != 3; i++)
-                            for (size_t j = 0; j != 3; j++)
-                            {
-                                smearing_sigma(i, j) += vec[j] * rij_vec[i];
-                            }
-                    } // end tau
-        } // end iat, jat
-    for (int iat = 0; iat != ucell_.nat; iat++)
+                        rr0ik = std::sqrt(rik2) / para_.r0ab()[iz_[kat]][iz_[iat]];
+                        rr0jk = std::sqrt(rjk2) / para_.r0ab()[iz_[kat]][iz_[jat]];
+                        // the pair of jat and kat is a neighbor of jat
+                        const int jk = find_neighbor(jat, kat, tau_diff(ktau, jtau));
+                        m = three_body_multiplicity(iat, jat, kat);
+                        // the pairs of a triple may belong to the triples of other threads as well
+
+                        geomean2 = rij2 * rjk2 * rik2;
+                        r0av = std::pow(rr0ij * rr0ik * rr0jk, 1.0 / 3.0);
+                        damp9 = 1.0 / (1.0 + 6.0 * std::pow(sr9 * r0av, alp9));
+                        geomean = std::sqrt(geomean2);
+                        geomean3 = geomean * geomean2;
+                        ang = 0.375 * (rij2 + rjk2 - rik2) * (rij2 - rjk2 + rik2) * (-rij2 + rjk2 + rik2)
+                                  / (geomean3 * geomean2)
+                              + 1.0 / geomean3;
+                        dc6_rest = ang * damp9 / m;
+                        dfdmp = 2.0 * alp9 * std::pow(0.75 * r0av, alp9) * damp9 * damp9;
+
+                        r = std::sqrt(rij2);
+                        dang = -0.375
+                               * (std::pow(rij2, 3) + std::pow(rij2, 2) * (rjk2 + rik2)
+                                  + rij2 * (3.0 * std::pow(rjk2, 2) + 2.0 * rjk2 * rik2 + 3.0 * std::pow(rik2, 2))
+                                  - 5.0 * std::pow(rjk2 - rik2, 2) * (rjk2 + rik2))
+                               / (r * geomean3 * geomean2);
+                        tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
+                        drij_ij -= tmp1 / m;
+
+                        r = std::sqrt(rik2);
+                        dang = -0.375
+                               * (std::pow(rik2, 3) + std::pow(rik2, 2) * (rjk2 + rij2)
+                                  + rik2 * (3.0 * std::pow(rjk2, 2) + 2.0 * rjk2 * rij2 + 3.0 * std::pow(rij2, 2))
+                                  - 5.0 * std::pow(rjk2 - rij2, 2) * (rjk2 + rij2))
+                               / (r * geomean3 * geomean2);
+                        tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
+#pragma omp atomic
+                        drij[ik] -= tmp1 / m;
+
+                        r = std::sqrt(rjk2);
+                        dang = -0.375
+                               * (std::pow(rjk2, 3) + std::pow(rjk2, 2) * (rik2 + rij2)
+                                  + rjk2 * (3.0 * std::pow(rik2, 2) + 2.0 * rik2 * rij2 + 3.0 * std::pow(rij2, 2))
+                                  - 5.0 * std::pow(rik2 - rij2, 2) * (rik2 + rij2))
+                               / (r * geomean3 * geomean2);
+                        tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
+                        // jat may belong to another process, so this pair goes to the gradient directly
+                        if (jk >= 0 && pair_vector(jat, jk, rjk))
+                            add_gdisp(jat, kat, -tmp1 / m, rjk, gs_thread);
+
+                        dc9 = (dc6ij[jat][iat] / c6ij + dc6ij[kat][iat] / c6ik) * c9 * 0.5;
+                        dc6i_thread[iat] += dc6_rest * dc9;
+
+                        dc9 = (dc6ij[iat][jat] / c6ij + dc6ij[kat][jat] / c6jk) * c9 * 0.5;
+                        dc6i_thread[jat] += dc6_rest * dc9;
+
+                        dc9 = (dc6ij[iat][kat] / c6ik + dc6ij[jat][kat] / c6jk) * c9 * 0.5;
+                        dc6i_thread[kat] += dc6_rest * dc9;
+                    } // end kat
+#pragma omp atomic
+                    drij[ij] += drij_ij;
+                } // end jat
+            } // end iat
+        }
+
+#pragma omp critical(vdwd3_gdisp)
+        {
+            for (int iat = 0; iat < nat; iat++)
+                dc6i[iat] += dc6i_thread[iat];
+            for (int i = 0; i < gs.size(); i++)
+                gs[i] += gs_thread[i];
+        }
+    }
+    // every pair needs dc6i of both of its atoms
+    Parallel_Reduce::reduce_double_all(dc6i.data(), nat);
+
+    // drij of the pairs of the atoms of this process is complete, so the pairs are split as in the loops above
+    // and only g and sigma are reduced
+#pragma omp parallel
     {
-        linii = lin(iat, iat);
-        rcovij = para_.rcov()[iz_[iat]] + para_.rcov()[iz_[iat]];
-        for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++)
-            for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++)
-                for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
+        std::vector<double> gs_thread(3 * nat + 9, 0.0);
+        double r2, r, expterm, dcnn, x1, rcovij;
+        ModuleBase::Vector3<double> rij;
+#pragma omp for schedule(dynamic)
+        for (int ia = 0; ia < atoms.size(); ia++)
+        {
+            const int iat = atoms[ia];
+            for (int in = neighbor_start_[iat]; in < neighbor_start_[iat + 1]; in++)
+            {
+                if (!pair_vector(iat, in, rij))
+                    continue;
+                const int jat = neighbor_[in].atom;
+                rcovij = para_.rcov()[iz_[iat]] + para_.rcov()[iz_[jat]];
+                r2 = rij.norm2();
+                r = std::sqrt(r2);
+                if (r2 < para_.cn_thr2())
                 {
-                    if (taux == 0 && tauy == 0 && tauz == 0)
-                        continue;
-                    tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                          + static_cast<double>(tauz) * lat_[2];
-                    r2 = tau.norm2();
-                    r = std::sqrt(r2);
-                    if (r2 < para_.cn_thr2())
-                    {
-                        expterm = exp(-para_.k1() * (rcovij / r - 1.0));
-                        dcnn = -para_.k1() * rcovij * expterm / (r2 * (expterm + 1.0) * (expterm + 1.0));
-                    }
-                    else
-                        dcnn = 0.0;
-                    x1 = drij[linii][taux + rep_vdw_[0]][tauy + rep_vdw_[1]][tauz + rep_vdw_[2]] + dcnn * dc6i[iat];
-
-                    vec3 = x1 * tau / r;
-                    std::vector<double> vec = {vec3.x, vec3.y, vec3.z};
-                    std::vector<double> tau_vec = {tau.x, tau.y, tau.z};
-                    for (size_t i = 0; i != 3; i++)
-                        for (size_t j = 0; j != 3; j++)
-                        {
-                            smearing_sigma(i, j) += vec[j] * tau_vec[i];
-                        }
-                } // end tau
-    } // end iat
+                    expterm = exp(-para_.k1() * (rcovij / r - 1.0));
+                    dcnn = -para_.k1() * rcovij * expterm / (r2 * (expterm + 1.0) * (expterm + 1.0));
+                }
+                else
+                    dcnn = 0.0;
+                if (jat != iat)
+                    x1 = drij[in] + dcnn * (dc6i[iat] + dc6i[jat]);
+                else
+                    x1 = drij[in] + dcnn * dc6i[iat];
+                add_gdisp(iat, jat, x1, rij, gs_thread);
+            } // end neighbors
+        } // end iat
+#pragma omp critical(vdwd3_gdisp)
+        for (int i = 0; i < gs.size(); i++)
+            gs[i] += gs_thread[i];
+    }
+    Parallel_Reduce::reduce_double_all(gs.data(), gs.size());
+
+    for (int iat = 0; iat != nat; iat++)
+        g[iat] += ModuleBase::Vector3<double>(gs[3 * iat], gs[3 * iat + 1], gs[3 * iat + 2]);
+    for (size_t i = 0; i != 3; i++)
+        for (size_t j = 0; j != 3; j++)
+            smearing_sigma(i, j) += gs[3 * nat + 3 * i + j];
 }
 
 } // namespace vdw
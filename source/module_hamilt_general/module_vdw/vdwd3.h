@@ -32,12 +32,53 @@ class Vdwd3 : public Vdw
     std::vector<int> rep_vdw_;
     std::vector<int> rep_cn_;
 
+    // the lattice translations within max(rep_vdw_, rep_cn_), in Bohr and in units of the lattice vectors
+    std::vector<int> rep_tau_;
+    std::vector<ModuleBase::Vector3<double>> tau_;
+    std::vector<ModuleBase::Vector3<int>> tau_index_;
+
+    // an image xyz_[atom] + tau_[itau]
+    struct Neighbor
+    {
+        int atom;
+        int itau;
+    };
+    // the images of the atoms <= iat within max(rthr, cn_thr) of iat are
+    // neighbor_[neighbor_start_[iat]], ..., neighbor_[neighbor_start_[iat + 1] - 1], sorted by atom and itau
+    std::vector<Neighbor> neighbor_;
+    std::vector<int> neighbor_start_;
+
     void cal_energy() override;
     void cal_force() override;
     void cal_stress() override;
 
     void init();
 
+    // build the neighbor list with a cell list of the periodic images
+    void set_neighbors();
+
+    // index of the image (jat, itau) in neighbor_, -1 if it is not a neighbor of iat
+    int find_neighbor(int iat, int jat, int itau) const;
+
+    // index of tau_[ktau] - tau_[jtau] in tau_, -1 if it is out of range
+    int tau_diff(int ktau, int jtau) const;
+
+    bool in_box(const ModuleBase::Vector3<int> &t, const std::vector<int> &rep) const;
+
+    // the atoms whose pairs and triples are calculated by this process
+    std::vector<int> local_atoms() const;
+
+    // indices in neighbor_ of the images within cn_thr of iat
+    void three_body_neighbors(int iat, std::vector<int> &neighbors) const;
+
+    // the number of orderings iat >= jat >= kat of the same triple of images
+    static double three_body_multiplicity(int iat, int jat, int kat)
+    {
+        if (iat == kat)
+            return 6.0;
+        return (iat == jat || jat == kat) ? 2.0 : 1.0;
+    }
+
     void set_criteria(double rthr, const std::vector<ModuleBase::Vector3<double>> &lat, std::vector<double> &tau_max);
 
     std::vector<double> atom_kind();
@@ -46,12 +87,7 @@ class Vdwd3 : public Vdw
 
     void pbc_ncoord(std::vector<double> &cn);
 
-    void pbc_three_body(const std::vector<int> &iz,
-                        const std::vector<ModuleBase::Vector3<double>> &lat,
-                        const std::vector<ModuleBase::Vector3<double>> &xyz,
-                        const std::vector<int> &rep_cn,
-                        const std::vector<double> &cc6ab,
-                        double &eabc);
+    void pbc_three_body(const std::vector<double> &cc6ab, double &eabc);
 
     void pbc_gdisp(std::vector<ModuleBase::Vector3<double>> &g, ModuleBase::matrix &smearing_sigma);
 
@@ -911,6 +911,61 @@ TEST_F(XCTest_PBE_LibXC, set_xc_type)
     }
 }
 
+class XCTest_BATCH : public testing::Test
+{
+    protected:
+        std::vector<double> rho  = {0.17E+01, 0.17E+01, 0.15E+01, 0.88E-01, 0.18E+04, 0.5E-06, 0.32E+00};
+        std::vector<double> grho = {0.81E-11, 0.17E+01, 0.36E+02, 0.87E-01, 0.55E+00, 0.12E-03, 0.21E-10};
+        std::vector<double> zeta = {0.0, 0.3, -0.5, 0.9, -0.1, 0.2, 1.0};
+};
+
+TEST_F(XCTest_BATCH, consistent_with_single_point)
+{
+    const int n = rho.size();
+    for(std::string xc : {"PBE", "PBEsol", "BP", "BLYP", "PW91", "OLYP", "HCTH", "PZ", "PWLDA", "PBE0"})
+    {
+        XC_Functional::set_xc_type(xc);
+
+        std::vector<double> e(n), v(n), s(n), v1(n), v2(n);
+        XC_Functional::xc_batch(n, rho.data(), e.data(), v.data());
+        if(XC_Functional::get_func_type() != 1)
+        {
+            XC_Functional::gcxc_batch(n, rho.data(), grho.data(), s.data(), v1.data(), v2.data());
+        }
+
+        for(int i = 0; i < n; ++i)
+        {
+            double e_ref, v_ref, s_ref, v1_ref, v2_ref;
+            XC_Functional::xc(rho[i], e_ref, v_ref);
+            EXPECT_DOUBLE_EQ(e[i], e_ref) << xc;
+            EXPECT_DOUBLE_EQ(v[i], v_ref) << xc;
+
+            if(XC_Functional::get_func_type() == 1) continue;
+            XC_Functional::gcxc(rho[i], grho[i], s_ref, v1_ref, v2_ref);
+            EXPECT_DOUBLE_EQ(s[i], s_ref) << xc;
+            EXPECT_DOUBLE_EQ(v1[i], v1_ref) << xc;
+            EXPECT_DOUBLE_EQ(v2[i], v2_ref) << xc;
+        }
+    }
+
+    for(std::string xc : {"PBE", "PZ", "PBE0"})
+    {
+        XC_Functional::set_xc_type(xc);
+
+        std::vector<double> e(n), vup(n), vdw(n);
+        XC_Functional::xc_spin_batch(n, rho.data(), zeta.data(), e.data(), vup.data(), vdw.data());
+
+        for(int i = 0; i < n; ++i)
+        {
+            double e_ref, vup_ref, vdw_ref;
+            XC_Functional::xc_spin(rho[i], zeta[i], e_ref, vup_ref, vdw_ref);
+            EXPECT_DOUBLE_EQ(e[i], e_ref) << xc;
+            EXPECT_DOUBLE_EQ(vup[i], vup_ref) << xc;
+            EXPECT_DOUBLE_EQ(vdw[i], vdw_ref) << xc;
+        }
+    }
+}
+
 /*
 //for printing results
             std::cout << std::setprecision(10);
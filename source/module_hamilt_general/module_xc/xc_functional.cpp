@@ -13,6 +13,7 @@ std::vector<int> XC_Functional::func_id(1);
 int XC_Functional::func_type = 0;
 bool XC_Functional::use_libxc = true;
 double XC_Functional::hybrid_alpha = 0.25;
+constexpr int XC_Functional::xc_chunk_size;
 
 void XC_Functional::get_hybrid_alpha(const double alpha_in)
 {
@@ -182,9 +183,9 @@ void XC_Functional::set_xc_type(const std::string xc_func_in)
 		std::cerr << "\n OPTX untested please test,";
 	}
 
-    if((func_type == 4 || func_type == 5) && GlobalV::BASIS_TYPE == "pw")
+    if((func_type == 4 || func_type == 5) && GlobalV::BASIS_TYPE == "pw" && GlobalV::NSPIN == 4)
     {
-        ModuleBase::WARNING_QUIT("set_xc_type","hybrid functional not realized for planewave yet");
+        ModuleBase::WARNING_QUIT("set_xc_type","hybrid functional in planewave has not been implemented for nspin = 4 yet");
     }
     if((func_type == 3 || func_type == 5) && GlobalV::NSPIN==4)
     {
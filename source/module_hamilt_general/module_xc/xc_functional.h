@@ -106,6 +106,8 @@ class XC_Functional
 // (i.e. LDA functional and LDA part of GGA functional)
 // 2. xc_spin, which is the spin polarized counterpart of xc
 // 3. xc_spin_libxc, which is the wrapper for LDA functional, spin polarized
+// 4. xc_batch and xc_spin_batch, which do the same as xc and xc_spin
+// on n grid points at once; the dispatch on func_id is done once per call
 
 // NOTE : In our own realization of GGA functional, the LDA part
 // and gradient correction are calculated separately.
@@ -131,6 +133,14 @@ class XC_Functional
 	static void xc_spin_libxc(const double &rhoup, const double &rhodw,
 			double &exc, double &vxcup, double &vxcdw);
 
+	// LDA and LSDA on a chunk of grid points; all rho must be positive
+	static void xc_batch(const int n, const double* rho, double* exc, double* vxc);
+	static void xc_spin_batch(const int n, const double* rho, const double* zeta,
+			double* exc, double* vxcup, double* vxcdw);
+
+	// number of grid points handed to the *_batch functions at a time
+	static constexpr int xc_chunk_size = 256;
+
 //-------------------
 //  xc_functional_wrapper_gcxc.cpp
 //-------------------
@@ -142,6 +152,8 @@ class XC_Functional
 // 3. gcc_spin, spin polarized, correlation only
 // 4. gcxc_libxc, the entire GGA functional, LIBXC, for nspin=1 case
 // 5. gcxc_spin_libxc, the entire GGA functional, LIBXC, for nspin=2 case
+// 6. gcxc_batch, gcxc_libxc_batch and gcxc_spin_libxc_batch, which do the same
+// as gcxc, gcxc_libxc and gcxc_spin_libxc on n grid points at once
 
 // The difference between our realization (gcxc/gcx_spin/gcc_spin) and
 // LIBXC, and the reason for not having gcxc_libxc is explained
@@ -164,13 +176,23 @@ class XC_Functional
 		ModuleBase::Vector3<double> gdr1, ModuleBase::Vector3<double> gdr2,
         double &sxc, double &v1xcup, double &v1xcdw, double &v2xcup, double &v2xcdw, double &v2xcud);
 
+	// GGA on a chunk of grid points
+	static void gcxc_batch(const int n, const double* rho, const double* grho,
+			double* sxc, double* v1xc, double* v2xc);
+	static void gcxc_libxc_batch(const int n, const double* rho, const double* grho,
+			double* sxc, double* v1xc, double* v2xc);
+	static void gcxc_spin_libxc_batch(const int n, const double* rhoup, const double* rhodw,
+		const ModuleBase::Vector3<double>* gdr1, const ModuleBase::Vector3<double>* gdr2,
+		double* sxc, double* v1xcup, double* v1xcdw, double* v2xcup, double* v2xcdw, double* v2xcud);
+
 //-------------------
 //  xc_functional_wrapper_tauxc.cpp
 //-------------------
 
 // This file contains wrapper for the mGGA functionals
-// it includes 1 subroutine:
+// it includes 2 subroutines:
 // 1. tau_xc
+// 2. tau_xc_batch, which does the same as tau_xc on n grid points at once
 
 // NOTE : mGGA is realized through LIBXC
 
@@ -178,6 +200,8 @@ class XC_Functional
 	// mGGA
 	static void tau_xc(const double &rho, const double &grho, const double &atau, double &sxc,
           double &v1xc, double &v2xc, double &v3xc);
+	static void tau_xc_batch(const int n, const double* rho, const double* grho, const double* atau,
+			double* sxc, double* v1xc, double* v2xc, double* v3xc);
 #endif 
 
 //-------------------
@@ -213,42 +213,71 @@ void XC_Functional::gradcorr(double &etxc, double &vtxc, ModuleBase::matrix &v,
 	double v1xc = 0.0;
 	double v2xc = 0.0;
 
+	// grid points are processed in chunks, each chunk calls the functional once
+	const int nchunk = (rhopw->nrxx + xc_chunk_size - 1) / xc_chunk_size;
+
 	if(nspin0==1)
 	{
-		double segno;
+		int idx[xc_chunk_size];
+		double arho_c[xc_chunk_size];
+		double grho_c[xc_chunk_size];
+		double sxc_c[xc_chunk_size];
+		double v1xc_c[xc_chunk_size];
+		double v2xc_c[xc_chunk_size];
 #ifdef _OPENMP
 #pragma omp for
 #endif
-		for(int ir=0; ir<rhopw->nrxx; ir++)
+		for(int ic=0; ic<nchunk; ic++)
 		{
-			const double arho = std::abs( rhotmp1[ir] );
-			if(!is_stress) h1[ir].x = h1[ir].y = h1[ir].z = 0.0;
+			const int ir_begin = ic * xc_chunk_size;
+			const int ir_end = (ir_begin + xc_chunk_size < rhopw->nrxx) ? ir_begin + xc_chunk_size : rhopw->nrxx;
 
-			if(arho > epsr)
+			int np = 0;
+			for(int ir=ir_begin; ir<ir_end; ir++)
 			{
-				grho2a = gdr1[ir].norm2();
-
-				if( rhotmp1[ir] >= 0.0 ) segno = 1.0;
-				if( rhotmp1[ir] < 0.0 ) segno = -1.0;
-				if (use_libxc && is_stress)
+				if(!is_stress) h1[ir].x = h1[ir].y = h1[ir].z = 0.0;
+				const double arho = std::abs( rhotmp1[ir] );
+				if(arho > epsr)
 				{
+					idx[np] = ir;
+					arho_c[np] = arho;
+					grho_c[np] = gdr1[ir].norm2();
+					++np;
+				}
+			}
+			if(np == 0) continue;
+
+			if (use_libxc && is_stress)
+			{
 #ifdef USE_LIBXC
-					if(func_type == 3 || func_type == 5) //the gradcorr part to stress of mGGA
-					{
-						double v3xc;
-						double atau = chr->kin_r[0][ir]/2.0;
-						XC_Functional::tau_xc( arho, grho2a, atau, sxc, v1xc, v2xc, v3xc);
-					}
-					else
+				if(func_type == 3 || func_type == 5) //the gradcorr part to stress of mGGA
+				{
+					double atau_c[xc_chunk_size];
+					double v3xc_c[xc_chunk_size];
+					for(int ip=0; ip<np; ip++)
 					{
-						XC_Functional::gcxc_libxc( arho, grho2a, sxc, v1xc, v2xc);
+						atau_c[ip] = chr->kin_r[0][idx[ip]]/2.0;
 					}
-#endif 
-				} // end use_libxc
+					XC_Functional::tau_xc_batch( np, arho_c, grho_c, atau_c, sxc_c, v1xc_c, v2xc_c, v3xc_c);
+				}
 				else
 				{
-					XC_Functional::gcxc( arho, grho2a, sxc, v1xc, v2xc);
+					XC_Functional::gcxc_libxc_batch( np, arho_c, grho_c, sxc_c, v1xc_c, v2xc_c);
 				}
+#endif 
+			} // end use_libxc
+			else
+			{
+				XC_Functional::gcxc_batch( np, arho_c, grho_c, sxc_c, v1xc_c, v2xc_c);
+			}
+
+			for(int ip=0; ip<np; ip++)
+			{
+				const int ir = idx[ip];
+				const double segno = ( rhotmp1[ir] >= 0.0 ) ? 1.0 : -1.0;
+				sxc = sxc_c[ip];
+				v1xc = v1xc_c[ip];
+				v2xc = v2xc_c[ip];
 				if(is_stress)
 				{
 					double tt[3];
@@ -269,7 +298,6 @@ void XC_Functional::gradcorr(double &etxc, double &vtxc, ModuleBase::matrix &v,
 					// first term of the gradient correction:
 					// D(rho*Exc)/D(rho)
 					v(0, ir) += ModuleBase::e2 * v1xc;
-					// cout << "v    " << v(0, ir) << endl;
 					
 					// h contains
 					// D(rho*Exc) / D(|grad rho|) * (grad rho) / |grad rho|
@@ -278,21 +306,39 @@ void XC_Functional::gradcorr(double &etxc, double &vtxc, ModuleBase::matrix &v,
 					local_vtxcgc += ModuleBase::e2* v1xc * ( rhotmp1[ir] - chr->rho_core[ir] );
 					local_etxcgc += ModuleBase::e2* sxc  * segno;
 				}
-			} // end arho > epsr
+			} // end ip
 		}
 	}// end nspin0 == 1
-	else // spin polarized case
+	else if(use_libxc) // spin polarized case, LIBXC
 	{
+		double sxc_c[xc_chunk_size];
+		double v1xcup_c[xc_chunk_size];
+		double v1xcdw_c[xc_chunk_size];
+		double v2xcup_c[xc_chunk_size];
+		double v2xcdw_c[xc_chunk_size];
+		double v2xcud_c[xc_chunk_size];
 #ifdef _OPENMP
 #pragma omp for
 #endif
-		for(int ir=0; ir<rhopw->nrxx; ir++)
+		for(int ic=0; ic<nchunk; ic++)
 		{
-			if(use_libxc)
+			const int ir_begin = ic * xc_chunk_size;
+			const int ir_end = (ir_begin + xc_chunk_size < rhopw->nrxx) ? ir_begin + xc_chunk_size : rhopw->nrxx;
+			const int np = ir_end - ir_begin;
+
+			XC_Functional::gcxc_spin_libxc_batch(np, rhotmp1 + ir_begin, rhotmp2 + ir_begin,
+				gdr1 + ir_begin, gdr2 + ir_begin,
+				sxc_c, v1xcup_c, v1xcdw_c, v2xcup_c, v2xcdw_c, v2xcud_c);
+
+			for(int ir=ir_begin; ir<ir_end; ir++)
 			{
-				double sxc, v1xcup, v1xcdw, v2xcup, v2xcdw, v2xcud;
-				XC_Functional::gcxc_spin_libxc(rhotmp1[ir], rhotmp2[ir], gdr1[ir], gdr2[ir], 
-					sxc, v1xcup, v1xcdw, v2xcup, v2xcdw, v2xcud);
+				const int ip = ir - ir_begin;
+				const double sxc = sxc_c[ip];
+				const double v1xcup = v1xcup_c[ip];
+				const double v1xcdw = v1xcdw_c[ip];
+				const double v2xcup = v2xcup_c[ip];
+				const double v2xcdw = v2xcdw_c[ip];
+				const double v2xcud = v2xcud_c[ip];
 				if(is_stress)
 				{
 					double tt1[3],tt2[3];
@@ -331,96 +377,102 @@ void XC_Functional::gradcorr(double &etxc, double &vtxc, ModuleBase::matrix &v,
 					local_etxcgc = local_etxcgc + ModuleBase::e2 * sxc;
 				}
 			}
-			else
+		}
+	}
+	else // spin polarized case
+	{
+#ifdef _OPENMP
+#pragma omp for
+#endif
+		for(int ir=0; ir<rhopw->nrxx; ir++)
+		{
+			double v1cup = 0.0;
+			double v1cdw = 0.0;
+			double v2cup = 0.0;
+			double v2cdw = 0.0;
+			double v1xup = 0.0;
+			double v1xdw = 0.0;
+			double v2xup = 0.0;
+			double v2xdw = 0.0;
+			double v2cud = 0.0;
+			double v2c = 0.0;
+			double sx = 0.0;
+			double sc = 0.0;
+			double rh = rhotmp1[ir] + rhotmp2[ir];
+			grho2a = gdr1[ir].norm2();
+			grho2b = gdr2[ir].norm2();
+			XC_Functional::gcx_spin(rhotmp1[ir], rhotmp2[ir], grho2a, grho2b,
+				sx, v1xup, v1xdw, v2xup, v2xdw);
+			
+			if(rh > epsr)
 			{
-				double v1cup = 0.0;
-				double v1cdw = 0.0;
-				double v2cup = 0.0;
-				double v2cdw = 0.0;
-				double v1xup = 0.0;
-				double v1xdw = 0.0;
-				double v2xup = 0.0;
-				double v2xdw = 0.0;
-				double v2cud = 0.0;
-				double v2c = 0.0;
-				double sx = 0.0;
-				double sc = 0.0;
-				double rh = rhotmp1[ir] + rhotmp2[ir];
-				grho2a = gdr1[ir].norm2();
-				grho2b = gdr2[ir].norm2();
-				XC_Functional::gcx_spin(rhotmp1[ir], rhotmp2[ir], grho2a, grho2b,
-					sx, v1xup, v1xdw, v2xup, v2xdw);
-				
-				if(rh > epsr)
+				if(igcc_is_lyp)
 				{
-					if(igcc_is_lyp)
-					{
-						ModuleBase::WARNING_QUIT("XC_Functional","igcc_is_lyp is not available now.");
-					}
-					else
-					{
-						double zeta = ( rhotmp1[ir] - rhotmp2[ir] ) / rh;
-						if(GlobalV::NSPIN==4&&(GlobalV::DOMAG||GlobalV::DOMAG_Z)) zeta = fabs(zeta) * neg[ir];
-						const double grh2 = (gdr1[ir]+gdr2[ir]).norm2();
-						XC_Functional::gcc_spin(rh, zeta, grh2, sc, v1cup, v1cdw, v2c);
-						v2cup = v2c;
-						v2cdw = v2c;
-						v2cud = v2c;
-					}
+					ModuleBase::WARNING_QUIT("XC_Functional","igcc_is_lyp is not available now.");
 				}
 				else
 				{
-					sc = 0.0;
-					v1cup = 0.0;
-					v1cdw = 0.0;
-					v2c = 0.0;
-					v2cup = 0.0;
-					v2cdw = 0.0;
-					v2cud = 0.0;
+					double zeta = ( rhotmp1[ir] - rhotmp2[ir] ) / rh;
+					if(GlobalV::NSPIN==4&&(GlobalV::DOMAG||GlobalV::DOMAG_Z)) zeta = fabs(zeta) * neg[ir];
+					const double grh2 = (gdr1[ir]+gdr2[ir]).norm2();
+					XC_Functional::gcc_spin(rh, zeta, grh2, sc, v1cup, v1cdw, v2c);
+					v2cup = v2c;
+					v2cdw = v2c;
+					v2cud = v2c;
 				}
+			}
+			else
+			{
+				sc = 0.0;
+				v1cup = 0.0;
+				v1cdw = 0.0;
+				v2c = 0.0;
+				v2cup = 0.0;
+				v2cdw = 0.0;
+				v2cud = 0.0;
+			}
 
-				if(is_stress)
+			if(is_stress)
+			{
+				double tt1[3],tt2[3];
 				{
-					double tt1[3],tt2[3];
-					{
-						tt1[0] = gdr1[ir].x;
-						tt1[1] = gdr1[ir].y;
-						tt1[2] = gdr1[ir].z;
-						tt2[0] = gdr2[ir].x;
-						tt2[1] = gdr2[ir].y;
-						tt2[2] = gdr2[ir].z;
-					}
-					for(int l = 0;l< 3;l++)
-					{
-						for(int m = 0;m< l+1;m++)
-						{
-							int ind = l*3 + m;
-							//    exchange
-							local_stress_gga [ind] += tt1[l] * tt1[m] * ModuleBase::e2 * v2xup + 
-									tt2[l] * tt2[m] * ModuleBase::e2 * v2xdw;
-							//    correlation
-							local_stress_gga [ind] += ( tt1[l] * tt1[m] * v2cup + 
-									tt2[l] * tt2[m] * v2cdw + 
-									(tt1[l] * tt2[m] +
-									tt2[l] * tt1[m] ) * v2cud ) * ModuleBase::e2;
-						}
-					}
+					tt1[0] = gdr1[ir].x;
+					tt1[1] = gdr1[ir].y;
+					tt1[2] = gdr1[ir].z;
+					tt2[0] = gdr2[ir].x;
+					tt2[1] = gdr2[ir].y;
+					tt2[2] = gdr2[ir].z;
 				}
-				else
+				for(int l = 0;l< 3;l++)
 				{
-					// first term of the gradient correction : D(rho*Exc)/D(rho)
-					v(0,ir) = v(0,ir) + ModuleBase::e2 * ( v1xup + v1cup );
-					v(1,ir) = v(1,ir) + ModuleBase::e2 * ( v1xdw + v1cdw );
-				
-					// h contains D(rho*Exc)/D(|grad rho|) * (grad rho) / |grad rho|
-					h1[ir] = ModuleBase::e2 * ( ( v2xup + v2cup ) * gdr1[ir] + v2cud * gdr2[ir] );
-					h2[ir] = ModuleBase::e2 * ( ( v2xdw + v2cdw ) * gdr2[ir] + v2cud * gdr1[ir] );
-
-					local_vtxcgc = local_vtxcgc + ModuleBase::e2 * ( v1xup + v1cup ) * ( rhotmp1[ir] - chr->rho_core[ir] * fac );
-					local_vtxcgc = local_vtxcgc + ModuleBase::e2 * ( v1xdw + v1cdw ) * ( rhotmp2[ir] - chr->rho_core[ir] * fac );
-					local_etxcgc = local_etxcgc + ModuleBase::e2 * ( sx + sc );
+					for(int m = 0;m< l+1;m++)
+					{
+						int ind = l*3 + m;
+						//    exchange
+						local_stress_gga [ind] += tt1[l] * tt1[m] * ModuleBase::e2 * v2xup + 
+								tt2[l] * tt2[m] * ModuleBase::e2 * v2xdw;
+						//    correlation
+						local_stress_gga [ind] += ( tt1[l] * tt1[m] * v2cup + 
+								tt2[l] * tt2[m] * v2cdw + 
+								(tt1[l] * tt2[m] +
+								tt2[l] * tt1[m] ) * v2cud ) * ModuleBase::e2;
+					}
 				}
 			}
+			else
+			{
+				// first term of the gradient correction : D(rho*Exc)/D(rho)
+				v(0,ir) = v(0,ir) + ModuleBase::e2 * ( v1xup + v1cup );
+				v(1,ir) = v(1,ir) + ModuleBase::e2 * ( v1xdw + v1cdw );
+			
+				// h contains D(rho*Exc)/D(|grad rho|) * (grad rho) / |grad rho|
+				h1[ir] = ModuleBase::e2 * ( ( v2xup + v2cup ) * gdr1[ir] + v2cud * gdr2[ir] );
+				h2[ir] = ModuleBase::e2 * ( ( v2xdw + v2cdw ) * gdr2[ir] + v2cud * gdr1[ir] );
+
+				local_vtxcgc = local_vtxcgc + ModuleBase::e2 * ( v1xup + v1cup ) * ( rhotmp1[ir] - chr->rho_core[ir] * fac );
+				local_vtxcgc = local_vtxcgc + ModuleBase::e2 * ( v1xdw + v1cdw ) * ( rhotmp2[ir] - chr->rho_core[ir] * fac );
+				local_etxcgc = local_etxcgc + ModuleBase::e2 * ( sx + sc );
+			}
 		}// end ir
 
 	}
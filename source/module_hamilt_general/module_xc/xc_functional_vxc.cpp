@@ -40,59 +40,93 @@ std::tuple<double,double,ModuleBase::matrix> XC_Functional::v_xc(
     if (GlobalV::NSPIN == 1 || ( GlobalV::NSPIN ==4 && !GlobalV::DOMAG && !GlobalV::DOMAG_Z))
     {
         // spin-unpolarized case
+        // grid points are processed in chunks, each chunk calls the functional once
+        const int nchunk = (nrxx + xc_chunk_size - 1) / xc_chunk_size;
 #ifdef _OPENMP
 #pragma omp parallel for reduction(+:etxc) reduction(+:vtxc)
 #endif
-        for (int ir = 0;ir < nrxx;ir++)
+        for (int ic = 0; ic < nchunk; ic++)
         {
-            // total electron charge density
-            double rhox = chr->rho[0][ir] + chr->rho_core[ir];
-            double arhox = std::abs(rhox);
-            if (arhox > vanishing_charge)
+            const int ir_begin = ic * xc_chunk_size;
+            const int ir_end = (ir_begin + xc_chunk_size < nrxx) ? ir_begin + xc_chunk_size : nrxx;
+
+            // collect the points with non-vanishing charge
+            int idx[xc_chunk_size];
+            double arhox[xc_chunk_size];
+            int np = 0;
+            for (int ir = ir_begin; ir < ir_end; ir++)
             {
-                double exc = 0.0;
-                double vxc = 0.0;
-                XC_Functional::xc(arhox, exc, vxc);
-                v(0,ir) = e2 * vxc;
+                // total electron charge density
+                const double rhox = chr->rho[0][ir] + chr->rho_core[ir];
+                if (std::abs(rhox) > vanishing_charge)
+                {
+                    idx[np] = ir;
+                    arhox[np] = std::abs(rhox);
+                    ++np;
+                }
+            }
+            if (np == 0) continue;
+
+            double exc[xc_chunk_size];
+            double vxc[xc_chunk_size];
+            XC_Functional::xc_batch(np, arhox, exc, vxc);
+
+            for (int ip = 0; ip < np; ip++)
+            {
+                const int ir = idx[ip];
+                v(0,ir) = e2 * vxc[ip];
                 // consider the total charge density
-                etxc += e2 * exc * rhox;
+                etxc += e2 * exc[ip] * (chr->rho[0][ir] + chr->rho_core[ir]);
                 // only consider chr->rho
                 vtxc += v(0, ir) * chr->rho[0][ir];
-            } // endif
-        } //enddo
+            }
+        }
     }
     else if(GlobalV::NSPIN ==2)
     {
         // spin-polarized case
+        const int nchunk = (nrxx + xc_chunk_size - 1) / xc_chunk_size;
 #ifdef _OPENMP
 #pragma omp parallel for reduction(+:etxc) reduction(+:vtxc)
 #endif
-        for (int ir = 0;ir < nrxx;ir++)
+        for (int ic = 0; ic < nchunk; ic++)
         {
-            double rhox = chr->rho[0][ir] + chr->rho[1][ir] + chr->rho_core[ir]; //HLX(05-29-06): bug fixed
-            double arhox = std::abs(rhox);
-
-            if (arhox > vanishing_charge)
+            const int ir_begin = ic * xc_chunk_size;
+            const int ir_end = (ir_begin + xc_chunk_size < nrxx) ? ir_begin + xc_chunk_size : nrxx;
+
+            int idx[xc_chunk_size];
+            double arhox[xc_chunk_size];
+            double zeta[xc_chunk_size];
+            int np = 0;
+            for (int ir = ir_begin; ir < ir_end; ir++)
             {
-                double zeta = (chr->rho[0][ir] - chr->rho[1][ir]) / arhox; //HLX(05-29-06): bug fixed
-
-                if (std::abs(zeta)  > 1.0)
+                const double rhox = chr->rho[0][ir] + chr->rho[1][ir] + chr->rho_core[ir]; //HLX(05-29-06): bug fixed
+                if (std::abs(rhox) > vanishing_charge)
                 {
-                    zeta = (zeta > 0.0) ? 1.0 : (-1.0);
+                    idx[np] = ir;
+                    arhox[np] = std::abs(rhox);
+                    zeta[np] = (chr->rho[0][ir] - chr->rho[1][ir]) / arhox[np]; //HLX(05-29-06): bug fixed
+                    if (std::abs(zeta[np]) > 1.0)
+                    {
+                        zeta[np] = (zeta[np] > 0.0) ? 1.0 : (-1.0);
+                    }
+                    ++np;
                 }
+            }
+            if (np == 0) continue;
 
-                double rhoup = arhox * (1.0+zeta) / 2.0;
-                double rhodw = arhox * (1.0-zeta) / 2.0;
-                double exc = 0.0;
-                double vxc[2];
-                XC_Functional::xc_spin(arhox, zeta, exc, vxc[0], vxc[1]);
+            double exc[xc_chunk_size];
+            double vxcup[xc_chunk_size];
+            double vxcdw[xc_chunk_size];
+            XC_Functional::xc_spin_batch(np, arhox, zeta, exc, vxcup, vxcdw);
 
-                for (int is = 0;is < GlobalV::NSPIN;is++)
-                {
-                    v(is, ir) = e2 * vxc[is];
-                }
+            for (int ip = 0; ip < np; ip++)
+            {
+                const int ir = idx[ip];
+                v(0, ir) = e2 * vxcup[ip];
+                v(1, ir) = e2 * vxcdw[ip];
 
-                etxc += e2 * exc * rhox;
+                etxc += e2 * exc[ip] * (chr->rho[0][ir] + chr->rho[1][ir] + chr->rho_core[ir]);
                 vtxc += v(0, ir) * chr->rho[0][ir] + v(1, ir) * chr->rho[1][ir];
             }
         }
@@ -5,9 +5,12 @@
 // 3. gcc_spin, spin polarized, correlation only
 // 4. gcxc_libxc, the entire GGA functional, LIBXC, for nspin=1 case
 // 5. gcxc_spin_libxc, the entire GGA functional, LIBXC, for nspin=2 case
+// 6. gcxc_batch, gcxc_libxc_batch and gcxc_spin_libxc_batch, which do the
+// same as their counterparts above on a chunk of grid points
 
 #include "xc_functional.h"
 #include <stdexcept>
+#include <vector>
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
 #include "module_base/global_function.h"
 
@@ -386,3 +389,207 @@ void XC_Functional::gcxc_spin_libxc(double rhoup, double rhodw,
     ModuleBase::WARNING_QUIT("xc_spin_libxc","compile with LIBXC to use this subroutine");
 #endif
 } 
+
+namespace
+{
+// adds the contribution of one GGA kernel to the packed points idx
+template <typename Kernel>
+void gcxc_accumulate(const std::vector<int>& idx, const double* rho, const double* grho,
+        double* sxc, double* v1xc, double* v2xc, Kernel kernel)
+{
+    for(const int i : idx)
+    {
+        double s, v1, v2;
+        kernel(rho[i], grho[i], s, v1, v2);
+        sxc[i] += s;
+        v1xc[i] += v1;
+        v2xc[i] += v2;
+    }
+}
+}
+
+void XC_Functional::gcxc_batch(const int n, const double* rho, const double* grho,
+        double* sxc, double* v1xc, double* v2xc)
+{
+    const double small = 1.e-6;
+    const double smallg = 1.e-10;
+
+    // points below the thresholds have no gradient correction,
+    // the others are collected so that each functional runs over them in one loop
+    std::vector<int> idx;
+    idx.reserve(n);
+    for(int i = 0; i < n; ++i)
+    {
+        sxc[i] = v1xc[i] = v2xc[i] = 0.0;
+        if (rho[i] > small && grho[i] >= smallg)
+        {
+            idx.push_back(i);
+        }
+    }
+
+    // the same dispatch as gcxc, hoisted out of the loop over points
+    auto pbex_flag = [](const int flag)
+    {
+        return [flag](const double &r, const double &g, double &s, double &v1, double &v2)
+            { XC_Functional::pbex(r, g, flag, s, v1, v2); };
+    };
+    auto pbec_flag = [](const int flag)
+    {
+        return [flag](const double &r, const double &g, double &s, double &v1, double &v2)
+            { XC_Functional::pbec(r, g, flag, s, v1, v2); };
+    };
+
+    for(int id : func_id)
+    {
+        switch( id )
+        {
+            case XC_GGA_X_B88: //B88
+                gcxc_accumulate(idx, rho, grho, sxc, v1xc, v2xc, XC_Functional::becke88);break;
+            case XC_GGA_X_PW91: //PW91_X
+                gcxc_accumulate(idx, rho, grho, sxc, v1xc, v2xc, XC_Functional::ggax);break;
+            case XC_GGA_X_PBE: //PBX
+                gcxc_accumulate(idx, rho, grho, sxc, v1xc, v2xc, pbex_flag(0));break;
+            case XC_GGA_X_PBE_R: //revised PBX
+                gcxc_accumulate(idx, rho, grho, sxc, v1xc, v2xc, pbex_flag(1));break;
+            case XC_GGA_X_HCTH_A: //HCTH_X
+                gcxc_accumulate(idx, rho, grho, sxc, v1xc, v2xc, XC_Functional::hcth);break; //XC together
+            case XC_GGA_C_HCTH_A: //HCTH_C
+                break;
+            case XC_GGA_X_OPTX: //OPTX
+                gcxc_accumulate(idx, rho, grho, sxc, v1xc, v2xc, XC_Functional::optx);break;
+            case XC_GGA_X_PBE_SOL: //PBXsol
+                gcxc_accumulate(idx, rho, grho, sxc, v1xc, v2xc, pbex_flag(2));break;
+            case XC_GGA_X_WC: //Wu-Cohen
+                gcxc_accumulate(idx, rho, grho, sxc, v1xc, v2xc, XC_Functional::wcx);break;
+            case XC_GGA_C_P86: //P86
+                gcxc_accumulate(idx, rho, grho, sxc, v1xc, v2xc, XC_Functional::perdew86);break;
+            case XC_GGA_C_PW91: //PW91_C
+                gcxc_accumulate(idx, rho, grho, sxc, v1xc, v2xc, XC_Functional::ggac);break;
+            case XC_GGA_C_PBE: //PBC
+                gcxc_accumulate(idx, rho, grho, sxc, v1xc, v2xc, pbec_flag(0));break;
+            case XC_GGA_C_PBE_SOL: //PBCsol
+                gcxc_accumulate(idx, rho, grho, sxc, v1xc, v2xc, pbec_flag(1));break;
+            case XC_GGA_C_LYP: //BLYP
+                gcxc_accumulate(idx, rho, grho, sxc, v1xc, v2xc, XC_Functional::glyp);break;
+            case XC_HYB_GGA_XC_PBEH: //PBE0
+                gcxc_accumulate(idx, rho, grho, sxc, v1xc, v2xc,
+                    [](const double &r, const double &g, double &s, double &v1, double &v2)
+                    {
+                        double sx, v1x, v2x, sc, v1c, v2c;
+                        XC_Functional::pbex(r, g, 0, sx, v1x, v2x);
+                        XC_Functional::pbec(r, g, 0, sc, v1c, v2c);
+                        s = sx * (1.0 - XC_Functional::hybrid_alpha) + sc;
+                        v1 = v1x * (1.0 - XC_Functional::hybrid_alpha) + v1c;
+                        v2 = v2x * (1.0 - XC_Functional::hybrid_alpha) + v2c;
+                    });
+                break;
+            default: //SCAN_X,SCAN_C,HSE, and so on
+                throw std::domain_error("functional unfinished in "+ModuleBase::GlobalFunc::TO_STRING(__FILE__)+" line "+ModuleBase::GlobalFunc::TO_STRING(__LINE__));
+        }
+    }
+    return;
+}
+
+void XC_Functional::gcxc_libxc_batch(const int n, const double* rho, const double* grho,
+        double* sxc, double* v1xc, double* v2xc)
+{
+#ifdef USE_LIBXC
+    const double small = 1.e-6;
+    const double smallg = 1.e-10;
+
+    std::vector<int> idx;
+    std::vector<double> rho_c, grho_c;
+    idx.reserve(n);
+    for(int i = 0; i < n; ++i)
+    {
+        sxc[i] = v1xc[i] = v2xc[i] = 0.0;
+        if (rho[i] > small && grho[i] >= smallg)
+        {
+            idx.push_back(i);
+            rho_c.push_back(rho[i]);
+            grho_c.push_back(grho[i]);
+        }
+    }
+
+    const int m = idx.size();
+    if (m == 0)
+    {
+        return;
+    }
+
+    std::vector<double> s(m), v1(m), v2(m);
+    std::vector<xc_func_type> funcs = init_func(XC_UNPOLARIZED);
+    for(xc_func_type &func : funcs)
+    {
+        // one libxc call for the whole chunk instead of one per point
+        xc_gga_exc_vxc(&func, m, rho_c.data(), grho_c.data(), s.data(), v1.data(), v2.data());
+        for(int k = 0; k < m; ++k)
+        {
+            sxc[idx[k]] += s[k] * rho_c[k];
+            v2xc[idx[k]] += v2[k] * 2.0;
+            v1xc[idx[k]] += v1[k];
+        }
+    }
+    finish_func(funcs);
+
+    return;
+#else
+    ModuleBase::WARNING_QUIT("gcxc_libxc_batch","compile with LIBXC to use this subroutine");
+#endif
+}
+
+void XC_Functional::gcxc_spin_libxc_batch(const int n, const double* rhoup, const double* rhodw,
+        const ModuleBase::Vector3<double>* gdr1, const ModuleBase::Vector3<double>* gdr2,
+        double* sxc, double* v1xcup, double* v1xcdw, double* v2xcup, double* v2xcdw, double* v2xcud)
+{
+#ifdef USE_LIBXC
+    std::vector<double> rho(2 * n), grho(3 * n);
+    for(int i = 0; i < n; ++i)
+    {
+        rho[2 * i] = rhoup[i];
+        rho[2 * i + 1] = rhodw[i];
+        grho[3 * i] = gdr1[i].norm2();
+        grho[3 * i + 1] = gdr1[i] * gdr2[i];
+        grho[3 * i + 2] = gdr2[i].norm2();
+        sxc[i] = v1xcup[i] = v1xcdw[i] = 0.0;
+        v2xcup[i] = v2xcdw[i] = v2xcud[i] = 0.0;
+    }
+
+    const double rho_threshold = 1E-6;
+    const double grho_threshold = 1E-10;
+
+    std::vector<double> s(n), v1xc(2 * n), v2xc(3 * n);
+    std::vector<xc_func_type> funcs = init_func(XC_POLARIZED);
+    for(xc_func_type &func : funcs)
+    {
+        if( func.info->family == XC_FAMILY_GGA || func.info->family == XC_FAMILY_HYB_GGA)
+        {
+            // call Libxc function: xc_gga_exc_vxc
+            xc_gga_exc_vxc( &func, n, rho.data(), grho.data(), s.data(), v1xc.data(), v2xc.data());
+            const bool is_corr = (func.info->kind == XC_CORRELATION);
+            for(int i = 0; i < n; ++i)
+            {
+                double sgn[2] = {1.0, 1.0};
+                if(is_corr)
+                {
+                    if ( rho[2 * i] < rho_threshold || sqrt(std::abs(grho[3 * i])) < grho_threshold )
+                        sgn[0] = 0.0;
+                    if ( rho[2 * i + 1] < rho_threshold || sqrt(std::abs(grho[3 * i + 2])) < grho_threshold )
+                        sgn[1] = 0.0;
+                }
+                sxc[i] += s[i] * (rho[2 * i] * sgn[0] + rho[2 * i + 1] * sgn[1]);
+                v1xcup[i] += v1xc[2 * i] * sgn[0];
+                v1xcdw[i] += v1xc[2 * i + 1] * sgn[1];
+                v2xcup[i] += 2.0 * v2xc[3 * i] * sgn[0];
+                v2xcud[i] += v2xc[3 * i + 1] * sgn[0] * sgn[1];
+                v2xcdw[i] += 2.0 * v2xc[3 * i + 2] * sgn[1];
+            }
+        }
+    }
+    finish_func(funcs);
+
+    return;
+#else
+    ModuleBase::WARNING_QUIT("gcxc_spin_libxc_batch","compile with LIBXC to use this subroutine");
+#endif
+}
@@ -1,10 +1,13 @@
 // This file contains wrapper for the mGGA functionals
-// it includes 1 subroutine:
+// it includes 2 subroutines:
 // 1. tau_xc
+// 2. tau_xc_batch, which does the same as tau_xc on a chunk of grid points
 
 #include "xc_functional.h"
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
 
+#include <vector>
+
 //tau_xc and tau_xc_spin: interface for calling xc_mgga_exc_vxc from LIBXC
 //XC_POLARIZED, XC_UNPOLARIZED: internal flags used in LIBXC, denote the polarized(nspin=1) or unpolarized(nspin=2) calculations, definition can be found in xc.h from LIBXC
 #ifdef USE_LIBXC
@@ -40,4 +43,42 @@ void XC_Functional::tau_xc(const double &rho, const double &grho, const double &
 	return;
 }
 
+void XC_Functional::tau_xc_batch(const int n, const double* rho, const double* grho, const double* atau,
+        double* sxc, double* v1xc, double* v2xc, double* v3xc)
+{
+    std::vector<double> s(n), v1(n), v2(n), v3(n), vlapl_rho(n);
+    // same as tau_xc, the laplacian is not used by the functionals we support
+    const double* lapl_rho = grho;
+
+    for(int i = 0; i < n; ++i)
+    {
+        sxc[i] = v1xc[i] = v2xc[i] = v3xc[i] = 0.0;
+    }
+
+    std::vector<xc_func_type> funcs = init_func(XC_UNPOLARIZED);
+    for(xc_func_type &func : funcs)
+    {
+        // one libxc call for the whole chunk instead of one per point
+        xc_mgga_exc_vxc(&func, n, rho, grho, lapl_rho, atau, s.data(), v1.data(), v2.data(), vlapl_rho.data(), v3.data());
+
+        double fac = 1.0;
+#ifdef __EXX
+        if (func.info->number == XC_MGGA_X_SCAN && get_func_type() == 5)
+        {
+            fac = 1.0 - GlobalC::exx_info.info_global.hybrid_alpha;
+        }
+#endif
+        for(int i = 0; i < n; ++i)
+        {
+            sxc[i] += fac * s[i] * rho[i];
+            v2xc[i] += fac * v2[i] * 2.0;
+            v1xc[i] += fac * v1[i];
+            v3xc[i] += fac * v3[i];
+        }
+    }
+    finish_func(funcs);
+
+    return;
+}
+
 #endif
\ No newline at end of file
@@ -4,9 +4,12 @@
 // (i.e. LDA functional and LDA part of GGA functional)
 // 2. xc_spin, which is the spin polarized counterpart of xc
 // 3. xc_spin_libxc, which is the wrapper for LDA functional, spin polarized
+// 4. xc_batch and xc_spin_batch, which evaluate xc and xc_spin on a chunk of
+// grid points with the dispatch on func_id done once per chunk
 
 #include "xc_functional.h"
 #include <stdexcept>
+#include <vector>
 
 void XC_Functional::xc(const double &rho, double &exc, double &vxc)
 {
@@ -156,4 +159,168 @@ void XC_Functional::xc_spin_libxc(const double &rhoup, const double &rhodw,
 #else
     ModuleBase::WARNING_QUIT("xc_spin_libxc","compile with LIBXC to use this subroutine");
 #endif 
-}
\ No newline at end of file
+}
+void XC_Functional::xc_batch(const int n, const double* rho, double* exc, double* vxc)
+{
+    const double third = 1.0 / 3.0;
+    const double pi34 = 0.6203504908994e0 ; // pi34=(3/4pi)^(1/3)
+
+    std::vector<double> rs(n);
+    for(int i = 0; i < n; ++i)
+    {
+        rs[i] = pi34 / std::pow(rho[i], third);
+        exc[i] = vxc[i] = 0.0;
+    }
+
+    // slater exchange with alpha=2/3, see XC_Functional::slater
+    const double fs = -0.687247939924714e0 * 2.0 / 3.0;
+
+    for(int id : func_id)
+    {
+        double e, v;
+        switch( id )
+        {
+            // Exchange functionals containing slater exchange
+            case XC_LDA_X: case XC_GGA_X_PBE: case XC_GGA_X_PBE_R: case XC_GGA_X_PBE_SOL:
+            case XC_GGA_X_WC: case XC_GGA_X_B88: case XC_GGA_X_PW91:
+            //  SLA,PBX,rPBX,PBXsol,WC,B88,PW91_X
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+                for(int i = 0; i < n; ++i)
+                {
+                    exc[i] += fs / rs[i];
+                    vxc[i] += 4.0 / 3.0 * fs / rs[i];
+                }
+                break;
+
+            // Exchange functionals containing attenuated slater exchange
+            case XC_HYB_GGA_XC_PBEH:
+            //  PBE0
+            {
+                const double fx = fs * (1.0 - XC_Functional::hybrid_alpha);
+                for(int i = 0; i < n; ++i)
+                {
+                    XC_Functional::pw(rs[i], 0, e, v);
+                    exc[i] += fx / rs[i] + e;
+                    vxc[i] += 4.0 / 3.0 * fx / rs[i] + v;
+                }
+                break;
+            }
+
+            // Correlation functionals containing PW correlation
+            case XC_GGA_C_PBE: case XC_GGA_C_PW91: case XC_LDA_C_PW: case XC_GGA_C_PBE_SOL:
+            //   PBC,PW91,PWLDA
+                for(int i = 0; i < n; ++i)
+                {
+                    XC_Functional::pw(rs[i], 0, e, v);
+                    exc[i] += e;
+                    vxc[i] += v;
+                }
+                break;
+
+            // Correlation functionals containing PZ correlation
+            case XC_LDA_C_PZ: case XC_GGA_C_P86:
+            //  PZ,P86
+                for(int i = 0; i < n; ++i)
+                {
+                    XC_Functional::pz(rs[i], 0, e, v);
+                    exc[i] += e;
+                    vxc[i] += v;
+                }
+                break;
+
+            // Correlation functionals containing LYP correlation
+            case XC_GGA_C_LYP:
+            //  BLYP
+                for(int i = 0; i < n; ++i)
+                {
+                    XC_Functional::lyp(rs[i], e, v);
+                    exc[i] += e;
+                    vxc[i] += v;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+    return;
+}
+
+void XC_Functional::xc_spin_batch(const int n, const double* rho, const double* zeta,
+        double* exc, double* vxcup, double* vxcdw)
+{
+	static const double third = 1.0 / 3.0;
+	static const double pi34 = 0.62035049089940;
+
+    std::vector<double> rs(n);
+    for(int i = 0; i < n; ++i)
+    {
+        rs[i] = pi34 / pow(rho[i], third);//wigner_sitz_radius;
+        exc[i] = vxcup[i] = vxcdw[i] = 0.0;
+    }
+
+    for(int id : func_id)
+    {
+        double e, vup, vdw;
+        switch( id )
+        {
+            // Exchange functionals containing slater exchange
+            case XC_LDA_X: case XC_GGA_X_PBE: case XC_GGA_X_PBE_R: case XC_GGA_X_PBE_SOL:
+            case XC_GGA_X_WC: case XC_GGA_X_B88: case XC_GGA_X_PW91:
+            //  SLA,PBX,rPBX,PBXsol,WC,B88,PW91_X
+                for(int i = 0; i < n; ++i)
+                {
+                    XC_Functional::slater_spin(rho[i], zeta[i], e, vup, vdw);
+                    exc[i] += e;
+                    vxcup[i] += vup;
+                    vxcdw[i] += vdw;
+                }
+                break;
+
+            // Exchange functionals containing attenuated slater exchange
+            case XC_HYB_GGA_XC_PBEH:
+            //  PBE0
+                for(int i = 0; i < n; ++i)
+                {
+                    double ex, vupx, vdwx;
+                    XC_Functional::slater_spin(rho[i], zeta[i], ex, vupx, vdwx);
+                    XC_Functional::pw_spin(rs[i], zeta[i], e, vup, vdw);
+                    exc[i] += ex * (1.0 - XC_Functional::hybrid_alpha) + e;
+                    vxcup[i] += vupx * (1.0 - XC_Functional::hybrid_alpha) + vup;
+                    vxcdw[i] += vdwx * (1.0 - XC_Functional::hybrid_alpha) + vdw;
+                }
+                break;
+
+            // Correlation functionals containing PZ correlation
+            case XC_LDA_C_PZ: case XC_GGA_C_P86:
+            //  PZ,P86
+                for(int i = 0; i < n; ++i)
+                {
+                    XC_Functional::pz_spin(rs[i], zeta[i], e, vup, vdw);
+                    exc[i] += e;
+                    vxcup[i] += vup;
+                    vxcdw[i] += vdw;
+                }
+                break;
+
+            // Correlation functionals containing PW correlation
+            case XC_GGA_C_PBE: case XC_GGA_C_PBE_SOL:
+            //   PBC,PBCsol
+                for(int i = 0; i < n; ++i)
+                {
+                    XC_Functional::pw_spin(rs[i], zeta[i], e, vup, vdw);
+                    exc[i] += e;
+                    vxcup[i] += vup;
+                    vxcdw[i] += vdw;
+                }
+                break;
+
+            // Cases that are only realized in LIBXC
+            default:
+                throw std::domain_error("functional unfinished in "+ModuleBase::GlobalFunc::TO_STRING(__FILE__)+" line "+ModuleBase::GlobalFunc::TO_STRING(__LINE__));	break;
+        }
+    }
+    return;
+}
@@ -0,0 +1,205 @@
+#ifdef __MPI
+#include "mpi.h"
+#include "module_base/parallel_global.h"
+#endif
+#include "gtest/gtest.h"
+#include "../module_ewald/ewald_spme.h"
+#include "module_base/constants.h"
+#include "module_base/global_variable.h"
+
+#include <cmath>
+
+/************************************************
+ *  unit test of ewald_spme.cpp
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - Ewald_SPME::compute
+ *     - the energy agrees with a converged direct Ewald sum
+ *     - the forces and the stress agree with the finite differences of the direct Ewald energy
+ *     - a tighter tol gives a smaller error
+ */
+
+class EwaldSPMETest : public ::testing::Test
+{
+  protected:
+    double lat0 = 2.0;
+    ModuleBase::Matrix3 latvec;
+    std::vector<ModuleBase::Vector3<double>> tau;
+    std::vector<double> zv;
+
+    void SetUp() override
+    {
+        // a triclinic cell of 8 ions with different charges
+        latvec = ModuleBase::Matrix3(4.1, 0.2, 0.0, 0.5, 3.8, 0.1, -0.3, 0.4, 4.4);
+        const double frac[8][3] = {{0.0, 0.0, 0.0},
+                                   {0.52, 0.48, 0.03},
+                                   {0.47, 0.02, 0.55},
+                                   {0.05, 0.51, 0.46},
+                                   {0.26, 0.23, 0.27},
+                                   {0.74, 0.77, 0.22},
+                                   {0.71, 0.28, 0.76},
+                                   {0.22, 0.73, 0.71}};
+        const double charge[8] = {4.0, 4.0, 6.0, 6.0, 1.0, 1.0, 3.0, 3.0};
+        for (int i = 0; i < 8; ++i)
+        {
+            tau.push_back(ModuleBase::Vector3<double>(frac[i][0], frac[i][1], frac[i][2]) * latvec);
+            zv.push_back(charge[i]);
+        }
+    }
+
+    // direct Ewald sum with generous cutoffs
+    double ewald_direct(const ModuleBase::Matrix3& lv, const std::vector<ModuleBase::Vector3<double>>& pos) const
+    {
+        const double omega = std::abs(lv.Det()) * std::pow(lat0, 3);
+        const double alpha = 0.5;
+        const double sqa = std::sqrt(alpha);
+        const ModuleBase::Matrix3 g = lv.Inverse().Transpose();
+        const int nr = 3;
+        const int ng = 12;
+        double charge = 0.0, charge2 = 0.0;
+        for (const double z: zv)
+        {
+            charge += z;
+            charge2 += z * z;
+        }
+        double er = 0.0, eg = 0.0;
+        for (int i = 0; i < pos.size(); ++i)
+        {
+            for (int j = 0; j < pos.size(); ++j)
+            {
+                for (int n1 = -nr; n1 <= nr; ++n1)
+                {
+                    for (int n2 = -nr; n2 <= nr; ++n2)
+                    {
+                        for (int n3 = -nr; n3 <= nr; ++n3)
+                        {
+                            const ModuleBase::Vector3<double> r
+                                = (pos[j] - pos[i] + ModuleBase::Vector3<double>(n1, n2, n3) * lv) * lat0;
+                            const double rr = r.norm();
+                            if (rr > 1e-8 && rr < 10.0)
+                            {
+                                er += 0.5 * zv[i] * zv[j] * std::erfc(sqa * rr) / rr;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        for (int m1 = -ng; m1 <= ng; ++m1)
+        {
+            for (int m2 = -ng; m2 <= ng; ++m2)
+            {
+                for (int m3 = -ng; m3 <= ng; ++m3)
+                {
+                    const ModuleBase::Vector3<double> gv
+                        = ModuleBase::Vector3<double>(m1, m2, m3) * g * (ModuleBase::TWO_PI / lat0);
+                    const double g2 = gv.norm2();
+                    if (g2 < 1e-8)
+                    {
+                        continue;
+                    }
+                    std::complex<double> s = 0.0;
+                    for (int i = 0; i < pos.size(); ++i)
+                    {
+                        s += zv[i] * std::exp(std::complex<double>(0.0, gv * pos[i] * lat0));
+                    }
+                    eg += ModuleBase::TWO_PI / omega * std::exp(-g2 / 4.0 / alpha) / g2 * std::norm(s);
+                }
+            }
+        }
+        return ModuleBase::e2
+               * (er + eg - sqa / std::sqrt(ModuleBase::PI) * charge2
+                  - 0.5 * ModuleBase::PI * charge * charge / omega / alpha);
+    }
+};
+
+TEST_F(EwaldSPMETest, Energy)
+{
+    const double eref = ewald_direct(latvec, tau);
+    Ewald_SPME spme;
+    double error = 0.0;
+    for (const double tol: {1e-5, 1e-8})
+    {
+        spme.set_parameters(tol);
+        const double e = spme.compute(lat0, latvec, tau, zv, nullptr, nullptr);
+        EXPECT_NEAR(e, eref, 1e2 * tol * std::abs(eref));
+        if (tol < 1e-5)
+        {
+            EXPECT_LT(std::abs(e - eref), error);
+        }
+        error = std::abs(e - eref);
+    }
+}
+
+TEST_F(EwaldSPMETest, ForceStress)
+{
+    Ewald_SPME spme;
+    spme.set_parameters(1e-8);
+    ModuleBase::matrix force, sigma;
+    spme.compute(lat0, latvec, tau, zv, &force, &sigma);
+
+    const double h = 1e-4;
+    double fmax = 0.0;
+    for (int iat = 0; iat < tau.size(); ++iat)
+    {
+        for (int l = 0; l < 3; ++l)
+        {
+            std::vector<ModuleBase::Vector3<double>> pos = tau;
+            pos[iat][l] += h / lat0;
+            const double ep = ewald_direct(latvec, pos);
+            pos[iat][l] -= 2.0 * h / lat0;
+            const double em = ewald_direct(latvec, pos);
+            const double fref = -(ep - em) / 2.0 / h;
+            EXPECT_NEAR(force(iat, l), fref, 1e-5);
+            fmax = std::max(fmax, std::abs(fref));
+        }
+    }
+    EXPECT_GT(fmax, 0.1);
+
+    // sigma = -1/omega dE/d(strain)
+    const double omega = std::abs(latvec.Det()) * std::pow(lat0, 3);
+    for (int l = 0; l < 3; ++l)
+    {
+        for (int m = 0; m < 3; ++m)
+        {
+            double e[2];
+            for (int s = 0; s < 2; ++s)
+            {
+                double d[9] = {1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0};
+                d[3 * l + m] += (s == 0) ? h : -h;
+                const ModuleBase::Matrix3 strain(d[0], d[1], d[2], d[3], d[4], d[5], d[6], d[7], d[8]);
+                std::vector<ModuleBase::Vector3<double>> pos = tau;
+                for (auto& p: pos)
+                {
+                    p = p * strain;
+                }
+                e[s] = ewald_direct(latvec * strain, pos);
+            }
+            const double sref = -(e[0] - e[1]) / 2.0 / h / omega;
+            EXPECT_NEAR(sigma(l, m), sref, 1e-7);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &GlobalV::NPROC);
+    MPI_Comm_rank(MPI_COMM_WORLD, &GlobalV::MY_RANK);
+    MPI_Comm_split(MPI_COMM_WORLD, 0, 1, &POOL_WORLD);
+    GlobalV::NPROC_IN_POOL = GlobalV::NPROC;
+    GlobalV::RANK_IN_POOL = GlobalV::MY_RANK;
+#endif
+
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+
+    return result;
+}
@@ -2,6 +2,7 @@
 #include "module_base/timer.h"
 #include "module_base/tool_title.h"
 #include "module_hsolver/hsolver_lcao.h"
+#include "module_hsolver/diago_blas.h"
 #include "module_hamilt_lcao/module_hcontainer/hcontainer_funcs.h"
 
 #ifdef __ELPA
@@ -28,6 +29,10 @@ void OperatorLCAO<double, double>::get_hs_pointers()
 #ifdef __ELPA
         hsolver::DiagoElpa::DecomposedState = 0;
 #endif
+        if (this->new_e_iteration)
+        {
+            hsolver::DiagoBlas::s_changed = true;
+        }
         this->new_e_iteration = false;
     }
     ModuleBase::timer::tick("OperatorLCAO", "get_hs_pointers");
@@ -38,6 +43,15 @@ void OperatorLCAO<std::complex<double>, double>::get_hs_pointers()
 {
     this->hmatrix_k = this->LM->Hloc2.data();
     this->smatrix_k = this->LM->Sloc2.data();
+    // a new Hamiltonian is built for new atomic positions, decomposed S(k) in diagonalizers are out of date
+    if (this->new_e_iteration)
+    {
+        hsolver::DiagoBlas::s_changed = true;
+#ifdef __ELPA
+        hsolver::DiagoElpa::s_changed = true;
+#endif
+        this->new_e_iteration = false;
+    }
 }
 
 template<>
@@ -45,6 +59,14 @@ void OperatorLCAO<std::complex<double>, std::complex<double>>::get_hs_pointers()
 {
     this->hmatrix_k = this->LM->Hloc2.data();
     this->smatrix_k = this->LM->Sloc2.data();
+    if (this->new_e_iteration)
+    {
+        hsolver::DiagoBlas::s_changed = true;
+#ifdef __ELPA
+        hsolver::DiagoElpa::s_changed = true;
+#endif
+        this->new_e_iteration = false;
+    }
 }
 
 template<>
@@ -154,30 +154,54 @@ void hamilt::OverlapNew<hamilt::OperatorLCAO<TK, TR>>::cal_SR_IJR(const int& iat
     auto row_indexes = paraV->get_indexes_row(iat1);
     auto col_indexes = paraV->get_indexes_col(iat2);
     const int step_trace = col_indexes.size() + 1;
+#ifdef USE_NEW_TWO_CENTER
+    // all orbital pairs of this atom pair share dtau, so they are evaluated in one batch
+    const int npair = row_indexes.size() / npol * (col_indexes.size() / npol);
+    std::vector<int> T1_batch(npair, T1), L1_batch(npair), N1_batch(npair), M1_batch(npair);
+    std::vector<int> T2_batch(npair, T2), L2_batch(npair), N2_batch(npair), M2_batch(npair);
+    std::vector<ModuleBase::Vector3<double>> dtau_batch(npair, dtau * this->ucell->lat0);
+    int ipair = 0;
     for (int iw1l = 0; iw1l < row_indexes.size(); iw1l += npol)
     {
         const int iw1 = row_indexes[iw1l] / npol;
-        const int L1 = iw2l1[iw1];
-        const int N1 = iw2n1[iw1];
-        const int m1 = iw2m1[iw1];
-#ifdef USE_NEW_TWO_CENTER
-        int M1 = (m1 % 2 == 0) ? -m1/2 : (m1+1)/2;
-#endif
         for (int iw2l = 0; iw2l < col_indexes.size(); iw2l += npol)
         {
             const int iw2 = col_indexes[iw2l] / npol;
-            const int L2 = iw2l2[iw2];
-            const int N2 = iw2n2[iw2];
-            const int m2 = iw2m2[iw2];
+            L1_batch[ipair] = iw2l1[iw1];
+            N1_batch[ipair] = iw2n1[iw1];
+            L2_batch[ipair] = iw2l2[iw2];
+            N2_batch[ipair] = iw2n2[iw2];
+            // convert m (0,1,...2l) to M (-l, -l+1, ..., l-1, l)
+            M1_batch[ipair] = (iw2m1[iw1] % 2 == 0) ? -iw2m1[iw1] / 2 : (iw2m1[iw1] + 1) / 2;
+            M2_batch[ipair] = (iw2m2[iw2] % 2 == 0) ? -iw2m2[iw2] / 2 : (iw2m2[iw2] + 1) / 2;
+            ++ipair;
+        }
+    }
+    std::vector<double> olm_batch(npair);
+    uot.two_center_bundle->overlap_orb->calculate(npair,
+                    T1_batch.data(), L1_batch.data(), N1_batch.data(), M1_batch.data(),
+                    T2_batch.data(), L2_batch.data(), N2_batch.data(), M2_batch.data(),
+                    dtau_batch.data(), olm_batch.data());
+    ipair = 0;
+#endif
+    for (int iw1l = 0; iw1l < row_indexes.size(); iw1l += npol)
+    {
+        for (int iw2l = 0; iw2l < col_indexes.size(); iw2l += npol)
+        {
 #ifdef USE_NEW_TWO_CENTER
             //=================================================================
             //          new two-center integral (temporary)
             //=================================================================
-            // convert m (0,1,...2l) to M (-l, -l+1, ..., l-1, l)
-            int M2 = (m2 % 2 == 0) ? -m2/2 : (m2+1)/2;
-            uot.two_center_bundle->overlap_orb->calculate(T1, L1, N1, M1,
-                    T2, L2, N2, M2, dtau * this->ucell->lat0, olm);
+            olm[0] = olm_batch[ipair++];
 #else
+            const int iw1 = row_indexes[iw1l] / npol;
+            const int L1 = iw2l1[iw1];
+            const int N1 = iw2n1[iw1];
+            const int m1 = iw2m1[iw1];
+            const int iw2 = col_indexes[iw2l] / npol;
+            const int L2 = iw2l2[iw2];
+            const int N2 = iw2n2[iw2];
+            const int m2 = iw2m2[iw2];
             uot.snap_psipsi(orb, // orbitals
                             olm,
                             0,
@@ -106,12 +106,13 @@ private:
 
     // projected density matrix
 	double** pdm;	//[tot_Inl][2l+1][2l+1]	caoyu modified 2021-05-07
+	//pdm of all atoms packed for each projector shell, [nlmax][natom][2l+1][2l+1]
 	std::vector<torch::Tensor> pdm_tensor;
 
-	// descriptors
-	std::vector<torch::Tensor> d_tensor;
+	// descriptors, [natom][des_per_atom]
+	torch::Tensor d_tensor;
 
-	//gedm:dE/dD, [tot_Inl][2l+1][2l+1]	(E: Hartree)
+	//gedm:dE/dD, [nlmax][natom][2l+1][2l+1]	(E: Hartree)
 	std::vector<torch::Tensor> gedm_tensor;
 
 	//gdmx: dD/dX		\sum_{mu,nu} 2*c_mu*c_nu * <dpsi_mu/dx|alpha_m><alpha_m'|psi_nu>
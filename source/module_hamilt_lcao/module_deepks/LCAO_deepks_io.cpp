@@ -65,15 +65,9 @@ void LCAO_Deepks::save_npy_d(const int nat)
     ModuleBase::TITLE("LCAO_Deepks", "save_npy_d");
     if(GlobalV::MY_RANK!=0) return;
     //save descriptor in .npy format
-    vector<double> npy_des;
-    for (int inl = 0;inl < inlmax;++inl)
-    {
-        int nm = 2*inl_l[inl] + 1;
-        for(int im=0;im<nm;im++)
-        {
-            npy_des.push_back(this->d_tensor[inl].index({im}).item().toDouble());
-        }
-    }
+    //d_tensor is nat*des_per_atom, already in the order of dm_eig.npy
+    const torch::Tensor d = this->d_tensor.detach().contiguous();
+    vector<double> npy_des(d.data_ptr<double>(), d.data_ptr<double>() + nat * this->des_per_atom);
     const long unsigned dshape[] = {static_cast<unsigned long>(nat), static_cast<unsigned long>(this->des_per_atom)};
     if (GlobalV::MY_RANK == 0)
     {
@@ -91,20 +85,8 @@ void LCAO_Deepks::save_npy_gvx(const int nat)
     //unit: /Bohr
     const long unsigned gshape[]
         = {static_cast<unsigned long>(nat), 3UL, static_cast<unsigned long>(nat), static_cast<unsigned long>(this->des_per_atom)};
-    vector<double> npy_gvx;
-    for (int ibt = 0;ibt < nat;++ibt)
-    {
-        for (int i = 0;i < 3;i++)
-        {
-            for (int iat = 0;iat < nat;++iat)
-            {
-                for(int p=0;p<this->des_per_atom;++p)
-                {
-                    npy_gvx.push_back(this->gvx_tensor.index({ ibt, i, iat, p }).item().toDouble());
-                }
-            }
-        }
-    }
+    const torch::Tensor gvx = this->gvx_tensor.contiguous();
+    vector<double> npy_gvx(gvx.data_ptr<double>(), gvx.data_ptr<double>() + gvx.numel());
     npy::SaveArrayAsNumpy("grad_vx.npy", false, 4, gshape, npy_gvx);
     return;
 }
@@ -117,19 +99,8 @@ void LCAO_Deepks::save_npy_gvepsl(const int nat)
     //save grad_vepsl.npy (when  stress label is in use)
     //unit: none
     const long unsigned gshape[] = {6UL, static_cast<unsigned long>(nat), static_cast<unsigned long>(this->des_per_atom)};
-    vector<double> npy_gvepsl;
-    for (int i = 0;i < 6;i++)
-    {
-        for (int ibt = 0;ibt < nat;++ibt)
-        {
-
-            for(int p=0;p<this->des_per_atom;++p)
-            {
-                npy_gvepsl.push_back(this->gvepsl_tensor.index({ i, ibt, p }).item().toDouble());
-            }
-
-        }
-    }
+    const torch::Tensor gvepsl = this->gvepsl_tensor.contiguous();
+    vector<double> npy_gvepsl(gvepsl.data_ptr<double>(), gvepsl.data_ptr<double>() + gvepsl.numel());
     npy::SaveArrayAsNumpy("grad_vepsl.npy", false, 3, gshape, npy_gvepsl);
     return;
 }
@@ -217,20 +188,9 @@ void LCAO_Deepks::save_npy_orbital_precalc(const int nat, const int nks)
                                     1,
                                     static_cast<unsigned long>(nat),
                                     static_cast<unsigned long>(this->des_per_atom)};
-    vector<double> npy_orbital_precalc;
-    for (int iks = 0; iks < nks; ++iks)
-    {
-        for (int hl = 0; hl < 1; ++hl)
-        {
-            for (int iat = 0;iat < nat;++iat)
-            {
-                for(int p=0; p<this->des_per_atom; ++p)
-                {
-                    npy_orbital_precalc.push_back(this->orbital_precalc_tensor.index({iks, hl, iat, p }).item().toDouble());
-                }
-            }
-        }
-    }
+    const torch::Tensor orbital_precalc = this->orbital_precalc_tensor.contiguous();
+    vector<double> npy_orbital_precalc(orbital_precalc.data_ptr<double>(),
+                                       orbital_precalc.data_ptr<double>() + orbital_precalc.numel());
     npy::SaveArrayAsNumpy("orbital_precalc.npy", false, 4, gshape, npy_orbital_precalc);
     return;
 }
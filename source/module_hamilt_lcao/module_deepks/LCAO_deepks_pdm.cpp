@@ -65,92 +65,95 @@ void LCAO_Deepks::cal_projected_DM(const std::vector<std::vector<double>>& dm,
     }
 
     const double Rcut_Alpha = orb.Alpha[0].getRcut();
+    // the neighbours of all atoms are searched beforehand, so that the atoms can be processed in parallel;
+    // each atom only writes the blocks of its own projectors
+    const std::vector<AdjacentAtomInfo> adjs_all = GridD.get_adjs(ucell);
     int nrow = this->pv->nrow;
-    for (int T0 = 0; T0 < ucell.ntype; T0++)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int iat = 0; iat < ucell.nat; iat++)
     {
-		Atom* atom0 = &ucell.atoms[T0]; 
-        for (int I0 =0; I0< atom0->na; I0++)
+        const int T0 = ucell.iat2it[iat];
+        const int I0 = ucell.iat2ia[iat];
+        const ModuleBase::Vector3<double> tau0 = ucell.atoms[T0].tau[I0];
+        const AdjacentAtomInfo& adjs = adjs_all[iat];
+
+        for (int ad1=0; ad1<adjs.adj_num+1 ; ++ad1)
         {
-            const int iat = ucell.itia2iat(T0,I0);
-            const ModuleBase::Vector3<double> tau0 = atom0->tau[I0];
-            GridD.Find_atom(ucell, atom0->tau[I0] ,T0, I0);
+            const int T1 = adjs.ntype[ad1];
+            const int I1 = adjs.natom[ad1];
+            const int start1 = ucell.itiaiw2iwt(T1, I1, 0);
+            const ModuleBase::Vector3<double> tau1 = adjs.adjacent_tau[ad1];
+			const Atom* atom1 = &ucell.atoms[T1];
+			const int nw1_tot = atom1->nw*GlobalV::NPOL;
+			const double Rcut_AO1 = orb.Phi[T1].getRcut(); 
+
+			for (int ad2=0; ad2 < adjs.adj_num+1 ; ad2++)
+			{
+				const int T2 = adjs.ntype[ad2];
+				const int I2 = adjs.natom[ad2];
+				const int start2 = ucell.itiaiw2iwt(T2, I2, 0);
+				const ModuleBase::Vector3<double> tau2 = adjs.adjacent_tau[ad2];
+				const Atom* atom2 = &ucell.atoms[T2];
+				const int nw2_tot = atom2->nw*GlobalV::NPOL;
+				
+				const double Rcut_AO2 = orb.Phi[T2].getRcut();
+            	const double dist1 = (tau1-tau0).norm() * ucell.lat0;
+            	const double dist2 = (tau2-tau0).norm() * ucell.lat0;
+
+				if (dist1 > Rcut_Alpha + Rcut_AO1
+						|| dist2 > Rcut_Alpha + Rcut_AO2)
+				{
+					continue;
+				}
 
-            for (int ad1=0; ad1<GridD.getAdjacentNum()+1 ; ++ad1)
-            {
-                const int T1 = GridD.getType(ad1);
-                const int I1 = GridD.getNatom(ad1);
-                const int start1 = ucell.itiaiw2iwt(T1, I1, 0);
-                const ModuleBase::Vector3<double> tau1 = GridD.getAdjacentTau(ad1);
-				const Atom* atom1 = &ucell.atoms[T1];
-				const int nw1_tot = atom1->nw*GlobalV::NPOL;
-				const double Rcut_AO1 = orb.Phi[T1].getRcut(); 
-
-				for (int ad2=0; ad2 < GridD.getAdjacentNum()+1 ; ad2++)
+				for (int iw1=0; iw1<nw1_tot; ++iw1)
 				{
-					const int T2 = GridD.getType(ad2);
-					const int I2 = GridD.getNatom(ad2);
-					const int start2 = ucell.itiaiw2iwt(T2, I2, 0);
-					const ModuleBase::Vector3<double> tau2 = GridD.getAdjacentTau(ad2);
-					const Atom* atom2 = &ucell.atoms[T2];
-					const int nw2_tot = atom2->nw*GlobalV::NPOL;
-					
-					const double Rcut_AO2 = orb.Phi[T2].getRcut();
-                	const double dist1 = (tau1-tau0).norm() * ucell.lat0;
-                	const double dist2 = (tau2-tau0).norm() * ucell.lat0;
-
-					if (dist1 > Rcut_Alpha + Rcut_AO1
-							|| dist2 > Rcut_Alpha + Rcut_AO2)
-					{
-						continue;
-					}
+					const int iw1_all = start1 + iw1;
+                    const int iw1_local = pv->global2local_col(iw1_all);
+					if(iw1_local < 0)continue;
+					const int iw1_0 = iw1/GlobalV::NPOL;
 
-					for (int iw1=0; iw1<nw1_tot; ++iw1)
+					for (int iw2=0; iw2<nw2_tot; ++iw2)
 					{
-						const int iw1_all = start1 + iw1;
-                        const int iw1_local = pv->global2local_col(iw1_all);
-						if(iw1_local < 0)continue;
-						const int iw1_0 = iw1/GlobalV::NPOL;
-
-						for (int iw2=0; iw2<nw2_tot; ++iw2)
-						{
-							const int iw2_all = start2 + iw2;
-                            const int iw2_local = pv->global2local_row(iw2_all);
-							if(iw2_local < 0)continue;
-							const int iw2_0 = iw2/GlobalV::NPOL;
-
-                            std::vector<double> nlm1 = this->nlm_save[iat][ad1][iw1_all][0];
-                            std::vector<double> nlm2 = this->nlm_save[iat][ad2][iw2_all][0];
-                            assert(nlm1.size()==nlm2.size());
-
-                            int ib=0;
-                            for (int L0 = 0; L0 <= orb.Alpha[0].getLmax();++L0)
+						const int iw2_all = start2 + iw2;
+                        const int iw2_local = pv->global2local_row(iw2_all);
+						if(iw2_local < 0)continue;
+						const int iw2_0 = iw2/GlobalV::NPOL;
+
+                        const std::vector<double>& nlm1 = this->nlm_save[iat][ad1][iw1_all][0];
+                        const std::vector<double>& nlm2 = this->nlm_save[iat][ad2][iw2_all][0];
+                        assert(nlm1.size()==nlm2.size());
+
+                        int ib=0;
+                        for (int L0 = 0; L0 <= orb.Alpha[0].getLmax();++L0)
+                        {
+                            for (int N0 = 0;N0 < orb.Alpha[0].getNchi(L0);++N0)
                             {
-                                for (int N0 = 0;N0 < orb.Alpha[0].getNchi(L0);++N0)
+                                const int inl = this->inl_index[T0](I0, L0, N0);
+                                const int nm = 2*L0+1;
+                                for (int m1 = 0;m1 < 2 * L0 + 1;++m1)
                                 {
-                                    const int inl = this->inl_index[T0](I0, L0, N0);
-                                    const int nm = 2*L0+1;
-                                    for (int m1 = 0;m1 < 2 * L0 + 1;++m1)
+                                    for (int m2 = 0; m2 < 2 * L0 + 1; ++m2)
                                     {
-                                        for (int m2 = 0; m2 < 2 * L0 + 1; ++m2)
+                                        int ind = m1*nm + m2;
+                                        for(int is = 0; is < dm.size(); ++is)
                                         {
-                                            int ind = m1*nm + m2;
-                                            for(int is = 0; is < dm.size(); ++is)
-                                            {
-                                                //pdm[inl][ind] += dm[is](iw1_local, iw2_local)*nlm1[ib+m1]*nlm2[ib+m2];
-                                                pdm[inl][ind] += dm[is][iw1_local * nrow + iw2_local]*nlm1[ib+m1]*nlm2[ib+m2];
-                                            }
+                                            //pdm[inl][ind] += dm[is](iw1_local, iw2_local)*nlm1[ib+m1]*nlm2[ib+m2];
+                                            pdm[inl][ind] += dm[is][iw1_local * nrow + iw2_local]*nlm1[ib+m1]*nlm2[ib+m2];
                                         }
                                     }
-                                    ib+=nm;
                                 }
+                                ib+=nm;
                             }
-                            assert(ib==nlm1.size());               
-						}//iw2
-					}//iw1
-				}//ad2
-			}//ad1
-        }//I0
-    }//T0
+                        }
+                        assert(ib==nlm1.size());               
+					}//iw2
+				}//iw1
+			}//ad2
+		}//ad1
+    }//iat
 
 #ifdef __MPI
     allsum_deepks(this->inlmax,pdm_size,this->pdm);
@@ -202,105 +205,106 @@ void LCAO_Deepks::cal_projected_DM_k(const std::vector<std::vector<std::complex<
     }
 
     const double Rcut_Alpha = orb.Alpha[0].getRcut();
+    const std::vector<AdjacentAtomInfo> adjs_all = GridD.get_adjs(ucell);
     int nrow = this->pv->nrow;
-    for (int T0 = 0; T0 < ucell.ntype; T0++)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int iat = 0; iat < ucell.nat; iat++)
     {
-		Atom* atom0 = &ucell.atoms[T0]; 
-        for (int I0 =0; I0< atom0->na; I0++)
-        {
-            const int iat = ucell.itia2iat(T0,I0);
-            const ModuleBase::Vector3<double> tau0 = atom0->tau[I0];
-            GridD.Find_atom(ucell, atom0->tau[I0] ,T0, I0);
+        const int T0 = ucell.iat2it[iat];
+        const int I0 = ucell.iat2ia[iat];
+        const ModuleBase::Vector3<double> tau0 = ucell.atoms[T0].tau[I0];
+        const AdjacentAtomInfo& adjs = adjs_all[iat];
 
-            for (int ad1=0; ad1<GridD.getAdjacentNum()+1 ; ++ad1)
-            {
-                const int T1 = GridD.getType(ad1);
-                const int I1 = GridD.getNatom(ad1);
-                const int ibt1 = ucell.itia2iat(T1,I1);
-                const int start1 = ucell.itiaiw2iwt(T1, I1, 0);
-                const ModuleBase::Vector3<double> tau1 = GridD.getAdjacentTau(ad1);
-				const Atom* atom1 = &ucell.atoms[T1];
-				const int nw1_tot = atom1->nw*GlobalV::NPOL;
-				const double Rcut_AO1 = orb.Phi[T1].getRcut();
-
-                ModuleBase::Vector3<double> dR1(GridD.getBox(ad1).x, GridD.getBox(ad1).y, GridD.getBox(ad1).z); 
-
-				for (int ad2=0; ad2 < GridD.getAdjacentNum()+1 ; ad2++)
+        for (int ad1=0; ad1<adjs.adj_num+1 ; ++ad1)
+        {
+            const int T1 = adjs.ntype[ad1];
+            const int I1 = adjs.natom[ad1];
+            const int ibt1 = ucell.itia2iat(T1,I1);
+            const int start1 = ucell.itiaiw2iwt(T1, I1, 0);
+            const ModuleBase::Vector3<double> tau1 = adjs.adjacent_tau[ad1];
+			const Atom* atom1 = &ucell.atoms[T1];
+			const int nw1_tot = atom1->nw*GlobalV::NPOL;
+			const double Rcut_AO1 = orb.Phi[T1].getRcut();
+
+            ModuleBase::Vector3<double> dR1(adjs.box[ad1].x, adjs.box[ad1].y, adjs.box[ad1].z); 
+
+			for (int ad2=0; ad2 < adjs.adj_num+1 ; ad2++)
+			{
+				const int T2 = adjs.ntype[ad2];
+				const int I2 = adjs.natom[ad2];
+                const int ibt2 = ucell.itia2iat(T2,I2);
+				const int start2 = ucell.itiaiw2iwt(T2, I2, 0);
+				const ModuleBase::Vector3<double> tau2 = adjs.adjacent_tau[ad2];
+				const Atom* atom2 = &ucell.atoms[T2];
+				const int nw2_tot = atom2->nw*GlobalV::NPOL;
+                ModuleBase::Vector3<double> dR2(adjs.box[ad2].x, adjs.box[ad2].y, adjs.box[ad2].z);
+				
+				const double Rcut_AO2 = orb.Phi[T2].getRcut();
+            	const double dist1 = (tau1-tau0).norm() * ucell.lat0;
+            	const double dist2 = (tau2-tau0).norm() * ucell.lat0;
+
+				if (dist1 > Rcut_Alpha + Rcut_AO1
+						|| dist2 > Rcut_Alpha + Rcut_AO2)
 				{
-					const int T2 = GridD.getType(ad2);
-					const int I2 = GridD.getNatom(ad2);
-                    const int ibt2 = ucell.itia2iat(T2,I2);
-					const int start2 = ucell.itiaiw2iwt(T2, I2, 0);
-					const ModuleBase::Vector3<double> tau2 = GridD.getAdjacentTau(ad2);
-					const Atom* atom2 = &ucell.atoms[T2];
-					const int nw2_tot = atom2->nw*GlobalV::NPOL;
-                    ModuleBase::Vector3<double> dR2(GridD.getBox(ad2).x, GridD.getBox(ad2).y, GridD.getBox(ad2).z);
-					
-					const double Rcut_AO2 = orb.Phi[T2].getRcut();
-                	const double dist1 = (tau1-tau0).norm() * ucell.lat0;
-                	const double dist2 = (tau2-tau0).norm() * ucell.lat0;
-
-					if (dist1 > Rcut_Alpha + Rcut_AO1
-							|| dist2 > Rcut_Alpha + Rcut_AO2)
-					{
-						continue;
-					}
+					continue;
+				}
 
-					for (int iw1=0; iw1<nw1_tot; ++iw1)
+				for (int iw1=0; iw1<nw1_tot; ++iw1)
+				{
+					const int iw1_all = start1 + iw1;
+                    const int iw1_local = pv->global2local_col(iw1_all);
+					if(iw1_local < 0)continue;
+					const int iw1_0 = iw1/GlobalV::NPOL;
+					for (int iw2=0; iw2<nw2_tot; ++iw2)
 					{
-						const int iw1_all = start1 + iw1;
-                        const int iw1_local = pv->global2local_col(iw1_all);
-						if(iw1_local < 0)continue;
-						const int iw1_0 = iw1/GlobalV::NPOL;
-						for (int iw2=0; iw2<nw2_tot; ++iw2)
-						{
-							const int iw2_all = start2 + iw2;
-                            const int iw2_local = pv->global2local_row(iw2_all);
-							if(iw2_local < 0)continue;
-							const int iw2_0 = iw2/GlobalV::NPOL;
+						const int iw2_all = start2 + iw2;
+                        const int iw2_local = pv->global2local_row(iw2_all);
+						if(iw2_local < 0)continue;
+						const int iw2_0 = iw2/GlobalV::NPOL;
  
-                            double dm_current;
-                            std::complex<double> tmp = 0.0;
-                            for(int ik=0;ik<nks;ik++)
+                        double dm_current;
+                        std::complex<double> tmp = 0.0;
+                        for(int ik=0;ik<nks;ik++)
+                        {
+                            const double arg = ( kvec_d[ik] * (dR1-dR2) ) * ModuleBase::TWO_PI;
+                            const std::complex<double> kphase = std::complex <double> ( cos(arg),  sin(arg) );
+                            //tmp += dm[ik](iw1_local,iw2_local)*kphase;
+                            tmp += dm[ik][iw1_local * nrow + iw2_local]*kphase;
+                        }
+                        dm_current=tmp.real();
+
+                        key_tuple key_1(ibt1,dR1.x,dR1.y,dR1.z);
+                        key_tuple key_2(ibt2,dR2.x,dR2.y,dR2.z);
+                        const std::vector<double>& nlm1 = this->nlm_save_k[iat][key_1][iw1_all][0];
+                        const std::vector<double>& nlm2 = this->nlm_save_k[iat][key_2][iw2_all][0];
+                        assert(nlm1.size()==nlm2.size());
+
+                        int ib=0;
+                        for (int L0 = 0; L0 <= orb.Alpha[0].getLmax();++L0)
+                        {
+                            for (int N0 = 0;N0 < orb.Alpha[0].getNchi(L0);++N0)
                             {
-                                const double arg = ( kvec_d[ik] * (dR1-dR2) ) * ModuleBase::TWO_PI;
-                                const std::complex<double> kphase = std::complex <double> ( cos(arg),  sin(arg) );
-                                //tmp += dm[ik](iw1_local,iw2_local)*kphase;
-                                tmp += dm[ik][iw1_local * nrow + iw2_local]*kphase;
-                            }
-                            dm_current=tmp.real();
-
-                            key_tuple key_1(ibt1,dR1.x,dR1.y,dR1.z);
-                            key_tuple key_2(ibt2,dR2.x,dR2.y,dR2.z);
-                            std::vector<double> nlm1 = this->nlm_save_k[iat][key_1][iw1_all][0];
-                            std::vector<double> nlm2 = this->nlm_save_k[iat][key_2][iw2_all][0];
-                            assert(nlm1.size()==nlm2.size());
-
-                            int ib=0;
-                            for (int L0 = 0; L0 <= orb.Alpha[0].getLmax();++L0)
-                            {
-                                for (int N0 = 0;N0 < orb.Alpha[0].getNchi(L0);++N0)
+                                const int inl = this->inl_index[T0](I0, L0, N0);
+                                const int nm = 2*L0+1;
+                                for (int m1 = 0;m1 < 2 * L0 + 1;++m1)
                                 {
-                                    const int inl = this->inl_index[T0](I0, L0, N0);
-                                    const int nm = 2*L0+1;
-                                    for (int m1 = 0;m1 < 2 * L0 + 1;++m1)
+                                    for (int m2 = 0; m2 < 2 * L0 + 1; ++m2)
                                     {
-                                        for (int m2 = 0; m2 < 2 * L0 + 1; ++m2)
-                                        {
-                                            int ind = m1*nm + m2;
-                                            pdm[inl][ind] += dm_current*nlm1[ib+m1]*nlm2[ib+m2];
-                                        }
+                                        int ind = m1*nm + m2;
+                                        pdm[inl][ind] += dm_current*nlm1[ib+m1]*nlm2[ib+m2];
                                     }
-                                    ib+=nm;
                                 }
+                                ib+=nm;
                             }
-                            assert(ib==nlm1.size());               
-						}//iw2
-					}//iw1
-				}//ad2
-			}//ad1
-        }//I0
-    }//T0
+                        }
+                        assert(ib==nlm1.size());               
+					}//iw2
+				}//iw1
+			}//ad2
+		}//ad1
+    }//iat
 
 #ifdef __MPI
     allsum_deepks(this->inlmax,pdm_size,this->pdm);
@@ -365,166 +369,167 @@ void LCAO_Deepks::cal_gdmx(const std::vector<double>& dm,
     }
 
     const double Rcut_Alpha = orb.Alpha[0].getRcut();
+    const std::vector<AdjacentAtomInfo> adjs_all = GridD.get_adjs(ucell);
 
-    for (int T0 = 0; T0 < ucell.ntype; T0++)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int iat = 0; iat < ucell.nat; iat++) //on which alpha is located
     {
-		Atom* atom0 = &ucell.atoms[T0]; 
-        for (int I0 =0; I0< atom0->na; I0++)
-        {
-            const int iat = ucell.itia2iat(T0,I0);//on which alpha is located
-            const ModuleBase::Vector3<double> tau0 = atom0->tau[I0];
-            GridD.Find_atom(ucell, atom0->tau[I0] ,T0, I0);
+        const int T0 = ucell.iat2it[iat];
+        const int I0 = ucell.iat2ia[iat];
+        const ModuleBase::Vector3<double> tau0 = ucell.atoms[T0].tau[I0];
+        const AdjacentAtomInfo& adjs = adjs_all[iat];
 
-            for (int ad1=0; ad1<GridD.getAdjacentNum()+1 ; ++ad1)
-            {
-                const int T1 = GridD.getType(ad1);
-                const int I1 = GridD.getNatom(ad1);
-                const int ibt1 = ucell.itia2iat(T1,I1); //on which chi_mu is located
-                const int start1 = ucell.itiaiw2iwt(T1, I1, 0);
-                
-                const ModuleBase::Vector3<double> tau1 = GridD.getAdjacentTau(ad1);
-				const Atom* atom1 = &ucell.atoms[T1];
-				const int nw1_tot = atom1->nw*GlobalV::NPOL;
-				const double Rcut_AO1 = orb.Phi[T1].getRcut(); 
-
-				for (int ad2=0; ad2 < GridD.getAdjacentNum()+1 ; ad2++)
+        for (int ad1=0; ad1<adjs.adj_num+1 ; ++ad1)
+        {
+            const int T1 = adjs.ntype[ad1];
+            const int I1 = adjs.natom[ad1];
+            const int ibt1 = ucell.itia2iat(T1,I1); //on which chi_mu is located
+            const int start1 = ucell.itiaiw2iwt(T1, I1, 0);
+            
+            const ModuleBase::Vector3<double> tau1 = adjs.adjacent_tau[ad1];
+			const Atom* atom1 = &ucell.atoms[T1];
+			const int nw1_tot = atom1->nw*GlobalV::NPOL;
+			const double Rcut_AO1 = orb.Phi[T1].getRcut(); 
+
+			for (int ad2=0; ad2 < adjs.adj_num+1 ; ad2++)
+			{
+				const int T2 = adjs.ntype[ad2];
+				const int I2 = adjs.natom[ad2];
+				const int start2 = ucell.itiaiw2iwt(T2, I2, 0);
+                const int ibt2 = ucell.itia2iat(T2,I2);
+				const ModuleBase::Vector3<double> tau2 = adjs.adjacent_tau[ad2];
+				const Atom* atom2 = &ucell.atoms[T2];
+				const int nw2_tot = atom2->nw*GlobalV::NPOL;
+				
+				const double Rcut_AO2 = orb.Phi[T2].getRcut();
+            	const double dist1 = (tau1-tau0).norm() * ucell.lat0;
+            	const double dist2 = (tau2-tau0).norm() * ucell.lat0;
+
+				if (dist1 > Rcut_Alpha + Rcut_AO1
+						|| dist2 > Rcut_Alpha + Rcut_AO2)
 				{
-					const int T2 = GridD.getType(ad2);
-					const int I2 = GridD.getNatom(ad2);
-					const int start2 = ucell.itiaiw2iwt(T2, I2, 0);
-                    const int ibt2 = ucell.itia2iat(T2,I2);
-					const ModuleBase::Vector3<double> tau2 = GridD.getAdjacentTau(ad2);
-					const Atom* atom2 = &ucell.atoms[T2];
-					const int nw2_tot = atom2->nw*GlobalV::NPOL;
-					
-					const double Rcut_AO2 = orb.Phi[T2].getRcut();
-                	const double dist1 = (tau1-tau0).norm() * ucell.lat0;
-                	const double dist2 = (tau2-tau0).norm() * ucell.lat0;
-
-					if (dist1 > Rcut_Alpha + Rcut_AO1
-							|| dist2 > Rcut_Alpha + Rcut_AO2)
-					{
-						continue;
-					}
-
-                    double r0[3];
-                    double r1[3];
-                    if(isstress)
-                    {
-                        r1[0] = ( tau1.x - tau0.x) ;
-                        r1[1] = ( tau1.y - tau0.y) ;
-                        r1[2] = ( tau1.z - tau0.z) ;
-                        r0[0] = ( tau2.x - tau0.x) ;
-                        r0[1] = ( tau2.y - tau0.y) ;
-                        r0[2] = ( tau2.z - tau0.z) ;
-                    }
-
-					for (int iw1=0; iw1<nw1_tot; ++iw1)
+					continue;
+				}
+
+                double r0[3];
+                double r1[3];
+                if(isstress)
+                {
+                    r1[0] = ( tau1.x - tau0.x) ;
+                    r1[1] = ( tau1.y - tau0.y) ;
+                    r1[2] = ( tau1.z - tau0.z) ;
+                    r0[0] = ( tau2.x - tau0.x) ;
+                    r0[1] = ( tau2.y - tau0.y) ;
+                    r0[2] = ( tau2.z - tau0.z) ;
+                }
+
+				for (int iw1=0; iw1<nw1_tot; ++iw1)
+				{
+					const int iw1_all = start1 + iw1;
+                    const int iw1_local = pv->global2local_col(iw1_all);
+					if(iw1_local < 0)continue;
+					const int iw1_0 = iw1/GlobalV::NPOL;
+					for (int iw2=0; iw2<nw2_tot; ++iw2)
 					{
-						const int iw1_all = start1 + iw1;
-                        const int iw1_local = pv->global2local_col(iw1_all);
-						if(iw1_local < 0)continue;
-						const int iw1_0 = iw1/GlobalV::NPOL;
-						for (int iw2=0; iw2<nw2_tot; ++iw2)
-						{
-							const int iw2_all = start2 + iw2;
-                            const int iw2_local = pv->global2local_row(iw2_all);
-							if(iw2_local < 0)continue;
-							const int iw2_0 = iw2/GlobalV::NPOL;
-                            
-                            std::vector<double> nlm1 = this->nlm_save[iat][ad1][iw1_all][0];
-                            std::vector<std::vector<double>> nlm2 = this->nlm_save[iat][ad2][iw2_all];
-
-                            assert(nlm1.size()==nlm2[0].size());
-
-                            int ib=0;
-                            for (int L0 = 0; L0 <= orb.Alpha[0].getLmax();++L0)
+						const int iw2_all = start2 + iw2;
+                        const int iw2_local = pv->global2local_row(iw2_all);
+						if(iw2_local < 0)continue;
+						const int iw2_0 = iw2/GlobalV::NPOL;
+                        
+                        const std::vector<double>& nlm1 = this->nlm_save[iat][ad1][iw1_all][0];
+                        const std::vector<std::vector<double>>& nlm2 = this->nlm_save[iat][ad2][iw2_all];
+
+                        assert(nlm1.size()==nlm2[0].size());
+
+                        int ib=0;
+                        for (int L0 = 0; L0 <= orb.Alpha[0].getLmax();++L0)
+                        {
+                            for (int N0 = 0;N0 < orb.Alpha[0].getNchi(L0);++N0)
                             {
-                                for (int N0 = 0;N0 < orb.Alpha[0].getNchi(L0);++N0)
+                                const int inl = this->inl_index[T0](I0, L0, N0);
+                                const int nm = 2*L0+1;
+                                for (int m1 = 0;m1 < nm;++m1)
                                 {
-                                    const int inl = this->inl_index[T0](I0, L0, N0);
-                                    const int nm = 2*L0+1;
-                                    for (int m1 = 0;m1 < nm;++m1)
+                                    for (int m2 = 0; m2 <nm; ++m2)
                                     {
-                                        for (int m2 = 0; m2 <nm; ++m2)
+                                        //(<d/dX chi_mu|alpha_m>)<chi_nu|alpha_m'>
+                                        gdmx[iat][inl][m1*nm+m2] += nlm2[1][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);
+                                        gdmy[iat][inl][m1*nm+m2] += nlm2[2][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);
+                                        gdmz[iat][inl][m1*nm+m2] += nlm2[3][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);
+
+                                        //(<d/dX chi_nu|alpha_m'>)<chi_mu|alpha_m>
+                                        gdmx[iat][inl][m2*nm+m1] += nlm2[1][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);
+                                        gdmy[iat][inl][m2*nm+m1] += nlm2[2][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);
+                                        gdmz[iat][inl][m2*nm+m1] += nlm2[3][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);                                            
+
+                                        //(<chi_mu|d/dX alpha_m>)<chi_nu|alpha_m'> = -(<d/dX chi_mu|alpha_m>)<chi_nu|alpha_m'>
+                                        gdmx[ibt2][inl][m1*nm+m2] -= nlm2[1][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);                                               
+                                        gdmy[ibt2][inl][m1*nm+m2] -= nlm2[2][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);                                               
+                                        gdmz[ibt2][inl][m1*nm+m2] -= nlm2[3][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);
+
+                                        //(<chi_nu|d/dX alpha_m'>)<chi_mu|alpha_m> = -(<d/dX chi_nu|alpha_m'>)<chi_mu|alpha_m>
+                                        gdmx[ibt2][inl][m2*nm+m1] -= nlm2[1][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);                                               
+                                        gdmy[ibt2][inl][m2*nm+m1] -= nlm2[2][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);                                               
+                                        gdmz[ibt2][inl][m2*nm+m1] -= nlm2[3][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);                                            
+
+                                        if (isstress)
                                         {
-                                            //(<d/dX chi_mu|alpha_m>)<chi_nu|alpha_m'>
-                                            gdmx[iat][inl][m1*nm+m2] += nlm2[1][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);
-                                            gdmy[iat][inl][m1*nm+m2] += nlm2[2][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);
-                                            gdmz[iat][inl][m1*nm+m2] += nlm2[3][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);
-
-                                            //(<d/dX chi_nu|alpha_m'>)<chi_mu|alpha_m>
-                                            gdmx[iat][inl][m2*nm+m1] += nlm2[1][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);
-                                            gdmy[iat][inl][m2*nm+m1] += nlm2[2][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);
-                                            gdmz[iat][inl][m2*nm+m1] += nlm2[3][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);                                            
-
-                                            //(<chi_mu|d/dX alpha_m>)<chi_nu|alpha_m'> = -(<d/dX chi_mu|alpha_m>)<chi_nu|alpha_m'>
-                                            gdmx[ibt2][inl][m1*nm+m2] -= nlm2[1][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);                                               
-                                            gdmy[ibt2][inl][m1*nm+m2] -= nlm2[2][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);                                               
-                                            gdmz[ibt2][inl][m1*nm+m2] -= nlm2[3][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);
-
-                                            //(<chi_nu|d/dX alpha_m'>)<chi_mu|alpha_m> = -(<d/dX chi_nu|alpha_m'>)<chi_mu|alpha_m>
-                                            gdmx[ibt2][inl][m2*nm+m1] -= nlm2[1][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);                                               
-                                            gdmy[ibt2][inl][m2*nm+m1] -= nlm2[2][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);                                               
-                                            gdmz[ibt2][inl][m2*nm+m1] -= nlm2[3][ib+m2] * nlm1[ib+m1] * dm[iw1_local*nrow+iw2_local]; //dm(iw1_local,iw2_local);                                            
-
-                                            if (isstress)
+                                            int mm = 0;
+                                            for(int ipol=0;ipol<3;ipol++)
                                             {
-                                                int mm = 0;
-                                                for(int ipol=0;ipol<3;ipol++)
+                                                for(int jpol=ipol;jpol<3;jpol++)
                                                 {
-                                                    for(int jpol=ipol;jpol<3;jpol++)
-                                                    {
-                                                        //gdm_epsl[mm][inl][m2*nm+m1] += ucell.lat0 * dm(iw1_local, iw2_local) * (nlm2[jpol+1][ib+m2] * nlm1[ib+m1] * r0[ipol]);
-                                                        gdm_epsl[mm][inl][m2*nm+m1] += ucell.lat0 * dm[iw1_local*nrow+iw2_local] * (nlm2[jpol+1][ib+m2] * nlm1[ib+m1] * r0[ipol]);
-                                                        mm++;
-                                                    }
+                                                    //gdm_epsl[mm][inl][m2*nm+m1] += ucell.lat0 * dm(iw1_local, iw2_local) * (nlm2[jpol+1][ib+m2] * nlm1[ib+m1] * r0[ipol]);
+                                                    gdm_epsl[mm][inl][m2*nm+m1] += ucell.lat0 * dm[iw1_local*nrow+iw2_local] * (nlm2[jpol+1][ib+m2] * nlm1[ib+m1] * r0[ipol]);
+                                                    mm++;
                                                 }
                                             }
                                         }
                                     }
-                                    ib+=nm;
                                 }
+                                ib+=nm;
                             }
-                            assert(ib==nlm1.size());
-                            if  (isstress)
+                        }
+                        assert(ib==nlm1.size());
+                        if  (isstress)
+                        {
+                            const std::vector<double>& nlm1 = this->nlm_save[iat][ad2][iw2_all][0];
+                            const std::vector<std::vector<double>>& nlm2 = this->nlm_save[iat][ad1][iw1_all];
+
+                            assert(nlm1.size()==nlm2[0].size());  
+                            int ib=0;
+                            for (int L0 = 0; L0 <= orb.Alpha[0].getLmax();++L0)
                             {
-                                nlm1 = this->nlm_save[iat][ad2][iw2_all][0];
-                                nlm2 = this->nlm_save[iat][ad1][iw1_all];
-
-                                assert(nlm1.size()==nlm2[0].size());  
-                                int ib=0;
-                                for (int L0 = 0; L0 <= orb.Alpha[0].getLmax();++L0)
+                                for (int N0 = 0;N0 < orb.Alpha[0].getNchi(L0);++N0)
                                 {
-                                    for (int N0 = 0;N0 < orb.Alpha[0].getNchi(L0);++N0)
+                                    const int inl = this->inl_index[T0](I0, L0, N0);
+                                    const int nm = 2*L0+1;
+                                    for (int m1 = 0;m1 < nm; ++m1)
                                     {
-                                        const int inl = this->inl_index[T0](I0, L0, N0);
-                                        const int nm = 2*L0+1;
-                                        for (int m1 = 0;m1 < nm; ++m1)
+                                        for (int m2 = 0; m2 < nm; ++m2)
                                         {
-                                            for (int m2 = 0; m2 < nm; ++m2)
+                                            int mm = 0;
+                                            for(int ipol=0;ipol<3;ipol++)
                                             {
-                                                int mm = 0;
-                                                for(int ipol=0;ipol<3;ipol++)
+                                                for(int jpol=ipol;jpol<3;jpol++)
                                                 {
-                                                    for(int jpol=ipol;jpol<3;jpol++)
-                                                    {
-                                                        gdm_epsl[mm][inl][m2*nm+m1]  += ucell.lat0 * dm[iw1_local*nrow+iw2_local] * (nlm1[ib+m1] * nlm2[jpol+1][ib+m2] * r1[ipol]);
-                                                        mm++;
-                                                    }
+                                                    gdm_epsl[mm][inl][m2*nm+m1]  += ucell.lat0 * dm[iw1_local*nrow+iw2_local] * (nlm1[ib+m1] * nlm2[jpol+1][ib+m2] * r1[ipol]);
+                                                    mm++;
                                                 }
                                             }
                                         }
-                                        ib+=nm;
                                     }
+                                    ib+=nm;
                                 }
                             }
-						}//iw2
-					}//iw1
-				}//ad2
-			}//ad1
-        }//I0
-    }//T0
+                        }
+					}//iw2
+				}//iw1
+			}//ad2
+		}//ad1
+    }//iat
 
 #ifdef __MPI
     for(int iat=0;iat<ucell.nat;iat++)
@@ -580,185 +585,186 @@ void LCAO_Deepks::cal_gdmx_k(const std::vector<std::vector<std::complex<double>>
     }
 
     const double Rcut_Alpha = orb.Alpha[0].getRcut();
+    const std::vector<AdjacentAtomInfo> adjs_all = GridD.get_adjs(ucell);
     int nrow = this->pv->nrow;
-    for (int T0 = 0; T0 < ucell.ntype; T0++)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int iat = 0; iat < ucell.nat; iat++) //on which alpha is located
     {
-		Atom* atom0 = &ucell.atoms[T0]; 
-        for (int I0 =0; I0< atom0->na; I0++)
-        {
-            const int iat = ucell.itia2iat(T0,I0);//on which alpha is located
-            const ModuleBase::Vector3<double> tau0 = atom0->tau[I0];
-            GridD.Find_atom(ucell, atom0->tau[I0] ,T0, I0);
+        const int T0 = ucell.iat2it[iat];
+        const int I0 = ucell.iat2ia[iat];
+        const ModuleBase::Vector3<double> tau0 = ucell.atoms[T0].tau[I0];
+        const AdjacentAtomInfo& adjs = adjs_all[iat];
 
-            for (int ad1=0; ad1<GridD.getAdjacentNum()+1 ; ++ad1)
-            {
-                const int T1 = GridD.getType(ad1);
-                const int I1 = GridD.getNatom(ad1);
-                const int ibt1 = ucell.itia2iat(T1,I1); //on which chi_mu is located
-                const int start1 = ucell.itiaiw2iwt(T1, I1, 0);
-                
-                const ModuleBase::Vector3<double> tau1 = GridD.getAdjacentTau(ad1);
-				const Atom* atom1 = &ucell.atoms[T1];
-				const int nw1_tot = atom1->nw*GlobalV::NPOL;
-				const double Rcut_AO1 = orb.Phi[T1].getRcut();
-
-                ModuleBase::Vector3<double> dR1(GridD.getBox(ad1).x, GridD.getBox(ad1).y, GridD.getBox(ad1).z); 
-
-				for (int ad2=0; ad2 < GridD.getAdjacentNum()+1 ; ad2++)
+        for (int ad1=0; ad1<adjs.adj_num+1 ; ++ad1)
+        {
+            const int T1 = adjs.ntype[ad1];
+            const int I1 = adjs.natom[ad1];
+            const int ibt1 = ucell.itia2iat(T1,I1); //on which chi_mu is located
+            const int start1 = ucell.itiaiw2iwt(T1, I1, 0);
+            
+            const ModuleBase::Vector3<double> tau1 = adjs.adjacent_tau[ad1];
+			const Atom* atom1 = &ucell.atoms[T1];
+			const int nw1_tot = atom1->nw*GlobalV::NPOL;
+			const double Rcut_AO1 = orb.Phi[T1].getRcut();
+
+            ModuleBase::Vector3<double> dR1(adjs.box[ad1].x, adjs.box[ad1].y, adjs.box[ad1].z); 
+
+			for (int ad2=0; ad2 < adjs.adj_num+1 ; ad2++)
+			{
+				const int T2 = adjs.ntype[ad2];
+				const int I2 = adjs.natom[ad2];
+				const int start2 = ucell.itiaiw2iwt(T2, I2, 0);
+                const int ibt2 = ucell.itia2iat(T2,I2);
+				const ModuleBase::Vector3<double> tau2 = adjs.adjacent_tau[ad2];
+				const Atom* atom2 = &ucell.atoms[T2];
+				const int nw2_tot = atom2->nw*GlobalV::NPOL;
+                ModuleBase::Vector3<double> dR2(adjs.box[ad2].x, adjs.box[ad2].y, adjs.box[ad2].z);
+				
+				const double Rcut_AO2 = orb.Phi[T2].getRcut();
+            	const double dist1 = (tau1-tau0).norm() * ucell.lat0;
+            	const double dist2 = (tau2-tau0).norm() * ucell.lat0;
+
+				if (dist1 > Rcut_Alpha + Rcut_AO1
+						|| dist2 > Rcut_Alpha + Rcut_AO2)
 				{
-					const int T2 = GridD.getType(ad2);
-					const int I2 = GridD.getNatom(ad2);
-					const int start2 = ucell.itiaiw2iwt(T2, I2, 0);
-                    const int ibt2 = ucell.itia2iat(T2,I2);
-					const ModuleBase::Vector3<double> tau2 = GridD.getAdjacentTau(ad2);
-					const Atom* atom2 = &ucell.atoms[T2];
-					const int nw2_tot = atom2->nw*GlobalV::NPOL;
-                    ModuleBase::Vector3<double> dR2(GridD.getBox(ad2).x, GridD.getBox(ad2).y, GridD.getBox(ad2).z);
-					
-					const double Rcut_AO2 = orb.Phi[T2].getRcut();
-                	const double dist1 = (tau1-tau0).norm() * ucell.lat0;
-                	const double dist2 = (tau2-tau0).norm() * ucell.lat0;
-
-					if (dist1 > Rcut_Alpha + Rcut_AO1
-							|| dist2 > Rcut_Alpha + Rcut_AO2)
-					{
-						continue;
-					}
-
-                    double r0[3];
-                    double r1[3];
-                    if(isstress)
-                    {
-                        r1[0] = ( tau1.x - tau0.x) ;
-                        r1[1] = ( tau1.y - tau0.y) ;
-                        r1[2] = ( tau1.z - tau0.z) ;
-                        r0[0] = ( tau2.x - tau0.x) ;
-                        r0[1] = ( tau2.y - tau0.y) ;
-                        r0[2] = ( tau2.z - tau0.z) ;
-                    }
-
-
-					for (int iw1=0; iw1<nw1_tot; ++iw1)
+					continue;
+				}
+
+                double r0[3];
+                double r1[3];
+                if(isstress)
+                {
+                    r1[0] = ( tau1.x - tau0.x) ;
+                    r1[1] = ( tau1.y - tau0.y) ;
+                    r1[2] = ( tau1.z - tau0.z) ;
+                    r0[0] = ( tau2.x - tau0.x) ;
+                    r0[1] = ( tau2.y - tau0.y) ;
+                    r0[2] = ( tau2.z - tau0.z) ;
+                }
+
+
+				for (int iw1=0; iw1<nw1_tot; ++iw1)
+				{
+					const int iw1_all = start1 + iw1;
+                    const int iw1_local = pv->global2local_col(iw1_all);
+					if(iw1_local < 0)continue;
+					const int iw1_0 = iw1/GlobalV::NPOL;
+					for (int iw2=0; iw2<nw2_tot; ++iw2)
 					{
-						const int iw1_all = start1 + iw1;
-                        const int iw1_local = pv->global2local_col(iw1_all);
-						if(iw1_local < 0)continue;
-						const int iw1_0 = iw1/GlobalV::NPOL;
-						for (int iw2=0; iw2<nw2_tot; ++iw2)
-						{
-							const int iw2_all = start2 + iw2;
-                            const int iw2_local = pv->global2local_row(iw2_all);
-							if(iw2_local < 0)continue;
-							const int iw2_0 = iw2/GlobalV::NPOL;
-
-                            double dm_current;
-                            std::complex<double> tmp = 0.0;
-                            for(int ik=0;ik<nks;ik++)
-                            {
-                                const double arg = - ( kvec_d[ik] * (dR2-dR1) ) * ModuleBase::TWO_PI;
-                                const std::complex<double> kphase = std::complex <double> ( cos(arg),  sin(arg) );
-                                //tmp += dm[ik](iw1_local,iw2_local)*kphase;
-                                tmp += dm[ik][iw1_local*nrow+iw2_local]*kphase;
-                            }
-                            dm_current=tmp.real();
-
-                            key_tuple key_1(ibt1,dR1.x,dR1.y,dR1.z);
-                            key_tuple key_2(ibt2,dR2.x,dR2.y,dR2.z);
-                            std::vector<double> nlm1 = this->nlm_save_k[iat][key_1][iw1_all][0];
-                            std::vector<std::vector<double>> nlm2 = this->nlm_save_k[iat][key_2][iw2_all];
-
-                            assert(nlm1.size()==nlm2[0].size());
-
-                            int ib=0;
-                            for (int L0 = 0; L0 <= orb.Alpha[0].getLmax();++L0)
+						const int iw2_all = start2 + iw2;
+                        const int iw2_local = pv->global2local_row(iw2_all);
+						if(iw2_local < 0)continue;
+						const int iw2_0 = iw2/GlobalV::NPOL;
+
+                        double dm_current;
+                        std::complex<double> tmp = 0.0;
+                        for(int ik=0;ik<nks;ik++)
+                        {
+                            const double arg = - ( kvec_d[ik] * (dR2-dR1) ) * ModuleBase::TWO_PI;
+                            const std::complex<double> kphase = std::complex <double> ( cos(arg),  sin(arg) );
+                            //tmp += dm[ik](iw1_local,iw2_local)*kphase;
+                            tmp += dm[ik][iw1_local*nrow+iw2_local]*kphase;
+                        }
+                        dm_current=tmp.real();
+
+                        key_tuple key_1(ibt1,dR1.x,dR1.y,dR1.z);
+                        key_tuple key_2(ibt2,dR2.x,dR2.y,dR2.z);
+                        const std::vector<double>& nlm1 = this->nlm_save_k[iat][key_1][iw1_all][0];
+                        const std::vector<std::vector<double>>& nlm2 = this->nlm_save_k[iat][key_2][iw2_all];
+
+                        assert(nlm1.size()==nlm2[0].size());
+
+                        int ib=0;
+                        for (int L0 = 0; L0 <= orb.Alpha[0].getLmax();++L0)
+                        {
+                            for (int N0 = 0;N0 < orb.Alpha[0].getNchi(L0);++N0)
                             {
-                                for (int N0 = 0;N0 < orb.Alpha[0].getNchi(L0);++N0)
+                                const int inl = this->inl_index[T0](I0, L0, N0);
+                                const int nm = 2*L0+1;
+                                for (int m1 = 0;m1 < 2 * L0 + 1;++m1)
                                 {
-                                    const int inl = this->inl_index[T0](I0, L0, N0);
-                                    const int nm = 2*L0+1;
-                                    for (int m1 = 0;m1 < 2 * L0 + 1;++m1)
+                                    for (int m2 = 0; m2 < 2 * L0 + 1; ++m2)
                                     {
-                                        for (int m2 = 0; m2 < 2 * L0 + 1; ++m2)
-                                        {
-                                            //(<d/dX chi_mu|alpha_m>)<chi_nu|alpha_m'>
-                                            gdmx[iat][inl][m1*nm+m2] += nlm2[1][ib+m2] * nlm1[ib+m1] * dm_current;
-                                            gdmy[iat][inl][m1*nm+m2] += nlm2[2][ib+m2] * nlm1[ib+m1] * dm_current;
-                                            gdmz[iat][inl][m1*nm+m2] += nlm2[3][ib+m2] * nlm1[ib+m1] * dm_current;
+                                        //(<d/dX chi_mu|alpha_m>)<chi_nu|alpha_m'>
+                                        gdmx[iat][inl][m1*nm+m2] += nlm2[1][ib+m2] * nlm1[ib+m1] * dm_current;
+                                        gdmy[iat][inl][m1*nm+m2] += nlm2[2][ib+m2] * nlm1[ib+m1] * dm_current;
+                                        gdmz[iat][inl][m1*nm+m2] += nlm2[3][ib+m2] * nlm1[ib+m1] * dm_current;
 
-                                            //(<d/dX chi_nu|alpha_m'>)<chi_mu|alpha_m>
-                                            gdmx[iat][inl][m2*nm+m1] += nlm2[1][ib+m2] * nlm1[ib+m1] * dm_current;
-                                            gdmy[iat][inl][m2*nm+m1] += nlm2[2][ib+m2] * nlm1[ib+m1] * dm_current;
-                                            gdmz[iat][inl][m2*nm+m1] += nlm2[3][ib+m2] * nlm1[ib+m1] * dm_current;                                            
+                                        //(<d/dX chi_nu|alpha_m'>)<chi_mu|alpha_m>
+                                        gdmx[iat][inl][m2*nm+m1] += nlm2[1][ib+m2] * nlm1[ib+m1] * dm_current;
+                                        gdmy[iat][inl][m2*nm+m1] += nlm2[2][ib+m2] * nlm1[ib+m1] * dm_current;
+                                        gdmz[iat][inl][m2*nm+m1] += nlm2[3][ib+m2] * nlm1[ib+m1] * dm_current;                                            
 
-                                            //(<chi_mu|d/dX alpha_m>)<chi_nu|alpha_m'> = -(<d/dX chi_mu|alpha_m>)<chi_nu|alpha_m'>
-                                            gdmx[ibt2][inl][m1*nm+m2] -= nlm2[1][ib+m2] * nlm1[ib+m1] * dm_current;                                               
-                                            gdmy[ibt2][inl][m1*nm+m2] -= nlm2[2][ib+m2] * nlm1[ib+m1] * dm_current;                                               
-                                            gdmz[ibt2][inl][m1*nm+m2] -= nlm2[3][ib+m2] * nlm1[ib+m1] * dm_current;
+                                        //(<chi_mu|d/dX alpha_m>)<chi_nu|alpha_m'> = -(<d/dX chi_mu|alpha_m>)<chi_nu|alpha_m'>
+                                        gdmx[ibt2][inl][m1*nm+m2] -= nlm2[1][ib+m2] * nlm1[ib+m1] * dm_current;                                               
+                                        gdmy[ibt2][inl][m1*nm+m2] -= nlm2[2][ib+m2] * nlm1[ib+m1] * dm_current;                                               
+                                        gdmz[ibt2][inl][m1*nm+m2] -= nlm2[3][ib+m2] * nlm1[ib+m1] * dm_current;
 
-                                            //(<chi_nu|d/dX alpha_m'>)<chi_mu|alpha_m> = -(<d/dX chi_nu|alpha_m'>)<chi_mu|alpha_m>
-                                            gdmx[ibt2][inl][m2*nm+m1] -= nlm2[1][ib+m2] * nlm1[ib+m1] * dm_current;                                               
-                                            gdmy[ibt2][inl][m2*nm+m1] -= nlm2[2][ib+m2] * nlm1[ib+m1] * dm_current;                                               
-                                            gdmz[ibt2][inl][m2*nm+m1] -= nlm2[3][ib+m2] * nlm1[ib+m1] * dm_current;     
+                                        //(<chi_nu|d/dX alpha_m'>)<chi_mu|alpha_m> = -(<d/dX chi_nu|alpha_m'>)<chi_mu|alpha_m>
+                                        gdmx[ibt2][inl][m2*nm+m1] -= nlm2[1][ib+m2] * nlm1[ib+m1] * dm_current;                                               
+                                        gdmy[ibt2][inl][m2*nm+m1] -= nlm2[2][ib+m2] * nlm1[ib+m1] * dm_current;                                               
+                                        gdmz[ibt2][inl][m2*nm+m1] -= nlm2[3][ib+m2] * nlm1[ib+m1] * dm_current;     
 
 
-                                            if (isstress)
+                                        if (isstress)
+                                        {
+                                            int mm = 0;
+                                            for(int ipol=0;ipol<3;ipol++)
                                             {
-                                                int mm = 0;
-                                                for(int ipol=0;ipol<3;ipol++)
+                                                for(int jpol=ipol;jpol<3;jpol++)
                                                 {
-                                                    for(int jpol=ipol;jpol<3;jpol++)
-                                                    {
-                                                        gdm_epsl[mm][inl][m2*nm+m1] += ucell.lat0 * dm_current * (nlm2[jpol+1][ib+m2] * nlm1[ib+m1] * r0[ipol]);
-                                                        mm++;
-                                                    }
+                                                    gdm_epsl[mm][inl][m2*nm+m1] += ucell.lat0 * dm_current * (nlm2[jpol+1][ib+m2] * nlm1[ib+m1] * r0[ipol]);
+                                                    mm++;
                                                 }
                                             }
-
                                         }
+
                                     }
-                                    ib+=nm;
                                 }
+                                ib+=nm;
                             }
-                            assert(ib==nlm1.size());
+                        }
+                        assert(ib==nlm1.size());
 
-                            if  (isstress)
-                            {
-                                nlm1 = this->nlm_save_k[iat][key_2][iw2_all][0];
-                                nlm2 = this->nlm_save_k[iat][key_1][iw1_all];
+                        if  (isstress)
+                        {
+                            const std::vector<double>& nlm1 = this->nlm_save_k[iat][key_2][iw2_all][0];
+                            const std::vector<std::vector<double>>& nlm2 = this->nlm_save_k[iat][key_1][iw1_all];
 
-                                assert(nlm1.size()==nlm2[0].size());  
-                                int ib=0;
-                                for (int L0 = 0; L0 <= orb.Alpha[0].getLmax();++L0)
+                            assert(nlm1.size()==nlm2[0].size());  
+                            int ib=0;
+                            for (int L0 = 0; L0 <= orb.Alpha[0].getLmax();++L0)
+                            {
+                                for (int N0 = 0;N0 < orb.Alpha[0].getNchi(L0);++N0)
                                 {
-                                    for (int N0 = 0;N0 < orb.Alpha[0].getNchi(L0);++N0)
+                                    const int inl = this->inl_index[T0](I0, L0, N0);
+                                    const int nm = 2*L0+1;
+                                    for (int m1 = 0;m1 < nm; ++m1)
                                     {
-                                        const int inl = this->inl_index[T0](I0, L0, N0);
-                                        const int nm = 2*L0+1;
-                                        for (int m1 = 0;m1 < nm; ++m1)
+                                        for (int m2 = 0; m2 < nm; ++m2)
                                         {
-                                            for (int m2 = 0; m2 < nm; ++m2)
+                                            int mm = 0;
+                                            for(int ipol=0;ipol<3;ipol++)
                                             {
-                                                int mm = 0;
-                                                for(int ipol=0;ipol<3;ipol++)
+                                                for(int jpol=ipol;jpol<3;jpol++)
                                                 {
-                                                    for(int jpol=ipol;jpol<3;jpol++)
-                                                    {
-                                                        gdm_epsl[mm][inl][m2*nm+m1]  += ucell.lat0 * dm_current * (nlm1[ib+m1] * nlm2[jpol+1][ib+m2] * r1[ipol]);
-                                                        mm++;
-                                                    }
+                                                    gdm_epsl[mm][inl][m2*nm+m1]  += ucell.lat0 * dm_current * (nlm1[ib+m1] * nlm2[jpol+1][ib+m2] * r1[ipol]);
+                                                    mm++;
                                                 }
                                             }
                                         }
-                                        ib+=nm;
                                     }
+                                    ib+=nm;
                                 }
                             }
-						}//iw2
-					}//iw1
-				}//ad2
-			}//ad1
-        }//I0
-    }//T0
+                        }
+					}//iw2
+				}//iw1
+			}//ad2
+		}//ad1
+    }//iat
 
 #ifdef __MPI
     for(int iat=0;iat<ucell.nat;iat++)
@@ -31,46 +31,37 @@
 void LCAO_Deepks::cal_descriptor(void)
 {
     ModuleBase::TITLE("LCAO_Deepks", "cal_descriptor");
+    ModuleBase::timer::tick("LCAO_Deepks", "cal_descriptor");
 
-    //init pdm_tensor and d_tensor
-    torch::Tensor tmp;
+    const int nat = this->n_descriptor / this->des_per_atom;
+    const int nlmax = this->inlmax / nat;
 
-    //if pdm_tensor and d_tensor is not empty, clear it !!
-    if (!this->d_tensor.empty())
+    //pdm_tensor : the blocks of all atoms of one projector shell nl, nat*nm*nm,
+    //so that the eigenvalues of all blocks are obtained in one batched call
+    this->pdm_tensor.clear();
+    std::vector<torch::Tensor> d_vector;
+    for (int nl = 0;nl < nlmax;++nl)
     {
-        this->d_tensor.erase(this->d_tensor.begin(), this->d_tensor.end());
-    }
-    if (!this->pdm_tensor.empty())
-    {
-        this->pdm_tensor.erase(this->pdm_tensor.begin(), this->pdm_tensor.end());
-    }
-
-    for (int inl = 0;inl < this->inlmax;++inl)
-    {
-        int nm = 2 * inl_l[inl] + 1;
-        tmp = torch::ones({ nm, nm }, torch::TensorOptions().dtype(torch::kFloat64));
-        for (int m1 = 0;m1 < nm;++m1)
+        const int nm = 2 * inl_l[nl] + 1;
+        torch::Tensor tmp = torch::empty({ nat, nm, nm }, torch::TensorOptions().dtype(torch::kFloat64));
+        double* ptmp = tmp.data_ptr<double>();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int iat = 0;iat < nat;++iat)
         {
-            for (int m2 = 0;m2 < nm;++m2)
-            {
-                tmp.index_put_({m1, m2}, this->pdm[inl][m1 * nm + m2]);
-            }
+            const int inl = iat * nlmax + nl;
+            std::copy(this->pdm[inl], this->pdm[inl] + nm * nm, ptmp + iat * nm * nm);
         }
-        //torch::Tensor tmp = torch::from_blob(this->pdm[inl], { nm, nm }, torch::requires_grad());
         tmp.requires_grad_(true);
         this->pdm_tensor.push_back(tmp);
-        this->d_tensor.push_back(torch::ones({ nm }, torch::requires_grad(true)));
+        d_vector.push_back(std::get<0>(torch::linalg::eigh(tmp, /*uplo*/"U"))); //nat*nm
     }
 
-    //cal d_tensor
-    for (int inl = 0;inl < inlmax;++inl)
-    {
-        torch::Tensor vd;
-        std::tuple<torch::Tensor, torch::Tensor> d_v(this->d_tensor[inl], vd);
-        //d_v = torch::symeig(pdm_tensor[inl], /*eigenvalues=*/true, /*upper=*/true);
-        d_v = torch::linalg::eigh(pdm_tensor[inl], /*uplo*/"U");
-        d_tensor[inl] = std::get<0>(d_v);
-    }
+    //d_tensor : nat*des_per_atom
+    this->d_tensor = torch::cat(d_vector, -1);
+
+    ModuleBase::timer::tick("LCAO_Deepks", "cal_descriptor");
     return;
 }
 
@@ -80,24 +71,19 @@ void LCAO_Deepks::check_descriptor(const UnitCell &ucell)
     if(GlobalV::MY_RANK!=0) return;
     std::ofstream ofs("descriptor.dat");
     ofs<<std::setprecision(10);
+    const torch::Tensor d = this->d_tensor.detach().contiguous();
+    const double* pd = d.data_ptr<double>();
     for (int it = 0; it < ucell.ntype; it++)
     {
         for (int ia = 0; ia < ucell.atoms[it].na; ia++)
         {
             int iat=ucell.itia2iat(it,ia);
             ofs << ucell.atoms[it].label << " atom_index " << ia + 1 << " n_descriptor " << this->des_per_atom << std::endl;
-            int id = 0;
-            for(int inl=0;inl<inlmax/ucell.nat;inl++)
+            for(int id=0;id<this->des_per_atom;id++)
             {
-                int nm = 2*inl_l[inl]+1;
-                for(int im=0;im<nm;im++)
-                {
-                    const int ind=iat*inlmax/ucell.nat+inl;
-                    ofs << d_tensor[ind].index({im}).item().toDouble() << " ";
-                    if (id % 8 == 7) ofs << std::endl;
-                    id++;
-                }
-            }   
+                ofs << pd[iat * this->des_per_atom + id] << " ";
+                if (id % 8 == 7) ofs << std::endl;
+            }
             ofs << std::endl << std::endl;
         }
     }
@@ -118,41 +104,29 @@ void LCAO_Deepks::cal_gvx(const int nat)
     //gdmr_vector : nat(derivative) * 3 * inl(projector) * nm * nm
     if(GlobalV::MY_RANK==0)
     {
-        //make gdmx as tensor
+        //make gdmx as tensor, the blocks of all atoms are packed directly into one tensor for each nl
         int nlmax = this->inlmax/nat;
         for (int nl=0;nl<nlmax;++nl)
         {
-            std::vector<torch::Tensor> bmmv;
+            const int nm = 2*this->inl_l[nl]+1;
+            torch::Tensor bmm = torch::empty({nat, 3, nat, nm, nm}, torch::TensorOptions().dtype(torch::kFloat64));
+            double* pbmm = bmm.data_ptr<double>();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
             for (int ibt=0;ibt<nat;++ibt)
             {
-                std::vector<torch::Tensor> xmmv;
                 for (int i=0;i<3;++i)
                 {
-                    std::vector<torch::Tensor> ammv;
+                    double** gdm = (i==0) ? this->gdmx[ibt] : ((i==1) ? this->gdmy[ibt] : this->gdmz[ibt]);
                     for (int iat=0; iat<nat; ++iat)
                     {
                         int inl = iat*nlmax + nl;
-                        int nm = 2*this->inl_l[inl]+1;
-                        std::vector<double> mmv;
-                        for (int m1=0;m1<nm;++m1)
-                        {
-                            for(int m2=0;m2<nm;++m2)
-                            {
-                                if(i==0) mmv.push_back(this->gdmx[ibt][inl][m1*nm+m2]);
-                                if(i==1) mmv.push_back(this->gdmy[ibt][inl][m1*nm+m2]);
-                                if(i==2) mmv.push_back(this->gdmz[ibt][inl][m1*nm+m2]);
-                            }
-                        }//nm^2
-                        torch::Tensor mm = torch::tensor(mmv, torch::TensorOptions().dtype(torch::kFloat64) ).reshape({nm, nm});    //nm*nm
-                        ammv.push_back(mm);
+                        std::copy(gdm[inl], gdm[inl] + nm*nm, pbmm + ((ibt*3 + i)*nat + iat)*nm*nm);
                     }
-                    torch::Tensor amm = torch::stack(ammv, 0);  //nat*nm*nm
-                    xmmv.push_back(amm);
                 }
-                torch::Tensor bmm = torch::stack(xmmv, 0);  //3*nat*nm*nm
-                bmmv.push_back(bmm); 
             }
-            this->gdmr_vector.push_back(torch::stack(bmmv, 0)); //nbt*3*nat*nm*nm
+            this->gdmr_vector.push_back(bmm); //nbt*3*nat*nm*nm
         }
         assert(this->gdmr_vector.size()==nlmax);
 
@@ -242,39 +216,25 @@ void LCAO_Deepks::cal_gvepsl(const int nat)
     //gdmr_vector : nat(derivative) * 3 * inl(projector) * nm * nm
     if(GlobalV::MY_RANK==0)
     {
-        //make gdmx as tensor
+        //make gdm_epsl as tensor
         int nlmax = this->inlmax/nat;
         for (int nl=0;nl<nlmax;++nl)
         {
-            std::vector<torch::Tensor> bmmv;
-            //for (int ipol=0;ipol<6;++ipol)
-            //{
-            //    std::vector<torch::Tensor> xmmv;
-                for (int i=0;i<6;++i)
+            const int nm = 2*this->inl_l[nl]+1;
+            torch::Tensor bmm = torch::empty({6, nat, nm, nm}, torch::TensorOptions().dtype(torch::kFloat64));
+            double* pbmm = bmm.data_ptr<double>();
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2)
+#endif
+            for (int i=0;i<6;++i)
+            {
+                for (int iat=0; iat<nat; ++iat)
                 {
-                    std::vector<torch::Tensor> ammv;
-                    for (int iat=0; iat<nat; ++iat)
-                    {
-                        int inl = iat*nlmax + nl;
-                        int nm = 2*this->inl_l[inl]+1;
-                        std::vector<double> mmv;
-                        for (int m1=0;m1<nm;++m1)
-                        {
-                            for(int m2=0;m2<nm;++m2)
-                            {
-                                 mmv.push_back(this->gdm_epsl[i][inl][m1*nm+m2]);
-                            }
-                        }//nm^2
-                        torch::Tensor mm = torch::tensor(mmv, torch::TensorOptions().dtype(torch::kFloat64) ).reshape({nm, nm});    //nm*nm
-                        ammv.push_back(mm);
-                    }
-                    torch::Tensor bmm = torch::stack(ammv, 0);  //nat*nm*nm
-                    bmmv.push_back(bmm);
+                    int inl = iat*nlmax + nl;
+                    std::copy(this->gdm_epsl[i][inl], this->gdm_epsl[i][inl] + nm*nm, pbmm + (i*nat + iat)*nm*nm);
                 }
-                //torch::Tensor bmm = torch::stack(xmmv, 0);  //3*nat*nm*nm
-                //bmmv.push_back(bmm); 
-            //}
-            this->gdmepsl_vector.push_back(torch::stack(bmmv, 0)); //nbt*3*nat*nm*nm
+            }
+            this->gdmepsl_vector.push_back(bmm); //6*nat*nm*nm
         }
         assert(this->gdmepsl_vector.size()==nlmax);
 
@@ -308,31 +268,24 @@ void LCAO_Deepks::cal_gvdm(const int nat)
         gevdm_vector.erase(gevdm_vector.begin(),gevdm_vector.end());
     }
     //cal gevdm(d(EigenValue(D))/dD)
+    //the blocks of all atoms are handled in one batch for each nl
     int nlmax = inlmax/nat;
     for (int nl=0;nl<nlmax;++nl)
     {
-        std::vector<torch::Tensor> avmmv;
-        for (int iat = 0;iat<nat;++iat)
-        {
-            int inl = iat*nlmax+nl;
-            int nm = 2*this->inl_l[inl]+1;
-            //repeat each block for nm times in an additional dimension
-            torch::Tensor tmp_x = this->pdm_tensor[inl].reshape({nm, nm}).unsqueeze(0).repeat({nm, 1, 1});
-            //torch::Tensor tmp_y = std::get<0>(torch::symeig(tmp_x, true));
-            torch::Tensor tmp_y = std::get<0>(torch::linalg::eigh(tmp_x, "U"));
-            torch::Tensor tmp_yshell = torch::eye(nm, torch::TensorOptions().dtype(torch::kFloat64));
-            std::vector<torch::Tensor> tmp_rpt;     //repeated-pdm-tensor (x)
-            std::vector<torch::Tensor> tmp_rdt; //repeated-d-tensor (y)
-            std::vector<torch::Tensor> tmp_gst; //gvx-shell
-            tmp_rpt.push_back(tmp_x);
-            tmp_rdt.push_back(tmp_y);
-            tmp_gst.push_back(tmp_yshell);
-            std::vector<torch::Tensor> tmp_res;
-            tmp_res = torch::autograd::grad(tmp_rdt, tmp_rpt, tmp_gst, false, false, /*allow_unused*/true); //nm(v)**nm*nm
-            avmmv.push_back(tmp_res[0]);
-        }
-        torch::Tensor avmm = torch::stack(avmmv, 0); //nat*nv**nm*nm
-        this->gevdm_vector.push_back(avmm);
+        int nm = 2*this->inl_l[nl]+1;
+        //repeat each block for nm times in an additional dimension
+        torch::Tensor tmp_x = this->pdm_tensor[nl].detach().unsqueeze(1).repeat({1, nm, 1, 1}).requires_grad_(true); //nat*nm(v)*nm*nm
+        torch::Tensor tmp_y = std::get<0>(torch::linalg::eigh(tmp_x, "U")); //nat*nm(v)*nm
+        torch::Tensor tmp_yshell = torch::eye(nm, torch::TensorOptions().dtype(torch::kFloat64)).unsqueeze(0).repeat({nat, 1, 1});
+        std::vector<torch::Tensor> tmp_rpt;     //repeated-pdm-tensor (x)
+        std::vector<torch::Tensor> tmp_rdt; //repeated-d-tensor (y)
+        std::vector<torch::Tensor> tmp_gst; //gvx-shell
+        tmp_rpt.push_back(tmp_x);
+        tmp_rdt.push_back(tmp_y);
+        tmp_gst.push_back(tmp_yshell);
+        std::vector<torch::Tensor> tmp_res;
+        tmp_res = torch::autograd::grad(tmp_rdt, tmp_rpt, tmp_gst, false, false, /*allow_unused*/true); //nat*nm(v)*nm*nm
+        this->gevdm_vector.push_back(tmp_res[0]);
     }
     assert(this->gevdm_vector.size() == nlmax);
     return;
@@ -365,27 +318,33 @@ void LCAO_Deepks::cal_gedm(const int nat)
     std::vector<torch::jit::IValue> inputs;
     
     //input_dim:(natom, des_per_atom)
-    inputs.push_back(torch::cat(this->d_tensor, 0).reshape({ 1, nat, this->des_per_atom }));
+    inputs.push_back(this->d_tensor.reshape({ 1, nat, this->des_per_atom }));
     std::vector<torch::Tensor> ec;
     ec.push_back(module.forward(inputs).toTensor());    //Hartree
     this->E_delta = ec[0].item().toDouble() * 2;//Ry; *2 is for Hartree to Ry
 
-    //cal gedm
+    //cal gedm, one backward pass for all atoms
     std::vector<torch::Tensor> gedm_shell;
     gedm_shell.push_back(torch::ones_like(ec[0]));
     this->gedm_tensor = torch::autograd::grad(ec, this->pdm_tensor, gedm_shell, /*retain_grad=*/true, /*create_graph=*/false, /*allow_unused=*/true);
 
-    //gedm_tensor(Hartree) to gedm(Ry)
-    for (int inl = 0;inl < inlmax;++inl)
+    //gedm_tensor(Hartree) to gedm(Ry), scattered back to the blocks of each atom
+    const int nlmax = this->inlmax / nat;
+    for (int nl = 0;nl < nlmax;++nl)
     {
-        int nm = 2 * inl_l[inl] + 1;
-        for (int m1 = 0;m1 < nm;++m1)
+        const int nm = 2 * inl_l[nl] + 1;
+        const torch::Tensor gedm_nl = this->gedm_tensor[nl].contiguous();
+        const double* pgedm = gedm_nl.data_ptr<double>();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int iat = 0;iat < nat;++iat)
         {
-            for (int m2 = 0;m2 < nm;++m2)
+            const int inl = iat * nlmax + nl;
+            for (int index = 0;index < nm * nm;++index)
             {
-                int index = m1 * nm + m2;
                 //*2 is for Hartree to Ry
-                this->gedm[inl][index] = this->gedm_tensor[inl].index({ m1,m2 }).item().toDouble() * 2;
+                this->gedm[inl][index] = pgedm[iat * nm * nm + index] * 2;
             }
         }
     }
@@ -531,38 +490,22 @@ void LCAO_Deepks::cal_orbital_precalc(const std::vector<std::vector<ModuleBase::
     std::vector<torch::Tensor> orbital_pdm_shell_vector;
     for(int nl = 0; nl < nlmax; ++nl)
     {
-        std::vector<torch::Tensor> kiammv;
+        const int nm = 2*this->inl_l[nl]+1;
+        torch::Tensor kiamm = torch::empty({1, 1, nat, nm, nm}, torch::TensorOptions().dtype(torch::kFloat64));
+        double* pkiamm = kiamm.data_ptr<double>();
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2)
+#endif
         for(int iks = 0; iks < 1; ++iks)
         {
-            std::vector<torch::Tensor> iammv;
-            for(int hl=0; hl<1; ++hl)
+            for (int iat=0; iat<nat; ++iat)
             {
-                std::vector<torch::Tensor> ammv;
-                for (int iat=0; iat<nat; ++iat)
-                {
-                    int inl = iat*nlmax+nl;
-                    int nm = 2*this->inl_l[inl]+1;
-                    std::vector<double> mmv;
-                
-                    for (int m1=0; m1<nm; ++m1) // m1 = 1 for s, 3 for p, 5 for d
-                    {
-                        for (int m2=0; m2<nm; ++m2) // m1 = 1 for s, 3 for p, 5 for d
-                        {
-                            mmv.push_back(this->orbital_pdm_shell[iks][hl][inl][m1*nm+m2]);
-                        }
-                    }
-                    torch::Tensor mm = torch::tensor(mmv, torch::TensorOptions().dtype(torch::kFloat64) ).reshape({nm, nm});    //nm*nm
-                    ammv.push_back(mm);
-                }
-                torch::Tensor amm = torch::stack(ammv, 0); 
-                iammv.push_back(amm);
+                int inl = iat*nlmax+nl;
+                const double* shell = this->orbital_pdm_shell[iks][0][inl];
+                std::copy(shell, shell + nm*nm, pkiamm + (iks*nat + iat)*nm*nm);
             }
-            torch::Tensor iamm = torch::stack(iammv, 0);  //inl*nm*nm
-            //orbital_pdm_shell_vector.push_back(iamm);
-            kiammv.push_back(iamm);
         }
-        torch::Tensor kiamm = torch::stack(kiammv, 0);  
-        orbital_pdm_shell_vector.push_back(kiamm);
+        orbital_pdm_shell_vector.push_back(kiamm); //nks*1*nat*nm*nm
     }
        
     assert(orbital_pdm_shell_vector.size() == nlmax);
@@ -713,44 +656,26 @@ void LCAO_Deepks::cal_orbital_precalc_k(const std::vector<std::vector<ModuleBase
     int nlmax = this->inlmax/nat;
    
     std::vector<torch::Tensor> orbital_pdm_shell_vector;
-    
     for(int nl = 0; nl < nlmax; ++nl)
     {
-        std::vector<torch::Tensor> kiammv;
+        const int nm = 2*this->inl_l[nl]+1;
+        torch::Tensor kiamm = torch::empty({nks, 1, nat, nm, nm}, torch::TensorOptions().dtype(torch::kFloat64));
+        double* pkiamm = kiamm.data_ptr<double>();
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2)
+#endif
         for(int iks = 0; iks < nks; ++iks)
         {
-            std::vector<torch::Tensor> iammv;
-            for(int hl=0; hl<1; ++hl)
+            for (int iat=0; iat<nat; ++iat)
             {
-                std::vector<torch::Tensor> ammv;
-                for (int iat=0; iat<nat; ++iat)
-                {
-                    int inl = iat*nlmax+nl;
-                    int nm = 2*this->inl_l[inl]+1;
-                    std::vector<double> mmv;
-                
-                    for (int m1=0; m1<nm; ++m1) // m1 = 1 for s, 3 for p, 5 for d
-                    {
-                        for (int m2=0; m2<nm; ++m2) // m1 = 1 for s, 3 for p, 5 for d
-                        {
-                            mmv.push_back(this->orbital_pdm_shell[iks][hl][inl][m1*nm+m2]);
-                        }
-                
-                    }
-                    torch::Tensor mm = torch::tensor(mmv, torch::TensorOptions().dtype(torch::kFloat64) ).reshape({nm, nm});    //nm*nm
-                    ammv.push_back(mm);
-                }
-                torch::Tensor amm = torch::stack(ammv, 0); 
-                iammv.push_back(amm);
+                int inl = iat*nlmax+nl;
+                const double* shell = this->orbital_pdm_shell[iks][0][inl];
+                std::copy(shell, shell + nm*nm, pkiamm + (iks*nat + iat)*nm*nm);
             }
-            torch::Tensor iamm = torch::stack(iammv, 0);  //inl*nm*nm
-            kiammv.push_back(iamm);
         }
-        torch::Tensor kiamm = torch::stack(kiammv, 0);
-        orbital_pdm_shell_vector.push_back(kiamm);
+        orbital_pdm_shell_vector.push_back(kiamm); //nks*1*nat*nm*nm
     }
        
-    
     assert(orbital_pdm_shell_vector.size() == nlmax);
         
     
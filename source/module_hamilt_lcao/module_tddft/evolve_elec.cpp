@@ -31,6 +31,7 @@ void Evolve_elec::solve_psi(const int& istep,
                             psi::Psi<std::complex<double>>* psi_laststep,
                             std::complex<double>** Hk_laststep,
                             std::complex<double>** Sk_laststep,
+                            std::vector<OverlapLU>& Sk_lu,
                             ModuleBase::matrix& ekb,
                             int htype,
                             int propagator,
@@ -39,6 +40,8 @@ void Evolve_elec::solve_psi(const int& istep,
     ModuleBase::TITLE("Evolve_elec", "eveolve_psi");
     ModuleBase::timer::tick("Evolve_elec", "evolve_psi");
 
+    // LU factors of S(k) are kept between electronic steps
+    Sk_lu.resize(nks);
     for (int ik = 0; ik < nks; ik++)
     {
         phm->updateHk(ik);
@@ -58,7 +61,8 @@ void Evolve_elec::solve_psi(const int& istep,
                        nullptr,
                        &(ekb(ik, 0)),
                        htype,
-                       propagator);
+                       propagator,
+                       &Sk_lu[ik]);
         }
         else if (htype == 1)
         {
@@ -72,7 +76,8 @@ void Evolve_elec::solve_psi(const int& istep,
                        Sk_laststep[ik],
                        &(ekb(ik, 0)),
                        htype,
-                       propagator);
+                       propagator,
+                       &Sk_lu[ik]);
         }
         else
         {
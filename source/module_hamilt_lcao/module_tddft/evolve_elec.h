@@ -8,6 +8,7 @@
 #include "module_hamilt_lcao/hamilt_lcaodft/LCAO_hamilt.h"
 #include "module_hamilt_lcao/hamilt_lcaodft/hamilt_lcao.h"
 #include "module_psi/psi.h"
+#include "propagator.h"
 
 //-----------------------------------------------------------
 // mohan add 2021-02-09
@@ -48,6 +49,7 @@ class Evolve_elec
                           psi::Psi<std::complex<double>>* psi_laststep,
                           std::complex<double>** Hk_laststep,
                           std::complex<double>** Sk_laststep,
+                          std::vector<OverlapLU>& Sk_lu,
                           ModuleBase::matrix& ekb,
                           int htype,
                           int propagator,
@@ -11,7 +11,6 @@
 #include "module_io/input.h"
 #include "norm_psi.h"
 #include "propagator.h"
-#include "upsi.h"
 
 namespace module_tddft
 {
@@ -25,7 +24,8 @@ void evolve_psi(const int nband,
                 std::complex<double>* S_laststep,
                 double* ekb,
                 int htype,
-                int propagator)
+                int propagator,
+                OverlapLU* s_lu)
 {
     ModuleBase::TITLE("Evolve_psi", "evolve_psi");
     time_t time_start = time(NULL);
@@ -49,9 +49,6 @@ void evolve_psi(const int nband,
     ModuleBase::GlobalFunc::ZEROS(Hold, pv->nloc);
     BlasConnector::copy(pv->nloc, h_mat.p, 1, Hold, 1);
 
-    std::complex<double>* U_operator = new std::complex<double>[pv->nloc];
-    ModuleBase::GlobalFunc::ZEROS(U_operator, pv->nloc);
-
     // (1)->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
     /// @brief compute H(t+dt/2)
@@ -64,27 +61,21 @@ void evolve_psi(const int nband,
 
     // (2)->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
-    /// @brief compute U_operator
-    /// @input Stmp, Htmp, print_matrix
-    /// @output U_operator
-    Propagator prop(propagator, pv);
-    prop.compute_propagator(nlocal, Stmp, Htmp, H_laststep, U_operator, print_matrix);
-
-    // (3)->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-
-    /// @brief apply U_operator to the wave function of the previous step for new wave function
-    /// @input U_operator, psi_k_laststep, print_matrix
+    /// @brief apply the propagator to the wave function of the previous step for new wave function,
+    ///        the nlocal*nlocal propagator is never formed
+    /// @input Stmp, Htmp, H_laststep, psi_k_laststep
     /// @output psi_k
-    upsi(pv, nband, nlocal, U_operator, psi_k_laststep, psi_k, print_matrix);
+    Propagator prop(propagator, pv, s_lu);
+    prop.propagate_psi(nlocal, nband, Stmp, Htmp, H_laststep, psi_k_laststep, psi_k);
 
-    // (4)->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+    // (3)->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
     /// @brief normalize psi_k
     /// @input Stmp, psi_not_norm, psi_k, print_matrix
     /// @output psi_k
     norm_psi(pv, nband, nlocal, Stmp, psi_k, print_matrix);
 
-    // (5)->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+    // (4)->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
     /// @brief compute ekb
     /// @input Htmp, psi_k
@@ -94,7 +85,6 @@ void evolve_psi(const int nband,
     delete[] Stmp;
     delete[] Htmp;
     delete[] Hold;
-    delete[] U_operator;
 
 #endif
 
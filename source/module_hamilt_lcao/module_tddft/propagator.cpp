@@ -1,14 +1,21 @@
 #include "propagator.h"
 
+#include <algorithm>
+#include <cmath>
 #include <complex>
 #include <iostream>
 
 #include "module_base/lapack_connector.h"
 #include "module_base/scalapack_connector.h"
+#include "module_base/timer.h"
+#include "module_base/tool_quit.h"
 #include "module_io/input.h"
 
 namespace module_tddft
 {
+const int Propagator::krylov_max_dim;
+constexpr double Propagator::krylov_thr;
+
 Propagator::~Propagator()
 {
 }
@@ -23,6 +30,66 @@ inline int globalIndex(int localindex, int nblk, int nprocs, int myproc)
     return gIndex;
 }
 
+// dots[ib] = a_ib^H b_ib for every band ib, summed over all processes
+static void column_dots(const Parallel_Orbitals* pv,
+                        const int nband,
+                        const std::complex<double>* a,
+                        const std::complex<double>* b,
+                        std::vector<std::complex<double>>& dots)
+{
+    dots.assign(nband, 0.0);
+    for (int ic = 0; ic < pv->ncol_bands; ++ic)
+    {
+        const int ib = globalIndex(ic, pv->nb, pv->dim1, pv->coord[1]);
+        if (ib >= nband)
+        {
+            continue;
+        }
+        std::complex<double> sum = 0.0;
+        for (int ir = 0; ir < pv->nrow; ++ir)
+        {
+            sum += std::conj(a[ic * pv->nrow + ir]) * b[ic * pv->nrow + ir];
+        }
+        dots[ib] = sum;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, dots.data(), nband, MPI_DOUBLE_COMPLEX, MPI_SUM, pv->comm_2D);
+}
+
+// y = exp(-i tau T) e_1 for the n x n symmetric tridiagonal T with diagonal alpha and off-diagonal beta
+static void expm_tridiag(const int n,
+                         const double* alpha,
+                         const double* beta,
+                         const double tau,
+                         std::complex<double>* y)
+{
+    std::vector<double> t(n * n, 0.0);
+    for (int i = 0; i < n; ++i)
+    {
+        t[i * n + i] = alpha[i];
+        if (i + 1 < n)
+        {
+            t[i * n + i + 1] = t[(i + 1) * n + i] = beta[i];
+        }
+    }
+    std::vector<double> w(n);
+    int lwork = 3 * n;
+    std::vector<double> work(lwork);
+    int info = 0;
+    dsyev_("V", "U", &n, t.data(), &n, w.data(), work.data(), &lwork, &info);
+    if (info != 0)
+    {
+        ModuleBase::WARNING_QUIT("Propagator", "dsyev failed in the Lanczos propagator");
+    }
+    for (int i = 0; i < n; ++i)
+    {
+        y[i] = 0.0;
+        for (int l = 0; l < n; ++l)
+        {
+            y[i] += t[l * n + i] * t[l * n] * std::exp(std::complex<double>(0.0, -tau * w[l]));
+        }
+    }
+}
+
 void Propagator::compute_propagator(const int nlocal,
                                     const std::complex<double>* Stmp,
                                     const std::complex<double>* Htmp,
@@ -53,6 +120,400 @@ void Propagator::compute_propagator(const int nlocal,
     }
 }
 
+void Propagator::propagate_psi(const int nlocal,
+                               const int nband,
+                               const std::complex<double>* Stmp,
+                               const std::complex<double>* Htmp,
+                               const std::complex<double>* H_laststep,
+                               const std::complex<double>* psi_k_laststep,
+                               std::complex<double>* psi_k)
+{
+    ModuleBase::timer::tick("Propagator", "propagate_psi");
+    switch (ptype)
+    {
+    case 0:
+        propagate_psi_cn2(nlocal, nband, Stmp, Htmp, psi_k_laststep, psi_k);
+        break;
+
+    case 1:
+        update_s_lu(nlocal, Stmp);
+        propagate_psi_taylor(nlocal, nband, Htmp, psi_k_laststep, psi_k, 1);
+        break;
+
+    case 2:
+    {
+        // U = U_2(H(t+dt)) U_2(H(t)), applied from the right
+        update_s_lu(nlocal, Stmp);
+        std::vector<std::complex<double>> psi_half(this->ParaV->nrow * this->ParaV->ncol_bands);
+        propagate_psi_taylor(nlocal, nband, H_laststep, psi_k_laststep, psi_half.data(), 2);
+        propagate_psi_taylor(nlocal, nband, Htmp, psi_half.data(), psi_k, 2);
+        break;
+    }
+
+    case 3:
+        update_s_lu(nlocal, Stmp);
+        propagate_psi_lanczos(nlocal, nband, Stmp, Htmp, psi_k_laststep, psi_k);
+        break;
+
+    default:
+        ModuleBase::WARNING_QUIT("Propagator", "method of propagator is wrong");
+        break;
+    }
+    ModuleBase::timer::tick("Propagator", "propagate_psi");
+}
+
+void Propagator::update_s_lu(const int nlocal, const std::complex<double>* Stmp)
+{
+    const int nloc = this->ParaV->nloc;
+    // every process has to take the same decision, S may only change on some of them
+    int changed = (this->s_lu->s.size() != static_cast<size_t>(nloc)
+                   || !std::equal(Stmp, Stmp + nloc, this->s_lu->s.begin()));
+    MPI_Allreduce(MPI_IN_PLACE, &changed, 1, MPI_INT, MPI_MAX, this->ParaV->comm_2D);
+    if (!changed)
+    {
+        return;
+    }
+
+    ModuleBase::timer::tick("Propagator", "factorize_s");
+    this->s_lu->s.assign(Stmp, Stmp + nloc);
+    this->s_lu->lu = this->s_lu->s;
+    this->s_lu->ipiv.assign(this->ParaV->nrow + this->ParaV->nb, 0);
+    int info = 0;
+    ScalapackConnector::getrf(nlocal, nlocal, this->s_lu->lu.data(), 1, 1, this->ParaV->desc, this->s_lu->ipiv.data(), &info);
+    if (info != 0)
+    {
+        ModuleBase::WARNING_QUIT("Propagator", "LU factorization of S failed");
+    }
+    ModuleBase::timer::tick("Propagator", "factorize_s");
+}
+
+void Propagator::solve_s(const int nlocal, const int nband, std::complex<double>* b) const
+{
+    int info = 0;
+    ScalapackConnector::getrs('N',
+                              nlocal,
+                              nband,
+                              this->s_lu->lu.data(),
+                              1,
+                              1,
+                              this->ParaV->desc,
+                              this->s_lu->ipiv.data(),
+                              b,
+                              1,
+                              1,
+                              this->ParaV->desc_wfc,
+                              &info);
+    if (info != 0)
+    {
+        ModuleBase::WARNING_QUIT("Propagator", "solving S x = b with the LU factors of S failed");
+    }
+}
+
+void Propagator::propagate_psi_cn2(const int nlocal,
+                                   const int nband,
+                                   const std::complex<double>* Stmp,
+                                   const std::complex<double>* Htmp,
+                                   const std::complex<double>* psi_k_laststep,
+                                   std::complex<double>* psi_k) const
+{
+    // Numerator = Stmp - i*para * Htmp;     beta1 = - para = -0.25 * INPUT.mdp.md_dt
+    // Denominator = Stmp + i*para * Htmp;   beta2 = para = 0.25 * INPUT.mdp.md_dt
+    const std::complex<double> alpha = {1.0, 0.0};
+    const std::complex<double> beta1 = {0.0, -0.25 * INPUT.mdp.md_dt};
+    const std::complex<double> beta2 = {0.0, 0.25 * INPUT.mdp.md_dt};
+
+    std::vector<std::complex<double>> Numerator(Htmp, Htmp + this->ParaV->nloc);
+    ScalapackConnector::geadd('N', nlocal, nlocal, alpha, Stmp, 1, 1, this->ParaV->desc, beta1, Numerator.data(), 1, 1, this->ParaV->desc);
+
+    // psi_k = Numerator * psi_k_laststep
+    ScalapackConnector::gemm('N',
+                             'N',
+                             nlocal,
+                             nband,
+                             nlocal,
+                             1.0,
+                             Numerator.data(),
+                             1,
+                             1,
+                             this->ParaV->desc,
+                             psi_k_laststep,
+                             1,
+                             1,
+                             this->ParaV->desc_wfc,
+                             0.0,
+                             psi_k,
+                             1,
+                             1,
+                             this->ParaV->desc_wfc);
+
+    // solve Denominator * psi_k = Numerator * psi_k_laststep, the buffer of Numerator is reused
+    std::vector<std::complex<double>>& Denominator = Numerator;
+    std::copy(Htmp, Htmp + this->ParaV->nloc, Denominator.begin());
+    ScalapackConnector::geadd('N', nlocal, nlocal, alpha, Stmp, 1, 1, this->ParaV->desc, beta2, Denominator.data(), 1, 1, this->ParaV->desc);
+
+    std::vector<int> ipiv(this->ParaV->nrow + this->ParaV->nb, 0);
+    int info = 0;
+    ScalapackConnector::getrf(nlocal, nlocal, Denominator.data(), 1, 1, this->ParaV->desc, ipiv.data(), &info);
+    if (info != 0)
+    {
+        ModuleBase::WARNING_QUIT("Propagator", "LU factorization of the Crank-Nicolson denominator failed");
+    }
+    ScalapackConnector::getrs('N',
+                              nlocal,
+                              nband,
+                              Denominator.data(),
+                              1,
+                              1,
+                              this->ParaV->desc,
+                              ipiv.data(),
+                              psi_k,
+                              1,
+                              1,
+                              this->ParaV->desc_wfc,
+                              &info);
+    if (info != 0)
+    {
+        ModuleBase::WARNING_QUIT("Propagator", "solving the Crank-Nicolson equation failed");
+    }
+}
+
+void Propagator::propagate_psi_taylor(const int nlocal,
+                                      const int nband,
+                                      const std::complex<double>* Htmp,
+                                      const std::complex<double>* psi_k_laststep,
+                                      std::complex<double>* psi_k,
+                                      const int tag) const
+{
+    const int size = this->ParaV->nrow * this->ParaV->ncol_bands;
+    const std::complex<double> beta = {0.0, -0.5 * INPUT.mdp.md_dt / tag}; // for ETRS tag=2 , for taylor tag=1
+
+    // term_n = A term_{n-1} / n with A = beta S^-1 H, psi_k = sum_{n=0}^{4} term_n
+    std::vector<std::complex<double>> term(psi_k_laststep, psi_k_laststep + size);
+    std::vector<std::complex<double>> hterm(size);
+    BlasConnector::copy(size, psi_k_laststep, 1, psi_k, 1);
+    for (int n = 1; n <= 4; ++n)
+    {
+        ScalapackConnector::gemm('N',
+                                 'N',
+                                 nlocal,
+                                 nband,
+                                 nlocal,
+                                 1.0,
+                                 Htmp,
+                                 1,
+                                 1,
+                                 this->ParaV->desc,
+                                 term.data(),
+                                 1,
+                                 1,
+                                 this->ParaV->desc_wfc,
+                                 0.0,
+                                 hterm.data(),
+                                 1,
+                                 1,
+                                 this->ParaV->desc_wfc);
+        solve_s(nlocal, nband, hterm.data());
+        const std::complex<double> factor = beta / static_cast<double>(n);
+        for (int i = 0; i < size; ++i)
+        {
+            term[i] = factor * hterm[i];
+            psi_k[i] += term[i];
+        }
+    }
+}
+
+void Propagator::propagate_psi_lanczos(const int nlocal,
+                                       const int nband,
+                                       const std::complex<double>* Stmp,
+                                       const std::complex<double>* Htmp,
+                                       const std::complex<double>* psi_k_laststep,
+                                       std::complex<double>* psi_k) const
+{
+    // S^{-1}H is Hermitian in the S inner product, so the Lanczos recursion with <u|S|v> gives a real
+    // tridiagonal T for each band and exp(-i tau S^{-1}H) psi = |psi|_S V exp(-i tau T) e_1.
+    // All bands are run together: one H * V and one solve with S per step.
+    const int nrow = this->ParaV->nrow;
+    const int ncol = this->ParaV->ncol_bands;
+    const int size = nrow * ncol;
+    const double tau = 0.5 * INPUT.mdp.md_dt;
+    const int mmax = std::min(krylov_max_dim, nlocal);
+
+    std::vector<int> band(ncol, nband);
+    for (int ic = 0; ic < ncol; ++ic)
+    {
+        band[ic] = globalIndex(ic, this->ParaV->nb, this->ParaV->dim1, this->ParaV->coord[1]);
+    }
+
+    // Lanczos vectors v_k, and S v_k of the last two steps
+    std::vector<std::vector<std::complex<double>>> v(1, std::vector<std::complex<double>>(size));
+    std::vector<std::complex<double>> sv(size), sv_last(size, 0.0), u(size), su(size);
+
+    ScalapackConnector::gemm('N',
+                             'N',
+                             nlocal,
+                             nband,
+                             nlocal,
+                             1.0,
+                             Stmp,
+                             1,
+                             1,
+                             this->ParaV->desc,
+                             psi_k_laststep,
+                             1,
+                             1,
+                             this->ParaV->desc_wfc,
+                             0.0,
+                             sv.data(),
+                             1,
+                             1,
+                             this->ParaV->desc_wfc);
+    std::vector<std::complex<double>> dots;
+    column_dots(this->ParaV, nband, psi_k_laststep, sv.data(), dots);
+    std::vector<double> norm(nband);
+    for (int ib = 0; ib < nband; ++ib)
+    {
+        norm[ib] = std::sqrt(std::max(dots[ib].real(), 0.0));
+    }
+    for (int ic = 0; ic < ncol; ++ic)
+    {
+        const double scale = (band[ic] < nband && norm[band[ic]] > 0.0) ? 1.0 / norm[band[ic]] : 0.0;
+        for (int ir = 0; ir < nrow; ++ir)
+        {
+            v[0][ic * nrow + ir] = psi_k_laststep[ic * nrow + ir] * scale;
+            sv[ic * nrow + ir] *= scale;
+        }
+    }
+
+    // alpha and beta of band ib are stored at ib * mmax + k
+    std::vector<double> alpha(nband * mmax, 0.0), beta(nband * mmax, 0.0);
+    std::vector<std::complex<double>> y(nband * mmax, 0.0);
+    std::vector<int> dim(nband, 0); // dimension of the converged Krylov space, 0 if not converged yet
+    double max_error = 0.0;
+
+    for (int k = 0; k < mmax; ++k)
+    {
+        // su = H v_k, u = S^-1 H v_k
+        ScalapackConnector::gemm('N',
+                                 'N',
+                                 nlocal,
+                                 nband,
+                                 nlocal,
+                                 1.0,
+                                 Htmp,
+                                 1,
+                                 1,
+                                 this->ParaV->desc,
+                                 v[k].data(),
+                                 1,
+                                 1,
+                                 this->ParaV->desc_wfc,
+                                 0.0,
+                                 su.data(),
+                                 1,
+                                 1,
+                                 this->ParaV->desc_wfc);
+        u = su;
+        solve_s(nlocal, nband, u.data());
+
+        column_dots(this->ParaV, nband, v[k].data(), su.data(), dots);
+        for (int ib = 0; ib < nband; ++ib)
+        {
+            alpha[ib * mmax + k] = dots[ib].real();
+        }
+
+        // u -= alpha_k v_k + beta_{k-1} v_{k-1}, and the same for S u
+        for (int ic = 0; ic < ncol; ++ic)
+        {
+            if (band[ic] >= nband)
+            {
+                continue;
+            }
+            const double a = alpha[band[ic] * mmax + k];
+            const double b = (k > 0) ? beta[band[ic] * mmax + k - 1] : 0.0;
+            for (int ir = 0; ir < nrow; ++ir)
+            {
+                const int i = ic * nrow + ir;
+                u[i] -= a * v[k][i];
+                if (k > 0)
+                {
+                    u[i] -= b * v[k - 1][i];
+                }
+                su[i] -= a * sv[i] + b * sv_last[i];
+            }
+        }
+
+        column_dots(this->ParaV, nband, u.data(), su.data(), dots);
+        bool all_done = true;
+        for (int ib = 0; ib < nband; ++ib)
+        {
+            if (dim[ib] > 0)
+            {
+                continue;
+            }
+            beta[ib * mmax + k] = std::sqrt(std::max(dots[ib].real(), 0.0));
+            expm_tridiag(k + 1, &alpha[ib * mmax], &beta[ib * mmax], tau, &y[ib * mmax]);
+            // the next Lanczos vector would enter with weight beta_k |y_k|
+            const double error = beta[ib * mmax + k] * std::abs(y[ib * mmax + k]);
+            if (error < krylov_thr || k + 1 == mmax)
+            {
+                dim[ib] = k + 1;
+                max_error = std::max(max_error, error);
+            }
+            else
+            {
+                all_done = false;
+            }
+        }
+        if (all_done)
+        {
+            break;
+        }
+
+        // v_{k+1} = u / beta_k, the columns of converged bands are set to zero
+        v.emplace_back(size);
+        for (int ic = 0; ic < ncol; ++ic)
+        {
+            const int ib = band[ic];
+            const double scale = (ib < nband && dim[ib] == 0) ? 1.0 / beta[ib * mmax + k] : 0.0;
+            for (int ir = 0; ir < nrow; ++ir)
+            {
+                const int i = ic * nrow + ir;
+                v[k + 1][i] = u[i] * scale;
+                sv_last[i] = sv[i];
+                sv[i] = su[i] * scale;
+            }
+        }
+    }
+
+    if (max_error > krylov_thr)
+    {
+        GlobalV::ofs_running << " Lanczos propagator is not converged in " << mmax
+                             << " steps, error estimate = " << max_error << std::endl;
+    }
+
+    // psi_k = |psi|_S sum_k y_k v_k
+    for (int ic = 0; ic < ncol; ++ic)
+    {
+        const int ib = band[ic];
+        for (int ir = 0; ir < nrow; ++ir)
+        {
+            psi_k[ic * nrow + ir] = 0.0;
+        }
+        if (ib >= nband)
+        {
+            continue;
+        }
+        for (int k = 0; k < dim[ib]; ++k)
+        {
+            const std::complex<double> c = norm[ib] * y[ib * mmax + k];
+            for (int ir = 0; ir < nrow; ++ir)
+            {
+                psi_k[ic * nrow + ir] += c * v[k][ic * nrow + ir];
+            }
+        }
+    }
+}
+
 void Propagator::compute_propagator_cn2(const int nlocal,
                                         const std::complex<double>* Stmp,
                                         const std::complex<double>* Htmp,
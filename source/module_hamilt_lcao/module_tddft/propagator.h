@@ -8,15 +8,35 @@
 
 #include "module_basis/module_ao/parallel_orbitals.h"
 
+#include <complex>
+#include <vector>
+
 namespace module_tddft
 {
+/**
+ * @brief LU factorization of the overlap matrix of one k point
+ *  It is kept by the caller between electronic steps and only recomputed when S changes.
+ */
+struct OverlapLU
+{
+    std::vector<std::complex<double>> s;  ///< the S matrix which lu belongs to
+    std::vector<std::complex<double>> lu; ///< LU factors of S in the 2D block distribution
+    std::vector<int> ipiv;
+};
+
 class Propagator
 {
   public:
-    Propagator(const int ptype, const Parallel_Orbitals* pv)
+    /**
+     * @param ptype type of propagator, 0: CN, 1: 4th Taylor, 2: ETRS, 3: Lanczos
+     * @param pv information of parallel
+     * @param s_lu factorization of S kept between calls, nullptr to factorize S in every call
+     */
+    Propagator(const int ptype, const Parallel_Orbitals* pv, OverlapLU* s_lu = nullptr)
     {
         this->ptype = ptype;
         this->ParaV = pv;
+        this->s_lu = (s_lu == nullptr) ? &this->own_lu : s_lu;
     }
     ~Propagator();
 
@@ -37,14 +57,73 @@ class Propagator
                             const std::complex<double>* H_laststep,
                             std::complex<double>* U_operator,
                             const int print_matrix) const;
+
+    /**
+     *  @brief evolve the wave functions without forming the propagator
+     *  Only the nband columns of psi are touched: CN solves with the LU factors of its denominator,
+     *  Taylor and ETRS apply S^{-1}H column by column, and the Lanczos method builds the Krylov
+     *  space of S^{-1}H for every band. The LU factors of S are reused while S does not change.
+     *
+     * @param[in] nlocal number of orbitals
+     * @param[in] nband number of bands
+     * @param[in] Stmp overlap matrix
+     * @param[in] Htmp H(t+dt/2) or H(t+dt)
+     * @param[in] H_laststep H(t)
+     * @param[in] psi_k_laststep psi of last step
+     * @param[out] psi_k psi of this step
+     */
+    void propagate_psi(const int nlocal,
+                       const int nband,
+                       const std::complex<double>* Stmp,
+                       const std::complex<double>* Htmp,
+                       const std::complex<double>* H_laststep,
+                       const std::complex<double>* psi_k_laststep,
+                       std::complex<double>* psi_k);
 #endif
 
+    /// maximal dimension of the Krylov space of the Lanczos propagator
+    static const int krylov_max_dim = 30;
+    /// threshold of the error estimate of each band of the Lanczos propagator
+    static constexpr double krylov_thr = 1.0e-10;
+
   private:
     int ptype; // type of propagator
     const Parallel_Orbitals* ParaV;
+    OverlapLU* s_lu = nullptr;
+    OverlapLU own_lu;
 
 #ifdef __MPI
 
+    /// factorize S, unless s_lu already holds the factors of Stmp
+    void update_s_lu(const int nlocal, const std::complex<double>* Stmp);
+
+    /// b = S^{-1} b for the nband columns of b
+    void solve_s(const int nlocal, const int nband, std::complex<double>* b) const;
+
+    /// psi_k = (S + i dt/4 H)^{-1} (S - i dt/4 H) psi_k_laststep
+    void propagate_psi_cn2(const int nlocal,
+                           const int nband,
+                           const std::complex<double>* Stmp,
+                           const std::complex<double>* Htmp,
+                           const std::complex<double>* psi_k_laststep,
+                           std::complex<double>* psi_k) const;
+
+    /// psi_k = sum_{n<=4} (-i dt/(2 tag) S^{-1} H)^n / n! psi_k_laststep
+    void propagate_psi_taylor(const int nlocal,
+                              const int nband,
+                              const std::complex<double>* Htmp,
+                              const std::complex<double>* psi_k_laststep,
+                              std::complex<double>* psi_k,
+                              const int tag) const;
+
+    /// psi_k = exp(-i dt/2 S^{-1} H) psi_k_laststep in the Krylov space of each band
+    void propagate_psi_lanczos(const int nlocal,
+                               const int nband,
+                               const std::complex<double>* Stmp,
+                               const std::complex<double>* Htmp,
+                               const std::complex<double>* psi_k_laststep,
+                               std::complex<double>* psi_k) const;
+
     /**
      *  @brief compute propagator of method Crank-Nicolson
      *
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <module_base/scalapack_connector.h>
+#include <mpi.h>
+
+#include "module_base/lapack_connector.h"
+#include "module_basis/module_ao/parallel_orbitals.h"
+#include "module_hamilt_lcao/module_tddft/propagator.h"
+#include "module_io/input.h"
+#include "tddft_test.h"
+
+/************************************************
+ *  unit test of functions in propagator.h
+ ***********************************************/
+
+/**
+ * - Tested Function
+ *   - Propagator::propagate_psi
+ *     - CN, 4th Taylor and ETRS give the same psi as applying the propagator matrix.
+ *     - the Lanczos propagator gives exp(-i dt/2 S^{-1}H) psi.
+ *     - the LU factors of S are kept in OverlapLU.
+ */
+
+#define doublethreshold 1e-8
+
+class PropagatePsiTest : public testing::Test
+{
+  protected:
+    const int nlocal = 4;
+    const int nband = 2;
+    Parallel_Orbitals pv;
+    std::vector<std::complex<double>> Stmp, Htmp, Hlaststep, psi;
+
+    void SetUp() override
+    {
+        pv.nloc = nlocal * nlocal;
+        pv.ncol = nlocal;
+        pv.nrow = nlocal;
+        pv.ncol_bands = nband;
+        pv.dim0 = 1;
+        pv.dim1 = 1;
+        pv.nb = 1;
+        pv.coord[0] = 0;
+        pv.coord[1] = 0;
+
+        int dim[2] = {nprow, npcol};
+        int period[2] = {1, 1};
+        MPI_Cart_create(MPI_COMM_WORLD, 2, dim, period, 0, &pv.comm_2D);
+
+        int info;
+        int mb = 1, nb = 1;
+        int irsrc = 0, icsrc = 0, lld = numroc_(&nlocal, &mb, &myprow, &irsrc, &nprow);
+        int nlocal_ = nlocal, nband_ = nband;
+        descinit_(pv.desc, &nlocal_, &nlocal_, &mb, &nb, &irsrc, &icsrc, &ictxt, &lld, &info);
+        descinit_(pv.desc_wfc, &nlocal_, &nband_, &mb, &nb, &irsrc, &icsrc, &ictxt, &lld, &info);
+
+        // Hermitian H, H_laststep and positive definite S, stored column-major
+        Stmp.assign(nlocal * nlocal, 0.0);
+        Htmp.assign(nlocal * nlocal, 0.0);
+        Hlaststep.assign(nlocal * nlocal, 0.0);
+        for (int i = 0; i < nlocal; ++i)
+        {
+            Stmp[i * nlocal + i] = 1.0;
+            Htmp[i * nlocal + i] = 0.5 * i - 0.4;
+            Hlaststep[i * nlocal + i] = 0.5 * i - 0.3;
+            if (i + 1 < nlocal)
+            {
+                Stmp[i * nlocal + i + 1] = Stmp[(i + 1) * nlocal + i] = 0.2;
+                Htmp[i * nlocal + i + 1] = std::complex<double>(0.1, 0.2);
+                Htmp[(i + 1) * nlocal + i] = std::complex<double>(0.1, -0.2);
+                Hlaststep[i * nlocal + i + 1] = std::complex<double>(0.15, 0.1);
+                Hlaststep[(i + 1) * nlocal + i] = std::complex<double>(0.15, -0.1);
+            }
+        }
+
+        psi.assign(nlocal * nband, 0.0);
+        for (int ib = 0; ib < nband; ++ib)
+        {
+            for (int i = 0; i < nlocal; ++i)
+            {
+                psi[ib * nlocal + i] = std::complex<double>(1.0 + i * ib, 0.1 * i);
+            }
+        }
+    }
+
+    void TearDown() override
+    {
+        MPI_Comm_free(&pv.comm_2D);
+    }
+};
+
+TEST_F(PropagatePsiTest, SameAsPropagatorMatrix)
+{
+    INPUT.mdp.md_dt = 0.5;
+    for (int ptype = 0; ptype < 3; ++ptype)
+    {
+        std::vector<std::complex<double>> U_operator(nlocal * nlocal, 0.0);
+        module_tddft::Propagator prop_u(ptype, &pv);
+        prop_u.compute_propagator(nlocal, Stmp.data(), Htmp.data(), Hlaststep.data(), U_operator.data(), 0);
+
+        module_tddft::OverlapLU s_lu;
+        module_tddft::Propagator prop(ptype, &pv, &s_lu);
+        std::vector<std::complex<double>> psi_new(nlocal * nband, 0.0);
+        prop.propagate_psi(nlocal, nband, Stmp.data(), Htmp.data(), Hlaststep.data(), psi.data(), psi_new.data());
+
+        for (int ib = 0; ib < nband; ++ib)
+        {
+            for (int i = 0; i < nlocal; ++i)
+            {
+                std::complex<double> ref = 0.0;
+                for (int j = 0; j < nlocal; ++j)
+                {
+                    ref += U_operator[j * nlocal + i] * psi[ib * nlocal + j];
+                }
+                EXPECT_NEAR(psi_new[ib * nlocal + i].real(), ref.real(), doublethreshold);
+                EXPECT_NEAR(psi_new[ib * nlocal + i].imag(), ref.imag(), doublethreshold);
+            }
+        }
+
+        // CN does not need S^{-1}, the other propagators keep the factors of S
+        if (ptype == 0)
+        {
+            EXPECT_TRUE(s_lu.s.empty());
+        }
+        else
+        {
+            EXPECT_EQ(s_lu.s, Stmp);
+        }
+    }
+}
+
+TEST_F(PropagatePsiTest, Lanczos)
+{
+    INPUT.mdp.md_dt = 4.0;
+    const double tau = 0.5 * INPUT.mdp.md_dt;
+
+    // reference: psi(t) = C exp(-i tau e) C^H S psi with H C = S C e
+    std::vector<std::complex<double>> c = Htmp, s = Stmp;
+    std::vector<double> e(nlocal), rwork(3 * nlocal);
+    std::vector<std::complex<double>> work(2 * nlocal);
+    const int itype = 1;
+    int lwork = 2 * nlocal;
+    int info = 0;
+    zhegv_(&itype, "V", "U", &nlocal, c.data(), &nlocal, s.data(), &nlocal, e.data(), work.data(), &lwork, rwork.data(), &info);
+    ASSERT_EQ(info, 0);
+
+    module_tddft::OverlapLU s_lu;
+    for (int step = 0; step < 2; ++step)
+    {
+        // the second step reuses the factors of S
+        module_tddft::Propagator prop(3, &pv, &s_lu);
+        std::vector<std::complex<double>> psi_new(nlocal * nband, 0.0);
+        prop.propagate_psi(nlocal, nband, Stmp.data(), Htmp.data(), Hlaststep.data(), psi.data(), psi_new.data());
+        EXPECT_EQ(s_lu.s, Stmp);
+
+        for (int ib = 0; ib < nband; ++ib)
+        {
+            std::vector<std::complex<double>> coef(nlocal, 0.0);
+            for (int l = 0; l < nlocal; ++l)
+            {
+                for (int i = 0; i < nlocal; ++i)
+                {
+                    for (int j = 0; j < nlocal; ++j)
+                    {
+                        coef[l] += std::conj(c[l * nlocal + i]) * Stmp[j * nlocal + i] * psi[ib * nlocal + j];
+                    }
+                }
+                coef[l] *= std::exp(std::complex<double>(0.0, -tau * e[l]));
+            }
+            for (int i = 0; i < nlocal; ++i)
+            {
+                std::complex<double> ref = 0.0;
+                for (int l = 0; l < nlocal; ++l)
+                {
+                    ref += c[l * nlocal + i] * coef[l];
+                }
+                EXPECT_NEAR(psi_new[ib * nlocal + i].real(), ref.real(), doublethreshold);
+                EXPECT_NEAR(psi_new[ib * nlocal + i].imag(), ref.imag(), doublethreshold);
+            }
+        }
+    }
+}
@@ -2,6 +2,7 @@
 
 #include "module_base/libm/libm.h"
 #include "module_base/math_integral.h"
+#include "module_base/radial_form_factor.h"
 #include "module_base/timer.h"
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
 
@@ -179,6 +180,20 @@ void pseudopot_cell_vl::vloc_of_g(const int& msh,
 		aux1 [ir] = r[ir] * vloc_at [ir] + fac * erf(r[ir]);
 	} 
 
+	// here the transform of aux1/r is tabulated once on a uniform q grid by FFT
+	// and interpolated onto the |G| shells, the erf part is added below
+	if (GlobalV::PSEUDO_SBT_FFT && rho_basis->ngg > igl0)
+	{
+		std::vector<double> gx(rho_basis->ngg - igl0);
+		for (int ig = igl0; ig < rho_basis->ngg; ig++)
+		{
+			gx[ig - igl0] = std::sqrt(rho_basis->gg_uniq[ig] * GlobalC::ucell.tpiba2);
+		}
+		ModuleBase::RadialFormFactor vloc_ff;
+		vloc_ff.build(0, msh, r, aux1, 1, gx.back());
+		vloc_ff.eval(gx.size(), gx.data(), &vloc_1d[igl0]);
+	}
+
 	// here we perform the integral, after multiplying for the |G|
 	// dependent part
 #ifdef _OPENMP
@@ -194,11 +209,14 @@ void pseudopot_cell_vl::vloc_of_g(const int& msh,
 	{
 		double gx2= rho_basis->gg_uniq[ig] * GlobalC::ucell.tpiba2;
 		double gx = std::sqrt(gx2);
-		for (int ir = 0;ir < msh;ir++) 
+		if (!GlobalV::PSEUDO_SBT_FFT)
 		{
-			aux [ir] = aux1 [ir] * ModuleBase::libm::sin(gx * r [ir]) / gx;
+			for (int ir = 0;ir < msh;ir++) 
+			{
+				aux [ir] = aux1 [ir] * ModuleBase::libm::sin(gx * r [ir]) / gx;
+			}
+			ModuleBase::Integral::Simpson_Integral(msh, aux, rab, vloc_1d[ig] );
 		}
-		ModuleBase::Integral::Simpson_Integral(msh, aux, rab, vloc_1d[ig] );
 		//  here we add the analytic fourier transform of the erf function
 		vloc_1d[ig] -= fac * ModuleBase::libm::exp(- gx2 * 0.25)/ gx2;
 	} // enddo
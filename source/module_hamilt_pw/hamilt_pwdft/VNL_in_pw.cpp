@@ -8,6 +8,7 @@
 #include "module_base/math_sphbes.h"
 #include "module_base/math_polyint.h"
 #include "module_base/math_ylmreal.h"
+#include "module_base/radial_form_factor.h"
 #include "module_hamilt_pw/hamilt_pwdft/soc.h"
 #include "module_base/timer.h"
 #include "module_base/memory.h"
@@ -582,6 +583,12 @@ void pseudopot_cell_vnl::init_vnl(UnitCell &cell)
 		for (int ib = 0;ib < nbeta;ib++)
 		{
 			const int l = cell.atoms[it].ncpp.lll[ib];
+			if (GlobalV::PSEUDO_SBT_FFT)
+			{
+				// tabulated by FFT and interpolated onto the q points of tab
+				this->sbt_table(l, kkbeta, cell.atoms[it].ncpp.r, &cell.atoms[it].ncpp.betar(ib, 0), pref, &this->tab(it, ib, 0));
+				continue;
+			}
 			for (int iq=0; iq<GlobalV::NQX; iq++)  
 			{
 				const double q = iq * GlobalV::DQ;
@@ -629,6 +636,28 @@ void pseudopot_cell_vnl::init_vnl(UnitCell &cell)
 	return;
 }
 
+void pseudopot_cell_vnl::sbt_table(const int l,
+                                   const int mesh,
+                                   const double* r,
+                                   const double* rfunc,
+                                   const double pref,
+                                   double* table) const
+{
+	std::vector<double> q(GlobalV::NQX);
+	for (int iq = 0; iq < GlobalV::NQX; iq++)
+	{
+		q[iq] = iq * GlobalV::DQ;
+	}
+	// \int r^2 (rfunc/r) j_l(qr) dr
+	ModuleBase::RadialFormFactor ff;
+	ff.build(l, mesh, r, rfunc, 1, q.back());
+	ff.eval(GlobalV::NQX, q.data(), table);
+	for (int iq = 0; iq < GlobalV::NQX; iq++)
+	{
+		table[iq] *= pref;
+	}
+}
+
 #ifdef __LCAO
 std::complex<double> pseudopot_cell_vnl::Cal_C(int alpha, int lu, int mu, int L, int M)   // pengfei Li  2018-3-23
 {
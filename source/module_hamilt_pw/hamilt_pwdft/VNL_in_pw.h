@@ -35,6 +35,10 @@ public:
 
 	void init_vnl(UnitCell &cell);
 
+	/// fills table[iq] = pref * \int rfunc(r) j_l(q r) r dr at q = iq * DQ (iq < NQX),
+	/// the transform is done by FFT on a uniform radial grid (pseudo_sbt_fft)
+	void sbt_table(const int l, const int mesh, const double* r, const double* rfunc, const double pref, double* table) const;
+
     template <typename FPTYPE, typename Device>
     void getvnl(Device * ctx, const int &ik, std::complex<FPTYPE>* vkb_in)const;
 
@@ -1,4 +1,5 @@
 #include "forces.h"
+#include "stress_func.h"
 
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
 // new
@@ -29,7 +30,8 @@ void Forces<FPTYPE, Device>::cal_force(ModuleBase::matrix& force,
                                        Structure_Factor* p_sf,
                                        K_Vectors* pkv,
                                        ModulePW::PW_Basis_K* wfc_basis,
-                                       const psi::Psi<std::complex<FPTYPE>, Device>* psi_in)
+                                       const psi::Psi<std::complex<FPTYPE>, Device>* psi_in,
+                                       ModuleBase::matrix* sigmanl)
 {
     ModuleBase::TITLE("Forces", "init");
     this->device = psi::device::get_device_type<Device>(this->ctx);
@@ -47,7 +49,16 @@ void Forces<FPTYPE, Device>::cal_force(ModuleBase::matrix& force,
     if(wfc_basis != nullptr)
     {
         this->npwx = wfc_basis->npwk_max;
-        this->cal_force_nl(forcenl, wg, pkv, wfc_basis, psi_in);
+        if (sigmanl != nullptr)
+        {
+            // the nonlocal stress is wanted as well, both come from one pass over the k points
+            Stress_Func<FPTYPE, Device> sf_nl;
+            sf_nl.force_stress_nl(forcenl, *sigmanl, wg, p_sf, pkv, p_symm, wfc_basis, psi_in);
+        }
+        else
+        {
+            this->cal_force_nl(forcenl, wg, pkv, wfc_basis, psi_in);
+        }
     }
     this->cal_force_cc(forcecc, rho_basis, chr);
     this->cal_force_scc(forcescc, rho_basis, elec.vnew, elec.vnew_exist);
@@ -515,6 +526,14 @@ void Forces<FPTYPE, Device>::cal_force_ew(ModuleBase::matrix& forceion,
     ModuleBase::TITLE("Forces", "cal_force_ew");
     ModuleBase::timer::tick("Forces", "cal_force_ew");
 
+    if (GlobalV::EWALD_SPME)
+    {
+        H_Ewald_pw::spme.set_parameters(GlobalV::EWALD_SPME_TOL);
+        H_Ewald_pw::spme.compute(GlobalC::ucell, &forceion, nullptr);
+        ModuleBase::timer::tick("Forces", "cal_force_ew");
+        return;
+    }
+
     double fact = 2.0;
     std::complex<double>* aux = new std::complex<double>[rho_basis->npw];
 
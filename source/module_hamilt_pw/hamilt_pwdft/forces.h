@@ -38,7 +38,8 @@ class Forces
                    Structure_Factor* p_sf,
                    K_Vectors* pkv = nullptr,
                    ModulePW::PW_Basis_K* psi_basis = nullptr,
-                   const psi::Psi<std::complex<FPTYPE>, Device>* psi_in = nullptr);
+                   const psi::Psi<std::complex<FPTYPE>, Device>* psi_in = nullptr,
+                   ModuleBase::matrix* sigmanl = nullptr);
 
   protected:
     int nat = 0;
@@ -128,11 +128,103 @@ struct cal_force_nl_op<FPTYPE, psi::DEVICE_CPU> {
     }
 };
 
+template <typename FPTYPE>
+struct cal_force_stress_nl_op<FPTYPE, psi::DEVICE_CPU> {
+    void operator()(
+        const psi::DEVICE_CPU *ctx,
+        const bool &multi_proj,
+        const int &nbands_occ,
+        const int &wg_nc,
+        const int &ntype,
+        const int &spin,
+        const int &deeq_2,
+        const int &deeq_3,
+        const int &deeq_4,
+        const int &forcenl_nc,
+        const int &ik,
+        const int &nkb,
+        const int *atom_nh,
+        const int *atom_na,
+        const FPTYPE &tpiba,
+        const FPTYPE *d_wg,
+        const FPTYPE *deeq,
+        const std::complex<FPTYPE> *becp,
+        const std::complex<FPTYPE> *dbecp,
+        FPTYPE *force,
+        FPTYPE *stress)
+    {
+        // the 6 stress components in the order of dbecp
+        const int stress_index[6] = {0, 3, 4, 6, 7, 8};
+#ifdef _OPENMP
+#pragma omp parallel
+{
+#endif
+        FPTYPE local_stress[6] = {0, 0, 0, 0, 0, 0};
+        int iat0 = 0;
+        int sum0 = 0;
+        for (int it = 0; it < ntype; it++) {
+            const int Nprojs = atom_nh[it];
+#ifdef _OPENMP
+#pragma omp for collapse(2)
+#endif
+            for (int ia = 0; ia < atom_na[it]; ia++) {
+                for (int ib = 0; ib < nbands_occ; ib++) {
+                    FPTYPE local_force[3] = {0, 0, 0};
+                    const FPTYPE fac_force = d_wg[ik * wg_nc + ib] * 2.0 * tpiba;
+                    const FPTYPE fac_stress = d_wg[ik * wg_nc + ib];
+                    const int iat = iat0 + ia;
+                    const int sum = sum0 + ia * Nprojs;
+                    const std::complex<FPTYPE> *pbecp = becp + ib * nkb;
+                    const std::complex<FPTYPE> *pdbecp = dbecp + ib * 9 * nkb;
+                    for (int ip1 = 0; ip1 < Nprojs; ip1++) {
+                        for (int ip2 = 0; ip2 < Nprojs; ip2++) {
+                            if (!multi_proj && ip1 != ip2) {
+                                continue;
+                            }
+                            const FPTYPE ps = deeq[((spin * deeq_2 + iat) * deeq_3 + ip1) * deeq_4 + ip2];
+                            const int inkb1 = sum + ip1;
+                            const std::complex<FPTYPE> b2 = pbecp[sum + ip2];
+                            for (int ipol = 0; ipol < 3; ipol++) {
+                                const FPTYPE dbb = (conj(pdbecp[ipol * nkb + inkb1]) * b2).real();
+                                local_force[ipol] -= ps * fac_force * dbb;
+                            }
+                            for (int is = 0; is < 6; is++) {
+                                const FPTYPE dbb = (conj(pdbecp[(3 + is) * nkb + inkb1]) * b2).real();
+                                local_stress[is] -= ps * fac_stress * dbb;
+                            }
+                        }
+                    }
+                    // each thread works on whole (ia, ib) pairs, several of them can share an atom
+                    for (int ipol = 0; ipol < 3; ipol++) {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+                        force[iat * forcenl_nc + ipol] += local_force[ipol];
+                    }
+                }
+            } // end ia
+            iat0 += atom_na[it];
+            sum0 += atom_na[it] * Nprojs;
+        } //end it
+        for (int is = 0; is < 6; is++) {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+            stress[stress_index[is]] += local_stress[is];
+        }
+#ifdef _OPENMP
+}
+#endif
+    }
+};
+
 template struct cal_vkb1_nl_op<float, psi::DEVICE_CPU>;
 template struct cal_force_nl_op<float, psi::DEVICE_CPU>;
+template struct cal_force_stress_nl_op<float, psi::DEVICE_CPU>;
 
 template struct cal_vkb1_nl_op<double, psi::DEVICE_CPU>;
 template struct cal_force_nl_op<double, psi::DEVICE_CPU>;
+template struct cal_force_stress_nl_op<double, psi::DEVICE_CPU>;
 
 }  // namespace hamilt
 
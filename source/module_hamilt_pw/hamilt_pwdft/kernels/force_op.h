@@ -92,6 +92,62 @@ struct cal_force_nl_op {
         FPTYPE *force);
 };
 
+template <typename FPTYPE, typename Device>
+struct cal_force_stress_nl_op {
+    /// @brief Calculate the nonlocal forces and stress of one k point in a single pass
+    ///
+    /// The derivatives of the projectors of all 9 components are multiplied with psi in one gemm,
+    /// so dbecp holds, for each band, the 3 force components <-iG beta|psi> followed by the
+    /// 6 stress components (00, 10, 11, 20, 21, 22) of Stress_Func::stress_nl, nkb each.
+    ///
+    /// Input Parameters
+    /// @param ctx - which device this function runs on
+    /// @param multi_proj - control flag
+    /// @param nbands_occ - number of occupied bands
+    /// @param wg_nc - the second dimension of matrix wg
+    /// @param ntype - total atomic type
+    /// @param spin - current spin
+    /// @param deeq_2 - the second dimension of deeq
+    /// @param deeq_3 - the third dimension of deeq
+    /// @param deeq_4 - the forth dimension of deeq
+    /// @param forcenl_nc - the second dimension of matrix forcenl
+    /// @param ik - current k point
+    /// @param nkb - number of projectors
+    /// @param atom_nh - GlobalC::ucell.atoms[ii].ncpp.nh
+    /// @param atom_na - GlobalC::ucell.atoms[ii].na
+    /// @param tpiba - GlobalC::ucell.tpiba
+    /// @param d_wg - input parameter wg
+    /// @param deeq - GlobalC::ppcell.deeq
+    /// @param becp - intermediate matrix with nbands_occ * nkb
+    /// @param dbecp - intermediate matrix with nbands_occ * 9 * nkb
+    ///
+    /// Output Parameters
+    /// @param force - output forces, added to
+    /// @param stress - output 3 * 3 stress, added to the lower triangle
+    void operator()(
+        const Device *ctx,
+        const bool &multi_proj,
+        const int &nbands_occ,
+        const int &wg_nc,
+        const int &ntype,
+        const int &spin,
+        const int &deeq_2,
+        const int &deeq_3,
+        const int &deeq_4,
+        const int &forcenl_nc,
+        const int &ik,
+        const int &nkb,
+        const int *atom_nh,
+        const int *atom_na,
+        const FPTYPE &tpiba,
+        const FPTYPE *d_wg,
+        const FPTYPE *deeq,
+        const std::complex<FPTYPE> *becp,
+        const std::complex<FPTYPE> *dbecp,
+        FPTYPE *force,
+        FPTYPE *stress);
+};
+
 #if __CUDA || __UT_USE_CUDA || __ROCM || __UT_USE_ROCM
 template <typename FPTYPE>
 struct cal_vkb1_nl_op<FPTYPE, psi::DEVICE_GPU> {
@@ -136,6 +192,32 @@ struct cal_force_nl_op<FPTYPE, psi::DEVICE_GPU> {
         FPTYPE *force);
 };
 
+template <typename FPTYPE>
+struct cal_force_stress_nl_op<FPTYPE, psi::DEVICE_GPU> {
+    void operator() (
+        const psi::DEVICE_GPU *ctx,
+        const bool &multi_proj,
+        const int &nbands_occ,
+        const int &wg_nc,
+        const int &ntype,
+        const int &spin,
+        const int &deeq_2,
+        const int &deeq_3,
+        const int &deeq_4,
+        const int &forcenl_nc,
+        const int &ik,
+        const int &nkb,
+        const int *atom_nh,
+        const int *atom_na,
+        const FPTYPE &tpiba,
+        const FPTYPE *d_wg,
+        const FPTYPE *deeq,
+        const std::complex<FPTYPE> *becp,
+        const std::complex<FPTYPE> *dbecp,
+        FPTYPE *force,
+        FPTYPE *stress);
+};
+
 #endif // __CUDA || __UT_USE_CUDA || __ROCM || __UT_USE_ROCM
 }  // namespace hamilt
 #endif //SRC_PW_FORCE_MULTI_DEVICE_H
\ No newline at end of file
@@ -97,6 +97,71 @@ __global__ void cal_force_nl(
     }
 }
 
+template <typename FPTYPE>
+__global__ void cal_force_stress_nl(
+        const bool multi_proj,
+        const int wg_nc,
+        const int ntype,
+        const int spin,
+        const int deeq_2,
+        const int deeq_3,
+        const int deeq_4,
+        const int forcenl_nc,
+        const int ik,
+        const int nkb,
+        const int *atom_nh,
+        const int *atom_na,
+        const FPTYPE tpiba,
+        const FPTYPE *d_wg,
+        const FPTYPE *deeq,
+        const thrust::complex<FPTYPE> *becp,
+        const thrust::complex<FPTYPE> *dbecp,
+        FPTYPE *force,
+        FPTYPE *stress)
+{
+    const int ib = blockIdx.x / ntype;
+    const int it = blockIdx.x % ntype;
+    // the 6 stress components in the order of dbecp
+    const int stress_index[6] = {0, 3, 4, 6, 7, 8};
+
+    int iat = 0, sum = 0;
+    for (int ii = 0; ii < it; ii++) {
+        iat += atom_na[ii];
+        sum += atom_na[ii] * atom_nh[ii];
+    }
+
+    const int Nprojs = atom_nh[it];
+    const FPTYPE fac_force = d_wg[ik * wg_nc + ib] * 2.0 * tpiba;
+    const FPTYPE fac_stress = d_wg[ik * wg_nc + ib];
+    const thrust::complex<FPTYPE> *pbecp = becp + ib * nkb;
+    const thrust::complex<FPTYPE> *pdbecp = dbecp + ib * 9 * nkb;
+    FPTYPE local_stress[6] = {0, 0, 0, 0, 0, 0};
+    for (int ia = 0; ia < atom_na[it]; ia++) {
+        for (int ii = threadIdx.x; ii < Nprojs * Nprojs; ii += blockDim.x) {
+            const int ip1 = ii / Nprojs, ip2 = ii % Nprojs;
+            if (!multi_proj && ip1 != ip2) {
+                continue;
+            }
+            const FPTYPE ps = deeq[((spin * deeq_2 + iat) * deeq_3 + ip1) * deeq_4 + ip2];
+            const int inkb1 = sum + ip1;
+            const thrust::complex<FPTYPE> b2 = pbecp[sum + ip2];
+            for (int ipol = 0; ipol < 3; ipol++) {
+                const FPTYPE dbb = (conj(pdbecp[ipol * nkb + inkb1]) * b2).real();
+                atomicAdd(force + iat * forcenl_nc + ipol, -ps * fac_force * dbb);
+            }
+            for (int is = 0; is < 6; is++) {
+                const FPTYPE dbb = (conj(pdbecp[(3 + is) * nkb + inkb1]) * b2).real();
+                local_stress[is] -= ps * fac_stress * dbb;
+            }
+        }
+        ++iat;
+        sum += Nprojs;
+    }
+    for (int is = 0; is < 6; is++) {
+        atomicAdd(stress + stress_index[is], local_stress[is]);
+    }
+}
+
 template <typename FPTYPE>
 void cal_vkb1_nl_op<FPTYPE, psi::DEVICE_GPU>::operator() (
         const psi::DEVICE_GPU *ctx,
@@ -162,10 +227,49 @@ void cal_force_nl_op<FPTYPE, psi::DEVICE_GPU>::operator() (
             force);// array of data
 }
 
+template <typename FPTYPE>
+void cal_force_stress_nl_op<FPTYPE, psi::DEVICE_GPU>::operator() (
+        const psi::DEVICE_GPU *ctx,
+        const bool &multi_proj,
+        const int &nbands_occ,
+        const int &wg_nc,
+        const int &ntype,
+        const int &spin,
+        const int &deeq_2,
+        const int &deeq_3,
+        const int &deeq_4,
+        const int &forcenl_nc,
+        const int &ik,
+        const int &nkb,
+        const int *atom_nh,
+        const int *atom_na,
+        const FPTYPE &tpiba,
+        const FPTYPE *d_wg,
+        const FPTYPE *deeq,
+        const std::complex<FPTYPE> *becp,
+        const std::complex<FPTYPE> *dbecp,
+        FPTYPE *force,
+        FPTYPE *stress)
+{
+    hipLaunchKernelGGL(HIP_KERNEL_NAME(cal_force_stress_nl<FPTYPE>), dim3(nbands_occ * ntype), dim3(THREADS_PER_BLOCK), 0, 0, 
+            multi_proj,
+            wg_nc, ntype, spin,
+            deeq_2, deeq_3, deeq_4,
+            forcenl_nc, ik, nkb,
+            atom_nh, atom_na,
+            tpiba,
+            d_wg, deeq,
+            reinterpret_cast<const thrust::complex<FPTYPE>*>(becp),
+            reinterpret_cast<const thrust::complex<FPTYPE>*>(dbecp),
+            force, stress);// array of data
+}
+
 template struct cal_vkb1_nl_op<float, psi::DEVICE_GPU>;
 template struct cal_force_nl_op<float, psi::DEVICE_GPU>;
+template struct cal_force_stress_nl_op<float, psi::DEVICE_GPU>;
 
 template struct cal_vkb1_nl_op<double, psi::DEVICE_GPU>;
 template struct cal_force_nl_op<double, psi::DEVICE_GPU>;
+template struct cal_force_stress_nl_op<double, psi::DEVICE_GPU>;
 
 }  // namespace hamilt
\ No newline at end of file
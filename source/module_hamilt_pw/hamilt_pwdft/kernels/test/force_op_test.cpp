@@ -3,6 +3,7 @@
 #include <gtest/gtest.h>
 #include "module_psi/kernels/memory_op.h"
 #include "module_hamilt_pw/hamilt_pwdft/kernels/force_op.h"
+#include "module_hamilt_pw/hamilt_pwdft/kernels/stress_op.h"
 
 class TestSrcPWForceMultiDevice : public ::testing::Test
 {
@@ -105,6 +106,57 @@ TEST_F(TestSrcPWForceMultiDevice, cal_force_nl_op_cpu)
     }
 }
 
+TEST_F(TestSrcPWForceMultiDevice, cal_force_stress_nl_op_cpu)
+{
+    // the fused op must agree with cal_force_nl_op and cal_stress_nl_op on the same projections,
+    // the stress components reuse the force ones with different weights
+    const int jpol_of[6] = {0, 0, 1, 0, 1, 2};
+    const int ipol_of[6] = {0, 1, 1, 2, 2, 2};
+    std::vector<std::complex<double>> dbecp_all(nbands_occ * 9 * nkb);
+    std::vector<std::vector<std::complex<double>>> dbecp_stress(6, std::vector<std::complex<double>>(nbands * nkb));
+    for (int ib = 0; ib < nbands_occ; ib++) {
+        for (int ikb = 0; ikb < nkb; ikb++) {
+            for (int ipol = 0; ipol < 3; ipol++) {
+                dbecp_all[(ib * 9 + ipol) * nkb + ikb] = dbecp[ipol * nbands * nkb + ib * nkb + ikb];
+            }
+            for (int is = 0; is < 6; is++) {
+                const std::complex<double> value = dbecp[(is % 3) * nbands * nkb + ib * nkb + ikb] * (1.0 + 0.5 * is);
+                dbecp_all[(ib * 9 + 3 + is) * nkb + ikb] = value;
+                dbecp_stress[is][ib * nkb + ikb] = value;
+            }
+        }
+    }
+
+    for (const bool multi : {false, true}) {
+        std::vector<double> force_ref(expected_force.size(), 0.0);
+        std::vector<double> stress_ref(9, 0.0);
+        hamilt::cal_force_nl_op<double, psi::DEVICE_CPU>()(
+            cpu_ctx, multi, nbands_occ, wg_nc, ntype, spin, deeq_2, deeq_3, deeq_4, forcenl_nc, nbands, ik, nkb,
+            atom_nh.data(), atom_na.data(), tpiba, wg.data(), deeq.data(), becp.data(), dbecp.data(), force_ref.data());
+        for (int is = 0; is < 6; is++) {
+            hamilt::cal_stress_nl_op<double, psi::DEVICE_CPU>()(
+                cpu_ctx, multi, ipol_of[is], jpol_of[is], nkb, nbands_occ, ntype, spin, wg_nc, ik, deeq_2, deeq_3,
+                deeq_4, atom_nh.data(), atom_na.data(), wg.data(), deeq.data(), becp.data(), dbecp_stress[is].data(),
+                stress_ref.data());
+        }
+
+        std::vector<double> force(expected_force.size(), 0.0);
+        std::vector<double> stress(9, 0.0);
+        hamilt::cal_force_stress_nl_op<double, psi::DEVICE_CPU>()(
+            cpu_ctx, multi, nbands_occ, wg_nc, ntype, spin, deeq_2, deeq_3, deeq_4, forcenl_nc, ik, nkb,
+            atom_nh.data(), atom_na.data(), tpiba, wg.data(), deeq.data(), becp.data(), dbecp_all.data(),
+            force.data(), stress.data());
+
+        for (int ii = 0; ii < force.size(); ii++) {
+            EXPECT_NEAR(force[ii], force_ref[ii], 1e-12);
+        }
+        EXPECT_NE(stress_ref[0], 0.0);
+        for (int ii = 0; ii < 9; ii++) {
+            EXPECT_NEAR(stress[ii], stress_ref[ii], 1e-12);
+        }
+    }
+}
+
 #if __CUDA || __UT_USE_CUDA || __ROCM || __UT_USE_ROCM
 TEST_F(TestSrcPWForceMultiDevice, cal_vkb1_nl_op_gpu)
 {
@@ -0,0 +1,322 @@
+#include "op_exx_pw.h"
+
+#include "module_base/blas_connector.h"
+#include "module_base/constants.h"
+#include "module_base/global_variable.h"
+#include "module_base/lapack_connector.h"
+#include "module_base/parallel_reduce.h"
+#include "module_base/timer.h"
+#include "module_base/tool_quit.h"
+#include "module_base/tool_title.h"
+#include "module_psi/kernels/device.h"
+
+#include <cmath>
+
+namespace hamilt {
+
+template <typename T, typename Device>
+OperatorEXX<OperatorPW<T, Device>>::OperatorEXX(const int* isk_in,
+                                                const ModulePW::PW_Basis_K* wfcpw_in,
+                                                const ModulePW::PW_Basis* rhopw_in,
+                                                const int nks_full_in,
+                                                const double alpha_in,
+                                                const double hse_omega_in)
+{
+    this->classname = "OperatorEXX";
+    this->cal_type = pw_exx;
+    this->isk = isk_in;
+    this->wfcpw = wfcpw_in;
+    this->rhopw = rhopw_in;
+    this->nks_full = nks_full_in;
+    this->alpha = alpha_in;
+    this->hse_omega = hse_omega_in;
+    if (this->isk == nullptr || this->wfcpw == nullptr || this->rhopw == nullptr || this->nks_full < 1)
+    {
+        ModuleBase::WARNING_QUIT("OperatorEXX", "Constuctor of Operator::OperatorEXX is failed, please check your code!");
+    }
+    if (this->wfcpw->nrxx != this->rhopw->nrxx)
+    {
+        ModuleBase::WARNING_QUIT("OperatorEXX", "the wave functions and the pair densities need the same real space grid");
+    }
+    if (psi::device::get_device_type<Device>(this->ctx) == psi::GpuDevice)
+    {
+        ModuleBase::WARNING_QUIT("OperatorEXX", "exact exchange in plane waves is only implemented on CPU");
+    }
+}
+
+template <typename T, typename Device>
+void OperatorEXX<OperatorPW<T, Device>>::cal_coulomb_kernel(const ModuleBase::Vector3<double>& dk,
+                                                            std::vector<Real>& vq) const
+{
+    // e^2 = 2 in Rydberg units
+    const double fpi_e2 = ModuleBase::FOUR_PI * 2.0;
+    // radius of the sphere with the volume of the Born-von Karman supercell
+    const double rcut = std::cbrt(3.0 * this->rhopw->omega * this->nks_full / ModuleBase::FOUR_PI);
+
+    vq.resize(this->rhopw->npw);
+    for (int ig = 0; ig < this->rhopw->npw; ++ig)
+    {
+        const double q2 = (dk + this->rhopw->gcar[ig]).norm2() * this->rhopw->tpiba2;
+        double v = 0.0;
+        if (this->hse_omega > 0.0)
+        {
+            const double x = 0.25 / (this->hse_omega * this->hse_omega);
+            v = (q2 > 1e-12) ? fpi_e2 / q2 * (1.0 - std::exp(-q2 * x)) : fpi_e2 * x;
+        }
+        else
+        {
+            v = (q2 > 1e-12) ? fpi_e2 / q2 * (1.0 - std::cos(std::sqrt(q2) * rcut)) : 0.5 * fpi_e2 * rcut * rcut;
+        }
+        vq[ig] = static_cast<Real>(v);
+    }
+}
+
+template <typename T, typename Device>
+void OperatorEXX<OperatorPW<T, Device>>::update_ace(const psi::Psi<T, Device>& psi_in, const ModuleBase::matrix& wg)
+{
+    ModuleBase::TITLE("OperatorEXX", "update_ace");
+    ModuleBase::timer::tick("OperatorEXX", "update_ace");
+
+    const int nks = psi_in.get_nk();
+    const int nbands = psi_in.get_nbands();
+    const int nbasis = psi_in.get_nbasis();
+    const int nrxx = this->wfcpw->nrxx;
+    // wg contains the spin degeneracy, the exchange only couples orbitals of the same spin
+    const double spin_fac = (GlobalV::NSPIN == 1) ? 0.5 : 1.0;
+    const Real omega = static_cast<Real>(this->rhopw->omega);
+
+    // occupied orbitals of the full k mesh in real space.
+    // If the mesh is reduced by time reversal symmetry, u_{-k}(r) = u_k(r)^* is added with half of the weight.
+    const int nspin_k = (GlobalV::NSPIN == 2) ? 2 : 1;
+    const bool time_reversal = nks < this->nks_full * nspin_k;
+    std::vector<ModuleBase::Vector3<double>> qvec;
+    std::vector<int> qspin;
+    std::vector<std::complex<Real>> occ_r;
+    std::vector<int> occ_q;
+    std::vector<Real> occ_f;
+    for (int iq = 0; iq < nks; ++iq)
+    {
+        const ModuleBase::Vector3<double> k2 = this->wfcpw->kvec_d[iq] * 2.0;
+        const bool add_minus = time_reversal
+                               && (std::abs(k2.x - std::round(k2.x)) > 1e-8 || std::abs(k2.y - std::round(k2.y)) > 1e-8
+                                   || std::abs(k2.z - std::round(k2.z)) > 1e-8);
+        const int iqv = qvec.size();
+        qvec.push_back(this->wfcpw->kvec_c[iq]);
+        qspin.push_back(this->isk[iq]);
+        if (add_minus)
+        {
+            qvec.push_back(-this->wfcpw->kvec_c[iq]);
+            qspin.push_back(this->isk[iq]);
+        }
+
+        psi_in.fix_k(iq);
+        for (int ib = 0; ib < nbands; ++ib)
+        {
+            double f = wg(iq, ib) * spin_fac;
+            if (std::abs(f) < 1e-12)
+            {
+                continue;
+            }
+            if (add_minus)
+            {
+                f *= 0.5;
+            }
+            occ_r.resize(occ_r.size() + nrxx);
+            std::complex<Real>* phi = occ_r.data() + occ_r.size() - nrxx;
+            this->wfcpw->recip2real(&psi_in(ib, 0), phi, iq);
+            occ_q.push_back(iqv);
+            occ_f.push_back(static_cast<Real>(f));
+            if (add_minus)
+            {
+                occ_r.resize(occ_r.size() + nrxx);
+                std::complex<Real>* phi_minus = occ_r.data() + occ_r.size() - nrxx;
+                phi = phi_minus - nrxx;
+                for (int ir = 0; ir < nrxx; ++ir)
+                {
+                    phi_minus[ir] = std::conj(phi[ir]);
+                }
+                occ_q.push_back(iqv + 1);
+                occ_f.push_back(static_cast<Real>(f));
+            }
+        }
+    }
+    if (qvec.size() != this->nks_full * nspin_k)
+    {
+        ModuleBase::WARNING_QUIT("OperatorEXX",
+                                 "exact exchange in plane waves needs all k-points of the full mesh in one pool, "
+                                 "only time reversal symmetry can be used");
+    }
+
+    this->nace = nbands;
+    this->nbasis_ace = nbasis;
+    this->xi.assign(nks, std::vector<T>());
+
+    std::vector<std::complex<Real>> psi_r(nrxx);
+    std::vector<std::complex<Real>> vpsi_r(nrxx);
+    std::vector<std::complex<Real>> aux(this->rhopw->nmaxgr);
+    std::vector<std::vector<Real>> vqs(qvec.size());
+    for (int ik = 0; ik < nks; ++ik)
+    {
+        psi_in.fix_k(ik);
+        const int npw = this->wfcpw->npwk[ik];
+        for (int iqv = 0; iqv < qvec.size(); ++iqv)
+        {
+            if (qspin[iqv] == this->isk[ik])
+            {
+                this->cal_coulomb_kernel(this->wfcpw->kvec_c[ik] - qvec[iqv], vqs[iqv]);
+            }
+        }
+
+        // W = Vx psi
+        std::vector<T> w(nbands * nbasis, T(0));
+        for (int ib = 0; ib < nbands; ++ib)
+        {
+            this->wfcpw->recip2real(&psi_in(ib, 0), psi_r.data(), ik);
+            std::fill(vpsi_r.begin(), vpsi_r.end(), std::complex<Real>(0));
+            for (int iocc = 0; iocc < occ_q.size(); ++iocc)
+            {
+                const int iqv = occ_q[iocc];
+                if (qspin[iqv] != this->isk[ik])
+                {
+                    continue;
+                }
+                const std::complex<Real>* phi = occ_r.data() + static_cast<size_t>(iocc) * nrxx;
+                for (int ir = 0; ir < nrxx; ++ir)
+                {
+                    aux[ir] = std::conj(phi[ir]) * psi_r[ir];
+                }
+                this->rhopw->real2recip(aux.data(), aux.data());
+                for (int ig = 0; ig < this->rhopw->npw; ++ig)
+                {
+                    aux[ig] *= vqs[iqv][ig];
+                }
+                this->rhopw->recip2real(aux.data(), aux.data());
+                const Real fac = -occ_f[iocc] / omega;
+                for (int ir = 0; ir < nrxx; ++ir)
+                {
+                    vpsi_r[ir] += fac * phi[ir] * aux[ir];
+                }
+            }
+            this->wfcpw->real2recip(vpsi_r.data(), &w[ib * nbasis], ik);
+        }
+
+        // M = psi^H W in column-major, it is negative definite
+        std::vector<T> m(nbands * nbands, T(0));
+        BlasConnector::gemm('N', 'C', nbands, nbands, npw, T(1), w.data(), nbasis, &psi_in(0, 0), nbasis, T(0), m.data(), nbands);
+        Parallel_Reduce::reduce_complex_double_pool(m.data(), nbands * nbands);
+
+        // -M = U^H U
+        std::vector<std::complex<double>> u(nbands * nbands);
+        for (int i = 0; i < nbands * nbands; ++i)
+        {
+            u[i] = -static_cast<std::complex<double>>(m[i]);
+        }
+        const char uplo = 'U';
+        int info = 0;
+        zpotrf_(&uplo, &nbands, u.data(), &nbands, &info);
+        if (info != 0)
+        {
+            ModuleBase::WARNING_QUIT("OperatorEXX", "Cholesky decomposition of -psi^H Vx psi failed");
+        }
+
+        // W = xi U, solved column by column: xi_j = (W_j - sum_{i<j} xi_i U_ij) / U_jj
+        std::vector<T>& xi_k = this->xi[ik];
+        xi_k = std::move(w);
+        const Real sqrt_alpha = static_cast<Real>(std::sqrt(this->alpha));
+        for (int j = 0; j < nbands; ++j)
+        {
+            T* xj = &xi_k[j * nbasis];
+            for (int i = 0; i < j; ++i)
+            {
+                const T* xii = &xi_k[i * nbasis];
+                const T uij = static_cast<T>(u[j * nbands + i]);
+                for (int ig = 0; ig < npw; ++ig)
+                {
+                    xj[ig] -= xii[ig] * uij;
+                }
+            }
+            const Real inv_ujj = static_cast<Real>(1.0 / u[j * nbands + j].real());
+            for (int ig = 0; ig < npw; ++ig)
+            {
+                xj[ig] *= inv_ujj;
+            }
+        }
+        for (auto& x: xi_k)
+        {
+            x *= sqrt_alpha;
+        }
+    }
+
+    ModuleBase::timer::tick("OperatorEXX", "update_ace");
+}
+
+template <typename T, typename Device>
+void OperatorEXX<OperatorPW<T, Device>>::act(const int nbands,
+                                             const int nbasis,
+                                             const int npol,
+                                             const T* tmpsi_in,
+                                             T* tmhpsi,
+                                             const int ngk_ik) const
+{
+    if (this->xi.empty())
+    {
+        return;
+    }
+    ModuleBase::timer::tick("Operator", "EXXPW");
+    if (npol != 1)
+    {
+        ModuleBase::WARNING_QUIT("OperatorEXX", "exact exchange in plane waves does not support npol = 2");
+    }
+    const int npw = this->wfcpw->npwk[this->ik];
+    const T* xi_k = this->xi[this->ik].data();
+
+    // hpsi -= xi (xi^H psi)
+    std::vector<T> proj(nbands * this->nace, T(0));
+    BlasConnector::gemm('N', 'C', nbands, this->nace, npw, T(1), tmpsi_in, nbasis, xi_k, this->nbasis_ace, T(0), proj.data(), this->nace);
+    Parallel_Reduce::reduce_complex_double_pool(proj.data(), nbands * this->nace);
+    BlasConnector::gemm('N', 'N', nbands, npw, this->nace, T(-1), proj.data(), this->nace, xi_k, this->nbasis_ace, T(1), tmhpsi, nbasis);
+
+    ModuleBase::timer::tick("Operator", "EXXPW");
+}
+
+template <typename T, typename Device>
+double OperatorEXX<OperatorPW<T, Device>>::cal_exx_energy(const psi::Psi<T, Device>& psi_in,
+                                                          const ModuleBase::matrix& wg) const
+{
+    if (this->xi.empty())
+    {
+        return 0.0;
+    }
+    ModuleBase::TITLE("OperatorEXX", "cal_exx_energy");
+    const int nbands = psi_in.get_nbands();
+    const int nbasis = psi_in.get_nbasis();
+    double energy = 0.0;
+    for (int ik = 0; ik < psi_in.get_nk(); ++ik)
+    {
+        psi_in.fix_k(ik);
+        const int npw = this->wfcpw->npwk[ik];
+        std::vector<T> proj(nbands * this->nace, T(0));
+        BlasConnector::gemm('N', 'C', nbands, this->nace, npw, T(1), &psi_in(0, 0), nbasis, this->xi[ik].data(), this->nbasis_ace, T(0), proj.data(), this->nace);
+        Parallel_Reduce::reduce_complex_double_pool(proj.data(), nbands * this->nace);
+        // <psi|alpha Vx|psi> = -|xi^H psi|^2
+        for (int ib = 0; ib < nbands; ++ib)
+        {
+            double sum = 0.0;
+            for (int j = 0; j < this->nace; ++j)
+            {
+                sum += std::norm(proj[ib * this->nace + j]);
+            }
+            energy += 0.5 * wg(ik, ib) * sum;
+        }
+    }
+    return energy;
+}
+
+template class OperatorEXX<OperatorPW<std::complex<float>, psi::DEVICE_CPU>>;
+template class OperatorEXX<OperatorPW<std::complex<double>, psi::DEVICE_CPU>>;
+#if ((defined __CUDA) || (defined __ROCM))
+template class OperatorEXX<OperatorPW<std::complex<float>, psi::DEVICE_GPU>>;
+template class OperatorEXX<OperatorPW<std::complex<double>, psi::DEVICE_GPU>>;
+#endif
+
+} // namespace hamilt
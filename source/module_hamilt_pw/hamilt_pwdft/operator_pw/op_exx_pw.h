@@ -0,0 +1,100 @@
+#ifndef OPEXXPW_H
+#define OPEXXPW_H
+
+#include "operator_pw.h"
+#include "module_base/matrix.h"
+#include "module_basis/module_pw/pw_basis.h"
+#include "module_basis/module_pw/pw_basis_k.h"
+#include "module_psi/psi.h"
+
+#include <module_base/macros.h>
+
+#include <vector>
+
+namespace hamilt {
+
+#ifndef __OPEXXTEMPLATE
+#define __OPEXXTEMPLATE
+
+template <class T>
+class OperatorEXX : public T
+{
+};
+
+#endif
+
+/**
+ * @brief exact exchange in plane waves with the adaptively compressed exchange (ACE) operator
+ *
+ * The Fock operator of the occupied orbitals phi_{mq} with occupations f_{mq},
+ *     Vx psi(r) = - sum_{mq} f_{mq} phi_{mq}(r) \int v(r-r') phi*_{mq}(r') psi(r') dr',
+ * is evaluated with FFTs of the pair densities phi*_{mq} psi on the dense grid of rhopw.
+ * update_ace() applies it once to all bands of psi, W = Vx psi, and keeps the projectors
+ *     xi = W L^{-H},  with  psi^H W = -L L^H,
+ * so that act() only applies -alpha xi xi^H, which equals alpha Vx on the span of psi.
+ *
+ * v(q) is the Coulomb kernel truncated at the radius of a sphere with the volume of the
+ * Born-von Karman supercell (Spencer and Alavi) for HF and PBE0, and the erfc-screened kernel for HSE.
+ * All k-points of the full mesh have to be in the current pool, possibly reduced by time reversal
+ * symmetry, and npol has to be 1.
+ */
+template <typename T, typename Device>
+class OperatorEXX<OperatorPW<T, Device>> : public OperatorPW<T, Device>
+{
+  private:
+    using Real = typename GetTypeReal<T>::type;
+
+  public:
+    OperatorEXX(const int* isk_in,
+                const ModulePW::PW_Basis_K* wfcpw_in,
+                const ModulePW::PW_Basis* rhopw_in,
+                const int nks_full_in,
+                const double alpha_in,
+                const double hse_omega_in = 0.0);
+
+    virtual ~OperatorEXX(){};
+
+    virtual void act(const int nbands,
+                     const int nbasis,
+                     const int npol,
+                     const T* tmpsi_in,
+                     T* tmhpsi,
+                     const int ngk_ik = 0) const override;
+
+    /**
+     * @brief build the ACE projectors from the orbitals psi_in and their weights wg
+     * Orbitals with wg(ik, ib) = 0 do not contribute to the Fock operator but it is still compressed on them.
+     */
+    void update_ace(const psi::Psi<T, Device>& psi_in, const ModuleBase::matrix& wg);
+
+    /// whether update_ace() has been called
+    bool ace_ready() const { return !this->xi.empty(); }
+
+    /**
+     * @brief -1/2 sum_{nk} wg(k,n) <psi_nk|alpha Vx|psi_nk>
+     * eband counts the exchange energy twice, this is the correction that goes into f_en.exx.
+     */
+    double cal_exx_energy(const psi::Psi<T, Device>& psi_in, const ModuleBase::matrix& wg) const;
+
+  private:
+    /// v(|k-q+G|) on the G vectors of rhopw, dk = k-q in Cartesian coordinates
+    void cal_coulomb_kernel(const ModuleBase::Vector3<double>& dk, std::vector<Real>& vq) const;
+
+    const int* isk = nullptr;
+    const ModulePW::PW_Basis_K* wfcpw = nullptr;
+    const ModulePW::PW_Basis* rhopw = nullptr;
+    int nks_full = 1;
+    double alpha = 1.0;
+    double hse_omega = 0.0;
+
+    // xi[ik]: nace x nbasis, sqrt(alpha) is included
+    std::vector<std::vector<T>> xi;
+    int nace = 0;
+    int nbasis_ace = 0;
+
+    Device* ctx = {};
+};
+
+} // namespace hamilt
+
+#endif
@@ -11,6 +11,7 @@
 #include "module_basis/module_pw/pw_basis_k.h"
 #include "module_cell/klist.h"
 #include "module_elecstate/module_charge/charge.h"
+#include "module_hamilt_pw/hamilt_pwdft/kernels/force_op.h"
 #include "module_hamilt_pw/hamilt_pwdft/kernels/stress_op.h"
 #include "module_hamilt_pw/hamilt_pwdft/structure_factor.h"
 #include "module_hsolver/kernels/math_kernel_op.h"
@@ -134,6 +135,22 @@ class Stress_Func
                    ModulePW::PW_Basis_K* wfc_basis,
                    const psi::Psi<complex<FPTYPE>, Device>* psi_in); // nonlocal part in PW basis
 
+    /**
+     * @brief the nonlocal forces and the nonlocal stress in one pass over the k points
+     *
+     * vkb and becp are computed once per k point, and the derivatives of the projectors for the
+     * 3 force and the 6 stress components are multiplied with psi in a single gemm. The forces
+     * are added to forcenl (nat x 3) without symmetrization, sigma is the same as from stress_nl.
+     */
+    void force_stress_nl(ModuleBase::matrix& forcenl,
+                         ModuleBase::matrix& sigma,
+                         const ModuleBase::matrix& wg,
+                         Structure_Factor* p_sf,
+                         K_Vectors* p_kv,
+                         ModuleSymmetry::Symmetry* p_symm,
+                         ModulePW::PW_Basis_K* wfc_basis,
+                         const psi::Psi<complex<FPTYPE>, Device>* psi_in);
+
     void get_dvnl1(ModuleBase::ComplexMatrix& vkb,
                    const int ik,
                    const int ipol,
@@ -169,6 +186,8 @@ class Stress_Func
     using gemm_op = hsolver::gemm_op<FPTYPE, Device>;
     using cal_stress_nl_op = hamilt::cal_stress_nl_op<FPTYPE, Device>;
     using cal_dbecp_noevc_nl_op = hamilt::cal_dbecp_noevc_nl_op<FPTYPE, Device>;
+    using cal_vkb1_nl_op = hamilt::cal_vkb1_nl_op<FPTYPE, Device>;
+    using cal_force_stress_nl_op = hamilt::cal_force_stress_nl_op<FPTYPE, Device>;
 
     using resmem_complex_op = psi::memory::resize_memory_op<std::complex<FPTYPE>, Device>;
     using resmem_complex_h_op = psi::memory::resize_memory_op<std::complex<FPTYPE>, psi::DEVICE_CPU>;
@@ -16,6 +16,14 @@ void Stress_Func<FPTYPE, Device>::stress_ewa(ModuleBase::matrix& sigma, ModulePW
     ModuleBase::TITLE("Stress_Func","stress_ewa");
     ModuleBase::timer::tick("Stress_Func","stress_ewa");
 
+    if (GlobalV::EWALD_SPME)
+    {
+        H_Ewald_pw::spme.set_parameters(GlobalV::EWALD_SPME_TOL);
+        H_Ewald_pw::spme.compute(GlobalC::ucell, nullptr, &sigma);
+        ModuleBase::timer::tick("Stress_Func","stress_ewa");
+        return;
+    }
+
     FPTYPE charge=0;
     for(int it=0; it < GlobalC::ucell.ntype; it++)
 	{
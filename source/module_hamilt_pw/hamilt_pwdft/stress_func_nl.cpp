@@ -316,6 +316,299 @@ void Stress_Func<FPTYPE, Device>::stress_nl(ModuleBase::matrix &sigma,
 	ModuleBase::timer::tick("Stress_Func","stress_nl");
 }
 
+template <typename FPTYPE, typename Device>
+void Stress_Func<FPTYPE, Device>::force_stress_nl(ModuleBase::matrix& forcenl,
+                                                  ModuleBase::matrix& sigma,
+                                                  const ModuleBase::matrix& wg,
+                                                  Structure_Factor* p_sf,
+                                                  K_Vectors* p_kv,
+                                                  ModuleSymmetry::Symmetry* p_symm,
+                                                  ModulePW::PW_Basis_K* wfc_basis,
+                                                  const psi::Psi<complex<FPTYPE>, Device>* psi_in)
+{
+    ModuleBase::TITLE("Stress_Func", "force_stress_nl");
+    ModuleBase::timer::tick("Stress_Func", "force_stress_nl");
+    const int npwx = wfc_basis->npwk_max;
+    const int nkb = GlobalC::ppcell.nkb;
+    if (nkb == 0 || psi_in == nullptr)
+    {
+        ModuleBase::timer::tick("Stress_Func", "force_stress_nl");
+        return;
+    }
+
+    this->device = psi::device::get_device_type<Device>(this->ctx);
+
+    // the derivatives of the projectors are kept in 9 blocks of nkb projectors:
+    // -iG_ipol |beta> for the 3 force components, then the 6 stress components (00, 10, 11, 20, 21, 22),
+    // so that all of them are multiplied with psi in one gemm
+    const int ncomp = 9;
+    ModuleBase::ComplexMatrix vkb0[3];
+    for (int i = 0; i < 3; i++)
+    {
+        vkb0[i].create(nkb, npwx);
+    }
+    ModuleBase::ComplexMatrix vkb2(nkb, npwx);
+    const int nbands_max = GlobalV::NPOL * GlobalV::NBANDS;
+    std::complex<FPTYPE> *dbecp = nullptr, *becp = nullptr, *dvkb = nullptr, *vkb = nullptr, *pvkb0 = nullptr,
+                         *vkb1 = nullptr, *pvkb2 = nullptr;
+    std::complex<FPTYPE> *_vkb0[3] = {nullptr, nullptr, nullptr};
+    resmem_complex_op()(this->ctx, becp, nbands_max * nkb, "Stress::becp");
+    resmem_complex_op()(this->ctx, dbecp, nbands_max * ncomp * nkb, "Stress::dbecp");
+    resmem_complex_op()(this->ctx, dvkb, ncomp * nkb * npwx, "Stress::dvkb");
+    resmem_complex_op()(this->ctx, vkb1, nkb * npwx, "Stress::vkb1");
+
+    int wg_nc = wg.nc;
+    int *atom_nh = nullptr, *atom_na = nullptr, *h_atom_nh = new int[GlobalC::ucell.ntype],
+        *h_atom_na = new int[GlobalC::ucell.ntype];
+    for (int ii = 0; ii < GlobalC::ucell.ntype; ii++)
+    {
+        h_atom_nh[ii] = GlobalC::ucell.atoms[ii].ncpp.nh;
+        h_atom_na[ii] = GlobalC::ucell.atoms[ii].na;
+    }
+    FPTYPE *stress = nullptr, *force = nullptr, *sigmanlc = nullptr, *d_wg = nullptr, *gcar = nullptr,
+           *deeq = GlobalC::ppcell.get_deeq_data<FPTYPE>(), *kvec_c = wfc_basis->get_kvec_c_data<FPTYPE>();
+    resmem_var_op()(this->ctx, stress, 9);
+    setmem_var_op()(this->ctx, stress, 0, 9);
+    resmem_var_h_op()(this->cpu_ctx, sigmanlc, 9);
+    if (this->device == psi::GpuDevice)
+    {
+        resmem_var_op()(this->ctx, d_wg, wg.nr * wg.nc);
+        resmem_var_op()(this->ctx, force, forcenl.nr * forcenl.nc);
+        resmem_var_op()(this->ctx, gcar, 3 * p_kv->nks * wfc_basis->npwk_max);
+        syncmem_var_h2d_op()(this->ctx, this->cpu_ctx, d_wg, wg.c, wg.nr * wg.nc);
+        syncmem_var_h2d_op()(this->ctx, this->cpu_ctx, force, forcenl.c, forcenl.nr * forcenl.nc);
+        syncmem_var_h2d_op()(this->ctx,
+                             this->cpu_ctx,
+                             gcar,
+                             &wfc_basis->gcar[0][0],
+                             3 * p_kv->nks * wfc_basis->npwk_max);
+        resmem_complex_op()(this->ctx, pvkb2, nkb * npwx);
+        resmem_complex_op()(this->ctx, pvkb0, 3 * nkb * npwx);
+        for (int ii = 0; ii < 3; ii++)
+        {
+            _vkb0[ii] = pvkb0 + ii * nkb * npwx;
+        }
+        resmem_int_op()(this->ctx, atom_nh, GlobalC::ucell.ntype);
+        resmem_int_op()(this->ctx, atom_na, GlobalC::ucell.ntype);
+        syncmem_int_h2d_op()(this->ctx, this->cpu_ctx, atom_nh, h_atom_nh, GlobalC::ucell.ntype);
+        syncmem_int_h2d_op()(this->ctx, this->cpu_ctx, atom_na, h_atom_na, GlobalC::ucell.ntype);
+    }
+    else
+    {
+        d_wg = wg.c;
+        force = forcenl.c;
+        gcar = &wfc_basis->gcar[0][0];
+        atom_nh = h_atom_nh;
+        atom_na = h_atom_na;
+        for (int ii = 0; ii < 3; ii++)
+        {
+            _vkb0[ii] = vkb0[ii].c;
+        }
+        pvkb2 = vkb2.c;
+    }
+
+    for (int ik = 0; ik < p_kv->nks; ik++)
+    {
+        if (GlobalV::NSPIN == 2)
+            GlobalV::CURRENT_SPIN = p_kv->isk[ik];
+        const int npw = p_kv->ngk[ik];
+        vkb = GlobalC::ppcell.get_vkb_data<FPTYPE>();
+        GlobalC::ppcell.getvnl(ctx, ik, vkb);
+
+        // becp(nkb,nbnd): <Beta(nkb,npw)|psi(nbnd,npw)>, shared by the forces and the stress
+        const std::complex<FPTYPE> *ppsi = &(psi_in[0](ik, 0, 0));
+        const char transa = 'C';
+        const char transb = 'N';
+        // only occupied band should be calculated.
+        int nbands_occ = GlobalV::NBANDS;
+        const double threshold = ModuleBase::threshold_wg * wg(ik, 0);
+        while (std::fabs(wg(ik, nbands_occ - 1)) < threshold)
+        {
+            nbands_occ--;
+            if (nbands_occ == 0)
+            {
+                break;
+            }
+        }
+        const int npm = GlobalV::NPOL * nbands_occ;
+        gemm_op()(this->ctx,
+                  transa,
+                  transb,
+                  nkb,
+                  npm,
+                  npw,
+                  &ModuleBase::ONE,
+                  vkb,
+                  npwx,
+                  ppsi,
+                  npwx,
+                  &ModuleBase::ZERO,
+                  becp,
+                  nkb);
+        if (this->device == psi::GpuDevice)
+        {
+            std::complex<FPTYPE> *h_becp = nullptr;
+            resmem_complex_h_op()(this->cpu_ctx, h_becp, npm * nkb);
+            syncmem_complex_d2h_op()(this->cpu_ctx, this->ctx, h_becp, becp, npm * nkb);
+            Parallel_Reduce::reduce_complex_double_pool(h_becp, npm * nkb);
+            syncmem_complex_h2d_op()(this->ctx, this->cpu_ctx, becp, h_becp, npm * nkb);
+            delmem_complex_h_op()(this->cpu_ctx, h_becp);
+        }
+        else
+        {
+            Parallel_Reduce::reduce_complex_double_pool(becp, npm * nkb);
+        }
+
+        // force components: |dbeta> = -iG |beta>
+        for (int ipol = 0; ipol < 3; ipol++)
+        {
+            cal_vkb1_nl_op()(this->ctx,
+                             nkb,
+                             npwx,
+                             wfc_basis->npwk_max,
+                             GlobalC::ppcell.vkb.nc,
+                             npw,
+                             ik,
+                             ipol,
+                             ModuleBase::NEG_IMAG_UNIT,
+                             vkb,
+                             gcar,
+                             dvkb + ipol * nkb * npwx);
+        }
+
+        // stress components, from the derivatives of the spherical harmonics and of the radial part
+        for (int i = 0; i < 3; i++)
+        {
+            get_dvnl1(vkb0[i], ik, i, p_sf, wfc_basis);
+            if (this->device == psi::GpuDevice)
+            {
+                syncmem_complex_h2d_op()(this->ctx, this->cpu_ctx, _vkb0[i], vkb0[i].c, nkb * npwx);
+            }
+        }
+        get_dvnl2(vkb2, ik, p_sf, wfc_basis);
+        if (this->device == psi::GpuDevice)
+        {
+            syncmem_complex_h2d_op()(this->ctx, this->cpu_ctx, pvkb2, vkb2.c, nkb * npwx);
+        }
+        int icomp = 3;
+        for (int ipol = 0; ipol < 3; ipol++)
+        {
+            for (int jpol = 0; jpol < ipol + 1; jpol++)
+            {
+                std::complex<FPTYPE> *pdvkb = dvkb + icomp * nkb * npwx;
+                setmem_complex_op()(this->ctx, vkb1, 0, nkb * npwx);
+                setmem_complex_op()(this->ctx, pdvkb, 0, nkb * npwx);
+                cal_dbecp_noevc_nl_op()(this->ctx,
+                                        ipol,
+                                        jpol,
+                                        nkb,
+                                        npw,
+                                        npwx,
+                                        ik,
+                                        GlobalC::ucell.tpiba,
+                                        gcar,
+                                        kvec_c,
+                                        _vkb0[ipol],
+                                        _vkb0[jpol],
+                                        vkb,
+                                        vkb1,
+                                        pvkb2,
+                                        pdvkb);
+                ++icomp;
+            }
+        }
+
+        // one gemm for all components, dbecp is [npm][9][nkb].
+        // don't need to reduce here, keep dbecp different in each processor,
+        // and at last sum up all the forces and the stress.
+        gemm_op()(this->ctx,
+                  transa,
+                  transb,
+                  ncomp * nkb,
+                  npm,
+                  npw,
+                  &ModuleBase::ONE,
+                  dvkb,
+                  npwx,
+                  ppsi,
+                  npwx,
+                  &ModuleBase::ZERO,
+                  dbecp,
+                  ncomp * nkb);
+
+        cal_force_stress_nl_op()(this->ctx,
+                                 GlobalC::ppcell.multi_proj,
+                                 nbands_occ,
+                                 wg_nc,
+                                 GlobalC::ucell.ntype,
+                                 GlobalV::CURRENT_SPIN,
+                                 GlobalC::ppcell.deeq.getBound2(),
+                                 GlobalC::ppcell.deeq.getBound3(),
+                                 GlobalC::ppcell.deeq.getBound4(),
+                                 forcenl.nc,
+                                 ik,
+                                 nkb,
+                                 atom_nh,
+                                 atom_na,
+                                 GlobalC::ucell.tpiba,
+                                 d_wg,
+                                 deeq,
+                                 becp,
+                                 dbecp,
+                                 force,
+                                 stress);
+    } // end ik
+
+    // sum up forcenl from all processors
+    if (this->device == psi::GpuDevice)
+    {
+        syncmem_var_d2h_op()(this->cpu_ctx, this->ctx, forcenl.c, force, forcenl.nr * forcenl.nc);
+    }
+    Parallel_Reduce::reduce_double_all(forcenl.c, forcenl.nr * forcenl.nc);
+
+    // the stress is symmetric, only the lower triangle has been computed
+    syncmem_var_d2h_op()(this->cpu_ctx, this->ctx, sigmanlc, stress, 9);
+    for (int l = 0; l < 3; l++)
+    {
+        for (int m = l + 1; m < 3; m++)
+        {
+            sigmanlc[l * 3 + m] = sigmanlc[m * 3 + l];
+        }
+    }
+    Parallel_Reduce::reduce_double_all(sigmanlc, 9);
+    for (int ipol = 0; ipol < 3; ipol++)
+    {
+        for (int jpol = 0; jpol < 3; jpol++)
+        {
+            sigma(ipol, jpol) = sigmanlc[ipol * 3 + jpol] / GlobalC::ucell.omega;
+        }
+    }
+    if (ModuleSymmetry::Symmetry::symm_flag == 1)
+    {
+        p_symm->stress_symmetry(sigma, GlobalC::ucell);
+    }
+
+    delete[] h_atom_nh;
+    delete[] h_atom_na;
+    delmem_var_op()(this->ctx, stress);
+    delmem_complex_op()(this->ctx, becp);
+    delmem_complex_op()(this->ctx, dbecp);
+    delmem_complex_op()(this->ctx, dvkb);
+    delmem_complex_op()(this->ctx, vkb1);
+    delmem_var_h_op()(this->cpu_ctx, sigmanlc);
+    if (this->device == psi::GpuDevice)
+    {
+        delmem_var_op()(this->ctx, d_wg);
+        delmem_var_op()(this->ctx, force);
+        delmem_var_op()(this->ctx, gcar);
+        delmem_int_op()(this->ctx, atom_nh);
+        delmem_int_op()(this->ctx, atom_na);
+        delmem_complex_op()(this->ctx, pvkb0);
+        delmem_complex_op()(this->ctx, pvkb2);
+    }
+    ModuleBase::timer::tick("Stress_Func", "force_stress_nl");
+}
+
 template <typename FPTYPE, typename Device>
 void Stress_Func<FPTYPE, Device>::get_dvnl1(ModuleBase::ComplexMatrix &vkb,
                                             const int ik,
@@ -12,7 +12,8 @@ void Stress_PW<FPTYPE, Device>::cal_stress(ModuleBase::matrix& sigmatot,
                                            K_Vectors* p_kv,
                                            ModulePW::PW_Basis_K* wfc_basis,
                                            const psi::Psi<complex<FPTYPE>>* psi_in,
-                                           const psi::Psi<complex<FPTYPE>, Device>* d_psi_in)
+                                           const psi::Psi<complex<FPTYPE>, Device>* d_psi_in,
+                                           const ModuleBase::matrix* sigmanl_in)
 {
 	ModuleBase::TITLE("Stress_PW","cal_stress");
 	ModuleBase::timer::tick("Stress_PW","cal_stress");    
@@ -92,8 +93,15 @@ void Stress_PW<FPTYPE, Device>::cal_stress(ModuleBase::matrix& sigmatot,
     // nlcc
     this->stress_cc(sigmaxcc, rho_basis, p_sf, 1, pelec->charge);
 
-    // nonlocal
-    this->stress_nl(sigmanl, this->pelec->wg, p_sf, p_kv, p_symm, wfc_basis, d_psi_in);
+    // nonlocal, unless it has been computed together with the forces
+    if (sigmanl_in != nullptr)
+    {
+        sigmanl = *sigmanl_in;
+    }
+    else
+    {
+        this->stress_nl(sigmanl, this->pelec->wg, p_sf, p_kv, p_symm, wfc_basis, d_psi_in);
+    }
 
     // vdw term
     stress_vdw(sigmavdw, ucell);
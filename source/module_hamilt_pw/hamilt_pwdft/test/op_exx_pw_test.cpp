@@ -0,0 +1,277 @@
+#include "gtest/gtest.h"
+#include "module_base/constants.h"
+#include "module_base/global_variable.h"
+#include "module_base/parallel_global.h"
+#include "module_hamilt_pw/hamilt_pwdft/operator_pw/op_exx_pw.h"
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <map>
+#include <vector>
+#ifdef __MPI
+#include "mpi.h"
+#endif
+
+/************************************************
+ *  unit test of op_exx_pw.cpp
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - OperatorEXX::update_ace() and OperatorEXX::act()
+ *     - on the orbitals it is built from, the ACE operator equals alpha Vx, with
+ *       Vx psi(G) = - 1/omega sum_{mq} f_{mq} sum_{G1,G'} phi*_{mq}(G1) psi(G') phi_{mq}(G-G'+G1) v(k-q+G'-G1)
+ *       summed directly over the plane waves as reference
+ *   - OperatorEXX::cal_exx_energy()
+ *     - -1/2 sum_{nk} wg(k,n) <psi_nk|alpha Vx|psi_nk> with the reference Vx
+ *   - the truncated Coulomb kernel on the full k mesh, and the erfc-screened kernel on the mesh reduced
+ *     by time reversal symmetry, where u_{-k}(G) = u_k(-G)^*
+ */
+
+using T = std::complex<double>;
+using Miller = std::array<int, 3>;
+
+class OpExxPwTest : public testing::Test
+{
+  protected:
+    ModulePW::PW_Basis rhopw;
+    ModulePW::PW_Basis_K wfcpw;
+    const int nbands = 3;
+    std::vector<int> isk;
+    ModuleBase::matrix wg;
+
+    void init(const std::vector<ModuleBase::Vector3<double>>& kvec_d)
+    {
+        const int nks = kvec_d.size();
+        const double lat0 = 5.0;
+        const ModuleBase::Matrix3 latvec(1, 0, 0, 0.1, 1.1, 0, 0, 0, 0.9);
+        const double ecut = 8.0;
+#ifdef __MPI
+        rhopw.initmpi(1, 0, POOL_WORLD);
+        wfcpw.initmpi(1, 0, POOL_WORLD);
+#endif
+        rhopw.initgrids(lat0, latvec, 4 * ecut);
+        rhopw.initparameters(false, 4 * ecut);
+        rhopw.setuptransform();
+        rhopw.collect_local_pw();
+        wfcpw.initgrids(lat0, latvec, rhopw.nx, rhopw.ny, rhopw.nz);
+        wfcpw.initparameters(false, ecut, nks, kvec_d.data());
+        wfcpw.setuptransform();
+        wfcpw.collect_local_pw();
+
+        isk.assign(nks, 0);
+        // the last band is empty
+        wg.create(nks, nbands);
+        for (int ik = 0; ik < nks; ++ik)
+        {
+            wg(ik, 0) = 2.0 / nks;
+            wg(ik, 1) = 1.2 / nks;
+        }
+    }
+
+    void fill_psi(psi::Psi<T>& psi)
+    {
+        for (int ik = 0; ik < psi.get_nk(); ++ik)
+        {
+            psi.fix_k(ik);
+            for (int ib = 0; ib < nbands; ++ib)
+            {
+                for (int ig = 0; ig < psi.get_nbasis(); ++ig)
+                {
+                    psi(ib, ig) = (ig < wfcpw.npwk[ik])
+                                      ? T(std::cos(0.3 * ig + ib + ik), std::sin(0.7 * ig * (ib + 1) - ik)) / (1.0 + ig)
+                                      : T(0.0, 0.0);
+                }
+            }
+        }
+    }
+
+    Miller miller(const ModuleBase::Vector3<double>& g) const
+    {
+        return {static_cast<int>(std::round(g.x)), static_cast<int>(std::round(g.y)), static_cast<int>(std::round(g.z))};
+    }
+    // index on the FFT grid, as seen by the FFTs
+    Miller wrap(const Miller& g) const
+    {
+        return {(g[0] % rhopw.nx + rhopw.nx) % rhopw.nx,
+                (g[1] % rhopw.ny + rhopw.ny) % rhopw.ny,
+                (g[2] % rhopw.nz + rhopw.nz) % rhopw.nz};
+    }
+
+    struct Orbital
+    {
+        ModuleBase::Vector3<double> q;
+        double f;
+        std::vector<std::pair<Miller, T>> coef;
+    };
+
+    double kernel(const ModuleBase::Vector3<double>& dkq, const int nks_full, const double hse_omega) const
+    {
+        const double fpi_e2 = ModuleBase::FOUR_PI * 2.0;
+        const double q2 = dkq.norm2() * rhopw.tpiba2;
+        if (hse_omega > 0.0)
+        {
+            const double x = 0.25 / (hse_omega * hse_omega);
+            return (q2 > 1e-12) ? fpi_e2 / q2 * (1.0 - std::exp(-q2 * x)) : fpi_e2 * x;
+        }
+        const double rcut = std::cbrt(3.0 * rhopw.omega * nks_full / ModuleBase::FOUR_PI);
+        return (q2 > 1e-12) ? fpi_e2 / q2 * (1.0 - std::cos(std::sqrt(q2) * rcut)) : 0.5 * fpi_e2 * rcut * rcut;
+    }
+
+    /// alpha Vx psi_nk by direct sums over the plane waves
+    void reference(const psi::Psi<T>& psi,
+                   const int nks_full,
+                   const bool time_reversal,
+                   const double alpha,
+                   const double hse_omega,
+                   std::vector<std::vector<T>>& vpsi)
+    {
+        const int nks = psi.get_nk();
+        const int nbasis = psi.get_nbasis();
+        // the spin degeneracy in wg
+        const double spin_fac = 0.5;
+        std::map<Miller, int> rho_index;
+        for (int ig = 0; ig < rhopw.npw; ++ig)
+        {
+            rho_index[wrap(miller(rhopw.gdirect[ig]))] = ig;
+        }
+
+        std::vector<Orbital> occ;
+        for (int iq = 0; iq < nks; ++iq)
+        {
+            psi.fix_k(iq);
+            for (int ib = 0; ib < nbands; ++ib)
+            {
+                if (wg(iq, ib) == 0.0)
+                {
+                    continue;
+                }
+                Orbital phi{wfcpw.kvec_c[iq], wg(iq, ib) * spin_fac * (time_reversal ? 0.5 : 1.0), {}};
+                Orbital phi_minus{-wfcpw.kvec_c[iq], phi.f, {}};
+                for (int ig = 0; ig < wfcpw.npwk[iq]; ++ig)
+                {
+                    const Miller g = miller(wfcpw.getgdirect(iq, ig));
+                    phi.coef.push_back({g, psi(ib, ig)});
+                    phi_minus.coef.push_back({{-g[0], -g[1], -g[2]}, std::conj(psi(ib, ig))});
+                }
+                occ.push_back(phi);
+                if (time_reversal)
+                {
+                    occ.push_back(phi_minus);
+                }
+            }
+        }
+
+        vpsi.assign(nks, std::vector<T>(nbands * nbasis, T(0.0, 0.0)));
+        for (int ik = 0; ik < nks; ++ik)
+        {
+            psi.fix_k(ik);
+            const int npw = wfcpw.npwk[ik];
+            std::map<Miller, int> k_index;
+            for (int ig = 0; ig < npw; ++ig)
+            {
+                k_index[wrap(miller(wfcpw.getgdirect(ik, ig)))] = ig;
+            }
+            for (const Orbital& phi: occ)
+            {
+                const ModuleBase::Vector3<double> dk = wfcpw.kvec_c[ik] - phi.q;
+                for (int ib = 0; ib < nbands; ++ib)
+                {
+                    for (int igp = 0; igp < npw; ++igp)
+                    {
+                        const Miller gp = miller(wfcpw.getgdirect(ik, igp));
+                        for (const auto& a1: phi.coef)
+                        {
+                            // the pair density only keeps the plane waves of rhopw
+                            const auto it_rho = rho_index.find(
+                                wrap({gp[0] - a1.first[0], gp[1] - a1.first[1], gp[2] - a1.first[2]}));
+                            if (it_rho == rho_index.end())
+                            {
+                                continue;
+                            }
+                            const Miller gq = miller(rhopw.gdirect[it_rho->second]);
+                            const T pair = std::conj(a1.second) * psi(ib, igp)
+                                           * kernel(dk + rhopw.gcar[it_rho->second], nks_full, hse_omega);
+                            for (const auto& a3: phi.coef)
+                            {
+                                const auto it_k
+                                    = k_index.find(wrap({a3.first[0] + gq[0], a3.first[1] + gq[1], a3.first[2] + gq[2]}));
+                                if (it_k != k_index.end())
+                                {
+                                    vpsi[ik][ib * nbasis + it_k->second]
+                                        -= alpha * phi.f / rhopw.omega * pair * a3.second;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void check(const int nks_full, const bool time_reversal, const double alpha, const double hse_omega)
+    {
+        const int nks = wfcpw.nks;
+        const int nbasis = wfcpw.npwk_max;
+        psi::Psi<T> psi(nks, nbands, nbasis, wfcpw.npwk);
+        fill_psi(psi);
+
+        hamilt::OperatorEXX<hamilt::OperatorPW<T, psi::DEVICE_CPU>> op(isk.data(), &wfcpw, &rhopw, nks_full, alpha, hse_omega);
+        EXPECT_FALSE(op.ace_ready());
+        op.update_ace(psi, wg);
+        EXPECT_TRUE(op.ace_ready());
+
+        std::vector<std::vector<T>> vpsi_ref;
+        reference(psi, nks_full, time_reversal, alpha, hse_omega, vpsi_ref);
+
+        double energy_ref = 0.0;
+        for (int ik = 0; ik < nks; ++ik)
+        {
+            psi.fix_k(ik);
+            op.init(ik);
+            std::vector<T> hpsi(nbands * nbasis, T(0.0, 0.0));
+            op.act(nbands, nbasis, 1, &psi(0, 0), hpsi.data(), wfcpw.npwk[ik]);
+            for (int ib = 0; ib < nbands; ++ib)
+            {
+                for (int ig = 0; ig < wfcpw.npwk[ik]; ++ig)
+                {
+                    const T ref = vpsi_ref[ik][ib * nbasis + ig];
+                    EXPECT_NEAR(hpsi[ib * nbasis + ig].real(), ref.real(), 1e-8);
+                    EXPECT_NEAR(hpsi[ib * nbasis + ig].imag(), ref.imag(), 1e-8);
+                    energy_ref -= 0.5 * wg(ik, ib) * (std::conj(psi(ib, ig)) * ref).real();
+                }
+            }
+        }
+        EXPECT_GT(energy_ref, 0.0);
+        EXPECT_NEAR(op.cal_exx_energy(psi, wg), energy_ref, 1e-8);
+    }
+};
+
+TEST_F(OpExxPwTest, CoulombFullMesh)
+{
+    init({{0.0, 0.0, 0.0}, {0.5, 0.0, 0.0}});
+    check(2, false, 0.25, 0.0);
+}
+
+TEST_F(OpExxPwTest, ScreenedTimeReversal)
+{
+    // the mesh {k, -k} reduced to k
+    init({{0.25, 0.25, 0.0}});
+    check(2, true, 0.25, 0.106);
+}
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_split(MPI_COMM_WORLD, 0, 1, &POOL_WORLD);
+#endif
+    GlobalV::NSPIN = 1;
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+    return result;
+}
@@ -126,6 +126,12 @@ void WF_atomic::init_at_1(Structure_Factor *sf_in)
             if (atom->ncpp.oc[ic] >= 0.0)
             {
                 const int l = atom->ncpp.lchi[ic];
+                if (GlobalV::PSEUDO_SBT_FFT)
+                {
+                    // tabulated by FFT and interpolated onto the q points of tab_at
+                    GlobalC::ppcell.sbt_table(l, atom->ncpp.msh, atom->ncpp.r, &atom->ncpp.chi(ic, 0), pref, &GlobalC::ppcell.tab_at(it, ic, 0));
+                    continue;
+                }
                 for (int iq=startq; iq<GlobalV::NQX; iq++)
                 {
                     const double q = GlobalV::DQ * iq;
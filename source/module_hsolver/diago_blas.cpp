@@ -10,17 +10,44 @@
 #include "module_base/global_function.h"
 #include "module_base/global_variable.h"
 #include "module_base/scalapack_connector.h"
+#include "module_base/timer.h"
 #include "module_hamilt_general/matrixblock.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 
 typedef hamilt::MatrixBlock<double> matd;
 typedef hamilt::MatrixBlock<std::complex<double>> matcd;
 
+namespace
+{
+int cholesky(double *s_mat, const int *const desc)
+{
+    char uplo = 'U';
+    int n = GlobalV::NLOCAL, one = 1, info = 0;
+    int desc_s[9];
+    std::copy(desc, desc + 9, desc_s);
+    pdpotrf_(&uplo, &n, s_mat, &one, &one, desc_s, &info);
+    return info;
+}
+
+int cholesky(std::complex<double> *s_mat, const int *const desc)
+{
+    char uplo = 'U';
+    int n = GlobalV::NLOCAL, one = 1, info = 0;
+    int desc_s[9];
+    std::copy(desc, desc + 9, desc_s);
+    pzpotrf_(&uplo, &n, s_mat, &one, &one, desc_s, &info);
+    return info;
+}
+} // namespace
+
 namespace hsolver
 {
 
+bool DiagoBlas::s_changed = true;
+
 void DiagoBlas::diag(hamilt::Hamilt<std::complex<double>> *phm_in, psi::Psi<double> &psi, double *eigenvalue_in)
 {
     ModuleBase::TITLE("DiagoElpa", "diag");
@@ -28,7 +55,12 @@ void DiagoBlas::diag(hamilt::Hamilt<std::complex<double>> *phm_in, psi::Psi<doub
     phm_in->matrix(h_mat, s_mat);
     assert(h_mat.col == s_mat.col && h_mat.row == s_mat.row && h_mat.desc == s_mat.desc);
     std::vector<double> eigen(GlobalV::NLOCAL, 0.0);
-    this->pdsygvx_diag(h_mat.desc, h_mat.col, h_mat.row, h_mat.p, s_mat.p, eigen.data(), psi);
+    const double *s_factor
+        = this->get_s_factor(this->s_factor_gamma, psi.get_current_k(), h_mat.desc, h_mat.col, h_mat.row, s_mat.p);
+    if (s_factor != nullptr)
+        this->pdsyevx_diag(h_mat.desc, h_mat.col, h_mat.row, h_mat.p, s_factor, eigen.data(), psi);
+    else
+        this->pdsygvx_diag(h_mat.desc, h_mat.col, h_mat.row, h_mat.p, s_mat.p, eigen.data(), psi);
     const int inc = 1;
     BlasConnector::copy(GlobalV::NBANDS, eigen.data(), inc, eigenvalue_in, inc);
 }
@@ -40,7 +72,12 @@ void DiagoBlas::diag(hamilt::Hamilt<std::complex<double>> *phm_in, psi::Psi<std:
     phm_in->matrix(h_mat, s_mat);
     assert(h_mat.col == s_mat.col && h_mat.row == s_mat.row && h_mat.desc == s_mat.desc);
     std::vector<double> eigen(GlobalV::NLOCAL, 0.0);
-    this->pzhegvx_diag(h_mat.desc, h_mat.col, h_mat.row, h_mat.p, s_mat.p, eigen.data(), psi);
+    const std::complex<double> *s_factor
+        = this->get_s_factor(this->s_factor_k, psi.get_current_k(), h_mat.desc, h_mat.col, h_mat.row, s_mat.p);
+    if (s_factor != nullptr)
+        this->pzheevx_diag(h_mat.desc, h_mat.col, h_mat.row, h_mat.p, s_factor, eigen.data(), psi);
+    else
+        this->pzhegvx_diag(h_mat.desc, h_mat.col, h_mat.row, h_mat.p, s_mat.p, eigen.data(), psi);
     const int inc = 1;
     BlasConnector::copy(GlobalV::NBANDS, eigen.data(), inc, eigenvalue_in, inc);
 }
@@ -302,6 +339,238 @@ std::pair<int, std::vector<int>> DiagoBlas::pzhegvx_once(const int *const desc,
                                  + ModuleBase::GlobalFunc::TO_STRING(__LINE__));
 }
 
+template <typename T>
+const T* DiagoBlas::get_s_factor(std::vector<std::vector<T>> &s_factor,
+                                 const int ik,
+                                 const int *const desc,
+                                 const int ncol,
+                                 const int nrow,
+                                 const T *const s_mat)
+{
+    if (DiagoBlas::s_changed)
+    {
+        this->s_factor_gamma.clear();
+        this->s_factor_k.clear();
+        DiagoBlas::s_changed = false;
+    }
+    if (s_factor.size() <= static_cast<size_t>(ik))
+        s_factor.resize(ik + 1);
+
+    std::vector<T> &u = s_factor[ik];
+    if (u.empty())
+    {
+        ModuleBase::timer::tick("DiagoBlas", "cholesky_S");
+        u.assign(s_mat, s_mat + static_cast<size_t>(ncol) * nrow);
+        const int info = cholesky(u.data(), desc);
+        ModuleBase::timer::tick("DiagoBlas", "cholesky_S");
+        // leave the failure to p?gvx, which reports it in post_processing
+        if (info != 0)
+        {
+            u.clear();
+            return nullptr;
+        }
+    }
+    return u.data();
+}
+
+std::pair<int, std::vector<int>> DiagoBlas::pdsyevx_once(const int *const desc,
+                                                         const int ncol,
+                                                         const int nrow,
+                                                         const double *const h_mat,
+                                                         const double *const s_factor,
+                                                         double *const ekb,
+                                                         psi::Psi<double> &wfc_2d) const
+{
+    ModuleBase::matrix h_tmp(ncol, nrow, false);
+    memcpy(h_tmp.c, h_mat, sizeof(double) * ncol * nrow);
+
+    // H -> U^{-T} H U^{-1}
+    const int itype = 1, one = 1;
+    const char uplo = 'U';
+    double scale = 1.0;
+    int info = 0;
+    pdsygst_(&itype, &uplo, &GlobalV::NLOCAL, h_tmp.c, &one, &one, desc, s_factor, &one, &one, desc, &scale, &info);
+    if (info)
+        throw std::runtime_error("info = " + ModuleBase::GlobalFunc::TO_STRING(info) + ".\n"
+                                 + ModuleBase::GlobalFunc::TO_STRING(__FILE__) + " line "
+                                 + ModuleBase::GlobalFunc::TO_STRING(__LINE__));
+
+    const char jobz = 'V', range = 'I';
+    const int il = 1, iu = GlobalV::NBANDS;
+    int M = 0, NZ = 0, lwork = -1, liwork = -1;
+    double vl = 0, vu = 0;
+    const double abstol = 0, orfac = -1;
+    std::vector<double> work(3, 0);
+    std::vector<int> iwork(1, 0);
+    std::vector<int> ifail(GlobalV::NLOCAL, 0);
+    std::vector<int> iclustr(2 * GlobalV::DSIZE);
+    std::vector<double> gap(GlobalV::DSIZE);
+
+    pdsyevx_(&jobz, &range, &uplo, &GlobalV::NLOCAL, h_tmp.c, &one, &one, desc,
+             &vl, &vu, &il, &iu, &abstol, &M, &NZ, ekb, &orfac,
+             wfc_2d.get_pointer(), &one, &one, desc,
+             work.data(), &lwork, iwork.data(), &liwork,
+             ifail.data(), iclustr.data(), gap.data(), &info);
+    if (info)
+        throw std::runtime_error("info = " + ModuleBase::GlobalFunc::TO_STRING(info) + ".\n"
+                                 + ModuleBase::GlobalFunc::TO_STRING(__FILE__) + " line "
+                                 + ModuleBase::GlobalFunc::TO_STRING(__LINE__));
+
+    lwork = work[0];
+    work.resize(std::max(lwork, 3), 0);
+    liwork = iwork[0];
+    iwork.resize(liwork, 0);
+
+    pdsyevx_(&jobz, &range, &uplo, &GlobalV::NLOCAL, h_tmp.c, &one, &one, desc,
+             &vl, &vu, &il, &iu, &abstol, &M, &NZ, ekb, &orfac,
+             wfc_2d.get_pointer(), &one, &one, desc,
+             work.data(), &lwork, iwork.data(), &liwork,
+             ifail.data(), iclustr.data(), gap.data(), &info);
+
+    if (info == 0)
+    {
+        // c = U^{-1} y
+        const char side = 'L', transa = 'N', diag = 'N';
+        const double alpha = 1.0;
+        pdtrsm_(&side, &uplo, &transa, &diag, &GlobalV::NLOCAL, &GlobalV::NBANDS, &alpha,
+                s_factor, &one, &one, desc, wfc_2d.get_pointer(), &one, &one, desc);
+        if (scale != 1.0)
+            for (int i = 0; i < M; ++i)
+                ekb[i] *= scale;
+        return std::make_pair(info, std::vector<int>{});
+    }
+    else if (info < 0)
+        return std::make_pair(info, std::vector<int>{});
+    else if (info % 2)
+        return std::make_pair(info, ifail);
+    else if (info / 2 % 2)
+        return std::make_pair(info, iclustr);
+    else if (info / 4 % 2)
+        return std::make_pair(info, std::vector<int>{M, NZ});
+    else
+        throw std::runtime_error("info = " + ModuleBase::GlobalFunc::TO_STRING(info) + ".\n"
+                                 + ModuleBase::GlobalFunc::TO_STRING(__FILE__) + " line "
+                                 + ModuleBase::GlobalFunc::TO_STRING(__LINE__));
+}
+
+std::pair<int, std::vector<int>> DiagoBlas::pzheevx_once(const int *const desc,
+                                                         const int ncol,
+                                                         const int nrow,
+                                                         const std::complex<double> *const h_mat,
+                                                         const std::complex<double> *const s_factor,
+                                                         double *const ekb,
+                                                         psi::Psi<std::complex<double>> &wfc_2d) const
+{
+    ModuleBase::ComplexMatrix h_tmp(ncol, nrow, false);
+    memcpy(h_tmp.c, h_mat, sizeof(std::complex<double>) * ncol * nrow);
+
+    // H -> U^{-H} H U^{-1}
+    const int itype = 1, one = 1;
+    const char uplo = 'U';
+    double scale = 1.0;
+    int info = 0;
+    pzhegst_(&itype, &uplo, &GlobalV::NLOCAL, h_tmp.c, &one, &one, desc, s_factor, &one, &one, desc, &scale, &info);
+    if (info)
+        throw std::runtime_error("info = " + ModuleBase::GlobalFunc::TO_STRING(info) + ".\n"
+                                 + ModuleBase::GlobalFunc::TO_STRING(__FILE__) + " line "
+                                 + ModuleBase::GlobalFunc::TO_STRING(__LINE__));
+
+    const char jobz = 'V', range = 'I';
+    const int il = 1, iu = GlobalV::NBANDS;
+    int M = 0, NZ = 0, lwork = -1, lrwork = -1, liwork = -1;
+    const double abstol = 0, orfac = -1;
+    // same as pzhegvx_, vl, vu and at least 3 elements of rwork must be given
+    const double vl = 0, vu = 0;
+    std::vector<std::complex<double>> work(1, 0);
+    std::vector<double> rwork(3, 0);
+    std::vector<int> iwork(1, 0);
+    std::vector<int> ifail(GlobalV::NLOCAL, 0);
+    std::vector<int> iclustr(2 * GlobalV::DSIZE);
+    std::vector<double> gap(GlobalV::DSIZE);
+
+    pzheevx_(&jobz, &range, &uplo, &GlobalV::NLOCAL, h_tmp.c, &one, &one, desc,
+             &vl, &vu, &il, &iu, &abstol, &M, &NZ, ekb, &orfac,
+             wfc_2d.get_pointer(), &one, &one, desc,
+             work.data(), &lwork, rwork.data(), &lrwork, iwork.data(), &liwork,
+             ifail.data(), iclustr.data(), gap.data(), &info);
+    if (info)
+        throw std::runtime_error("info=" + ModuleBase::GlobalFunc::TO_STRING(info) + ". "
+                                 + ModuleBase::GlobalFunc::TO_STRING(__FILE__) + " line "
+                                 + ModuleBase::GlobalFunc::TO_STRING(__LINE__));
+
+    lwork = work[0].real();
+    work.resize(lwork, 0);
+    lrwork = rwork[0] + this->degeneracy_max * GlobalV::NLOCAL;
+    rwork.resize(std::max(lrwork, 3), 0);
+    liwork = iwork[0];
+    iwork.resize(liwork, 0);
+
+    pzheevx_(&jobz, &range, &uplo, &GlobalV::NLOCAL, h_tmp.c, &one, &one, desc,
+             &vl, &vu, &il, &iu, &abstol, &M, &NZ, ekb, &orfac,
+             wfc_2d.get_pointer(), &one, &one, desc,
+             work.data(), &lwork, rwork.data(), &lrwork, iwork.data(), &liwork,
+             ifail.data(), iclustr.data(), gap.data(), &info);
+
+    if (info == 0)
+    {
+        // c = U^{-1} y
+        const char side = 'L', transa = 'N', diag = 'N';
+        const std::complex<double> alpha = 1.0;
+        pztrsm_(&side, &uplo, &transa, &diag, &GlobalV::NLOCAL, &GlobalV::NBANDS, &alpha,
+                s_factor, &one, &one, desc, wfc_2d.get_pointer(), &one, &one, desc);
+        if (scale != 1.0)
+            for (int i = 0; i < M; ++i)
+                ekb[i] *= scale;
+        return std::make_pair(info, std::vector<int>{});
+    }
+    else if (info < 0)
+        return std::make_pair(info, std::vector<int>{});
+    else if (info % 2)
+        return std::make_pair(info, ifail);
+    else if (info / 2 % 2)
+        return std::make_pair(info, iclustr);
+    else if (info / 4 % 2)
+        return std::make_pair(info, std::vector<int>{M, NZ});
+    else
+        throw std::runtime_error("info = " + ModuleBase::GlobalFunc::TO_STRING(info) + ".\n"
+                                 + ModuleBase::GlobalFunc::TO_STRING(__FILE__) + " line "
+                                 + ModuleBase::GlobalFunc::TO_STRING(__LINE__));
+}
+
+void DiagoBlas::pdsyevx_diag(const int *const desc,
+                             const int ncol,
+                             const int nrow,
+                             const double *const h_mat,
+                             const double *const s_factor,
+                             double *const ekb,
+                             psi::Psi<double> &wfc_2d)
+{
+    while (true)
+    {
+        const std::pair<int, std::vector<int>> info_vec = pdsyevx_once(desc, ncol, nrow, h_mat, s_factor, ekb, wfc_2d);
+        post_processing(info_vec.first, info_vec.second);
+        if (info_vec.first == 0)
+            break;
+    }
+}
+
+void DiagoBlas::pzheevx_diag(const int *const desc,
+                             const int ncol,
+                             const int nrow,
+                             const std::complex<double> *const h_mat,
+                             const std::complex<double> *const s_factor,
+                             double *const ekb,
+                             psi::Psi<std::complex<double>> &wfc_2d)
+{
+    while (true)
+    {
+        const std::pair<int, std::vector<int>> info_vec = pzheevx_once(desc, ncol, nrow, h_mat, s_factor, ekb, wfc_2d);
+        post_processing(info_vec.first, info_vec.second);
+        if (info_vec.first == 0)
+            break;
+    }
+}
+
 void DiagoBlas::pdsygvx_diag(const int *const desc,
                              const int ncol,
                              const int nrow,
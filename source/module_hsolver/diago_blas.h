@@ -28,6 +28,10 @@ class DiagoBlas : public DiagH<std::complex<double>>
 
     void diag(hamilt::Hamilt<std::complex<double>> *phm_in, psi::Psi<std::complex<double>> &psi, double *eigenvalue_in) override;
 
+    // S(k) only depends on the structure, so its Cholesky factor is kept for each k point and reused
+    // in later SCF iterations. OperatorLCAO sets it to true when S(k) is rebuilt, which drops all factors.
+    static bool s_changed;
+
   private:
     void pdsygvx_diag(const int *const desc,
                       const int ncol,
@@ -59,8 +63,54 @@ class DiagoBlas : public DiagH<std::complex<double>>
                                                   double *const ekb,
                                                   psi::Psi<std::complex<double>> &wfc_2d) const;
 
+    // solve the standard problem U^{-H} H U^{-1} y = e y with the cached S = U^H U, and c = U^{-1} y
+    void pdsyevx_diag(const int *const desc,
+                      const int ncol,
+                      const int nrow,
+                      const double *const h_mat,
+                      const double *const s_factor,
+                      double *const ekb,
+                      psi::Psi<double> &wfc_2d);
+    void pzheevx_diag(const int *const desc,
+                      const int ncol,
+                      const int nrow,
+                      const std::complex<double> *const h_mat,
+                      const std::complex<double> *const s_factor,
+                      double *const ekb,
+                      psi::Psi<std::complex<double>> &wfc_2d);
+
+    std::pair<int, std::vector<int>> pdsyevx_once(const int *const desc,
+                                                  const int ncol,
+                                                  const int nrow,
+                                                  const double *const h_mat,
+                                                  const double *const s_factor,
+                                                  double *const ekb,
+                                                  psi::Psi<double> &wfc_2d) const;
+    std::pair<int, std::vector<int>> pzheevx_once(const int *const desc,
+                                                  const int ncol,
+                                                  const int nrow,
+                                                  const std::complex<double> *const h_mat,
+                                                  const std::complex<double> *const s_factor,
+                                                  double *const ekb,
+                                                  psi::Psi<std::complex<double>> &wfc_2d) const;
+
+    // return the Cholesky factor U of S for the ik-th k point, decompose S if it is not cached,
+    // nullptr if S is not positive definite
+    template <typename T>
+    const T* get_s_factor(std::vector<std::vector<T>> &s_factor,
+                          const int ik,
+                          const int *const desc,
+                          const int ncol,
+                          const int nrow,
+                          const T *const s_mat);
+
     int degeneracy_max = 12; // For reorthogonalized memory. 12 followes siesta.
 
+    // Cholesky factors of S(k) of each k point in the 2D-block layout of Parallel_Orbitals,
+    // the upper triangle holds U. An empty vector means S(k) has not been decomposed.
+    std::vector<std::vector<double>> s_factor_gamma;
+    std::vector<std::vector<std::complex<double>>> s_factor_k;
+
     void post_processing(const int info, const std::vector<int> &vec);
 };
 
@@ -17,6 +17,7 @@ typedef hamilt::MatrixBlock<std::complex<double>> matcd;
 namespace hsolver
 {
 int DiagoElpa::DecomposedState = 0;
+bool DiagoElpa::s_changed = true;
 void DiagoElpa::diag(hamilt::Hamilt<std::complex<double>> *phm_in, psi::Psi<std::complex<double>> &psi, double *eigenvalue_in)
 {
     ModuleBase::TITLE("DiagoElpa", "diag");
@@ -29,9 +30,26 @@ void DiagoElpa::diag(hamilt::Hamilt<std::complex<double>> *phm_in, psi::Psi<std:
     bool isReal=false;
     const MPI_Comm COMM_DIAG=MPI_COMM_WORLD; // use all processes
     ELPA_Solver es((const bool)isReal, COMM_DIAG, (const int)GlobalV::NBANDS, (const int)h_mat.row, (const int)h_mat.col, (const int*)h_mat.desc);
-    this->DecomposedState=0; // for k pointer, the decomposed s_mat can not be reused
+
+    // s_mat is rebuilt for each k point, so the decomposed one is kept in decomposed_s_k instead
+    if (DiagoElpa::s_changed)
+    {
+        this->decomposed_s_k.clear();
+        this->decomposed_state_k.clear();
+        DiagoElpa::s_changed = false;
+    }
+    const int ik = psi.get_current_k();
+    if (this->decomposed_state_k.size() <= static_cast<size_t>(ik))
+    {
+        this->decomposed_s_k.resize(ik + 1);
+        this->decomposed_state_k.resize(ik + 1, 0);
+    }
+    if (this->decomposed_state_k[ik] == 0)
+    {
+        this->decomposed_s_k[ik].assign(s_mat.p, s_mat.p + s_mat.row * s_mat.col);
+    }
     ModuleBase::timer::tick("DiagoElpa", "elpa_solve");
-    es.generalized_eigenvector(h_mat.p, s_mat.p, this->DecomposedState, eigen.data(), psi.get_pointer());
+    es.generalized_eigenvector(h_mat.p, this->decomposed_s_k[ik].data(), this->decomposed_state_k[ik], eigen.data(), psi.get_pointer());
     ModuleBase::timer::tick("DiagoElpa", "elpa_solve");
     es.exit();
 
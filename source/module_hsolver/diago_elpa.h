@@ -4,6 +4,9 @@
 #include "diagh.h"
 #include "module_basis/module_ao/parallel_orbitals.h"
 
+#include <complex>
+#include <vector>
+
 namespace hsolver
 {
 
@@ -17,10 +20,19 @@ class DiagoElpa : public DiagH<std::complex<double>>
     
     static int DecomposedState;
 
+    // for multi-k, decomposed S(k) of each k point are cached and reused in later SCF iterations.
+    // OperatorLCAO sets it to true when S(k) is rebuilt, which drops all of them.
+    static bool s_changed;
+
   private:
 #ifdef __MPI
     bool ifElpaHandle(const bool& newIteration, const bool& ifNSCF);
 #endif
+
+    // decomposed S(k) (U^{-1} or S^{-1/2}, see ELPA_Solver::decomposeRightMatrix) of each k point
+    // in the 2D-block layout of Parallel_Orbitals, and the DecomposedState of each of them
+    std::vector<std::vector<std::complex<double>>> decomposed_s_k;
+    std::vector<int> decomposed_state_k;
 };
 
 } // namespace hsolver
@@ -0,0 +1,663 @@
+#include "dm_purification.h"
+
+#include "module_base/blas_connector.h"
+#include "module_base/timer.h"
+#include "module_base/tool_quit.h"
+#include "module_base/tool_title.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace hsolver
+{
+
+namespace
+{
+// maximal number of Newton-Schulz or purification steps
+constexpr int max_iter = 100;
+
+#ifdef __MPI
+// send[ip] is sent to process ip, the buffers received from all processes are concatenated in the order of the processes
+std::vector<int> alltoall(const std::vector<std::vector<int>>& send, std::vector<int>& recv_counts, MPI_Comm comm)
+{
+    const int nproc = send.size();
+    std::vector<int> send_counts(nproc), send_displs(nproc, 0), recv_displs(nproc, 0);
+    std::vector<int> buffer;
+    for (int ip = 0; ip < nproc; ++ip)
+    {
+        send_counts[ip] = send[ip].size();
+        send_displs[ip] = buffer.size();
+        buffer.insert(buffer.end(), send[ip].begin(), send[ip].end());
+    }
+    recv_counts.assign(nproc, 0);
+    MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, comm);
+    for (int ip = 1; ip < nproc; ++ip)
+    {
+        recv_displs[ip] = recv_displs[ip - 1] + recv_counts[ip - 1];
+    }
+    std::vector<int> recv(recv_displs[nproc - 1] + recv_counts[nproc - 1]);
+    MPI_Alltoallv(buffer.data(),
+                  send_counts.data(),
+                  send_displs.data(),
+                  MPI_INT,
+                  recv.data(),
+                  recv_counts.data(),
+                  recv_displs.data(),
+                  MPI_INT,
+                  comm);
+    return recv;
+}
+#endif
+} // namespace
+
+#ifdef __MPI
+void DMPurification::init(const std::vector<int>& nw_in, MPI_Comm comm_in)
+#else
+void DMPurification::init(const std::vector<int>& nw_in)
+#endif
+{
+    ModuleBase::TITLE("DMPurification", "init");
+    this->nw = nw_in;
+    const int nat = this->nw.size();
+    this->nbasis = 0;
+    for (int iat = 0; iat < nat; ++iat)
+    {
+        this->nbasis += this->nw[iat];
+    }
+
+    // distribute contiguous rows with balanced number of orbitals
+    int nproc = 1, rank = 0;
+#ifdef __MPI
+    this->comm = comm_in;
+    MPI_Comm_size(this->comm, &nproc);
+    MPI_Comm_rank(this->comm, &rank);
+#endif
+    this->row_split.assign(nproc + 1, nat);
+    this->row_split[0] = 0;
+    int ip = 1;
+    int nw_sum = 0;
+    for (int iat = 0; iat < nat && ip < nproc; ++iat)
+    {
+        nw_sum += this->nw[iat];
+        while (ip < nproc && nw_sum >= static_cast<double>(this->nbasis) * ip / nproc)
+        {
+            this->row_split[ip++] = iat + 1;
+        }
+    }
+    this->row_begin = this->row_split[rank];
+    this->row_end = this->row_split[rank + 1];
+    this->nlocal = this->row_end - this->row_begin;
+}
+
+int DMPurification::get_owner(const int iat) const
+{
+    return std::upper_bound(this->row_split.begin(), this->row_split.end(), iat) - this->row_split.begin() - 1;
+}
+
+void DMPurification::set_pattern(const std::vector<int>& pairs)
+{
+    ModuleBase::TITLE("DMPurification", "set_pattern");
+    ModuleBase::timer::tick("DMPurification", "set_pattern");
+    const int nat = this->nw.size();
+
+    // each block and its mirror go to the process of their rows
+    int nproc = 1;
+#ifdef __MPI
+    MPI_Comm_size(this->comm, &nproc);
+#endif
+    std::vector<std::vector<int>> send(nproc);
+    for (size_t i = 0; i + 4 < pairs.size(); i += 5)
+    {
+        const int* p = &pairs[i];
+        std::vector<int>& to_row1 = send[this->get_owner(p[0])];
+        to_row1.insert(to_row1.end(), {p[0], p[1], p[2], p[3], p[4]});
+        std::vector<int>& to_row2 = send[this->get_owner(p[1])];
+        to_row2.insert(to_row2.end(), {p[1], p[0], -p[2], -p[3], -p[4]});
+    }
+#ifdef __MPI
+    std::vector<int> recv_counts;
+    const std::vector<int> blocks = alltoall(send, recv_counts, this->comm);
+#else
+    const std::vector<int>& blocks = send[0];
+#endif
+
+    // (J, Rx, Ry, Rz) of each local row, with diagonal blocks
+    std::vector<std::vector<std::array<int, 4>>> keys(this->nlocal);
+    for (size_t i = 0; i + 4 < blocks.size(); i += 5)
+    {
+        const int* p = &blocks[i];
+        keys[p[0] - this->row_begin].push_back({p[1], p[2], p[3], p[4]});
+    }
+    for (int i = 0; i < this->nlocal; ++i)
+    {
+        keys[i].push_back({this->row_begin + i, 0, 0, 0});
+        std::sort(keys[i].begin(), keys[i].end());
+        keys[i].erase(std::unique(keys[i].begin(), keys[i].end()), keys[i].end());
+    }
+
+    this->slot_of.assign(nat, -1);
+    this->row_start.assign(1, 0);
+    this->blk_col.clear();
+    this->blk_R.clear();
+    this->blk_offset.clear();
+    this->slot_size.clear();
+    this->local_size = 0;
+    for (int i = 0; i < this->nlocal; ++i)
+    {
+        const int iat = this->row_begin + i;
+        this->slot_of[iat] = i;
+        size_t n = 0;
+        for (const auto& key: keys[i])
+        {
+            this->blk_col.push_back(key[0]);
+            this->blk_R.insert(this->blk_R.end(), {key[1], key[2], key[3]});
+            this->blk_offset.push_back(this->local_size + n);
+            n += this->nw[iat] * this->nw[key[0]];
+        }
+        this->row_start.push_back(this->blk_col.size());
+        this->slot_size.push_back(n);
+        this->local_size += n;
+    }
+    this->blk_diag.resize(this->nlocal);
+    for (int i = 0; i < this->nlocal; ++i)
+    {
+        this->blk_diag[i] = this->find_in_slot(i, this->row_begin + i, 0, 0, 0);
+    }
+    const int nblocks_local = this->blk_col.size();
+
+    // the rows of other processes in the columns of the local rows
+    std::vector<int> need;
+    for (int ib = 0; ib < nblocks_local; ++ib)
+    {
+        if (this->blk_col[ib] < this->row_begin || this->blk_col[ib] >= this->row_end)
+        {
+            need.push_back(this->blk_col[ib]);
+        }
+    }
+    std::sort(need.begin(), need.end());
+    need.erase(std::unique(need.begin(), need.end()), need.end());
+
+    this->ghost_size = 0;
+#ifdef __MPI
+    std::vector<std::vector<int>> request(nproc);
+    for (const int iat: need)
+    {
+        request[this->get_owner(iat)].push_back(iat);
+    }
+    std::vector<int> request_counts;
+    const std::vector<int> requested = alltoall(request, request_counts, this->comm);
+
+    // the patterns of the requested rows: number of blocks, then (J, Rx, Ry, Rz) of each block
+    std::vector<std::vector<int>> reply(nproc);
+    this->send_procs.clear();
+    this->send_slots.clear();
+    size_t pos = 0;
+    for (int ip = 0; ip < nproc; ++ip)
+    {
+        if (request_counts[ip] == 0)
+        {
+            continue;
+        }
+        this->send_procs.push_back(ip);
+        this->send_slots.emplace_back();
+        size_t send_size = 0;
+        for (int k = 0; k < request_counts[ip]; ++k)
+        {
+            const int slot = requested[pos++] - this->row_begin;
+            this->send_slots.back().push_back(slot);
+            send_size += this->slot_size[slot];
+            reply[ip].push_back(this->row_start[slot + 1] - this->row_start[slot]);
+            for (int ib = this->row_start[slot]; ib < this->row_start[slot + 1]; ++ib)
+            {
+                const int* r = &this->blk_R[3 * ib];
+                reply[ip].insert(reply[ip].end(), {this->blk_col[ib], r[0], r[1], r[2]});
+            }
+        }
+        if (send_size > static_cast<size_t>(std::numeric_limits<int>::max()))
+        {
+            ModuleBase::WARNING_QUIT("DMPurification::set_pattern", "too many matrix elements, reduce purification_rcut");
+        }
+    }
+    std::vector<int> reply_counts;
+    const std::vector<int> patterns = alltoall(reply, reply_counts, this->comm);
+
+    // the received rows follow the local rows, grouped by the sending process
+    this->recv_procs.clear();
+    this->recv_begin.assign(1, 0);
+    pos = 0;
+    for (int ip = 0; ip < nproc; ++ip)
+    {
+        if (request[ip].empty())
+        {
+            continue;
+        }
+        this->recv_procs.push_back(ip);
+        for (const int iat: request[ip])
+        {
+            this->slot_of[iat] = this->row_start.size() - 1;
+            const int nblocks = patterns[pos++];
+            size_t n = 0;
+            for (int ib = 0; ib < nblocks; ++ib, pos += 4)
+            {
+                this->blk_col.push_back(patterns[pos]);
+                this->blk_R.insert(this->blk_R.end(), {patterns[pos + 1], patterns[pos + 2], patterns[pos + 3]});
+                this->blk_offset.push_back(this->ghost_size + n);
+                n += this->nw[iat] * this->nw[patterns[pos]];
+            }
+            this->row_start.push_back(this->blk_col.size());
+            this->slot_size.push_back(n);
+            this->ghost_size += n;
+        }
+        this->recv_begin.push_back(this->ghost_size);
+        if (this->recv_begin.back() - this->recv_begin[this->recv_begin.size() - 2]
+            > static_cast<size_t>(std::numeric_limits<int>::max()))
+        {
+            ModuleBase::WARNING_QUIT("DMPurification::set_pattern", "too many matrix elements, reduce purification_rcut");
+        }
+    }
+#endif
+
+    this->nblocks_all = std::lround(this->sum_procs(nblocks_local));
+    this->nvalues_all = std::lround(this->sum_procs(this->local_size));
+
+    this->h.assign(this->local_size, 0.0);
+    this->s.assign(this->local_size, 0.0);
+    this->s_inverted.clear();
+    this->sinv.clear();
+    ModuleBase::timer::tick("DMPurification", "set_pattern");
+}
+
+int DMPurification::find_block(const int iat1, const int iat2, const int rx, const int ry, const int rz) const
+{
+    if (iat1 < this->row_begin || iat1 >= this->row_end)
+    {
+        return -1;
+    }
+    return this->find_in_slot(iat1 - this->row_begin, iat2, rx, ry, rz);
+}
+
+int DMPurification::find_in_slot(const int slot, const int iat2, const int rx, const int ry, const int rz) const
+{
+    const std::array<int, 4> key = {iat2, rx, ry, rz};
+    int lo = this->row_start[slot];
+    int hi = this->row_start[slot + 1];
+    while (lo < hi)
+    {
+        const int mid = (lo + hi) / 2;
+        const int* r = &this->blk_R[3 * mid];
+        const std::array<int, 4> k = {this->blk_col[mid], r[0], r[1], r[2]};
+        if (k < key)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    if (lo < this->row_start[slot + 1] && this->blk_col[lo] == iat2)
+    {
+        const int* r = &this->blk_R[3 * lo];
+        if (r[0] == rx && r[1] == ry && r[2] == rz)
+        {
+            return lo;
+        }
+    }
+    return -1;
+}
+
+void DMPurification::fetch_ghosts(const std::vector<double>& a, std::vector<double>& ghost) const
+{
+    ghost.resize(this->ghost_size);
+#ifdef __MPI
+    ModuleBase::timer::tick("DMPurification", "fetch_ghosts");
+    std::vector<MPI_Request> requests(this->recv_procs.size() + this->send_procs.size());
+    for (size_t i = 0; i < this->recv_procs.size(); ++i)
+    {
+        MPI_Irecv(ghost.data() + this->recv_begin[i],
+                  this->recv_begin[i + 1] - this->recv_begin[i],
+                  MPI_DOUBLE,
+                  this->recv_procs[i],
+                  0,
+                  this->comm,
+                  &requests[i]);
+    }
+    std::vector<std::vector<double>> buffers(this->send_procs.size());
+    for (size_t i = 0; i < this->send_procs.size(); ++i)
+    {
+        for (const int slot: this->send_slots[i])
+        {
+            const double* begin = a.data() + this->blk_offset[this->row_start[slot]];
+            buffers[i].insert(buffers[i].end(), begin, begin + this->slot_size[slot]);
+        }
+        MPI_Isend(buffers[i].data(),
+                  buffers[i].size(),
+                  MPI_DOUBLE,
+                  this->send_procs[i],
+                  0,
+                  this->comm,
+                  &requests[this->recv_procs.size() + i]);
+    }
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    ModuleBase::timer::tick("DMPurification", "fetch_ghosts");
+#endif
+}
+
+double DMPurification::sum_procs(const double v) const
+{
+    double sum = v;
+#ifdef __MPI
+    MPI_Allreduce(&v, &sum, 1, MPI_DOUBLE, MPI_SUM, this->comm);
+#endif
+    return sum;
+}
+
+double DMPurification::max_procs(const double v) const
+{
+    double max = v;
+#ifdef __MPI
+    MPI_Allreduce(&v, &max, 1, MPI_DOUBLE, MPI_MAX, this->comm);
+#endif
+    return max;
+}
+
+void DMPurification::multiply(const std::vector<double>& a, const std::vector<double>& b, std::vector<double>& c) const
+{
+    ModuleBase::timer::tick("DMPurification", "multiply");
+    std::vector<double> b_ghost;
+    this->fetch_ghosts(b, b_ghost);
+    c.assign(this->local_size, 0.0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0; i < this->nlocal; ++i)
+    {
+        const int nw1 = this->nw[this->row_begin + i];
+        for (int ik = this->row_start[i]; ik < this->row_start[i + 1]; ++ik)
+        {
+            const int iat3 = this->blk_col[ik];
+            const int nw3 = this->nw[iat3];
+            const int k = this->slot_of[iat3];
+            const double* pb = (k < this->nlocal) ? b.data() : b_ghost.data();
+            const int* r1 = &this->blk_R[3 * ik];
+            for (int kj = this->row_start[k]; kj < this->row_start[k + 1]; ++kj)
+            {
+                const int iat2 = this->blk_col[kj];
+                const int* r2 = &this->blk_R[3 * kj];
+                const int ij = this->find_in_slot(i, iat2, r1[0] + r2[0], r1[1] + r2[1], r1[2] + r2[2]);
+                if (ij < 0)
+                {
+                    continue;
+                }
+                const int nw2 = this->nw[iat2];
+                BlasConnector::gemm('N',
+                                    'N',
+                                    nw1,
+                                    nw2,
+                                    nw3,
+                                    1.0,
+                                    &a[this->blk_offset[ik]],
+                                    nw3,
+                                    pb + this->blk_offset[kj],
+                                    nw2,
+                                    1.0,
+                                    &c[this->blk_offset[ij]],
+                                    nw2);
+            }
+        }
+    }
+    ModuleBase::timer::tick("DMPurification", "multiply");
+}
+
+double DMPurification::trace(const std::vector<double>& a) const
+{
+    double tr = 0.0;
+    for (int i = 0; i < this->nlocal; ++i)
+    {
+        const int nw1 = this->nw[this->row_begin + i];
+        const double* block = &a[this->blk_offset[this->blk_diag[i]]];
+        for (int iw = 0; iw < nw1; ++iw)
+        {
+            tr += block[iw * nw1 + iw];
+        }
+    }
+    return this->sum_procs(tr);
+}
+
+double DMPurification::trace_product(const std::vector<double>& a, const std::vector<double>& b) const
+{
+    // Tr(AB) = sum_{IJR} sum_{mn} A_{IJ}(R)_{mn} B_{JI}(-R)_{nm}
+    std::vector<double> b_ghost;
+    this->fetch_ghosts(b, b_ghost);
+    double tr = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(+ : tr)
+#endif
+    for (int i = 0; i < this->nlocal; ++i)
+    {
+        const int iat1 = this->row_begin + i;
+        const int nw1 = this->nw[iat1];
+        for (int ij = this->row_start[i]; ij < this->row_start[i + 1]; ++ij)
+        {
+            const int iat2 = this->blk_col[ij];
+            const int nw2 = this->nw[iat2];
+            const int j = this->slot_of[iat2];
+            const int* r = &this->blk_R[3 * ij];
+            const int ji = this->find_in_slot(j, iat1, -r[0], -r[1], -r[2]);
+            const double* pa = &a[this->blk_offset[ij]];
+            const double* pb = ((j < this->nlocal) ? b.data() : b_ghost.data()) + this->blk_offset[ji];
+            for (int m = 0; m < nw1; ++m)
+            {
+                for (int n = 0; n < nw2; ++n)
+                {
+                    tr += pa[m * nw2 + n] * pb[n * nw1 + m];
+                }
+            }
+        }
+    }
+    return this->sum_procs(tr);
+}
+
+void DMPurification::add_identity(std::vector<double>& a, const double alpha) const
+{
+    for (int i = 0; i < this->nlocal; ++i)
+    {
+        const int nw1 = this->nw[this->row_begin + i];
+        double* block = &a[this->blk_offset[this->blk_diag[i]]];
+        for (int iw = 0; iw < nw1; ++iw)
+        {
+            block[iw * nw1 + iw] += alpha;
+        }
+    }
+}
+
+void DMPurification::gershgorin(const std::vector<double>& a, double& emin, double& emax) const
+{
+    emin = std::numeric_limits<double>::max();
+    emax = -std::numeric_limits<double>::max();
+    std::vector<double> radius;
+    for (int i = 0; i < this->nlocal; ++i)
+    {
+        const int nw1 = this->nw[this->row_begin + i];
+        radius.assign(nw1, 0.0);
+        for (int ij = this->row_start[i]; ij < this->row_start[i + 1]; ++ij)
+        {
+            const int nw2 = this->nw[this->blk_col[ij]];
+            const double* block = &a[this->blk_offset[ij]];
+            for (int m = 0; m < nw1; ++m)
+            {
+                for (int n = 0; n < nw2; ++n)
+                {
+                    radius[m] += std::abs(block[m * nw2 + n]);
+                }
+            }
+        }
+        const double* diag = &a[this->blk_offset[this->blk_diag[i]]];
+        for (int m = 0; m < nw1; ++m)
+        {
+            const double center = diag[m * nw1 + m];
+            const double r = radius[m] - std::abs(center);
+            emin = std::min(emin, center - r);
+            emax = std::max(emax, center + r);
+        }
+    }
+    emin = -this->max_procs(-emin);
+    emax = this->max_procs(emax);
+}
+
+void DMPurification::invert_s(const double thr)
+{
+    ModuleBase::TITLE("DMPurification", "invert_s");
+    ModuleBase::timer::tick("DMPurification", "invert_s");
+
+    // X_0 = 1 / max(eig(S)), so that the eigenvalues of 1 - S X_0 are in [0, 1)
+    double emin = 0.0, emax = 0.0;
+    this->gershgorin(this->s, emin, emax);
+    this->sinv.assign(this->local_size, 0.0);
+    this->add_identity(this->sinv, 1.0 / emax);
+
+    std::vector<double> sx, tmp;
+    this->sinv_error = std::numeric_limits<double>::max();
+    for (this->sinv_iter = 0; this->sinv_iter < max_iter; ++this->sinv_iter)
+    {
+        this->multiply(this->s, this->sinv, sx);
+        this->add_identity(sx, -1.0);
+        double error = 0.0;
+        for (const double& v: sx)
+        {
+            error = std::max(error, std::abs(v));
+        }
+        error = this->max_procs(error);
+        // the truncation limits the accuracy, stop if there is no more progress
+        const bool stop = error < thr || error >= this->sinv_error;
+        this->sinv_error = std::min(error, this->sinv_error);
+        if (stop)
+        {
+            break;
+        }
+        // X <- X (1 - (S X - 1))
+        for (double& v: sx)
+        {
+            v = -v;
+        }
+        this->add_identity(sx, 1.0);
+        this->multiply(this->sinv, sx, tmp);
+        this->sinv.swap(tmp);
+    }
+    this->s_inverted = this->s;
+    ModuleBase::timer::tick("DMPurification", "invert_s");
+}
+
+int DMPurification::solve(const double nocc, const double thr, std::vector<double>& dm)
+{
+    ModuleBase::TITLE("DMPurification", "solve");
+    ModuleBase::timer::tick("DMPurification", "solve");
+
+    // all processes invert S if it changed on any of them
+    const bool s_changed = this->sinv.empty() || this->s != this->s_inverted;
+    if (this->max_procs(s_changed ? 1.0 : 0.0) > 0.0)
+    {
+        this->invert_s(thr);
+    }
+
+    // X = S^{-1} H has the generalized eigenvalues of (H, S)
+    std::vector<double> x;
+    this->multiply(this->sinv, this->h, x);
+    double emin = 0.0, emax = 0.0;
+    this->gershgorin(x, emin, emax);
+    const double mu = this->trace(x) / this->nbasis;
+    const double lambda = std::min(nocc / (emax - mu), (this->nbasis - nocc) / (mu - emin));
+
+    // D_0 = lambda/n (mu - X) + nocc/n, eigenvalues in [0, 1] with trace nocc
+    std::vector<double> d(x.size());
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+        d[i] = -lambda / this->nbasis * x[i];
+    }
+    this->add_identity(d, (lambda * mu + nocc) / this->nbasis);
+
+    std::vector<double> d2, d3;
+    double idem_last = std::numeric_limits<double>::max();
+    int iter = 0;
+    bool converged = false;
+    for (; iter < max_iter; ++iter)
+    {
+        this->multiply(d, d, d2);
+        this->multiply(d2, d, d3);
+        const double tr1 = this->trace(d);
+        const double tr2 = this->trace(d2);
+        const double tr3 = this->trace(d3);
+
+        // Tr(D - D^2) vanishes for an idempotent D
+        const double idem = std::abs(tr1 - tr2);
+        if (idem < thr)
+        {
+            converged = true;
+            break;
+        }
+        if (idem >= idem_last)
+        {
+            break;
+        }
+        idem_last = idem;
+
+        const double c = (tr2 - tr3) / (tr1 - tr2);
+        if (c >= 0.5)
+        {
+            for (size_t i = 0; i < d.size(); ++i)
+            {
+                d[i] = ((1.0 + c) * d2[i] - d3[i]) / c;
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < d.size(); ++i)
+            {
+                d[i] = ((1.0 - 2.0 * c) * d[i] + (1.0 + c) * d2[i] - d3[i]) / (1.0 - c);
+            }
+        }
+    }
+
+    // P = D S^{-1}, symmetrized against the truncation error
+    this->multiply(d, this->sinv, dm);
+    std::vector<double> dm_ghost;
+    this->fetch_ghosts(dm, dm_ghost);
+    std::vector<double> pt(dm.size());
+    for (int i = 0; i < this->nlocal; ++i)
+    {
+        const int iat1 = this->row_begin + i;
+        const int nw1 = this->nw[iat1];
+        for (int ij = this->row_start[i]; ij < this->row_start[i + 1]; ++ij)
+        {
+            const int iat2 = this->blk_col[ij];
+            const int nw2 = this->nw[iat2];
+            const int j = this->slot_of[iat2];
+            const int* r = &this->blk_R[3 * ij];
+            const int ji = this->find_in_slot(j, iat1, -r[0], -r[1], -r[2]);
+            const double* pji = ((j < this->nlocal) ? dm.data() : dm_ghost.data()) + this->blk_offset[ji];
+            double* pij = &pt[this->blk_offset[ij]];
+            for (int m = 0; m < nw1; ++m)
+            {
+                for (int n = 0; n < nw2; ++n)
+                {
+                    pij[m * nw2 + n] = pji[n * nw1 + m];
+                }
+            }
+        }
+    }
+    for (size_t i = 0; i < dm.size(); ++i)
+    {
+        dm[i] = 0.5 * (dm[i] + pt[i]);
+    }
+
+    ModuleBase::timer::tick("DMPurification", "solve");
+    return converged ? iter : -iter;
+}
+
+} // namespace hsolver
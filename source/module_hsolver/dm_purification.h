@@ -0,0 +1,151 @@
+#ifndef DM_PURIFICATION_H
+#define DM_PURIFICATION_H
+
+#include <cstddef>
+#include <vector>
+
+#ifdef __MPI
+#include <mpi.h>
+#endif
+
+namespace hsolver
+{
+
+/**
+ * @brief linear-scaling density matrix solver for insulators by canonical purification
+ *
+ * All matrices are real and share one fixed sparsity pattern of atom-pair blocks <I,J,R>,
+ * the same layout as HContainer: block <I,J,R> is the nw(I) x nw(J) row-major matrix
+ * <phi_{I,R}|O|phi_{J,0}>. Blocks outside the pattern are dropped in every product, so the
+ * range of the pattern (the truncation radius) controls both the cost and the error.
+ * With all R = 0 the matrices are gamma-point matrices of the cell.
+ *
+ * For a given H, S and number of occupied orbitals nocc per cell,
+ * 1. S^{-1} is approximated by Newton-Schulz iterations X <- X (2 - S X),
+ * 2. D = P S is purified from a linear function of S^{-1} H with the canonical scheme of
+ *    Palser and Manolopoulos, which keeps Tr(D) = nocc and needs no chemical potential,
+ * 3. P = D S^{-1} is returned, with P S P = P and Tr(P S) = nocc.
+ * The gap has to be open at nocc, metals are not supported.
+ *
+ * The rows of contiguous ranges of atoms are distributed over the processes of the communicator,
+ * each process keeps the blocks of its own rows only. The rows of B needed by the product A B
+ * on the local rows are received from their owners before each product, so that the
+ * communication is limited to the neighbors of the local atoms if the atoms are ordered in space.
+ */
+class DMPurification
+{
+  public:
+    /**
+     * @brief distribute the rows of atoms over the processes, balanced by the number of orbitals
+     * @param nw_in number of orbitals of each atom
+     */
+#ifdef __MPI
+    void init(const std::vector<int>& nw_in, MPI_Comm comm_in);
+#else
+    void init(const std::vector<int>& nw_in);
+#endif
+
+    /// the rows of atoms [row_begin, row_end) are kept by this process
+    int get_row_begin() const { return this->row_begin; }
+    int get_row_end() const { return this->row_end; }
+    /// the process keeping the rows of atom iat
+    int get_owner(const int iat) const;
+
+    /**
+     * @brief set up the sparsity pattern, called by all processes after init()
+     * @param pairs (I, J, Rx, Ry, Rz) of kept blocks with rows of any process, duplicates are allowed,
+     *        each block is sent to the process keeping its row,
+     *        the mirror <J,I,-R> and all diagonal blocks <I,I,0> are added automatically
+     */
+    void set_pattern(const std::vector<int>& pairs);
+
+    /// index of block <I,J,R> in the pattern, -1 if it is truncated or row I is kept by another process
+    int find_block(const int iat1, const int iat2, const int rx, const int ry, const int rz) const;
+    /// offset of the values of block ib in a matrix
+    size_t block_offset(const int ib) const { return this->blk_offset[ib]; }
+    /// number of values of a matrix on this process
+    size_t size() const { return this->local_size; }
+    /// number of blocks and values of a matrix on all processes
+    long get_nblocks() const { return this->nblocks_all; }
+    long get_nvalues() const { return this->nvalues_all; }
+
+    /// Hamiltonian and overlap of the local rows, filled by the caller after set_pattern()
+    std::vector<double> h;
+    std::vector<double> s;
+
+    /**
+     * @brief calculate the density matrix of the lowest nocc states, called by all processes
+     * S^{-1} is kept and only recalculated when s differs from the last call.
+     * @param nocc number of occupied orbitals per cell
+     * @param thr convergence threshold of |Tr(D - D^2)| and of max|S S^{-1} - 1|
+     * @param dm [out] density matrix P of the local rows (without spin degeneracy)
+     * @return number of purification steps, negative if not converged
+     */
+    int solve(const double nocc, const double thr, std::vector<double>& dm);
+
+    /// Tr(A B) over the home cell, summed over all processes
+    double trace_product(const std::vector<double>& a, const std::vector<double>& b) const;
+
+    /// max |S S^{-1} - 1| of the last inversion
+    double get_sinv_error() const { return this->sinv_error; }
+    int get_sinv_iter() const { return this->sinv_iter; }
+
+  private:
+    /// c = a * b, restricted to the pattern
+    void multiply(const std::vector<double>& a, const std::vector<double>& b, std::vector<double>& c) const;
+    /// Newton-Schulz iterations for S^{-1}
+    void invert_s(const double thr);
+    /// lower and upper Gershgorin bound of the eigenvalues of a
+    void gershgorin(const std::vector<double>& a, double& emin, double& emax) const;
+    double trace(const std::vector<double>& a) const;
+    /// a += alpha * 1
+    void add_identity(std::vector<double>& a, const double alpha) const;
+    /// index of block <J,R> in the row of slot, -1 if it is truncated
+    int find_in_slot(const int slot, const int iat2, const int rx, const int ry, const int rz) const;
+    /// receive the rows of a kept by other processes that are needed on this process
+    void fetch_ghosts(const std::vector<double>& a, std::vector<double>& ghost) const;
+    /// sum and maximum over all processes
+    double sum_procs(const double v) const;
+    double max_procs(const double v) const;
+
+    std::vector<int> nw;
+    int nbasis = 0;
+    // rows of atoms [row_split[ip], row_split[ip+1]) are kept by process ip
+    std::vector<int> row_split;
+    int row_begin = 0;
+    int row_end = 0;
+
+    // CSR of blocks over slots: the local rows are the slots [0, nlocal), the rows received from
+    // other processes follow. Blocks of slot i are [row_start[i], row_start[i+1]), sorted by (J, R).
+    int nlocal = 0;
+    std::vector<int> slot_of; ///< slot of the row of each atom, -1 if it is not needed on this process
+    std::vector<int> row_start;
+    std::vector<int> blk_col;
+    std::vector<int> blk_R;
+    std::vector<size_t> blk_offset; ///< offset in the local values, or in the received values for other rows
+    std::vector<size_t> slot_size;  ///< number of values of each slot
+    std::vector<int> blk_diag;      ///< diagonal block of each local row
+    size_t local_size = 0;
+    size_t ghost_size = 0;
+    long nblocks_all = 0;
+    long nvalues_all = 0;
+
+#ifdef __MPI
+    MPI_Comm comm = MPI_COMM_NULL;
+    // local slots sent to each process in send_procs
+    std::vector<int> send_procs;
+    std::vector<std::vector<int>> send_slots;
+    // received values of recv_procs[i] are [recv_begin[i], recv_begin[i+1]) of the received values
+    std::vector<int> recv_procs;
+    std::vector<size_t> recv_begin;
+#endif
+
+    std::vector<double> s_inverted; ///< the S which sinv belongs to
+    std::vector<double> sinv;
+    double sinv_error = 0.0;
+    int sinv_iter = 0;
+};
+
+} // namespace hsolver
+
+#endif
@@ -2,8 +2,18 @@
 
 #include "diago_blas.h"
 #include "module_base/timer.h"
+#include "module_cell/module_neighbor/sltk_atom_arrange.h"
+#include "module_cell/module_neighbor/sltk_grid_driver.h"
+#include "module_elecstate/elecstate_lcao.h"
+#include "module_hamilt_lcao/hamilt_lcaodft/hamilt_lcao.h"
+#include "module_hamilt_pw/hamilt_pwdft/global.h"
 #include "module_io/write_HS.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <type_traits>
+
 #ifdef __ELPA
 #include "diago_elpa.h"
 #endif
@@ -11,6 +21,281 @@
 namespace hsolver
 {
 
+namespace
+{
+// sort (I, J, Rx, Ry, Rz) tuples and remove duplicates
+void unique_pairs(std::vector<int>& pairs)
+{
+    std::vector<std::array<int, 5>> keys(pairs.size() / 5);
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        std::copy(&pairs[5 * i], &pairs[5 * i] + 5, keys[i].begin());
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    pairs.resize(5 * keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        std::copy(keys[i].begin(), keys[i].end(), &pairs[5 * i]);
+    }
+}
+
+// (I, J, Rx, Ry, Rz) of the atom pairs of a 2D-distributed HContainer on this process
+std::vector<int> local_pairs(const hamilt::HContainer<double>& hR)
+{
+    std::vector<int> pairs;
+    for (size_t iap = 0; iap < hR.size_atom_pairs(); ++iap)
+    {
+        const hamilt::AtomPair<double>& ap = hR.get_atom_pair(iap);
+        for (size_t ir = 0; ir < ap.get_R_size(); ++ir)
+        {
+            const int* r = ap.get_R_index(ir);
+            pairs.insert(pairs.end(), {ap.get_atom_i(), ap.get_atom_j(), r[0], r[1], r[2]});
+        }
+    }
+    return pairs;
+}
+
+// (I, J, Rx, Ry, Rz) of the atom pairs closer than rcut (Bohr), with I in [iat_begin, iat_end)
+std::vector<int> search_pairs(const UnitCell& ucell,
+                              const double rcut,
+                              const bool gamma_only,
+                              const int iat_begin,
+                              const int iat_end)
+{
+    Grid_Driver grid_neigh(GlobalV::test_deconstructor, GlobalV::test_grid_driver, GlobalV::test_grid);
+    atom_arrange::search(GlobalV::SEARCH_PBC, GlobalV::ofs_running, grid_neigh, ucell, rcut, GlobalV::test_atom_input);
+
+    std::vector<int> pairs;
+    for (int iat1 = iat_begin; iat1 < iat_end; ++iat1)
+    {
+        const int it1 = ucell.iat2it[iat1];
+        const int ia1 = ucell.iat2ia[iat1];
+        const ModuleBase::Vector3<double>& tau1 = ucell.atoms[it1].tau[ia1];
+        grid_neigh.Find_atom(ucell, tau1, it1, ia1);
+        for (int ad = 0; ad < grid_neigh.getAdjacentNum() + 1; ++ad)
+        {
+            const double distance = (grid_neigh.getAdjacentTau(ad) - tau1).norm() * ucell.lat0;
+            if (distance > rcut)
+            {
+                continue;
+            }
+            const int iat2 = ucell.itia2iat(grid_neigh.getType(ad), grid_neigh.getNatom(ad));
+            const ModuleBase::Vector3<int>& box = grid_neigh.getBox(ad);
+            // gamma_only matrices are folded into the home cell
+            if (gamma_only)
+            {
+                pairs.insert(pairs.end(), {iat1, iat2, 0, 0, 0});
+            }
+            else
+            {
+                pairs.insert(pairs.end(), {iat1, iat2, box.x, box.y, box.z});
+            }
+        }
+    }
+#ifdef __MPI
+    atom_arrange::delete_vector(GlobalV::ofs_running,
+                                GlobalV::SEARCH_PBC,
+                                grid_neigh,
+                                ucell,
+                                rcut,
+                                GlobalV::test_atom_input);
+#endif
+    unique_pairs(pairs);
+    return pairs;
+}
+
+int get_nproc()
+{
+    int nproc = 1;
+#ifdef __MPI
+    MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+#endif
+    return nproc;
+}
+
+// the blocks of hR go to the process keeping their rows in pur,
+// which finds the position of each value from the orbital indexes of the rows and columns of the block
+void setup_transfer(const hamilt::HContainer<double>& hR,
+                    const DMPurification& pur,
+                    const std::vector<int>& orb_index,
+                    Row_Transfer& trans)
+{
+    const int nproc = get_nproc();
+    // I, J, Rx, Ry, Rz, nrow, ncol, then the orbital indexes of the rows and of the columns
+    std::vector<std::vector<int>> headers(nproc);
+    trans.send_counts.assign(nproc, 0);
+    for (size_t iap = 0; iap < hR.size_atom_pairs(); ++iap)
+    {
+        const hamilt::AtomPair<double>& ap = hR.get_atom_pair(iap);
+        const int iat1 = ap.get_atom_i();
+        const int iat2 = ap.get_atom_j();
+        const std::vector<int> rows = ap.get_paraV()->get_indexes_row(iat1);
+        const std::vector<int> cols = ap.get_paraV()->get_indexes_col(iat2);
+        const int owner = pur.get_owner(iat1);
+        for (size_t ir = 0; ir < ap.get_R_size(); ++ir)
+        {
+            const int* r = ap.get_R_index(ir);
+            std::vector<int>& header = headers[owner];
+            header.insert(header.end(), {iat1, iat2, r[0], r[1], r[2], ap.get_row_size(), ap.get_col_size()});
+            header.insert(header.end(), rows.begin(), rows.end());
+            header.insert(header.end(), cols.begin(), cols.end());
+            trans.send_counts[owner] += ap.get_row_size() * ap.get_col_size();
+        }
+    }
+
+    std::vector<int> header_send_counts(nproc), header_send_displs(nproc, 0);
+    std::vector<int> header_recv_counts(nproc, 0), header_recv_displs(nproc, 0);
+    std::vector<int> send_buffer;
+    for (int ip = 0; ip < nproc; ++ip)
+    {
+        header_send_counts[ip] = headers[ip].size();
+        header_send_displs[ip] = send_buffer.size();
+        send_buffer.insert(send_buffer.end(), headers[ip].begin(), headers[ip].end());
+    }
+#ifdef __MPI
+    MPI_Alltoall(header_send_counts.data(), 1, MPI_INT, header_recv_counts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    for (int ip = 1; ip < nproc; ++ip)
+    {
+        header_recv_displs[ip] = header_recv_displs[ip - 1] + header_recv_counts[ip - 1];
+    }
+    std::vector<int> recv_buffer(header_recv_displs[nproc - 1] + header_recv_counts[nproc - 1]);
+    MPI_Alltoallv(send_buffer.data(),
+                  header_send_counts.data(),
+                  header_send_displs.data(),
+                  MPI_INT,
+                  recv_buffer.data(),
+                  header_recv_counts.data(),
+                  header_recv_displs.data(),
+                  MPI_INT,
+                  MPI_COMM_WORLD);
+#else
+    header_recv_counts = header_send_counts;
+    const std::vector<int>& recv_buffer = send_buffer;
+#endif
+
+    trans.recv_counts.assign(nproc, 0);
+    trans.recv_offset.clear();
+    for (int ip = 0; ip < nproc; ++ip)
+    {
+        const int* header = recv_buffer.data() + header_recv_displs[ip];
+        const int* header_end = header + header_recv_counts[ip];
+        while (header < header_end)
+        {
+            const int nrow = header[5];
+            const int ncol = header[6];
+            const int* rows = header + 7;
+            const int* cols = rows + nrow;
+            const int ib = pur.find_block(header[0], header[1], header[2], header[3], header[4]);
+            if (ib < 0)
+            {
+                ModuleBase::WARNING_QUIT("HSolverLCAO::solvePurification", "block of H or DM missing in the pattern");
+            }
+            const int nw2 = orb_index[header[1] + 1] - orb_index[header[1]];
+            for (int m = 0; m < nrow; ++m)
+            {
+                for (int n = 0; n < ncol; ++n)
+                {
+                    trans.recv_offset.push_back(pur.block_offset(ib) + rows[m] * nw2 + cols[n]);
+                }
+            }
+            trans.recv_counts[ip] += nrow * ncol;
+            header = cols + ncol;
+        }
+    }
+    trans.send_displs.assign(nproc, 0);
+    trans.recv_displs.assign(nproc, 0);
+    for (int ip = 1; ip < nproc; ++ip)
+    {
+        trans.send_displs[ip] = trans.send_displs[ip - 1] + trans.send_counts[ip - 1];
+        trans.recv_displs[ip] = trans.recv_displs[ip - 1] + trans.recv_counts[ip - 1];
+    }
+}
+
+// values of the rows of pur from the blocks of hR, set up by setup_transfer()
+void to_rows(const hamilt::HContainer<double>& hR,
+             const DMPurification& pur,
+             const Row_Transfer& trans,
+             std::vector<double>& values)
+{
+    const int nproc = get_nproc();
+    std::vector<double> send_buffer(trans.send_displs[nproc - 1] + trans.send_counts[nproc - 1]);
+    std::vector<int> pos = trans.send_displs;
+    for (size_t iap = 0; iap < hR.size_atom_pairs(); ++iap)
+    {
+        const hamilt::AtomPair<double>& ap = hR.get_atom_pair(iap);
+        const int owner = pur.get_owner(ap.get_atom_i());
+        const int size = ap.get_row_size() * ap.get_col_size();
+        for (size_t ir = 0; ir < ap.get_R_size(); ++ir)
+        {
+            const double* data = ap.get_pointer(ir);
+            std::copy(data, data + size, &send_buffer[pos[owner]]);
+            pos[owner] += size;
+        }
+    }
+#ifdef __MPI
+    std::vector<double> recv_buffer(trans.recv_offset.size());
+    MPI_Alltoallv(send_buffer.data(),
+                  trans.send_counts.data(),
+                  trans.send_displs.data(),
+                  MPI_DOUBLE,
+                  recv_buffer.data(),
+                  trans.recv_counts.data(),
+                  trans.recv_displs.data(),
+                  MPI_DOUBLE,
+                  MPI_COMM_WORLD);
+#else
+    const std::vector<double>& recv_buffer = send_buffer;
+#endif
+    values.assign(pur.size(), 0.0);
+    for (size_t k = 0; k < trans.recv_offset.size(); ++k)
+    {
+        values[trans.recv_offset[k]] = recv_buffer[k];
+    }
+}
+
+// blocks of hR from factor times the values of the rows of pur, the reverse of to_rows()
+void from_rows(const std::vector<double>& values,
+               const double factor,
+               const DMPurification& pur,
+               const Row_Transfer& trans,
+               hamilt::HContainer<double>& hR)
+{
+    std::vector<double> send_buffer(trans.recv_offset.size());
+    for (size_t k = 0; k < trans.recv_offset.size(); ++k)
+    {
+        send_buffer[k] = factor * values[trans.recv_offset[k]];
+    }
+#ifdef __MPI
+    const int nproc = get_nproc();
+    std::vector<double> recv_buffer(trans.send_displs[nproc - 1] + trans.send_counts[nproc - 1]);
+    MPI_Alltoallv(send_buffer.data(),
+                  trans.recv_counts.data(),
+                  trans.recv_displs.data(),
+                  MPI_DOUBLE,
+                  recv_buffer.data(),
+                  trans.send_counts.data(),
+                  trans.send_displs.data(),
+                  MPI_DOUBLE,
+                  MPI_COMM_WORLD);
+#else
+    const std::vector<double>& recv_buffer = send_buffer;
+#endif
+    std::vector<int> pos = trans.send_displs;
+    for (size_t iap = 0; iap < hR.size_atom_pairs(); ++iap)
+    {
+        const hamilt::AtomPair<double>& ap = hR.get_atom_pair(iap);
+        const int owner = pur.get_owner(ap.get_atom_i());
+        const int size = ap.get_row_size() * ap.get_col_size();
+        for (size_t ir = 0; ir < ap.get_R_size(); ++ir)
+        {
+            std::copy(&recv_buffer[pos[owner]], &recv_buffer[pos[owner]] + size, ap.get_pointer(ir));
+            pos[owner] += size;
+        }
+    }
+}
+} // namespace
+
 template <typename T>
 void HSolverLCAO::solveTemplate(hamilt::Hamilt<std::complex<double>>* pHamilt,
                                 psi::Psi<T>& psi,
@@ -56,6 +341,16 @@ void HSolverLCAO::solveTemplate(hamilt::Hamilt<std::complex<double>>* pHamilt,
         }
     }
 #endif
+    else if (this->method == "purification")
+    {
+        if (skip_charge)
+        {
+            ModuleBase::WARNING_QUIT("HSolverLCAO::solve", "purification gives no wave functions for nscf calculation!");
+        }
+        this->solvePurification<T>(pHamilt, pes);
+        ModuleBase::timer::tick("HSolverLCAO", "solve");
+        return;
+    }
     else if (this->method == "lapack")
     {
         ModuleBase::WARNING_QUIT("hsolver_lcao", "please fix lapack solver!!!");
@@ -123,10 +418,112 @@ void HSolverLCAO::solveTemplate(hamilt::Hamilt<std::complex<double>>* pHamilt,
     ModuleBase::timer::tick("HSolverLCAO", "solve");
 }
 
+template <typename T>
+void HSolverLCAO::solvePurification(hamilt::Hamilt<std::complex<double>>* pHamilt, elecstate::ElecState* pes)
+{
+    ModuleBase::TITLE("HSolverLCAO", "solvePurification");
+    ModuleBase::timer::tick("HSolverLCAO", "solvePurification");
+
+    hamilt::HamiltLCAO<T, double>* p_hamilt = dynamic_cast<hamilt::HamiltLCAO<T, double>*>(pHamilt);
+    elecstate::DensityMatrix<T, double>* dm = dynamic_cast<elecstate::ElecStateLCAO<T>*>(pes)->get_DM();
+    const K_Vectors* kv = dm->get_kv_pointer();
+    const UnitCell& ucell = GlobalC::ucell;
+    const bool gamma_only = std::is_same<T, double>::value;
+
+    std::vector<int> orb_index(ucell.nat + 1, 0);
+    for (int iat = 0; iat < ucell.nat; ++iat)
+    {
+        orb_index[iat + 1] = orb_index[iat] + ucell.atoms[ucell.iat2it[iat]].nw;
+    }
+
+    // H(R) is rebuilt for each spin, the first k point of the spin is enough
+    p_hamilt->updateHk(0);
+    const hamilt::HContainer<double>* hR = p_hamilt->getHR();
+
+    // the pattern, the transfers and S only change with the atoms
+    if (this->ppur == nullptr)
+    {
+        this->ppur = new DMPurification;
+        std::vector<int> nw(ucell.nat);
+        for (int iat = 0; iat < ucell.nat; ++iat)
+        {
+            nw[iat] = orb_index[iat + 1] - orb_index[iat];
+        }
+#ifdef __MPI
+        this->ppur->init(nw, MPI_COMM_WORLD);
+#else
+        this->ppur->init(nw);
+#endif
+        // blocks of H, S and DM are always kept, other blocks of the density matrix are cut at purification_rcut
+        const hamilt::HContainer<double>* sR = p_hamilt->getSR();
+        const hamilt::HContainer<double>* dmR = dm->get_DMR_pointer(1);
+        std::vector<int> pairs = search_pairs(ucell,
+                                              purification_rcut,
+                                              gamma_only,
+                                              this->ppur->get_row_begin(),
+                                              this->ppur->get_row_end());
+        for (const hamilt::HContainer<double>* container: {hR, sR, dmR})
+        {
+            const std::vector<int> pairs_container = local_pairs(*container);
+            pairs.insert(pairs.end(), pairs_container.begin(), pairs_container.end());
+        }
+        unique_pairs(pairs);
+        this->ppur->set_pattern(pairs);
+        GlobalV::ofs_running << " purification pattern: " << this->ppur->get_nblocks() << " blocks, "
+                             << this->ppur->get_nvalues() << " elements per matrix" << std::endl;
+
+        Row_Transfer trans_s;
+        setup_transfer(*sR, *this->ppur, orb_index, trans_s);
+        to_rows(*sR, *this->ppur, trans_s, this->ppur->s);
+        setup_transfer(*hR, *this->ppur, orb_index, this->trans_h);
+        // the density matrices of all spins have the same blocks
+        setup_transfer(*dmR, *this->ppur, orb_index, this->trans_dm);
+    }
+
+    std::vector<double> dm_values;
+    for (int is = 0; is < GlobalV::NSPIN; ++is)
+    {
+        if (is > 0)
+        {
+            int ik = 0;
+            while (kv->isk[ik] != is)
+            {
+                ++ik;
+            }
+            p_hamilt->updateHk(ik);
+        }
+        to_rows(*hR, *this->ppur, this->trans_h, this->ppur->h);
+
+        // occupied orbitals of this spin, spin degeneracy is 2 for nspin = 1
+        const double occ = (GlobalV::NSPIN == 1) ? 2.0 : 1.0;
+        const double nocc = (GlobalV::NSPIN == 1) ? GlobalV::nelec / 2.0 : pes->nelec_spin[is];
+        if (std::abs(nocc - std::round(nocc)) > 1e-8 || nocc < 1.0 || nocc >= orb_index[ucell.nat])
+        {
+            ModuleBase::WARNING_QUIT("HSolverLCAO::solvePurification",
+                                     "purification needs an integer number of occupied orbitals in each spin");
+        }
+        const int niter = this->ppur->solve(std::round(nocc), purification_thr, dm_values);
+        GlobalV::ofs_running << " purification spin " << is + 1 << ": " << std::abs(niter)
+                             << " steps, S^-1 error " << this->ppur->get_sinv_error() << std::endl;
+        if (niter < 0)
+        {
+            ModuleBase::WARNING("HSolverLCAO::solvePurification",
+                                "purification stopped before purification_thr is reached, check the gap or purification_rcut");
+        }
+        pes->f_en.eband += occ * this->ppur->trace_product(dm_values, this->ppur->h);
+        from_rows(dm_values, occ, *this->ppur, this->trans_dm, *dm->get_DMR_pointer(is + 1));
+    }
+
+    dynamic_cast<elecstate::ElecStateLCAO<T>*>(pes)->dmToRho();
+    ModuleBase::timer::tick("HSolverLCAO", "solvePurification");
+}
+
 int HSolverLCAO::out_mat_hs = 0;
 int HSolverLCAO::out_mat_hsR = 0;
 int HSolverLCAO::out_mat_t = 0;
 int HSolverLCAO::out_mat_dh = 0;
+double HSolverLCAO::purification_rcut = 20.0;
+double HSolverLCAO::purification_thr = 1.0e-8;
 
 void HSolverLCAO::solve(hamilt::Hamilt<std::complex<double>>* pHamilt,
                         psi::Psi<std::complex<double>>& psi,
@@ -1,12 +1,25 @@
 #ifndef HSOLVERLCAO_H
 #define HSOLVERLCAO_H
 
+#include "dm_purification.h"
 #include "hsolver.h"
 #include "module_basis/module_ao/parallel_orbitals.h"
 
 namespace hsolver
 {
 
+/// exchange of the blocks of a 2D-distributed HContainer with the rows of DMPurification
+struct Row_Transfer
+{
+    // number and offset of the values sent to and received from each process
+    std::vector<int> send_counts;
+    std::vector<int> send_displs;
+    std::vector<int> recv_counts;
+    std::vector<int> recv_displs;
+    // offset of each received value in the values of DMPurification
+    std::vector<size_t> recv_offset;
+};
+
 class HSolverLCAO : public HSolver<std::complex<double>>
 {
   public:
@@ -26,22 +39,46 @@ class HSolverLCAO : public HSolver<std::complex<double>>
 
     void solve(hamilt::Hamilt<std::complex<double>>* pHamilt, psi::Psi<double>& psi, elecstate::ElecState* pes, const std::string method_in, const bool skip_charge) override;
 
+    ~HSolverLCAO()
+    {
+        delete this->ppur;
+    }
+
+    /// the pattern of ks_solver = purification is rebuilt at the next solve, called when the atoms move
+    void reset_purification()
+    {
+        delete this->ppur;
+        this->ppur = nullptr;
+    }
+
     static int out_mat_hs; // mohan add 2010-09-02
     static int out_mat_hsR; // LiuXh add 2019-07-16
     static int out_mat_t;
     static int out_mat_dh;
 
+    // ks_solver = purification: cutoff of density matrix blocks (Bohr) and convergence threshold
+    static double purification_rcut;
+    static double purification_thr;
+
   private:
     void hamiltSolvePsiK(hamilt::Hamilt<std::complex<double>>* hm, psi::Psi<std::complex<double>>& psi, double* eigenvalue);
     void hamiltSolvePsiK(hamilt::Hamilt<std::complex<double>>* hm, psi::Psi<double>& psi, double* eigenvalue);
 
     template <typename T> void solveTemplate(hamilt::Hamilt<std::complex<double>>* pHamilt, psi::Psi<T>& psi, elecstate::ElecState* pes, const std::string method_in, const bool skip_charge);
+
+    /// density matrix in real space from sparse H(R) and S(R) without diagonalization, for insulators
+    template <typename T> void solvePurification(hamilt::Hamilt<std::complex<double>>* pHamilt, elecstate::ElecState* pes);
     /*void solveTemplate(
         hamilt::Hamilt* pHamilt,
         psi::Psi<std::complex<double>>& psi,
         elecstate::ElecState* pes
     );*/
     const Parallel_Orbitals* ParaV;
+
+    DMPurification* ppur = nullptr;
+    // blocks of H(R) and DM(R) of this process to and from the rows of ppur
+    Row_Transfer trans_h;
+    Row_Transfer trans_dm;
 };
 
 } // namespace hsolver
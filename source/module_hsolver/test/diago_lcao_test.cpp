@@ -21,6 +21,7 @@
  * Tested function:
  *  - hsolver::DiagoElpa::diag (for ELPA)
  *  - hsolver::DiagoBlas::diag (for Scalapack)
+ *  - reuse of the decomposed S in the second call of diag
  *
  * The 2d block cyclic distribution of H/S matrix is done by 
  * self-realized functions in module_hsolver/test/diago_elpa_utils.h
@@ -86,6 +87,7 @@ template<class T> class DiagoPrepare
     psi::Psi<T> psi;
     std::vector<double> e_solver; 
     std::vector<double> e_lapack;
+    std::vector<double> e_reuse;
     std::vector<double> abc;
     int icontxt;
 
@@ -193,7 +195,25 @@ template<class T> class DiagoPrepare
         }
         endtime = MPI_Wtime();
         hsolver_time = (endtime - starttime)/REPEATRUN;
-        delete dh;
+    }
+
+    // diagonalize again with the same solver, the decomposed S of the first call is reused.
+    // As in SCF, s_local is not refreshed, ELPA of gamma_only decomposes it in place.
+    void diago_reuse_s()
+    {
+        e_reuse.resize(nlocal, 0.0);
+        hmtest.h_local = this->h_local;
+        dh->diag(&hmtest, psi, e_reuse.data());
+    }
+
+    bool compare_reuse_s()
+    {
+        for (int i = 0; i < nbands; i++)
+        {
+            if (std::abs(e_reuse[i] - e_solver[i]) > PASSTHRESHOLD)
+                return false;
+        }
+        return true;
     }
 
     void diago_lapack()
@@ -250,6 +270,9 @@ TEST_P(DiagoGammaOnlyTest, LCAO)
     DiagoPrepare<double> dp = GetParam();
     ASSERT_TRUE(dp.produce_HS());
     dp.diago();
+    dp.diago_reuse_s();
+    EXPECT_TRUE(dp.compare_reuse_s());
+    delete dp.dh;
 
     if (dp.myrank == 0)
     {
@@ -281,6 +304,9 @@ TEST_P(DiagoKPointsTest, LCAO)
     DiagoPrepare<std::complex<double>> dp = GetParam();
     ASSERT_TRUE(dp.produce_HS());
     dp.diago();
+    dp.diago_reuse_s();
+    EXPECT_TRUE(dp.compare_reuse_s());
+    delete dp.dh;
 
     if (dp.myrank == 0)
     {
@@ -0,0 +1,346 @@
+#include "module_hsolver/dm_purification.h"
+
+#include "gtest/gtest.h"
+#include "module_base/lapack_connector.h"
+
+#include <cmath>
+#include <complex>
+#include <vector>
+#ifdef __MPI
+#include <mpi.h>
+#endif
+
+/************************************************
+ *  unit test of DMPurification
+ ***********************************************/
+
+/**
+ * Tested function:
+ *  - hsolver::DMPurification::init
+ *  - hsolver::DMPurification::set_pattern
+ *  - hsolver::DMPurification::find_block
+ *      - only the blocks of the local rows are found
+ *  - hsolver::DMPurification::solve
+ *      - gamma-point matrices of a dimerized chain, compared with dsygv
+ *      - periodic blocks <I,J,R> of a chain, compared with the k-integrated density matrix
+ *      - the same chain with 4 atoms per cell, whose rows are spread over the processes
+ *      - S^{-1} is reused when S does not change
+ *  - hsolver::DMPurification::trace_product
+ *
+ * Both models have two orbitals per atom with on-site energies -2 and 2,
+ * so that the gap is open when one orbital per atom is occupied.
+ * Each process fills and checks the blocks of its own rows.
+ */
+
+class DMPurificationTest : public testing::Test
+{
+  protected:
+    hsolver::DMPurification pur;
+
+    void init(const std::vector<int>& nw, const std::vector<int>& pairs)
+    {
+#ifdef __MPI
+        pur.init(nw, MPI_COMM_WORLD);
+#else
+        pur.init(nw);
+#endif
+        pur.set_pattern(pairs);
+    }
+
+    bool is_local(const int iat) const
+    {
+        return iat >= pur.get_row_begin() && iat < pur.get_row_end();
+    }
+
+    // H and S of the block between orbitals of two atoms at distance d (in bond length)
+    static void model_block(const int d, const double t, double* h, double* s)
+    {
+        for (int m = 0; m < 2; ++m)
+        {
+            for (int n = 0; n < 2; ++n)
+            {
+                if (d == 0)
+                {
+                    h[m * 2 + n] = (m == n) ? (m == 0 ? -2.0 : 2.0) : 0.0;
+                    s[m * 2 + n] = (m == n) ? 1.0 : 0.0;
+                }
+                else
+                {
+                    h[m * 2 + n] = (m == n) ? t : 0.5 * t;
+                    s[m * 2 + n] = (m == n) ? 0.1 * t : 0.05 * t;
+                }
+            }
+        }
+    }
+};
+
+TEST_F(DMPurificationTest, Pattern)
+{
+    init({2, 3, 1}, {0, 1, 0, 0, 0, 1, 2, 1, 0, 0, 1, 2, 1, 0, 0});
+    // diagonal blocks and mirrors are added, duplicates removed
+    EXPECT_EQ(pur.get_nblocks(), 7);
+    EXPECT_EQ(pur.get_nvalues(), 4 + 6 + 6 + 9 + 3 + 3 + 1);
+    EXPECT_EQ(pur.find_block(1, 0, 0, 0, 0) >= 0, is_local(1));
+    EXPECT_EQ(pur.find_block(2, 1, -1, 0, 0) >= 0, is_local(2));
+    EXPECT_EQ(pur.find_block(2, 2, 0, 0, 0) >= 0, is_local(2));
+    EXPECT_EQ(pur.find_block(0, 2, 0, 0, 0), -1);
+    EXPECT_EQ(pur.find_block(1, 2, -1, 0, 0), -1);
+    if (is_local(1))
+    {
+        const int ib = pur.find_block(1, 0, 0, 0, 0);
+        EXPECT_EQ(pur.block_offset(ib + 1) - pur.block_offset(ib), 6u);
+    }
+    size_t nlocal_values = 0;
+    for (int iat = pur.get_row_begin(); iat < pur.get_row_end(); ++iat)
+    {
+        nlocal_values += std::vector<size_t>({4 + 6, 6 + 9 + 3, 3 + 1})[iat];
+    }
+    EXPECT_EQ(pur.size(), nlocal_values);
+}
+
+TEST_F(DMPurificationTest, GammaChain)
+{
+    // open chain of 8 atoms with alternating bonds, all pairs are kept
+    const int nat = 8;
+    const int n = 2 * nat;
+    std::vector<int> pairs;
+    for (int i = 0; i < nat; ++i)
+    {
+        for (int j = 0; j < nat; ++j)
+        {
+            pairs.insert(pairs.end(), {i, j, 0, 0, 0});
+        }
+    }
+    init(std::vector<int>(nat, 2), pairs);
+
+    std::vector<double> h_full(n * n, 0.0), s_full(n * n, 0.0);
+    double h[4], s[4];
+    for (int i = 0; i < nat; ++i)
+    {
+        for (int j = 0; j < nat; ++j)
+        {
+            const int d = std::abs(i - j);
+            if (d > 1)
+            {
+                continue;
+            }
+            const double t = (std::min(i, j) % 2 == 0) ? -0.8 : -0.3;
+            model_block(d, t, h, s);
+            const int ib = pur.find_block(i, j, 0, 0, 0);
+            for (int k = 0; k < 4; ++k)
+            {
+                if (ib >= 0)
+                {
+                    pur.h[pur.block_offset(ib) + k] = h[k];
+                    pur.s[pur.block_offset(ib) + k] = s[k];
+                }
+                h_full[(2 * i + k / 2) * n + 2 * j + k % 2] = h[k];
+                s_full[(2 * i + k / 2) * n + 2 * j + k % 2] = s[k];
+            }
+        }
+    }
+
+    std::vector<double> dm;
+    const double nocc = nat;
+    const int niter = pur.solve(nocc, 1e-12, dm);
+    EXPECT_GT(niter, 0);
+    EXPECT_LT(pur.get_sinv_error(), 1e-12);
+    EXPECT_NEAR(pur.trace_product(dm, pur.s), nocc, 1e-10);
+
+    // reference from the generalized eigenvalue problem
+    const int itype = 1;
+    int lwork = 3 * n * n;
+    const char jobz = 'V', uplo = 'U';
+    int info = 0;
+    std::vector<double> w(n), work(lwork);
+    dsygv_(&itype, &jobz, &uplo, &n, h_full.data(), &n, s_full.data(), &n, w.data(), work.data(), &lwork, &info);
+    ASSERT_EQ(info, 0);
+    ASSERT_LT(w[nat - 1], w[nat]);
+    for (int i = pur.get_row_begin(); i < pur.get_row_end(); ++i)
+    {
+        for (int j = 0; j < nat; ++j)
+        {
+            const int ib = pur.find_block(i, j, 0, 0, 0);
+            for (int k = 0; k < 4; ++k)
+            {
+                const int mu = 2 * i + k / 2;
+                const int nu = 2 * j + k % 2;
+                double ref = 0.0;
+                for (int ib_occ = 0; ib_occ < nat; ++ib_occ)
+                {
+                    ref += h_full[ib_occ * n + mu] * h_full[ib_occ * n + nu];
+                }
+                EXPECT_NEAR(dm[pur.block_offset(ib) + k], ref, 1e-8);
+            }
+        }
+    }
+
+    // band energy is the sum of occupied eigenvalues
+    double eband = 0.0;
+    for (int ib_occ = 0; ib_occ < nat; ++ib_occ)
+    {
+        eband += w[ib_occ];
+    }
+    EXPECT_NEAR(pur.trace_product(dm, pur.h), eband, 1e-8);
+
+    // S^{-1} is reused for a new H with the same S
+    const int sinv_iter = pur.get_sinv_iter();
+    for (double& v: pur.h)
+    {
+        v *= 2.0;
+    }
+    std::vector<double> dm2;
+    EXPECT_GT(pur.solve(nocc, 1e-12, dm2), 0);
+    EXPECT_EQ(pur.get_sinv_iter(), sinv_iter);
+    for (size_t i = 0; i < dm.size(); ++i)
+    {
+        EXPECT_NEAR(dm2[i], dm[i], 1e-8);
+    }
+}
+
+TEST_F(DMPurificationTest, PeriodicChain)
+{
+    // one atom per cell with nearest-neighbor blocks, the density matrix is truncated at |R| <= rmax
+    const int rmax = 12;
+    std::vector<int> pairs;
+    for (int r = -rmax; r <= rmax; ++r)
+    {
+        pairs.insert(pairs.end(), {0, 0, r, 0, 0});
+    }
+    init({2}, pairs);
+    double h[4], s[4];
+    for (int r = -1; r <= 1 && is_local(0); ++r)
+    {
+        model_block(std::abs(r), -0.6, h, s);
+        const int ib = pur.find_block(0, 0, r, 0, 0);
+        for (int k = 0; k < 4; ++k)
+        {
+            pur.h[pur.block_offset(ib) + k] = h[k];
+            pur.s[pur.block_offset(ib) + k] = s[k];
+        }
+    }
+
+    std::vector<double> dm;
+    EXPECT_GT(pur.solve(1.0, 1e-12, dm), 0);
+    EXPECT_NEAR(pur.trace_product(dm, pur.s), 1.0, 1e-10);
+
+    // reference: P(R) = 1/Nk sum_k exp(-ikR) P(k)
+    const int nk = 400;
+    const int n = 2, itype = 1;
+    int lwork = 8;
+    const char jobz = 'V', uplo = 'U';
+    std::vector<std::complex<double>> pr(3 * 4, 0.0);
+    for (int ik = 0; ik < nk; ++ik)
+    {
+        const double k = 2.0 * M_PI * ik / nk;
+        std::complex<double> hk[4] = {}, sk[4] = {}, work[8];
+        for (int r = -1; r <= 1; ++r)
+        {
+            model_block(std::abs(r), -0.6, h, s);
+            const std::complex<double> phase = std::exp(std::complex<double>(0.0, k * r));
+            for (int k2 = 0; k2 < 4; ++k2)
+            {
+                hk[k2] += h[k2] * phase;
+                sk[k2] += s[k2] * phase;
+            }
+        }
+        double w[2], rwork[6];
+        int info = 0;
+        zhegv_(&itype, &jobz, &uplo, &n, hk, &n, sk, &n, w, work, &lwork, rwork, &info);
+        ASSERT_EQ(info, 0);
+        for (int r = -1; r <= 1; ++r)
+        {
+            const std::complex<double> phase = std::exp(std::complex<double>(0.0, -k * r)) / double(nk);
+            for (int m = 0; m < 2; ++m)
+            {
+                for (int n2 = 0; n2 < 2; ++n2)
+                {
+                    // column-major eigenvector of the lowest band
+                    pr[(r + 1) * 4 + m * 2 + n2] += phase * hk[m] * std::conj(hk[n2]);
+                }
+            }
+        }
+    }
+    for (int r = -1; r <= 1; ++r)
+    {
+        for (int k = 0; k < 4; ++k)
+        {
+            EXPECT_NEAR(pr[(r + 1) * 4 + k].imag(), 0.0, 1e-10);
+        }
+        const int ib = pur.find_block(0, 0, r, 0, 0);
+        for (int k = 0; k < 4 && ib >= 0; ++k)
+        {
+            EXPECT_NEAR(dm[pur.block_offset(ib) + k], pr[(r + 1) * 4 + k].real(), 1e-7);
+        }
+    }
+
+    // the same chain with 4 atoms per cell and the same truncation,
+    // atom I of cell R is at 4R+I and the blocks only depend on the distance
+    const int nat = 4;
+    pairs.clear();
+    for (int i = 0; i < nat; ++i)
+    {
+        for (int j = 0; j < nat; ++j)
+        {
+            for (int r = -4; r <= 4; ++r)
+            {
+                if (std::abs(j - i - nat * r) <= rmax)
+                {
+                    pairs.insert(pairs.end(), {i, j, r, 0, 0});
+                }
+            }
+        }
+    }
+    init(std::vector<int>(nat, 2), pairs);
+    for (int i = pur.get_row_begin(); i < pur.get_row_end(); ++i)
+    {
+        for (int j = 0; j < nat; ++j)
+        {
+            for (int r = -1; r <= 1; ++r)
+            {
+                const int d = std::abs(j - i - nat * r);
+                const int ib = pur.find_block(i, j, r, 0, 0);
+                if (d > 1 || ib < 0)
+                {
+                    continue;
+                }
+                model_block(d, -0.6, h, s);
+                for (int k = 0; k < 4; ++k)
+                {
+                    pur.h[pur.block_offset(ib) + k] = h[k];
+                    pur.s[pur.block_offset(ib) + k] = s[k];
+                }
+            }
+        }
+    }
+    EXPECT_GT(pur.solve(nat, 1e-12, dm), 0);
+    EXPECT_NEAR(pur.trace_product(dm, pur.s), nat, 1e-10);
+    for (int i = pur.get_row_begin(); i < pur.get_row_end(); ++i)
+    {
+        for (int j = 0; j < nat; ++j)
+        {
+            for (int r = -1; r <= 1; ++r)
+            {
+                const int d = std::abs(j - i - nat * r);
+                const int ib = pur.find_block(i, j, r, 0, 0);
+                for (int k = 0; k < 4 && d <= 1; ++k)
+                {
+                    EXPECT_NEAR(dm[pur.block_offset(ib) + k], pr[(d + 1) * 4 + k].real(), 1e-7);
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+#endif
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+    return result;
+}
@@ -42,7 +42,8 @@ void write_cube(
     const double& ef,
     const UnitCell* ucell,
     const int& precision = 11,
-    const int& out_fermi = 1); // mohan add 2007-10-17
+    const int& out_fermi = 1, // mohan add 2007-10-17
+    const bool async = false); // the gathered data is written by ModuleIO::output_queue() in the background
 
     /**
      * @brief The trilinear interpolation method
@@ -85,6 +86,21 @@ void write_cube(
                                double** data
 #else
                                double* data
+#endif
+    );
+
+    /// @brief the trilinear interpolation of the grid data read_rho[iz][ix * ny_read + iy] already in memory
+    void trilinear_interpolate(const double* const* read_rho,
+                               const int& nx_read,
+                               const int& ny_read,
+                               const int& nz_read,
+                               const int& nx,
+                               const int& ny,
+                               const int& nz,
+#ifdef __MPI
+                               double** data
+#else
+                               double* data
 #endif
     );
 }
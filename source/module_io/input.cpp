@@ -141,6 +141,7 @@ void Input::Default(void)
     kpoint_file = ""; // xiaohui modify 2015-02-01
     pseudo_dir = "";
     orbital_dir = ""; // liuyu add 2021-08-14
+    cache_dir = "";
     read_file_dir = "auto";
     // pseudo_type = "auto"; // mohan add 2013-05-20 (xiaohui add 2013-06-23)
     wannier_card = "none";
@@ -151,6 +152,7 @@ void Input::Default(void)
     esolver_type = "ksdft";
     pseudo_rcut = 15.0; // qianrui add this parameter 2021-5
     pseudo_mesh = false; // qianrui add this pararmeter
+    pseudo_sbt_fft = false;
     ntype = 0;
     nbands = 0;
     nbands_sto = 256;
@@ -186,6 +188,8 @@ void Input::Default(void)
     out_wannier_unk = true;
     for(int i=0;i<3;i++){kspacing[i] = 0;}
     min_dist_coef = 0.2;
+    ewald_spme = false;
+    ewald_spme_tol = 1e-8;
     //----------------------------------------------------------
     // electrons / spin
     //----------------------------------------------------------
@@ -201,6 +205,8 @@ void Input::Default(void)
     ks_solver = "default"; // xiaohui add 2013-09-01
     search_radius = -1.0; // unit: a.u. -1.0 has no meaning.
     search_pbc = true;
+    purification_rcut = 20.0;
+    purification_thr = 1.0e-8;
     symmetry = "default";
     init_vel = false;
     ref_cell_factor = 1.0;
@@ -227,6 +233,9 @@ void Input::Default(void)
     relax_bfgs_rmax = 0.8; // bohr
     relax_bfgs_rmin = 1e-5;
     relax_bfgs_init = 0.5; // bohr
+    relax_bfgs_prec = "none";
+    relax_bfgs_hess_in = "none";
+    out_bfgs_hess = false;
     relax_scale_force = 0.5;
     nbspline = -1;
 
@@ -305,6 +314,7 @@ void Input::Default(void)
     out_freq_elec = 0;
     out_freq_ion = 0;
     out_chg = 0;
+    out_chg_format = "cube";
     out_dm = 0;
     out_dm1 = 0;
 
@@ -408,6 +418,7 @@ void Input::Default(void)
     exx_v_grad_threshold = 1E-1;
     exx_cauchy_force_threshold = 1E-7;
     exx_cauchy_stress_threshold = 1E-7;
+    exx_incremental = false;
     exx_ccp_threshold = 1E-8;
     exx_ccp_rmesh_times = "default";
 
@@ -516,6 +527,7 @@ void Input::Default(void)
     //----------------------------------------------------------
     restart_save = false;
     restart_load = false;
+    restart_freq = 0;
 
     //==========================================================
     // test only
@@ -670,6 +682,10 @@ bool Input::Read(const std::string &fn)
         {
             read_value(ifs, orbital_dir);
         }
+        else if (strcmp("cache_dir", word) == 0)
+        {
+            read_value(ifs, cache_dir);
+        }
         else if (strcmp("kpoint_file", word) == 0) // xiaohui modify 2015-02-01
         {
             read_value(ifs, kpoint_file); // xiaohui modify 2015-02-01
@@ -690,6 +706,10 @@ bool Input::Read(const std::string &fn)
         {
             read_bool(ifs, pseudo_mesh);
         }
+        else if (strcmp("pseudo_sbt_fft", word) == 0)
+        {
+            read_bool(ifs, pseudo_sbt_fft);
+        }
         else if (strcmp("calculation", word) == 0) // which type calculation
         {
             read_value(ifs, calculation);
@@ -723,6 +743,14 @@ bool Input::Read(const std::string &fn)
         {
             read_value(ifs, min_dist_coef);
         }
+        else if (strcmp("ewald_spme", word) == 0)
+        {
+            read_bool(ifs, ewald_spme);
+        }
+        else if (strcmp("ewald_spme_tol", word) == 0)
+        {
+            read_value(ifs, ewald_spme_tol);
+        }
         else if (strcmp("nbands_istate", word) == 0) // number of atom bands
         {
             read_value(ifs, nbands_istate);
@@ -884,6 +912,14 @@ bool Input::Read(const std::string &fn)
         {
             read_bool(ifs, search_pbc);
         }
+        else if (strcmp("purification_rcut", word) == 0)
+        {
+            read_value(ifs, purification_rcut);
+        }
+        else if (strcmp("purification_thr", word) == 0)
+        {
+            read_value(ifs, purification_thr);
+        }
         else if (strcmp("symmetry", word) == 0)
         {
             read_value(ifs, symmetry);
@@ -986,6 +1022,18 @@ bool Input::Read(const std::string &fn)
         {
             read_value(ifs, relax_bfgs_init);
         }
+        else if (strcmp("relax_bfgs_prec", word) == 0)
+        {
+            read_value(ifs, relax_bfgs_prec);
+        }
+        else if (strcmp("relax_bfgs_hess_in", word) == 0)
+        {
+            read_value(ifs, relax_bfgs_hess_in);
+        }
+        else if (strcmp("out_bfgs_hess", word) == 0)
+        {
+            read_bool(ifs, out_bfgs_hess);
+        }
         else if (strcmp("relax_scale_force", word) == 0)
         {
             read_value(ifs, relax_scale_force);
@@ -1234,6 +1282,10 @@ bool Input::Read(const std::string &fn)
         {
             read_bool(ifs, out_chg);
         }
+        else if (strcmp("out_chg_format", word) == 0)
+        {
+            read_value(ifs, out_chg_format);
+        }
         else if (strcmp("out_dm", word) == 0)
         {
             read_bool(ifs, out_dm);
@@ -1512,6 +1564,18 @@ bool Input::Read(const std::string &fn)
         {
             read_value(ifs, mdp.md_damp);
         }
+        else if (strcmp("md_respa_nstep", word) == 0)
+        {
+            read_value(ifs, mdp.md_respa_nstep);
+        }
+        else if (strcmp("md_respa_esolver", word) == 0)
+        {
+            read_value(ifs, mdp.md_respa_esolver);
+        }
+        else if (strcmp("md_relabel_file", word) == 0)
+        {
+            read_value(ifs, mdp.md_relabel_file);
+        }
         else if (strcmp("pot_file", word) == 0)
         {
             read_value(ifs, mdp.pot_file);
@@ -1836,6 +1900,10 @@ bool Input::Read(const std::string &fn)
         {
             read_bool(ifs, restart_load);
         }
+        else if (strcmp("restart_freq", word) == 0)
+        {
+            read_value(ifs, restart_freq);
+        }
         else if (strcmp("ocp", word) == 0)
         {
             read_bool(ifs, ocp);
@@ -1921,6 +1989,10 @@ bool Input::Read(const std::string &fn)
         {
             read_value(ifs, exx_cauchy_stress_threshold);
         }
+        else if (strcmp("exx_incremental", word) == 0)
+        {
+            read_bool(ifs, exx_incremental);
+        }
         else if (strcmp("exx_ccp_threshold", word) == 0)
         {
             read_value(ifs, exx_ccp_threshold);
@@ -2867,6 +2939,7 @@ void Input::Bcast()
     Parallel_Common::bcast_string(pseudo_dir);
     // Parallel_Common::bcast_string(pseudo_type); // mohan add 2013-05-20 (xiaohui add 2013-06-23)
     Parallel_Common::bcast_string(orbital_dir);
+    Parallel_Common::bcast_string(cache_dir);
     Parallel_Common::bcast_string(kpoint_file); // xiaohui modify 2015-02-01
     Parallel_Common::bcast_string(wannier_card);
     Parallel_Common::bcast_string(latname);
@@ -2874,6 +2947,7 @@ void Input::Bcast()
     Parallel_Common::bcast_string(esolver_type);
     Parallel_Common::bcast_double(pseudo_rcut);
     Parallel_Common::bcast_bool(pseudo_mesh);
+    Parallel_Common::bcast_bool(pseudo_sbt_fft);
     Parallel_Common::bcast_int(ntype);
     Parallel_Common::bcast_int(nbands);
     Parallel_Common::bcast_int(nbands_sto);
@@ -2881,6 +2955,8 @@ void Input::Bcast()
     for(int i=0;i<3;i++)
     {Parallel_Common::bcast_double(kspacing[i]);}
     Parallel_Common::bcast_double(min_dist_coef);
+    Parallel_Common::bcast_bool(ewald_spme);
+    Parallel_Common::bcast_double(ewald_spme_tol);
     Parallel_Common::bcast_int(nche_sto);
     Parallel_Common::bcast_int(seed_sto);
     Parallel_Common::bcast_int(pw_seed);
@@ -2920,6 +2996,8 @@ void Input::Bcast()
     Parallel_Common::bcast_string(ks_solver); // xiaohui add 2013-09-01
     Parallel_Common::bcast_double(search_radius);
     Parallel_Common::bcast_bool(search_pbc);
+    Parallel_Common::bcast_double(purification_rcut);
+    Parallel_Common::bcast_double(purification_thr);
     Parallel_Common::bcast_double(search_radius);
     Parallel_Common::bcast_string(symmetry);
     Parallel_Common::bcast_bool(init_vel); // liuyu 2021-07-14
@@ -2946,6 +3024,9 @@ void Input::Bcast()
     Parallel_Common::bcast_double(relax_bfgs_rmax);
     Parallel_Common::bcast_double(relax_bfgs_rmin);
     Parallel_Common::bcast_double(relax_bfgs_init);
+    Parallel_Common::bcast_string(relax_bfgs_prec);
+    Parallel_Common::bcast_string(relax_bfgs_hess_in);
+    Parallel_Common::bcast_bool(out_bfgs_hess);
     Parallel_Common::bcast_double(relax_scale_force);
     Parallel_Common::bcast_bool(relax_new);
 
@@ -3014,6 +3095,7 @@ void Input::Bcast()
     Parallel_Common::bcast_int(out_freq_elec);
     Parallel_Common::bcast_int(out_freq_ion);
     Parallel_Common::bcast_bool(out_chg);
+    Parallel_Common::bcast_string(out_chg_format);
     Parallel_Common::bcast_bool(out_dm);
     Parallel_Common::bcast_bool(out_dm1);
     Parallel_Common::bcast_bool(out_bandgap); // for bandgap printing
@@ -3080,6 +3162,9 @@ void Input::Bcast()
     Parallel_Common::bcast_double(mdp.md_damp);
     Parallel_Common::bcast_string(mdp.pot_file);
     Parallel_Common::bcast_int(mdp.md_nraise);
+    Parallel_Common::bcast_int(mdp.md_respa_nstep);
+    Parallel_Common::bcast_string(mdp.md_respa_esolver);
+    Parallel_Common::bcast_string(mdp.md_relabel_file);
     Parallel_Common::bcast_bool(cal_syns);
     Parallel_Common::bcast_double(dmax);
     Parallel_Common::bcast_double(mdp.md_tolerance);
@@ -3207,6 +3292,7 @@ void Input::Bcast()
     Parallel_Common::bcast_double(exx_v_grad_threshold);
     Parallel_Common::bcast_double(exx_cauchy_force_threshold);
     Parallel_Common::bcast_double(exx_cauchy_stress_threshold);
+    Parallel_Common::bcast_bool(exx_incremental);
     Parallel_Common::bcast_double(exx_ccp_threshold);
     Parallel_Common::bcast_string(exx_ccp_rmesh_times);
     Parallel_Common::bcast_string(exx_distribute_type);
@@ -3222,6 +3308,7 @@ void Input::Bcast()
     Parallel_Common::bcast_double(cell_factor); // LiuXh add 20180619
     Parallel_Common::bcast_bool(restart_save); // Peize Lin add 2020.04.04
     Parallel_Common::bcast_bool(restart_load); // Peize Lin add 2020.04.04
+    Parallel_Common::bcast_int(restart_freq);
 
     //-----------------------------------------------------------------------------------
     // DFT+U (added by Quxin 2020-10-29)
@@ -3351,6 +3438,11 @@ void Input::Check(void)
         ModuleBase::WARNING_QUIT("Input", "kspacing must > 0");
     }
 
+    if (ewald_spme && (ewald_spme_tol <= 0.0 || ewald_spme_tol >= 1.0))
+    {
+        ModuleBase::WARNING_QUIT("Input", "ewald_spme_tol should be between 0 and 1");
+    }
+
     if (nelec < 0.0)
     {
         ModuleBase::WARNING_QUIT("Input", "nelec < 0 is not allowed !");
@@ -3417,6 +3509,36 @@ void Input::Check(void)
                 ModuleBase::WARNING_QUIT("Input::Check", "Can not find DP model !");
             }
         }
+        if (mdp.md_respa_nstep < 1)
+        {
+            ModuleBase::WARNING_QUIT("Input::Check", "md_respa_nstep should be a positive integer!");
+        }
+        if (mdp.md_respa_nstep > 1)
+        {
+            if (mdp.md_type != "nve" && mdp.md_type != "nvt" && mdp.md_type != "langevin")
+            {
+                ModuleBase::WARNING_QUIT("Input::Check", "r-RESPA is only available for md_type = nve, nvt, langevin");
+            }
+            if (mdp.md_respa_esolver != "lj" && mdp.md_respa_esolver != "dp")
+            {
+                ModuleBase::WARNING_QUIT("Input::Check", "md_respa_esolver should be lj or dp");
+            }
+            if (mdp.md_respa_esolver == "dp" && access(mdp.pot_file.c_str(), 0) == -1)
+            {
+                ModuleBase::WARNING_QUIT("Input::Check", "Can not find DP model !");
+            }
+        }
+        if (mdp.md_relabel_file != "none")
+        {
+            if (esolver_type != "dp")
+            {
+                ModuleBase::WARNING_QUIT("Input::Check", "md_relabel_file is only available for esolver_type = dp");
+            }
+            if (access(mdp.md_relabel_file.c_str(), 0) == -1)
+            {
+                ModuleBase::WARNING_QUIT("Input::Check", "Can not find md_relabel_file !");
+            }
+        }
     }
     else if (calculation == "gen_bessel")
     {
@@ -3441,6 +3563,16 @@ void Input::Check(void)
     {
         ModuleBase::WARNING_QUIT("Input", "wrong 'init_chg',not 'atomic', 'file',please check");
     }
+    if (out_chg_format != "cube" && out_chg_format != "binary" && out_chg_format != "binary_zlib")
+    {
+        ModuleBase::WARNING_QUIT("Input", "out_chg_format should be 'cube', 'binary' or 'binary_zlib'");
+    }
+#ifndef __ZLIB
+    if (out_chg_format == "binary_zlib")
+    {
+        ModuleBase::WARNING_QUIT("Input", "out_chg_format = binary_zlib needs ABACUS compiled with zlib (ENABLE_ZLIB)");
+    }
+#endif
     if (gamma_only_local == 0)
     {
         if (out_dm == 1)
@@ -3569,6 +3701,28 @@ void Input::Check(void)
             ModuleBase::WARNING_QUIT("Input", "Cusolver can not be used for series version.");
 #endif
         }
+        else if (ks_solver == "purification")
+        {
+            if (nspin == 4)
+            {
+                ModuleBase::WARNING_QUIT("Input", "ks_solver = purification does not support nspin = 4.");
+            }
+            if (calculation != "scf" || cal_force || cal_stress)
+            {
+                ModuleBase::WARNING_QUIT("Input",
+                                         "ks_solver = purification only supports scf without force and stress.");
+            }
+            if (purification_rcut <= 0.0 || purification_thr <= 0.0)
+            {
+                ModuleBase::WARNING_QUIT("Input", "purification_rcut and purification_thr must > 0");
+            }
+            if (out_bandgap || out_band || out_dos)
+            {
+                ModuleBase::WARNING_QUIT("Input",
+                                         "ks_solver = purification gives no eigenvalues, out_bandgap, out_band and "
+                                         "out_dos are not available.");
+            }
+        }
         else if (ks_solver != "default")
         {
             ModuleBase::WARNING_QUIT("Input", "please check the ks_solver parameter!");
@@ -3616,6 +3770,10 @@ void Input::Check(void)
     {
         ModuleBase::WARNING_QUIT("Input", "relax_method can only be sd, cg, bfgs or cg_bfgs.");
     }
+    if (relax_bfgs_prec != "none" && relax_bfgs_prec != "exp")
+    {
+        ModuleBase::WARNING_QUIT("Input", "relax_bfgs_prec can only be none or exp.");
+    }
 
     if (bx > 10 || by > 10 || bz > 10)
     {
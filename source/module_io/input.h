@@ -31,6 +31,7 @@ class Input
     std::string stru_file; // file contains atomic positions -- xiaohui modify 2015-02-01
     std::string pseudo_dir; // directory of pseudopotential
     std::string orbital_dir; // directory of orbital file
+    std::string cache_dir; // directory of the binary cache of parsed pseudopotential and orbital files
     std::string read_file_dir; // directory of files for reading
     // std::string pseudo_type; // the type of pseudopotential, mohan add 2013-05-20, ABACUS supports
     //                          // UPF format (default) and vwr format. (xiaohui add 2013-06-23)
@@ -44,6 +45,7 @@ class Input
     std::string esolver_type;    // the energy solver: ksdft, sdft, ofdft, tddft, lj, dp
     double pseudo_rcut; // cut-off radius for calculating msh
     bool pseudo_mesh; // 0: use msh to normalize radial wave functions;  1: use mesh, which is used in QE.
+    bool pseudo_sbt_fft; // compute the radial Fourier transforms of pseudopotentials by FFT
     int ntype; // number of atom types
     int nbands; // number of bands
     int nbands_istate; // number of bands around fermi level for get_pchg calculation.
@@ -65,6 +67,8 @@ class Input
     int gdir; // berry phase calculation
     double kspacing[3];
     double min_dist_coef;
+    bool ewald_spme; // use the smooth particle-mesh Ewald method for the ion-ion interaction
+    double ewald_spme_tol; // accuracy target of the smooth particle-mesh Ewald method
     //==========================================================
     // Wannier functions
     //==========================================================
@@ -150,6 +154,9 @@ class Input
     double relax_bfgs_rmax; // trust radius max
     double relax_bfgs_rmin; // trust radius min
     double relax_bfgs_init; // initial move
+    std::string relax_bfgs_prec;    // model hessian to start bfgs from: none or exp
+    std::string relax_bfgs_hess_in; // file of the inverse hessian saved by a previous run
+    bool out_bfgs_hess;             // output the inverse hessian of bfgs
 
     double relax_scale_force;
 
@@ -245,6 +252,7 @@ class Input
     int out_freq_elec;  // the frequency ( >= 0) of electronic iter to output charge density and wavefunction. 0: output only when converged
     int out_freq_ion;  // the frequency ( >= 0 ) of ionic step to output charge density and wavefunction. 0: output only when ion steps are finished
     bool out_chg; // output charge density. 0: no; 1: yes
+    std::string out_chg_format; // format of the charge density files: cube, binary or binary_zlib
     bool out_dm; // output density matrix.
     bool out_dm1;
     int out_pot; // yes or no
@@ -288,6 +296,8 @@ class Input
     double lcao_rmax; // rmax(a.u.) to make table.
     double search_radius; // 11.1
     bool search_pbc; // 11.2
+    double purification_rcut; // cutoff (a.u.) of the density matrix in ks_solver = purification
+    double purification_thr; // convergence threshold of ks_solver = purification
 
     //==========================================================
     // molecular dynamics
@@ -372,6 +382,7 @@ class Input
     double exx_v_grad_threshold;
     double exx_cauchy_force_threshold;
     double exx_cauchy_stress_threshold;
+    bool exx_incremental; // update Hexx from the change of the density matrix
     double exx_ccp_threshold;
     std::string exx_ccp_rmesh_times;
 
@@ -458,6 +469,7 @@ class Input
     //==========================================================
     bool restart_save;
     bool restart_load;
+    int restart_freq; // write the binary SCF checkpoint every restart_freq electronic iterations
     // xiaohui add 2015-09-16
     bool input_error;
     double cell_factor; // LiuXh add 20180619
@@ -508,7 +520,7 @@ class Input
     // OFDFT  sunliang added on 2022-05-05
     //==========================================================
     std::string of_kinetic; // Kinetic energy functional, such as TF, VW, WT, TF+
-    std::string of_method;  // optimization method, include cg1, cg2, tn (default), bfgs
+    std::string of_method;  // optimization method, include cg1, cg2, tn (default), lbfgs, bfgs
     std::string of_conv;    // select the convergence criterion, potential, energy (default), or both
     double of_tole;    // tolerance of the energy change (in Ry) for determining the convergence, default=2e-6 Ry
     double of_tolp;    // tolerance of potential for determining the convergence, default=1e-5 in a.u.
@@ -226,6 +226,8 @@ void Input_Conv::Convert(void)
         GlobalV::global_pseudo_dir = INPUT.pseudo_dir + "/";
     if (INPUT.orbital_dir != "")
         GlobalV::global_orbital_dir = INPUT.orbital_dir + "/";
+    if (INPUT.cache_dir != "")
+        GlobalV::global_cache_dir = INPUT.cache_dir;
     // GlobalV::global_pseudo_type = INPUT.pseudo_type;
     GlobalC::ucell.setup(INPUT.latname, INPUT.ntype, INPUT.lmaxmax, INPUT.init_vel, INPUT.fixed_axes);
 
@@ -247,6 +249,13 @@ void Input_Conv::Convert(void)
         {
             INPUT.relax_new = false;
         }
+        if (INPUT.relax_new
+            && (INPUT.relax_bfgs_prec != "none" || INPUT.relax_bfgs_hess_in != "none" || INPUT.out_bfgs_hess))
+        {
+            ModuleBase::WARNING("Input_Conv",
+                                "relax_bfgs_prec, relax_bfgs_hess_in and out_bfgs_hess only act on BFGS, "
+                                "they are ignored by the CG of relax_new = 1");
+        }
         if (!INPUT.relax_new && (INPUT.fixed_axes == "shape" || INPUT.fixed_axes == "volume"))
         {
             ModuleBase::WARNING_QUIT("Input_Conv", "fixed shape and fixed volume only supported for relax_new = 1");
@@ -259,6 +268,8 @@ void Input_Conv::Convert(void)
         GlobalV::KSPACING[i] = INPUT.kspacing[i];
     }
     GlobalV::MIN_DIST_COEF = INPUT.min_dist_coef;
+    GlobalV::EWALD_SPME = INPUT.ewald_spme;
+    GlobalV::EWALD_SPME_TOL = INPUT.ewald_spme_tol;
     GlobalV::NBANDS = INPUT.nbands;
     GlobalV::NBANDS_ISTATE = INPUT.nbands_istate;
     GlobalV::device_flag = psi::device::get_device_flag(INPUT.device, INPUT.ks_solver, INPUT.basis_type);
@@ -278,6 +289,7 @@ void Input_Conv::Convert(void)
 
     GlobalV::PSEUDORCUT = INPUT.pseudo_rcut;
     GlobalV::PSEUDO_MESH = INPUT.pseudo_mesh;
+    GlobalV::PSEUDO_SBT_FFT = INPUT.pseudo_sbt_fft;
 
     GlobalV::DFT_FUNCTIONAL = INPUT.dft_functional;
     GlobalV::XC_TEMPERATURE = INPUT.xc_temperature;
@@ -298,6 +310,9 @@ void Input_Conv::Convert(void)
 
     BFGS_Basic::relax_bfgs_w1 = INPUT.relax_bfgs_w1;
     BFGS_Basic::relax_bfgs_w2 = INPUT.relax_bfgs_w2;
+    BFGS_Basic::relax_bfgs_prec = INPUT.relax_bfgs_prec;
+    BFGS_Basic::relax_bfgs_hess_in = INPUT.relax_bfgs_hess_in;
+    BFGS_Basic::out_bfgs_hess = INPUT.out_bfgs_hess;
 
     Ions_Move_Basic::relax_bfgs_rmax = INPUT.relax_bfgs_rmax;
     Ions_Move_Basic::relax_bfgs_rmin = INPUT.relax_bfgs_rmin;
@@ -482,6 +497,7 @@ void Input_Conv::Convert(void)
         std::transform(INPUT.dft_functional.begin(), INPUT.dft_functional.end(), dft_functional_lower.begin(), tolower);
         GlobalC::restart.folder = GlobalV::global_readin_dir + "restart/";
         ModuleBase::GlobalFunc::MAKE_DIR(GlobalC::restart.folder);
+        GlobalC::restart.info_save.checkpoint_freq = INPUT.restart_freq;
         if (dft_functional_lower == "hf" || dft_functional_lower == "pbe0" || dft_functional_lower == "hse"
             || dft_functional_lower == "opt_orb" || dft_functional_lower == "scan0")
         {
@@ -498,6 +514,7 @@ void Input_Conv::Convert(void)
         std::string dft_functional_lower = INPUT.dft_functional;
         std::transform(INPUT.dft_functional.begin(), INPUT.dft_functional.end(), dft_functional_lower.begin(), tolower);
         GlobalC::restart.folder = GlobalV::global_readin_dir + "restart/";
+        GlobalC::restart.info_load.load_checkpoint = (INPUT.restart_freq > 0);
         if (dft_functional_lower == "hf" || dft_functional_lower == "pbe0" || dft_functional_lower == "hse"
             || dft_functional_lower == "opt_orb" || dft_functional_lower == "scan0")
         {
@@ -569,6 +586,7 @@ void Input_Conv::Convert(void)
         GlobalC::exx_info.info_ri.V_grad_threshold = INPUT.exx_v_grad_threshold;
         GlobalC::exx_info.info_ri.cauchy_force_threshold = INPUT.exx_cauchy_force_threshold;
         GlobalC::exx_info.info_ri.cauchy_stress_threshold = INPUT.exx_cauchy_stress_threshold;
+        GlobalC::exx_info.info_ri.incremental = INPUT.exx_incremental;
         GlobalC::exx_info.info_ri.ccp_threshold = INPUT.exx_ccp_threshold;
         GlobalC::exx_info.info_ri.ccp_rmesh_times = std::stod(INPUT.exx_ccp_rmesh_times);
 
@@ -612,6 +630,7 @@ void Input_Conv::Convert(void)
     GlobalV::psi_initializer = INPUT.psi_initializer;
     GlobalV::chg_extrap = INPUT.chg_extrap; // xiaohui modify 2015-02-01
     GlobalV::out_chg = INPUT.out_chg;
+    GlobalV::out_chg_format = INPUT.out_chg_format;
     GlobalV::nelec = INPUT.nelec;
     GlobalV::out_pot = INPUT.out_pot;
     GlobalV::out_app_flag = INPUT.out_app_flag;
@@ -625,6 +644,8 @@ void Input_Conv::Convert(void)
     hsolver::HSolverLCAO::out_mat_hsR = INPUT.out_mat_hs2; // LiuXh add 2019-07-16
     hsolver::HSolverLCAO::out_mat_t = INPUT.out_mat_t;
     hsolver::HSolverLCAO::out_mat_dh = INPUT.out_mat_dh;
+    hsolver::HSolverLCAO::purification_rcut = INPUT.purification_rcut;
+    hsolver::HSolverLCAO::purification_thr = INPUT.purification_thr;
     if (GlobalV::GAMMA_ONLY_LOCAL)
     {
         elecstate::ElecStateLCAO<double>::out_wfc_lcao = INPUT.out_wfc_lcao;
@@ -18,6 +18,7 @@
 #include "module_base/name_angular.h"
 #include "module_base/scalapack_connector.h"
 #include "write_orb_info.h"
+#include "orb_weight_lcao.h"
 #include "module_elecstate/elecstate_lcao.h"
 
 
@@ -29,92 +30,20 @@ ModuleBase::matrix ModuleIO::cal_mulliken(const std::vector<std::vector<double>>
 
     const int nspin = (GlobalV::NSPIN == 2) ? 2 : 1;
     const int nlocal = (GlobalV::NSPIN == 4) ? GlobalV::NLOCAL/2 : GlobalV::NLOCAL;
-    // std::vector<std::vector<double>> MecMulP(GlobalV::NSPIN, std::vector<double>(nlocal, 0));
-    // std::vector<std::vector<double>> orbMulP(GlobalV::NSPIN, std::vector<double>(nlocal, 0));
     ModuleBase::matrix MecMulP, orbMulP;
     MecMulP.create(GlobalV::NSPIN, nlocal);
     orbMulP.create(GlobalV::NSPIN, nlocal);
 
+    // (D S)(i, i) is summed directly from the local blocks of D and S,
+    // NSPIN=4 is forbidden for gamma_only case
     for(size_t is=0; is!=nspin; ++is)
     {
-        ModuleBase::matrix mud;
-        mud.create(LM->ParaV->ncol, LM->ParaV->nrow);
-#ifdef __MPI
-        const char T_char = 'T';
-        const char N_char = 'N';
-        const int one_int = 1;
-        const double one_float = 1.0, zero_float = 0.0;        
-        pdgemm_(&T_char,
-                &T_char,
-                &GlobalV::NLOCAL,
-                &GlobalV::NLOCAL,
-                &GlobalV::NLOCAL,
-                &one_float,
-                dm[is].data(),
-                &one_int,
-                &one_int,
-                LM->ParaV->desc,
-                LM->Sloc.data(),
-                &one_int,
-                &one_int,
-                LM->ParaV->desc,
-                &zero_float,
-                mud.c,
-                &one_int,
-                &one_int,
-                LM->ParaV->desc);
-        if(GlobalV::NSPIN == 1 || GlobalV::NSPIN == 2)
-        {
-            for(size_t i=0; i!=GlobalV::NLOCAL; ++i)
-                if(LM->ParaV->in_this_processor(i, i))
-                {
-                    const int ir = LM->ParaV->global2local_row(i);
-                    const int ic = LM->ParaV->global2local_col(i);
-                    MecMulP(is, i) += mud(ic, ir);
-                }
-        }
-        //NSPIN=4 is forbidden for gamma_only case
-        /*else if(GlobalV::NSPIN == 4)
-        {
-            for(size_t i=0; i!=GlobalV::NLOCAL; ++i)
-            {
-                const int index = i%2;
-                if(!index)
-                {
-                    const int j = i/2;
-                    const int k1 = 2*j;
-                    const int k2 = 2*j+1;
-                    if(LM->ParaV->in_this_processor(k1, k1))
-                    {
-                        const int ir = LM->ParaV->global2local_row(k1);
-                        const int ic = LM->ParaV->global2local_col(k1);
-                        MecMulP(0, j) += mud(ir, ic);
-                    }
-                    if(LM->ParaV->in_this_processor(k1, k2))
-                    {
-                        const int ir = LM->ParaV->global2local_row(k1);
-                        const int ic = LM->ParaV->global2local_col(k2);
-                        MecMulP(1, j) += mud(ir, ic);
-                    }
-                    if(LM->ParaV->in_this_processor(k2, k1))
-                    {
-                        const int ir = LM->ParaV->global2local_row(k2);
-                        const int ic = LM->ParaV->global2local_col(k1);
-                        MecMulP(2, j) += mud(ir, ic);
-                    }
-                    if(LM->ParaV->in_this_processor(k2, k2))
-                    {
-                        const int ir = LM->ParaV->global2local_row(k2);
-                        const int ic = LM->ParaV->global2local_col(k2);
-                        MecMulP(3, j) += mud(ir, ic);
-                    }
-                }
-            }
-        }*/
-#endif
+        ModuleIO::cal_orb_mulliken(LM->ParaV, dm[is].data(), LM->Sloc.data(), MecMulP.c + is * nlocal);
     }
 #ifdef __MPI 
     MPI_Reduce(MecMulP.c, orbMulP.c, GlobalV::NSPIN*nlocal, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+#else
+    orbMulP = MecMulP;
 #endif 
 
     return orbMulP;
@@ -147,12 +76,19 @@ ModuleBase::matrix ModuleIO::cal_mulliken_k(const std::vector<std::vector<std::c
             dynamic_cast<hamilt::HamiltLCAO<std::complex<double>, double>*>(ham_in)->updateSk(ik, LM, 1);
         }
 
+        if(GlobalV::NSPIN == 1 || GlobalV::NSPIN == 2)
+        {
+            const int spin = kv.isk[ik];
+            ModuleIO::cal_orb_mulliken(LM->ParaV, dm[ik].data(), LM->Sloc2.data(), MecMulP.c + spin * nlocal);
+            continue;
+        }
+
+        // the spin blocks of NSPIN=4 pair the columns 2j and 2j+1, which may be on different processes
         ModuleBase::ComplexMatrix mud;
         mud.create(LM->ParaV->ncol, LM->ParaV->nrow);
 
 #ifdef __MPI
         const char T_char = 'T';
-        const char N_char = 'N';
         const int one_int = 1;
         const std::complex<double> one_float = {1.0, 0.0}, zero_float = {0.0, 0.0};        
         pzgemm_(&T_char,
@@ -174,18 +110,7 @@ ModuleBase::matrix ModuleIO::cal_mulliken_k(const std::vector<std::vector<std::c
                 &one_int,
                 &one_int,
                 LM->ParaV->desc);
-        if(GlobalV::NSPIN == 1 || GlobalV::NSPIN == 2)
-        {
-            const int spin = kv.isk[ik];
-            for(size_t i=0; i!=GlobalV::NLOCAL; ++i)
-                if(LM->ParaV->in_this_processor(i, i))
-                {
-                    const int ir = LM->ParaV->global2local_row(i);
-                    const int ic = LM->ParaV->global2local_col(i);
-                    MecMulP(spin, i) += mud(ic, ir).real();
-                }
-        }
-        else if(GlobalV::NSPIN == 4)
+        if(GlobalV::NSPIN == 4)
         {
             for(size_t i=0; i!=GlobalV::NLOCAL; ++i)
             {
@@ -230,6 +155,8 @@ ModuleBase::matrix ModuleIO::cal_mulliken_k(const std::vector<std::vector<std::c
     }
 #ifdef __MPI
     MPI_Reduce(MecMulP.c, orbMulP.c, GlobalV::NSPIN*nlocal, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+#else
+    orbMulP = MecMulP;
 #endif 
 
     return orbMulP;
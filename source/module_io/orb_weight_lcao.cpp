@@ -0,0 +1,151 @@
+#include "module_io/orb_weight_lcao.h"
+
+#include <vector>
+
+#include "module_base/blas_connector.h"
+#include "module_base/scalapack_connector.h"
+#include "module_base/timer.h"
+
+namespace
+{
+inline double conj(const double& x)
+{
+    return x;
+}
+
+inline std::complex<double> conj(const std::complex<double>& x)
+{
+    return std::conj(x);
+}
+
+inline double real(const double& x)
+{
+    return x;
+}
+
+inline double real(const std::complex<double>& x)
+{
+    return x.real();
+}
+
+// sc = S * psi for all bands, in the distribution of psi
+void s_times_psi(const Parallel_Orbitals* pv, const int nbands, const double* s, const double* psi, double* sc)
+{
+#ifdef __MPI
+    const int nlocal = pv->desc[2];
+    const char N_char = 'N';
+    const int one_int = 1;
+    const double one_float = 1.0, zero_float = 0.0;
+    pdgemm_(&N_char, &N_char, &nlocal, &nbands, &nlocal,
+            &one_float,
+            s, &one_int, &one_int, pv->desc,
+            psi, &one_int, &one_int, pv->desc_wfc,
+            &zero_float,
+            sc, &one_int, &one_int, pv->desc_wfc);
+#else
+    const int nlocal = pv->get_row_size();
+    BlasConnector::gemm('N', 'N', nbands, nlocal, nlocal, 1.0, psi, nlocal, s, nlocal, 0.0, sc, nlocal);
+#endif
+}
+
+void s_times_psi(const Parallel_Orbitals* pv,
+                 const int nbands,
+                 const std::complex<double>* s,
+                 const std::complex<double>* psi,
+                 std::complex<double>* sc)
+{
+    const std::complex<double> one_float = {1.0, 0.0}, zero_float = {0.0, 0.0};
+#ifdef __MPI
+    const int nlocal = pv->desc[2];
+    const char N_char = 'N';
+    const int one_int = 1;
+    pzgemm_(&N_char, &N_char, &nlocal, &nbands, &nlocal,
+            &one_float,
+            s, &one_int, &one_int, pv->desc,
+            psi, &one_int, &one_int, pv->desc_wfc,
+            &zero_float,
+            sc, &one_int, &one_int, pv->desc_wfc);
+#else
+    const int nlocal = pv->get_row_size();
+    BlasConnector::gemm('N', 'N', nbands, nlocal, nlocal, one_float, psi, nlocal, s, nlocal, zero_float, sc, nlocal);
+#endif
+}
+
+template <typename T>
+void cal_orb_weight_impl(const Parallel_Orbitals* pv, const int nbands, const T* s, const T* psi, double* weight)
+{
+    ModuleBase::timer::tick("ModuleIO", "cal_orb_weight");
+    const int nrow = pv->get_row_size();
+#ifdef __MPI
+    const int ncol = pv->ncol_bands;
+#else
+    const int ncol = nbands;
+#endif
+    std::vector<T> sc(static_cast<size_t>(nrow) * ncol);
+    s_times_psi(pv, nbands, s, psi, sc.data());
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int ic = 0; ic < ncol; ++ic)
+    {
+        const size_t offset = static_cast<size_t>(ic) * nrow;
+        for (int ir = 0; ir < nrow; ++ir)
+        {
+            weight[offset + ir] = real(conj(psi[offset + ir]) * sc[offset + ir]);
+        }
+    }
+    ModuleBase::timer::tick("ModuleIO", "cal_orb_weight");
+}
+
+template <typename T>
+void cal_orb_mulliken_impl(const Parallel_Orbitals* pv, const T* dm, const T* s, double* mulliken)
+{
+    const int nrow = pv->get_row_size();
+    const int ncol = pv->get_col_size();
+    // each column mu belongs to one thread
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int ic = 0; ic < ncol; ++ic)
+    {
+        const size_t offset = static_cast<size_t>(ic) * nrow;
+        double sum = 0.0;
+        for (int ir = 0; ir < nrow; ++ir)
+        {
+            sum += real(dm[offset + ir] * conj(s[offset + ir]));
+        }
+        mulliken[pv->local2global_col(ic)] += sum;
+    }
+}
+} // namespace
+
+namespace ModuleIO
+{
+void cal_orb_weight(const Parallel_Orbitals* pv, const int nbands, const double* s, const double* psi, double* weight)
+{
+    cal_orb_weight_impl(pv, nbands, s, psi, weight);
+}
+
+void cal_orb_weight(const Parallel_Orbitals* pv,
+                    const int nbands,
+                    const std::complex<double>* s,
+                    const std::complex<double>* psi,
+                    double* weight)
+{
+    cal_orb_weight_impl(pv, nbands, s, psi, weight);
+}
+
+void cal_orb_mulliken(const Parallel_Orbitals* pv, const double* dm, const double* s, double* mulliken)
+{
+    cal_orb_mulliken_impl(pv, dm, s, mulliken);
+}
+
+void cal_orb_mulliken(const Parallel_Orbitals* pv,
+                      const std::complex<double>* dm,
+                      const std::complex<double>* s,
+                      double* mulliken)
+{
+    cal_orb_mulliken_impl(pv, dm, s, mulliken);
+}
+} // namespace ModuleIO
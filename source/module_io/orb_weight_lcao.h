@@ -0,0 +1,42 @@
+#ifndef ORB_WEIGHT_LCAO_H
+#define ORB_WEIGHT_LCAO_H
+
+#include <complex>
+
+#include "module_basis/module_ao/parallel_orbitals.h"
+
+/**
+ * Projections of the LCAO states onto the atomic orbitals, used by the Mulliken charge,
+ * PDOS and projected bands. They work on the local 2D blocks of the distributed matrices
+ * only: each process fills the elements it owns, and the callers accumulate them over
+ * k-points and reduce once at the end. The overlap matrix S is Hermitian and stored
+ * in full, with the same distribution (ParaV->desc) as the density matrix.
+ */
+namespace ModuleIO
+{
+/// @brief the weight of orbital mu in band ib, w(mu, ib) = Re[ c*(mu, ib) (S c)(mu, ib) ].
+/// S*c is computed for all bands in one p?gemm, and the product with c* is done on the local block.
+/// @param nbands number of bands (columns of psi)
+/// @param s the local block of S, distributed by pv->desc
+/// @param psi the local block of the wave functions, distributed by pv->desc_wfc
+/// @param weight the local block of the weights, the same layout as psi (nrow x ncol_bands, column-major)
+void cal_orb_weight(const Parallel_Orbitals* pv, const int nbands, const double* s, const double* psi, double* weight);
+void cal_orb_weight(const Parallel_Orbitals* pv,
+                    const int nbands,
+                    const std::complex<double>* s,
+                    const std::complex<double>* psi,
+                    double* weight);
+
+/// @brief the Mulliken population of each orbital, Re[ (S D)(mu, mu) ] = Re[ sum_nu D(nu, mu) S*(nu, mu) ].
+/// As S is Hermitian, D(nu, mu) and S(nu, mu) are on the same process, so no matrix product is needed.
+/// @param dm the local block of the density matrix, distributed by pv->desc
+/// @param s the local block of S, distributed by pv->desc
+/// @param mulliken the contributions of this process are added to mulliken[mu], mu is the global index
+void cal_orb_mulliken(const Parallel_Orbitals* pv, const double* dm, const double* s, double* mulliken);
+void cal_orb_mulliken(const Parallel_Orbitals* pv,
+                      const std::complex<double>* dm,
+                      const std::complex<double>* s,
+                      double* mulliken);
+} // namespace ModuleIO
+
+#endif
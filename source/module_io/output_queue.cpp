@@ -0,0 +1,131 @@
+#include "module_io/output_queue.h"
+
+#include <fstream>
+
+#include "module_base/timer.h"
+#include "module_base/tool_quit.h"
+
+namespace ModuleIO
+{
+
+Output_Queue::Output_Queue(const int max_tasks) : max_tasks_(max_tasks)
+{
+    if (this->max_tasks_ > 0)
+    {
+        this->worker_ = std::thread(&Output_Queue::work, this);
+    }
+}
+
+Output_Queue::~Output_Queue()
+{
+    {
+        std::unique_lock<std::mutex> lock(this->mutex_);
+        this->stop_ = true;
+    }
+    this->cv_push_.notify_all();
+    if (this->worker_.joinable())
+    {
+        this->worker_.join();
+    }
+}
+
+void Output_Queue::push(const std::string& file_name, const std::function<bool()>& task)
+{
+    if (this->max_tasks_ <= 0)
+    {
+        if (!task())
+        {
+            this->failed_.push_back(file_name);
+        }
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(this->mutex_);
+        this->cv_done_.wait(lock, [this] { return static_cast<int>(this->tasks_.size()) < this->max_tasks_; });
+        this->tasks_.push_back({file_name, task});
+    }
+    this->cv_push_.notify_one();
+}
+
+void Output_Queue::push_text(const std::string& file_name, const std::string& text, const bool append)
+{
+    this->push(file_name, [file_name, text, append]() {
+        std::ofstream ofs(file_name.c_str(), append ? std::ios::app : std::ios::trunc);
+        ofs << text;
+        ofs.close();
+        return !ofs.fail();
+    });
+}
+
+void Output_Queue::flush()
+{
+    ModuleBase::timer::tick("Output_Queue", "flush");
+    std::vector<std::string> failed;
+    {
+        std::unique_lock<std::mutex> lock(this->mutex_);
+        this->cv_done_.wait(lock, [this] { return this->tasks_.empty() && this->running_ == 0; });
+        failed.swap(this->failed_);
+    }
+    for (const std::string& file_name: failed)
+    {
+        ModuleBase::WARNING("Output_Queue::flush", "Can't write " + file_name);
+    }
+    ModuleBase::timer::tick("Output_Queue", "flush");
+}
+
+int Output_Queue::pending() const
+{
+    std::unique_lock<std::mutex> lock(this->mutex_);
+    return static_cast<int>(this->tasks_.size()) + this->running_;
+}
+
+void Output_Queue::work()
+{
+    while (true)
+    {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex_);
+            this->cv_push_.wait(lock, [this] { return this->stop_ || !this->tasks_.empty(); });
+            // the pending tasks are still written when the queue is destroyed
+            if (this->tasks_.empty())
+            {
+                return;
+            }
+            task = std::move(this->tasks_.front());
+            this->tasks_.pop_front();
+            ++this->running_;
+        }
+        // a full queue is waiting in push(), let it go on while this task is written
+        this->cv_done_.notify_all();
+
+        bool ok = false;
+        try
+        {
+            ok = task.run();
+        }
+        catch (...)
+        {
+            ok = false;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex_);
+            --this->running_;
+            if (!ok)
+            {
+                this->failed_.push_back(task.file_name);
+            }
+        }
+        this->cv_done_.notify_all();
+    }
+}
+
+Output_Queue& output_queue()
+{
+    static Output_Queue queue;
+    return queue;
+}
+
+} // namespace ModuleIO
@@ -0,0 +1,78 @@
+#ifndef OUTPUT_QUEUE_H
+#define OUTPUT_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ModuleIO
+{
+
+/**
+ * @brief A background I/O service with a bounded queue.
+ *
+ * The caller hands over a task that owns a copy of everything it needs
+ * (positions, forces, gathered grids, formatted text, ...) and goes on with
+ * the next step, while a single worker thread formats and writes the files
+ * in the order they were pushed. push() blocks while max_tasks tasks are
+ * pending, so the memory held by the snapshots stays bounded.
+ *
+ * The tasks must not touch MPI, ModuleBase::timer or the global log streams.
+ * Failures of the tasks are collected and reported as warnings by flush().
+ */
+class Output_Queue
+{
+  public:
+    /// @param max_tasks number of pending tasks before push() blocks, 0 means the tasks run immediately in push()
+    explicit Output_Queue(const int max_tasks = 4);
+    /// wait for all pending tasks and stop the worker
+    ~Output_Queue();
+
+    Output_Queue(const Output_Queue&) = delete;
+    Output_Queue& operator=(const Output_Queue&) = delete;
+
+    /// @brief queue a task, the task returns false if the output failed
+    /// @param file_name the file written by the task, used in the warning if the task fails
+    void push(const std::string& file_name, const std::function<bool()>& task);
+
+    /// @brief queue a text which is already formatted
+    /// @param append append to the file instead of overwriting it
+    void push_text(const std::string& file_name, const std::string& text, const bool append = false);
+
+    /// @brief wait until all the pushed tasks are written, and warn about the files that failed
+    void flush();
+
+    /// number of tasks which are pushed but not finished
+    int pending() const;
+
+  private:
+    void work();
+
+    struct Task
+    {
+        std::string file_name;
+        std::function<bool()> run;
+    };
+
+    const int max_tasks_;
+    std::deque<Task> tasks_;
+    int running_ = 0;
+    bool stop_ = false;
+    std::vector<std::string> failed_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_push_; ///< signalled when a task is queued or the worker should stop
+    std::condition_variable cv_done_; ///< signalled when a task is finished
+    std::thread worker_;
+};
+
+/// the output queue shared by the per-step output of rank 0, it is flushed at the end of Driver::driver_run
+Output_Queue& output_queue();
+
+} // namespace ModuleIO
+
+#endif
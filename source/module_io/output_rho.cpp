@@ -15,7 +15,8 @@ Output_Rho::Output_Rho(const ModulePW::PW_Basis_Big* pw_big,
                        const std::string directory,
                        int precision,
                        const std::string tag,
-                       const std::string prefix)
+                       const std::string prefix,
+                       const std::string format)
     : _pw_big(pw_big),
       _pw_rho(pw_rho),
       _is(is),
@@ -27,7 +28,8 @@ Output_Rho::Output_Rho(const ModulePW::PW_Basis_Big* pw_big,
       _directory(directory),
       _precision(precision),
       _tag(tag),
-      _prefix(prefix)
+      _prefix(prefix),
+      _format(format)
 {
     if (prefix != "None")
     {
@@ -40,6 +42,26 @@ Output_Rho::Output_Rho(const ModulePW::PW_Basis_Big* pw_big,
 }
 void Output_Rho::write()
 {
+    if (_format != "cube")
+    {
+        write_rho_binary(
+#ifdef __MPI
+            _pw_rho->nplane,
+            _pw_rho->startz_current,
+#endif
+            _data,
+            _is,
+            _nspin,
+            rho_binary_name(_fn),
+            _pw_rho->nx,
+            _pw_rho->ny,
+            _pw_rho->nz,
+            _ef,
+            _ucell,
+            _format == "binary_zlib",
+            true);
+        return;
+    }
     write_rho(
 #ifdef __MPI
         _pw_big->bz,
@@ -57,6 +79,7 @@ void Output_Rho::write()
         _pw_rho->nz,
         _ef,
         _ucell,
-        _precision);
+        _precision,
+        true);
 }
 } // namespace ModuleIO
\ No newline at end of file
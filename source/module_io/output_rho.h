@@ -8,7 +8,9 @@
 namespace ModuleIO
 {
 
-/// @brief the output interface to write the charge density
+/// @brief the output interface to write the charge density,
+/// the file is written by ModuleIO::output_queue() in the background.
+/// format is "cube", "binary" or "binary_zlib", see ModuleIO::write_rho_binary
 class Output_Rho : public Output_Interface
 {
   public:
@@ -23,7 +25,8 @@ class Output_Rho : public Output_Interface
                const std::string directory,
                int precision,
                const std::string tag,
-               const std::string prefix);
+               const std::string prefix,
+               const std::string format = "cube");
     void write() override;
 
   private:
@@ -40,6 +43,7 @@ class Output_Rho : public Output_Interface
     const std::string _tag;
     std::string _fn;
     int _precision;
+    const std::string _format;
 };
 
 } // namespace ModuleIO
@@ -332,6 +332,10 @@ bool input_parameters_set(std::map<std::string, InputParameter> input_parameters
     {
         INPUT.orbital_dir = static_cast<SimpleString*>(input_parameters["orbital_dir"].get())->c_str();
     }
+    else if (input_parameters.count("cache_dir") != 0)
+    {
+        INPUT.cache_dir = static_cast<SimpleString*>(input_parameters["cache_dir"].get())->c_str();
+    }
     else if (input_parameters.count("read_file_dir") != 0)
     {
         INPUT.read_file_dir = static_cast<SimpleString*>(input_parameters["read_file_dir"].get())->c_str();
@@ -364,6 +368,10 @@ bool input_parameters_set(std::map<std::string, InputParameter> input_parameters
     {
         INPUT.pseudo_mesh = *static_cast<bool*>(input_parameters["pseudo_mesh"].get());
     }
+    else if (input_parameters.count("pseudo_sbt_fft") != 0)
+    {
+        INPUT.pseudo_sbt_fft = *static_cast<bool*>(input_parameters["pseudo_sbt_fft"].get());
+    }
     else if (input_parameters.count("ntype") != 0)
     {
         INPUT.ntype = *static_cast<int*>(input_parameters["ntype"].get());
@@ -431,6 +439,14 @@ bool input_parameters_set(std::map<std::string, InputParameter> input_parameters
     {
         INPUT.min_dist_coef = *static_cast<double*>(input_parameters["min_dist_coef"].get());
     }
+    else if (input_parameters.count("ewald_spme") != 0)
+    {
+        INPUT.ewald_spme = *static_cast<bool*>(input_parameters["ewald_spme"].get());
+    }
+    else if (input_parameters.count("ewald_spme_tol") != 0)
+    {
+        INPUT.ewald_spme_tol = *static_cast<double*>(input_parameters["ewald_spme_tol"].get());
+    }
     else if (input_parameters.count("towannier90") != 0)
     {
         INPUT.towannier90 = *static_cast<bool*>(input_parameters["towannier90"].get());
@@ -639,6 +655,18 @@ bool input_parameters_set(std::map<std::string, InputParameter> input_parameters
     {
         INPUT.relax_bfgs_init = *static_cast<double*>(input_parameters["relax_bfgs_init"].get());
     }
+    else if (input_parameters.count("relax_bfgs_prec") != 0)
+    {
+        INPUT.relax_bfgs_prec = static_cast<SimpleString*>(input_parameters["relax_bfgs_prec"].get())->c_str();
+    }
+    else if (input_parameters.count("relax_bfgs_hess_in") != 0)
+    {
+        INPUT.relax_bfgs_hess_in = static_cast<SimpleString*>(input_parameters["relax_bfgs_hess_in"].get())->c_str();
+    }
+    else if (input_parameters.count("out_bfgs_hess") != 0)
+    {
+        INPUT.out_bfgs_hess = *static_cast<bool*>(input_parameters["out_bfgs_hess"].get());
+    }
     else if (input_parameters.count("relax_scale_force") != 0)
     {
         INPUT.relax_scale_force = *static_cast<double*>(input_parameters["relax_scale_force"].get());
@@ -855,6 +883,10 @@ bool input_parameters_set(std::map<std::string, InputParameter> input_parameters
     {
         INPUT.out_chg = *static_cast<bool*>(input_parameters["out_chg"].get());
     }
+    else if (input_parameters.count("out_chg_format") != 0)
+    {
+        INPUT.out_chg_format = static_cast<SimpleString*>(input_parameters["out_chg_format"].get())->c_str();
+    }
     else if (input_parameters.count("out_dm") != 0)
     {
         INPUT.out_dm = *static_cast<bool*>(input_parameters["out_dm"].get());
@@ -995,6 +1027,14 @@ bool input_parameters_set(std::map<std::string, InputParameter> input_parameters
     {
         INPUT.search_pbc = *static_cast<bool*>(input_parameters["search_pbc"].get());
     }
+    else if (input_parameters.count("purification_rcut") != 0)
+    {
+        INPUT.purification_rcut = *static_cast<double*>(input_parameters["purification_rcut"].get());
+    }
+    else if (input_parameters.count("purification_thr") != 0)
+    {
+        INPUT.purification_thr = *static_cast<double*>(input_parameters["purification_thr"].get());
+    }
     else if (input_parameters.count("mdp") != 0)
     {
         // INPUT.mdp = static_cast<MD_para>(input_parameters["mdp"].get());
@@ -1212,6 +1252,10 @@ bool input_parameters_set(std::map<std::string, InputParameter> input_parameters
         INPUT.exx_cauchy_stress_threshold
             = *static_cast<double*>(input_parameters["exx_cauchy_stress_threshold"].get());
     }
+    else if (input_parameters.count("exx_incremental") != 0)
+    {
+        INPUT.exx_incremental = *static_cast<bool*>(input_parameters["exx_incremental"].get());
+    }
     else if (input_parameters.count("exx_ccp_threshold") != 0)
     {
         INPUT.exx_ccp_threshold = *static_cast<double*>(input_parameters["exx_ccp_threshold"].get());
@@ -1372,6 +1416,10 @@ bool input_parameters_set(std::map<std::string, InputParameter> input_parameters
     {
         INPUT.restart_load = *static_cast<bool*>(input_parameters["restart_load"].get());
     }
+    else if (input_parameters.count("restart_freq") != 0)
+    {
+        INPUT.restart_freq = *static_cast<int*>(input_parameters["restart_freq"].get());
+    }
     else if (input_parameters.count("input_error") != 0)
     {
         INPUT.input_error = *static_cast<bool*>(input_parameters["input_error"].get());
@@ -218,6 +218,29 @@ void ModuleIO::trilinear_interpolate(std::ifstream& ifs,
         }
     }
 
+    ModuleIO::trilinear_interpolate(read_rho, nx_read, ny_read, nz_read, nx, ny, nz, data);
+
+    for (int iz = 0; iz < nz_read; iz++)
+    {
+        delete[] read_rho[iz];
+    }
+    delete[] read_rho;
+}
+
+void ModuleIO::trilinear_interpolate(const double* const* read_rho,
+                                     const int& nx_read,
+                                     const int& ny_read,
+                                     const int& nz_read,
+                                     const int& nx,
+                                     const int& ny,
+                                     const int& nz,
+#ifdef __MPI
+                                     double** data
+#else
+                                     double* data
+#endif
+)
+{
     for (int ix = 0; ix < nx; ix++)
     {
         double fracx = 0.5 * (static_cast<double>(nx_read) / nx * (1.0 + 2.0 * ix) - 1.0);
@@ -257,10 +280,4 @@ void ModuleIO::trilinear_interpolate(std::ifstream& ifs,
             }
         }
     }
-
-    for (int iz = 0; iz < nz_read; iz++)
-    {
-        delete[] read_rho[iz];
-    }
-    delete[] read_rho;
 }
\ No newline at end of file
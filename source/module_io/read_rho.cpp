@@ -1,6 +1,30 @@
 #include "module_io/rho_io.h"
 #include "module_io/cube_io.h"
 
+#include <sys/stat.h>
+
+namespace
+{
+// the binary file is read if it is newer than the cube file, or if there is no cube file
+bool prefer_binary(const std::string& fn)
+{
+	int binary = 0;
+	if (GlobalV::MY_RANK == 0)
+	{
+		struct stat st_bin;
+		struct stat st_cube;
+		if (stat(ModuleIO::rho_binary_name(fn).c_str(), &st_bin) == 0)
+		{
+			binary = (stat(fn.c_str(), &st_cube) != 0 || st_bin.st_mtime >= st_cube.st_mtime) ? 1 : 0;
+		}
+	}
+#ifdef __MPI
+	MPI_Bcast(&binary, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+	return binary == 1;
+}
+}
+
 
 bool ModuleIO::read_rho(
 #ifdef __MPI
@@ -17,6 +41,24 @@ bool ModuleIO::read_rho(
 		const UnitCell* ucell,
 		int &prenspin)
 {
+	if (prefer_binary(fn))
+	{
+		return ModuleIO::read_rho_binary(
+#ifdef __MPI
+			Pgrid,
+#endif
+			is,
+			nspin,
+			ModuleIO::rho_binary_name(fn),
+			rho,
+			nx,
+			ny,
+			nz,
+			ef,
+			ucell,
+			prenspin);
+	}
+
 	ModuleIO::read_cube(
 #ifdef __MPI
 		Pgrid,
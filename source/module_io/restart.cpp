@@ -3,10 +3,16 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <sstream>
 #include <stdexcept>
 
 #include "module_base/global_function.h"
+#include "module_base/parallel_common.h"
+#include "module_base/parallel_reduce.h"
 
 void Restart::write_file1(const std::string &file_name, const void*const ptr, const size_t size) const
 {
@@ -88,4 +94,385 @@ void Restart::load_disk(LCAO_Matrix& lm, const std::string mode, const int is, c
 			read_file2(folder+"Hk_"+ModuleBase::GlobalFunc::TO_STRING(GlobalV::MY_RANK)+"_"+ModuleBase::GlobalFunc::TO_STRING(is), lm.Hloc2.data(), lm.ParaV->nloc*sizeof(std::complex<double>));
 	}
 }
-#endif
\ No newline at end of file
+#endif
+
+namespace
+{
+	template<typename T>
+	void pack(std::vector<char> &buffer, const T*const data, const size_t n)
+	{
+		const char*const ptr = reinterpret_cast<const char*>(data);
+		buffer.insert(buffer.end(), ptr, ptr + n * sizeof(T));
+	}
+
+	template<typename T>
+	void pack(std::vector<char> &buffer, const T &data)
+	{
+		pack(buffer, &data, 1);
+	}
+
+	// copy n values from buffer at pos, return false if the buffer is too short
+	template<typename T>
+	bool unpack(const std::vector<char> &buffer, size_t &pos, T*const data, const size_t n)
+	{
+		if(pos + n * sizeof(T) > buffer.size())
+			return false;
+		std::memcpy(data, buffer.data() + pos, n * sizeof(T));
+		pos += n * sizeof(T);
+		return true;
+	}
+
+	template<typename T>
+	bool unpack(const std::vector<char> &buffer, size_t &pos, T &data)
+	{
+		return unpack(buffer, pos, &data, 1);
+	}
+
+	bool read_whole_file(const std::string &file_name, std::vector<char> &buffer)
+	{
+		std::ifstream ifs(file_name, std::ifstream::binary|std::ifstream::ate);
+		if(!ifs)
+			return false;
+		buffer.resize(ifs.tellg());
+		ifs.seekg(0);
+		ifs.read(buffer.data(), buffer.size());
+		return static_cast<bool>(ifs);
+	}
+}
+
+std::string Restart::checkpoint_file(const std::string &name, const int seq, const int rank) const
+{
+	return folder + "checkpoint_" + name + "_" + ModuleBase::GlobalFunc::TO_STRING(seq) + "_" + ModuleBase::GlobalFunc::TO_STRING(rank);
+}
+
+void Restart::begin_checkpoint()
+{
+	this->wait_checkpoint();
+	if(this->checkpoint_seq < 0)
+	{
+		// continue the numbering of a checkpoint left by an earlier job, so its files are never overwritten
+		int last[2] = {0, 0};
+		if(GlobalV::MY_RANK == 0 && this->load_checkpoint_info(this->checkpoint_info_last))
+		{
+			last[0] = this->checkpoint_info_last.seq;
+			last[1] = this->checkpoint_info_last.nproc;
+		}
+#ifdef __MPI
+		Parallel_Common::bcast_int(last, 2);
+#endif
+		this->checkpoint_info_last.seq = last[0];
+		this->checkpoint_info_last.nproc = last[1];
+		this->checkpoint_seq = last[0];
+	}
+	++this->checkpoint_seq;
+	this->checkpoint_names.clear();
+	this->checkpoint_files.clear();
+}
+
+void Restart::save_grids(const std::string &name, const int nx, const int ny, const int nz, const int startz, const int nplane,
+	const std::vector<const double*> &grids)
+{
+	const size_t nrxx = static_cast<size_t>(nx) * ny * nplane;
+	std::vector<char> buffer;
+	buffer.reserve(7 * sizeof(int) + grids.size() * nrxx * sizeof(double));
+	pack(buffer, this->checkpoint_seq);
+	pack(buffer, nx);
+	pack(buffer, ny);
+	pack(buffer, nz);
+	pack(buffer, startz);
+	pack(buffer, nplane);
+	pack(buffer, static_cast<int>(grids.size()));
+	for(const double* grid : grids)
+		pack(buffer, grid, nrxx);
+	this->checkpoint_names.push_back(name);
+	this->checkpoint_files.emplace_back(checkpoint_file(name, this->checkpoint_seq, GlobalV::MY_RANK), std::move(buffer));
+}
+
+void Restart::save_coefs(const std::string &name, const int n, const std::vector<const std::complex<double>*> &coefs)
+{
+	std::vector<char> buffer;
+	buffer.reserve(3 * sizeof(int) + coefs.size() * n * sizeof(std::complex<double>));
+	pack(buffer, this->checkpoint_seq);
+	pack(buffer, n);
+	pack(buffer, static_cast<int>(coefs.size()));
+	for(const std::complex<double>* coef : coefs)
+		pack(buffer, coef, n);
+	this->checkpoint_names.push_back(name);
+	this->checkpoint_files.emplace_back(checkpoint_file(name, this->checkpoint_seq, GlobalV::MY_RANK), std::move(buffer));
+}
+
+#ifdef __LCAO
+void Restart::save_hcontainer(const std::string &name, const std::vector<hamilt::HContainer<double>*> &hR)
+{
+	std::vector<char> buffer;
+	pack(buffer, this->checkpoint_seq);
+	pack(buffer, static_cast<int>(hR.size()));
+	std::vector<int> rows, cols;
+	for(const hamilt::HContainer<double>* h : hR)
+	{
+		pack(buffer, static_cast<int>(h->size_atom_pairs()));
+		for(int iap = 0; iap < h->size_atom_pairs(); ++iap)
+		{
+			const hamilt::AtomPair<double> &ap = h->get_atom_pair(iap);
+			const Parallel_Orbitals*const pv = ap.get_paraV();
+			const int iat1 = ap.get_atom_i();
+			const int iat2 = ap.get_atom_j();
+			const int nrow = ap.get_row_size();
+			const int ncol = ap.get_col_size();
+			rows.resize(nrow);
+			cols.resize(ncol);
+			for(int i = 0; i < nrow; ++i)
+				rows[i] = pv->local2global_row(pv->atom_begin_row[iat1] + i);
+			for(int j = 0; j < ncol; ++j)
+				cols[j] = pv->local2global_col(pv->atom_begin_col[iat2] + j);
+
+			pack(buffer, iat1);
+			pack(buffer, iat2);
+			pack(buffer, nrow);
+			pack(buffer, ncol);
+			pack(buffer, rows.data(), nrow);
+			pack(buffer, cols.data(), ncol);
+			pack(buffer, static_cast<int>(ap.get_R_size()));
+			for(int iR = 0; iR < ap.get_R_size(); ++iR)
+			{
+				pack(buffer, ap.get_R_index(iR), 3);
+				pack(buffer, ap.get_pointer(iR), static_cast<size_t>(nrow) * ncol);
+			}
+		}
+	}
+	this->checkpoint_names.push_back(name);
+	this->checkpoint_files.emplace_back(checkpoint_file(name, this->checkpoint_seq, GlobalV::MY_RANK), std::move(buffer));
+}
+#endif
+
+void Restart::commit_checkpoint(const Info_Checkpoint &info)
+{
+	this->checkpoint_info_pending = info;
+	this->checkpoint_info_pending.seq = this->checkpoint_seq;
+	this->checkpoint_pending = true;
+
+	std::vector<std::pair<std::string, std::vector<char>>> files;
+	files.swap(this->checkpoint_files);
+	this->checkpoint_writer = std::async(std::launch::async, [this](std::vector<std::pair<std::string, std::vector<char>>> files)
+	{
+		// write a temporary file first, so that a killed job never leaves a half-written checkpoint behind
+		for(const auto &file : files)
+		{
+			const std::string file_tmp = file.first + ".tmp";
+			this->write_file2(file_tmp, file.second.data(), file.second.size());
+			if(0 != std::rename(file_tmp.c_str(), file.first.c_str()))
+				throw std::runtime_error("can't rename restart checkpoint file "+file.first+".\n"+ModuleBase::GlobalFunc::TO_STRING(__FILE__)+" line "+ModuleBase::GlobalFunc::TO_STRING(__LINE__));
+		}
+	}, std::move(files));
+}
+
+void Restart::wait_checkpoint()
+{
+	if(!this->checkpoint_pending)
+		return;
+	this->checkpoint_pending = false;
+
+	int nfail = 0;
+	try
+	{
+		this->checkpoint_writer.get();
+	}
+	catch(const std::runtime_error &e)
+	{
+		ModuleBase::WARNING("Restart::wait_checkpoint", e.what());
+		++nfail;
+	}
+	Parallel_Reduce::reduce_int_all(nfail);
+	const Info_Checkpoint &info = this->checkpoint_info_pending;
+	if(nfail > 0)
+	{
+		// checkpoint_info keeps referring to the previous checkpoint
+		ModuleBase::WARNING("Restart::wait_checkpoint", "restart checkpoint "+ModuleBase::GlobalFunc::TO_STRING(info.seq)+" is incomplete and not used");
+		for(const std::string &name : this->checkpoint_names)
+			std::remove(checkpoint_file(name, info.seq, GlobalV::MY_RANK).c_str());
+		return;
+	}
+
+	// all the files are complete, rank 0 switches checkpoint_info to them
+	if(GlobalV::MY_RANK == 0)
+	{
+		std::stringstream ss;
+		ss << "nproc " << info.nproc << "\n";
+		ss << "seq " << info.seq << "\n";
+		ss << "iter " << info.iter << "\n";
+		ss << "mixing_steps " << info.mixing_steps.size();
+		for(const int step : info.mixing_steps)
+			ss << " " << step;
+		ss << "\n";
+		const std::string content = ss.str();
+		const std::string file_info = folder + "checkpoint_info";
+		this->write_file2(file_info + ".tmp", content.data(), content.size());
+		if(0 != std::rename((file_info + ".tmp").c_str(), file_info.c_str()))
+			throw std::runtime_error("can't rename restart checkpoint file "+file_info+".\n"+ModuleBase::GlobalFunc::TO_STRING(__FILE__)+" line "+ModuleBase::GlobalFunc::TO_STRING(__LINE__));
+	}
+#ifdef __MPI
+	MPI_Barrier(MPI_COMM_WORLD);
+#endif
+
+	// the previous checkpoint may have been written by another number of ranks
+	std::vector<std::string> names_last = this->checkpoint_names_last;
+	names_last.insert(names_last.end(), this->checkpoint_names.begin(), this->checkpoint_names.end());
+	std::sort(names_last.begin(), names_last.end());
+	names_last.erase(std::unique(names_last.begin(), names_last.end()), names_last.end());
+	for(int rank = GlobalV::MY_RANK; rank < this->checkpoint_info_last.nproc; rank += GlobalV::NPROC)
+		for(const std::string &name : names_last)
+			std::remove(checkpoint_file(name, this->checkpoint_info_last.seq, rank).c_str());
+
+	this->checkpoint_info_last = info;
+	this->checkpoint_names_last = this->checkpoint_names;
+}
+
+bool Restart::load_checkpoint_info(Info_Checkpoint &info) const
+{
+	std::ifstream ifs(folder + "checkpoint_info");
+	if(!ifs)
+		return false;
+	std::string word;
+	int nstep = 0;
+	ifs >> word >> info.nproc >> word >> info.seq >> word >> info.iter >> word >> nstep;
+	info.mixing_steps.resize(nstep);
+	for(int i = 0; i < nstep; ++i)
+		ifs >> info.mixing_steps[i];
+	return static_cast<bool>(ifs) && info.nproc > 0;
+}
+
+bool Restart::load_grids(const Info_Checkpoint &info, const std::string &name, const int nx, const int ny, const int nz,
+	const int startz, const int nplane, const std::vector<double*> &grids) const
+{
+	const int nxy = nx * ny;
+	std::vector<char> buffer;
+	std::vector<double> plane(nxy);
+	for(int rank = 0; rank < info.nproc; ++rank)
+	{
+		if(!read_whole_file(checkpoint_file(name, info.seq, rank), buffer))
+			return false;
+		size_t pos = 0;
+		int seq_w=0, nx_w=0, ny_w=0, nz_w=0, startz_w=0, nplane_w=0, ngrid_w=0;
+		unpack(buffer, pos, seq_w);
+		unpack(buffer, pos, nx_w);
+		unpack(buffer, pos, ny_w);
+		unpack(buffer, pos, nz_w);
+		unpack(buffer, pos, startz_w);
+		unpack(buffer, pos, nplane_w);
+		if(!unpack(buffer, pos, ngrid_w))
+			return false;
+		if(seq_w != info.seq || nx_w != nx || ny_w != ny || nz_w != nz || ngrid_w != grids.size())
+			return false;
+		if(buffer.size() != pos + static_cast<size_t>(ngrid_w) * nxy * nplane_w * sizeof(double))
+			return false;
+
+		// the planes of the writer overlapping with those of this rank, both stored as data[ixy*nplane+iz-startz]
+		const int zbeg = std::max(startz, startz_w);
+		const int zend = std::min(startz + nplane, startz_w + nplane_w);
+		if(zbeg >= zend)
+			continue;
+		for(int ig = 0; ig < ngrid_w; ++ig)
+		{
+			const char*const data_w = buffer.data() + pos + static_cast<size_t>(ig) * nxy * nplane_w * sizeof(double);
+			for(int ixy = 0; ixy < nxy; ++ixy)
+				std::memcpy(grids[ig] + static_cast<size_t>(ixy) * nplane + zbeg - startz,
+					data_w + (static_cast<size_t>(ixy) * nplane_w + zbeg - startz_w) * sizeof(double),
+					(zend - zbeg) * sizeof(double));
+		}
+	}
+	return true;
+}
+
+bool Restart::load_coefs(const Info_Checkpoint &info, const std::string &name, const int n,
+	const std::vector<std::complex<double>*> &coefs) const
+{
+	if(info.nproc != GlobalV::NPROC)
+		return false;
+	std::vector<char> buffer;
+	if(!read_whole_file(checkpoint_file(name, info.seq, GlobalV::MY_RANK), buffer))
+		return false;
+	size_t pos = 0;
+	int seq_w=0, n_w=0, ncoef_w=0;
+	unpack(buffer, pos, seq_w);
+	unpack(buffer, pos, n_w);
+	if(!unpack(buffer, pos, ncoef_w))
+		return false;
+	if(seq_w != info.seq || n_w != n || ncoef_w != coefs.size())
+		return false;
+	for(std::complex<double>* coef : coefs)
+	{
+		if(!unpack(buffer, pos, coef, n))
+			return false;
+	}
+	return true;
+}
+
+#ifdef __LCAO
+bool Restart::load_hcontainer(const Info_Checkpoint &info, const std::string &name,
+	const std::vector<hamilt::HContainer<double>*> &hR) const
+{
+	std::vector<char> buffer;
+	std::vector<int> rows, cols;
+	std::vector<double> values;
+	for(int rank = 0; rank < info.nproc; ++rank)
+	{
+		if(!read_whole_file(checkpoint_file(name, info.seq, rank), buffer))
+			return false;
+		size_t pos = 0;
+		int seq_w=0, nspin_w=0;
+		unpack(buffer, pos, seq_w);
+		if(!unpack(buffer, pos, nspin_w))
+			return false;
+		if(seq_w != info.seq || nspin_w != hR.size())
+			return false;
+
+		for(hamilt::HContainer<double>* h : hR)
+		{
+			int npair = 0;
+			if(!unpack(buffer, pos, npair))
+				return false;
+			for(int iap = 0; iap < npair; ++iap)
+			{
+				int iat1=0, iat2=0, nrow=0, ncol=0, nR=0;
+				unpack(buffer, pos, iat1);
+				unpack(buffer, pos, iat2);
+				unpack(buffer, pos, nrow);
+				if(!unpack(buffer, pos, ncol))
+					return false;
+				rows.resize(nrow);
+				cols.resize(ncol);
+				values.resize(static_cast<size_t>(nrow) * ncol);
+				unpack(buffer, pos, rows.data(), nrow);
+				unpack(buffer, pos, cols.data(), ncol);
+				if(!unpack(buffer, pos, nR))
+					return false;
+
+				hamilt::AtomPair<double>*const ap = h->find_pair(iat1, iat2);
+				const Parallel_Orbitals*const pv = (ap == nullptr) ? nullptr : ap->get_paraV();
+				for(int iR = 0; iR < nR; ++iR)
+				{
+					int R[3];
+					unpack(buffer, pos, R, 3);
+					if(!unpack(buffer, pos, values.data(), values.size()))
+						return false;
+					if(ap == nullptr || ap->find_R(R[0], R[1], R[2]) < 0)
+						continue;
+					// find_R has fixed the cell for get_matrix_value
+					for(int i = 0; i < nrow; ++i)
+					{
+						if(pv->global2local_row(rows[i]) < 0)
+							continue;
+						for(int j = 0; j < ncol; ++j)
+						{
+							if(pv->global2local_col(cols[j]) < 0)
+								continue;
+							ap->get_matrix_value(rows[i], cols[j]) = values[static_cast<size_t>(i) * ncol + j];
+						}
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
+#endif
@@ -1,20 +1,32 @@
 #ifndef RESTART_H
 #define RESTART_H
 
+#include <complex>
+#include <future>
 #include <string>
+#include <utility>
+#include <vector>
 #ifdef __LCAO
 #include "module_hamilt_lcao/hamilt_lcaodft/LCAO_matrix.h"
+#include "module_hamilt_lcao/module_hcontainer/hcontainer.h"
 #endif
 class Restart
 {
 public:
+	~Restart()
+	{
+		if(this->checkpoint_writer.valid())
+			this->checkpoint_writer.wait();
+	}
+
 	struct Info_Save
 	{
 		bool save_charge = false;
 		bool save_H = false;
+		int checkpoint_freq = 0;	// write the binary SCF checkpoint every checkpoint_freq iterations, 0 means never
 	};
 	Info_Save info_save;
-	
+
 	struct Info_Load
 	{
 		bool load_charge = false;
@@ -22,22 +34,84 @@ public:
 		bool load_H = false;
 		bool load_H_finish = false;
 		bool restart_exx = false;
+		bool load_checkpoint = false;
+		bool load_checkpoint_finish = false;
 	};
 	Info_Load info_load;
-	
+
 	std::string folder;
-	
+
 	void save_disk(const std::string mode, const int is, const int nrxx, double** rho) const;
 	void load_disk(const std::string mode, const int is, const int nrxx, double** rho) const;
 #ifdef __LCAO
     void save_disk(LCAO_Matrix &lm, const std::string mode, const int is, const int nrxx, double** rho) const;
     void load_disk(LCAO_Matrix &lm, const std::string mode, const int is, const int nrxx, double** rho) const;
 #endif
+
+	//----------------------------------------------------------
+	// binary SCF checkpoint
+	// save_* pack the data of this rank in memory, and
+	// commit_checkpoint writes them to disk in a background thread,
+	// so the SCF loop only waits for the copies.
+	// Each checkpoint gets a new sequence number in its file names,
+	// so writing it never touches the files of the last complete one,
+	// which checkpoint_info refers to until all ranks have finished.
+	//----------------------------------------------------------
+	struct Info_Checkpoint
+	{
+		int nproc = 0;					// number of ranks that wrote the checkpoint
+		int seq = 0;					// sequence number of the checkpoint, increases with each one written
+		int iter = 0;					// electronic iteration of the checkpoint
+		std::vector<int> mixing_steps;	// step counters of the charge mixing history
+	};
+
+	// collective: wait for the previous checkpoint and start packing a new one with the next sequence number
+	void begin_checkpoint();
+	// real-space grids of nx*ny*nplane points, this rank holds the z-planes [startz, startz+nplane)
+	void save_grids(const std::string &name, const int nx, const int ny, const int nz, const int startz, const int nplane,
+		const std::vector<const double*> &grids);
+	// coefficients only meaningful on the same parallel layout, e.g. G-space vectors of this rank
+	void save_coefs(const std::string &name, const int n, const std::vector<const std::complex<double>*> &coefs);
+#ifdef __LCAO
+	// R-space matrices of each spin, the elements are labelled by atom pair, cell and global orbital indices
+	void save_hcontainer(const std::string &name, const std::vector<hamilt::HContainer<double>*> &hR);
+#endif
+	// write the packed files in the background, the checkpoint is complete after the next wait_checkpoint
+	void commit_checkpoint(const Info_Checkpoint &info);
+	// collective: wait for the background writing of all ranks, then rank 0 points checkpoint_info
+	// to the new files and the files of the previous checkpoint are removed
+	void wait_checkpoint();
+
+	bool load_checkpoint_info(Info_Checkpoint &info) const;
+	// the planes of this rank are picked from the files of all writers, so the z-planes may be distributed differently
+	bool load_grids(const Info_Checkpoint &info, const std::string &name, const int nx, const int ny, const int nz,
+		const int startz, const int nplane, const std::vector<double*> &grids) const;
+	// only succeeds if the checkpoint was written by the same number of ranks with the same sizes
+	bool load_coefs(const Info_Checkpoint &info, const std::string &name, const int n,
+		const std::vector<std::complex<double>*> &coefs) const;
+#ifdef __LCAO
+	// the elements of this rank are picked from the files of all writers, so the 2D block distribution may differ;
+	// atom pairs and cells missing in hR are skipped
+	bool load_hcontainer(const Info_Checkpoint &info, const std::string &name,
+		const std::vector<hamilt::HContainer<double>*> &hR) const;
+#endif
+
 private:
 	void write_file1(const std::string &file_name, const void*const ptr, const size_t size) const;
 	void read_file1(const std::string &file_name, void*const ptr, const size_t size) const;
 	void write_file2(const std::string &file_name, const void*const ptr, const size_t size) const;
 	void read_file2(const std::string &file_name, void*const ptr, const size_t size) const;
+
+	std::string checkpoint_file(const std::string &name, const int seq, const int rank) const;
+
+	int checkpoint_seq = -1;					// sequence number of the checkpoint being packed, -1 before the first one
+	std::vector<std::string> checkpoint_names;	// names of the files being packed
+	std::vector<std::pair<std::string, std::vector<char>>> checkpoint_files;	// (file name, content) packed for writing
+	std::future<void> checkpoint_writer;
+	bool checkpoint_pending = false;			// written in the background but not yet in checkpoint_info
+	Info_Checkpoint checkpoint_info_pending;
+	Info_Checkpoint checkpoint_info_last;		// the checkpoint that checkpoint_info refers to
+	std::vector<std::string> checkpoint_names_last;
 };
 
-#endif
\ No newline at end of file
+#endif
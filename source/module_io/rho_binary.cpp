@@ -0,0 +1,574 @@
+#include "module_io/rho_io.h"
+#include "module_io/cube_io.h"
+#include "module_io/output_queue.h"
+#include "module_base/element_name.h"
+#include "module_base/global_variable.h"
+#include "module_base/timer.h"
+#include "module_base/tool_quit.h"
+#include "module_base/tool_title.h"
+#ifdef __MPI
+#include "module_base/parallel_global.h"
+#endif
+#ifdef __ZLIB
+#include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+
+//----------------------------------------------------------
+// Layout of the binary charge density file,
+// all numbers are in the native byte order.
+//
+//   char[8]   "ABACHG01"
+//   int32     nspin, is, nx, ny, nz, nat, compression, nslab, two_efermi
+//   double    ef (Ry), lat0 (Bohr), latvec (e11, e12, ..., e33, in lat0)
+//   nat   x   int32 atomic number, double zv, double x, y, z (Bohr)
+//   nslab x   int32 startz, int32 nplane, int64 nbytes
+//   nslab x   nbytes of the slab, in the order of the table above
+//
+// A slab holds the z-planes [startz, startz+nplane) as
+// data[(iz-startz)*nx*ny + ix*ny + iy].
+// compression 0: the doubles are stored as they are;
+// compression 1: the bytes of the doubles are regrouped by
+// significance (all first bytes, then all second bytes, ...)
+// and the result is compressed by zlib.
+//----------------------------------------------------------
+
+namespace
+{
+const char rho_binary_magic[8] = {'A', 'B', 'A', 'C', 'H', 'G', '0', '1'};
+
+template <class T>
+void put(std::string& buf, const T& value)
+{
+	buf.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+bool get(std::istream& ifs, T& value)
+{
+	ifs.read(reinterpret_cast<char*>(&value), sizeof(T));
+	return static_cast<bool>(ifs);
+}
+
+int64_t header_size(const int nat, const int nslab)
+{
+	return sizeof(rho_binary_magic) + 9 * sizeof(int32_t) + 11 * sizeof(double)
+		+ nat * (sizeof(int32_t) + 4 * sizeof(double))
+		+ nslab * (2 * sizeof(int32_t) + sizeof(int64_t));
+}
+
+// convert from label to atomic number, the number in label is erased, such as Fe1.
+int atomic_number(std::string element)
+{
+	std::string::iterator temp = element.begin();
+	while (temp != element.end())
+	{
+		if ((*temp >= '1') && (*temp <= '9'))
+		{
+			temp = element.erase(temp);
+		}
+		else
+		{
+			temp++;
+		}
+	}
+	for(size_t j=0; j!=ModuleBase::element_name.size(); j++)
+	{
+		if (element == ModuleBase::element_name[j])
+		{
+			return j+1;
+		}
+	}
+	return 0;
+}
+
+std::string pack_header(const int nspin,
+                        const int is,
+                        const int nx,
+                        const int ny,
+                        const int nz,
+                        const int compression,
+                        const double ef,
+                        const UnitCell* ucell,
+                        const std::vector<int>& startz,
+                        const std::vector<int>& nplane,
+                        const std::vector<int64_t>& nbytes)
+{
+	std::string buf;
+	buf.append(rho_binary_magic, sizeof(rho_binary_magic));
+	const int32_t ints[9] = {nspin, is, nx, ny, nz, ucell->nat, compression, static_cast<int32_t>(startz.size()),
+		GlobalV::TWO_EFERMI ? 1 : 0};
+	for (const int32_t i: ints)
+	{
+		put(buf, i);
+	}
+	put(buf, ef);
+	put(buf, ucell->lat0);
+	const ModuleBase::Matrix3& a = ucell->latvec;
+	for (const double e: {a.e11, a.e12, a.e13, a.e21, a.e22, a.e23, a.e31, a.e32, a.e33})
+	{
+		put(buf, e);
+	}
+	for(int it=0; it<ucell->ntype; it++)
+	{
+		const int32_t z = atomic_number(ucell->atoms[it].label);
+		for(int ia=0; ia<ucell->atoms[it].na; ia++)
+		{
+			put(buf, z);
+			put(buf, static_cast<double>(ucell->atoms[it].ncpp.zv));
+			put(buf, ucell->lat0 * ucell->atoms[it].tau[ia].x);
+			put(buf, ucell->lat0 * ucell->atoms[it].tau[ia].y);
+			put(buf, ucell->lat0 * ucell->atoms[it].tau[ia].z);
+		}
+	}
+	for (size_t islab = 0; islab < startz.size(); ++islab)
+	{
+		put(buf, static_cast<int32_t>(startz[islab]));
+		put(buf, static_cast<int32_t>(nplane[islab]));
+		put(buf, nbytes[islab]);
+	}
+	return buf;
+}
+
+// compression is set to 0 if ABACUS is compiled without zlib
+std::vector<char> encode_slab(const std::vector<double>& slab, int& compression)
+{
+	const size_t size = slab.size() * sizeof(double);
+	const char* raw = reinterpret_cast<const char*>(slab.data());
+#ifdef __ZLIB
+	if (compression == 1)
+	{
+		std::vector<Bytef> shuffled(size);
+		for (size_t i = 0; i < slab.size(); ++i)
+		{
+			for (size_t b = 0; b < sizeof(double); ++b)
+			{
+				shuffled[b * slab.size() + i] = raw[i * sizeof(double) + b];
+			}
+		}
+		uLongf nbytes = compressBound(size);
+		std::vector<char> bytes(nbytes);
+		if (compress2(reinterpret_cast<Bytef*>(bytes.data()), &nbytes, shuffled.data(), size, Z_BEST_SPEED) == Z_OK)
+		{
+			bytes.resize(nbytes);
+			return bytes;
+		}
+	}
+#endif
+	compression = 0;
+	return std::vector<char>(raw, raw + size);
+}
+
+bool decode_slab(const std::vector<char>& bytes, const int compression, std::vector<double>& slab)
+{
+	const size_t size = slab.size() * sizeof(double);
+	char* raw = reinterpret_cast<char*>(slab.data());
+	if (compression == 0)
+	{
+		if (bytes.size() != size)
+		{
+			return false;
+		}
+		std::copy(bytes.begin(), bytes.end(), raw);
+		return true;
+	}
+#ifdef __ZLIB
+	if (compression == 1)
+	{
+		std::vector<Bytef> shuffled(size);
+		uLongf nbytes = size;
+		if (uncompress(shuffled.data(), &nbytes, reinterpret_cast<const Bytef*>(bytes.data()), bytes.size()) != Z_OK
+			|| nbytes != size)
+		{
+			return false;
+		}
+		for (size_t i = 0; i < slab.size(); ++i)
+		{
+			for (size_t b = 0; b < sizeof(double); ++b)
+			{
+				raw[i * sizeof(double) + b] = shuffled[b * slab.size() + i];
+			}
+		}
+		return true;
+	}
+#endif
+	return false;
+}
+
+// the file is created by the first process, the other slabs are written into it at their offsets
+bool write_slab(const std::string& fn, const int64_t offset, const std::vector<char>& bytes)
+{
+	std::fstream ofs(fn.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+	if (!ofs)
+	{
+		return false;
+	}
+	ofs.seekp(offset);
+	ofs.write(bytes.data(), bytes.size());
+	ofs.close();
+	return !ofs.fail();
+}
+
+// read the whole grid as planes[iz][ix*ny+iy]
+bool read_binary_file(const std::string& fn,
+                      const int& nspin,
+                      const UnitCell* ucell,
+                      const bool& warning_flag,
+                      double& ef,
+                      int& prenspin,
+                      int& nx_read,
+                      int& ny_read,
+                      int& nz_read,
+                      std::vector<std::vector<double>>& planes)
+{
+	std::ifstream ifs(fn.c_str(), std::ios::binary);
+	if (!ifs)
+	{
+		GlobalV::ofs_running << "!!! Couldn't find the charge file of " << fn << std::endl;
+		return false;
+	}
+	char magic[sizeof(rho_binary_magic)];
+	ifs.read(magic, sizeof(magic));
+	if (!ifs || !std::equal(magic, magic + sizeof(magic), rho_binary_magic))
+	{
+		GlobalV::ofs_running << "!!! " << fn << " is not a binary charge density file" << std::endl;
+		return false;
+	}
+	GlobalV::ofs_running << " Find the file, try to read charge from file." << std::endl;
+
+	int32_t ints[9];
+	for (int32_t& i: ints)
+	{
+		get(ifs, i);
+	}
+	const int nspin_read = ints[0];
+	nx_read = ints[2];
+	ny_read = ints[3];
+	nz_read = ints[4];
+	const int nat_read = ints[5];
+	const int compression = ints[6];
+	const int nslab = ints[7];
+
+	if(nspin != 4)
+	{
+		if (nspin_read != nspin)
+		{
+			ModuleBase::WARNING_QUIT("ModuleIO::read_rho_binary", "nspin of " + fn + " is different!");
+		}
+	}
+	else
+	{
+		prenspin = nspin_read;
+	}
+	if (nat_read != ucell->nat)
+	{
+		ModuleBase::WARNING_QUIT("ModuleIO::read_rho_binary", "number of atoms of " + fn + " is different!");
+	}
+
+	double lat0 = 0.0;
+	double latvec[9];
+	get(ifs, ef);
+	get(ifs, lat0);
+	for (double& e: latvec)
+	{
+		get(ifs, e);
+	}
+	GlobalV::ofs_running << " read in fermi energy = " << ef << std::endl;
+
+	// check the lattice vectors and atomic positions in Bohr, as the cube file does
+	const double tiny = 1.0e-5;
+	const double fac = ucell->lat0;
+	const ModuleBase::Matrix3& a = ucell->latvec;
+	const double latvec_now[9] = {a.e11, a.e12, a.e13, a.e21, a.e22, a.e23, a.e31, a.e32, a.e33};
+	for (int i = 0; i < 9 && warning_flag; ++i)
+	{
+		const double v_in = lat0 * latvec[i];
+		const double v = fac * latvec_now[i];
+		if (std::abs(v - v_in) > tiny)
+		{
+			std::cout << " can not match well (1.0e-5): " << v_in << "(readin)  " << v << std::endl;
+		}
+	}
+	for(int it=0; it<ucell->ntype; it++)
+	{
+		for(int ia=0; ia<ucell->atoms[it].na; ia++)
+		{
+			int32_t z = 0;
+			double zv = 0.0;
+			double tau[3];
+			get(ifs, z);
+			get(ifs, zv);
+			get(ifs, tau[0]);
+			get(ifs, tau[1]);
+			get(ifs, tau[2]);
+			if (!warning_flag)
+			{
+				continue;
+			}
+			const double tau_now[3] = {fac * ucell->atoms[it].tau[ia].x,
+				fac * ucell->atoms[it].tau[ia].y,
+				fac * ucell->atoms[it].tau[ia].z};
+			for (int i = 0; i < 3; ++i)
+			{
+				if (std::abs(tau_now[i] - tau[i]) > tiny)
+				{
+					std::cout << " can not match well (1.0e-5): " << tau[i] << "(readin)  " << tau_now[i] << std::endl;
+				}
+			}
+		}
+	}
+
+	std::vector<int32_t> startz(nslab);
+	std::vector<int32_t> nplane(nslab);
+	std::vector<int64_t> nbytes(nslab);
+	for (int islab = 0; islab < nslab; ++islab)
+	{
+		get(ifs, startz[islab]);
+		get(ifs, nplane[islab]);
+		get(ifs, nbytes[islab]);
+	}
+	if (!ifs)
+	{
+		GlobalV::ofs_running << "!!! the header of " << fn << " is incomplete" << std::endl;
+		return false;
+	}
+
+	const int nxy_read = nx_read * ny_read;
+	planes.assign(nz_read, std::vector<double>());
+	std::vector<char> bytes;
+	for (int islab = 0; islab < nslab; ++islab)
+	{
+		if (startz[islab] < 0 || startz[islab] + nplane[islab] > nz_read)
+		{
+			GlobalV::ofs_running << "!!! wrong z-planes in " << fn << std::endl;
+			return false;
+		}
+		bytes.resize(nbytes[islab]);
+		ifs.read(bytes.data(), nbytes[islab]);
+		std::vector<double> slab(static_cast<size_t>(nplane[islab]) * nxy_read);
+		if (!ifs || !decode_slab(bytes, compression, slab))
+		{
+			GlobalV::ofs_running << "!!! can not read the z-planes " << startz[islab] << " to "
+				<< startz[islab] + nplane[islab] - 1 << " of " << fn << std::endl;
+			return false;
+		}
+		for (int iz = 0; iz < nplane[islab]; ++iz)
+		{
+			planes[startz[islab] + iz].assign(slab.begin() + iz * nxy_read, slab.begin() + (iz + 1) * nxy_read);
+		}
+	}
+	for (int iz = 0; iz < nz_read; ++iz)
+	{
+		if (planes[iz].size() != static_cast<size_t>(nxy_read))
+		{
+			GlobalV::ofs_running << "!!! the z-plane " << iz << " is missing in " << fn << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+}
+
+std::string ModuleIO::rho_binary_name(const std::string& fn)
+{
+	const std::string cube = ".cube";
+	if (fn.size() >= cube.size() && fn.compare(fn.size() - cube.size(), cube.size(), cube) == 0)
+	{
+		return fn.substr(0, fn.size() - cube.size()) + ".bin";
+	}
+	return fn + ".bin";
+}
+
+void ModuleIO::write_rho_binary(
+#ifdef __MPI
+	const int& nplane,
+	const int& startz_current,
+#endif
+	const double* rho_save,
+	const int& is,
+	const int& nspin,
+	const std::string& fn,
+	const int& nx,
+	const int& ny,
+	const int& nz,
+	const double& ef,
+	const UnitCell* ucell,
+	const bool compress,
+	const bool async)
+{
+	ModuleBase::TITLE("ModuleIO","write_rho_binary");
+	ModuleBase::timer::tick("ModuleIO","write_rho_binary");
+
+	const int nxy = nx * ny;
+#ifdef __MPI
+	// only do in the first pool.
+	if(GlobalV::MY_POOL==0)
+	{
+		const int rank = GlobalV::RANK_IN_POOL;
+		const int nslab = GlobalV::NPROC_IN_POOL;
+		const int startz_local = startz_current;
+		const int nplane_local = nplane;
+#else
+	{
+		const int rank = 0;
+		const int nslab = 1;
+		const int startz_local = 0;
+		const int nplane_local = nz;
+#endif
+		// the z-planes of this process, z is the slowest index
+		std::vector<double> slab(static_cast<size_t>(nplane_local) * nxy);
+		for (int iz = 0; iz < nplane_local; ++iz)
+		{
+			for (int ir = 0; ir < nxy; ++ir)
+			{
+#ifdef __MPI
+				slab[iz * nxy + ir] = rho_save[ir * nplane_local + iz];
+#else
+				slab[iz * nxy + ir] = rho_save[iz * nxy + ir];
+#endif
+			}
+		}
+		int compression = compress ? 1 : 0;
+		std::shared_ptr<std::vector<char>> bytes = std::make_shared<std::vector<char>>(encode_slab(slab, compression));
+
+		// the table of slabs, the offset of each slab follows from the sizes of the slabs before it
+		std::vector<int> startz(nslab, startz_local);
+		std::vector<int> nplanes(nslab, nplane_local);
+		std::vector<int64_t> nbytes(nslab, bytes->size());
+#ifdef __MPI
+		const long long nbytes_local = bytes->size();
+		std::vector<long long> nbytes_all(nslab);
+		MPI_Allgather(&startz_local, 1, MPI_INT, startz.data(), 1, MPI_INT, POOL_WORLD);
+		MPI_Allgather(&nplane_local, 1, MPI_INT, nplanes.data(), 1, MPI_INT, POOL_WORLD);
+		MPI_Allgather(&nbytes_local, 1, MPI_LONG_LONG, nbytes_all.data(), 1, MPI_LONG_LONG, POOL_WORLD);
+		nbytes.assign(nbytes_all.begin(), nbytes_all.end());
+#endif
+		int64_t offset = header_size(ucell->nat, nslab);
+		for (int ip = 0; ip < rank; ++ip)
+		{
+			offset += nbytes[ip];
+		}
+
+		// the slabs of the former output of the same file must be on disk before the file is created again
+		if (async)
+		{
+			ModuleIO::output_queue().flush();
+		}
+		if (rank == 0)
+		{
+			const std::string head = pack_header(nspin, is, nx, ny, nz, compression, ef, ucell, startz, nplanes, nbytes);
+			std::ofstream ofs(fn.c_str(), std::ios::binary | std::ios::trunc);
+			ofs.write(head.data(), head.size());
+			ofs.close();
+			if (ofs.fail())
+			{
+				ModuleBase::WARNING("ModuleIO::write_rho_binary","Can't create Output File!");
+			}
+		}
+#ifdef __MPI
+		MPI_Barrier(POOL_WORLD);
+#endif
+
+		if (async)
+		{
+			ModuleIO::output_queue().push(fn, [fn, offset, bytes]() { return write_slab(fn, offset, *bytes); });
+		}
+		else if (!write_slab(fn, offset, *bytes))
+		{
+			ModuleBase::WARNING("ModuleIO::write_rho_binary","Can't write " + fn);
+		}
+	}
+#ifdef __MPI
+	MPI_Barrier(MPI_COMM_WORLD);
+#endif
+
+	ModuleBase::timer::tick("ModuleIO","write_rho_binary");
+	return;
+}
+
+bool ModuleIO::read_rho_binary(
+#ifdef __MPI
+	Parallel_Grid* Pgrid,
+#endif
+	const int& is,
+	const int& nspin,
+	const std::string& fn,
+	double* rho,
+	const int& nx,
+	const int& ny,
+	const int& nz,
+	double& ef,
+	const UnitCell* ucell,
+	int& prenspin,
+	const bool& warning_flag)
+{
+	ModuleBase::TITLE("ModuleIO","read_rho_binary");
+
+	const bool reader = (GlobalV::MY_RANK == 0 || (GlobalV::ESOLVER_TYPE == "sdft" && GlobalV::RANK_IN_STOGROUP == 0));
+	int nx_read = 0;
+	int ny_read = 0;
+	int nz_read = 0;
+	std::vector<std::vector<double>> planes;
+	int ok = 0;
+	if (reader)
+	{
+		ok = read_binary_file(fn, nspin, ucell, warning_flag, ef, prenspin, nx_read, ny_read, nz_read, planes) ? 1 : 0;
+	}
+#ifdef __MPI
+	MPI_Bcast(&ok, 1, MPI_INT, 0, MPI_COMM_WORLD);
+	MPI_Bcast(&ef, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+	MPI_Bcast(&prenspin, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+	if (!ok)
+	{
+		return false;
+	}
+
+	const int nxy = nx * ny;
+	const bool same = (nx == nx_read && ny == ny_read && nz == nz_read);
+	if (reader && !same)
+	{
+		std::vector<const double*> read_rho(nz_read);
+		for (int iz = 0; iz < nz_read; ++iz)
+		{
+			read_rho[iz] = planes[iz].data();
+		}
+		std::vector<std::vector<double>> interpolated(nz, std::vector<double>(nxy));
+#ifdef __MPI
+		std::vector<double*> data(nz);
+		for (int iz = 0; iz < nz; ++iz)
+		{
+			data[iz] = interpolated[iz].data();
+		}
+		ModuleIO::trilinear_interpolate(read_rho.data(), nx_read, ny_read, nz_read, nx, ny, nz, data.data());
+		planes.swap(interpolated);
+#else
+		ModuleIO::trilinear_interpolate(read_rho.data(), nx_read, ny_read, nz_read, nx, ny, nz, rho);
+		return true;
+#endif
+	}
+
+#ifdef __MPI
+	std::vector<double> zpiece;
+	if (!reader)
+	{
+		zpiece.assign(nxy, 0.0);
+	}
+	for (int iz = 0; iz < nz; iz++)
+	{
+		Pgrid->zpiece_to_all(reader ? planes[iz].data() : zpiece.data(), iz, rho);
+	}
+#else
+	GlobalV::ofs_running << " Read SPIN = " << is + 1 << " charge now." << std::endl;
+	for (int iz = 0; iz < nz; iz++)
+	{
+		std::copy(planes[iz].begin(), planes[iz].end(), rho + iz * nxy);
+	}
+#endif
+	return true;
+}
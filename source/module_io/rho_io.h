@@ -40,7 +40,50 @@ namespace ModuleIO
 		const int& nz,
 		const double& ef,
 		const UnitCell* ucell,
-		const int &precision = 11);//mohan add 2007-10-17
+		const int &precision = 11,//mohan add 2007-10-17
+		const bool async = false);
+
+	/// @brief write the charge density in the binary format described in rho_binary.cpp.
+	/// Every process of the first pool writes its own z-slab at an offset computed from the sizes of the slabs
+	/// before it, so the grid is never gathered.
+	/// @param compress compress each slab with zlib, only available if ABACUS is compiled with zlib
+	/// @param async the slabs are written by ModuleIO::output_queue() in the background
+	void write_rho_binary(
+#ifdef __MPI
+		const int& nplane,
+		const int& startz_current,
+#endif
+		const double* rho_save,
+		const int& is,
+		const int& nspin,
+		const std::string& fn,
+		const int& nx,
+		const int& ny,
+		const int& nz,
+		const double& ef,
+		const UnitCell* ucell,
+		const bool compress = false,
+		const bool async = false);
+
+	/// @brief read the charge density written by write_rho_binary, the grid is interpolated if nx, ny, nz differ
+	bool read_rho_binary(
+#ifdef __MPI
+		Parallel_Grid* Pgrid,
+#endif
+		const int& is,
+		const int& nspin,
+		const std::string& fn,
+		double* rho,
+		const int& nx,
+		const int& ny,
+		const int& nz,
+		double& ef,
+		const UnitCell* ucell,
+		int& prenspin,
+		const bool& warning_flag = true);
+
+	/// the binary file corresponding to a cube file, e.g. SPIN1_CHG.cube -> SPIN1_CHG.bin
+	std::string rho_binary_name(const std::string& fn);
 }
 
 #endif
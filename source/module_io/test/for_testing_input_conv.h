@@ -118,6 +118,9 @@ std::vector<double> elecstate::H_TDDFT_pw::heavi_amp; // Ry/bohr
 double Force_Stress_LCAO::force_invalid_threshold_ev = 0.0;
 double BFGS_Basic::relax_bfgs_w1 = -1.0;
 double BFGS_Basic::relax_bfgs_w2 = -1.0;
+std::string BFGS_Basic::relax_bfgs_prec = "none";
+std::string BFGS_Basic::relax_bfgs_hess_in = "none";
+bool BFGS_Basic::out_bfgs_hess = false;
 double Ions_Move_Basic::relax_bfgs_rmax = -1.0;
 double Ions_Move_Basic::relax_bfgs_rmin = -1.0;
 double Ions_Move_Basic::relax_bfgs_init = -1.0;
@@ -346,6 +346,20 @@ TEST_F(InputConvTest,restart_save2 )
 	EXPECT_EQ(GlobalC::restart.info_save.save_charge,true);
 }
 
+TEST_F(InputConvTest,restart_freq )
+{
+	INPUT.Default();
+	std::string input_file = "./support/INPUT";
+	INPUT.Read(input_file);
+	INPUT.restart_save=true;
+	INPUT.restart_load=true;
+	INPUT.restart_freq=5;
+	INPUT.dft_functional = "default";
+	Input_Conv::Convert();
+	EXPECT_EQ(GlobalC::restart.info_save.checkpoint_freq,5);
+	EXPECT_EQ(GlobalC::restart.info_load.load_checkpoint,true);
+}
+
 TEST_F(InputConvTest, restart_load)
 {
 	INPUT.Default();
@@ -31,6 +31,7 @@ TEST_F(InputTest, Default)
 	EXPECT_EQ(INPUT.kpoint_file,"");
 	EXPECT_EQ(INPUT.pseudo_dir,"");
 	EXPECT_EQ(INPUT.orbital_dir,"");
+	EXPECT_EQ(INPUT.cache_dir,"");
 	EXPECT_EQ(INPUT.read_file_dir,"auto");
 	EXPECT_EQ(INPUT.wannier_card,"none");
 	EXPECT_EQ(INPUT.latname,"none");
@@ -38,6 +39,7 @@ TEST_F(InputTest, Default)
 	EXPECT_EQ(INPUT.esolver_type,"ksdft");
 	EXPECT_DOUBLE_EQ(INPUT.pseudo_rcut,15.0);
 	EXPECT_FALSE(INPUT.pseudo_mesh);
+	EXPECT_FALSE(INPUT.pseudo_sbt_fft);
 	EXPECT_EQ(INPUT.ntype,0);
 	EXPECT_EQ(INPUT.nbands,0);
 	EXPECT_EQ(INPUT.nbands_sto,256);
@@ -74,6 +76,8 @@ TEST_F(InputTest, Default)
         EXPECT_DOUBLE_EQ(INPUT.kspacing[1],0.0);
         EXPECT_DOUBLE_EQ(INPUT.kspacing[2],0.0);
         EXPECT_DOUBLE_EQ(INPUT.min_dist_coef,0.2);
+        EXPECT_FALSE(INPUT.ewald_spme);
+        EXPECT_DOUBLE_EQ(INPUT.ewald_spme_tol,1e-8);
         EXPECT_EQ(INPUT.dft_functional,"default");
         EXPECT_DOUBLE_EQ(INPUT.xc_temperature,0.0);
         EXPECT_EQ(INPUT.nspin,1);
@@ -83,6 +87,8 @@ TEST_F(InputTest, Default)
         EXPECT_EQ(INPUT.ks_solver,"default");
         EXPECT_DOUBLE_EQ(INPUT.search_radius,-1.0);
         EXPECT_TRUE(INPUT.search_pbc);
+        EXPECT_DOUBLE_EQ(INPUT.purification_rcut, 20.0);
+        EXPECT_DOUBLE_EQ(INPUT.purification_thr, 1.0e-8);
         EXPECT_EQ(INPUT.symmetry,"default");
         EXPECT_FALSE(INPUT.init_vel);
         EXPECT_DOUBLE_EQ(INPUT.ref_cell_factor,1.0);
@@ -109,6 +115,9 @@ TEST_F(InputTest, Default)
         EXPECT_DOUBLE_EQ(INPUT.relax_bfgs_rmax,0.8);
         EXPECT_DOUBLE_EQ(INPUT.relax_bfgs_rmin,1e-5);
         EXPECT_DOUBLE_EQ(INPUT.relax_bfgs_init,0.5);
+        EXPECT_EQ(INPUT.relax_bfgs_prec,"none");
+        EXPECT_EQ(INPUT.relax_bfgs_hess_in,"none");
+        EXPECT_FALSE(INPUT.out_bfgs_hess);
         EXPECT_DOUBLE_EQ(INPUT.relax_scale_force,0.5);
         EXPECT_EQ(INPUT.nbspline,-1);
         EXPECT_FALSE(INPUT.gamma_only);
@@ -158,6 +167,7 @@ TEST_F(InputTest, Default)
         EXPECT_EQ(INPUT.out_freq_elec,0);
         EXPECT_EQ(INPUT.out_freq_ion,0);
         EXPECT_EQ(INPUT.out_chg,0);
+        EXPECT_EQ(INPUT.out_chg_format,"cube");
         EXPECT_EQ(INPUT.out_dm,0);
         EXPECT_EQ(INPUT.out_dm1,0);
         EXPECT_EQ(INPUT.deepks_out_labels,0);
@@ -248,6 +258,7 @@ TEST_F(InputTest, Default)
         EXPECT_DOUBLE_EQ(INPUT.exx_v_grad_threshold,1E-1);
         EXPECT_DOUBLE_EQ(INPUT.exx_cauchy_force_threshold,1E-7);
         EXPECT_DOUBLE_EQ(INPUT.exx_cauchy_stress_threshold,1E-7);
+        EXPECT_FALSE(INPUT.exx_incremental);
         EXPECT_DOUBLE_EQ(INPUT.exx_ccp_threshold,1E-8);
         EXPECT_EQ(INPUT.exx_ccp_rmesh_times,"default");
         EXPECT_EQ(INPUT.exx_distribute_type,"htime");
@@ -294,6 +305,7 @@ TEST_F(InputTest, Default)
         EXPECT_EQ(INPUT.out_mul,0);
         EXPECT_FALSE(INPUT.restart_save);
         EXPECT_FALSE(INPUT.restart_load);
+        EXPECT_EQ(INPUT.restart_freq, 0);
         EXPECT_FALSE(INPUT.test_skip_ewald);
         EXPECT_FALSE(INPUT.dft_plus_u);
         EXPECT_FALSE(INPUT.yukawa_potential);
@@ -335,6 +347,9 @@ TEST_F(InputTest, Default)
 	EXPECT_EQ(INPUT.mdp.md_dt,1);
 	EXPECT_EQ(INPUT.mdp.md_dumpfreq,1);
 	EXPECT_EQ(INPUT.mdp.md_nraise,1);
+	EXPECT_EQ(INPUT.mdp.md_respa_nstep,1);
+	EXPECT_EQ(INPUT.mdp.md_respa_esolver,"lj");
+	EXPECT_EQ(INPUT.mdp.md_relabel_file,"none");
 	EXPECT_EQ(INPUT.cal_syns,0);
 	EXPECT_EQ(INPUT.dmax,0.01);
 	EXPECT_EQ(INPUT.mdp.md_nstep,10);
@@ -504,6 +519,7 @@ TEST_F(InputTest, Read)
         EXPECT_EQ(INPUT.out_freq_elec,0);
         EXPECT_EQ(INPUT.out_freq_ion,0);
         EXPECT_EQ(INPUT.out_chg,0);
+        EXPECT_EQ(INPUT.out_chg_format,"cube");
         EXPECT_EQ(INPUT.out_dm,0);
         EXPECT_EQ(INPUT.out_dm1,0);
         EXPECT_EQ(INPUT.deepks_out_labels,0);
@@ -639,6 +655,7 @@ TEST_F(InputTest, Read)
         EXPECT_EQ(INPUT.out_mul,0);
         EXPECT_FALSE(INPUT.restart_save);
         EXPECT_FALSE(INPUT.restart_load);
+        EXPECT_EQ(INPUT.restart_freq, 0);
         EXPECT_FALSE(INPUT.test_skip_ewald);
         EXPECT_FALSE(INPUT.dft_plus_u);
         EXPECT_FALSE(INPUT.yukawa_potential);
@@ -683,6 +700,9 @@ TEST_F(InputTest, Read)
 	EXPECT_EQ(INPUT.mdp.md_dt,1);
 	EXPECT_EQ(INPUT.mdp.md_dumpfreq,1);
 	EXPECT_EQ(INPUT.mdp.md_nraise,1);
+	EXPECT_EQ(INPUT.mdp.md_respa_nstep,1);
+	EXPECT_EQ(INPUT.mdp.md_respa_esolver,"lj");
+	EXPECT_EQ(INPUT.mdp.md_relabel_file,"none");
 	EXPECT_EQ(INPUT.cal_syns,0);
 	EXPECT_EQ(INPUT.dmax,0.01);
 	EXPECT_EQ(INPUT.mdp.md_nstep,10);
@@ -1006,6 +1026,15 @@ TEST_F(InputTest, Check)
 	EXPECT_THAT(output,testing::HasSubstr("kspacing must > 0"));
 	INPUT.kspacing[0] = INPUT.kspacing[1] = INPUT.kspacing[2] = 0.8;
 	//
+	INPUT.ewald_spme = true;
+	INPUT.ewald_spme_tol = 0.0;
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("ewald_spme_tol should be between 0 and 1"));
+	INPUT.ewald_spme = false;
+	INPUT.ewald_spme_tol = 1e-8;
+	//
 	INPUT.nelec = -1;
 	testing::internal::CaptureStdout();
 	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
@@ -1089,6 +1118,32 @@ TEST_F(InputTest, Check)
 	EXPECT_THAT(output,testing::HasSubstr("Can not find DP model !"));
 	INPUT.esolver_type = "ksdft";
 	//
+	INPUT.mdp.md_respa_nstep = 0;
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("md_respa_nstep should be a positive integer!"));
+	INPUT.mdp.md_respa_nstep = 2;
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("r-RESPA is only available for md_type = nve, nvt, langevin"));
+	INPUT.mdp.md_type = "nve";
+	INPUT.mdp.md_respa_esolver = "ksdft";
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("md_respa_esolver should be lj or dp"));
+	INPUT.mdp.md_type = "msst";
+	INPUT.mdp.md_respa_esolver = "lj";
+	INPUT.mdp.md_respa_nstep = 1;
+	INPUT.mdp.md_relabel_file = "MD_dump";
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("md_relabel_file is only available for esolver_type = dp"));
+	INPUT.mdp.md_relabel_file = "none";
+	//
 	INPUT.calculation = "gen_bessel";
 	INPUT.basis_type = "lcao";
 	testing::internal::CaptureStdout();
@@ -1111,6 +1166,13 @@ TEST_F(InputTest, Check)
 	EXPECT_THAT(output,testing::HasSubstr("wrong 'init_chg',not 'atomic', 'file',please check"));
 	INPUT.init_chg = "atomic";
 	//
+	INPUT.out_chg_format = "hdf5";
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("out_chg_format should be 'cube', 'binary' or 'binary_zlib'"));
+	INPUT.out_chg_format = "cube";
+	//
 	INPUT.gamma_only_local = 0;
 	INPUT.out_dm = 1;
 	testing::internal::CaptureStdout();
@@ -1258,6 +1320,22 @@ TEST_F(InputTest, Check)
 	output = testing::internal::GetCapturedStdout();
 	EXPECT_THAT(output,testing::HasSubstr("Cusolver can not be used for series version."));
 #endif
+	//
+	INPUT.basis_type = "lcao";
+	INPUT.ks_solver = "purification";
+	INPUT.cal_force = 1;
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("ks_solver = purification only supports scf without force and stress."));
+	INPUT.cal_force = 0;
+	INPUT.cal_stress = 0;
+	INPUT.out_bandgap = 1;
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("ks_solver = purification gives no eigenvalues"));
+	INPUT.out_bandgap = 0;
 	//
 	INPUT.basis_type = "lcao";
 	INPUT.ks_solver = "arbitrary";
@@ -1305,6 +1383,13 @@ TEST_F(InputTest, Check)
 	EXPECT_THAT(output,testing::HasSubstr("relax_method can only be sd, cg, bfgs or cg_bfgs."));
 	INPUT.relax_method = "cg";
 	//
+	INPUT.relax_bfgs_prec = "arbitrary";
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("relax_bfgs_prec can only be none or exp."));
+	INPUT.relax_bfgs_prec = "none";
+	//
 	INPUT.bx = 11; INPUT.by = 1; INPUT.bz = 1;
 	testing::internal::CaptureStdout();
 	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
@@ -164,6 +164,7 @@ TEST_F(InputParaTest,Bcast)
         EXPECT_EQ(INPUT.out_freq_elec,0);
         EXPECT_EQ(INPUT.out_freq_ion,0);
         EXPECT_EQ(INPUT.out_chg,0);
+        EXPECT_EQ(INPUT.out_chg_format,"cube");
         EXPECT_EQ(INPUT.out_dm,0);
         EXPECT_EQ(INPUT.out_dm1,0);
         EXPECT_EQ(INPUT.deepks_out_labels,0);
@@ -300,6 +301,7 @@ TEST_F(InputParaTest,Bcast)
         EXPECT_EQ(INPUT.out_mul,0);
         EXPECT_FALSE(INPUT.restart_save);
         EXPECT_FALSE(INPUT.restart_load);
+        EXPECT_EQ(INPUT.restart_freq, 0);
         EXPECT_FALSE(INPUT.test_skip_ewald);
         EXPECT_FALSE(INPUT.dft_plus_u);
         EXPECT_FALSE(INPUT.yukawa_potential);
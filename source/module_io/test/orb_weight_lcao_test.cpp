@@ -0,0 +1,176 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include <complex>
+#include <vector>
+/************************************************
+ *  unit test of orb_weight_lcao.cpp
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - ModuleIO::cal_orb_weight()
+ *     - w(mu, ib) = Re[ c*(mu, ib) (S c)(mu, ib) ] on the local blocks, real and complex
+ *   - ModuleIO::cal_orb_mulliken()
+ *     - the local contributions sum up to Re[ (D S)(mu, mu) ] for Hermitian D and S, real and complex
+ */
+
+#include "module_io/orb_weight_lcao.h"
+
+class OrbWeightTest : public testing::Test
+{
+  protected:
+    const int nlocal = 10;
+    const int nbands = 6;
+    Parallel_Orbitals pv;
+    std::ofstream ofs_running;
+    void SetUp() override
+    {
+#ifdef __MPI
+        int dsize = 1;
+        MPI_Comm_size(MPI_COMM_WORLD, &dsize);
+        pv.set_block_size(2);
+        pv.set_proc_dim(dsize, 0);
+        pv.mpi_create_cart(MPI_COMM_WORLD);
+        pv.set_local2global(nlocal, nlocal, ofs_running, ofs_running);
+        pv.set_desc(nlocal, nlocal, pv.get_row_size());
+        pv.set_global2local(nlocal, nlocal, true, ofs_running);
+        pv.set_nloc_wfc_Eij(nbands, ofs_running, ofs_running);
+        pv.set_desc_wfc_Eij(nlocal, nbands, pv.get_row_size());
+#else
+        pv.set_serial(nlocal, nlocal);
+        pv.set_global2local(nlocal, nlocal, false, ofs_running);
+        pv.ncol_bands = nbands;
+#endif
+    }
+
+    // a Hermitian overlap matrix and its local block
+    std::complex<double> s_global(const int i, const int j) const
+    {
+        if (i == j)
+        {
+            return 1.0;
+        }
+        const double re = 0.1 / (1 + std::abs(i - j));
+        const double im = 0.02 * (j - i);
+        return std::complex<double>(re, im);
+    }
+    std::complex<double> psi_global(const int mu, const int ib) const
+    {
+        return std::complex<double>(std::cos(0.3 * mu + ib), std::sin(0.7 * mu * ib + 0.1));
+    }
+    template <typename T, typename F>
+    std::vector<T> local_block(const int ncol, F f) const
+    {
+        const int nrow = pv.get_row_size();
+        std::vector<T> local(static_cast<size_t>(nrow) * ncol);
+        for (int ic = 0; ic < ncol; ++ic)
+        {
+            for (int ir = 0; ir < nrow; ++ir)
+            {
+                local[ic * nrow + ir] = f(pv.local2global_row(ir), pv.local2global_col(ic));
+            }
+        }
+        return local;
+    }
+};
+
+TEST_F(OrbWeightTest, WeightComplex)
+{
+    auto s = local_block<std::complex<double>>(pv.get_col_size(), [this](int i, int j) { return s_global(i, j); });
+    auto psi = local_block<std::complex<double>>(pv.ncol_bands, [this](int i, int j) { return psi_global(i, j); });
+    std::vector<double> weight(psi.size());
+    ModuleIO::cal_orb_weight(&pv, nbands, s.data(), psi.data(), weight.data());
+
+    const int nrow = pv.get_row_size();
+    for (int ic = 0; ic < pv.ncol_bands; ++ic)
+    {
+        const int ib = pv.local2global_col(ic);
+        for (int ir = 0; ir < nrow; ++ir)
+        {
+            const int mu = pv.local2global_row(ir);
+            std::complex<double> sc = 0.0;
+            for (int nu = 0; nu < nlocal; ++nu)
+            {
+                sc += s_global(mu, nu) * psi_global(nu, ib);
+            }
+            EXPECT_NEAR(weight[ic * nrow + ir], (std::conj(psi_global(mu, ib)) * sc).real(), 1e-12);
+        }
+    }
+}
+
+TEST_F(OrbWeightTest, WeightReal)
+{
+    auto s = local_block<double>(pv.get_col_size(), [this](int i, int j) { return s_global(i, j).real(); });
+    auto psi = local_block<double>(pv.ncol_bands, [this](int i, int j) { return psi_global(i, j).real(); });
+    std::vector<double> weight(psi.size());
+    ModuleIO::cal_orb_weight(&pv, nbands, s.data(), psi.data(), weight.data());
+
+    const int nrow = pv.get_row_size();
+    for (int ic = 0; ic < pv.ncol_bands; ++ic)
+    {
+        const int ib = pv.local2global_col(ic);
+        for (int ir = 0; ir < nrow; ++ir)
+        {
+            const int mu = pv.local2global_row(ir);
+            double sc = 0.0;
+            for (int nu = 0; nu < nlocal; ++nu)
+            {
+                sc += s_global(mu, nu).real() * psi_global(nu, ib).real();
+            }
+            EXPECT_NEAR(weight[ic * nrow + ir], psi_global(mu, ib).real() * sc, 1e-12);
+        }
+    }
+}
+
+TEST_F(OrbWeightTest, Mulliken)
+{
+    // D = sum_ib c(ib) c(ib)^dagger
+    auto dm_global = [this](const int i, const int j) {
+        std::complex<double> d = 0.0;
+        for (int ib = 0; ib < nbands; ++ib)
+        {
+            d += psi_global(i, ib) * std::conj(psi_global(j, ib));
+        }
+        return d;
+    };
+    auto s = local_block<std::complex<double>>(pv.get_col_size(), [this](int i, int j) { return s_global(i, j); });
+    auto dm = local_block<std::complex<double>>(pv.get_col_size(), dm_global);
+    std::vector<double> mulliken(nlocal, 0.0);
+    ModuleIO::cal_orb_mulliken(&pv, dm.data(), s.data(), mulliken.data());
+
+    auto s_real = local_block<double>(pv.get_col_size(), [this](int i, int j) { return s_global(i, j).real(); });
+    auto dm_real = local_block<double>(pv.get_col_size(), [&dm_global](int i, int j) { return dm_global(i, j).real(); });
+    std::vector<double> mulliken_real(nlocal, 0.0);
+    ModuleIO::cal_orb_mulliken(&pv, dm_real.data(), s_real.data(), mulliken_real.data());
+#ifdef __MPI
+    MPI_Allreduce(MPI_IN_PLACE, mulliken.data(), nlocal, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, mulliken_real.data(), nlocal, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+#endif
+
+    for (int mu = 0; mu < nlocal; ++mu)
+    {
+        std::complex<double> ds = 0.0;
+        double ds_real = 0.0;
+        for (int nu = 0; nu < nlocal; ++nu)
+        {
+            ds += dm_global(mu, nu) * s_global(nu, mu);
+            ds_real += dm_global(mu, nu).real() * s_global(nu, mu).real();
+        }
+        EXPECT_NEAR(mulliken[mu], ds.real(), 1e-12);
+        EXPECT_NEAR(mulliken_real[mu], ds_real, 1e-12);
+    }
+}
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+#endif
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+    return result;
+}
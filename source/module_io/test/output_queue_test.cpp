@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include <atomic>
+#include <fstream>
+#include <sstream>
+/************************************************
+ *  unit test of output_queue.cpp
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - Output_Queue::push_text()
+ *     - the texts are written in the order they are pushed, also in append mode
+ *   - Output_Queue::push()
+ *     - the tasks run in the background and at most max_tasks of them wait in the queue
+ *   - Output_Queue::flush()
+ *     - wait for all tasks and warn about the files that failed
+ *   - Output_Queue(0)
+ *     - the tasks run immediately in push()
+ *   - ~Output_Queue()
+ *     - the pending tasks are written before the queue is destroyed
+ */
+
+#include "module_base/global_variable.h"
+#include "../output_queue.h"
+
+namespace
+{
+std::string read_file(const std::string& file_name)
+{
+	std::ifstream ifs(file_name);
+	std::stringstream ss;
+	ss << ifs.rdbuf();
+	return ss.str();
+}
+}
+
+class OutputQueueTest : public testing::Test
+{
+protected:
+	std::string output_str;
+};
+
+TEST_F(OutputQueueTest, PushText)
+{
+	ModuleIO::Output_Queue queue(2);
+	queue.push_text("output_queue_text.dat", "step 0\n");
+	for (int i = 1; i < 10; ++i)
+	{
+		queue.push_text("output_queue_text.dat", "step " + std::to_string(i) + "\n", true);
+	}
+	queue.flush();
+	EXPECT_EQ(queue.pending(), 0);
+	output_str = read_file("output_queue_text.dat");
+	std::string expected;
+	for (int i = 0; i < 10; ++i)
+	{
+		expected += "step " + std::to_string(i) + "\n";
+	}
+	EXPECT_EQ(output_str, expected);
+	remove("output_queue_text.dat");
+}
+
+TEST_F(OutputQueueTest, Bounded)
+{
+	ModuleIO::Output_Queue queue(1);
+	std::atomic<bool> release(false);
+	std::atomic<int> done(0);
+	// the first task blocks the worker, the second one waits in the queue
+	queue.push("first", [&release, &done]() {
+		while (!release)
+		{
+			std::this_thread::yield();
+		}
+		++done;
+		return true;
+	});
+	queue.push("second", [&done]() {
+		++done;
+		return true;
+	});
+	EXPECT_EQ(queue.pending(), 2);
+	EXPECT_EQ(done, 0);
+	release = true;
+	queue.flush();
+	EXPECT_EQ(queue.pending(), 0);
+	EXPECT_EQ(done, 2);
+}
+
+TEST_F(OutputQueueTest, Failure)
+{
+	GlobalV::MY_RANK = 0;
+	GlobalV::ofs_warning.open("warning.log");
+	ModuleIO::Output_Queue queue(4);
+	queue.push_text("./no_such_directory/output_queue.dat", "content");
+	queue.push("throw", []() -> bool { throw std::runtime_error("failed"); });
+	queue.flush();
+	GlobalV::ofs_warning.close();
+	output_str = read_file("warning.log");
+	EXPECT_THAT(output_str, testing::HasSubstr("Can't write ./no_such_directory/output_queue.dat"));
+	EXPECT_THAT(output_str, testing::HasSubstr("Can't write throw"));
+	remove("warning.log");
+}
+
+TEST_F(OutputQueueTest, Synchronous)
+{
+	ModuleIO::Output_Queue queue(0);
+	queue.push_text("output_queue_sync.dat", "content");
+	EXPECT_EQ(queue.pending(), 0);
+	output_str = read_file("output_queue_sync.dat");
+	EXPECT_EQ(output_str, "content");
+	remove("output_queue_sync.dat");
+}
+
+TEST_F(OutputQueueTest, Destructor)
+{
+	{
+		ModuleIO::Output_Queue queue(4);
+		for (int i = 0; i < 4; ++i)
+		{
+			queue.push_text("output_queue_exit.dat", std::to_string(i), i > 0);
+		}
+	}
+	output_str = read_file("output_queue_exit.dat");
+	EXPECT_EQ(output_str, "0123");
+	remove("output_queue_exit.dat");
+}
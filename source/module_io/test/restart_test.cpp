@@ -0,0 +1,238 @@
+#include "gtest/gtest.h"
+#include "module_base/global_variable.h"
+
+#include <sys/stat.h>
+
+#include <complex>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#ifdef __MPI
+#include "mpi.h"
+#endif
+/************************************************
+ *  unit test of the binary checkpoint in restart.cpp
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - Restart::save_grids() and Restart::load_grids()
+ *     - the grids read back equal those written, also when the z-planes are distributed differently
+ *   - Restart::save_coefs() and Restart::load_coefs()
+ *     - the coefficients read back equal those written, a different size is rejected
+ *   - Restart::commit_checkpoint() and Restart::wait_checkpoint()
+ *     - each checkpoint gets a new sequence number, also in a new job, and the files of the
+ *       previous checkpoint are removed after checkpoint_info refers to the new one
+ *     - a checkpoint that one rank can't write is dropped by all, checkpoint_info keeps the previous one
+ */
+
+#include "module_io/restart.h"
+
+class RestartCheckpointTest : public testing::Test
+{
+  protected:
+    const std::string folder = "./restart_checkpoint_test/";
+    const int nx = 2;
+    const int ny = 3;
+    const int nz = 8;
+    // the z-planes [startz, startz+nplane) written by this rank
+    int startz = 0;
+    int nplane = 0;
+    // spin 2, the full grids stored as data[ixy*nz+iz]
+    std::vector<std::vector<double>> rho;
+    std::vector<std::complex<double>> coef;
+
+    void SetUp() override
+    {
+        if (GlobalV::MY_RANK == 0)
+        {
+            mkdir(folder.c_str(), 0755);
+            std::remove((folder + "checkpoint_info").c_str());
+        }
+        barrier();
+        startz = GlobalV::MY_RANK * nz / GlobalV::NPROC;
+        nplane = (GlobalV::MY_RANK + 1) * nz / GlobalV::NPROC - startz;
+        rho.assign(2, std::vector<double>(nx * ny * nz));
+        for (int is = 0; is < 2; ++is)
+        {
+            for (int i = 0; i < nx * ny * nz; ++i)
+            {
+                rho[is][i] = 0.1 * i - is;
+            }
+        }
+        coef.resize(5);
+        for (int i = 0; i < 5; ++i)
+        {
+            coef[i] = std::complex<double>(i + GlobalV::MY_RANK, -0.5 * i);
+        }
+    }
+    void TearDown() override
+    {
+        // the other ranks may still read the files of this rank
+        barrier();
+        for (int seq = 0; seq < 5; ++seq)
+        {
+            for (const std::string name: {"charge", "mixing"})
+            {
+                std::remove(file(name, seq).c_str());
+            }
+        }
+        barrier();
+        if (GlobalV::MY_RANK == 0)
+        {
+            std::remove((folder + "checkpoint_info").c_str());
+            std::remove(folder.c_str());
+        }
+    }
+    void barrier() const
+    {
+#ifdef __MPI
+        MPI_Barrier(MPI_COMM_WORLD);
+#endif
+    }
+    // the checkpoint file of this rank
+    std::string file(const std::string& name, const int seq) const
+    {
+        return folder + "checkpoint_" + name + "_" + std::to_string(seq) + "_" + std::to_string(GlobalV::MY_RANK);
+    }
+    bool exists(const std::string& name, const int seq) const
+    {
+        return std::ifstream(file(name, seq)).good();
+    }
+    void save(Restart& restart, const int iter)
+    {
+        std::vector<std::vector<double>> rho_local(2, std::vector<double>(nx * ny * nplane));
+        for (int is = 0; is < 2; ++is)
+        {
+            for (int ixy = 0; ixy < nx * ny; ++ixy)
+            {
+                for (int iz = 0; iz < nplane; ++iz)
+                {
+                    rho_local[is][ixy * nplane + iz] = rho[is][ixy * nz + startz + iz];
+                }
+            }
+        }
+        restart.begin_checkpoint();
+        restart.save_grids("charge", nx, ny, nz, startz, nplane, {rho_local[0].data(), rho_local[1].data()});
+        restart.save_coefs("mixing", coef.size(), {coef.data()});
+        Restart::Info_Checkpoint info;
+        info.nproc = GlobalV::NPROC;
+        info.iter = iter;
+        info.mixing_steps = {iter - 1, iter};
+        restart.commit_checkpoint(info);
+        restart.wait_checkpoint();
+    }
+};
+
+TEST_F(RestartCheckpointTest, RoundTrip)
+{
+    Restart restart;
+    restart.folder = folder;
+    save(restart, 3);
+
+    Restart::Info_Checkpoint info;
+    ASSERT_TRUE(restart.load_checkpoint_info(info));
+    EXPECT_EQ(info.nproc, GlobalV::NPROC);
+    EXPECT_EQ(info.seq, 1);
+    EXPECT_EQ(info.iter, 3);
+    EXPECT_EQ(info.mixing_steps, std::vector<int>({2, 3}));
+
+    // each rank reads the z-planes [1,nz-1), which span the planes of several writers
+    const int startz_read = 1;
+    const int nplane_read = nz - 2;
+    std::vector<std::vector<double>> rho_read(2, std::vector<double>(nx * ny * nplane_read, 0.0));
+    ASSERT_TRUE(restart.load_grids(info, "charge", nx, ny, nz, startz_read, nplane_read,
+                                   {rho_read[0].data(), rho_read[1].data()}));
+    for (int is = 0; is < 2; ++is)
+    {
+        for (int ixy = 0; ixy < nx * ny; ++ixy)
+        {
+            for (int iz = 0; iz < nplane_read; ++iz)
+            {
+                EXPECT_DOUBLE_EQ(rho_read[is][ixy * nplane_read + iz], rho[is][ixy * nz + startz_read + iz]);
+            }
+        }
+    }
+    // the number of grids must agree
+    EXPECT_FALSE(restart.load_grids(info, "charge", nx, ny, nz, startz_read, nplane_read, {rho_read[0].data()}));
+
+    std::vector<std::complex<double>> coef_read(coef.size());
+    ASSERT_TRUE(restart.load_coefs(info, "mixing", coef.size(), {coef_read.data()}));
+    EXPECT_EQ(coef_read, coef);
+    EXPECT_FALSE(restart.load_coefs(info, "mixing", coef.size() - 1, {coef_read.data()}));
+}
+
+TEST_F(RestartCheckpointTest, Sequence)
+{
+    {
+        Restart restart;
+        restart.folder = folder;
+        save(restart, 2);
+        save(restart, 4);
+        EXPECT_FALSE(exists("charge", 1));
+        EXPECT_TRUE(exists("charge", 2));
+    }
+
+    // a new job continues the numbering and reads the checkpoint of the last one until its own is complete
+    Restart restart;
+    restart.folder = folder;
+    Restart::Info_Checkpoint info;
+    ASSERT_TRUE(restart.load_checkpoint_info(info));
+    EXPECT_EQ(info.seq, 2);
+    EXPECT_EQ(info.iter, 4);
+    save(restart, 1);
+    EXPECT_FALSE(exists("charge", 2));
+    EXPECT_FALSE(exists("mixing", 2));
+    ASSERT_TRUE(restart.load_checkpoint_info(info));
+    EXPECT_EQ(info.seq, 3);
+    EXPECT_EQ(info.iter, 1);
+
+    // a file of another checkpoint is never taken
+    Restart::Info_Checkpoint info_stale = info;
+    info_stale.seq = 2;
+    std::vector<std::complex<double>> coef_read(coef.size());
+    EXPECT_FALSE(restart.load_coefs(info_stale, "mixing", coef.size(), {coef_read.data()}));
+}
+
+TEST_F(RestartCheckpointTest, FailedWrite)
+{
+    Restart restart;
+    restart.folder = folder;
+    save(restart, 2);
+
+    // the last rank can't create the temporary file of the next checkpoint, while rank 0 writes checkpoint_info
+    const std::string blocker = file("charge", 2) + ".tmp";
+    const bool blocked = (GlobalV::MY_RANK == GlobalV::NPROC - 1);
+    if (blocked)
+    {
+        mkdir(blocker.c_str(), 0755);
+    }
+    save(restart, 3);
+    if (blocked)
+    {
+        std::remove(blocker.c_str());
+    }
+
+    Restart::Info_Checkpoint info;
+    ASSERT_TRUE(restart.load_checkpoint_info(info));
+    EXPECT_EQ(info.seq, 1);
+    EXPECT_EQ(info.iter, 2);
+    EXPECT_FALSE(exists("mixing", 2));
+    std::vector<std::complex<double>> coef_read(coef.size());
+    EXPECT_TRUE(restart.load_coefs(info, "mixing", coef.size(), {coef_read.data()}));
+}
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &GlobalV::NPROC);
+    MPI_Comm_rank(MPI_COMM_WORLD, &GlobalV::MY_RANK);
+#endif
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+    return result;
+}
@@ -0,0 +1,150 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include <complex>
+#include <vector>
+#ifdef __MPI
+#include "mpi.h"
+#endif
+/************************************************
+ *  unit test of to_wannier90_mmn.cpp
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - ModuleIO::get_kb_index()
+ *     - the plane wave kb_index[ig] of k_b is G+G0 for the plane wave G of k, -1 if G+G0 is not in the basis of k_b
+ *   - ModuleIO::shift_psi_kb() and ModuleIO::cal_mmn_local()
+ *     - M_mn = sum_G c*_{m,k}(G) c_{n,k_b}(G+G0), compared with a search over all pairs of plane waves
+ */
+
+#include "module_io/to_wannier90_mmn.h"
+
+class WannierMmnTest : public testing::Test
+{
+  protected:
+    ModulePW::PW_Basis_K wfcpw;
+    const int nks = 3;
+    const int nbands = 3;
+    ModuleBase::Vector3<double> kvec_d[3];
+    void SetUp() override
+    {
+        // k_0 + b = k_b + G0 with b = (0.5, 0, 0), G0 = (1, 0, 0) for k_1 and b = (0, 0, 0.5), G0 = (0, 0, 1) for k_2
+        kvec_d[0].set(0.25, 0.25, 0.25);
+        kvec_d[1].set(-0.25, 0.25, 0.25);
+        kvec_d[2].set(0.25, 0.25, -0.25);
+        ModuleBase::Matrix3 latvec(1, 0, 0, 0, 1.2, 0, 0, 0, 1.5);
+        const double ecut = 20;
+#ifdef __MPI
+        wfcpw.initmpi(1, 0, MPI_COMM_SELF);
+#endif
+        wfcpw.initgrids(5, latvec, 4 * ecut);
+        wfcpw.initparameters(false, ecut, nks, kvec_d, 1, false);
+        wfcpw.setuptransform();
+        wfcpw.collect_local_pw();
+    }
+    std::complex<double> psi(const int ik, const int ib, const int ig) const
+    {
+        return std::complex<double>(std::cos(0.1 * ig + ib + ik), std::sin(0.3 * ig * (ib + 1) - ik));
+    }
+    // the index of the plane wave G+G0 of k_b, found by comparing all the plane waves
+    int find_kb(const int ik, const int ikb, const int ig, const ModuleBase::Vector3<double>& G0) const
+    {
+        const ModuleBase::Vector3<double> g = wfcpw.getgdirect(ik, ig) + G0;
+        for (int igb = 0; igb < wfcpw.npwk[ikb]; ++igb)
+        {
+            if (wfcpw.getgdirect(ikb, igb) == g)
+            {
+                return igb;
+            }
+        }
+        return -1;
+    }
+    void check(const int ik, const int ikb, const int* G0)
+    {
+        const ModuleBase::Vector3<double> G0_vec(G0[0], G0[1], G0[2]);
+        std::vector<int> kb_index;
+        EXPECT_TRUE(ModuleIO::get_kb_index(&wfcpw, ik, ikb, G0, kb_index));
+        const int npw = wfcpw.npwk[ik];
+        ASSERT_EQ(kb_index.size(), static_cast<size_t>(npw));
+        int nfound = 0;
+        for (int ig = 0; ig < npw; ++ig)
+        {
+            EXPECT_EQ(kb_index[ig], find_kb(ik, ikb, ig, G0_vec));
+            nfound += (kb_index[ig] >= 0);
+        }
+        // most of the sphere of k overlaps the shifted sphere of k_b
+        EXPECT_GT(nfound, npw / 2);
+
+        const int npwx = wfcpw.npwk_max;
+        std::vector<std::complex<double>> psi_k(npwx * nbands), psi_kb(npwx * nbands);
+        for (int ib = 0; ib < nbands; ++ib)
+        {
+            for (int ig = 0; ig < npwx; ++ig)
+            {
+                psi_k[ib * npwx + ig] = psi(ik, ib, ig);
+                psi_kb[ib * npwx + ig] = psi(ikb, ib, ig);
+            }
+        }
+        std::vector<std::complex<double>> psi_shift(npw * nbands);
+        ModuleIO::shift_psi_kb(kb_index, nbands, psi_kb.data(), npwx, psi_shift.data(), npw);
+        std::vector<std::complex<double>> mmn(nbands * nbands);
+        ModuleIO::cal_mmn_local(nbands, npw, psi_k.data(), npwx, psi_shift.data(), npw, mmn.data());
+
+        for (int n = 0; n < nbands; ++n)
+        {
+            for (int m = 0; m < nbands; ++m)
+            {
+                std::complex<double> ref = 0.0;
+                for (int ig = 0; ig < npw; ++ig)
+                {
+                    const int igb = find_kb(ik, ikb, ig, G0_vec);
+                    if (igb >= 0)
+                    {
+                        ref += std::conj(psi(ik, m, ig)) * psi(ikb, n, igb);
+                    }
+                }
+                EXPECT_NEAR(mmn[m + n * nbands].real(), ref.real(), 1e-10);
+                EXPECT_NEAR(mmn[m + n * nbands].imag(), ref.imag(), 1e-10);
+            }
+        }
+    }
+};
+
+TEST_F(WannierMmnTest, ShiftX)
+{
+    const int G0[3] = {1, 0, 0};
+    check(0, 1, G0);
+}
+
+TEST_F(WannierMmnTest, ShiftZ)
+{
+    const int G0[3] = {0, 0, 1};
+    check(0, 2, G0);
+}
+
+TEST_F(WannierMmnTest, NoShift)
+{
+    // with G0 = 0 the plane waves of k are mapped onto themselves, and M is the overlap of the coefficients
+    const int G0[3] = {0, 0, 0};
+    std::vector<int> kb_index;
+    EXPECT_TRUE(ModuleIO::get_kb_index(&wfcpw, 0, 0, G0, kb_index));
+    for (int ig = 0; ig < wfcpw.npwk[0]; ++ig)
+    {
+        EXPECT_EQ(kb_index[ig], ig);
+    }
+    check(0, 0, G0);
+}
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+#endif
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+    return result;
+}
@@ -81,6 +81,7 @@ TEST_F(write_input,print)
         EXPECT_THAT(output,testing::HasSubstr("init_chg                       atomic #start charge is from 'atomic' or file"));
         EXPECT_THAT(output,testing::HasSubstr("chg_extrap                     atomic #atomic; first-order; second-order; dm:coefficients of SIA"));
         EXPECT_THAT(output,testing::HasSubstr("out_chg                        0 #>0 output charge density for selected electron steps"));
+        EXPECT_THAT(output,testing::HasSubstr("out_chg_format                 cube #format of the charge density files: cube, binary or binary_zlib"));
         EXPECT_THAT(output,testing::HasSubstr("out_pot                        2 #output realspace potential"));
         EXPECT_THAT(output,testing::HasSubstr("out_wfc_pw                     0 #output wave functions"));
         EXPECT_THAT(output,testing::HasSubstr("out_wfc_r                      0 #output wave functions in realspace"));
@@ -46,6 +46,10 @@ Magnetism::~Magnetism()
  *   - trilinear_interpolate()
  *     - the trilinear interpolation method
  *     - the serial version without MPI
+ *   - write_rho_binary(), read_rho_binary()
+ *     - the binary file is read back exactly, also with zlib if available
+ *     - read_rho() reads the binary file if there is no cube file
+ *     - a file of a wrong format is rejected
  */
 
 class RhoIOTest : public ::testing::Test
@@ -138,4 +142,43 @@ TEST_F(RhoIOTest, TrilinearInterpolate)
     EXPECT_DOUBLE_EQ(data[0], 0.0010824725010374092);
     EXPECT_DOUBLE_EQ(data[10], 0.058649850374240906);
     EXPECT_DOUBLE_EQ(data[100], 0.018931708073604996);
-}
\ No newline at end of file
+}
+TEST_F(RhoIOTest, Binary)
+{
+    int is = 0;
+    std::string fn = "./support/SPIN1_CHG.cube";
+    int nx = 36;
+    int ny = 36;
+    int nz = 36;
+    double ef;
+    UcellTestPrepare utp = UcellTestLib["Si"];
+    ucell = utp.SetUcellInfo();
+    ModuleIO::read_rho(is, nspin, fn, rho[is], nx, ny, nz, ef, ucell, prenspin);
+    GlobalV::MY_RANK = 0;
+    std::vector<double> rho_read(nrxx);
+    std::vector<bool> compress = {false};
+#ifdef __ZLIB
+    compress.push_back(true);
+#endif
+    for (const bool zlib: compress)
+    {
+        ModuleIO::write_rho_binary(rho[is], is, nspin, "SPIN1_CHG.bin", nx, ny, nz, ef, ucell, zlib);
+        double ef_read = 0.0;
+        EXPECT_TRUE(ModuleIO::read_rho_binary(is, nspin, "SPIN1_CHG.bin", rho_read.data(), nx, ny, nz, ef_read,
+                                              ucell, prenspin));
+        EXPECT_DOUBLE_EQ(ef_read, 0.461002);
+        for (int ir = 0; ir < nrxx; ++ir)
+        {
+            EXPECT_EQ(rho_read[ir], rho[is][ir]);
+        }
+    }
+    // there is no SPIN1_CHG.cube in the working directory
+    std::fill(rho_read.begin(), rho_read.end(), 0.0);
+    ModuleIO::read_rho(is, nspin, "SPIN1_CHG.cube", rho_read.data(), nx, ny, nz, ef, ucell, prenspin);
+    EXPECT_DOUBLE_EQ(rho_read[0], 1.27020863940e-03);
+    EXPECT_DOUBLE_EQ(rho_read[46655], 1.33581335706e-02);
+    remove("SPIN1_CHG.bin");
+    // a cube file is not a binary file
+    EXPECT_FALSE(ModuleIO::read_rho_binary(is, nspin, fn, rho_read.data(), nx, ny, nz, ef, ucell, prenspin));
+    EXPECT_EQ(ModuleIO::rho_binary_name("OUT.abacus/SPIN2_CHG.cube"), "OUT.abacus/SPIN2_CHG.bin");
+}
@@ -1,6 +1,8 @@
 #include "to_wannier90.h"
+#include "to_wannier90_mmn.h"
 
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
+#include "module_base/blas_connector.h"
 #include "module_base/math_integral.h"
 #include "module_base/math_polyint.h"
 #include "module_base/math_sphbes.h"
@@ -687,37 +689,40 @@ void toWannier90::cal_Amn(const psi::Psi<std::complex<double>>& psi_pw, const Mo
     // cal_num_kpts << std::endl;
     // test by jingan
 
+    // A_mn(k) = <psi_{m,k}|g_n(k)>, one ZGEMM per k-point
+    const int nbands = GlobalV::NBANDS;
+    std::vector<std::complex<double>> amn(nbands * num_wannier);
     for (int ik = start_k_index; ik < (cal_num_kpts + start_k_index); ik++)
     {
-        for (int iw = 0; iw < num_wannier; iw++)
-        {
-            int index_band = 0;
-            for (int ib = 0; ib < GlobalV::NBANDS; ib++)
-            {
-                if (!tag_cal_band[ib])
-                    continue;
-                index_band++;
-                std::complex<double> amn(0.0, 0.0);
-                std::complex<double> amn_tem(0.0, 0.0);
-                for (int ig = 0; ig < pwNumberMax; ig++)
-                {
-                    int cal_ik = ik - start_k_index;
-                    amn_tem = amn_tem + conj(psi_pw(ik, ib, ig)) * trial_orbitals[cal_ik](iw, ig);
-                }
+        const int cal_ik = ik - start_k_index;
+        const int npw = wfcpw->npwk[ik];
+        const char trans_c = 'C';
+        const char trans_n = 'N';
+        const std::complex<double> one(1.0, 0.0);
+        const std::complex<double> zero(0.0, 0.0);
+        const int ld_psi = psi_pw.get_nbasis();
+        zgemm_(&trans_c, &trans_n, &nbands, &num_wannier, &npw,
+               &one, &psi_pw(ik, 0, 0), &ld_psi, trial_orbitals[cal_ik].c, &pwNumberMax,
+               &zero, amn.data(), &nbands);
 #ifdef __MPI
-                MPI_Allreduce(&amn_tem, &amn, 1, MPI_DOUBLE_COMPLEX, MPI_SUM, POOL_WORLD);
-#else
-                amn = amn_tem;
+        MPI_Allreduce(MPI_IN_PLACE, amn.data(), nbands * num_wannier, MPI_DOUBLE_COMPLEX, MPI_SUM, POOL_WORLD);
 #endif
-                if (GlobalV::MY_RANK == 0)
+
+        if (GlobalV::MY_RANK == 0)
+        {
+            for (int iw = 0; iw < num_wannier; iw++)
+            {
+                int index_band = 0;
+                for (int ib = 0; ib < nbands; ib++)
                 {
+                    if (!tag_cal_band[ib])
+                        continue;
+                    index_band++;
+                    const std::complex<double>& value = amn[ib + iw * nbands];
                     Amn_file << std::setw(5) << index_band << std::setw(5) << iw + 1 << std::setw(5)
-                             << ik + 1 - start_k_index << std::setw(18) << std::showpoint << std::fixed << std::setprecision(12)
-                             << amn.real() << std::setw(18) << std::showpoint << std::fixed << std::setprecision(12)
-                             << amn.imag()
-                             // jingan test
-                             //<< "   " << std::setw(18) << std::setprecision(13) << std::abs(amn)
-                             << std::endl;
+                             << ik + 1 - start_k_index << std::setw(18) << std::showpoint << std::fixed
+                             << std::setprecision(12) << value.real() << std::setw(18) << std::showpoint
+                             << std::fixed << std::setprecision(12) << value.imag() << std::endl;
                 }
             }
         }
@@ -770,11 +775,22 @@ void toWannier90::cal_Mmn(const psi::Psi<std::complex<double>>& psi_pw,
     }
     */
 
+    // M_mn(k,b) = <u_{m,k}|u_{n,k+b}> = \sum_G c*_{m,k}(G) c_{n,k_b}(G+G0) with k+b = k_b + G0.
+    // The coefficients of k_b are gathered onto the plane waves of k, and the whole matrix
+    // of a (k,b) pair is obtained by one ZGEMM and reduced once.
+    const int nbands = GlobalV::NBANDS;
+    std::vector<std::complex<double>> mmn(nbands * nbands);
+    std::vector<std::complex<double>> psi_shift;
+    std::vector<int> kb_index;
     for (int ik = 0; ik < cal_num_kpts; ik++)
     {
+        const int cal_ik = ik + start_k_index;
+        const int npw = wfcpw->npwk[cal_ik];
+        psi_shift.resize(std::max(npw, 1) * nbands);
         for (int ib = 0; ib < nntot; ib++)
         {
             int ikb = nnlist[ik][ib];
+            const int cal_ikb = ikb + start_k_index;
 
             ModuleBase::Vector3<double> phase_G = nncell[ik][ib];
 
@@ -784,78 +800,68 @@ void toWannier90::cal_Mmn(const psi::Psi<std::complex<double>>& psi_pw,
                          << std::setw(5) << int(phase_G.y) << std::setw(5) << int(phase_G.z) << std::endl;
             }
 
-            for (int m = 0; m < GlobalV::NBANDS; m++)
+            const int G0[3] = {static_cast<int>(std::round(phase_G.x)),
+                               static_cast<int>(std::round(phase_G.y)),
+                               static_cast<int>(std::round(phase_G.z))};
+            int local = ModuleIO::get_kb_index(wfcpw, cal_ik, cal_ikb, G0, kb_index);
+#ifdef __MPI
+            MPI_Allreduce(MPI_IN_PLACE, &local, 1, MPI_INT, MPI_MIN, POOL_WORLD);
+#endif
+            if (local)
             {
-                if (!tag_cal_band[m])
-                    continue;
-                // (1) set value
-                std::complex<double>* psir = new std::complex<double>[wfcpw->nmaxgr];
-                std::complex<double>* phase = new std::complex<double>[wfcpw->nmaxgr];
-                ModuleBase::GlobalFunc::ZEROS(phase, wfcpw->nmaxgr);
-                ModuleBase::GlobalFunc::ZEROS(psir, wfcpw->nmaxgr);
-                int cal_ik = ik + start_k_index;
-                int cal_ikb = ikb + start_k_index;
-                // get the phase value in realspace
-                for (int ig = 0; ig < wfcpw->npwk[cal_ik]; ig++)
-                {
-                    if (wfcpw->getgdirect(cal_ik,ig) == -phase_G) // It should be used carefully. We cannot judge if two double are equal.
+                ModuleIO::shift_psi_kb(kb_index, nbands, &psi_pw(cal_ikb, 0, 0), psi_pw.get_nbasis(), psi_shift.data(), npw);
+            }
+            else
+            {
+                // some G+G0 are on the sticks of other processes: multiply by exp(-i*G0*r) in real space
+                std::vector<std::complex<double>> phase(wfcpw->nmaxgr, std::complex<double>(0.0, 0.0));
+                std::vector<std::complex<double>> psir(wfcpw->nmaxgr);
+                for (int ig = 0; ig < npw; ig++)
+                {
+                    if (wfcpw->getgdirect(cal_ik, ig) == -phase_G)
                     {
                         phase[ig] = std::complex<double>(1.0, 0.0);
                         break;
                     }
                 }
-
-                // (2) fft and get value
-                wfcpw->recip2real(phase, phase, cal_ik);
-                //wfcpw->recip2real(&psi_pw(ik, iband_L, 0), psir, ik);
-                wfcpw->recip2real(&psi_pw(cal_ikb, m, 0), psir, cal_ikb);
-
-                for (int ir = 0; ir < wfcpw->nrxx; ir++)
-                {
-                    psir[ir] *= phase[ir];
-                }
-
-                //wfcpw->real2recip(psir, psir, ikb); //ikb, not ik
-                wfcpw->real2recip(psir, psir, cal_ik);
-                for (int n = 0; n < GlobalV::NBANDS; n++)
+                wfcpw->recip2real(phase.data(), phase.data(), cal_ik);
+                for (int n = 0; n < nbands; n++)
                 {
                     if (!tag_cal_band[n])
                         continue;
-                    std::complex<double> mmn(0.0, 0.0);
-
-                    if (!gamma_only_wannier)
+                    wfcpw->recip2real(&psi_pw(cal_ikb, n, 0), psir.data(), cal_ikb);
+                    for (int ir = 0; ir < wfcpw->nrxx; ir++)
                     {
-                        // int cal_ik = ik + start_k_index;
-                        // int cal_ikb = ikb + start_k_index;
-                        // test by jingan
-                        // GlobalV::ofs_running << __FILE__ << __LINE__ << "cal_ik = " << cal_ik << "cal_ikb = " <<
-                        // cal_ikb << std::endl;
-                        // test by jingan
-                        // std::complex<double> *unk_L_r = new std::complex<double>[wfcpw->nrxx];
-                        // ToRealSpace(cal_ik,n,psi_pw,unk_L_r,phase_G);
-                        // mmn = unkdotb(unk_L_r,cal_ikb,m,psi_pw);
-                        mmn = unkdotkb(wfcpw, cal_ik, cal_ikb, n, m, psir, phase, phase_G, psi_pw);
-                        // delete[] unk_L_r;
-                    }
-                    else
-                    {
-                        // GlobalV::ofs_running << "gamma only test" << std::endl;
-                        // mmn = Mmn(n,m);
+                        psir[ir] *= phase[ir];
                     }
+                    wfcpw->real2recip(psir.data(), &psi_shift[n * npw], cal_ik);
+                }
+            }
 
-                    if (GlobalV::MY_RANK == 0)
+            // mmn[m + n * nbands] = M_mn
+            ModuleIO::cal_mmn_local(nbands, npw, &psi_pw(cal_ik, 0, 0), psi_pw.get_nbasis(),
+                                    psi_shift.data(), std::max(npw, 1), mmn.data());
+#ifdef __MPI
+            MPI_Allreduce(MPI_IN_PLACE, mmn.data(), nbands * nbands, MPI_DOUBLE_COMPLEX, MPI_SUM, POOL_WORLD);
+#endif
+
+            if (GlobalV::MY_RANK == 0)
+            {
+                for (int n = 0; n < nbands; n++)
+                {
+                    if (!tag_cal_band[n])
+                        continue;
+                    for (int m = 0; m < nbands; m++)
                     {
-                        mmn_file << std::setw(18) << std::setprecision(12) << std::showpoint << std::fixed << mmn.real()
-                                 << std::setw(18) << std::setprecision(12) << std::showpoint << std::fixed
-                                 << mmn.imag()
-                                 // jingan test
-                                 //<< "    " << std::setw(12) << std::setprecision(9) << std::abs(mmn)
-                                 << std::endl;
+                        if (!tag_cal_band[m])
+                            continue;
+                        const std::complex<double>& value = mmn[m + n * nbands];
+                        mmn_file << std::setw(18) << std::setprecision(12) << std::showpoint << std::fixed
+                                 << value.real() << std::setw(18) << std::setprecision(12) << std::showpoint
+                                 << std::fixed << value.imag() << std::endl;
                     }
-                }//n
-                delete[] psir;
-                delete[] phase;
-            }//m
+                }
+            }
         }
     }
 
@@ -1683,69 +1689,6 @@ std::complex<double> toWannier90::unkdotb(const std::complex<double> *psir,
     return result;
 }
 */
-std::complex<double> toWannier90::unkdotkb(const ModulePW::PW_Basis_K* wfcpw,
-                                           const int& ik,
-                                           const int& ikb,
-                                           const int& iband_L,
-                                           const int& iband_R,
-                                           std::complex<double>* psir,
-                                           std::complex<double>* phase,
-                                           const ModuleBase::Vector3<double> G,
-                                           const psi::Psi<std::complex<double>>& psi_pw)
-/*
-Calculate and print <u_{n,k}|u_{u,k+b}> required by Wannier90.
-*/
-{
-    // (1) set value
-    std::complex<double> result(0.0, 0.0);
-    // std::complex<double>* psir = new std::complex<double>[wfcpw->nmaxgr];
-    // std::complex<double>* phase = new std::complex<double>[wfcpw->nmaxgr];
-    // ModuleBase::GlobalFunc::ZEROS(phase, wfcpw->nmaxgr);
-    // ModuleBase::GlobalFunc::ZEROS(psir, wfcpw->nmaxgr);
-
-    // // get the phase value in realspace
-    // for (int ig = 0; ig < wfcpw->npwk[ik]; ig++)
-    // {
-    //     if (wfcpw->getgdirect(ik,ig) == -G) // It should be used carefully. We cannot judge if two double are equal.
-    //     {
-    //         phase[ig] = std::complex<double>(1.0, 0.0);
-    //         break;
-    //     }
-    // }
-
-    // // (2) fft and get value
-    // wfcpw->recip2real(phase, phase, ik);
-    // //wfcpw->recip2real(&psi_pw(ik, iband_L, 0), psir, ik);
-    // wfcpw->recip2real(&psi_pw(ikb, iband_R, 0), psir, ikb);
-
-    // for (int ir = 0; ir < wfcpw->nrxx; ir++)
-    // {
-    //     psir[ir] *= phase[ir];
-    // }
-
-    // //wfcpw->real2recip(psir, psir, ikb); //ikb, not ik
-    // wfcpw->real2recip(psir, psir, ik);
-
-    std::complex<double> result_tem(0.0, 0.0);
-
-    // for (int ig = 0; ig <wfcpw->npwk[ikb]; ig++)
-    // {
-    //     result_tem = result_tem + conj(psir[ig]) * psi_pw(ikb, iband_R, ig);
-    // }
-    for (int ig = 0; ig <wfcpw->npwk[ik]; ig++)
-    {
-        result_tem = result_tem + psir[ig] * conj(psi_pw(ik, iband_L, ig));
-    }
-#ifdef __MPI
-    MPI_Allreduce(&result_tem, &result, 1, MPI_DOUBLE_COMPLEX, MPI_SUM, POOL_WORLD);
-#else
-    result = result_tem;
-#endif
-    // delete[] psir;
-    // delete[] phase;
-    return result;
-}
-
 /*
 std::complex<double> toWannier90::gamma_only_cal(const int &ib_L,
                                                    const int &ib_R,
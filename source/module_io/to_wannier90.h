@@ -119,15 +119,6 @@ class toWannier90
     // void ToRealSpace(const int &ik, const int &ib, const ModuleBase::ComplexMatrix *evc, std::complex<double> *psir,
     // const ModuleBase::Vector3<double> G); std::complex<double> unkdotb(const std::complex<double> *psir, const int
     // ikb, const int bandindex, const ModuleBase::ComplexMatrix *psi_pw);
-    std::complex<double> unkdotkb(const ModulePW::PW_Basis_K* wfcpw,
-                                  const int& ik,
-                                  const int& ikb,
-                                  const int& iband_L,
-                                  const int& iband_R,
-                                  std::complex<double>* psir,
-                                  std::complex<double>* phase,
-                                  const ModuleBase::Vector3<double> G,
-                                  const psi::Psi<std::complex<double>>& psi_pw);
     // std::complex<double> gamma_only_cal(const int &ib_L, const int &ib_R, const ModuleBase::ComplexMatrix *psi_pw,
     // const ModuleBase::Vector3<double> G);
 
@@ -0,0 +1,88 @@
+#include "to_wannier90_mmn.h"
+
+#include "module_base/blas_connector.h"
+
+namespace ModuleIO
+{
+bool get_kb_index(const ModulePW::PW_Basis_K* wfcpw,
+                  const int ik,
+                  const int ikb,
+                  const int* G0,
+                  std::vector<int>& kb_index)
+{
+    const int nz = wfcpw->nz;
+    const int npwx = wfcpw->npwk_max;
+
+    // (is, iz) of the sticks on this process -> index of the plane wave of k_b
+    std::vector<int> isz2ig(wfcpw->nstnz, -1);
+    for (int ig = 0; ig < wfcpw->npwk[ikb]; ig++)
+    {
+        isz2ig[wfcpw->igl2isz_k[ikb * npwx + ig]] = ig;
+    }
+    std::vector<int> fftixy2is(wfcpw->fftnxy);
+    wfcpw->getfftixy2is(fftixy2is.data());
+
+    bool local = true;
+    kb_index.resize(wfcpw->npwk[ik]);
+    for (int ig = 0; ig < wfcpw->npwk[ik]; ig++)
+    {
+        const int isz = wfcpw->igl2isz_k[ik * npwx + ig];
+        const int ixy = wfcpw->is2fftixy[isz / nz];
+        const int ix = ((ixy / wfcpw->fftny + G0[0]) % wfcpw->fftnx + wfcpw->fftnx) % wfcpw->fftnx;
+        const int iy = ((ixy % wfcpw->fftny + G0[1]) % wfcpw->fftny + wfcpw->fftny) % wfcpw->fftny;
+        const int iz = ((isz % nz + G0[2]) % nz + nz) % nz;
+        const int ixy_kb = iy + ix * wfcpw->fftny;
+        const int is_kb = fftixy2is[ixy_kb];
+        if (is_kb >= 0)
+        {
+            kb_index[ig] = isz2ig[is_kb * nz + iz];
+        }
+        else
+        {
+            kb_index[ig] = -1;
+            // the stick of G+G0 belongs to another process
+            if (wfcpw->fftixy2ip[ixy_kb] >= 0)
+            {
+                local = false;
+            }
+        }
+    }
+    return local;
+}
+
+void shift_psi_kb(const std::vector<int>& kb_index,
+                  const int nbands,
+                  const std::complex<double>* psi_kb,
+                  const int ld_kb,
+                  std::complex<double>* psi_shift,
+                  const int ld_shift)
+{
+    const int npw = kb_index.size();
+    for (int n = 0; n < nbands; n++)
+    {
+        const std::complex<double>* in = psi_kb + n * ld_kb;
+        std::complex<double>* out = psi_shift + n * ld_shift;
+        for (int ig = 0; ig < npw; ig++)
+        {
+            out[ig] = (kb_index[ig] >= 0) ? in[kb_index[ig]] : std::complex<double>(0.0, 0.0);
+        }
+    }
+}
+
+void cal_mmn_local(const int nbands,
+                   const int npw,
+                   const std::complex<double>* psi_k,
+                   const int ld_psi,
+                   const std::complex<double>* psi_shift,
+                   const int ld_shift,
+                   std::complex<double>* mmn)
+{
+    const char trans_c = 'C';
+    const char trans_n = 'N';
+    const std::complex<double> one(1.0, 0.0);
+    const std::complex<double> zero(0.0, 0.0);
+    zgemm_(&trans_c, &trans_n, &nbands, &nbands, &npw,
+           &one, psi_k, &ld_psi, psi_shift, &ld_shift,
+           &zero, mmn, &nbands);
+}
+} // namespace ModuleIO
@@ -0,0 +1,46 @@
+#ifndef TO_WANNIER90_MMN_H
+#define TO_WANNIER90_MMN_H
+
+#include <complex>
+#include <vector>
+
+#include "module_basis/module_pw/pw_basis_k.h"
+
+/**
+ * Plane-wave kernels of the Wannier90 overlaps
+ * M_mn(k,b) = <u_{m,k}|u_{n,k+b}> = \sum_G c*_{m,k}(G) c_{n,k_b}(G+G0), with k+b = k_b + G0.
+ * The coefficients of k_b are gathered onto the plane waves of k, then the whole matrix of a
+ * (k,b) pair is one ZGEMM; the caller reduces it over the processes of the pool.
+ */
+namespace ModuleIO
+{
+/// @brief kb_index[ig] is the index of the plane wave G+G0 of k_b for the plane wave G of k,
+/// -1 if it is not in the basis of k_b. G+G0 is wrapped into the FFT box, as is done by the FFT.
+/// @return false if some G+G0 are on sticks of other processes
+bool get_kb_index(const ModulePW::PW_Basis_K* wfcpw,
+                  const int ik,
+                  const int ikb,
+                  const int* G0,
+                  std::vector<int>& kb_index);
+
+/// @brief psi_shift(ig, n) = psi_kb(kb_index[ig], n), or 0 if kb_index[ig] < 0
+/// @param ld_kb the leading dimension of psi_kb
+/// @param ld_shift the leading dimension of psi_shift, at least kb_index.size()
+void shift_psi_kb(const std::vector<int>& kb_index,
+                  const int nbands,
+                  const std::complex<double>* psi_kb,
+                  const int ld_kb,
+                  std::complex<double>* psi_shift,
+                  const int ld_shift);
+
+/// @brief the local part of M_mn, mmn[m + n * nbands] = \sum_ig conj(psi_k(ig, m)) psi_shift(ig, n)
+void cal_mmn_local(const int nbands,
+                   const int npw,
+                   const std::complex<double>* psi_k,
+                   const int ld_psi,
+                   const std::complex<double>* psi_shift,
+                   const int ld_shift,
+                   std::complex<double>* mmn);
+} // namespace ModuleIO
+
+#endif
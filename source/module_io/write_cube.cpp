@@ -1,6 +1,45 @@
 #include "module_io/cube_io.h"
+#include "module_io/output_queue.h"
 #include "module_base/element_name.h"
 
+#include <memory>
+
+namespace
+{
+// write the header and the data of nx*ny*nz points, the inner loop is z index, followed by y index, x index in turn
+bool write_cube_file(const std::string& fn,
+                     const std::string& head,
+                     const double* data_cube,
+                     const int nx,
+                     const int ny,
+                     const int nz,
+                     const int precision)
+{
+	std::ofstream ofs_cube(fn.c_str());
+	if (!ofs_cube)
+	{
+		return false;
+	}
+	ofs_cube << head;
+	ofs_cube << std::setprecision(precision);
+	ofs_cube << std::scientific;
+	for(int ix=0; ix<nx; ix++)
+	{
+		for(int iy=0; iy<ny; iy++)
+		{
+			for (int iz=0; iz<nz; iz++)
+			{
+				ofs_cube << " " << data_cube[iz*nx*ny+ix*ny+iy];
+				if(iz%6==5 && iz!=nz-1) ofs_cube << "\n";
+			}
+			ofs_cube << "\n";
+		}
+	}
+	ofs_cube.close();
+	return !ofs_cube.fail();
+}
+}
+
 void ModuleIO::write_cube(
 #ifdef __MPI
 	const int& bz,
@@ -19,24 +58,18 @@ void ModuleIO::write_cube(
 	const double& ef,
 	const UnitCell* ucell,
 	const int &precision,
-	const int &out_fermi)
+	const int &out_fermi,
+	const bool async)
 {
 	ModuleBase::TITLE("ModuleIO","write_cube");
 
 	time_t start, end;
-	std::ofstream ofs_cube;
+	std::stringstream ofs_cube;
   
 	if(GlobalV::MY_RANK==0)
 	{
 		start = time(NULL);
 
-		ofs_cube.open(fn.c_str());
-		
-		if (!ofs_cube)
-		{
-				ModuleBase::WARNING("ModuleIO::write_cube","Can't create Output File!");
-		}	
-
 		/// output header for cube file
 		ofs_cube << "Cubefile created from ABACUS SCF calculation. The inner loop is z index, followed by y index, x index in turn." << std::endl;
 		// ofs_cube << "Contains the selected quantity on a FFT grid" << std::endl;
@@ -112,11 +145,12 @@ void ModuleIO::write_cube(
 						 << " " << fac*ucell->atoms[it].tau[ia].z << std::endl;
 			}
 		}
-		ofs_cube.unsetf(std::ostream::fixed);
-		ofs_cube << std::setprecision(precision);
-		ofs_cube << std::scientific;
 	}
 
+	/// the gathered data, only allocated on rank 0.
+	/// With async, the worker of ModuleIO::output_queue() keeps it until the file is written.
+	std::shared_ptr<std::vector<double>> data_cube = std::make_shared<std::vector<double>>();
+
 #ifdef __MPI
 //	for(int ir=0; ir<rhopw->nrxx; ir++) chr.rho[0][ir]=1; // for testing
 //	GlobalV::ofs_running << "\n GlobalV::RANK_IN_POOL = " << GlobalV::RANK_IN_POOL;
@@ -125,10 +159,10 @@ void ModuleIO::write_cube(
 	if(GlobalV::MY_POOL==0)
 	{
 		/// for cube file
-		int nxyz = nx * ny * nz;
-		double* data_cube = new double[nxyz];
-		ModuleBase::GlobalFunc::ZEROS(data_cube, nxyz);
-		/// for cube file
+		if(GlobalV::MY_RANK==0)
+		{
+			data_cube->resize(nx * ny * nz, 0.0);
+		}
 	
 		// num_z: how many planes on processor 'ip'
     		int *num_z = new int[GlobalV::NPROC_IN_POOL];
@@ -221,7 +255,7 @@ void ModuleIO::write_cube(
 				/// for cube file
 				for(int ir=0; ir<nxy; ir++)
 				{
-					data_cube[ir+iz*nxy]=zpiece[ir];
+					(*data_cube)[ir+iz*nxy]=zpiece[ir];
 				}
 				/// for cube file
 			}
@@ -230,49 +264,35 @@ void ModuleIO::write_cube(
 		delete[] which_ip;
 		delete[] num_z;
 		delete[] start_z;
-		// for cube file
-		if(GlobalV::MY_RANK==0)
-		{
-			for(int ix=0; ix<nx; ix++)
-			{
-				for(int iy=0; iy<ny; iy++)
-				{
-					for (int iz=0; iz<nz; iz++)
-					{
-						ofs_cube << " " << data_cube[iz*nx*ny+ix*ny+iy];
-						if(iz%6==5 && iz!=nz-1) ofs_cube << "\n";
-					}
-					ofs_cube << "\n";
-				}
-			}
-		}
-		delete[] data_cube;
-		/// for cube file
 	}
 	MPI_Barrier(MPI_COMM_WORLD);
 #else
-	for(int i=0; i<nx; i++)
+	if(GlobalV::MY_RANK==0 && async)
 	{
-		for(int j=0; j<ny; j++)
-		{
-			for(int k=0; k<nz; k++)
-			{
-				ofs_cube << " " << data[k*nx*ny+i*ny+j];
-				// ++count_cube;
-				if(k%6==5 && k!=nz-1) ofs_cube << "\n";
-			}
-			ofs_cube << "\n";
-		}
+		data_cube->assign(data, data + nx * ny * nz);
 	}
 #endif
 
 	if(GlobalV::MY_RANK==0) 
 	{
+#ifdef __MPI
+		const double* data_write = data_cube->data();
+#else
+		const double* data_write = async ? data_cube->data() : data;
+#endif
+		if (async)
+		{
+			const std::string head = ofs_cube.str();
+			ModuleIO::output_queue().push(fn, [fn, head, data_cube, nx, ny, nz, precision]() {
+				return write_cube_file(fn, head, data_cube->data(), nx, ny, nz, precision);
+			});
+		}
+		else if (!write_cube_file(fn, ofs_cube.str(), data_write, nx, ny, nz, precision))
+		{
+			ModuleBase::WARNING("ModuleIO::write_cube","Can't create Output File!");
+		}
 		end = time(NULL);
 		ModuleBase::GlobalFunc::OUT_TIME("write_cube",start,end);
-		// ofs.close();
-		/// for cube file
-		ofs_cube.close();
 	}
 
     return;
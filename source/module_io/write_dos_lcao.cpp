@@ -6,6 +6,7 @@
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
 #include "module_hamilt_pw/hamilt_pwdft/wavefunc.h"
 #include "write_orb_info.h"
+#include "orb_weight_lcao.h"
 #ifdef __LCAO
 #include "module_cell/module_neighbor/sltk_atom_arrange.h" //qifeng-2019-01-21
 #include "module_hamilt_lcao/hamilt_lcaodft/LCAO_gen_fixedH.h"
@@ -14,6 +15,7 @@
 #include "module_hamilt_lcao/hamilt_lcaodft/local_orbital_charge.h"
 #include "module_hamilt_lcao/hamilt_lcaodft/hamilt_lcao.h"
 #endif
+#include <algorithm>
 #include <vector>
 
 #include "module_base/blas_connector.h"
@@ -85,106 +87,63 @@ void ModuleIO::write_dos_lcao(const psi::Psi<double>* psid,
 
     const int npoints = static_cast<int>(std::floor((emax - emin) / de_ev));
 
-    int NUM = GlobalV::NLOCAL * npoints;
-
     const int np = npoints;
-    ModuleBase::matrix* pdosk = new ModuleBase::matrix[nspin0];
-
-    for (int is = 0; is < nspin0; ++is)
-    {
-
-        pdosk[is].create(GlobalV::NLOCAL, np, true);
-    }
-    ModuleBase::matrix* pdos = new ModuleBase::matrix[nspin0];
-    for (int is = 0; is < nspin0; ++is)
-    {
-        pdos[is].create(GlobalV::NLOCAL, np, true);
-    }
-
-    double a = bcoeff;
-    double c = 2 * 3.141592653;
-    double b = sqrt(c) * a;
-
-    std::complex<double>* waveg = new std::complex<double>[GlobalV::NLOCAL];
+    const double a = bcoeff;
+    const double c = 2 * 3.141592653;
+    const double b = sqrt(c) * a;
 
-    double* Gauss = new double[np];
+    // the weights of the local orbitals (rows) in the local bands (columns) of one k-point,
+    // and the Gaussian of the local bands on the energy grid
+    const int nrow = pv->get_row_size();
+#ifdef __MPI
+    const int ncol = pv->ncol_bands;
+#else
+    const int ncol = GlobalV::NBANDS;
+#endif
+    std::vector<double> weight(static_cast<size_t>(nrow) * ncol);
+    std::vector<double> gauss(static_cast<size_t>(ncol) * np);
+    // the pdos of the local orbitals, accumulated over k-points
+    std::vector<double> pdos_local(static_cast<size_t>(nrow) * np);
+    // the pdos of all orbitals and spins, reduced once after all k-points
+    std::vector<double> pdosk(static_cast<size_t>(nspin0) * GlobalV::NLOCAL * np, 0.0);
+
+    // pdos_local(ir, n) += sum_ic weight(ir, ic) * gauss(ic, n)
+    auto add_pdos = [&](const int ik, const double wk) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int ic = 0; ic < ncol; ++ic)
+        {
+            const double en0 = ekb(ik, pv->local2global_col(ic)) * ModuleBase::Ry_to_eV;
+            double* g = gauss.data() + static_cast<size_t>(ic) * np;
+            for (int n = 0; n < np; ++n)
+            {
+                const double de = emin + n * de_ev - en0;
+                const double de2 = 0.5 * de * de;
+                g[n] = wk * exp(-de2 / a / a) / b;
+            }
+        }
+        if (nrow > 0 && ncol > 0 && np > 0)
+        {
+            BlasConnector::gemm('T', 'N', nrow, np, ncol,
+                                1.0, weight.data(), nrow, gauss.data(), np,
+                                1.0, pdos_local.data(), np);
+        }
+    };
 
     for (int is = 0; is < nspin0; ++is)
     {
+        std::fill(pdos_local.begin(), pdos_local.end(), 0.0);
         if (GlobalV::GAMMA_ONLY_LOCAL)
         {
-            std::vector<ModuleBase::matrix> Mulk;
-            Mulk.resize(1);
-            Mulk[0].create(pv->ncol, pv->nrow);
-
             psid->fix_k(is);
-            const double* ppsi = psid->get_pointer();
-            for (int i = 0; i < GlobalV::NBANDS; ++i)
-            {
-                ModuleBase::GlobalFunc::ZEROS(waveg, GlobalV::NLOCAL);
-
-                ModuleBase::GlobalFunc::ZEROS(Gauss, np);
-                for (int n = 0; n < npoints; ++n)
-                {
-                    double en = emin + n * de_ev;
-                    double en0 = ekb(0, i) * ModuleBase::Ry_to_eV;
-                    double de = en - en0;
-                    double de2 = 0.5 * de * de;
-                    Gauss[n] = kv.wk[0] * exp(-de2 / a / a) / b;
-                }
-
-                const int NB = i + 1;
-
-                const double one_float = 1.0, zero_float = 0.0;
-                const int one_int = 1;
-
-#ifdef __MPI
-                const char T_char = 'T';
-                pdgemv_(&T_char,
-                        &GlobalV::NLOCAL,
-                        &GlobalV::NLOCAL,
-                        &one_float,
-                        uhm.LM->Sloc.data(),
-                        &one_int,
-                        &one_int,
-                        pv->desc,
-                        ppsi,
-                        &one_int,
-                        &NB,
-                        pv->desc,
-                        &one_int,
-                        &zero_float,
-                        Mulk[0].c,
-                        &one_int,
-                        &NB,
-                        pv->desc,
-                        &one_int);
-#endif
-
-                for (int j = 0; j < GlobalV::NLOCAL; ++j)
-                {
-
-                    if (pv->in_this_processor(j, i))
-                    {
-
-                        const int ir = pv->global2local_row(j);
-                        const int ic = pv->global2local_col(i);
-                        waveg[j] = Mulk[0](ic, ir) * psid[0](ic, ir);
-                        const double x = waveg[j].real();
-                        BlasConnector::axpy(np, x, Gauss, 1, pdosk[is].c + j * pdosk[is].nc, 1);
-                    }
-                }
-            } // ib
+            ModuleIO::cal_orb_weight(pv, GlobalV::NBANDS, uhm.LM->Sloc.data(), psid->get_pointer(), weight.data());
+            add_pdos(0, kv.wk[0]);
         } // if
         else
         {
-            std::vector<ModuleBase::ComplexMatrix> Mulk;
-            Mulk.resize(1);
-            Mulk[0].create(pv->ncol, pv->nrow);
-
             for (int ik = 0; ik < kv.nks; ik++)
             {
-
                 if (is == kv.isk[ik])
                 {
                     // calculate SK for current k point
@@ -199,86 +158,41 @@ void ModuleIO::write_dos_lcao(const psi::Psi<double>* psid,
                     }
 
                     psi->fix_k(ik);
-                    psi::Psi<std::complex<double>> Dwfc(psi[0], 1);
-                    std::complex<double>* p_dwfc = Dwfc.get_pointer();
-                    for (int index = 0; index < Dwfc.size(); ++index)
-                    {
-                        p_dwfc[index] = conj(p_dwfc[index]);
-                    }
-
-                    for (int i = 0; i < GlobalV::NBANDS; ++i)
-                    {
-
-                        ModuleBase::GlobalFunc::ZEROS(waveg, GlobalV::NLOCAL);
-
-                        ModuleBase::GlobalFunc::ZEROS(Gauss, np);
-                        for (int n = 0; n < npoints; ++n)
-                        {
-                            double en = emin + n * de_ev;
-                            double en0 = ekb(ik, i) * ModuleBase::Ry_to_eV;
-                            double de = en - en0;
-                            double de2 = 0.5 * de * de;
-                            Gauss[n] = kv.wk[ik] * exp(-de2 / a / a) / b;
-                        }
-
-                        const int NB = i + 1;
-
-                        const double one_float[2] = {1.0, 0.0}, zero_float[2] = {0.0, 0.0};
-                        const int one_int = 1;
-                        //   const int two_int=2;
-                        const char T_char = 'T'; // N_char='N',U_char='U'
-
-#ifdef __MPI
-                        pzgemv_(&T_char,
-                                &GlobalV::NLOCAL,
-                                &GlobalV::NLOCAL,
-                                &one_float[0],
-                                uhm.LM->Sloc2.data(),
-                                &one_int,
-                                &one_int,
-                                pv->desc,
-                                p_dwfc,
-                                &one_int,
-                                &NB,
-                                pv->desc,
-                                &one_int,
-                                &zero_float[0],
-                                Mulk[0].c,
-                                &one_int,
-                                &NB,
-                                pv->desc,
-                                &one_int);
-#endif
-
-                        for (int j = 0; j < GlobalV::NLOCAL; ++j)
-                        {
-
-                            if (pv->in_this_processor(j, i))
-                            {
-
-                                const int ir = pv->global2local_row(j);
-                                const int ic = pv->global2local_col(i);
-
-                                waveg[j] = Mulk[0](ic, ir) * psi[0](ic, ir);
-                                const double x = waveg[j].real();
-                                BlasConnector::axpy(np, x, Gauss, 1, pdosk[is].c + j * pdosk[is].nc, 1);
-                            }
-                        }
-
-                    } // ib
-
+                    ModuleIO::cal_orb_weight(pv, GlobalV::NBANDS, uhm.LM->Sloc2.data(), psi->get_pointer(), weight.data());
+                    add_pdos(ik, kv.wk[ik]);
                 } // if
             } // ik
         } // else
+
+        double* pdosk_is = pdosk.data() + static_cast<size_t>(is) * GlobalV::NLOCAL * np;
+        for (int ir = 0; ir < nrow; ++ir)
+        {
+            const int j = pv->local2global_row(ir);
+            std::copy(pdos_local.begin() + static_cast<size_t>(ir) * np,
+                      pdos_local.begin() + static_cast<size_t>(ir + 1) * np,
+                      pdosk_is + static_cast<size_t>(j) * np);
+        }
+    } // is
+
+    ModuleBase::matrix* pdos = new ModuleBase::matrix[nspin0];
+    for (int is = 0; is < nspin0; ++is)
+    {
+        pdos[is].create(GlobalV::NLOCAL, np, true);
+    }
 #ifdef __MPI
-        MPI_Reduce(pdosk[is].c, pdos[is].c, NUM, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    std::vector<double> pdos_all(GlobalV::MY_RANK == 0 ? pdosk.size() : 0);
+    MPI_Reduce(pdosk.data(), pdos_all.data(), pdosk.size(), MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    pdosk.swap(pdos_all);
 #endif
-    } // is
-    delete[] pdosk;
-    delete[] waveg;
-    delete[] Gauss;
     if (GlobalV::MY_RANK == 0)
     {
+        for (int is = 0; is < nspin0; ++is)
+        {
+            std::copy(pdosk.begin() + static_cast<size_t>(is) * GlobalV::NLOCAL * np,
+                      pdosk.begin() + static_cast<size_t>(is + 1) * GlobalV::NLOCAL * np,
+                      pdos[is].c);
+        }
+
         {
             std::stringstream ps;
             ps << GlobalV::global_out_dir << "TDOS";
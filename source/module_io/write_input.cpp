@@ -37,12 +37,20 @@ void Input::Print(const std::string &fn) const
                                  "orbital_dir",
                                  GlobalV::global_orbital_dir,
                                  "the directory containing orbital files");
+    ModuleBase::GlobalFunc::OUTP(ofs,
+                                 "cache_dir",
+                                 GlobalV::global_cache_dir,
+                                 "the directory of the cache of parsed pseudo and orbital files");
     // ModuleBase::GlobalFunc::OUTP(ofs, "pseudo_type", GlobalV::global_pseudo_type, "the type pseudo files");
     ModuleBase::GlobalFunc::OUTP(ofs, "pseudo_rcut", pseudo_rcut, "cut-off radius for radial integration");
     ModuleBase::GlobalFunc::OUTP(ofs,
                                  "pseudo_mesh",
                                  pseudo_mesh,
                                  "0: use our own mesh to do radial renormalization; 1: use mesh as in QE");
+    ModuleBase::GlobalFunc::OUTP(ofs,
+                                 "pseudo_sbt_fft",
+                                 pseudo_sbt_fft,
+                                 "compute the radial Fourier transforms of pseudopotentials by FFT");
     ModuleBase::GlobalFunc::OUTP(ofs, "lmaxmax", lmaxmax, "maximum of l channels used");
     ModuleBase::GlobalFunc::OUTP(ofs, "dft_functional", dft_functional, "exchange correlation functional");
     ModuleBase::GlobalFunc::OUTP(ofs, "xc_temperature", xc_temperature, "temperature for finite temperature functionals");
@@ -54,6 +62,8 @@ void Input::Print(const std::string &fn) const
     for(int i=0;i<3;i++){kspacing_ss << kspacing[i] << " ";}
     ModuleBase::GlobalFunc::OUTP(ofs, "kspacing", kspacing_ss.str(),  "unit in 1/bohr, should be > 0, default is 0 which means read KPT file");
     ModuleBase::GlobalFunc::OUTP(ofs, "min_dist_coef", min_dist_coef, "factor related to the allowed minimum distance between two atoms");
+    ModuleBase::GlobalFunc::OUTP(ofs, "ewald_spme", ewald_spme, "use the smooth particle-mesh Ewald method for the ion-ion interaction");
+    ModuleBase::GlobalFunc::OUTP(ofs, "ewald_spme_tol", ewald_spme_tol, "accuracy target of the smooth particle-mesh Ewald method");
     ModuleBase::GlobalFunc::OUTP(ofs, "nbands", nbands, "number of bands");
     ModuleBase::GlobalFunc::OUTP(ofs, "nbands_sto", nbands_sto, "number of stochastic bands");
     ModuleBase::GlobalFunc::OUTP(ofs,
@@ -116,6 +126,7 @@ void Input::Print(const std::string &fn) const
                                  chg_extrap,
                                  "atomic; first-order; second-order; dm:coefficients of SIA");
     ModuleBase::GlobalFunc::OUTP(ofs, "out_chg", out_chg, ">0 output charge density for selected electron steps");
+    ModuleBase::GlobalFunc::OUTP(ofs, "out_chg_format", out_chg_format, "format of the charge density files: cube, binary or binary_zlib");
     ModuleBase::GlobalFunc::OUTP(ofs, "out_pot", out_pot, "output realspace potential");
     ModuleBase::GlobalFunc::OUTP(ofs, "out_wfc_pw", out_wfc_pw, "output wave functions");
     ModuleBase::GlobalFunc::OUTP(ofs, "out_wfc_r", out_wfc_r, "output wave functions in realspace");
@@ -124,6 +135,7 @@ void Input::Print(const std::string &fn) const
     ModuleBase::GlobalFunc::OUTP(ofs, "out_proj_band", out_proj_band, "output projected band structure");
     ModuleBase::GlobalFunc::OUTP(ofs, "restart_save", restart_save, "print to disk every step for restart");
     ModuleBase::GlobalFunc::OUTP(ofs, "restart_load", restart_load, "restart from disk");
+    ModuleBase::GlobalFunc::OUTP(ofs, "restart_freq", restart_freq, "write the binary SCF checkpoint every restart_freq iterations");
     ModuleBase::GlobalFunc::OUTP(ofs, "read_file_dir", read_file_dir, "directory of files for reading");
     ModuleBase::GlobalFunc::OUTP(ofs, "nx", nx, "number of points along x axis for FFT grid");
     ModuleBase::GlobalFunc::OUTP(ofs, "ny", ny, "number of points along y axis for FFT grid");
@@ -179,6 +191,9 @@ void Input::Print(const std::string &fn) const
     ModuleBase::GlobalFunc::OUTP(ofs, "relax_bfgs_rmax", relax_bfgs_rmax, "maximal trust radius, unit: Bohr");
     ModuleBase::GlobalFunc::OUTP(ofs, "relax_bfgs_rmin", relax_bfgs_rmin, "minimal trust radius, unit: Bohr");
     ModuleBase::GlobalFunc::OUTP(ofs, "relax_bfgs_init", relax_bfgs_init, "initial trust radius, unit: Bohr");
+    ModuleBase::GlobalFunc::OUTP(ofs, "relax_bfgs_prec", relax_bfgs_prec, "model hessian for bfgs: none; exp");
+    ModuleBase::GlobalFunc::OUTP(ofs, "relax_bfgs_hess_in", relax_bfgs_hess_in, "file of the initial inverse hessian for bfgs");
+    ModuleBase::GlobalFunc::OUTP(ofs, "out_bfgs_hess", out_bfgs_hess, "output the inverse hessian of bfgs or not");
     ModuleBase::GlobalFunc::OUTP(ofs, "cal_stress", cal_stress, "calculate the stress or not");
     ModuleBase::GlobalFunc::OUTP(ofs, "fixed_axes", fixed_axes, "which axes are fixed");
     ModuleBase::GlobalFunc::OUTP(ofs, "fixed_ibrav", fixed_ibrav, "whether to preseve lattice type during relaxation");
@@ -211,6 +226,11 @@ ModuleBase::GlobalFunc::OUTP(ofs, "out_bandgap", out_bandgap, "if true, print ou
     ModuleBase::GlobalFunc::OUTP(ofs, "gamma_only", gamma_only, "Only for localized orbitals set and gamma point. If set to 1, a fast algorithm is used");
     ModuleBase::GlobalFunc::OUTP(ofs, "search_radius", search_radius, "input search radius (Bohr)");
     ModuleBase::GlobalFunc::OUTP(ofs, "search_pbc", search_pbc, "input periodic boundary condition");
+    if (ks_solver == "purification")
+    {
+        ModuleBase::GlobalFunc::OUTP(ofs, "purification_rcut", purification_rcut, "cutoff of density matrix blocks (Bohr)");
+        ModuleBase::GlobalFunc::OUTP(ofs, "purification_thr", purification_thr, "convergence threshold of purification");
+    }
     ModuleBase::GlobalFunc::OUTP(ofs, "lcao_ecut", lcao_ecut, "energy cutoff for LCAO");
     ModuleBase::GlobalFunc::OUTP(ofs, "lcao_dk", lcao_dk, "delta k for 1D integration in LCAO");
     ModuleBase::GlobalFunc::OUTP(ofs, "lcao_dr", lcao_dr, "delta r for 1D integration in LCAO");
@@ -277,6 +297,9 @@ ModuleBase::GlobalFunc::OUTP(ofs, "out_bandgap", out_bandgap, "if true, print ou
 	ModuleBase::GlobalFunc::OUTP(ofs,"md_tfreq",mdp.md_tfreq,"oscillation frequency, used to determine qmass of NHC");
 	ModuleBase::GlobalFunc::OUTP(ofs,"md_damp",mdp.md_damp,"damping parameter (time units) used to add force in Langevin method");
     ModuleBase::GlobalFunc::OUTP(ofs,"md_nraise",mdp.md_nraise,"parameters used when md_type=nvt");
+    ModuleBase::GlobalFunc::OUTP(ofs,"md_respa_nstep",mdp.md_respa_nstep,"number of r-RESPA inner steps per md_dt");
+    ModuleBase::GlobalFunc::OUTP(ofs,"md_respa_esolver",mdp.md_respa_esolver,"esolver of r-RESPA inner steps: lj, dp");
+    ModuleBase::GlobalFunc::OUTP(ofs,"md_relabel_file",mdp.md_relabel_file,"MD_dump trajectory relabelled by the DP model, none: run md");
     ModuleBase::GlobalFunc::OUTP(ofs,"cal_syns",cal_syns,"calculate asynchronous overlap matrix to output for Hefei-NAMD");
     ModuleBase::GlobalFunc::OUTP(ofs,"dmax",dmax,"maximum displacement of all atoms in one step (bohr)");
     ModuleBase::GlobalFunc::OUTP(ofs,"md_tolerance",mdp.md_tolerance,"tolerance for velocity rescaling (K)");
@@ -376,6 +399,7 @@ ModuleBase::GlobalFunc::OUTP(ofs, "out_bandgap", out_bandgap, "if true, print ou
     ModuleBase::GlobalFunc::OUTP(ofs, "exx_v_grad_threshold", exx_v_grad_threshold, "threshold to screen nabla V matrix in exx");
     ModuleBase::GlobalFunc::OUTP(ofs, "exx_cauchy_force_threshold", exx_cauchy_force_threshold, "threshold to screen exx force using Cauchy-Schwartz inequality");
     ModuleBase::GlobalFunc::OUTP(ofs, "exx_cauchy_stress_threshold", exx_cauchy_stress_threshold, "threshold to screen exx stress using Cauchy-Schwartz inequality");
+    ModuleBase::GlobalFunc::OUTP(ofs, "exx_incremental", exx_incremental, "if 1, update Hexx from the change of the density matrix");
     //ModuleBase::GlobalFunc::OUTP(ofs, "exx_ccp_threshold", exx_ccp_threshold, "");
     ModuleBase::GlobalFunc::OUTP(ofs, "exx_ccp_rmesh_times", exx_ccp_rmesh_times, "how many times larger the radial mesh required for calculating Columb potential is to that of atomic orbitals");
     //ModuleBase::GlobalFunc::OUTP(ofs, "exx_distribute_type", exx_distribute_type, "htime or kmeans1 or kmeans2");
@@ -415,7 +439,7 @@ ModuleBase::GlobalFunc::OUTP(ofs, "out_bandgap", out_bandgap, "if true, print ou
 
     ofs << "\n#Parameters (19.orbital free density functional theory)" << std::endl;
     ModuleBase::GlobalFunc::OUTP(ofs, "of_kinetic", of_kinetic, "kinetic energy functional, such as tf, vw, wt");
-    ModuleBase::GlobalFunc::OUTP(ofs, "of_method", of_method, "optimization method used in OFDFT, including cg1, cg2, tn (default)");
+    ModuleBase::GlobalFunc::OUTP(ofs, "of_method", of_method, "optimization method used in OFDFT, including cg1, cg2, tn (default), lbfgs");
     ModuleBase::GlobalFunc::OUTP(ofs, "of_conv", of_conv, "the convergence criterion, potential, energy (default), or both");
     ModuleBase::GlobalFunc::OUTP(ofs, "of_tole", of_tole, "tolerance of the energy change (in Ry) for determining the convergence, default=2e-6 Ry");
     ModuleBase::GlobalFunc::OUTP(ofs, "of_tolp", of_tolp, "tolerance of potential for determining the convergence, default=1e-5 in a.u.");
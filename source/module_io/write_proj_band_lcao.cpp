@@ -6,6 +6,7 @@
 #include "module_base/scalapack_connector.h"
 #include "module_base/timer.h"
 #include "module_hamilt_lcao/hamilt_lcaodft/hamilt_lcao.h"
+#include "orb_weight_lcao.h"
 
 void ModuleIO::write_proj_band_lcao(const psi::Psi<double> *psid,
     const psi::Psi<std::complex<double>> *psi,
@@ -33,7 +34,7 @@ void ModuleIO::write_proj_band_lcao(const psi::Psi<double> *psid,
         nks = kv.nkstot / 2;
     }
 
-    ModuleBase::ComplexMatrix weightk;
+    ModuleBase::matrix weightk;
     ModuleBase::matrix weight;
     int NUM = 0;
     if (GlobalV::GAMMA_ONLY_LOCAL)
@@ -49,137 +50,64 @@ void ModuleIO::write_proj_band_lcao(const psi::Psi<double> *psid,
         weight.create(kv.nks, GlobalV::NBANDS * GlobalV::NLOCAL, true);
     }
 
-    for (int is = 0; is < nspin0; is++)
-    {
-
-        if (GlobalV::GAMMA_ONLY_LOCAL)
-        {
-            std::vector<ModuleBase::matrix> Mulk;
-            Mulk.resize(1);
-            Mulk[0].create(pv->ncol, pv->nrow);
-
-            psid->fix_k(is);
-            for (int i = 0; i < GlobalV::NBANDS; ++i)
-            {
-                const int NB = i + 1;
-
-                const double one_float = 1.0, zero_float = 0.0;
-                const int one_int = 1;
+    // the weights of the local orbitals (rows) in the local bands (columns) of one k-point
+    const int nrow = pv->get_row_size();
 #ifdef __MPI
-                const char T_char = 'T';
-                pdgemv_(&T_char,
-                        &GlobalV::NLOCAL,
-                        &GlobalV::NLOCAL,
-                        &one_float,
-                        uhm.LM->Sloc.data(),
-                        &one_int,
-                        &one_int,
-                        pv->desc,
-                        psid->get_pointer(),
-                        &one_int,
-                        &NB,
-                        pv->desc,
-                        &one_int,
-                        &zero_float,
-                        Mulk[0].c,
-                        &one_int,
-                        &NB,
-                        pv->desc,
-                        &one_int);
+    const int ncol = pv->ncol_bands;
+#else
+    const int ncol = GlobalV::NBANDS;
 #endif
-                for (int j = 0; j < GlobalV::NLOCAL; ++j)
-                {
-
-                    if (pv->in_this_processor(j, i))
-                    {
-
-                        const int ir = pv->global2local_row(j);
-                        const int ic = pv->global2local_col(i);
-                        weightk(is, i * GlobalV::NLOCAL + j) = Mulk[0](ic, ir) * psid[0](ic, ir);
-                    }
-                }
-            } // ib
-        } // if
-        else
+    std::vector<double> weight_local(static_cast<size_t>(nrow) * ncol);
+    auto add_weight = [&](const int ik) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int ic = 0; ic < ncol; ++ic)
         {
-            std::vector<ModuleBase::ComplexMatrix> Mulk;
-            Mulk.resize(1);
-            Mulk[0].create(pv->ncol, pv->nrow);
-
-            for (int ik = 0; ik < kv.nks; ik++)
+            const int ib = pv->local2global_col(ic);
+            for (int ir = 0; ir < nrow; ++ir)
             {
-                if (is == kv.isk[ik])
-                {
-                    // calculate SK for current k point
-                    // the target matrix is LM->Sloc2 with collumn-major
-                    if(GlobalV::NSPIN == 4)
-                    {
-                        dynamic_cast<hamilt::HamiltLCAO<std::complex<double>, std::complex<double>>*>(p_ham)->updateSk(ik, uhm.LM, 1);
-                    }
-                    else
-                    {
-                        dynamic_cast<hamilt::HamiltLCAO<std::complex<double>, double>*>(p_ham)->updateSk(ik, uhm.LM, 1);
-                    }
-                    // calculate Mulk
-                    psi->fix_k(ik);
-                    psi::Psi<std::complex<double>> Dwfc(psi[0], 1);
-                    std::complex<double>* p_dwfc = Dwfc.get_pointer();
-                    for (int index = 0; index < Dwfc.size(); ++index)
-                    {
-                        p_dwfc[index] = conj(p_dwfc[index]);
-                    }
-
-                    for (int i = 0; i < GlobalV::NBANDS; ++i)
-                    {
-                        const int NB = i + 1;
-
-                        const double one_float[2] = {1.0, 0.0}, zero_float[2] = {0.0, 0.0};
-                        const int one_int = 1;
-                        //   const int two_int=2;
-                        const char T_char = 'T'; // N_char='N',U_char='U'
-#ifdef __MPI
-                        pzgemv_(&T_char,
-                                &GlobalV::NLOCAL,
-                                &GlobalV::NLOCAL,
-                                &one_float[0],
-                                uhm.LM->Sloc2.data(),
-                                &one_int,
-                                &one_int,
-                                pv->desc,
-                                p_dwfc,
-                                &one_int,
-                                &NB,
-                                pv->desc,
-                                &one_int,
-                                &zero_float[0],
-                                Mulk[0].c,
-                                &one_int,
-                                &NB,
-                                pv->desc,
-                                &one_int);
-#endif
-                        for (int j = 0; j < GlobalV::NLOCAL; ++j)
-                        {
-
-                            if (pv->in_this_processor(j, i))
-                            {
-
-                                const int ir = pv->global2local_row(j);
-                                const int ic = pv->global2local_col(i);
-
-                                weightk(ik, i * GlobalV::NLOCAL + j) = Mulk[0](ic, ir) * psi[0](ic, ir);
-                            }
-                        }
-
-                    } // ib
+                weightk(ik, ib * GlobalV::NLOCAL + pv->local2global_row(ir)) = weight_local[ic * nrow + ir];
+            }
+        }
+    };
 
-                } // if
-            } // ik
-        } // else
+    if (GlobalV::GAMMA_ONLY_LOCAL)
+    {
+        for (int is = 0; is < nspin0; is++)
+        {
+            psid->fix_k(is);
+            ModuleIO::cal_orb_weight(pv, GlobalV::NBANDS, uhm.LM->Sloc.data(), psid->get_pointer(), weight_local.data());
+            add_weight(is);
+        }
+    }
+    else
+    {
+        for (int ik = 0; ik < kv.nks; ik++)
+        {
+            // calculate SK for current k point
+            // the target matrix is LM->Sloc2 with collumn-major
+            if(GlobalV::NSPIN == 4)
+            {
+                dynamic_cast<hamilt::HamiltLCAO<std::complex<double>, std::complex<double>>*>(p_ham)->updateSk(ik, uhm.LM, 1);
+            }
+            else
+            {
+                dynamic_cast<hamilt::HamiltLCAO<std::complex<double>, double>*>(p_ham)->updateSk(ik, uhm.LM, 1);
+            }
+            psi->fix_k(ik);
+            ModuleIO::cal_orb_weight(pv, GlobalV::NBANDS, uhm.LM->Sloc2.data(), psi->get_pointer(), weight_local.data());
+            add_weight(ik);
+        }
+    }
 #ifdef __MPI
-        MPI_Reduce(weightk.real().c, weight.c, NUM, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(weightk.c, weight.c, NUM, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+#else
+    weight = weightk;
 #endif
 
+    for (int is = 0; is < nspin0; is++)
+    {
         if (GlobalV::MY_RANK == 0)
         {
             std::stringstream ps2;
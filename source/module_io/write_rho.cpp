@@ -18,7 +18,8 @@ void ModuleIO::write_rho(
 	const int& nz,
 	const double& ef,
 	const UnitCell* ucell,
-	const int &precision)
+	const int &precision,
+	const bool async)
 {
 	ModuleIO::write_cube(
 #ifdef __MPI
@@ -38,7 +39,8 @@ void ModuleIO::write_rho(
 		ef,
 		ucell,
 		precision,
-		1);
+		1,
+		async);
 
     return;
 }
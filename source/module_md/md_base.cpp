@@ -6,6 +6,8 @@
 #endif
 #include "module_io/print_info.h"
 
+#include <vector>
+
 MD_base::MD_base(MD_para& MD_para_in, UnitCell& unit_in) : mdp(MD_para_in), ucell(unit_in)
 {
     if (mdp.md_seed >= 0)
@@ -20,6 +22,8 @@ MD_base::MD_base(MD_para& MD_para_in, UnitCell& unit_in) : mdp(MD_para_in), ucel
     vel = new ModuleBase::Vector3<double>[ucell.nat];
     ionmbl = new ModuleBase::Vector3<int>[ucell.nat];
     force = new ModuleBase::Vector3<double>[ucell.nat];
+    p_esolver_fast_ = nullptr;
+    force_fast_ = nullptr;
     virial.create(3, 3);
     stress.create(3, 3);
 
@@ -47,6 +51,7 @@ MD_base::~MD_base()
     delete[] vel;
     delete[] ionmbl;
     delete[] force;
+    delete[] force_fast_;
 }
 
 void MD_base::setup(ModuleESolver::ESolver* p_esolver, const std::string& global_readin_dir)
@@ -61,6 +66,20 @@ void MD_base::setup(ModuleESolver::ESolver* p_esolver, const std::string& global
     MD_func::force_virial(p_esolver, step_, ucell, potential, force, mdp.cal_stress, virial);
     MD_func::compute_stress(ucell, vel, allmass, mdp.cal_stress, virial, stress);
     ucell.ionic_position_updated = true;
+
+    if (p_esolver_fast_ != nullptr)
+    {
+        double potential_fast = 0.0;
+        ModuleBase::matrix virial_fast(3, 3);
+        MD_func::force_virial(p_esolver_fast_, step_, ucell, potential_fast, force_fast_, false, virial_fast);
+    }
+}
+
+void MD_base::set_respa(ModuleESolver::ESolver* p_esolver_fast)
+{
+    p_esolver_fast_ = p_esolver_fast;
+    delete[] force_fast_;
+    force_fast_ = new ModuleBase::Vector3<double>[ucell.nat];
 }
 
 void MD_base::first_half(std::ofstream& ofs)
@@ -75,6 +94,59 @@ void MD_base::second_half()
 }
 
 void MD_base::update_pos()
+{
+    if (p_esolver_fast_ == nullptr)
+    {
+        move_atoms(mdp.md_dt);
+        return;
+    }
+
+    /// r-RESPA inner steps driven by the fast forces
+    const double dt_fast = mdp.md_dt / mdp.md_respa_nstep;
+    double potential_fast = 0.0;
+    ModuleBase::matrix virial_fast(3, 3);
+    std::vector<ModuleBase::Vector3<double>> dis(ucell.nat);
+    for (int istep = 0; istep < mdp.md_respa_nstep; ++istep)
+    {
+        kick_vel(force_fast_, dt_fast);
+        move_atoms(dt_fast);
+        for (int i = 0; i < ucell.nat; ++i)
+        {
+            dis[i] += pos[i];
+        }
+        MD_func::force_virial(p_esolver_fast_, step_, ucell, potential_fast, force_fast_, false, virial_fast);
+        kick_vel(force_fast_, dt_fast);
+    }
+
+    /// atom->dis only keeps the last inner step, but the charge extrapolation needs the whole outer step
+    int iat = 0;
+    for (int it = 0; it < ucell.ntype; ++it)
+    {
+        for (int ia = 0; ia < ucell.atoms[it].na; ++ia)
+        {
+            ucell.atoms[it].dis[ia] = dis[iat++];
+        }
+    }
+}
+
+void MD_base::update_vel(const ModuleBase::Vector3<double>* force)
+{
+    if (p_esolver_fast_ == nullptr)
+    {
+        kick_vel(force, mdp.md_dt);
+        return;
+    }
+
+    /// r-RESPA outer step: only the slow forces act with md_dt, the fast ones are integrated in update_pos
+    std::vector<ModuleBase::Vector3<double>> force_slow(ucell.nat);
+    for (int i = 0; i < ucell.nat; ++i)
+    {
+        force_slow[i] = force[i] - force_fast_[i];
+    }
+    kick_vel(force_slow.data(), mdp.md_dt);
+}
+
+void MD_base::move_atoms(const double& dt)
 {
     if (mdp.my_rank == 0)
     {
@@ -84,7 +156,7 @@ void MD_base::update_pos()
             {
                 if (ionmbl[i][k])
                 {
-                    pos[i][k] = vel[i][k] * mdp.md_dt / ucell.lat0;
+                    pos[i][k] = vel[i][k] * dt / ucell.lat0;
                 }
                 else
                 {
@@ -102,7 +174,7 @@ void MD_base::update_pos()
     ucell.update_pos_taud(pos);
 }
 
-void MD_base::update_vel(const ModuleBase::Vector3<double>* force)
+void MD_base::kick_vel(const ModuleBase::Vector3<double>* force, const double& dt)
 {
     if (mdp.my_rank == 0)
     {
@@ -112,7 +184,7 @@ void MD_base::update_vel(const ModuleBase::Vector3<double>* force)
             {
                 if (ionmbl[i][k])
                 {
-                    vel[i][k] += 0.5 * force[i][k] * mdp.md_dt / allmass[i];
+                    vel[i][k] += 0.5 * force[i][k] * dt / allmass[i];
                 }
             }
         }
@@ -48,6 +48,17 @@ class MD_base
      */
     virtual void write_restart(const std::string& global_out_dir);
 
+    /**
+     * @brief switch to the r-RESPA integrator, must be called before setup
+     *
+     * The forces are split into a fast part given by p_esolver_fast and a slow part, the difference between the full
+     * and the fast forces. The slow part is applied in update_vel with md_dt, while update_pos performs md_respa_nstep
+     * velocity-Verlet steps of md_dt/md_respa_nstep with the fast forces only.
+     *
+     * @param p_esolver_fast the cheap energy solver driving the inner steps
+     */
+    void set_respa(ModuleESolver::ESolver* p_esolver_fast);
+
   protected:
     /**
      * @brief restart MD when md_restart is true
@@ -66,6 +77,19 @@ class MD_base
      */
     virtual void update_vel(const ModuleBase::Vector3<double>* force);
 
+    /**
+     * @brief move atoms by their velocities during dt
+     * @param dt time increment
+     */
+    void move_atoms(const double& dt);
+
+    /**
+     * @brief half-step update of vel due to atomic force during dt
+     * @param force atomic forces
+     * @param dt time increment
+     */
+    void kick_vel(const ModuleBase::Vector3<double>* force, const double& dt);
+
   public:
     bool stop;                          ///< MD stop or not
     double t_current;                   ///< current temperature
@@ -86,6 +110,9 @@ class MD_base
     MD_para& mdp;    ///< input parameters used in md
     UnitCell& ucell; ///< unitcell information
     double energy_;  ///< total energy of the system
+
+    ModuleESolver::ESolver* p_esolver_fast_; ///< cheap energy solver of r-RESPA, nullptr if r-RESPA is off
+    ModuleBase::Vector3<double>* force_fast_; ///< forces from p_esolver_fast_
 };
 
 #endif // MD_BASE_H
\ No newline at end of file
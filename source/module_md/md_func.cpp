@@ -2,10 +2,104 @@
 
 #include "module_base/global_variable.h"
 #include "module_base/timer.h"
+#include "module_io/output_queue.h"
 
 namespace MD_func
 {
 
+namespace
+{
+/// the information of one md step, copied so that it can be written after the atoms have moved on
+struct Dump_Frame
+{
+    int step = 0;
+    std::string file;
+    bool new_file = false; ///< truncate the file instead of appending
+    double lat0_angstrom = 0.0;
+    ModuleBase::Matrix3 latvec;
+    bool dump_virial = false;
+    bool dump_force = false;
+    bool dump_vel = false;
+    bool dump_energy = false;
+    double energy = 0.0;                     ///< eV
+    ModuleBase::matrix virial;               ///< kBar
+    std::vector<std::string> label;          ///< label of each atom
+    std::vector<ModuleBase::Vector3<double>> pos;   ///< Angstrom
+    std::vector<ModuleBase::Vector3<double>> force; ///< eV/Angstrom
+    std::vector<ModuleBase::Vector3<double>> vel;   ///< Angstrom/fs
+};
+
+bool write_dump(const Dump_Frame& frame)
+{
+    std::ofstream ofs;
+    if (frame.new_file)
+    {
+        ofs.open(frame.file, std::ios::trunc);
+    }
+    else
+    {
+        ofs.open(frame.file, std::ios::app);
+    }
+
+    ofs << "MDSTEP:  " << frame.step << std::endl;
+    ofs << std::setprecision(12) << std::setiosflags(std::ios::fixed);
+
+    ofs << "LATTICE_CONSTANT: " << frame.lat0_angstrom << " Angstrom" << std::endl;
+
+    if (frame.dump_energy)
+    {
+        ofs << "ENERGY: " << frame.energy << " eV" << std::endl;
+    }
+
+    ofs << "LATTICE_VECTORS" << std::endl;
+    ofs << "  " << frame.latvec.e11 << "  " << frame.latvec.e12 << "  " << frame.latvec.e13 << std::endl;
+    ofs << "  " << frame.latvec.e21 << "  " << frame.latvec.e22 << "  " << frame.latvec.e23 << std::endl;
+    ofs << "  " << frame.latvec.e31 << "  " << frame.latvec.e32 << "  " << frame.latvec.e33 << std::endl;
+
+    if (frame.dump_virial)
+    {
+        ofs << "VIRIAL (kbar)" << std::endl;
+        for (int i = 0; i < 3; ++i)
+        {
+            ofs << "  " << frame.virial(i, 0) << "  " << frame.virial(i, 1) << "  " << frame.virial(i, 2) << std::endl;
+        }
+    }
+
+    ofs << "INDEX    LABEL    POSITION (Angstrom)";
+    if (frame.dump_force)
+    {
+        ofs << "    FORCE (eV/Angstrom)";
+    }
+    if (frame.dump_vel)
+    {
+        ofs << "    VELOCITY (Angstrom/fs)";
+    }
+    ofs << std::endl;
+
+    for (int index = 0; index < frame.pos.size(); ++index)
+    {
+        ofs << "  " << index << "  " << frame.label[index] << "  " << frame.pos[index].x << "  " << frame.pos[index].y
+            << "  " << frame.pos[index].z;
+
+        if (frame.dump_force)
+        {
+            ofs << "  " << frame.force[index].x << "  " << frame.force[index].y << "  " << frame.force[index].z;
+        }
+
+        if (frame.dump_vel)
+        {
+            ofs << "  " << frame.vel[index].x << "  " << frame.vel[index].y << "  " << frame.vel[index].z;
+        }
+        ofs << std::endl;
+    }
+
+    ofs << std::endl;
+    ofs << std::endl;
+    ofs.close();
+    return !ofs.fail();
+}
+} // namespace
+
 double gaussrand()
 {
     static double V1, V2, S;
@@ -256,6 +350,43 @@ void force_virial(ModuleESolver::ESolver* p_esolver,
     ModuleBase::timer::tick("MD_func", "force_virial");
 }
 
+void force_virial_frames(ModuleESolver::ESolver_DP* p_esolver,
+                         const int& nframes,
+                         const ModuleBase::Vector3<double>* tau,
+                         const ModuleBase::Matrix3* latvec,
+                         const UnitCell& unit_in,
+                         double* potential,
+                         ModuleBase::Vector3<double>* force,
+                         ModuleBase::matrix* virial)
+{
+    ModuleBase::TITLE("MD_func", "force_virial_frames");
+    ModuleBase::timer::tick("MD_func", "force_virial_frames");
+
+    p_esolver->Run_frames(nframes, tau, latvec, unit_in);
+
+    ModuleBase::matrix force_temp(unit_in.nat, 3);
+    for (int iframe = 0; iframe < nframes; ++iframe)
+    {
+        virial[iframe].create(3, 3);
+        p_esolver->cal_Frame(iframe, potential[iframe], force_temp, virial[iframe]);
+
+        /// convert Rydberg to Hartree
+        potential[iframe] *= 0.5;
+        virial[iframe] *= 0.5;
+
+        ModuleBase::Vector3<double>* force_frame = force + unit_in.nat * iframe;
+        for (int i = 0; i < unit_in.nat; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                force_frame[i][j] = 0.5 * force_temp(i, j);
+            }
+        }
+    }
+
+    ModuleBase::timer::tick("MD_func", "force_virial_frames");
+}
+
 void print_stress(std::ofstream& ofs, const ModuleBase::matrix& virial, const ModuleBase::matrix& stress)
 {
     double stress_scalar = 0.0, virial_scalar = 0.0;
@@ -286,86 +417,163 @@ void dump_info(const int& step,
                const MD_para& mdp,
                const ModuleBase::matrix& virial,
                const ModuleBase::Vector3<double>* force,
-               const ModuleBase::Vector3<double>* vel)
+               const ModuleBase::Vector3<double>* vel,
+               ModuleIO::Output_Queue* queue)
 {
     if (mdp.my_rank)
         return;
 
-    std::stringstream file;
-    file << global_out_dir << "MD_dump";
-    std::ofstream ofs;
-    if (step == 0)
-    {
-        ofs.open(file.str(), std::ios::trunc);
-    }
-    else
-    {
-        ofs.open(file.str(), std::ios::app);
-    }
-
     const double unit_pos = unit_in.lat0 / ModuleBase::ANGSTROM_AU;                                  ///< Angstrom
     const double unit_vel = 1.0 / ModuleBase::ANGSTROM_AU / ModuleBase::AU_to_FS;                    ///< Angstrom/fs
     const double unit_virial = ModuleBase::HARTREE_SI / pow(ModuleBase::BOHR_RADIUS_SI, 3) * 1.0e-8; ///< kBar
     const double unit_force = ModuleBase::Hartree_to_eV * ModuleBase::ANGSTROM_AU;                   ///< eV/Angstrom
 
-    ofs << "MDSTEP:  " << step << std::endl;
-    ofs << std::setprecision(12) << std::setiosflags(std::ios::fixed);
-
-    ofs << "LATTICE_CONSTANT: " << unit_in.lat0_angstrom << " Angstrom" << std::endl;
-
-    ofs << "LATTICE_VECTORS" << std::endl;
-    ofs << "  " << unit_in.latvec.e11 << "  " << unit_in.latvec.e12 << "  " << unit_in.latvec.e13 << std::endl;
-    ofs << "  " << unit_in.latvec.e21 << "  " << unit_in.latvec.e22 << "  " << unit_in.latvec.e23 << std::endl;
-    ofs << "  " << unit_in.latvec.e31 << "  " << unit_in.latvec.e32 << "  " << unit_in.latvec.e33 << std::endl;
+    Dump_Frame frame;
+    frame.step = step;
+    frame.file = global_out_dir + "MD_dump";
+    frame.new_file = (step == 0);
+    frame.lat0_angstrom = unit_in.lat0_angstrom;
+    frame.latvec = unit_in.latvec;
+    frame.dump_virial = mdp.cal_stress && mdp.dump_virial;
+    frame.dump_force = mdp.dump_force;
+    frame.dump_vel = mdp.dump_vel;
+    if (frame.dump_virial)
+    {
+        frame.virial = virial * unit_virial;
+    }
 
-    if (mdp.cal_stress && mdp.dump_virial)
+    frame.label.reserve(unit_in.nat);
+    frame.pos.reserve(unit_in.nat);
+    int index = 0;
+    for (int it = 0; it < unit_in.ntype; ++it)
     {
-        ofs << "VIRIAL (kbar)" << std::endl;
-        for (int i = 0; i < 3; ++i)
+        for (int ia = 0; ia < unit_in.atoms[it].na; ++ia)
         {
-            ofs << "  " << virial(i, 0) * unit_virial << "  " << virial(i, 1) * unit_virial << "  "
-                << virial(i, 2) * unit_virial << std::endl;
+            frame.label.push_back(unit_in.atom_label[it]);
+            frame.pos.push_back(unit_in.atoms[it].tau[ia] * unit_pos);
+            if (frame.dump_force)
+            {
+                frame.force.push_back(force[index] * unit_force);
+            }
+            if (frame.dump_vel)
+            {
+                frame.vel.push_back(vel[index] * unit_vel);
+            }
+            index++;
         }
     }
 
-    ofs << "INDEX    LABEL    POSITION (Angstrom)";
-    if (mdp.dump_force)
+    if (queue)
     {
-        ofs << "    FORCE (eV/Angstrom)";
+        const std::string file = frame.file;
+        queue->push(file, std::bind(write_dump, std::move(frame)));
     }
-    if (mdp.dump_vel)
+    else
     {
-        ofs << "    VELOCITY (Angstrom/fs)";
+        write_dump(frame);
     }
-    ofs << std::endl;
+}
 
-    int index = 0;
-    for (int it = 0; it < unit_in.ntype; ++it)
+int read_dump(std::ifstream& ifs,
+              const UnitCell& unit_in,
+              const int& nmax,
+              int* step,
+              ModuleBase::Vector3<double>* tau,
+              ModuleBase::Matrix3* latvec)
+{
+    int nframes = 0;
+    std::string line;
+    while (nframes < nmax && std::getline(ifs, line))
     {
-        for (int ia = 0; ia < unit_in.atoms[it].na; ++ia)
+        std::stringstream ss(line);
+        std::string word;
+        ss >> word;
+        if (word == "MDSTEP:")
+        {
+            ss >> step[nframes];
+        }
+        else if (word == "LATTICE_CONSTANT:")
         {
-            ofs << "  " << index << "  " << unit_in.atom_label[it] << "  " << unit_in.atoms[it].tau[ia].x * unit_pos
-                << "  " << unit_in.atoms[it].tau[ia].y * unit_pos << "  " << unit_in.atoms[it].tau[ia].z * unit_pos;
+            double lat0_angstrom = 0.0;
+            ss >> lat0_angstrom;
 
-            if (mdp.dump_force)
+            /// the lattice vectors in units of the lattice constant of STRU
+            ModuleBase::Matrix3& lat = latvec[nframes];
+            std::getline(ifs, line);
+            while (line.find("LATTICE_VECTORS") == std::string::npos && std::getline(ifs, line))
             {
-                ofs << "  " << force[index].x * unit_force << "  " << force[index].y * unit_force << "  "
-                    << force[index].z * unit_force;
             }
-
-            if (mdp.dump_vel)
+            ifs >> lat.e11 >> lat.e12 >> lat.e13 >> lat.e21 >> lat.e22 >> lat.e23 >> lat.e31 >> lat.e32 >> lat.e33;
+            lat *= lat0_angstrom / unit_in.lat0_angstrom;
+        }
+        else if (word == "INDEX")
+        {
+            ModuleBase::Vector3<double>* pos = tau + unit_in.nat * nframes;
+            int iat = 0;
+            for (int it = 0; it < unit_in.ntype; ++it)
             {
-                ofs << "  " << vel[index].x * unit_vel << "  " << vel[index].y * unit_vel << "  "
-                    << vel[index].z * unit_vel;
+                for (int ia = 0; ia < unit_in.atoms[it].na; ++ia)
+                {
+                    std::getline(ifs, line);
+                    std::stringstream ss_atom(line);
+                    int index = -1;
+                    std::string label;
+                    ss_atom >> index >> label >> pos[iat].x >> pos[iat].y >> pos[iat].z;
+                    if (ss_atom.fail() || index != iat || label != unit_in.atom_label[it])
+                    {
+                        ModuleBase::WARNING_QUIT("MD_func::read_dump", "the atoms of the frame differ from STRU");
+                    }
+                    pos[iat] *= ModuleBase::ANGSTROM_AU / unit_in.lat0;
+                    ++iat;
+                }
             }
-            ofs << std::endl;
-            index++;
+            ++nframes;
         }
     }
+    return nframes;
+}
 
-    ofs << std::endl;
-    ofs << std::endl;
-    ofs.close();
+void dump_relabel(const int& step,
+                  const bool& new_file,
+                  const std::string& global_out_dir,
+                  const UnitCell& unit_in,
+                  const ModuleBase::Matrix3& latvec,
+                  const ModuleBase::Vector3<double>* tau,
+                  const double& potential,
+                  const ModuleBase::matrix& virial,
+                  const ModuleBase::Vector3<double>* force)
+{
+    const double unit_pos = unit_in.lat0 / ModuleBase::ANGSTROM_AU;                                  ///< Angstrom
+    const double unit_virial = ModuleBase::HARTREE_SI / pow(ModuleBase::BOHR_RADIUS_SI, 3) * 1.0e-8; ///< kBar
+    const double unit_force = ModuleBase::Hartree_to_eV * ModuleBase::ANGSTROM_AU;                   ///< eV/Angstrom
+
+    Dump_Frame frame;
+    frame.step = step;
+    frame.file = global_out_dir + "MD_relabel";
+    frame.new_file = new_file;
+    frame.lat0_angstrom = unit_in.lat0_angstrom;
+    frame.latvec = latvec;
+    frame.dump_virial = true;
+    frame.dump_force = true;
+    frame.dump_energy = true;
+    frame.energy = potential * ModuleBase::Hartree_to_eV;
+    frame.virial = virial * unit_virial;
+
+    frame.label.reserve(unit_in.nat);
+    frame.pos.reserve(unit_in.nat);
+    frame.force.reserve(unit_in.nat);
+    int index = 0;
+    for (int it = 0; it < unit_in.ntype; ++it)
+    {
+        for (int ia = 0; ia < unit_in.atoms[it].na; ++ia)
+        {
+            frame.label.push_back(unit_in.atom_label[it]);
+            frame.pos.push_back(tau[index] * unit_pos);
+            frame.force.push_back(force[index] * unit_force);
+            index++;
+        }
+    }
+    write_dump(frame);
 }
 
 void get_mass_mbl(const UnitCell& unit_in,
@@ -2,6 +2,12 @@
 #define MD_FUNC_H
 
 #include "module_esolver/esolver.h"
+#include "module_esolver/esolver_dp.h"
+
+namespace ModuleIO
+{
+class Output_Queue;
+}
 
 /**
  * @brief base functions in md
@@ -86,6 +92,28 @@ void force_virial(ModuleESolver::ESolver* p_esolver,
                   ModuleBase::Vector3<double>* force,
                   const bool& cal_stress,
                   ModuleBase::matrix& virial);
+
+/**
+ * @brief calculate energy, forces and virial tensor of several frames in one DP call
+ *
+ * @param p_esolver the DP energy solver
+ * @param nframes the number of frames
+ * @param tau atomic positions of all frames in lat0, nframes * nat
+ * @param latvec lattice vectors of all frames in lat0
+ * @param unit_in unitcell information
+ * @param potential potential energy of all frames
+ * @param force atomic forces of all frames, nframes * nat
+ * @param virial lattice virial tensor of all frames
+ */
+void force_virial_frames(ModuleESolver::ESolver_DP* p_esolver,
+                         const int& nframes,
+                         const ModuleBase::Vector3<double>* tau,
+                         const ModuleBase::Matrix3* latvec,
+                         const UnitCell& unit_in,
+                         double* potential,
+                         ModuleBase::Vector3<double>* force,
+                         ModuleBase::matrix* virial);
+
 /**
  * @brief calculate the ionic kinetic energy
  *
@@ -135,6 +163,7 @@ void print_stress(std::ofstream& ofs, const ModuleBase::matrix& virial, const Mo
  * @param virial lattice virial tensor
  * @param force atomic forces
  * @param vel atomic velocities
+ * @param queue if not nullptr, a copy of the information is formatted and written by the queue in the background
  */
 void dump_info(const int& step,
                const std::string& global_out_dir,
@@ -142,7 +171,53 @@ void dump_info(const int& step,
                const MD_para& mdp,
                const ModuleBase::matrix& virial,
                const ModuleBase::Vector3<double>* force,
-               const ModuleBase::Vector3<double>* vel);
+               const ModuleBase::Vector3<double>* vel,
+               ModuleIO::Output_Queue* queue = nullptr);
+
+/**
+ * @brief read frames of a trajectory in the format of MD_dump
+ *
+ * The atoms of each frame must be listed in the order of unit_in.
+ *
+ * @param ifs the trajectory, the reading continues where the former call stopped
+ * @param unit_in unitcell information
+ * @param nmax the maximal number of frames to read
+ * @param step md step of each frame
+ * @param tau atomic positions of each frame in units of unit_in.lat0, nat * nmax
+ * @param latvec lattice vectors of each frame in units of unit_in.lat0
+ * @return the number of frames read, smaller than nmax at the end of the file
+ */
+int read_dump(std::ifstream& ifs,
+              const UnitCell& unit_in,
+              const int& nmax,
+              int* step,
+              ModuleBase::Vector3<double>* tau,
+              ModuleBase::Matrix3* latvec);
+
+/**
+ * @brief dump the energy, forces and virial of one relabelled frame into MD_relabel
+ *
+ * The format is that of MD_dump with an additional ENERGY line.
+ *
+ * @param step md step of the frame
+ * @param new_file whether to truncate MD_relabel
+ * @param global_out_dir directory of output files
+ * @param unit_in unitcell information
+ * @param latvec lattice vectors in units of unit_in.lat0
+ * @param tau atomic positions in units of unit_in.lat0
+ * @param potential potential energy
+ * @param virial lattice virial tensor
+ * @param force atomic forces
+ */
+void dump_relabel(const int& step,
+                  const bool& new_file,
+                  const std::string& global_out_dir,
+                  const UnitCell& unit_in,
+                  const ModuleBase::Matrix3& latvec,
+                  const ModuleBase::Vector3<double>* tau,
+                  const double& potential,
+                  const ModuleBase::matrix& virial,
+                  const ModuleBase::Vector3<double>* force);
 
 /**
  * @brief obtain the atomic mass and whether the freedom is fixed
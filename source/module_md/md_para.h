@@ -49,6 +49,10 @@ class MD_para
         md_tolerance = 100.0;
         md_nraise = 1;
 
+        md_respa_nstep = 1;
+        md_respa_esolver = "lj";
+        md_relabel_file = "none";
+
         dump_force = true;
         dump_vel = true;
         dump_virial = true;
@@ -96,6 +100,10 @@ class MD_para
     double md_tolerance; ///< tolerance for velocity rescaling (K)
     int md_nraise;       ///< parameters used when md_type=nvt
 
+    int md_respa_nstep;           ///< number of r-RESPA inner steps per md_dt, 1 means no r-RESPA
+    std::string md_respa_esolver; ///< the cheap esolver driving the r-RESPA inner steps: lj, dp
+    std::string md_relabel_file;  ///< MD_dump trajectory whose frames are evaluated by the DP model, none: run md
+
     bool dump_force;  ///< output atomic forces into the file MD_dump or not. liuyu 2023-03-01
     bool dump_vel;    ///< output atomic velocities into the file MD_dump or not. liuyu 2023-03-01
     bool dump_virial; ///< output lattice virial into the file MD_dump or not. liuyu 2023-03-01
@@ -3,18 +3,32 @@
 #include "fire.h"
 #include "langevin.h"
 #include "md_func.h"
+#include "module_base/parallel_common.h"
 #include "module_base/timer.h"
+#include "module_esolver/esolver_dp.h"
+#include "module_esolver/esolver_lj.h"
+#include "module_io/input.h"
+#include "module_io/output_queue.h"
 #include "module_io/print_info.h"
 #include "msst.h"
 #include "nhchain.h"
 #include "verlet.h"
 
+#include <algorithm>
+
 namespace Run_MD
 {
 
 void md_line(UnitCell& unit_in, ModuleESolver::ESolver* p_esolver, MD_para& md_para)
 {
     ModuleBase::TITLE("Run_MD", "md_line");
+
+    if (md_para.md_relabel_file != "none")
+    {
+        relabel_line(unit_in, p_esolver, md_para);
+        return;
+    }
+
     ModuleBase::timer::tick("Run_MD", "md_line");
 
     /// determine the md_type
@@ -44,6 +58,31 @@ void md_line(UnitCell& unit_in, ModuleESolver::ESolver* p_esolver, MD_para& md_p
         ModuleBase::WARNING_QUIT("md_line", "no such md_type!");
     }
 
+    /// the cheap esolver driving the r-RESPA inner steps
+    ModuleESolver::ESolver* p_esolver_fast = nullptr;
+    if (md_para.md_respa_nstep > 1)
+    {
+        if (md_para.md_respa_esolver == "lj")
+        {
+            p_esolver_fast = new ModuleESolver::ESolver_LJ();
+        }
+        else if (md_para.md_respa_esolver == "dp")
+        {
+            p_esolver_fast = new ModuleESolver::ESolver_DP(md_para.pot_file);
+        }
+        else
+        {
+            ModuleBase::WARNING_QUIT("md_line", "no such md_respa_esolver!");
+        }
+
+        /// keep the searching radius of the main esolver
+        const double search_radius = GlobalV::SEARCH_RADIUS;
+        p_esolver_fast->Init(INPUT, unit_in);
+        GlobalV::SEARCH_RADIUS = search_radius;
+
+        mdrun->set_respa(p_esolver_fast);
+    }
+
     /// md cycle
     while ((mdrun->step_ + mdrun->step_rst_) <= md_para.md_nstep && !mdrun->stop)
     {
@@ -90,11 +129,14 @@ void md_line(UnitCell& unit_in, ModuleESolver::ESolver* p_esolver, MD_para& md_p
                                md_para,
                                mdrun->virial,
                                mdrun->force,
-                               mdrun->vel);
+                               mdrun->vel,
+                               &ModuleIO::output_queue());
         }
 
         if ((mdrun->step_ + mdrun->step_rst_) % md_para.md_restartfreq == 0)
         {
+            /// the restart files are written only after the former output is on disk
+            ModuleIO::output_queue().flush();
             unit_in.update_vel(mdrun->vel);
             std::stringstream file;
             file << GlobalV::global_stru_dir << "STRU_MD_" << mdrun->step_ + mdrun->step_rst_;
@@ -106,8 +148,118 @@ void md_line(UnitCell& unit_in, ModuleESolver::ESolver* p_esolver, MD_para& md_p
     }
 
     delete mdrun;
+    delete p_esolver_fast;
     ModuleBase::timer::tick("Run_MD", "md_line");
     return;
 }
 
+void relabel_line(UnitCell& unit_in, ModuleESolver::ESolver* p_esolver, const MD_para& md_para)
+{
+    ModuleBase::TITLE("Run_MD", "relabel_line");
+    ModuleBase::timer::tick("Run_MD", "relabel_line");
+
+    ModuleESolver::ESolver_DP* p_esolver_dp = dynamic_cast<ModuleESolver::ESolver_DP*>(p_esolver);
+    if (p_esolver_dp == nullptr)
+    {
+        ModuleBase::WARNING_QUIT("relabel_line", "md_relabel_file is only available for esolver_type = dp");
+    }
+
+    /// the number of frames evaluated in one DeePMD call
+    const int nbatch = 32;
+    const int nat = unit_in.nat;
+    std::vector<int> step(nbatch);
+    std::vector<ModuleBase::Vector3<double>> tau(nbatch * nat);
+    std::vector<ModuleBase::Matrix3> latvec(nbatch);
+    std::vector<double> potential(nbatch);
+    std::vector<ModuleBase::Vector3<double>> force(nbatch * nat);
+    std::vector<ModuleBase::matrix> virial(nbatch);
+
+    std::ifstream ifs;
+    if (md_para.my_rank == 0)
+    {
+        ifs.open(md_para.md_relabel_file);
+    }
+
+    int nframes_all = 0;
+    int nframes = nbatch;
+    while (nframes == nbatch)
+    {
+        if (md_para.my_rank == 0)
+        {
+            nframes = MD_func::read_dump(ifs, unit_in, nbatch, step.data(), tau.data(), latvec.data());
+        }
+#ifdef __MPI
+        Parallel_Common::bcast_int(nframes);
+        Parallel_Common::bcast_int(step.data(), nframes);
+        /// the lattice vectors and positions of the batch in one broadcast
+        std::vector<double> buffer(9 * nframes + 3 * nat * nframes);
+        for (int iframe = 0; iframe < nframes; ++iframe)
+        {
+            const ModuleBase::Matrix3& lat = latvec[iframe];
+            const double box[9] = {lat.e11, lat.e12, lat.e13, lat.e21, lat.e22, lat.e23, lat.e31, lat.e32, lat.e33};
+            std::copy(box, box + 9, buffer.data() + 9 * iframe);
+        }
+        for (int i = 0; i < nframes * nat; ++i)
+        {
+            double* xyz = buffer.data() + 9 * nframes + 3 * i;
+            xyz[0] = tau[i].x;
+            xyz[1] = tau[i].y;
+            xyz[2] = tau[i].z;
+        }
+        Parallel_Common::bcast_double(buffer.data(), buffer.size());
+        for (int iframe = 0; iframe < nframes; ++iframe)
+        {
+            const double* box = buffer.data() + 9 * iframe;
+            latvec[iframe] = ModuleBase::Matrix3(box[0], box[1], box[2], box[3], box[4], box[5], box[6], box[7], box[8]);
+        }
+        for (int i = 0; i < nframes * nat; ++i)
+        {
+            const double* xyz = buffer.data() + 9 * nframes + 3 * i;
+            tau[i].set(xyz[0], xyz[1], xyz[2]);
+        }
+#endif
+        if (nframes == 0)
+        {
+            break;
+        }
+
+        /// all frames share the atom types of STRU set up in ESolver_DP::Init
+        MD_func::force_virial_frames(p_esolver_dp,
+                                     nframes,
+                                     tau.data(),
+                                     latvec.data(),
+                                     unit_in,
+                                     potential.data(),
+                                     force.data(),
+                                     virial.data());
+
+        if (md_para.my_rank == 0)
+        {
+            for (int iframe = 0; iframe < nframes; ++iframe)
+            {
+                MD_func::dump_relabel(step[iframe],
+                                      nframes_all + iframe == 0,
+                                      GlobalV::global_out_dir,
+                                      unit_in,
+                                      latvec[iframe],
+                                      tau.data() + nat * iframe,
+                                      potential[iframe],
+                                      virial[iframe],
+                                      force.data() + nat * iframe);
+            }
+        }
+        nframes_all += nframes;
+    }
+
+    GlobalV::ofs_running << " " << nframes_all << " frames of " << md_para.md_relabel_file
+                         << " are relabelled into MD_relabel" << std::endl;
+    if (nframes_all == 0)
+    {
+        ModuleBase::WARNING("relabel_line", "no frame is found in md_relabel_file");
+    }
+
+    ModuleBase::timer::tick("Run_MD", "relabel_line");
+    return;
+}
+
 } // namespace Run_MD
\ No newline at end of file
@@ -18,6 +18,18 @@ namespace Run_MD
  * @param md_para input parameters used in md
  */
 void md_line(UnitCell& unit_in, ModuleESolver::ESolver* p_esolver, MD_para& md_para);
+
+/**
+ * @brief evaluate the frames of md_para.md_relabel_file by the DP model instead of running md
+ *
+ * The frames are read in batches and each batch is evaluated in one DeePMD call,
+ * the results are written into MD_relabel.
+ *
+ * @param unit_in unitcell information
+ * @param p_esolver energy solver, must be ESolver_DP
+ * @param md_para input parameters used in md
+ */
+void relabel_line(UnitCell& unit_in, ModuleESolver::ESolver* p_esolver, const MD_para& md_para);
 } // namespace Run_MD
 
 #endif
\ No newline at end of file
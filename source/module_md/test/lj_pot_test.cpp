@@ -13,6 +13,7 @@
  * - Tested Function
  *   - ESolver_LJ::Run
  *     - calculate energy, force, virial for lj pot
+ *     - reuse the half neighbor list while atoms stay within the skin
  */
 
 class LJ_pot_test : public testing::Test
@@ -77,4 +78,56 @@ TEST_F(LJ_pot_test, stress)
     EXPECT_NEAR(stress(2, 0), 0, doublethreshold);
     EXPECT_NEAR(stress(2, 1), -1.1858461261560206e-22, doublethreshold);
     EXPECT_NEAR(stress(2, 2), 6.4275429572682057e-07, doublethreshold);
-}
\ No newline at end of file
+}
+
+TEST(LJ_neighbor_test, reuse)
+{
+    UnitCell ucell;
+    Setcell::setupcell(ucell);
+    Setcell::parameters();
+
+    double potential_ref = 0.0;
+    double potential = 0.0;
+    ModuleBase::Vector3<double>* force_ref = new ModuleBase::Vector3<double>[ucell.nat];
+    ModuleBase::Vector3<double>* force = new ModuleBase::Vector3<double>[ucell.nat];
+    ModuleBase::matrix stress_ref(3, 3);
+    ModuleBase::matrix stress(3, 3);
+
+    ModuleESolver::ESolver_LJ lj;
+    lj.Init(INPUT, ucell);
+    MD_func::force_virial(&lj, 0, ucell, potential, force, true, stress);
+    EXPECT_EQ(lj.get_nbuild(), 1);
+
+    // a small displacement keeps the neighbor list
+    ucell.atoms[0].tau[1].x += 0.05;
+    ucell.atoms[0].tau[2].y -= 0.05;
+    MD_func::force_virial(&lj, 1, ucell, potential, force, true, stress);
+    EXPECT_EQ(lj.get_nbuild(), 1);
+
+    ModuleESolver::ESolver_LJ lj_ref;
+    lj_ref.Init(INPUT, ucell);
+    MD_func::force_virial(&lj_ref, 0, ucell, potential_ref, force_ref, true, stress_ref);
+
+    EXPECT_NEAR(potential, potential_ref, doublethreshold);
+    for (int iat = 0; iat < ucell.nat; ++iat)
+    {
+        EXPECT_NEAR(force[iat].x, force_ref[iat].x, doublethreshold);
+        EXPECT_NEAR(force[iat].y, force_ref[iat].y, doublethreshold);
+        EXPECT_NEAR(force[iat].z, force_ref[iat].z, doublethreshold);
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            EXPECT_NEAR(stress(i, j), stress_ref(i, j), doublethreshold);
+        }
+    }
+
+    // a displacement larger than half of the skin triggers a rebuild
+    ucell.atoms[0].tau[3].z += 2.0;
+    MD_func::force_virial(&lj, 2, ucell, potential, force, true, stress);
+    EXPECT_EQ(lj.get_nbuild(), 2);
+
+    delete[] force_ref;
+    delete[] force;
+}
@@ -3,6 +3,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "module_esolver/esolver_lj.h"
+#include "module_io/output_queue.h"
 #include "setcell.h"
 
 #define doublethreshold 1e-12
@@ -34,6 +35,15 @@
  *   - MD_func::dump_info
  *     - output MD dump information
  *
+ *   - MD_func::dump_info_queue
+ *     - output MD dump information in the background, the file is the same as the direct output
+ *
+ *   - MD_func::read_dump
+ *     - read the frames of MD_dump back in batches
+ *
+ *   - MD_func::dump_relabel
+ *     - output the energy, forces and virial of a relabelled frame, which read_dump can read again
+ *
  *   - MD_func::print_stress
  *     - output stress
  *
@@ -345,6 +355,99 @@ TEST_F(MD_func_test, dump_info)
     remove("MD_dump");
 }
 
+TEST_F(MD_func_test, dump_info_queue)
+{
+    MD_func::dump_info(0, GlobalV::global_out_dir, ucell, INPUT.mdp, virial, force, vel);
+    MD_func::dump_info(1, GlobalV::global_out_dir, ucell, INPUT.mdp, virial, force, vel);
+    std::ifstream ifs("MD_dump");
+    std::stringstream direct;
+    direct << ifs.rdbuf();
+    ifs.close();
+    remove("MD_dump");
+
+    ModuleIO::Output_Queue queue(2);
+    MD_func::dump_info(0, GlobalV::global_out_dir, ucell, INPUT.mdp, virial, force, vel, &queue);
+    MD_func::dump_info(1, GlobalV::global_out_dir, ucell, INPUT.mdp, virial, force, vel, &queue);
+    queue.flush();
+    std::ifstream ifs2("MD_dump");
+    std::stringstream queued;
+    queued << ifs2.rdbuf();
+    ifs2.close();
+
+    EXPECT_FALSE(direct.str().empty());
+    EXPECT_EQ(queued.str(), direct.str());
+    remove("MD_dump");
+}
+
+TEST_F(MD_func_test, read_dump)
+{
+    MD_func::dump_info(0, GlobalV::global_out_dir, ucell, INPUT.mdp, virial, force, vel);
+    MD_func::dump_info(5, GlobalV::global_out_dir, ucell, INPUT.mdp, virial, force, vel);
+
+    int step[2];
+    std::vector<ModuleBase::Vector3<double>> tau(2 * natom);
+    ModuleBase::Matrix3 latvec[2];
+    std::ifstream ifs("MD_dump");
+    EXPECT_EQ(MD_func::read_dump(ifs, ucell, 1, step, tau.data(), latvec), 1);
+    EXPECT_EQ(MD_func::read_dump(ifs, ucell, 2, step + 1, tau.data() + natom, latvec + 1), 1);
+    EXPECT_EQ(MD_func::read_dump(ifs, ucell, 2, step, tau.data(), latvec), 0);
+    ifs.close();
+    remove("MD_dump");
+
+    EXPECT_EQ(step[1], 5);
+    for (int iframe = 0; iframe < 2; ++iframe)
+    {
+        EXPECT_NEAR(latvec[iframe].e11, ucell.latvec.e11, doublethreshold);
+        EXPECT_NEAR(latvec[iframe].e22, ucell.latvec.e22, doublethreshold);
+        EXPECT_NEAR(latvec[iframe].e33, ucell.latvec.e33, doublethreshold);
+        EXPECT_NEAR(latvec[iframe].e12, ucell.latvec.e12, doublethreshold);
+        for (int ia = 0; ia < natom; ++ia)
+        {
+            EXPECT_NEAR(tau[iframe * natom + ia].x, ucell.atoms[0].tau[ia].x, doublethreshold);
+            EXPECT_NEAR(tau[iframe * natom + ia].y, ucell.atoms[0].tau[ia].y, doublethreshold);
+            EXPECT_NEAR(tau[iframe * natom + ia].z, ucell.atoms[0].tau[ia].z, doublethreshold);
+        }
+    }
+}
+
+TEST_F(MD_func_test, dump_relabel)
+{
+    for (int i = 0; i < natom; ++i)
+    {
+        force[i].set(0.1 * i, 0.0, -0.1 * i);
+    }
+    MD_func::dump_relabel(3, true, GlobalV::global_out_dir, ucell, ucell.latvec, ucell.atoms[0].tau, -0.5, virial, force);
+    MD_func::dump_relabel(4, false, GlobalV::global_out_dir, ucell, ucell.latvec, ucell.atoms[0].tau, -0.5, virial, force);
+
+    std::ifstream ifs("MD_relabel");
+    std::string output_str;
+    getline(ifs, output_str);
+    EXPECT_THAT(output_str, testing::HasSubstr("MDSTEP:  3"));
+    getline(ifs, output_str);
+    getline(ifs, output_str);
+    EXPECT_THAT(output_str, testing::HasSubstr("ENERGY: -13.605698000000 eV"));
+    for (int i = 0; i < 11; ++i)
+    {
+        getline(ifs, output_str);
+    }
+    EXPECT_THAT(output_str,
+                testing::HasSubstr("  1  Ar  2.751720222021  2.751720222021  0.000000000000  5.142210972889  "
+                                   "0.000000000000  -5.142210972889"));
+    ifs.close();
+
+    // the relabelled frames are read like MD_dump
+    int step[2];
+    std::vector<ModuleBase::Vector3<double>> tau(2 * natom);
+    ModuleBase::Matrix3 latvec[2];
+    std::ifstream ifs2("MD_relabel");
+    EXPECT_EQ(MD_func::read_dump(ifs2, ucell, 2, step, tau.data(), latvec), 2);
+    ifs2.close();
+    remove("MD_relabel");
+    EXPECT_EQ(step[0], 3);
+    EXPECT_EQ(step[1], 4);
+    EXPECT_NEAR(tau[natom + 2].x, ucell.atoms[0].tau[2].x, doublethreshold);
+}
+
 TEST_F(MD_func_test, print_stress)
 {
     GlobalV::ofs_running.open("running.log");
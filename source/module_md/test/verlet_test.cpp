@@ -5,6 +5,7 @@
 
 #define private public
 #define protected public
+#include "module_md/md_func.h"
 #include "module_md/verlet.h"
 
 #define doublethreshold 1e-12
@@ -32,6 +33,10 @@
  *
  *   - verlet::print_md
  *     - output MD information such as energy, temperature, and pressure
+ *
+ *   - MD_base::set_respa
+ *     - with the full forces as fast forces, one r-RESPA step equals md_respa_nstep velocity-Verlet steps
+ *     - atom->dis holds the displacement of the whole outer step
  */
 
 class Verlet_test : public testing::Test
@@ -330,4 +335,61 @@ TEST_F(Verlet_test, print_md)
             " ------------------------------------------------------------------------------------------------"));
     ifs.close();
     remove("running.log");
-}
\ No newline at end of file
+}
+
+TEST_F(Verlet_test, respa)
+{
+    Setcell::parameters();
+    INPUT.mdp.md_type = "nve";
+
+    /// the slow forces vanish if the inner esolver is the full one
+    MD_para mdp_respa = INPUT.mdp;
+    mdp_respa.md_respa_nstep = 2;
+    UnitCell ucell_respa;
+    Setcell::setupcell(ucell_respa);
+    ModuleESolver::ESolver_LJ lj_full;
+    ModuleESolver::ESolver_LJ lj_fast;
+    lj_full.Init(INPUT, ucell_respa);
+    lj_fast.Init(INPUT, ucell_respa);
+
+    Verlet respa(mdp_respa, ucell_respa);
+    respa.set_respa(&lj_fast);
+    respa.setup(&lj_full, GlobalV::global_readin_dir);
+    respa.first_half(GlobalV::ofs_running);
+    MD_func::force_virial(&lj_full, 1, ucell_respa, respa.potential, respa.force, true, respa.virial);
+    respa.second_half();
+
+    /// two velocity-Verlet steps of md_dt/2
+    MD_para mdp_ref = INPUT.mdp;
+    mdp_ref.md_dt /= 2;
+    UnitCell ucell_ref;
+    Setcell::setupcell(ucell_ref);
+    ModuleESolver::ESolver_LJ lj_ref;
+    lj_ref.Init(INPUT, ucell_ref);
+
+    Verlet ref(mdp_ref, ucell_ref);
+    ref.setup(&lj_ref, GlobalV::global_readin_dir);
+    std::vector<ModuleBase::Vector3<double>> dis_ref(ucell_ref.nat);
+    for (int istep = 1; istep <= 2; ++istep)
+    {
+        ref.first_half(GlobalV::ofs_running);
+        for (int i = 0; i < ucell_ref.nat; ++i)
+        {
+            dis_ref[i] += ucell_ref.atoms[0].dis[i];
+        }
+        MD_func::force_virial(&lj_ref, istep, ucell_ref, ref.potential, ref.force, true, ref.virial);
+        ref.second_half();
+    }
+
+    EXPECT_NEAR(respa.potential, ref.potential, doublethreshold);
+    for (int i = 0; i < ucell_ref.nat; ++i)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            EXPECT_NEAR(respa.vel[i][k], ref.vel[i][k], doublethreshold);
+            EXPECT_NEAR(respa.force[i][k], ref.force[i][k], doublethreshold);
+            EXPECT_NEAR(ucell_respa.atoms[0].tau[i][k], ucell_ref.atoms[0].tau[i][k], doublethreshold);
+            EXPECT_NEAR(ucell_respa.atoms[0].dis[i][k], dis_ref[i][k], doublethreshold);
+        }
+    }
+}
@@ -1,6 +1,7 @@
 #include "relax_driver.h"
 
 #include "module_hamilt_pw/hamilt_pwdft/global.h" // use chr.
+#include "module_io/output_queue.h"
 #include "module_io/print_info.h"
 #include "module_io/write_wfc_r.h"
 
@@ -83,17 +84,24 @@ void Relax_Driver<FPTYPE, Device>::relax_driver(ModuleESolver::ESolver *p_esolve
                                              force_step,
                                              stress_step); // pengfei Li 2018-05-14
                 }
-                // print structure
-                std::stringstream ss, ss1;
-                ss << GlobalV::global_out_dir << "STRU_ION_D";
-                GlobalC::ucell.print_stru_file(ss.str(), 2, 0);
+                // print structure, the files are written in the background
+                if (GlobalV::MY_RANK == 0)
+                {
+                    std::stringstream stru;
+                    GlobalC::ucell.print_stru_ofs(stru, 2, 0);
+                    ModuleIO::output_queue().push_text(GlobalV::global_out_dir + "STRU_ION_D", stru.str());
+
+                    if (Ions_Move_Basic::out_stru)
+                    {
+                        std::stringstream ss1;
+                        ss1 << GlobalV::global_out_dir << "STRU_ION";
+                        ss1 << istep << "_D";
+                        ModuleIO::output_queue().push_text(ss1.str(), stru.str());
+                    }
+                }
 
                 if (Ions_Move_Basic::out_stru)
                 {
-                    ss1 << GlobalV::global_out_dir << "STRU_ION";
-                    ss1 << istep << "_D";
-                    GlobalC::ucell.print_stru_file(ss1.str(), 2, 0);
-
                     GlobalC::ucell.print_cell_cif("STRU_NOW.cif");
                 }
 
@@ -3,10 +3,17 @@
 #include "ions_move_basic.h"
 #include "module_base/global_function.h"
 #include "module_base/global_variable.h"
+#include "module_base/lapack_connector.h"
+#ifdef __MPI
+#include "module_base/parallel_common.h"
+#endif
 using namespace Ions_Move_Basic;
 
 double BFGS_Basic::relax_bfgs_w1 = -1.0; // default is 0.01
 double BFGS_Basic::relax_bfgs_w2 = -1.0; // defalut is 0.05
+std::string BFGS_Basic::relax_bfgs_prec = "none";
+std::string BFGS_Basic::relax_bfgs_hess_in = "none";
+bool BFGS_Basic::out_bfgs_hess = false;
 
 BFGS_Basic::BFGS_Basic()
 {
@@ -186,6 +193,11 @@ void BFGS_Basic::check_wolfe_conditions(void)
 
 void BFGS_Basic::reset_hessian(void)
 {
+    if (this->inv_hess0.nr == dim && this->inv_hess0.nc == dim)
+    {
+        this->inv_hess = this->inv_hess0;
+        return;
+    }
     for (int i = 0; i < dim; i++)
     {
         for (int j = 0; j < dim; j++)
@@ -199,6 +211,112 @@ void BFGS_Basic::reset_hessian(void)
     return;
 }
 
+void BFGS_Basic::set_model_hessian(const ModuleBase::matrix& hess)
+{
+    ModuleBase::TITLE("BFGS_Basic", "set_model_hessian");
+    assert(hess.nr == dim && hess.nc == dim);
+
+    // the model hessian is symmetric and positive definite
+    this->inv_hess0 = hess;
+    int info = 0;
+    LapackConnector::potrf('U', dim, this->inv_hess0.c, dim, info);
+    if (info == 0)
+    {
+        LapackConnector::potri('U', dim, this->inv_hess0.c, dim, info);
+    }
+    if (info != 0)
+    {
+        GlobalV::ofs_running << " WARNING: the model hessian is not positive definite, use identity instead." << std::endl;
+        this->inv_hess0.create(0, 0);
+        return;
+    }
+
+    // potri only gives the upper triangle
+    double trace = 0.0;
+    for (int i = 0; i < dim; i++)
+    {
+        for (int j = 0; j < i; j++)
+        {
+            this->inv_hess0(i, j) = this->inv_hess0(j, i);
+        }
+        trace += this->inv_hess0(i, i);
+    }
+
+    // keep the same average scale as the identity, the step length is
+    // controlled by the trust radius anyway.
+    this->inv_hess0 *= dim / trace;
+    return;
+}
+
+bool BFGS_Basic::read_hessian(const std::string& fn)
+{
+    ModuleBase::TITLE("BFGS_Basic", "read_hessian");
+
+    bool ok = false;
+    if (GlobalV::MY_RANK == 0)
+    {
+        std::ifstream hess_file(fn.c_str());
+        if (hess_file)
+        {
+            int rank1 = 0;
+            int rank2 = 0;
+            hess_file >> rank1 >> rank2;
+            if (rank1 == dim && rank2 == dim)
+            {
+                for (int i = 0; i < dim; i++)
+                {
+                    for (int j = 0; j < dim; j++)
+                    {
+                        hess_file >> this->inv_hess(i, j);
+                    }
+                }
+                ok = static_cast<bool>(hess_file);
+            }
+        }
+        hess_file.close();
+    }
+#ifdef __MPI
+    Parallel_Common::bcast_bool(ok);
+    if (ok)
+    {
+        Parallel_Common::bcast_double(this->inv_hess.c, dim * dim);
+    }
+#endif
+
+    if (ok)
+    {
+        GlobalV::ofs_running << " Read the approximate inverse hessian from " << fn << std::endl;
+    }
+    else
+    {
+        GlobalV::ofs_running << " WARNING: can not read the inverse hessian of dimension " << dim << " from " << fn
+                             << std::endl;
+        this->reset_hessian();
+    }
+    return ok;
+}
+
+void BFGS_Basic::write_hessian(const std::string& fn) const
+{
+    if (GlobalV::MY_RANK != 0)
+    {
+        return;
+    }
+    std::ofstream hess_file(fn.c_str());
+    hess_file << dim << " " << dim << std::endl;
+    hess_file << std::setprecision(16);
+    for (int i = 0; i < dim; i++)
+    {
+        for (int j = 0; j < dim; j++)
+        {
+            hess_file << " " << this->inv_hess(i, j);
+        }
+        hess_file << std::endl;
+    }
+    hess_file.close();
+    return;
+}
+
 void BFGS_Basic::save_bfgs(void)
 {
     this->save_flag = true;
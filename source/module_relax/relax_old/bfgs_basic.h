@@ -3,6 +3,8 @@
 
 #include "module_base/matrix.h"
 
+#include <string>
+
 // references
 // 1) Roger Fletcher, Practical Methods of Optimization, John Wiley and
 // Sons, Chichester, 2nd edn, 1987.
@@ -12,6 +14,8 @@
 // Comput. Mat. Science 27, 437, (2003).
 // 4) Ren Weiqing, PhD Thesis: Numerical Methods for the Study of Energy
 // Landscapes and Rare Events.
+// 5) David Packwood, James Kermode, Letif Mones, et al.,
+// J. Chem. Phys. 144, 164109 (2016). (preconditioner)
 
 class BFGS_Basic
 {
@@ -26,6 +30,15 @@ class BFGS_Basic
     void reset_hessian(void);
     void save_bfgs(void);
 
+    // keep the inverse of a model hessian, which replaces the identity
+    // matrix when the bfgs history is reset.
+    void set_model_hessian(const ModuleBase::matrix& hess);
+
+    // read/write the approximate inverse hessian, so that it can be
+    // reused by another run on the same system.
+    bool read_hessian(const std::string& fn);
+    void write_hessian(const std::string& fn) const;
+
     double* pos;  // std::vector containing 3N coordinates of the system ( x )
     double* grad; // std::vector containing 3N components of ( grad( V(x) ) )
     double* move; // pos = pos_p + move.
@@ -38,6 +51,10 @@ class BFGS_Basic
     static double relax_bfgs_w1; // fixed: parameters for Wolfe conditions.
     static double relax_bfgs_w2; // fixed: parameters for Wolfe conditions.
 
+    static std::string relax_bfgs_prec;    // model hessian to start from: none or exp
+    static std::string relax_bfgs_hess_in; // file of a saved inverse hessian, or none
+    static bool out_bfgs_hess;             // output the inverse hessian at each step or not
+
   protected:
     bool save_flag;
     bool tr_min_hit; //.TRUE. if the trust_radius has already been set
@@ -49,6 +66,7 @@ class BFGS_Basic
   private:
     bool wolfe_flag;
     ModuleBase::matrix inv_hess;
+    ModuleBase::matrix inv_hess0; // inverse of the model hessian, empty if not used
 
     int bfgs_ndim;
 
@@ -4,6 +4,9 @@
 #include "module_base/global_function.h"
 #include "module_base/global_variable.h"
 
+#include <cmath>
+#include <vector>
+
 //============= MAP OF BFGS ===========================
 // (1) start() -> BFGS_Basic::check_converged()
 // -> restart_bfgs() -> bfgs_routine() -> save_bfgs()
@@ -53,6 +56,11 @@ void Ions_Move_BFGS::start(UnitCell& ucell, const ModuleBase::matrix& force, con
     }
     else
     {
+        if (!this->save_flag && this->relax_bfgs_prec == "exp")
+        {
+            this->exp_precond(ucell);
+        }
+
         // [ if new step ]
         // reset trust_radius_old.
         // [ if run from previous saved info ]
@@ -71,6 +79,10 @@ void Ions_Move_BFGS::start(UnitCell& ucell, const ModuleBase::matrix& force, con
         // get prepared for the next try.
         // even if the energy is higher, we save the information.
         this->save_bfgs();
+        if (this->out_bfgs_hess)
+        {
+            this->write_hessian(GlobalV::global_out_dir + "BFGS_INV_HESS");
+        }
 
         Ions_Move_Basic::move_atoms(ucell, move, pos);
     }
@@ -126,27 +138,11 @@ void Ions_Move_BFGS::restart_bfgs(const double& lat0)
         trust_radius_old = relax_bfgs_init;
         this->reset_hessian();
 
-        /*
-        std::ifstream hess_file("hess_in");
-        if(hess_file)
+        // start from the inverse hessian of a previous run
+        if (this->relax_bfgs_hess_in != "none")
         {
-            int rank1,rank2;
-            hess_file >> rank1 >> rank2;
-            if(rank1 == dim && rank2 == dim)
-            {
-                GlobalV::ofs_running << "\n Reading the approximate inverse hessian from file"<<std::endl;
-
-                for(int i=0;i<dim;i++)
-                {
-                    for(int j=0;j<dim;j++)
-                    {
-                        hess_file >> inv_hess(i, j);
-                    }
-                }
-            }
+            this->read_hessian(this->relax_bfgs_hess_in);
         }
-        hess_file.close();
-        */
 
         this->tr_min_hit = false;
     }
@@ -309,3 +305,132 @@ void Ions_Move_BFGS::bfgs_routine(const double& lat0)
 
     return;
 }
+
+void Ions_Move_BFGS::exp_precond(const UnitCell& ucell)
+{
+    ModuleBase::TITLE("Ions_Move_BFGS", "exp_precond");
+
+    const int nat = ucell.nat;
+    const int dim = Ions_Move_Basic::dim;
+    assert(dim == 3 * nat);
+    const double A = 3.0;      // decay of the coupling
+    const double c_stab = 0.1; // keeps the matrix positive definite
+
+    std::vector<ModuleBase::Vector3<double>> tau(nat);
+    std::vector<ModuleBase::Vector3<int>> mbl(nat);
+    int iat = 0;
+    for (int it = 0; it < ucell.ntype; it++)
+    {
+        for (int ia = 0; ia < ucell.atoms[it].na; ia++)
+        {
+            tau[iat] = ucell.atoms[it].tau[ia] * ucell.lat0;
+            mbl[iat] = ucell.atoms[it].mbl[ia];
+            ++iat;
+        }
+    }
+    const ModuleBase::Vector3<double> a1 = ucell.a1 * ucell.lat0;
+    const ModuleBase::Vector3<double> a2 = ucell.a2 * ucell.lat0;
+    const ModuleBase::Vector3<double> a3 = ucell.a3 * ucell.lat0;
+
+    // number of periodic images needed in each direction to cover rcut,
+    // 1/|G_i| is the distance between the lattice planes.
+    auto nimage = [&ucell](const double rcut, int* n) {
+        const ModuleBase::Vector3<double> g[3] = {ModuleBase::Vector3<double>(ucell.G.e11, ucell.G.e12, ucell.G.e13),
+                                                  ModuleBase::Vector3<double>(ucell.G.e21, ucell.G.e22, ucell.G.e23),
+                                                  ModuleBase::Vector3<double>(ucell.G.e31, ucell.G.e32, ucell.G.e33)};
+        for (int i = 0; i < 3; i++)
+        {
+            n[i] = static_cast<int>(std::ceil(rcut * g[i].norm() / ucell.lat0)) + 1;
+        }
+    };
+
+    // (1) nearest neighbor distance
+    double r_nn = 1.0e10;
+    for (int i = 0; i < nat; i++)
+    {
+        for (int j = 0; j < nat; j++)
+        {
+            for (int n1 = -1; n1 <= 1; n1++)
+            {
+                for (int n2 = -1; n2 <= 1; n2++)
+                {
+                    for (int n3 = -1; n3 <= 1; n3++)
+                    {
+                        const ModuleBase::Vector3<double> R = a1 * static_cast<double>(n1)
+                                                              + a2 * static_cast<double>(n2)
+                                                              + a3 * static_cast<double>(n3);
+                        const double r = (tau[j] + R - tau[i]).norm();
+                        if (r > 1.0e-8)
+                        {
+                            r_nn = std::min(r_nn, r);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // (2) P = L + c_stab * I, with L the weighted graph laplacian,
+    // which acts in the same way on x, y and z.
+    const double rcut = 2.0 * r_nn;
+    int n[3] = {0, 0, 0};
+    nimage(rcut, n);
+    ModuleBase::matrix coef(nat, nat);
+    for (int i = 0; i < nat; i++)
+    {
+        for (int j = 0; j < nat; j++)
+        {
+            if (i == j)
+            {
+                continue; // images of the same atom move together
+            }
+            for (int n1 = -n[0]; n1 <= n[0]; n1++)
+            {
+                for (int n2 = -n[1]; n2 <= n[1]; n2++)
+                {
+                    for (int n3 = -n[2]; n3 <= n[2]; n3++)
+                    {
+                        const ModuleBase::Vector3<double> R = a1 * static_cast<double>(n1)
+                                                              + a2 * static_cast<double>(n2)
+                                                              + a3 * static_cast<double>(n3);
+                        const double r = (tau[j] + R - tau[i]).norm();
+                        if (r < rcut)
+                        {
+                            const double c = std::exp(-A * (r / r_nn - 1.0));
+                            coef(i, j) -= c;
+                            coef(i, i) += c;
+                        }
+                    }
+                }
+            }
+        }
+        coef(i, i) += c_stab;
+    }
+
+    // (3) the fixed degrees of freedom are decoupled
+    ModuleBase::matrix hess(dim, dim);
+    for (int i = 0; i < nat; i++)
+    {
+        for (int j = 0; j < nat; j++)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                if (mbl[i][k] && mbl[j][k])
+                {
+                    hess(3 * i + k, 3 * j + k) = coef(i, j);
+                }
+            }
+        }
+        for (int k = 0; k < 3; k++)
+        {
+            if (!mbl[i][k])
+            {
+                hess(3 * i + k, 3 * i + k) = coef(i, i);
+            }
+        }
+    }
+
+    ModuleBase::GlobalFunc::OUT(GlobalV::ofs_running, "nearest neighbor distance (Bohr)", r_nn);
+    this->set_model_hessian(hess);
+    return;
+}
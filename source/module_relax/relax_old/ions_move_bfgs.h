@@ -17,6 +17,10 @@ class Ions_Move_BFGS : public BFGS_Basic
     bool init_done;
     void bfgs_routine(const double& lat0);
     void restart_bfgs(const double& lat0);
+
+    // model hessian from the exponential preconditioner of Packwood et al.,
+    // P_ij = -exp(-A*(r_ij/r_nn-1)) for atom pairs within rcut = 2*r_nn.
+    void exp_precond(const UnitCell& ucell);
 };
 
 #endif
@@ -18,6 +18,9 @@
  *   - BFGS_Basic::update_inverse_hessian()
  *   - BFGS_Basic::check_wolfe_conditions()
  *   - BFGS_Basic::compute_trust_radius()
+ *   - BFGS_Basic::set_model_hessian()
+ *   - BFGS_Basic::read_hessian()
+ *   - BFGS_Basic::write_hessian()
  */
 
 int Ions_Move_Basic::dim = 0;
@@ -373,4 +376,51 @@ TEST_F(BFGSBasicTest, ComputeTrustRadiusWarningQuit)
     EXPECT_EXIT(bfgs.compute_trust_radius(), ::testing::ExitedWithCode(0), "");
     std::string output = testing::internal::GetCapturedStdout();
     EXPECT_THAT(output, testing::HasSubstr("bfgs history already reset at previous step, we got trapped!"));
-}
\ No newline at end of file
+}
+
+// Test function set_model_hessian(), the hessian is used when bfgs is reset
+TEST_F(BFGSBasicTest, SetModelHessian)
+{
+    Ions_Move_Basic::dim = 2;
+    bfgs.allocate_basic();
+    ModuleBase::matrix hess(2, 2);
+    hess(0, 0) = 2.0;
+    hess(0, 1) = 1.0;
+    hess(1, 0) = 1.0;
+    hess(1, 1) = 2.0;
+    bfgs.set_model_hessian(hess);
+    bfgs.reset_hessian();
+
+    // inverse is [[2,-1],[-1,2]]/3, scaled to a trace of 2
+    EXPECT_DOUBLE_EQ(bfgs.inv_hess(0, 0), 1.0);
+    EXPECT_DOUBLE_EQ(bfgs.inv_hess(0, 1), -0.5);
+    EXPECT_DOUBLE_EQ(bfgs.inv_hess(1, 0), -0.5);
+    EXPECT_DOUBLE_EQ(bfgs.inv_hess(1, 1), 1.0);
+}
+
+// Test functions write_hessian() and read_hessian()
+TEST_F(BFGSBasicTest, ReadWriteHessian)
+{
+    Ions_Move_Basic::dim = 2;
+    bfgs.allocate_basic();
+    bfgs.inv_hess(0, 0) = 1.5;
+    bfgs.inv_hess(0, 1) = 0.1;
+    bfgs.inv_hess(1, 0) = 0.1;
+    bfgs.inv_hess(1, 1) = 1.0 / 3.0;
+    bfgs.write_hessian("bfgs_hess_test");
+
+    bfgs.reset_hessian();
+    EXPECT_TRUE(bfgs.read_hessian("bfgs_hess_test"));
+    EXPECT_DOUBLE_EQ(bfgs.inv_hess(0, 0), 1.5);
+    EXPECT_DOUBLE_EQ(bfgs.inv_hess(0, 1), 0.1);
+    EXPECT_DOUBLE_EQ(bfgs.inv_hess(1, 0), 0.1);
+    EXPECT_DOUBLE_EQ(bfgs.inv_hess(1, 1), 1.0 / 3.0);
+
+    // a hessian of another dimension is not used
+    Ions_Move_Basic::dim = 3;
+    bfgs.allocate_basic();
+    EXPECT_FALSE(bfgs.read_hessian("bfgs_hess_test"));
+    EXPECT_DOUBLE_EQ(bfgs.inv_hess(0, 0), 1.0);
+    EXPECT_DOUBLE_EQ(bfgs.inv_hess(0, 1), 0.0);
+    std::remove("bfgs_hess_test");
+}
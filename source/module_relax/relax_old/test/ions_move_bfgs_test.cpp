@@ -15,6 +15,7 @@
  *   - Ions_Move_BFGS::start()
  *   - Ions_Move_BFGS::bfgs_routine()
  *   - Ions_Move_BFGS::restart_bfgs()
+ *   - Ions_Move_BFGS::exp_precond()
  */
 
 // Define a fixture for the tests
@@ -422,4 +423,41 @@ TEST_F(IonsMoveBFGSTest, BfgsRoutineWarningQuit2)
     EXPECT_EXIT(bfgs.bfgs_routine(lat0), ::testing::ExitedWithCode(0), "");
     std::string output = testing::internal::GetCapturedStdout();
     EXPECT_THAT(output, testing::HasSubstr("BFGS: move-length unreasonably short"));
-}
\ No newline at end of file
+}
+
+// Test the exp_precond() function
+TEST_F(IonsMoveBFGSTest, ExpPrecond)
+{
+    // two atoms 2 Bohr apart in a cubic cell of 10 Bohr
+    UnitCell ucell;
+    ucell.lat0 = 10.0;
+    ucell.a1 = ModuleBase::Vector3<double>(1.0, 0.0, 0.0);
+    ucell.a2 = ModuleBase::Vector3<double>(0.0, 1.0, 0.0);
+    ucell.a3 = ModuleBase::Vector3<double>(0.0, 0.0, 1.0);
+    ucell.G.Identity();
+    ucell.atoms[0].tau[0] = ModuleBase::Vector3<double>(0.0, 0.0, 0.0);
+    ucell.atoms[0].tau[1] = ModuleBase::Vector3<double>(0.2, 0.0, 0.0);
+    bfgs.allocate();
+    GlobalV::ofs_running.open("log");
+    bfgs.exp_precond(ucell);
+    bfgs.reset_hessian();
+    GlobalV::ofs_running.close();
+    std::remove("log");
+
+    // only the pair at r_nn is within 2*r_nn, so P = [[1.1, -1], [-1, 1.1]] for x, y and z,
+    // whose inverse is scaled to a unit diagonal
+    for (int i = 0; i < 2; ++i)
+    {
+        for (int j = 0; j < 2; ++j)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                for (int l = 0; l < 3; ++l)
+                {
+                    const double ref = (k != l) ? 0.0 : ((i == j) ? 1.0 : 1.0 / 1.1);
+                    EXPECT_NEAR(bfgs.inv_hess(3 * i + k, 3 * j + l), ref, 1e-12);
+                }
+            }
+        }
+    }
+}
@@ -16,6 +16,8 @@
 #include <vector>
 #include <array>
 #include <map>
+#include <set>
+#include <tuple>
 #include <deque>
 #include <mpi.h>
 
@@ -68,6 +70,14 @@ private:
 	void post_process_Hexx( std::map<TA, std::map<TAC, RI::Tensor<Tdata>>> &Hexxs_io ) const;
 	Tdata post_process_Eexx( const Tdata &Eexx_in ) const;
 
+	// for info.incremental: Hexxs belongs to Ds_last, and is updated by Hexx[Ds-Ds_last]
+	std::vector<std::map<TA,std::map<TAC,RI::Tensor<Tdata>>>> Ds_last;
+	static constexpr int Hexx_frac = -1 * 2;
+	void cal_exx_elec_incremental(
+		const std::vector<std::map<TA,std::map<TAC,RI::Tensor<Tdata>>>> &Ds,
+		const std::vector<std::tuple<std::set<TA>, std::set<TA>>> &judge,
+		const Parallel_Orbitals &pv);
+
     int two_level_step = 0;
     Mix_DMk_2D mix_DMk_2D;
     
@@ -9,6 +9,7 @@
 #include "Exx_LRI.h"
 #include "RI_2D_Comm.h"
 #include "RI_Util.h"
+#include "Exx_LRI_Incremental.h"
 #include "module_ri/exx_abfs-construct_orbs.h"
 #include "module_ri/exx_abfs-io.h"
 #include "module_ri/conv_coulomb_pot_k.h"
@@ -116,6 +117,9 @@ void Exx_LRI<Tdata>::cal_exx_ions()
 
 	this->exx_lri.set_parallel(this->mpi_comm, atoms_pos, latvec, period);
 
+	// Hexx of the new Cs and Vs has to be rebuilt from the full density matrix
+	this->Ds_last.clear();
+
 	// std::max(3) for gamma_only, list_A2 should contain cell {-1,0,1}. In the future distribute will be neighbour.
 	const std::array<Tcell,Ndim> period_Vs = LRI_CV_Tools::cal_latvec_range<Tcell>(1+this->info.ccp_rmesh_times);	
 	const std::pair<std::vector<TA>, std::vector<std::vector<std::pair<TA,std::array<Tcell,Ndim>>>>>
@@ -175,6 +179,21 @@ void Exx_LRI<Tdata>::cal_exx_elec(const Parallel_Orbitals &pv)
 
 	this->exx_lri.set_csm_threshold(this->info.cauchy_threshold);
 
+	if(this->info.incremental && this->Ds_last.size()==Ds.size() && this->Hexxs.size()==Ds.size())
+	{
+		this->cal_exx_elec_incremental(Ds, judge, pv);
+		this->Ds_last = std::move(Ds);
+		ModuleBase::timer::tick("Exx_LRI", "cal_exx_elec");
+		return;
+	}
+	if(this->info.incremental)
+	{
+		// deep copy, the tensors passed to exx_lri are not kept
+		this->Ds_last.resize(Ds.size());
+		for(std::size_t is=0; is<Ds.size(); ++is)
+			this->Ds_last[is] = Exx_LRI_Incremental::copy(Ds[is]);
+	}
+
 	this->Hexxs.resize(GlobalV::NSPIN);
 	this->Eexx = 0;
 	for(int is=0; is<GlobalV::NSPIN; ++is)
@@ -198,11 +217,46 @@ void Exx_LRI<Tdata>::cal_exx_elec(const Parallel_Orbitals &pv)
 	ModuleBase::timer::tick("Exx_LRI", "cal_exx_elec");	
 }
 
+template<typename Tdata>
+void Exx_LRI<Tdata>::cal_exx_elec_incremental(
+	const std::vector<std::map<TA,std::map<TAC,RI::Tensor<Tdata>>>> &Ds,
+	const std::vector<std::tuple<std::set<TA>, std::set<TA>>> &judge,
+	const Parallel_Orbitals &pv)
+{
+	ModuleBase::TITLE("Exx_LRI","cal_exx_elec_incremental");
+	ModuleBase::timer::tick("Exx_LRI", "cal_exx_elec_incremental");
+
+	// Hexx is linear in D: Hexx[Ds] = Hexx[Ds_last] + Hexx[Ds-Ds_last].
+	// Ds-Ds_last is small close to convergence, so that most of it is screened by dm_threshold and cauchy_threshold.
+	Tdata energy = 0;
+	for(int is=0; is<GlobalV::NSPIN; ++is)
+	{
+		this->exx_lri.set_Ds(Exx_LRI_Incremental::minus(Ds[is], this->Ds_last[is]), this->info.dm_threshold);
+		this->exx_lri.cal_Hs();
+		std::map<TA,std::map<TAC,RI::Tensor<Tdata>>> Hexxs_delta = RI::Communicate_Tensors_Map_Judge::comm_map2_first(
+			this->mpi_comm, std::move(this->exx_lri.Hs), std::get<0>(judge[is]), std::get<1>(judge[is]));
+		post_process_Hexx(Hexxs_delta);
+		Exx_LRI_Incremental::add(this->Hexxs[is], std::move(Hexxs_delta));
+
+		// force and stress need the full density matrix
+		if(GlobalV::CAL_FORCE || GlobalV::CAL_STRESS)
+			this->exx_lri.set_Ds(Exx_LRI_Incremental::copy(Ds[is]), this->info.dm_threshold, std::to_string(is));
+
+		// the energy is quadratic in D, Tr(Ds*Hs) with the updated Hexx
+		energy += Exx_LRI_Incremental::trace(Ds[is], this->Hexxs[is]);
+	}
+	energy /= Tdata(Hexx_frac);
+	MPI_Allreduce(MPI_IN_PLACE, &energy, sizeof(Tdata)/sizeof(double), MPI_DOUBLE, MPI_SUM, pv.comm_2D);
+	this->Eexx = post_process_Eexx(energy);
+
+	ModuleBase::timer::tick("Exx_LRI", "cal_exx_elec_incremental");
+}
+
 template<typename Tdata>
 void Exx_LRI<Tdata>::post_process_Hexx( std::map<TA, std::map<TAC, RI::Tensor<Tdata>>> &Hexxs_io ) const
 {
 	ModuleBase::TITLE("Exx_LRI","post_process_Hexx");
-	constexpr Tdata frac = -1 * 2;								// why?	Hartree to Ry?
+	constexpr Tdata frac = Hexx_frac;								// why?	Hartree to Ry?
 	const std::function<void(RI::Tensor<Tdata>&)>
 		multiply_frac = [&frac](RI::Tensor<Tdata> &t)
 		{ t = t*frac; };
@@ -0,0 +1,39 @@
+#ifndef EXX_LRI_INCREMENTAL_H
+#define EXX_LRI_INCREMENTAL_H
+
+#include <RI/global/Tensor.h>
+
+#include <map>
+
+// Tensor maps of the incremental Hexx update: Hexx is linear in D,
+// so Hexx[Ds] = Hexx[Ds_last] + Hexx[Ds-Ds_last] with the same Cs and Vs.
+namespace Exx_LRI_Incremental
+{
+	// deep copy, the copy of RI::Tensor shares the data
+	template<typename TA, typename TAC, typename Tdata>
+	extern std::map<TA,std::map<TAC,RI::Tensor<Tdata>>>
+	copy(const std::map<TA,std::map<TAC,RI::Tensor<Tdata>>> &Ds_in);
+
+	// Ds - Ds_last, a block missing in one of them is 0
+	template<typename TA, typename TAC, typename Tdata>
+	extern std::map<TA,std::map<TAC,RI::Tensor<Tdata>>>
+	minus(
+		const std::map<TA,std::map<TAC,RI::Tensor<Tdata>>> &Ds,
+		const std::map<TA,std::map<TAC,RI::Tensor<Tdata>>> &Ds_last);
+
+	// Hs += Hs_delta
+	template<typename TA, typename TAC, typename Tdata>
+	extern void add(
+		std::map<TA,std::map<TAC,RI::Tensor<Tdata>>> &Hs,
+		std::map<TA,std::map<TAC,RI::Tensor<Tdata>>> &&Hs_delta);
+
+	// \sum D * conj(H) over the blocks of Ds on this process
+	template<typename TA, typename TAC, typename Tdata>
+	extern Tdata trace(
+		const std::map<TA,std::map<TAC,RI::Tensor<Tdata>>> &Ds,
+		const std::map<TA,std::map<TAC,RI::Tensor<Tdata>>> &Hs);
+}
+
+#include "Exx_LRI_Incremental.hpp"
+
+#endif
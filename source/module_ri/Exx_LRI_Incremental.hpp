@@ -0,0 +1,94 @@
+#ifndef EXX_LRI_INCREMENTAL_HPP
+#define EXX_LRI_INCREMENTAL_HPP
+
+#include "Exx_LRI_Incremental.h"
+#include <RI/global/Global_Func-1.h>
+#include <RI/global/Global_Func-2.h>
+
+#include <complex>
+
+template<typename TA, typename TAC, typename Tdata>
+std::map<TA,std::map<TAC,RI::Tensor<Tdata>>>
+Exx_LRI_Incremental::copy(const std::map<TA,std::map<TAC,RI::Tensor<Tdata>>> &Ds_in)
+{
+	std::map<TA,std::map<TAC,RI::Tensor<Tdata>>> Ds_out;
+	for(const auto &Ds_A : Ds_in)
+		for(const auto &Ds_B : Ds_A.second)
+		{
+			RI::Tensor<Tdata> D(Ds_B.second.shape);
+			*D.data = *Ds_B.second.data;
+			Ds_out[Ds_A.first][Ds_B.first] = std::move(D);
+		}
+	return Ds_out;
+}
+
+template<typename TA, typename TAC, typename Tdata>
+std::map<TA,std::map<TAC,RI::Tensor<Tdata>>>
+Exx_LRI_Incremental::minus(
+	const std::map<TA,std::map<TAC,RI::Tensor<Tdata>>> &Ds,
+	const std::map<TA,std::map<TAC,RI::Tensor<Tdata>>> &Ds_last)
+{
+	std::map<TA,std::map<TAC,RI::Tensor<Tdata>>> Ds_delta;
+	for(const auto &Ds_A : Ds)
+		for(const auto &Ds_B : Ds_A.second)
+		{
+			const RI::Tensor<Tdata> &D = Ds_B.second;
+			const RI::Tensor<Tdata> D_last = RI::Global_Func::find(Ds_last, Ds_A.first, Ds_B.first);
+			RI::Tensor<Tdata> D_delta(D.shape);
+			for(std::size_t i=0; i<D.data->size(); ++i)
+				(*D_delta.data)[i] = D_last.empty() ? (*D.data)[i] : (*D.data)[i] - (*D_last.data)[i];
+			Ds_delta[Ds_A.first][Ds_B.first] = std::move(D_delta);
+		}
+	for(const auto &Ds_A : Ds_last)
+		for(const auto &Ds_B : Ds_A.second)
+			if(RI::Global_Func::find(Ds, Ds_A.first, Ds_B.first).empty())
+			{
+				const RI::Tensor<Tdata> &D_last = Ds_B.second;
+				RI::Tensor<Tdata> D_delta(D_last.shape);
+				for(std::size_t i=0; i<D_last.data->size(); ++i)
+					(*D_delta.data)[i] = -(*D_last.data)[i];
+				Ds_delta[Ds_A.first][Ds_B.first] = std::move(D_delta);
+			}
+	return Ds_delta;
+}
+
+template<typename TA, typename TAC, typename Tdata>
+void Exx_LRI_Incremental::add(
+	std::map<TA,std::map<TAC,RI::Tensor<Tdata>>> &Hs,
+	std::map<TA,std::map<TAC,RI::Tensor<Tdata>>> &&Hs_delta)
+{
+	for(auto &Hs_A : Hs_delta)
+		for(auto &Hs_B : Hs_A.second)
+		{
+			RI::Tensor<Tdata> &H = Hs[Hs_A.first][Hs_B.first];
+			if(H.empty())
+			{
+				H = std::move(Hs_B.second);
+				continue;
+			}
+			const RI::Tensor<Tdata> &H_delta = Hs_B.second;
+			for(std::size_t i=0; i<H.data->size(); ++i)
+				(*H.data)[i] += (*H_delta.data)[i];
+		}
+}
+
+template<typename TA, typename TAC, typename Tdata>
+Tdata Exx_LRI_Incremental::trace(
+	const std::map<TA,std::map<TAC,RI::Tensor<Tdata>>> &Ds,
+	const std::map<TA,std::map<TAC,RI::Tensor<Tdata>>> &Hs)
+{
+	Tdata energy = 0;
+	for(const auto &Ds_A : Ds)
+		for(const auto &Ds_B : Ds_A.second)
+		{
+			const RI::Tensor<Tdata> H = RI::Global_Func::find(Hs, Ds_A.first, Ds_B.first);
+			if(H.empty())
+				continue;
+			const RI::Tensor<Tdata> &D = Ds_B.second;
+			for(std::size_t i=0; i<D.data->size(); ++i)
+				energy += (*D.data)[i] * RI::Global_Func::convert<Tdata>(std::conj((*H.data)[i]));
+		}
+	return energy;
+}
+
+#endif
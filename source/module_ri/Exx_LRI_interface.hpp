@@ -23,6 +23,7 @@ void Exx_LRI_Interface<Tdata>::read_Hexxs(const std::string &file_name)
 	std::ifstream ifs(file_name, std::ofstream::binary);
 	cereal::BinaryInputArchive iar(ifs);
 	iar(exx_lri->Hexxs);
+	exx_lri->Ds_last.clear();
 	ModuleBase::timer::tick("Exx_LRI", "read_Hexxs");
 }
 template<typename Tdata>
@@ -0,0 +1,151 @@
+#include "gtest/gtest.h"
+#include "module_ri/Exx_LRI_Incremental.h"
+
+#include <RI/physics/Exx.h>
+#include <mpi.h>
+
+#include <array>
+#include <map>
+#include <random>
+#include <vector>
+
+/************************************************
+ *  unit test of Exx_LRI_Incremental
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - Exx_LRI_Incremental::copy()
+ *     - the copy does not share the data with the input
+ *   - Exx_LRI_Incremental::minus()
+ *     - a block missing in one of the density matrices is taken as 0
+ *   - Exx_LRI_Incremental::minus(), add() and trace() with RI::Exx
+ *     - Hexx[D1] + Hexx[D2-D1] equals Hexx[D2], and Tr(D2 Hexx) equals the energy of RI::Exx for D2,
+ *       i.e. the incremental and the full update of Exx_LRI give the same Hexx and Eexx
+ */
+
+using TA = int;
+using Tcell = int;
+constexpr std::size_t Ndim = 3;
+using TC = std::array<Tcell, Ndim>;
+using TAC = std::pair<TA, TC>;
+using Tdata = double;
+using TensorMap = std::map<TA, std::map<TAC, RI::Tensor<Tdata>>>;
+
+class ExxIncrementalTest : public testing::Test
+{
+  protected:
+    const int nat = 2;
+    const std::size_t nw = 2;   // orbitals of each atom
+    const std::size_t nabf = 3; // auxiliary basis functions of each atom
+    const TC cell0 = {0, 0, 0};
+    std::mt19937 gen{1234};
+    std::uniform_real_distribution<double> dist{-1.0, 1.0};
+
+    RI::Tensor<Tdata> random_tensor(const std::vector<std::size_t>& shape)
+    {
+        RI::Tensor<Tdata> t(shape);
+        for (auto& x: *t.data)
+            x = dist(gen);
+        return t;
+    }
+    // blocks of all the atom pairs in the home cell
+    TensorMap random_map(const std::vector<std::size_t>& shape)
+    {
+        TensorMap m;
+        for (int iat0 = 0; iat0 < nat; ++iat0)
+            for (int iat1 = 0; iat1 < nat; ++iat1)
+                m[iat0][{iat1, cell0}] = random_tensor(shape);
+        return m;
+    }
+    void expect_near(const TensorMap& m, const TensorMap& m_ref)
+    {
+        for (const auto& m_A: m_ref)
+            for (const auto& m_B: m_A.second)
+            {
+                const RI::Tensor<Tdata> t = RI::Global_Func::find(m, m_A.first, m_B.first);
+                ASSERT_FALSE(t.empty());
+                for (std::size_t i = 0; i < t.data->size(); ++i)
+                    EXPECT_NEAR((*t.data)[i], (*m_B.second.data)[i], 1e-10);
+            }
+    }
+};
+
+TEST_F(ExxIncrementalTest, Copy)
+{
+    const TensorMap Ds = random_map({nw, nw});
+    TensorMap Ds_copy = Exx_LRI_Incremental::copy(Ds);
+    const double D00 = (*Ds.at(0).at({1, cell0}).data)[0];
+    (*Ds_copy.at(0).at({1, cell0}).data)[0] += 1.0;
+    EXPECT_DOUBLE_EQ((*Ds.at(0).at({1, cell0}).data)[0], D00);
+}
+
+TEST_F(ExxIncrementalTest, Minus)
+{
+    TensorMap Ds = random_map({nw, nw});
+    TensorMap Ds_last = random_map({nw, nw});
+    Ds[0].erase({1, cell0});
+    Ds_last[1].erase({0, cell0});
+    const TensorMap Ds_delta = Exx_LRI_Incremental::minus(Ds, Ds_last);
+    for (int iat0 = 0; iat0 < nat; ++iat0)
+        for (int iat1 = 0; iat1 < nat; ++iat1)
+        {
+            const TAC key = {iat1, cell0};
+            const RI::Tensor<Tdata> D = RI::Global_Func::find(Ds, iat0, key);
+            const RI::Tensor<Tdata> D_last = RI::Global_Func::find(Ds_last, iat0, key);
+            const RI::Tensor<Tdata>& D_delta = Ds_delta.at(iat0).at(key);
+            for (std::size_t i = 0; i < D_delta.data->size(); ++i)
+            {
+                const double ref = (D.empty() ? 0.0 : (*D.data)[i]) - (D_last.empty() ? 0.0 : (*D_last.data)[i]);
+                EXPECT_DOUBLE_EQ((*D_delta.data)[i], ref);
+            }
+        }
+}
+
+TEST_F(ExxIncrementalTest, IncrementalEqualsFull)
+{
+    std::map<TA, std::array<double, Ndim>> atoms_pos = {{0, {0.0, 0.0, 0.0}}, {1, {1.0, 1.2, 0.8}}};
+    const std::array<std::array<double, Ndim>, Ndim> latvec = {{{8.0, 0.0, 0.0}, {0.0, 8.0, 0.0}, {0.0, 0.0, 8.0}}};
+    const std::array<Tcell, Ndim> period = {1, 1, 1};
+    TensorMap Cs = random_map({nabf, nw, nw});
+    TensorMap Vs = random_map({nabf, nabf});
+
+    RI::Exx<TA, Tcell, Ndim, Tdata> exx_lri;
+    exx_lri.set_parallel(MPI_COMM_SELF, atoms_pos, latvec, period);
+    exx_lri.set_Cs(std::move(Cs), 0.0);
+    exx_lri.set_Vs(std::move(Vs), 0.0);
+    exx_lri.set_csm_threshold(0.0);
+
+    // the blocks of the density matrix change from one loop to the next
+    TensorMap Ds_last = random_map({nw, nw});
+    TensorMap Ds = random_map({nw, nw});
+    Ds_last[0].erase({1, cell0});
+    Ds[1].erase({0, cell0});
+
+    // full update
+    exx_lri.set_Ds(Exx_LRI_Incremental::copy(Ds), 0.0);
+    exx_lri.cal_Hs();
+    const TensorMap Hs_full = std::move(exx_lri.Hs);
+    const Tdata energy_full = exx_lri.energy;
+
+    // incremental update
+    exx_lri.set_Ds(Exx_LRI_Incremental::copy(Ds_last), 0.0);
+    exx_lri.cal_Hs();
+    TensorMap Hs = std::move(exx_lri.Hs);
+    exx_lri.set_Ds(Exx_LRI_Incremental::minus(Ds, Ds_last), 0.0);
+    exx_lri.cal_Hs();
+    Exx_LRI_Incremental::add(Hs, std::move(exx_lri.Hs));
+
+    expect_near(Hs, Hs_full);
+    expect_near(Hs_full, Hs);
+    EXPECT_NEAR(Exx_LRI_Incremental::trace(Ds, Hs), energy_full, 1e-10);
+}
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+    MPI_Finalize();
+    return result;
+}